@@ -243,6 +243,11 @@ function connectSocket() {
     processNewData(data);
   });
 
+  // Gain hasil autotune sudah disimpan server: isi ulang form supaya "Simpan" tidak mengirim gain lama
+  state.socket.on('autotune', (data) => {
+    if (data.status === 'selesai' && data.terpasang) loadControlSettings();
+  });
+
   state.socket.on('debugLog', (packet) => {
     if (packet.type === 'CONTROL') {
         lastKnownControlSettings = packet.data;
@@ -0,0 +1,125 @@
+// =========================================================================
+//      LAPORAN LATENSI UJUNG KE UJUNG (pasangan lib/Kontrol/JamDinding.h)
+// =========================================================================
+// Telemetri JSON membawa "waktu": { kirim_ms (UTC, SNTP), umur_us: umur tiap
+// stempel tahap saat kirim }; batch biner v3 membawa epoch kirim di header.
+// Perintah ke MQTT_TOPIC_MODE diberi id_perintah, ESP32 menggemakannya ke
+// MQTT_TOPIC_GEMA dengan waktu terima/terap/aktuasi.
+// Selisih lintas jam (perangkat <-> server) hanya dihitung jika kirim_ms /
+// terima_ms ada (ESP32 sudah sinkron SNTP); server diasumsikan ber-NTP juga.
+// Broker tidak memberi stempel sendiri: "kirim_ke_server" = publish ESP32 ->
+// broker -> server.
+
+const KAPASITAS = 2000;              // sampel terakhir per jalur
+const BATAS_TUNGGU_GEMA_MS = 60000;  // perintah tanpa gema selama ini = hilang
+
+const JALUR = [
+  'sampel_suhu_ke_kirim', 'sampel_keruh_ke_kirim', 'sampel_keruh_ke_aktuasi',
+  'kirim_ke_server', 'server_ke_db', 'sampel_keruh_ke_db',
+  'perintah_ke_terima', 'perintah_ke_terap', 'perintah_ke_aktuasi_suhu', 'perintah_ke_aktuasi_keruh',
+  'perintah_pulang_pergi'
+];
+
+class JendelaLatensi {
+  constructor(kapasitas = KAPASITAS) {
+    this.data = new Float64Array(kapasitas);
+    this.jumlah = 0;   // total sejak server jalan (isi jendela = min(jumlah, kapasitas))
+  }
+
+  tambah(ms) {
+    if (!Number.isFinite(ms)) return;
+    this.data[this.jumlah % this.data.length] = ms;
+    this.jumlah++;
+  }
+
+  ringkas() {
+    const n = Math.min(this.jumlah, this.data.length);
+    if (n === 0) return { n: 0, total: this.jumlah };
+    const urut = Array.from(this.data.subarray(0, n)).sort((a, b) => a - b);
+    const persentil = (p) => urut[Math.min(n - 1, Math.floor(p * n))];
+    const bulat = (x) => Math.round(x * 1000) / 1000;
+    return {
+      n, total: this.jumlah,
+      min: bulat(urut[0]), p50: bulat(persentil(0.5)), p90: bulat(persentil(0.9)),
+      p99: bulat(persentil(0.99)), maks: bulat(urut[n - 1])
+    };
+  }
+}
+
+const jendela = Object.fromEntries(JALUR.map(j => [j, new JendelaLatensi()]));
+const statPerintah = { terkirim: 0, bergema: 0, ditolak: 0, hilang: 0, gema_asing: 0 };
+
+// id_perintah: 1..2^31-1, mulai dari waktu supaya restart server tidak mengulang id lama
+let idBerikut = (Math.floor(Date.now() / 1000) % 1000000000) + 1;
+const perintahTertunda = new Map();   // id -> waktu publish (ms UTC server)
+
+function catat(jalur, ms) {
+  jendela[jalur].tambah(ms);
+}
+
+// Telemetri JSON satu sampel: diterima = tiba di server, tersimpan = insert DB selesai
+function catatTelemetri(data, diterima, tersimpan) {
+  const w = data.waktu;
+  if (!w || !w.umur_us) return;
+  const u = w.umur_us;
+  if (u.sampel_suhu != null) catat('sampel_suhu_ke_kirim', u.sampel_suhu / 1000);
+  if (u.sampel_keruh != null) catat('sampel_keruh_ke_kirim', u.sampel_keruh / 1000);
+  if (u.sampel_keruh != null && u.aktuasi_keruh != null) {
+    catat('sampel_keruh_ke_aktuasi', (u.sampel_keruh - u.aktuasi_keruh) / 1000);
+  }
+  if (tersimpan) catat('server_ke_db', tersimpan - diterima);
+  if (w.kirim_ms == null) return;
+  catat('kirim_ke_server', diterima - w.kirim_ms);
+  if (tersimpan && u.sampel_keruh != null) catat('sampel_keruh_ke_db', tersimpan - w.kirim_ms + u.sampel_keruh / 1000);
+}
+
+// Batch biner: satu publish -> satu sampel kirim_ke_server (sampel di dalamnya bisa sudah lama)
+function catatBatch(docs, diterima, tersimpan) {
+  if (docs.length === 0 || docs[0].putar_ulang) return;
+  if (tersimpan) catat('server_ke_db', tersimpan - diterima);
+  if (docs[0].waktu_kirim) catat('kirim_ke_server', diterima - docs[0].waktu_kirim.getTime());
+}
+
+// Payload perintah + id_perintah di depan (ikut terbaca walau kunci sesudahnya ditolak)
+function beriId(payload) {
+  const id = idBerikut;
+  idBerikut = idBerikut >= 2147483647 ? 1 : idBerikut + 1;
+  const sekarang = Date.now();
+  for (const [lama, t] of perintahTertunda) {
+    if (sekarang - t < BATAS_TUNGGU_GEMA_MS) break;   // Map urut waktu sisip
+    perintahTertunda.delete(lama);
+    statPerintah.hilang++;
+  }
+  perintahTertunda.set(id, sekarang);
+  statPerintah.terkirim++;
+  return { id_perintah: id, ...payload };
+}
+
+// Gema dari ESP32; *_us relatif waktu terima di perangkat
+function catatGema(g, diterima) {
+  const dikirim = perintahTertunda.get(g.id);
+  if (dikirim === undefined) {
+    statPerintah.gema_asing++;   // retained lama / server restart / sudah dianggap hilang
+    return null;
+  }
+  perintahTertunda.delete(g.id);
+  if (!g.ok) statPerintah.ditolak++;
+  else statPerintah.bergema++;
+  catat('perintah_pulang_pergi', diterima - dikirim);
+  if (!g.ok || g.terima_ms == null) return diterima - dikirim;
+  const keTerima = g.terima_ms - dikirim;
+  catat('perintah_ke_terima', keTerima);
+  if (g.terap_us != null) catat('perintah_ke_terap', keTerima + g.terap_us / 1000);
+  if (g.aktuasi_suhu_us != null) catat('perintah_ke_aktuasi_suhu', keTerima + g.aktuasi_suhu_us / 1000);
+  if (g.aktuasi_keruh_us != null) catat('perintah_ke_aktuasi_keruh', keTerima + g.aktuasi_keruh_us / 1000);
+  return diterima - dikirim;
+}
+
+// { jalur: {n, total, min, p50, p90, p99, maks} (ms), perintah: {...} }
+function laporan() {
+  const jalur = {};
+  for (const j of JALUR) jalur[j] = jendela[j].ringkas();
+  return { jalur, perintah: { ...statPerintah, menunggu_gema: perintahTertunda.size } };
+}
+
+module.exports = { JendelaLatensi, catatTelemetri, catatBatch, beriId, catatGema, laporan };
@@ -1,7 +1,7 @@
 const mongoose = require('mongoose');
 
 const controlSchema = new mongoose.Schema({
-  kontrol_aktif: { type: String, default: "Fuzzy" },    // Mode kontrol: "Fuzzy" atau "PID"
+  kontrol_aktif: { type: String, default: "Fuzzy" },    // Mode kontrol: "Fuzzy", "PID" atau "MPC" (suhu saja)
 
   // --- Parameter Kontrol Suhu ---
   suhu_setpoint: { type: Number, default: 28.0 },    // Setpoint suhu target
@@ -12,11 +12,42 @@ const controlSchema = new mongoose.Schema({
   // --- Parameter Kontrol Kekeruhan ---
   keruh_setpoint: { type: Number, default: 10.0 },   // Setpoint kekeruhan target (%)
   kp_keruh: { type: Number, default: 5.0 },         // Gain Proporsional untuk kekeruhan
-  ki_keruh: { type: Number, default: 0.3 },         // Gain Integral untuk kekeruhan
+  ki_keruh: { type: Number, default: 0.2 },         // Gain Integral untuk kekeruhan (sama dengan firmware)
   kd_keruh: { type: Number, default: 2.0 },         // Gain Derivatif untuk kekeruhan
+  kp_turbo_keruh: { type: Number, default: 35.0 },  // Kp Mode Turbo PID keruh
+  ambang_turbo_keruh: { type: Number, default: 2.0 }, // |error| (%) di atas ini pakai Mode Turbo
+  keruh_tahan: { type: Number, default: 11.0 },     // >= ini pompa minimal 50% (Fuzzy & PID)
+  keruh_mati: { type: Number, default: 9.0 },       // <= ini pompa mati
+
+  // --- Mesin Fuzzy: false = eksak (membership function), true = lookup table ---
+  fuzzy_lut_suhu: { type: Boolean, default: false },
+  fuzzy_lut_keruh: { type: Boolean, default: false },
+  fuzzy_pd_suhu: { type: Boolean, default: false },     // PD-fuzzy 2 input (error & delta error)
+
+  // Resolusi DS18B20 (9-12 bit): makin rendah makin cepat, makin kasar
+  resolusi_suhu: { type: Number, default: 12 },
+
+  // Telemetri biner batch (lib/Kontrol/TelemetriBiner.h) vs JSON per detik
+  telemetri_biner: { type: Boolean, default: false },
+  batch_sampel: { type: Number, default: 10 },
+  batch_interval_ms: { type: Number, default: 10000 },
+
+  // Report-by-exception (lib/Kontrol/KebijakanKirim.h): kirim hanya jika keluar deadband,
+  // saat transien (ganti mode/setpoint, error besar), atau heartbeat
+  kirim_pintar: { type: Boolean, default: true },
+  deadband_suhu: { type: Number, default: 0.05 },     // C
+  deadband_keruh: { type: Number, default: 0.2 },     // %
+  deadband_output: { type: Number, default: 5.0 },    // % output heater/pompa
+  heartbeat_ms: { type: Number, default: 60000 },
+
+  // Mode bayangan: Fuzzy & PID dihitung tiap tick, yang aktif saja menggerakkan aktuator;
+  // transfer mulus = ganti mode tanpa loncatan output (bias meluruh tau_transfer detik)
+  mode_bayangan: { type: Boolean, default: false },
+  transfer_mulus: { type: Boolean, default: false },
+  tau_transfer: { type: Number, default: 30.0 },
 
   // Kalibrasi ADC (TAMBAHKAN DEFAULT VALUE!)
-  adc_jernih: { type: Number, default: 9475 },
+  adc_jernih: { type: Number, default: 20100 },
   adc_keruh: { type: Number, default: 3550 },
 
   timestamp: { type: Date, default: Date.now } // Waktu data disimpan (opsional, tapi bagus untuk logging)
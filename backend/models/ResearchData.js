@@ -1,6 +1,9 @@
 const mongoose = require('mongoose');
 
 const researchDataSchema = new mongoose.Schema({
+  // Perangkat asal (id dari topik <prefix>/<id>/data, kanal bank "<id>/<k>"); kosong = topik lama satu perangkat
+  perangkat: { type: String },
+
   // Timing
   timestamp: { type: Date, default: Date.now, index: true },
   timestamp_ms: { type: Number },
@@ -10,7 +13,7 @@ const researchDataSchema = new mongoose.Schema({
   turbidity_persen: { type: Number, required: true },
   
   // Control Info
-  kontrol_aktif: { type: String, enum: ['Fuzzy', 'PID'], required: true },
+  kontrol_aktif: { type: String, enum: ['Fuzzy', 'PID', 'MPC'], required: true },
   pwm_heater: { type: Number },
   pwm_pompa: { type: Number },
   
@@ -20,7 +23,23 @@ const researchDataSchema = new mongoose.Schema({
   
   // Errors
   error_suhu: { type: Number },
-  error_keruh: { type: Number }
+  error_keruh: { type: Number },
+
+  // Mode bayangan: output & waktu hitung (us) Fuzzy dan PID pada sampel yang sama
+  // { suhu: {fuzzy, pid, us_fuzzy, us_pid}, keruh: {...}, lewat_anggaran }
+  bayangan: { type: mongoose.Schema.Types.Mixed },
+
+  // Latensi: { kirim_ms (UTC saat publish, null = belum SNTP), umur_us: {sampel_suhu, ..., aktuasi_keruh} }
+  // + waktu tiba di server & (batch v3) waktu kirim dari header
+  waktu: { type: mongoose.Schema.Types.Mixed },
+  waktu_terima: { type: Date },
+  waktu_kirim: { type: Date },
+
+  // Store-and-forward (telemetri biner v2): nomor boot ESP32, data kiriman
+  // ulang setelah putus, dan timestamp yang hanya perkiraan (sesi lama)
+  sesi: { type: Number },
+  putar_ulang: { type: Boolean },
+  waktu_perkiraan: { type: Boolean }
   
 }, {
   timestamps: true,
@@ -30,5 +49,10 @@ const researchDataSchema = new mongoose.Schema({
 });
 
 researchDataSchema.index({ kontrol_aktif: 1, timestamp: -1 });
+researchDataSchema.index({ perangkat: 1, timestamp: -1 });
+// Segmen yang terkirim dua kali (reboot di tengah putar ulang) ditolak di sini;
+// sesi & timestamp_ms hanya unik per perangkat
+researchDataSchema.index({ perangkat: 1, sesi: 1, timestamp_ms: 1 },
+  { unique: true, partialFilterExpression: { sesi: { $exists: true } } });
 
 module.exports = mongoose.model('ResearchData', researchDataSchema);
\ No newline at end of file
@@ -9,16 +9,61 @@ const cors = require('cors');
 // Models
 const ResearchData = require('./models/ResearchData');
 const Control = require('./models/Control');
+const { dekodeBatch } = require('./telemetriBiner');
+const latensi = require('./latensi');
+
+// <prefix>/<id>/<nama> -> { topic: <prefix>/<nama> (topik lama), perangkat: id };
+// <prefix>/<id>/<k>/<nama> (kanal k > 0 BankKontrol) -> perangkat "<id>/<k>" (satu tangki = satu sumber);
+// topik lama -> perangkat '' (firmware sebelum namespace per perangkat)
+function pisahTopik(topic, prefix) {
+  if (!topic.startsWith(prefix + '/')) return { topic, perangkat: '' };
+  const bagian = topic.slice(prefix.length + 1).split('/');
+  if (bagian.length === 2) return { topic: `${prefix}/${bagian[1]}`, perangkat: bagian[0] };
+  if (bagian.length === 3 && /^[1-9][0-9]*$/.test(bagian[1])) {
+    return { topic: `${prefix}/${bagian[2]}`, perangkat: `${bagian[0]}/${bagian[1]}` };
+  }
+  return { topic, perangkat: '' };
+}
 
 // Config
 const CONFIG = {
   PORT: process.env.PORT || 3000,
   MONGODB_URI: process.env.MONGODB_URI || 'mongodb://localhost:27017/aquarium_research',
-  MQTT_BROKER: 'mqtt://broker.hivemq.com',
+  MQTT_BROKER: process.env.MQTT_BROKER || 'mqtt://broker.hivemq.com',
+  // Topik per perangkat <prefix>/<id>/<nama> (lib/Kontrol/TopikPerangkat.h);
+  // topik lama tanpa id tetap dilayani, perintah dikirim siaran ke <prefix>/mode
+  MQTT_PREFIX: 'unhas/informatika/aquarium',
   MQTT_TOPIC_DATA: 'unhas/informatika/aquarium/data',
   MQTT_TOPIC_MODE: 'unhas/informatika/aquarium/mode',
+  MQTT_TOPIC_JADWAL: 'unhas/informatika/aquarium/jadwal',
+  MQTT_TOPIC_BATCH: 'unhas/informatika/aquarium/batch',
+  MQTT_TOPIC_STATUS: 'unhas/informatika/aquarium/status',
+  MQTT_TOPIC_PERINTAH: 'unhas/informatika/aquarium/perintah',
+  MQTT_TOPIC_KIRIM: 'unhas/informatika/aquarium/kirim',
+  MQTT_TOPIC_KONEKSI: 'unhas/informatika/aquarium/koneksi',
+  MQTT_TOPIC_PROFIL: 'unhas/informatika/aquarium/profil',
+  MQTT_TOPIC_AKTUATOR: 'unhas/informatika/aquarium/aktuator',
+  MQTT_TOPIC_GEMA: 'unhas/informatika/aquarium/gema',
+  MQTT_TOPIC_AUTOTUNE: 'unhas/informatika/aquarium/autotune',
 };
 
+// Statistik penjadwal ESP32 terakhir per loop (kunci: "penjadwal/loop")
+const statistikJadwal = {};
+// Status store-and-forward ESP32 terakhir (tertunda, diputar ulang, dibuang)
+let statusSimpan = null;
+// Statistik parser perintah ESP32 (diterima/ditolak, waktu parse, heap)
+let statusPerintah = null;
+// Kebijakan kirim ESP32 (sampel terkirim vs ditekan deadband)
+let statusKirim = null;
+// Manajer koneksi ESP32 (waktu sambung, jumlah putus/gagal, backoff)
+let statusKoneksi = null;
+// Profil jalur panas ESP32 per tahap (kunci: nama tahap) + memori (heap, stack)
+const statistikProfil = {};
+// Kalibrasi aktuator ESP32 terakhir per aktuator (status, kurva logika -> duty %)
+const statusAktuator = {};
+// Autotune PID ESP32 terakhir per loop (Ku, Pu, gain hasil, dipasang atau tidak)
+const statusAutotune = {};
+
 const app = express();
 const server = http.createServer(app);
 const io = socketIo(server, {
@@ -46,7 +91,11 @@ mongoose.connect(CONFIG.MONGODB_URI, {
   useNewUrlParser: true,
   useUnifiedTopology: true
 })
-.then(() => console.log('[MongoDB] ✅ Connected'))
+.then(() => {
+  console.log('[MongoDB] ✅ Connected');
+  // Indeks unik lama {sesi, timestamp_ms} diganti {perangkat, sesi, timestamp_ms}
+  return ResearchData.syncIndexes();
+})
 .catch(err => {
   console.error('[MongoDB] ❌ Error:', err.message);
   process.exit(1);
@@ -67,7 +116,20 @@ mqttClient.on('connect', async () => {
   // Subscribe Data Sensor
   mqttClient.subscribe([
     CONFIG.MQTT_TOPIC_DATA,
-    CONFIG.MQTT_TOPIC_MODE 
+    CONFIG.MQTT_TOPIC_MODE,
+    CONFIG.MQTT_TOPIC_JADWAL,
+    CONFIG.MQTT_TOPIC_BATCH,
+    CONFIG.MQTT_TOPIC_STATUS,
+    CONFIG.MQTT_TOPIC_PERINTAH,
+    CONFIG.MQTT_TOPIC_KIRIM,
+    CONFIG.MQTT_TOPIC_KONEKSI,
+    CONFIG.MQTT_TOPIC_PROFIL,
+    CONFIG.MQTT_TOPIC_AKTUATOR,
+    CONFIG.MQTT_TOPIC_GEMA,
+    CONFIG.MQTT_TOPIC_AUTOTUNE,
+    // Semua perangkat: <prefix>/+/<nama>, kanal bank: <prefix>/+/+/<nama> (perintah "mode" hanya dikirim server)
+    ...['data', 'jadwal', 'batch', 'status', 'perintah', 'kirim', 'koneksi', 'profil', 'aktuator', 'gema', 'autotune']
+      .flatMap(nama => [`${CONFIG.MQTT_PREFIX}/+/${nama}`, `${CONFIG.MQTT_PREFIX}/+/+/${nama}`])
   ], { qos: 1 }, (err) => {
     if (err) console.error('[MQTT] ❌ Subscribe error:', err);
     else console.log('[MQTT] ✅ Subscribed to topics');
@@ -88,7 +150,7 @@ mqttClient.on('connect', async () => {
     delete lastSettings._id; delete lastSettings.__v; delete lastSettings.timestamp;
 
     // Kirim ke ESP32 dengan RETAIN: TRUE
-    const payload = JSON.stringify(lastSettings);
+    const payload = JSON.stringify(latensi.beriId(lastSettings));
     mqttClient.publish(CONFIG.MQTT_TOPIC_MODE, payload, { qos: 1, retain: true });
     console.log(`[Sync] 🔄 Mode Terakhir Dikirim ke ESP32: ${lastSettings.kontrol_aktif}`);
 
@@ -99,16 +161,76 @@ mqttClient.on('connect', async () => {
 
 // ... (listener MQTT lainnya tetap sama) ...
 
-mqttClient.on('message', async (topic, message) => {
+// Batch biner: dekode semua sampel lalu satu insertMany (bukan N kali create)
+async function simpanBatch(message, perangkat) {
+  const diterima = new Date();
+  const docs = dekodeBatch(message, diterima, perangkat);
+  if (docs.length === 0) return;
+  const ulang = docs[0].putar_ulang ? ' putar ulang' : '';
+  docs.forEach(d => { d.waktu_terima = diterima; });
   try {
+    const saved = await ResearchData.insertMany(docs, { ordered: false });
+    latensi.catatBatch(docs, diterima.getTime(), Date.now());
+    // Data putar ulang sudah lewat: simpan saja, jangan ganggu grafik live
+    if (!ulang) saved.forEach(doc => io.emit('newData', doc));
+    io.emit('debugLog', { type: 'BATCH', data: { jumlah: docs.length, bytes: message.length, putar_ulang: !!ulang } });
+    const last = docs[docs.length - 1];
+    console.log(`[MQTT] Batch v${message[2]}${ulang}: ${docs.length} sampel (${message.length} byte) | ` +
+      `terakhir [${last.kontrol_aktif}] T:${last.suhu.toFixed(2)}°C K:${last.turbidity_persen.toFixed(1)}%`);
+  } catch (dbError) {
+    // ordered:false -> sampel lain tetap masuk, yang ganda (sesi + timestamp_ms) dilewati
+    if (dbError.code === 11000) {
+      console.log(`[MQTT] Batch${ulang}: sampel ganda dilewati (${dbError.writeErrors ? dbError.writeErrors.length : '?'})`);
+    } else {
+      console.error('[MongoDB] Error saving batch:', dbError.message);
+    }
+  }
+}
+
+// Gain autotune yang sudah dipasang ESP32 -> dokumen Control baru (salinan yang terakhir),
+// lalu konfigurasi retained diterbitkan ulang. Tanpa ini sinkron startup & POST /api/control
+// berikutnya mengirim gain lama. Tanda laporan disimpan di dokumen supaya laporan retained
+// yang sama (reconnect) tidak menimpa gain yang diubah sesudahnya.
+async function simpanGainAutotune(data) {
+  const kunci = data.loop === 'suhu' ? ['kp_suhu', 'ki_suhu', 'kd_suhu'] : ['kp_keruh', 'ki_keruh', 'kd_keruh'];
+  const gain = [data.kp, data.ki, data.kd];
+  if (!gain.every(g => Number.isFinite(g) && g >= 0)) return;
+  const tanda = `${data.aturan}/${data.ku}/${data.pu_s}/${gain.join('/')}`;
+  const terakhir = (await Control.findOne().sort({ timestamp: -1 }).lean()) || {};
+  if (terakhir[`autotune_${data.loop}`] === tanda) return;
+
+  const baru = { ...terakhir, [`autotune_${data.loop}`]: tanda, timestamp: new Date() };
+  delete baru._id; delete baru.__v;
+  kunci.forEach((k, i) => { baru[k] = gain[i]; });
+  const dok = (await Control.create(baru)).toObject();
+  delete dok._id; delete dok.__v; delete dok.timestamp;
+
+  const payload = JSON.stringify(latensi.beriId(dok));
+  mqttClient.publish(CONFIG.MQTT_TOPIC_MODE, payload, { qos: 1, retain: true });
+  io.emit('debugLog', { type: 'CONTROL', data: dok });
+  console.log(`[AUTOTUNE] Gain loop ${data.loop} disimpan ke Control: ${kunci.map((k, i) => `${k}=${gain[i]}`).join(' ')}`);
+}
+
+mqttClient.on('message', async (topicAsli, message) => {
+  try {
+    const { topic, perangkat } = pisahTopik(topicAsli, CONFIG.MQTT_PREFIX);
+    if (topic === CONFIG.MQTT_TOPIC_BATCH) {
+      await simpanBatch(message, perangkat);
+      return;
+    }
+
+    const diterima = Date.now();
     const data = JSON.parse(message.toString());
+    if (perangkat) data.perangkat = perangkat;
     
     if (topic === CONFIG.MQTT_TOPIC_DATA) {
       // Save to database
       // console.log('[DEBUG] Raw MQTT Data:', data); // Opsional: di-comment biar terminal bersih
       let savedData = null;
       try {
+        data.waktu_terima = new Date(diterima);
         const savedData = await ResearchData.create(data);
+        latensi.catatTelemetri(data, diterima, Date.now());
         if (savedData) { 
           io.emit('newData', savedData);
           // [MODIFIKASI] Kirim ke Debug Terminal Frontend
@@ -142,6 +264,69 @@ mqttClient.on('message', async (topic, message) => {
       console.log('[MQTT] Data saved:', data.suhu, '°C', data.turbidity_persen, '%');
       
       // [PENTING] SAYA HAPUS LOGIKA "AUTO-FIX" DARI SINI KARENA ITU PENYEBAB GAGAL UPDATE
+    } else if (topic === CONFIG.MQTT_TOPIC_STATUS) {
+      data.diterima = new Date();
+      statusSimpan = data;
+      io.emit('statusSimpan', data);
+      if (data.tertunda > 0 || data.dibuang > 0) {
+        console.log(`[SIMPAN] Sesi ${data.sesi}: tertunda ${data.tertunda} (flash ${data.tertunda_flash}), ` +
+          `diputar ulang ${data.diputar_ulang}, dibuang ${data.dibuang}`);
+      }
+    } else if (topic === CONFIG.MQTT_TOPIC_PERINTAH) {
+      // Perintah ditolak = konfigurasi lama tetap dipakai ESP32
+      data.diterima_server = new Date();
+      if (statusPerintah && data.ditolak > statusPerintah.ditolak) {
+        console.log(`[PERINTAH] Ditolak ESP32: ${data.ditolak_kunci || '(JSON)'} -> ${data.ditolak_alasan}`);
+      }
+      statusPerintah = data;
+      io.emit('statusPerintah', data);
+    } else if (topic === CONFIG.MQTT_TOPIC_KIRIM) {
+      data.diterima_server = new Date();
+      statusKirim = data;
+      io.emit('statusKirim', data);
+    } else if (topic === CONFIG.MQTT_TOPIC_KONEKSI) {
+      data.diterima_server = new Date();
+      if (statusKoneksi && data.putus_mqtt > statusKoneksi.putus_mqtt) {
+        console.log(`[KONEKSI] ESP32 sempat putus, terhubung lagi setelah ${data.ms_sambung_terakhir} ms`);
+      }
+      statusKoneksi = data;
+      io.emit('statusKoneksi', data);
+    } else if (topic === CONFIG.MQTT_TOPIC_PROFIL) {
+      data.diterima_server = new Date();
+      statistikProfil[data.tahap || 'memori'] = data;
+      io.emit('profil', data);
+    } else if (topic === CONFIG.MQTT_TOPIC_AKTUATOR) {
+      data.diterima_server = new Date();
+      statusAktuator[data.aktuator] = data;
+      io.emit('aktuator', data);
+      console.log(`[AKTUATOR] Kalibrasi ${data.aktuator}: ${data.status}${data.alasan ? ' (' + data.alasan + ')' : ''}`);
+    } else if (topic === CONFIG.MQTT_TOPIC_AUTOTUNE) {
+      data.diterima_server = new Date();
+      statusAutotune[data.loop] = data;
+      if (data.status === 'selesai') {
+        console.log(`[AUTOTUNE] Loop ${data.loop} (${data.aturan}): Ku ${data.ku}, Pu ${data.pu_s} s -> ` +
+          `Kp ${data.kp} Ki ${data.ki} Kd ${data.kd}${data.terpasang ? ' (dipasang)' : ''}`);
+        if (data.terpasang) await simpanGainAutotune(data);
+      } else {
+        console.log(`[AUTOTUNE] Loop ${data.loop}: ${data.status}${data.alasan ? ' (' + data.alasan + ')' : ''}`);
+      }
+      io.emit('autotune', data);   // sesudah Control disimpan: dashboard memuat ulang gain
+    } else if (topic === CONFIG.MQTT_TOPIC_GEMA) {
+      // Gema perintah ber-id_perintah: latensi perintah -> terima/terap/aktuasi di ESP32
+      const pulangPergi = latensi.catatGema(data, diterima);
+      io.emit('gema', data);
+      if (pulangPergi !== null) {
+        console.log(`[GEMA] Perintah ${data.id} ${data.ok ? 'diterapkan' : 'DITOLAK'} | pulang-pergi ${pulangPergi} ms` +
+          (data.aktuasi_keruh_us != null ? ` | aktuasi pompa ${(data.aktuasi_keruh_us / 1000).toFixed(1)} ms sesudah terima` : ''));
+      }
+    } else if (topic === CONFIG.MQTT_TOPIC_JADWAL) {
+      // Laju aktual = jalan / jendela_ms; jitter & overrun per jendela statistik
+      data.diterima = new Date();
+      statistikJadwal[`${data.penjadwal}/${data.loop}`] = data;
+      io.emit('jadwal', data);
+      if (data.overrun > 0) {
+        console.log(`[JADWAL] ${data.penjadwal}/${data.loop}: ${data.overrun} overrun, jitter ${data.jitter_min_us}..${data.jitter_max_us} us`);
+      }
     }
   } catch (error) {
     console.error('[MQTT] Processing error:', error.message);
@@ -218,6 +403,43 @@ app.get('/api/health', (req, res) => {
   });
 });
 
+app.get('/api/jadwal', (req, res) => {
+  res.json(Object.values(statistikJadwal));
+});
+
+app.get('/api/status', (req, res) => {
+  res.json(statusSimpan || {});
+});
+
+app.get('/api/perintah', (req, res) => {
+  res.json(statusPerintah || {});
+});
+
+app.get('/api/kirim', (req, res) => {
+  res.json(statusKirim || {});
+});
+
+app.get('/api/koneksi', (req, res) => {
+  res.json(statusKoneksi || {});
+});
+
+app.get('/api/profil', (req, res) => {
+  res.json(statistikProfil);
+});
+
+app.get('/api/aktuator', (req, res) => {
+  res.json(statusAktuator);
+});
+
+app.get('/api/autotune', (req, res) => {
+  res.json(statusAutotune);
+});
+
+// Distribusi latensi (ms) per jalur: sensor -> kirim -> server -> DB & perintah -> aktuasi
+app.get('/api/latensi', (req, res) => {
+  res.json(latensi.laporan());
+});
+
 app.get('/api/data', async (req, res) => {
   try {
     const { limit = 50 } = req.query;
@@ -252,10 +474,11 @@ app.post('/api/control', async (req, res) => {
     console.log('[API] Control update request:', req.body);
     
     // 1. Simpan ke DB dulu
+    // Dokumen terbaru (yang dibaca sinkron startup; autotune menambah dokumen baru)
     const updated = await Control.findOneAndUpdate(
       {}, 
       { $set: req.body }, 
-      { upsert: true, new: true, setDefaultsOnInsert: true }
+      { sort: { timestamp: -1 }, upsert: true, new: true, setDefaultsOnInsert: true }
     );
     
     // 2. BERSIHKAN DATA (Hanya ambil field penting & pastikan tipe angka)
@@ -264,20 +487,45 @@ app.post('/api/control', async (req, res) => {
         kontrol_aktif: req.body.kontrol_aktif, // String
         suhu_setpoint: parseFloat(req.body.suhu_setpoint),
         keruh_setpoint: parseFloat(req.body.keruh_setpoint),
-        kp_suhu: parseFloat(req.body.kp_suhu || 0),
-        ki_suhu: parseFloat(req.body.ki_suhu || 0),
-        kd_suhu: parseFloat(req.body.kd_suhu || 0),
-        kp_keruh: parseFloat(req.body.kp_keruh || 0),
-        ki_keruh: parseFloat(req.body.ki_keruh || 0),
-        kd_keruh: parseFloat(req.body.kd_keruh || 0),
+        kp_suhu: req.body.kp_suhu !== undefined ? parseFloat(req.body.kp_suhu) : undefined,
+        ki_suhu: req.body.ki_suhu !== undefined ? parseFloat(req.body.ki_suhu) : undefined,
+        kd_suhu: req.body.kd_suhu !== undefined ? parseFloat(req.body.kd_suhu) : undefined,
+        kp_keruh: req.body.kp_keruh !== undefined ? parseFloat(req.body.kp_keruh) : undefined,
+        ki_keruh: req.body.ki_keruh !== undefined ? parseFloat(req.body.ki_keruh) : undefined,
+        kd_keruh: req.body.kd_keruh !== undefined ? parseFloat(req.body.kd_keruh) : undefined,
+        kp_turbo_keruh: req.body.kp_turbo_keruh !== undefined ? parseFloat(req.body.kp_turbo_keruh) : undefined,
+        ambang_turbo_keruh: req.body.ambang_turbo_keruh !== undefined ? parseFloat(req.body.ambang_turbo_keruh) : undefined,
+        keruh_tahan: req.body.keruh_tahan !== undefined ? parseFloat(req.body.keruh_tahan) : undefined,
+        keruh_mati: req.body.keruh_mati !== undefined ? parseFloat(req.body.keruh_mati) : undefined,
         adc_jernih: req.body.adc_jernih ? parseInt(req.body.adc_jernih) : undefined,
-        adc_keruh: req.body.adc_keruh ? parseInt(req.body.adc_keruh) : undefined
+        adc_keruh: req.body.adc_keruh ? parseInt(req.body.adc_keruh) : undefined,
+        fuzzy_lut_suhu: req.body.fuzzy_lut_suhu !== undefined ? Boolean(req.body.fuzzy_lut_suhu) : undefined,
+        fuzzy_lut_keruh: req.body.fuzzy_lut_keruh !== undefined ? Boolean(req.body.fuzzy_lut_keruh) : undefined,
+        fuzzy_pd_suhu: req.body.fuzzy_pd_suhu !== undefined ? Boolean(req.body.fuzzy_pd_suhu) : undefined,
+        resolusi_suhu: req.body.resolusi_suhu ? parseInt(req.body.resolusi_suhu) : undefined,
+        telemetri_biner: req.body.telemetri_biner !== undefined ? Boolean(req.body.telemetri_biner) : undefined,
+        batch_sampel: req.body.batch_sampel ? parseInt(req.body.batch_sampel) : undefined,
+        batch_interval_ms: req.body.batch_interval_ms ? parseInt(req.body.batch_interval_ms) : undefined,
+        // Report-by-exception: deadband per field & heartbeat maksimum
+        kirim_pintar: req.body.kirim_pintar !== undefined ? Boolean(req.body.kirim_pintar) : undefined,
+        deadband_suhu: req.body.deadband_suhu !== undefined ? parseFloat(req.body.deadband_suhu) : undefined,
+        deadband_keruh: req.body.deadband_keruh !== undefined ? parseFloat(req.body.deadband_keruh) : undefined,
+        deadband_output: req.body.deadband_output !== undefined ? parseFloat(req.body.deadband_output) : undefined,
+        heartbeat_ms: req.body.heartbeat_ms ? parseInt(req.body.heartbeat_ms) : undefined,
+        // Mode bayangan & transfer mulus (tau_transfer detik, 0.1-3600 di ESP32)
+        mode_bayangan: req.body.mode_bayangan !== undefined ? Boolean(req.body.mode_bayangan) : undefined,
+        transfer_mulus: req.body.transfer_mulus !== undefined ? Boolean(req.body.transfer_mulus) : undefined,
+        tau_transfer: req.body.tau_transfer !== undefined ? parseFloat(req.body.tau_transfer) : undefined,
+        // Rule base baru (opsional): { mf: [[a,b,c,d], ...], out: [...], default: x }
+        fuzzy_suhu: req.body.fuzzy_suhu,
+        fuzzy_keruh: req.body.fuzzy_keruh,
+        fuzzy_suhu_pd: req.body.fuzzy_suhu_pd
     };
 
     // Hapus undefined
     Object.keys(cleanPayload).forEach(key => cleanPayload[key] === undefined && delete cleanPayload[key]);
 
-    const payload = JSON.stringify(cleanPayload);
+    const payload = JSON.stringify(latensi.beriId(cleanPayload));
 
     // 3. Kirim ke MQTT dengan RETAIN: TRUE
     mqttClient.publish(CONFIG.MQTT_TOPIC_MODE, payload, { qos: 1, retain: true }, (err) => {
@@ -310,7 +558,7 @@ app.post('/api/calibration', async (req, res) => {
     const updated = await Control.findOneAndUpdate(
       {},
       { $set: { adc_jernih: parseInt(adc_jernih), adc_keruh: parseInt(adc_keruh) } },
-      { upsert: true, new: true }
+      { sort: { timestamp: -1 }, upsert: true, new: true }
     );
     
     // Siapkan Payload Bersih
@@ -319,7 +567,7 @@ app.post('/api/calibration', async (req, res) => {
       adc_keruh: parseInt(adc_keruh)
     };
     
-    const payloadStr = JSON.stringify(cleanPayload);
+    const payloadStr = JSON.stringify(latensi.beriId(cleanPayload));
     
     // Kirim MQTT (Retain)
     mqttClient.publish(CONFIG.MQTT_TOPIC_MODE, payloadStr, { qos: 1, retain: true });
@@ -0,0 +1,104 @@
+// =========================================================================
+//      DEKODER TELEMETRI BINER BATCH (pasangan lib/Kontrol/TelemetriBiner.h)
+// =========================================================================
+// v1 header 8 byte : 'A' 'Q' | versi | jumlah | ukuran record | 3 byte cadangan
+// v2 header 12 byte: ... | flags | sesi u16 | t_kirim_ms u32 (0 = tidak diketahui)
+// v3 header 20 byte: ... | epoch_kirim_ms u64 (UTC saat publish, 0 = belum SNTP)
+// Record           : 24 byte little endian, fixed-point x100 (lihat header C++)
+// Hasil: array objek dengan key yang sama seperti payload JSON lama.
+
+const MAGIC_0 = 0x41; // 'A'
+const MAGIC_1 = 0x51; // 'Q'
+const UKURAN_RECORD_V1 = 24;
+const BATCH_PUTAR_ULANG = 1;
+
+// Selisih jam dinding - millis ESP32 per sesi (boot), dipelajari dari batch
+// yang t_kirim_ms-nya diketahui; dipakai untuk record putar ulang sesi lama.
+// Kunci "perangkat/sesi": nomor sesi tiap perangkat berjalan sendiri-sendiri.
+// Dengan epoch_kirim_ms (v3, SNTP) selisihnya pasti; tanpa itu diperkirakan
+// dari waktu tiba (termasuk latensi jaringan + broker).
+const offsetSesi = new Map();
+
+function dekodeRecordV1(buf, o) {
+  const flags = buf.readUInt8(o + 22);
+  return {
+    timestamp_ms: buf.readUInt32LE(o + 0),
+    suhu: buf.readInt16LE(o + 4) / 100,
+    turbidity_persen: buf.readUInt16LE(o + 6) / 100,
+    turbidity_adc: buf.readInt16LE(o + 8),
+    kontrol_aktif: (flags & 4) ? 'MPC' : (flags & 1) ? 'PID' : 'Fuzzy',
+    pwm_heater: buf.readUInt16LE(o + 10) / 100,
+    pwm_pompa: buf.readUInt16LE(o + 12) / 100,
+    error_suhu: buf.readInt16LE(o + 14) / 100,
+    error_keruh: buf.readInt16LE(o + 16) / 100,
+    setpoint_suhu: buf.readUInt16LE(o + 18) / 100,
+    setpoint_keruh: buf.readUInt16LE(o + 20) / 100,
+    feedforward_active: (flags & 2) !== 0
+  };
+}
+
+function bacaHeader(buf) {
+  if (buf.length < 8 || buf[0] !== MAGIC_0 || buf[1] !== MAGIC_1) {
+    throw new Error('Bukan batch telemetri (magic salah)');
+  }
+  const h = { versi: buf[2], jumlah: buf[3], ukuranRecord: buf[4], flags: 0, sesi: null, tKirimMs: 0,
+              epochKirimMs: 0, ukuran: 8 };
+  if (h.versi >= 2) {
+    if (buf.length < 12) throw new Error('Header batch v2 terpotong');
+    h.flags = buf[5];
+    h.sesi = buf.readUInt16LE(6);
+    h.tKirimMs = buf.readUInt32LE(8);
+    h.ukuran = 12;
+  }
+  if (h.versi >= 3) {
+    if (buf.length < 20) throw new Error('Header batch v3 terpotong');
+    h.epochKirimMs = Number(buf.readBigUInt64LE(12));
+    h.ukuran = 20;
+  }
+  return h;
+}
+
+// diterima: waktu pesan tiba. Timestamp tiap sampel = offset jam sesi +
+// timestamp_ms; tanpa offset (v1 / sesi lama tak dikenal) dihitung mundur
+// dari sampel terakhir = diterima, ditandai waktu_perkiraan.
+// perangkat: id dari topik <prefix>/<id>/batch ('' = topik lama satu perangkat).
+function dekodeBatch(buf, diterima = new Date(), perangkat = '') {
+  const h = bacaHeader(buf);
+  // Versi baru boleh menambah field di belakang record; field v1 tetap di tempat
+  if (h.versi < 1 || h.ukuranRecord < UKURAN_RECORD_V1) {
+    throw new Error(`Versi batch tidak didukung: v${h.versi}, record ${h.ukuranRecord} byte`);
+  }
+  if (buf.length < h.ukuran + h.jumlah * h.ukuranRecord) {
+    throw new Error(`Batch terpotong: ${buf.length} byte untuk ${h.jumlah} sampel`);
+  }
+
+  const docs = [];
+  for (let i = 0; i < h.jumlah; i++) docs.push(dekodeRecordV1(buf, h.ukuran + i * h.ukuranRecord));
+  if (h.jumlah === 0) return docs;
+
+  let offset = null;
+  const kunciSesi = `${perangkat}/${h.sesi}`;
+  if (h.sesi !== null && h.tKirimMs !== 0) {
+    offset = (h.epochKirimMs !== 0 ? h.epochKirimMs : diterima.getTime()) - h.tKirimMs;
+    offsetSesi.set(kunciSesi, offset);
+  } else if (h.sesi !== null && offsetSesi.has(kunciSesi)) {
+    offset = offsetSesi.get(kunciSesi);
+  }
+
+  const msTerakhir = docs[h.jumlah - 1].timestamp_ms;
+  for (const d of docs) {
+    if (offset !== null) {
+      d.timestamp = new Date(offset + d.timestamp_ms);
+    } else {
+      d.timestamp = new Date(diterima.getTime() - ((msTerakhir - d.timestamp_ms) >>> 0));
+      if (h.flags & BATCH_PUTAR_ULANG) d.waktu_perkiraan = true;
+    }
+    if (h.sesi !== null) d.sesi = h.sesi;
+    if (perangkat) d.perangkat = perangkat;
+    if (h.epochKirimMs !== 0) d.waktu_kirim = new Date(h.epochKirimMs);
+    if (h.flags & BATCH_PUTAR_ULANG) d.putar_ulang = true;
+  }
+  return docs;
+}
+
+module.exports = { dekodeBatch, bacaHeader, UKURAN_RECORD_V1, BATCH_PUTAR_ULANG };
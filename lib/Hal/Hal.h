@@ -0,0 +1,144 @@
+/**
+ * HARDWARE ABSTRACTION LAYER (HAL)
+ * * Deskripsi:
+ * Antarmuka tipis antara logika kontrol dan perangkat keras.
+ * - ESP32  : HalEsp32.h (millis, hw timer, ADS1115, DS18B20, LEDC + L298N, WiFi, PubSubClient).
+ * - Native : HalNative.h (steady_clock / jam simulasi, sensor, AP & broker pengganti).
+ * Kode di lib/Kontrol hanya boleh bicara ke hardware lewat struct Hal ini.
+ */
+
+#ifndef AQUARIUM_HAL_H
+#define AQUARIUM_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Kanal aktuator (sesuai urutan kanal LEDC lama: 0 = heater, 1 = pompa)
+enum KanalPwm : uint8_t { KANAL_HEATER = 0, KANAL_POMPA = 1 };
+
+class HalClock {
+public:
+  virtual ~HalClock() {}
+  virtual unsigned long millis() = 0;
+  virtual unsigned long micros() = 0;
+  virtual void delay(unsigned long ms) = 0;
+  // Jam dinding UTC (us sejak epoch 1970) untuk stempel lintas perangkat.
+  // false = belum tersinkron (ESP32: SNTP belum menjawab; jam uji tanpa epoch)
+  virtual bool epochUs(uint64_t &us) { (void)us; return false; }
+};
+
+// Timer periodik (hardware timer di ESP32): membangunkan task pemanggil
+// mulai() tiap periode. Dasar waktu penjadwal loop kontrol.
+class HalTimer {
+public:
+  virtual ~HalTimer() {}
+  virtual bool mulai(uint32_t periodeUs) = 0;
+  // Blok sampai tick berikutnya; return jumlah tick sejak panggilan terakhir
+  // (> 1 berarti ada tick yang terlewat)
+  virtual uint32_t tunggu() = 0;
+};
+
+// ADC eksternal (ADS1115)
+class HalAdc {
+public:
+  virtual ~HalAdc() {}
+  virtual int16_t readSingleEnded(uint8_t kanal) = 0;
+
+  // Mode kontinu: ADC konversi terus-menerus, pin ALERT/RDY memicu ISR.
+  // jumlahSiap() naik 1 tiap konversi selesai (dihitung di ISR).
+  virtual bool mulaiKontinu(uint8_t kanal, uint16_t sps) = 0;
+  virtual uint32_t jumlahSiap() = 0;
+  virtual int16_t hasilTerakhir() = 0;
+};
+
+// Sensor suhu 1-Wire (DS18B20), beberapa probe di satu bus, mode non-blocking
+const uint8_t SUHU_MAKS_PROBE = 4;
+
+class HalSuhu {
+public:
+  virtual ~HalSuhu() {}
+  // Cari probe, simpan alamatnya, set resolusi (9-12 bit); return jumlah probe
+  virtual uint8_t mulai(uint8_t resolusiBit) = 0;
+  virtual void setResolusi(uint8_t resolusiBit) = 0;
+  // Mulai konversi semua probe sekaligus, langsung kembali
+  virtual void mintaKonversi() = 0;
+  virtual bool konversiSelesai() = 0;
+  // Baca hasil satu probe (-127 jika gagal / terputus)
+  virtual float bacaC(uint8_t index) = 0;
+};
+
+// Output PWM ke driver L298N. duty = 0 berarti arah motor juga dimatikan.
+class HalPwm {
+public:
+  virtual ~HalPwm() {}
+  virtual void tulis(KanalPwm kanal, int duty) = 0;
+};
+
+// WiFi station. Semua panggilan langsung kembali: asosiasi & DHCP jalan di
+// latar, hasilnya dipantau lewat status() (lib/Kontrol/ManajerKoneksi.h).
+enum StatusWifi : uint8_t {
+  WIFI_PUTUS = 0,
+  WIFI_MENYAMBUNG,
+  WIFI_TERHUBUNG,
+  WIFI_GAGAL,        // SSID tidak ada / password salah
+};
+
+struct IpStatis {
+  bool aktif;        // false = DHCP
+  uint8_t ip[4], gateway[4], subnet[4], dns[4];
+};
+
+class HalWifi {
+public:
+  virtual ~HalWifi() {}
+  // bssid & kanal opsional (nullptr / 0 = scan semua kanal)
+  virtual void mulai(const char *ssid, const char *password, const uint8_t *bssid, int32_t kanal,
+                     const IpStatis &ip) = 0;
+  virtual StatusWifi status() = 0;
+  virtual void putus() = 0;
+  // AP yang sedang terhubung
+  virtual void infoAp(uint8_t bssid[6], int32_t &kanal) = 0;
+  virtual int32_t rssi() = 0;
+};
+
+// Transport MQTT (PubSubClient di ESP32, broker pengganti di native)
+class HalMqtt {
+public:
+  virtual ~HalMqtt() {}
+  // Satu percobaan CONNECT (ESP32: dibatasi timeout socket, lihat main.cpp)
+  virtual bool sambung(const char *clientId) = 0;
+  virtual bool connected() = 0;
+  virtual bool publish(const char *topic, const char *payload, bool retained) = 0;
+  virtual bool publish(const char *topic, const uint8_t *payload, size_t len, bool retained) = 0;
+};
+
+// Berkas di flash (LittleFS di ESP32, map di memori pada native).
+// Dipakai log store-and-forward telemetri; path absolut, mis. "/tlm/00000001.seg".
+class HalBerkas {
+public:
+  virtual ~HalBerkas() {}
+  virtual bool mulai() = 0;
+  // Tambah di akhir berkas (dibuat jika belum ada)
+  virtual bool tambah(const char *path, const uint8_t *data, size_t len) = 0;
+  // Ganti seluruh isi berkas
+  virtual bool tulis(const char *path, const uint8_t *data, size_t len) = 0;
+  // Return jumlah byte terbaca (0 jika berkas tidak ada / offset di luar)
+  virtual size_t baca(const char *path, size_t offset, uint8_t *buf, size_t len) = 0;
+  virtual long ukuran(const char *path) = 0;   // -1 jika tidak ada
+  virtual bool hapus(const char *path) = 0;
+  // Panggil fn untuk tiap berkas di dir (nama tanpa path)
+  virtual void daftar(const char *dir, void (*fn)(const char *nama, void *ctx), void *ctx) = 0;
+};
+
+struct Profil;   // lib/Kontrol/Profil.h
+
+struct Hal {
+  HalClock *clock;
+  HalAdc *adc;
+  HalSuhu *suhu;
+  HalPwm *pwm;
+  HalMqtt *mqtt;
+  Profil *profil = nullptr;   // nullptr = jalur panas tidak diukur
+};
+
+#endif
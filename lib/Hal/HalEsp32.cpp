@@ -0,0 +1,211 @@
+#ifdef ARDUINO
+
+#include "HalEsp32.h"
+#include <esp_arduino_version.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
+
+// Sebelum SNTP menjawab, jam sistem mulai dari epoch 0 (1970)
+static const time_t EPOCH_VALID_MIN = 1700000000;   // Nov 2023
+
+void Esp32Clock::mulaiSntp(const char *server1, const char *server2) {
+  sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+  configTime(0, 0, server1, server2);
+}
+
+bool Esp32Clock::epochUs(uint64_t &us) {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (tv.tv_sec < EPOCH_VALID_MIN) return false;
+  us = (uint64_t)tv.tv_sec * 1000000ULL + (uint64_t)tv.tv_usec;
+  return true;
+}
+
+volatile uint32_t Esp32Adc::siap = 0;
+
+// I2C tidak boleh dipakai di ISR; ISR hanya menghitung, hasil dibaca di task
+void IRAM_ATTR Esp32Adc::isrRdy() {
+  siap = siap + 1;
+}
+
+TaskHandle_t Esp32Timer::task = nullptr;
+
+void IRAM_ATTR Esp32Timer::isrTimer() {
+  BaseType_t bangunkan = pdFALSE;
+  vTaskNotifyGiveFromISR(task, &bangunkan);
+  if (bangunkan) portYIELD_FROM_ISR();
+}
+
+bool Esp32Timer::mulai(uint32_t periodeUs) {
+  task = xTaskGetCurrentTaskHandle();
+  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+    timer = timerBegin(1000000);            // 1 MHz -> 1 count = 1 us
+    if (timer == nullptr) return false;
+    timerAttachInterrupt(timer, isrTimer);
+    timerAlarm(timer, periodeUs, true, 0);
+  #else
+    timer = timerBegin(0, 80, true);        // APB 80 MHz / 80 = 1 us
+    if (timer == nullptr) return false;
+    timerAttachInterrupt(timer, isrTimer, true);
+    timerAlarmWrite(timer, periodeUs, true);
+    timerAlarmEnable(timer);
+  #endif
+  return true;
+}
+
+bool Esp32Adc::mulaiKontinu(uint8_t kanal, uint16_t sps) {
+  // Data rate ADS1115 diskrit: pilih yang >= sps diminta
+  uint16_t rate;
+  if (sps <= 8) rate = RATE_ADS1115_8SPS;
+  else if (sps <= 16) rate = RATE_ADS1115_16SPS;
+  else if (sps <= 32) rate = RATE_ADS1115_32SPS;
+  else if (sps <= 64) rate = RATE_ADS1115_64SPS;
+  else if (sps <= 128) rate = RATE_ADS1115_128SPS;
+  else if (sps <= 250) rate = RATE_ADS1115_250SPS;
+  else if (sps <= 475) rate = RATE_ADS1115_475SPS;
+  else rate = RATE_ADS1115_860SPS;
+  ads.setDataRate(rate);
+
+  pinMode(pinRdy, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(pinRdy), isrRdy, FALLING);
+
+  // Mode kontinu juga mengaktifkan ALERT/RDY sebagai sinyal conversion-ready
+  static const uint16_t MUX[4] = {
+    ADS1X15_REG_CONFIG_MUX_SINGLE_0, ADS1X15_REG_CONFIG_MUX_SINGLE_1,
+    ADS1X15_REG_CONFIG_MUX_SINGLE_2, ADS1X15_REG_CONFIG_MUX_SINGLE_3
+  };
+  ads.startADCReading(MUX[kanal & 3], true);
+  return true;
+}
+
+uint8_t Esp32Suhu::mulai(uint8_t resolusiBit) {
+  sensors.begin();
+  uint8_t n = sensors.getDeviceCount();
+  jumlahProbe = 0;
+  for (uint8_t i = 0; i < n && jumlahProbe < SUHU_MAKS_PROBE; i++) {
+    if (sensors.getAddress(alamat[jumlahProbe], i)) jumlahProbe++;
+  }
+  setResolusi(resolusiBit);
+  // requestTemperatures() langsung kembali, hasil diambil belakangan
+  sensors.setWaitForConversion(false);
+  return jumlahProbe;
+}
+
+void Esp32Suhu::setResolusi(uint8_t resolusiBit) {
+  for (uint8_t i = 0; i < jumlahProbe; i++) sensors.setResolution(alamat[i], resolusiBit);
+}
+
+float Esp32Suhu::bacaC(uint8_t index) {
+  if (index >= jumlahProbe) return DEVICE_DISCONNECTED_C;
+  return sensors.getTempC(alamat[index]);
+}
+
+bool Esp32Berkas::mulai() {
+  return LittleFS.begin(true);
+}
+
+bool Esp32Berkas::tambah(const char *path, const uint8_t *data, size_t len) {
+  File f = LittleFS.open(path, FILE_APPEND);
+  if (!f) return false;
+  size_t n = f.write(data, len);
+  f.close();
+  return n == len;
+}
+
+bool Esp32Berkas::tulis(const char *path, const uint8_t *data, size_t len) {
+  File f = LittleFS.open(path, FILE_WRITE);
+  if (!f) return false;
+  size_t n = f.write(data, len);
+  f.close();
+  return n == len;
+}
+
+size_t Esp32Berkas::baca(const char *path, size_t offset, uint8_t *buf, size_t len) {
+  File f = LittleFS.open(path, FILE_READ);
+  if (!f) return 0;
+  size_t n = f.seek(offset) ? f.read(buf, len) : 0;
+  f.close();
+  return n;
+}
+
+long Esp32Berkas::ukuran(const char *path) {
+  if (!LittleFS.exists(path)) return -1;
+  File f = LittleFS.open(path, FILE_READ);
+  if (!f) return -1;
+  long n = (long)f.size();
+  f.close();
+  return n;
+}
+
+void Esp32Berkas::daftar(const char *dir, void (*fn)(const char *nama, void *ctx), void *ctx) {
+  File d = LittleFS.open(dir);
+  if (!d || !d.isDirectory()) { LittleFS.mkdir(dir); return; }
+  for (File f = d.openNextFile(); f; f = d.openNextFile()) {
+    // name() tanpa path di core 2.x+, dengan path di core lama
+    const char *nama = f.name();
+    const char *garis = strrchr(nama, '/');
+    fn(garis ? garis + 1 : nama, ctx);
+  }
+}
+
+void Esp32Pwm::begin(int freq, int resolusi) {
+  for (int k = 0; k < 2; k++) {
+    pinMode(pin[k].in1, OUTPUT); pinMode(pin[k].in2, OUTPUT);
+  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+    ledcAttach(pin[k].en, freq, resolusi);
+  #else
+    ledcSetup(k, freq, resolusi); ledcAttachPin(pin[k].en, k);
+  #endif
+  }
+}
+
+void Esp32Pwm::tulis(KanalPwm kanal, int duty) {
+  const Pin &p = pin[kanal];
+  if (duty > 0) {
+    digitalWrite(p.in1, HIGH); digitalWrite(p.in2, LOW);
+  } else {
+    digitalWrite(p.in1, LOW); digitalWrite(p.in2, LOW);
+  }
+
+  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
+    ledcWrite(p.en, duty);
+  #else
+    ledcWrite(kanal, duty);
+  #endif
+}
+
+void Esp32Wifi::mulai(const char *ssid, const char *password, const uint8_t *bssid, int32_t kanal,
+                      const IpStatis &ip) {
+  WiFi.mode(WIFI_STA);
+  WiFi.setAutoReconnect(false);
+  WiFi.disconnect(false);
+  // IP statis: lewati DHCP (~0.5-2 s lebih cepat sampai terhubung)
+  if (ip.aktif) {
+    WiFi.config(IPAddress(ip.ip[0], ip.ip[1], ip.ip[2], ip.ip[3]),
+                IPAddress(ip.gateway[0], ip.gateway[1], ip.gateway[2], ip.gateway[3]),
+                IPAddress(ip.subnet[0], ip.subnet[1], ip.subnet[2], ip.subnet[3]),
+                IPAddress(ip.dns[0], ip.dns[1], ip.dns[2], ip.dns[3]));
+  } else {
+    WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+  }
+  WiFi.begin(ssid, password, kanal, bssid);   // langsung kembali
+}
+
+StatusWifi Esp32Wifi::status() {
+  switch (WiFi.status()) {
+    case WL_CONNECTED: return WIFI_TERHUBUNG;
+    case WL_NO_SSID_AVAIL:
+    case WL_CONNECT_FAILED: return WIFI_GAGAL;
+    case WL_CONNECTION_LOST: return WIFI_PUTUS;
+    default: return WIFI_MENYAMBUNG;
+  }
+}
+
+void Esp32Wifi::infoAp(uint8_t bssid[6], int32_t &kanal) {
+  const uint8_t *b = WiFi.BSSID();
+  if (b) memcpy(bssid, b, 6);
+  else memset(bssid, 0, 6);
+  kanal = WiFi.channel();
+}
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * Implementasi HAL untuk ESP32 (Arduino framework).
+ * Objek library (ads, sensors, mqttClient) tetap dimiliki main.cpp,
+ * kelas di sini hanya membungkusnya.
+ */
+
+#ifndef AQUARIUM_HAL_ESP32_H
+#define AQUARIUM_HAL_ESP32_H
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include <DallasTemperature.h>
+#include <Adafruit_ADS1X15.h>
+#include <LittleFS.h>
+#include "Hal.h"
+
+class Esp32Clock : public HalClock {
+public:
+  unsigned long millis() override { return ::millis(); }
+  unsigned long micros() override { return ::micros(); }
+  void delay(unsigned long ms) override { ::delay(ms); }
+  bool epochUs(uint64_t &us) override;
+  // SNTP mode smooth: selisih kecil di-slew (adjtime), jam tidak meloncat
+  // di tengah pengukuran latensi. Boleh sebelum WiFi terhubung.
+  void mulaiSntp(const char *server1, const char *server2);
+};
+
+// Hardware timer -> ISR -> task notification ke task yang memanggil mulai()
+class Esp32Timer : public HalTimer {
+public:
+  bool mulai(uint32_t periodeUs) override;
+  uint32_t tunggu() override { return ulTaskNotifyTake(pdTRUE, portMAX_DELAY); }
+private:
+  static void IRAM_ATTR isrTimer();
+  static TaskHandle_t task;
+  hw_timer_t *timer = nullptr;
+};
+
+// Pin ALERT/RDY ADS1115 (open-drain, pulsa LOW tiap konversi selesai)
+class Esp32Adc : public HalAdc {
+public:
+  Esp32Adc(Adafruit_ADS1115 &ads, int pinRdy) : ads(ads), pinRdy(pinRdy) {}
+  int16_t readSingleEnded(uint8_t kanal) override { return ads.readADC_SingleEnded(kanal); }
+  bool mulaiKontinu(uint8_t kanal, uint16_t sps) override;
+  uint32_t jumlahSiap() override { return siap; }
+  int16_t hasilTerakhir() override { return ads.getLastConversionResults(); }
+private:
+  static void IRAM_ATTR isrRdy();
+  static volatile uint32_t siap;
+  Adafruit_ADS1115 &ads;
+  int pinRdy;
+};
+
+// Alamat probe di-cache saat mulai(), jadi baca per probe tanpa search bus
+class Esp32Suhu : public HalSuhu {
+public:
+  explicit Esp32Suhu(DallasTemperature &sensors) : sensors(sensors) {}
+  uint8_t mulai(uint8_t resolusiBit) override;
+  void setResolusi(uint8_t resolusiBit) override;
+  void mintaKonversi() override { sensors.requestTemperatures(); }
+  bool konversiSelesai() override { return sensors.isConversionComplete(); }
+  float bacaC(uint8_t index) override;
+private:
+  DallasTemperature &sensors;
+  DeviceAddress alamat[SUHU_MAKS_PROBE];
+  uint8_t jumlahProbe = 0;
+};
+
+// PWM LEDC + pin arah L298N
+class Esp32Pwm : public HalPwm {
+public:
+  struct Pin { int en; int in1; int in2; };
+  Esp32Pwm(Pin heater, Pin pompa) : pin{heater, pompa} {}
+  void begin(int freq, int resolusi);
+  void tulis(KanalPwm kanal, int duty) override;
+private:
+  Pin pin[2];
+};
+
+// LittleFS (partisi spiffs), diformat otomatis jika belum pernah
+class Esp32Berkas : public HalBerkas {
+public:
+  bool mulai() override;
+  bool tambah(const char *path, const uint8_t *data, size_t len) override;
+  bool tulis(const char *path, const uint8_t *data, size_t len) override;
+  size_t baca(const char *path, size_t offset, uint8_t *buf, size_t len) override;
+  long ukuran(const char *path) override;
+  bool hapus(const char *path) override { return LittleFS.remove(path); }
+  void daftar(const char *dir, void (*fn)(const char *nama, void *ctx), void *ctx) override;
+};
+
+// Reconnect otomatis bawaan core dimatikan: ManajerKoneksi yang mengatur
+class Esp32Wifi : public HalWifi {
+public:
+  void mulai(const char *ssid, const char *password, const uint8_t *bssid, int32_t kanal,
+             const IpStatis &ip) override;
+  StatusWifi status() override;
+  void putus() override { WiFi.disconnect(false); }
+  void infoAp(uint8_t bssid[6], int32_t &kanal) override;
+  int32_t rssi() override { return WiFi.RSSI(); }
+};
+
+class Esp32Mqtt : public HalMqtt {
+public:
+  explicit Esp32Mqtt(PubSubClient &client) : client(client) {}
+  bool sambung(const char *clientId) override { return client.connect(clientId); }
+  bool connected() override { return client.connected(); }
+  bool publish(const char *topic, const char *payload, bool retained) override {
+    return client.publish(topic, payload, retained);
+  }
+  bool publish(const char *topic, const uint8_t *payload, size_t len, bool retained) override {
+    return client.publish(topic, payload, (unsigned int)len, retained);
+  }
+private:
+  PubSubClient &client;
+};
+
+#endif
+#endif
@@ -0,0 +1,138 @@
+#ifndef ARDUINO
+
+#include "HalNative.h"
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <string.h>
+
+static long long sekarangNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+NativeClock::NativeClock() : awalNs(sekarangNs()) {}
+
+unsigned long NativeClock::millis() {
+  return (unsigned long)((sekarangNs() - awalNs) / 1000000LL);
+}
+
+unsigned long NativeClock::micros() {
+  return (unsigned long)((sekarangNs() - awalNs) / 1000LL);
+}
+
+void NativeClock::delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+bool NativeClock::epochUs(uint64_t &us) {
+  us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  return true;
+}
+
+void NativeWifi::mulai(const char *ssid, const char *password, const uint8_t *bssid, int32_t kanal,
+                       const IpStatis &ip) {
+  jumlahMulai++;
+  menyambung = true;
+  mulaiMs = jam.millis();
+  statis = ip.aktif;
+  apAktif = apTarget = -1;
+  cepat = false;
+  for (size_t i = 0; i < ap.size(); i++) {
+    if (ap[i].ssid != ssid || ap[i].password != (password ? password : "")) continue;
+    // BSSID/kanal diberikan tapi tidak cocok: hanya kanal itu yang di-scan -> gagal cepat
+    if (bssid && (memcmp(bssid, ap[i].bssid, 6) != 0 || kanal != ap[i].kanal)) continue;
+    apTarget = (int)i;
+    cepat = bssid != nullptr;
+  }
+  if (cepat) jumlahCepat++;
+}
+
+StatusWifi NativeWifi::status() {
+  if (apAktif >= 0) {
+    if (ap[apAktif].hidup) return WIFI_TERHUBUNG;
+    apAktif = -1;
+    return WIFI_PUTUS;
+  }
+  if (!menyambung) return WIFI_PUTUS;
+  const unsigned long lama = jam.millis() - mulaiMs;
+  if (apTarget < 0 || !ap[apTarget].hidup) return lama >= (cepat ? lamaCepatMs : lamaScanMs) ? WIFI_GAGAL : WIFI_MENYAMBUNG;
+  if (lama < (cepat ? lamaCepatMs : lamaAsosiasiMs) + (statis ? 0 : lamaDhcpMs)) return WIFI_MENYAMBUNG;
+  apAktif = apTarget;
+  menyambung = false;
+  return WIFI_TERHUBUNG;
+}
+
+void NativeWifi::infoAp(uint8_t bssid[6], int32_t &kanal) {
+  if (apAktif < 0) {
+    memset(bssid, 0, 6);
+    kanal = 0;
+    return;
+  }
+  memcpy(bssid, ap[apAktif].bssid, 6);
+  kanal = ap[apAktif].kanal;
+}
+
+bool NativeMqtt::publish(const char *topic, const char *payload, bool) {
+  if (!online) return false;
+  jumlahPublish++;
+  topikTerakhir = topic;
+  payloadTerakhir = payload;
+  if (pendengar) pendengar(topikTerakhir, payloadTerakhir);
+  return true;
+}
+
+bool NativeMqtt::publish(const char *topic, const uint8_t *payload, size_t len, bool) {
+  if (!online) return false;
+  jumlahPublish++;
+  topikTerakhir = topic;
+  payloadTerakhir.assign((const char *)payload, len);
+  if (pendengar) pendengar(topikTerakhir, payloadTerakhir);
+  return true;
+}
+
+size_t NativeBerkas::totalByte() const {
+  size_t n = 0;
+  for (const auto &b : berkas) n += b.second.size();
+  return n;
+}
+
+bool NativeBerkas::tambah(const char *path, const uint8_t *data, size_t len) {
+  if (!siap || gagalTulis || totalByte() + len > kapasitasByte) return false;
+  std::vector<uint8_t> &isi = berkas[path];
+  isi.insert(isi.end(), data, data + len);
+  jumlahTulis++;
+  return true;
+}
+
+bool NativeBerkas::tulis(const char *path, const uint8_t *data, size_t len) {
+  if (!siap || gagalTulis) return false;
+  berkas[path].assign(data, data + len);
+  jumlahTulis++;
+  return true;
+}
+
+size_t NativeBerkas::baca(const char *path, size_t offset, uint8_t *buf, size_t len) {
+  auto it = berkas.find(path);
+  if (it == berkas.end() || offset >= it->second.size()) return 0;
+  size_t n = std::min(len, it->second.size() - offset);
+  std::copy(it->second.begin() + offset, it->second.begin() + offset + n, buf);
+  return n;
+}
+
+long NativeBerkas::ukuran(const char *path) {
+  auto it = berkas.find(path);
+  return (it == berkas.end()) ? -1 : (long)it->second.size();
+}
+
+void NativeBerkas::daftar(const char *dir, void (*fn)(const char *nama, void *ctx), void *ctx) {
+  std::string awalan = std::string(dir) + "/";
+  for (const auto &b : berkas) {
+    if (b.first.compare(0, awalan.size(), awalan) != 0) continue;
+    std::string nama = b.first.substr(awalan.size());
+    if (nama.find('/') == std::string::npos) fn(nama.c_str(), ctx);
+  }
+}
+
+#endif
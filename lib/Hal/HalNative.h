@@ -0,0 +1,164 @@
+/**
+ * Implementasi HAL untuk build native (Linux/host).
+ * Dipakai oleh benchmark & tools di folder tools/. Semua "hardware"
+ * di sini hanya variabel biasa yang bisa diisi/dibaca dari luar.
+ */
+
+#ifndef AQUARIUM_HAL_NATIVE_H
+#define AQUARIUM_HAL_NATIVE_H
+
+#ifndef ARDUINO
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "Hal.h"
+
+// Jam asli (steady_clock), dihitung sejak objek dibuat
+class NativeClock : public HalClock {
+public:
+  NativeClock();
+  unsigned long millis() override;
+  unsigned long micros() override;
+  void delay(unsigned long ms) override;
+  bool epochUs(uint64_t &us) override;   // jam sistem host (NTP milik OS)
+private:
+  long long awalNs;
+};
+
+// Jam simulasi: waktu hanya maju lewat maju() atau delay()
+class SimClock : public HalClock {
+public:
+  unsigned long millis() override { return (unsigned long)(us / 1000ULL); }
+  unsigned long micros() override { return (unsigned long)us; }
+  void delay(unsigned long ms) override { us += (unsigned long long)ms * 1000ULL; }
+  void maju(unsigned long ms) { delay(ms); }
+  void majuUs(unsigned long long d) { us += d; }
+  // Pengganti SNTP untuk uji offline: epoch = epochAwalUs + us (0 = belum sinkron)
+  bool epochUs(uint64_t &e) override {
+    if (epochAwalUs == 0) return false;
+    e = epochAwalUs + us;
+    return true;
+  }
+  unsigned long long us = 0;
+  uint64_t epochAwalUs = 0;
+};
+
+// Timer simulasi: tunggu() memajukan SimClock satu periode
+class SimTimer : public HalTimer {
+public:
+  explicit SimTimer(SimClock &jam) : jam(jam) {}
+  bool mulai(uint32_t p) override { periodeUs = p; return true; }
+  uint32_t tunggu() override { jam.majuUs(periodeUs); return 1; }
+  uint32_t periodeUs = 1000;
+private:
+  SimClock &jam;
+};
+
+// konversi() meniru satu pulsa RDY: isi hasil baru & naikkan counter
+class NativeAdc : public HalAdc {
+public:
+  int16_t readSingleEnded(uint8_t) override { return nilai; }
+  bool mulaiKontinu(uint8_t, uint16_t) override { return true; }
+  uint32_t jumlahSiap() override { return siap; }
+  int16_t hasilTerakhir() override { return nilai; }
+  void konversi(int16_t v) { nilai = v; siap++; }
+  int16_t nilai = 0;
+  uint32_t siap = 0;
+};
+
+// Konversi dianggap langsung selesai; suhu probe 0 = suhu, sisanya suhuProbe[]
+class NativeSuhu : public HalSuhu {
+public:
+  uint8_t mulai(uint8_t resolusiBit) override { resolusi = resolusiBit; return jumlahProbe; }
+  void setResolusi(uint8_t resolusiBit) override { resolusi = resolusiBit; }
+  void mintaKonversi() override { jumlahKonversi++; }
+  bool konversiSelesai() override { return true; }
+  float bacaC(uint8_t index) override { return (index == 0) ? suhu : suhuProbe[index]; }
+  float suhu = 25.0f;
+  float suhuProbe[SUHU_MAKS_PROBE] = {25.0f, 25.0f, 25.0f, 25.0f};
+  uint8_t jumlahProbe = 1;
+  uint8_t resolusi = 12;
+  unsigned long jumlahKonversi = 0;
+};
+
+class NativePwm : public HalPwm {
+public:
+  void tulis(KanalPwm kanal, int d) override { duty[kanal] = d; }
+  int duty[2] = {0, 0};
+};
+
+// AP pengganti di atas jam (biasanya SimClock). SSID yang tidak ada / mati
+// gagal setelah lamaScanMs; asosiasi selesai setelah lamaAsosiasiMs, atau
+// lamaCepatMs jika BSSID & kanal yang diberikan cocok, ditambah lamaDhcpMs
+// tanpa IP statis. AP yang dimatikan (hidup = false) memutus koneksi.
+class NativeWifi : public HalWifi {
+public:
+  struct Ap {
+    std::string ssid, password;
+    uint8_t bssid[6];
+    int32_t kanal;
+    bool hidup;
+  };
+  explicit NativeWifi(HalClock &jam) : jam(jam) {}
+  void mulai(const char *ssid, const char *password, const uint8_t *bssid, int32_t kanal,
+             const IpStatis &ip) override;
+  StatusWifi status() override;
+  void putus() override { menyambung = false; apAktif = -1; }
+  void infoAp(uint8_t bssid[6], int32_t &kanal) override;
+  int32_t rssi() override { return apAktif >= 0 ? -60 : 0; }
+
+  std::vector<Ap> ap;
+  unsigned long lamaScanMs = 2000, lamaAsosiasiMs = 3000, lamaCepatMs = 300, lamaDhcpMs = 500;
+  unsigned long jumlahMulai = 0, jumlahCepat = 0;
+private:
+  HalClock &jam;
+  int apAktif = -1, apTarget = -1;
+  bool menyambung = false, cepat = false, statis = false;
+  unsigned long mulaiMs = 0;
+};
+
+// Broker pengganti: simpan pesan terakhir + hitung jumlah publish.
+// pendengar (opsional) menerima setiap pesan, mis. untuk dekode di tools.
+// sambung() berhasil hanya jika brokerHidup; online = false meniru koneksi putus.
+class NativeMqtt : public HalMqtt {
+public:
+  bool sambung(const char *) override {
+    jumlahSambung++;
+    online = brokerHidup;
+    return online;
+  }
+  bool connected() override { return online; }
+  bool publish(const char *topic, const char *payload, bool retained) override;
+  bool publish(const char *topic, const uint8_t *payload, size_t len, bool retained) override;
+  bool online = true;
+  bool brokerHidup = true;
+  unsigned long jumlahPublish = 0, jumlahSambung = 0;
+  std::string topikTerakhir;
+  std::string payloadTerakhir;
+  std::function<void(const std::string &topik, const std::string &payload)> pendengar;
+};
+
+// Flash pengganti: berkas di memori, bisa dibatasi kapasitas / dibuat gagal.
+// Objek yang sama bisa dipakai ulang untuk meniru restart (isi tetap ada).
+class NativeBerkas : public HalBerkas {
+public:
+  bool mulai() override { return siap; }
+  bool tambah(const char *path, const uint8_t *data, size_t len) override;
+  bool tulis(const char *path, const uint8_t *data, size_t len) override;
+  size_t baca(const char *path, size_t offset, uint8_t *buf, size_t len) override;
+  long ukuran(const char *path) override;
+  bool hapus(const char *path) override { return berkas.erase(path) > 0; }
+  void daftar(const char *dir, void (*fn)(const char *nama, void *ctx), void *ctx) override;
+  size_t totalByte() const;
+
+  std::map<std::string, std::vector<uint8_t>> berkas;
+  bool siap = true;
+  bool gagalTulis = false;
+  size_t kapasitasByte = 1536 * 1024;   // kira-kira partisi spiffs default
+  unsigned long jumlahTulis = 0;        // operasi tulis (indikasi keausan)
+};
+
+#endif
+#endif
@@ -0,0 +1,57 @@
+#include "Aktuator.h"
+#include <math.h>
+#include "Kontrol.h"
+
+// map() lama dalam fraksi: logika*2.55 in [PWM_START_LOGIKA, 255] -> [PWM_MIN_FISIK, 255]
+static constexpr float dutyPompaLama(int titik) {
+  return (PWM_MIN_FISIK + (titik * 25.5f - PWM_START_LOGIKA) * (255 - PWM_MIN_FISIK) / (255 - PWM_START_LOGIKA)) /
+         255.0f;
+}
+
+const KurvaAktuator KURVA_HEATER_DEFAULT = {{0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f}, 0.0f};
+const KurvaAktuator KURVA_POMPA_DEFAULT = {
+  {dutyPompaLama(0), dutyPompaLama(1), dutyPompaLama(2), dutyPompaLama(3), dutyPompaLama(4), dutyPompaLama(5),
+   dutyPompaLama(6), dutyPompaLama(7), dutyPompaLama(8), dutyPompaLama(9), 1.0f},
+  PWM_START_LOGIKA / 2.55f};
+
+bool kurvaAktuatorValid(const KurvaAktuator &k) {
+  if (!(k.ambangMati >= 0.0f && k.ambangMati <= 100.0f)) return false;
+  for (int i = 0; i < KURVA_AKTUATOR_TITIK; i++) {
+    if (!(k.duty[i] >= 0.0f && k.duty[i] <= 1.0f)) return false;
+    if (i > 0 && k.duty[i] < k.duty[i - 1]) return false;
+  }
+  return true;
+}
+
+float dutyLinear(const KurvaAktuator &k, float persen) {
+  if (!(persen > k.ambangMati)) return 0.0f;   // termasuk NaN
+  if (persen >= 100.0f) return k.duty[KURVA_AKTUATOR_TITIK - 1] * PWM_DUTY_MAKS;
+  const float x = persen * ((KURVA_AKTUATOR_TITIK - 1) / 100.0f);
+  const int i = (int)x;
+  const float f = k.duty[i] + (k.duty[i + 1] - k.duty[i]) * (x - i);
+  return f * PWM_DUTY_MAKS;
+}
+
+int kuantisasiDuty(float ideal, float *sisaDither) {
+  if (!sisaDither) return batasi((int)(ideal + 0.5f), 0, PWM_DUTY_MAKS);
+  if (ideal <= 0.0f) {
+    *sisaDither = 0.0f;   // mati = mati, tanpa pulsa sisa
+    return 0;
+  }
+  const float v = ideal + *sisaDither;
+  const int d = batasi((int)floorf(v + 0.5f), 0, PWM_DUTY_MAKS);
+  *sisaDither = batasi(v - d, -1.0f, 1.0f);
+  return d;
+}
+
+int setHeaterSpeed(HalPwm &pwm, const KurvaAktuator &k, float persen, float *sisaDither) {
+  const int d = kuantisasiDuty(dutyLinear(k, persen), sisaDither);
+  pwm.tulis(KANAL_HEATER, d);
+  return d;
+}
+
+int setPumpSpeed(HalPwm &pwm, const KurvaAktuator &k, float persen) {
+  const int d = kuantisasiDuty(dutyLinear(k, persen), nullptr);
+  pwm.tulis(KANAL_POMPA, d);
+  return d;
+}
@@ -0,0 +1,58 @@
+/**
+ * KONTROL MOTOR L298N (Pemanas & Pompa) lewat HAL.
+ * * Deskripsi:
+ * Output kontrol (logika 0-100%) diubah ke duty LEDC lewat kurva
+ * linearisasi per aktuator, lalu ditulis dengan resolusi PWM_RESOLUTION.
+ * - Kurva: duty (fraksi 0-1) di logika 0, 10, ..., 100%, interpolasi
+ *   linear; logika <= ambangMati = mati total. duty[0] = tepi dead band
+ *   (pompa tidak berputar di bawahnya), jadi logika kecil langsung bertenaga.
+ * - Kurva bawaan = perilaku lama (heater linear, pompa 235..255 dari
+ *   logika 5/255); hasil ukur: KalibrasiAktuator.h.
+ * - Heater opsional sigma-delta orde-1: sisa kuantisasi dibawa ke tick
+ *   berikutnya, rata-rata duty = nilai ideal walau di bawah 1 LSB.
+ */
+
+#ifndef AQUARIUM_AKTUATOR_H
+#define AQUARIUM_AKTUATOR_H
+
+#include "Hal.h"
+
+// Setting PWM. LEDC ESP32 @ 1 kHz sanggup s.d. 16 bit; -DPWM_RESOLUSI_BIT=8 = perilaku lama
+#ifndef PWM_RESOLUSI_BIT
+#define PWM_RESOLUSI_BIT 12
+#endif
+#ifndef AKTUATOR_DITHER_HEATER
+#define AKTUATOR_DITHER_HEATER (PWM_RESOLUSI_BIT < 10)   // default: hanya jika resolusi kasar
+#endif
+
+const int PWM_FREQ = 1000;
+const int PWM_RESOLUTION = PWM_RESOLUSI_BIT;
+const int PWM_DUTY_MAKS = (1 << PWM_RESOLUTION) - 1;
+// Kurva pompa bawaan (skala 8 bit, seperti map() lama)
+const int PWM_MIN_FISIK = 235;
+const int PWM_START_LOGIKA = 5;
+
+const int KURVA_AKTUATOR_TITIK = 11;   // logika 0, 10, ..., 100%
+
+struct KurvaAktuator {
+  float duty[KURVA_AKTUATOR_TITIK];   // fraksi 0-1, tidak turun
+  float ambangMati;                   // logika (%) <= ini -> duty 0
+};
+
+extern const KurvaAktuator KURVA_HEATER_DEFAULT;
+extern const KurvaAktuator KURVA_POMPA_DEFAULT;
+
+// false jika duty di luar 0-1 / NaN / turun atau ambang di luar 0-100
+bool kurvaAktuatorValid(const KurvaAktuator &k);
+
+// Duty ideal (count, 0-PWM_DUTY_MAKS, belum dibulatkan) untuk logika persen
+float dutyLinear(const KurvaAktuator &k, float persen);
+
+// Bulatkan duty ideal; sisaDither != nullptr -> sigma-delta (sisa dibawa ke panggilan berikutnya)
+int kuantisasiDuty(float ideal, float *sisaDither);
+
+// Tulis ke driver, return duty yang ditulis (count)
+int setHeaterSpeed(HalPwm &pwm, const KurvaAktuator &k, float persen, float *sisaDither = nullptr);
+int setPumpSpeed(HalPwm &pwm, const KurvaAktuator &k, float persen);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * ANTRIAN SPSC LOCK-FREE (SATU PRODUSEN, SATU KONSUMEN)
+ * * Deskripsi:
+ * Ring buffer kapasitas tetap untuk mengirim data antar core tanpa lock.
+ * - Produsen (task kontrol) hanya menulis ekor, konsumen (task jaringan)
+ *   hanya menulis kepala; sinkronisasi lewat acquire/release.
+ * - Penuh = data baru dibuang & dihitung (produsen real-time tidak boleh
+ *   menunggu konsumen).
+ * - N harus pangkat 2 (indeks pakai mask, counter boleh overflow).
+ */
+
+#ifndef AQUARIUM_ANTRIAN_SPSC_H
+#define AQUARIUM_ANTRIAN_SPSC_H
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, uint32_t N>
+class AntrianSpsc {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "kapasitas harus pangkat 2");
+
+public:
+  // Dipanggil produsen; false jika penuh (data dibuang)
+  bool kirim(const T &v) {
+    uint32_t e = ekor.load(std::memory_order_relaxed);
+    if (e - kepala.load(std::memory_order_acquire) == N) {
+      terbuang.store(terbuang.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return false;
+    }
+    slot[e & (N - 1)] = v;
+    ekor.store(e + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Dipanggil konsumen; false jika kosong
+  bool ambil(T &v) {
+    uint32_t k = kepala.load(std::memory_order_relaxed);
+    if (k == ekor.load(std::memory_order_acquire)) return false;
+    v = slot[k & (N - 1)];
+    kepala.store(k + 1, std::memory_order_release);
+    return true;
+  }
+
+  uint32_t jumlahTerbuang() const { return terbuang.load(std::memory_order_relaxed); }
+  static constexpr uint32_t kapasitas() { return N; }
+
+private:
+  // Kepala & ekor di cache line berbeda (native); di ESP32 hanya padding
+  alignas(64) std::atomic<uint32_t> kepala{0};
+  alignas(64) std::atomic<uint32_t> ekor{0};
+  std::atomic<uint32_t> terbuang{0};
+  T slot[N];
+};
+
+#endif
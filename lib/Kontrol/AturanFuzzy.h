@@ -0,0 +1,107 @@
+/**
+ * RULE BASE FUZZY (SUHU, KERUH, PD-SUHU)
+ * * Deskripsi:
+ * Breakpoint & konsekuen yang dulu tertanam di 10 fungsi membership*,
+ * sekarang konstanta constexpr untuk mesin FuzzySugeno.
+ * - Default disimpan di flash, LUT default dipanggang saat kompilasi.
+ * - Salinan runtime (aturanFuzzy) bisa diganti lewat MQTT, lalu LUT
+ *   dipanggang ulang dengan siapkanFuzzyLut().
+ */
+
+#ifndef AQUARIUM_ATURAN_FUZZY_H
+#define AQUARIUM_ATURAN_FUZZY_H
+
+#include "FuzzySugeno.h"
+#include "FuzzyLut.h"
+
+constexpr int FUZZY_N_HIMPUNAN = 5;
+
+typedef FuzzySugeno<FUZZY_N_HIMPUNAN, 1> Fuzzy1;
+typedef FuzzySugeno<FUZZY_N_HIMPUNAN, 2> Fuzzy2;
+typedef FuzzyLut<FUZZY_LUT_RESOLUSI> LutFuzzy;
+
+// Rentang input LUT; di luar rentang ini output fuzzy sudah konstan
+constexpr float LUT_SUHU_MIN = -5.0f, LUT_SUHU_MAX = 5.0f;
+constexpr float LUT_KERUH_MIN = -7.0f, LUT_KERUH_MAX = 12.0f;
+
+// --- Fuzzy Suhu (error = setpoint - suhu) ---
+// Sangat Dingin, Dingin, Sesuai, Panas, Sangat Panas
+constexpr Trapesium HIMPUNAN_SUHU[FUZZY_N_HIMPUNAN] = {
+  bahuKanan(3.5f, 5.0f),
+  trapesium(1.5f, 2.5f, 3.5f, 4.5f),
+  trapesium(-1.0f, -0.3f, 0.3f, 2.0f),
+  trapesium(-3.5f, -2.5f, -1.0f, -0.5f),
+  bahuKiri(-4.5f, -3.0f),
+};
+constexpr float KONSEKUEN_SUHU[FUZZY_N_HIMPUNAN] = {95.0f, 75.0f, 25.0f, 5.0f, 0.0f};
+
+// --- Fuzzy Turbidity (error = turbidity - setpoint) ---
+// Sangat Jernih, Jernih, Sesuai, Keruh, Sangat Keruh
+constexpr Trapesium HIMPUNAN_KERUH[FUZZY_N_HIMPUNAN] = {
+  bahuKiri(-7.0f, -5.0f),
+  trapesium(-7.0f, -4.0f, -2.0f, -1.0f),
+  trapesium(-2.5f, -0.5f, 0.5f, 2.5f),
+  trapesium(1.0f, 4.0f, 7.0f, 10.0f),
+  bahuKanan(8.0f, 12.0f),
+};
+constexpr float KONSEKUEN_KERUH[FUZZY_N_HIMPUNAN] = {0.0f, 20.0f, 50.0f, 90.0f, 100.0f};
+
+// --- PD-Fuzzy Suhu: input 0 = error, input 1 = delta error (C/menit) ---
+// Turun Cepat, Turun, Tetap, Naik, Naik Cepat
+constexpr Trapesium HIMPUNAN_DELTA_SUHU[FUZZY_N_HIMPUNAN] = {
+  bahuKiri(-0.6f, -0.3f),
+  trapesium(-0.6f, -0.3f, -0.3f, 0.0f),
+  trapesium(-0.3f, 0.0f, 0.0f, 0.3f),
+  trapesium(0.0f, 0.3f, 0.3f, 0.6f),
+  bahuKanan(0.3f, 0.6f),
+};
+// Koreksi konsekuen suhu: error makin membesar -> tambah panas
+constexpr float KOREKSI_DELTA_SUHU[FUZZY_N_HIMPUNAN] = {-15.0f, -7.0f, 0.0f, 7.0f, 15.0f};
+
+constexpr Fuzzy2 buatFuzzySuhuPD() {
+  Fuzzy2 f;
+  for (int s = 0; s < FUZZY_N_HIMPUNAN; s++) {
+    f.setHimpunan(0, s, HIMPUNAN_SUHU[s]);
+    f.setHimpunan(1, s, HIMPUNAN_DELTA_SUHU[s]);
+  }
+  for (int j = 0; j < FUZZY_N_HIMPUNAN; j++) {
+    for (int i = 0; i < FUZZY_N_HIMPUNAN; i++) {
+      float y = KONSEKUEN_SUHU[i] + KOREKSI_DELTA_SUHU[j];
+      f.konsekuen[i + FUZZY_N_HIMPUNAN * j] = (y < 0.0f) ? 0.0f : ((y > 100.0f) ? 100.0f : y);
+    }
+  }
+  f.keluaranDefault = 25.0f;
+  return f;
+}
+
+// Semua rule base + LUT yang dipakai hitungKontrol()
+struct AturanFuzzy {
+  Fuzzy1 suhu;
+  Fuzzy1 keruh;
+  Fuzzy2 suhuPD;
+  LutFuzzy lutSuhu;
+  LutFuzzy lutKeruh;
+
+  // Panggang ulang LUT dari rule base saat ini (breakpoint jadi node tambahan)
+  constexpr void panggangLut() {
+    const Fuzzy1 &s = suhu, &k = keruh;
+    float patahS[4 * FUZZY_N_HIMPUNAN] = {}, patahK[4 * FUZZY_N_HIMPUNAN] = {};
+    const int nS = s.titikPatah(0, patahS), nK = k.titikPatah(0, patahK);
+    lutSuhu.bangun([&s](float x) { return s.hitung(x); }, LUT_SUHU_MIN, LUT_SUHU_MAX, patahS, nS);
+    lutKeruh.bangun([&k](float x) { return k.hitung(x); }, LUT_KERUH_MIN, LUT_KERUH_MAX, patahK, nK);
+  }
+};
+
+constexpr AturanFuzzy buatAturanFuzzyDefault() {
+  AturanFuzzy a;
+  a.suhu = buatFuzzy1(HIMPUNAN_SUHU, KONSEKUEN_SUHU, 25.0f);
+  a.keruh = buatFuzzy1(HIMPUNAN_KERUH, KONSEKUEN_KERUH, 50.0f);
+  a.suhuPD = buatFuzzySuhuPD();
+  a.panggangLut();
+  return a;
+}
+
+// Default lengkap (rule base + LUT) dihitung compiler, disimpan di flash
+constexpr AturanFuzzy ATURAN_FUZZY_DEFAULT = buatAturanFuzzyDefault();
+
+#endif
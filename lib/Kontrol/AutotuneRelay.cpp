@@ -0,0 +1,170 @@
+#include "AutotuneRelay.h"
+#include <math.h>
+#include <stdio.h>
+
+// Periode siklus ukur boleh menyebar sebesar ini dari rata-rata
+static const float SEBARAN_PERIODE_MAKS = 0.3f;
+
+PengaturanAutotune pengaturanAutotune(KanalPwm kanal, uint8_t resolusiSuhu) {
+  if (kanal == KANAL_HEATER) {
+    // Naik ~2.7 C/jam penuh vs turun ~0.3 C/jam (rugi ke ruang): siklus ~20-40 menit
+    const int langkah = AUTOTUNE_LANGKAH_HISTERESIS < 2 ? 2 : AUTOTUNE_LANGKAH_HISTERESIS;
+    const float h = (float)langkah * PipelineSuhu::langkahC(resolusiSuhu);
+    return {0.0f, 100.0f, h, 1.0f, 1.0f, 1, 3, 6UL * 3600000UL, 0.0f};
+  }
+  // Pompa mati: kotoran ~+2 %/jam; 60% aliran: turun ~50 %/jam
+  return {0.0f, 60.0f, 0.5f, -1.0f, 5.0f, 1, 3, 4UL * 3600000UL, 0.0f};
+}
+
+void AutotuneRelay::mulai(KanalPwm k, float sp, AturanAutotune a, bool terapkanHasil, const PengaturanAutotune &pa,
+                          unsigned long now) {
+  kanal = k;
+  setpoint = sp;
+  aturan = a;
+  terapkan = terapkanHasil;
+  terpasang = false;
+  p = pa;
+  if (p.siklusUkur < 1) p.siklusUkur = 1;
+  status = AUTOTUNE_BERJALAN;
+  alasan = "";
+  siklus = 0;
+  ku = pu = amplitudo = fraksiTinggi = kp = ki = kd = 0.0f;
+  awal = now;
+  pertama = true;
+  adaSiklus = false;
+  siklusSelesai = 0;
+  jumlahPeriode = jumlahFraksi = jumlahAmplitudo = 0.0;
+  tinggi = false;
+  awalRendah = now;
+  // Relay harus bisa berbalik dua kali di dalam pita aman
+  if (p.histeresis * 2.0f >= p.batasSimpang) gagal("histeresis terlalu besar untuk batas simpang");
+}
+
+void AutotuneRelay::batal() {
+  if (status == AUTOTUNE_BERJALAN) gagal("dibatalkan");
+}
+
+void AutotuneRelay::gagal(const char *kenapa) {
+  status = AUTOTUNE_GAGAL;
+  alasan = kenapa;
+}
+
+void AutotuneRelay::mulaiSiklus(float nilai, unsigned long now) {
+  awalSiklus = now;
+  yMaks = yMin = nilai;
+  adaSiklus = true;
+}
+
+float AutotuneRelay::langkah(float nilai, unsigned long now) {
+  if (status != AUTOTUNE_BERJALAN) return 0.0f;
+  if (!isfinite(nilai)) {
+    gagal("pembacaan tidak valid");
+    return 0.0f;
+  }
+  if (fabsf(nilai - setpoint) > p.batasSimpang) {
+    gagal(pertama ? "terlalu jauh dari setpoint" : "pembacaan menyimpang melewati batas");
+    return 0.0f;
+  }
+  pertama = false;
+  if (now - awal > p.durasiMaksMs) {
+    gagal("tidak ada osilasi stabil dalam batas waktu");
+    return 0.0f;
+  }
+  if (nilai > yMaks) yMaks = nilai;
+  if (nilai < yMin) yMin = nilai;
+
+  // Error arah kontrol: positif = perlu output lebih besar
+  const float e = p.arah * (setpoint - nilai);
+  if (!tinggi && e > p.histeresis) {
+    tinggi = true;
+    if (adaSiklus) {
+      // Siklus selesai (naik ke naik)
+      const float periode = (now - awalSiklus) / 1000.0f;
+      const float fraksi = (awalRendah - awalSiklus) / 1000.0f / periode;
+      const float amp = 0.5f * (yMaks - yMin);
+      if (++siklusSelesai > p.siklusBuang) {
+        if (siklus == 0) periodeMin = periodeMaks = periode;
+        periodeMin = fminf(periodeMin, periode);
+        periodeMaks = fmaxf(periodeMaks, periode);
+        jumlahPeriode += periode;
+        jumlahFraksi += fraksi;
+        jumlahAmplitudo += amp;
+        if (++siklus == p.siklusUkur) {
+          hitungGain();
+          return 0.0f;
+        }
+      }
+    }
+    mulaiSiklus(nilai, now);
+  } else if (tinggi && e < -p.histeresis) {
+    tinggi = false;
+    awalRendah = now;
+  }
+  return tinggi ? p.outTinggi : p.outRendah;
+}
+
+void AutotuneRelay::hitungGain() {
+  const double n = siklus;
+  pu = (float)(jumlahPeriode / n);
+  fraksiTinggi = (float)(jumlahFraksi / n);
+  amplitudo = (float)(jumlahAmplitudo / n);
+  if ((periodeMaks - periodeMin) > SEBARAN_PERIODE_MAKS * pu) {
+    gagal("periode osilasi tidak konsisten");
+    return;
+  }
+  if (amplitudo <= 0.0f || fraksiTinggi <= 0.0f || fraksiTinggi >= 1.0f) {
+    gagal("osilasi tidak terukur");
+    return;
+  }
+  // Harmonik pertama gelombang persegi tidak simetris
+  const double u1 = (p.outTinggi - p.outRendah) * (2.0 / M_PI) * sin(M_PI * fraksiTinggi);
+  ku = (float)(u1 / amplitudo);
+
+  double Kp, Ti, Td;
+  switch (aturan) {
+    case AUTOTUNE_ZN:
+      Kp = 0.6 * ku; Ti = 0.5 * pu; Td = pu / 8.0;
+      break;
+    case AUTOTUNE_TL:
+      Kp = ku / 2.2; Ti = 2.2 * pu; Td = pu / 6.3;
+      break;
+    default: {
+      // Integrator + waktu mati yang melewati titik relay yang sama
+      const double kAksen = 2.0 * M_PI / (pu * ku), theta = pu / 4.0;
+      const double tauC = p.tauC > 0.0f ? p.tauC : theta;
+      Kp = 1.0 / (kAksen * (tauC + theta)); Ti = 4.0 * (tauC + theta); Td = 0.0;
+      break;
+    }
+  }
+  kp = (float)Kp;
+  ki = (float)(Kp / Ti);
+  kd = (float)(Kp * Td);
+  status = AUTOTUNE_SELESAI;
+}
+
+bool terapkanAutotune(const AutotuneRelay &a, ParameterKontrol &p, float gainMaks) {
+  if (a.status != AUTOTUNE_SELESAI) return false;
+  const float g[3] = {a.kp, a.ki, a.kd};
+  for (float x : g)
+    if (!(x >= 0.0f && x <= gainMaks)) return false;
+  if (a.kanal == KANAL_HEATER) {
+    p.Kp_suhu = a.kp; p.Ki_suhu = a.ki; p.Kd_suhu = a.kd;
+  } else {
+    p.Kp_keruh = a.kp; p.Ki_keruh = a.ki; p.Kd_keruh = a.kd;
+  }
+  return true;
+}
+
+size_t serializeAutotune(const AutotuneRelay &a, char *buf, size_t len) {
+  static const char *const NAMA_STATUS[] = {"diam", "berjalan", "selesai", "gagal"};
+  static const char *const NAMA_ATURAN[] = {"simc", "zn", "tl"};
+  const int n = snprintf(buf, len,
+                         "{\"loop\":\"%s\",\"status\":\"%s\",\"alasan\":\"%s\",\"aturan\":\"%s\",\"terapkan\":%s,"
+                         "\"terpasang\":%s,\"setpoint\":%.2f,\"siklus\":%u,\"ku\":%.4g,\"pu_s\":%.1f,"
+                         "\"amplitudo\":%.4g,\"fraksi_tinggi\":%.3f,\"kp\":%.9g,\"ki\":%.9g,\"kd\":%.9g}",
+                         a.kanal == KANAL_HEATER ? "suhu" : "keruh", NAMA_STATUS[a.status], a.alasan,
+                         NAMA_ATURAN[a.aturan], a.terapkan ? "true" : "false", a.terpasang ? "true" : "false",
+                         a.setpoint, (unsigned)a.siklus, a.ku, a.pu, a.amplitudo, a.fraksiTinggi, a.kp, a.ki, a.kd);
+  if (n < 0 || (size_t)n >= len) return 0;
+  return (size_t)n;
+}
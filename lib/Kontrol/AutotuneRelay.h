@@ -0,0 +1,129 @@
+/**
+ * AUTOTUNE PID RELAY-FEEDBACK (ÅSTRÖM–HÄGGLUND, DI PERANGKAT)
+ * * Deskripsi:
+ * Menala ulang gain PID suhu / keruh dari respon plant sendiri, tanpa
+ * model. Berjalan di task kontrol: selama eksperimen, tick loop itu
+ * menulis output relay (% logika, lewat kurva aktuator), bukan output PID.
+ * - Relay berhisteresis di sekitar setpoint: error (arah kontrol) > +h ->
+ *   output tinggi, < -h -> output rendah. Plant berosilasi sendiri pada
+ *   frekuensi di mana fasa loop ~ -180 derajat.
+ * - Tiap siklus (naik ke naik): periode, fraksi waktu output tinggi, dan
+ *   amplitudo puncak-puncak pembacaan. Siklus awal dibuang (transien),
+ *   periode siklus ukur harus konsisten.
+ * - Ku = harmonik pertama output relay / amplitudo pembacaan. Relay tidak
+ *   simetris (heater hanya memanaskan, pompa hanya menjernihkan) sehingga
+ *   harmonik pertama = (tinggi - rendah) * 2/pi * sin(pi * fraksi tinggi),
+ *   bukan 4d/pi. Pu = periode rata-rata.
+ * - Aturan: Ziegler–Nichols (PID klasik), Tyreus–Luyben (PID konservatif),
+ *   SIMC (PI) dengan model integrator + waktu mati dari titik relay
+ *   (k' = 2*pi / (Pu*Ku), theta = Pu/4): kedua loop akuarium didominasi
+ *   integrator (tau termal ~14 jam, kekeruhan berjam-jam).
+ * - Histeresis heater diturunkan dari resolusi DS18B20 aktif (>= 2 langkah
+ *   kuantisasi): di bawah satu langkah relay berpindah karena kuantisasi,
+ *   bukan karena plant, dan Ku/Pu tidak bermakna.
+ * - Pengaman: pembacaan menyimpang > batasSimpang dari setpoint (termasuk
+ *   saat mulai), histeresis >= batasSimpang / 2 (resolusi terlalu kasar),
+ *   pembacaan tidak valid, atau tidak ada osilasi stabil dalam
+ *   durasiMaksMs -> GAGAL, aktuator 0, gain lama tetap.
+ * Gain hasil berlaku untuk Mode Smooth; Mode Turbo, feedforward & batas
+ * pompa (keruh) tidak diubah.
+ */
+
+#ifndef AQUARIUM_AUTOTUNE_RELAY_H
+#define AQUARIUM_AUTOTUNE_RELAY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Aktuator.h"
+#include "Kontrol.h"
+#include "Sensor.h"
+
+#ifndef AUTOTUNE_GAIN_MAKS
+#define AUTOTUNE_GAIN_MAKS 100000.0f // gain hasil > ini tidak dipasang (Kd suhu ~3e4 % s/C, di atas PERINTAH_GAIN_MAKS)
+#endif
+#ifndef AUTOTUNE_LANGKAH_HISTERESIS
+#define AUTOTUNE_LANGKAH_HISTERESIS 2  // histeresis heater = sekian langkah kuantisasi DS18B20 (min 2)
+#endif
+
+enum StatusAutotune : uint8_t {
+  AUTOTUNE_DIAM = 0,
+  AUTOTUNE_BERJALAN,
+  AUTOTUNE_SELESAI,
+  AUTOTUNE_GAGAL,
+};
+
+enum AturanAutotune : uint8_t {
+  AUTOTUNE_SIMC = 0,  // Skogestad: PI, tau_c = theta (atau tauC); bawaan
+  AUTOTUNE_ZN,        // Ziegler–Nichols: Kp 0.6 Ku, Ti Pu/2, Td Pu/8
+  AUTOTUNE_TL,        // Tyreus–Luyben: Kp Ku/2.2, Ti 2.2 Pu, Td Pu/6.3
+};
+
+struct PengaturanAutotune {
+  float outRendah, outTinggi;   // output relay (% logika)
+  float histeresis;             // satuan sensor (C / %)
+  float arah;                   // +1 aktuator menaikkan pembacaan, -1 menurunkan
+  float batasSimpang;           // |pembacaan - setpoint| maksimum
+  uint8_t siklusBuang;          // siklus transien awal
+  uint8_t siklusUkur;
+  uint32_t durasiMaksMs;
+  float tauC;                   // SIMC: konstanta waktu loop tertutup (s), 0 = theta
+};
+
+// Bawaan per aktuator: heater 0/100% +/- AUTOTUNE_LANGKAH_HISTERESIS langkah DS18B20 pada
+// resolusiSuhu (0.125 C di 12 bit), simpang maks 1 C, <= 6 jam; pompa 0/60% +/- 0.5 %,
+// simpang maks 5 %, <= 4 jam
+PengaturanAutotune pengaturanAutotune(KanalPwm kanal, uint8_t resolusiSuhu = SUHU_RESOLUSI);
+
+class AutotuneRelay {
+public:
+  void mulai(KanalPwm k, float setpoint, AturanAutotune a, bool terapkanHasil, const PengaturanAutotune &p,
+             unsigned long now);
+  void batal();
+  bool aktif(KanalPwm k) const { return status == AUTOTUNE_BERJALAN && kanal == k; }
+
+  // Satu tick loop ini: nilai = pembacaan terfilter (C / %).
+  // Return output relay (% logika 0-100); 0 setelah selesai / gagal.
+  float langkah(float nilai, unsigned long now);
+
+  StatusAutotune status = AUTOTUNE_DIAM;
+  KanalPwm kanal = KANAL_HEATER;
+  AturanAutotune aturan = AUTOTUNE_SIMC;
+  bool terapkan = false;        // hasil langsung dipasang ke konfigurasi aktif
+  bool terpasang = false;       // SELESAI & gain benar-benar dipasang (diisi pemanggil terapkanAutotune)
+  const char *alasan = "";      // GAGAL
+  float setpoint = 0.0f;
+  // Hasil identifikasi (SELESAI)
+  uint8_t siklus = 0;           // siklus terukur
+  float ku = 0.0f;              // % output per satuan sensor
+  float pu = 0.0f;              // detik
+  float amplitudo = 0.0f;       // setengah puncak-puncak (satuan sensor)
+  float fraksiTinggi = 0.0f;
+  float kp = 0.0f, ki = 0.0f, kd = 0.0f;
+
+private:
+  PengaturanAutotune p = {};
+  unsigned long awal = 0, awalSiklus = 0, awalRendah = 0;
+  bool tinggi = false;
+  bool pertama = false;         // langkah pertama: cek jarak dari setpoint
+  bool adaSiklus = false;       // sudah melewati naik pertama
+  uint8_t siklusSelesai = 0;    // termasuk yang dibuang
+  float yMaks = 0.0f, yMin = 0.0f;
+  double jumlahPeriode = 0, jumlahFraksi = 0, jumlahAmplitudo = 0;
+  float periodeMin = 0.0f, periodeMaks = 0.0f;
+
+  void gagal(const char *kenapa);
+  void mulaiSiklus(float nilai, unsigned long now);
+  void hitungGain();
+};
+
+// Pasang gain hasil ke loop yang dituning. false (p tidak diubah) jika belum
+// SELESAI atau ada gain di luar [0, gainMaks] (AUTOTUNE_GAIN_MAKS di firmware)
+bool terapkanAutotune(const AutotuneRelay &a, ParameterKontrol &p, float gainMaks);
+
+// {"loop":"suhu","status":"selesai","alasan":"","aturan":"tl","terapkan":true,"terpasang":true,
+//  "setpoint":..,"siklus":..,"ku":..,"pu_s":..,"amplitudo":..,"fraksi_tinggi":..,"kp":..,"ki":..,"kd":..}
+// Gain ditulis %.9g (float utuh): backend menyimpannya ke Control & menggemakannya kembali
+// Return panjang, 0 jika buf kurang
+size_t serializeAutotune(const AutotuneRelay &a, char *buf, size_t len);
+
+#endif
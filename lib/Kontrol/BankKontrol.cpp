@@ -0,0 +1,23 @@
+#include "BankKontrol.h"
+#include <stdio.h>
+#include <string.h>
+
+size_t topikKanal(char *buf, size_t len, const char *dasar, int kanal, const char *sub) {
+  int n = (kanal == 0) ? snprintf(buf, len, "%s/%s", dasar, sub) : snprintf(buf, len, "%s/%d/%s", dasar, kanal, sub);
+  if (n < 0 || (size_t)n >= len) return 0;
+  return (size_t)n;
+}
+
+int kanalDariTopik(const char *topik, const char *dasar, const char *sub) {
+  size_t nDasar = strlen(dasar);
+  if (strncmp(topik, dasar, nDasar) != 0 || topik[nDasar] != '/') return -1;
+  const char *p = topik + nDasar + 1;
+
+  int kanal = 0;
+  if (*p >= '0' && *p <= '9') {
+    kanal = 0;
+    while (*p >= '0' && *p <= '9') kanal = kanal * 10 + (*p++ - '0');
+    if (*p++ != '/' || kanal == 0) return -1;   // kanal 0 hanya lewat topik lama
+  }
+  return (strcmp(p, sub) == 0) ? kanal : -1;
+}
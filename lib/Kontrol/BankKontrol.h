@@ -0,0 +1,254 @@
+/**
+ * BANK KONTROLER MULTI-TANGKI (STRUCT-OF-ARRAYS)
+ * * Deskripsi:
+ * Satu board mengendalikan N tangki (pasangan heater/pompa). Setiap kanal
+ * punya mode (Fuzzy/PID/MPC), mesin fuzzy, setpoint, gain, batas pompa,
+ * kalibrasi ADC dan memori kontroler sendiri.
+ * - Layout struct-of-arrays: field yang sama dari semua kanal berdampingan
+ *   di memori (termasuk kurva aktuator [titik][kanal] & observer MPC).
+ * - hitungSuhu()/hitungKeruh() tidak memilih mode per kanal: daftar kanal per
+ *   mode disusun sekali di setParameter(), tiap kernel berjalan atas daftarnya.
+ *   Prolog (filter/konversi/error) & epilog (duty) berjalan atas semua kanal.
+ * - Kurva linearisasi aktuator (+ dither heater) per kanal; duty sudah
+ *   dihitung di hitung*(), tulisAktuator() hanya menulis.
+ * - Keuntungan atas N x jalur satu tangki kecil (~5-15% ns/kanal di host,
+ *   lihat tools/bench): ESP32 tidak punya SIMD float dan kernel PID/fuzzy
+ *   bercabang, jadi tidak ada divektorisasi. Firmware masih satu tangki.
+ * - Kernel sama dengan jalur satu tangki (pidSuhu/pidKeruh lewat
+ *   RefStatePid, hitungFuzzySuhuMesin, hitungFuzzyKeruhTerfilter, filterSuhu),
+ *   jadi kanal k dengan input sama memberi output identik dengan
+ *   tickSuhu/tickKeruh + ParameterKontrol/StateKontrol (dicek di tools/bench).
+ * - Rule base fuzzy dipakai bersama semua kanal (hanya dibaca).
+ * - I/O: isi suhu[] (probe mentah) & turbidityAdc[] (median), panggil
+ *   hitung*(), lalu tulisAktuator() ke HalPwm tiap kanal.
+ * Topik MQTT per kanal di bawah cabang perangkat (TopikPerangkat::dasar):
+ * kanal 0 = <prefix>/<id>/<nama> (sama dengan perangkat satu tangki),
+ * kanal k = <prefix>/<id>/<k>/<nama>; backend membedakan dari kedalaman topik.
+ */
+
+#ifndef AQUARIUM_BANK_KONTROL_H
+#define AQUARIUM_BANK_KONTROL_H
+
+#include <stddef.h>
+#include "Aktuator.h"
+#include "Hal.h"
+#include "Kontrol.h"
+#include "Sensor.h"
+
+enum LoopKontrol : uint8_t { LOOP_SUHU = 0, LOOP_KERUH = 1 };
+
+template <int N>
+struct BankKontrol {
+  static_assert(N >= 1, "bank kosong");
+  static constexpr int JUMLAH_KANAL = N;
+
+  // --- Parameter per kanal ---
+  ControlMode mode[N];
+  MesinFuzzy mesinSuhu[N], mesinKeruh[N];
+  float suhuSetpoint[N], turbiditySetpoint[N];
+  float kpSuhu[N], kiSuhu[N], kdSuhu[N];
+  float kpKeruh[N], kiKeruh[N], kdKeruh[N];
+  float kpTurbo[N], ambangTurbo[N];
+  float keruhTahan[N], keruhMati[N];
+  int adcJernih[N], adcKeruh[N];
+  float dutyHeater[KURVA_AKTUATOR_TITIK][N], dutyPompa[KURVA_AKTUATOR_TITIK][N];   // [titik][kanal]
+  float ambangHeater[N], ambangPompa[N];
+  bool ditherHeater[N];
+
+  // --- Input tiap tick ---
+  float suhu[N];              // probe mentah (-127 = gagal baca)
+  int turbidityAdc[N];        // median ADC
+
+  // --- Output tiap tick ---
+  float suhuTerfilter[N];
+  float turbidityPersen[N];
+  double outSuhu[N], outKeruh[N];   // 0-100%
+  int pwmSuhu[N], pwmKeruh[N];      // duty LEDC 0-PWM_DUTY_MAKS (setelah linearisasi)
+
+  // --- Memori kontroler, index [loop][kanal] ---
+  AngkaPid integral[2][N], lastError[2][N], lastDeriv[2][N], pidTerfilter[2][N];
+  unsigned long lastTime[2][N];
+  float lastErrorFuzzySuhu[N];
+  unsigned long lastTimeFuzzySuhu[N];
+  double outputKeruhTerfilter[N];
+  // Observer MPC per tangki (tabel TABEL_MPC dipakai bersama)
+  float mpcAir[N], mpcUkur[N], mpcRuang[N], mpcOut[N];
+  unsigned long mpcLastTime[N];
+  bool mpcSiap[N];
+  float sisaDither[N];   // sigma-delta heater
+
+  // --- Kanal per mode (disusun ulang di setParameter); keruh: selain PID = Fuzzy ---
+  int kanalPid[N], kanalFuzzySuhu[N], kanalMpc[N], kanalFuzzyKeruh[N];
+  int jumlahPid = 0, jumlahFuzzySuhu = 0, jumlahMpc = 0, jumlahFuzzyKeruh = 0;
+
+  // Semua kanal = ParameterKontrol default, state kosong
+  void mulai(unsigned long now) {
+    const ParameterKontrol p;
+    for (int k = 0; k < N; k++) {
+      setParameter(k, p);
+      suhu[k] = -127.0f;
+      turbidityAdc[k] = 0;
+      suhuTerfilter[k] = 0.0f;
+      turbidityPersen[k] = 0.0f;
+      outSuhu[k] = outKeruh[k] = 0.0;
+      pwmSuhu[k] = pwmKeruh[k] = 0;
+      sisaDither[k] = 0.0f;
+      reset(k, now);
+    }
+  }
+
+  void setParameter(int k, const ParameterKontrol &p) {
+    mode[k] = p.kontrolAktif;
+    mesinSuhu[k] = p.mesinFuzzySuhu;
+    mesinKeruh[k] = p.mesinFuzzyKeruh;
+    suhuSetpoint[k] = p.suhuSetpoint;
+    turbiditySetpoint[k] = p.turbiditySetpoint;
+    kpSuhu[k] = p.Kp_suhu; kiSuhu[k] = p.Ki_suhu; kdSuhu[k] = p.Kd_suhu;
+    kpKeruh[k] = p.Kp_keruh; kiKeruh[k] = p.Ki_keruh; kdKeruh[k] = p.Kd_keruh;
+    kpTurbo[k] = p.Kp_keruh_turbo;
+    ambangTurbo[k] = p.ambangTurboKeruh;
+    keruhTahan[k] = p.keruhTahan;
+    keruhMati[k] = p.keruhMati;
+    adcJernih[k] = p.NILAI_ADC_JERNIH;
+    adcKeruh[k] = p.NILAI_ADC_KERUH;
+    for (int i = 0; i < KURVA_AKTUATOR_TITIK; i++) {
+      dutyHeater[i][k] = p.kurvaHeater.duty[i];
+      dutyPompa[i][k] = p.kurvaPompa.duty[i];
+    }
+    ambangHeater[k] = p.kurvaHeater.ambangMati;
+    ambangPompa[k] = p.kurvaPompa.ambangMati;
+    ditherHeater[k] = p.ditherHeater;
+    susunKanalMode();
+  }
+
+  ParameterKontrol parameter(int k) const {
+    ParameterKontrol p;
+    p.kontrolAktif = mode[k];
+    p.mesinFuzzySuhu = mesinSuhu[k];
+    p.mesinFuzzyKeruh = mesinKeruh[k];
+    p.suhuSetpoint = suhuSetpoint[k];
+    p.turbiditySetpoint = turbiditySetpoint[k];
+    p.Kp_suhu = kpSuhu[k]; p.Ki_suhu = kiSuhu[k]; p.Kd_suhu = kdSuhu[k];
+    p.Kp_keruh = kpKeruh[k]; p.Ki_keruh = kiKeruh[k]; p.Kd_keruh = kdKeruh[k];
+    p.Kp_keruh_turbo = kpTurbo[k];
+    p.ambangTurboKeruh = ambangTurbo[k];
+    p.keruhTahan = keruhTahan[k];
+    p.keruhMati = keruhMati[k];
+    p.NILAI_ADC_JERNIH = adcJernih[k];
+    p.NILAI_ADC_KERUH = adcKeruh[k];
+    for (int i = 0; i < KURVA_AKTUATOR_TITIK; i++) {
+      p.kurvaHeater.duty[i] = dutyHeater[i][k];
+      p.kurvaPompa.duty[i] = dutyPompa[i][k];
+    }
+    p.kurvaHeater.ambangMati = ambangHeater[k];
+    p.kurvaPompa.ambangMati = ambangPompa[k];
+    p.ditherHeater = ditherHeater[k];
+    return p;
+  }
+
+  // Sama dengan resetPID() untuk satu kanal (mis. setelah ganti mode)
+  void reset(int k, unsigned long now) {
+    for (int l = 0; l < 2; l++) refPid((LoopKontrol)l, k).reset(now);
+    outputKeruhTerfilter[k] = 0.0;
+    suhuTerfilter[k] = 0.0f;
+    lastErrorFuzzySuhu[k] = 0.0f;
+    lastTimeFuzzySuhu[k] = now;
+    mpcSiap[k] = false;
+  }
+
+  RefStatePid<AngkaPid> refPid(LoopKontrol l, int k) {
+    return {integral[l][k], lastError[l][k], lastDeriv[l][k], pidTerfilter[l][k], lastTime[l][k]};
+  }
+
+  // Satu lintasan loop suhu semua kanal (periode PERIODE_SUHU_MS):
+  // filter & error atas semua kanal, lalu tiap kernel hanya atas daftar kanal
+  // modenya (tanpa switch per kanal), lalu linearisasi aktuator semua kanal.
+  void hitungSuhu(unsigned long now, const AturanFuzzy &af = aturanFuzzy) {
+    float error[N];
+    for (int k = 0; k < N; k++) error[k] = suhuSetpoint[k] - filterSuhu(suhuTerfilter[k], suhu[k]);
+    for (int j = 0; j < jumlahPid; j++) {
+      const int k = kanalPid[j];
+      const GainPid<AngkaPid> g = {AngkaPid(kpSuhu[k]), AngkaPid(kiSuhu[k]), AngkaPid(kdSuhu[k])};
+      outSuhu[k] = (double)pidSuhu(refPid(LOOP_SUHU, k), g, error[k], now);
+    }
+    for (int j = 0; j < jumlahFuzzySuhu; j++) {
+      const int k = kanalFuzzySuhu[j];
+      outSuhu[k] = hitungFuzzySuhuMesin(lastErrorFuzzySuhu[k], lastTimeFuzzySuhu[k], af, mesinSuhu[k], error[k], now);
+    }
+    for (int j = 0; j < jumlahMpc; j++) {
+      const int k = kanalMpc[j];
+      StateMpc m = {mpcAir[k], mpcUkur[k], mpcRuang[k], mpcOut[k], mpcLastTime[k], mpcSiap[k]};
+      outSuhu[k] = hitungMpcSuhu(m, TABEL_MPC, suhuSetpoint[k] - error[k], suhuSetpoint[k], now);
+      mpcAir[k] = m.suhuAir; mpcUkur[k] = m.suhuUkur; mpcRuang[k] = m.suhuRuang;
+      mpcOut[k] = m.outTerakhir; mpcLastTime[k] = m.lastTime; mpcSiap[k] = m.siap;
+    }
+    for (int k = 0; k < N; k++)
+      pwmSuhu[k] = kuantisasiDuty(dutyKanal(dutyHeater, ambangHeater, k, (float)outSuhu[k]),
+                                  ditherHeater[k] ? &sisaDither[k] : nullptr);
+  }
+
+  // Satu lintasan loop keruh semua kanal (periode PERIODE_KERUH_MS), pola sama
+  void hitungKeruh(unsigned long now, const AturanFuzzy &af = aturanFuzzy) {
+    float error[N];
+    for (int k = 0; k < N; k++) {
+      turbidityPersen[k] = konversiTurbidityKePersen(turbidityAdc[k], adcKeruh[k], adcJernih[k]);
+      error[k] = turbidityPersen[k] - turbiditySetpoint[k];
+    }
+    for (int j = 0; j < jumlahPid; j++) {
+      const int k = kanalPid[j];
+      const GainPidKeruh<AngkaPid> g = {AngkaPid(kpKeruh[k]), AngkaPid(kiKeruh[k]), AngkaPid(kdKeruh[k]),
+                                        AngkaPid(kpTurbo[k]), ambangTurbo[k], keruhTahan[k], keruhMati[k],
+                                        turbiditySetpoint[k]};
+      outKeruh[k] = (double)pidKeruh(refPid(LOOP_KERUH, k), g, error[k], now);
+    }
+    for (int j = 0; j < jumlahFuzzyKeruh; j++) {
+      const int k = kanalFuzzyKeruh[j];
+      outKeruh[k] = hitungFuzzyKeruhTerfilter(outputKeruhTerfilter[k], af, mesinKeruh[k], error[k],
+                                              turbidityPersen[k], keruhTahan[k], keruhMati[k]);
+    }
+    for (int k = 0; k < N; k++)
+      pwmKeruh[k] = kuantisasiDuty(dutyKanal(dutyPompa, ambangPompa, k, (float)outKeruh[k]), nullptr);
+  }
+
+  void hitung(unsigned long now, const AturanFuzzy &af = aturanFuzzy) {
+    hitungSuhu(now, af);
+    hitungKeruh(now, af);
+  }
+
+  // pwm[k] = driver L298N tangki k
+  void tulisAktuator(HalPwm *const (&pwm)[N]) const {
+    for (int k = 0; k < N; k++) {
+      pwm[k]->tulis(KANAL_HEATER, pwmSuhu[k]);
+      pwm[k]->tulis(KANAL_POMPA, pwmKeruh[k]);
+    }
+  }
+
+private:
+  // = dutyLinear() atas kolom kurva kanal k
+  static float dutyKanal(const float (&duty)[KURVA_AKTUATOR_TITIK][N], const float (&ambang)[N], int k, float persen) {
+    if (!(persen > ambang[k])) return 0.0f;
+    if (persen >= 100.0f) return duty[KURVA_AKTUATOR_TITIK - 1][k] * PWM_DUTY_MAKS;
+    const float x = persen * ((KURVA_AKTUATOR_TITIK - 1) / 100.0f);
+    const int i = (int)x;
+    const float f = duty[i][k] + (duty[i + 1][k] - duty[i][k]) * (x - i);
+    return f * PWM_DUTY_MAKS;
+  }
+
+  void susunKanalMode() {
+    jumlahPid = jumlahFuzzySuhu = jumlahMpc = jumlahFuzzyKeruh = 0;
+    for (int k = 0; k < N; k++) {
+      if (mode[k] == PID) kanalPid[jumlahPid++] = k;
+      if (mode[k] == FUZZY) kanalFuzzySuhu[jumlahFuzzySuhu++] = k;
+      if (mode[k] == MPC) kanalMpc[jumlahMpc++] = k;
+      if (mode[k] != PID) kanalFuzzyKeruh[jumlahFuzzyKeruh++] = k;
+    }
+  }
+};
+
+// Topik per kanal, dasar = "<prefix>/<id>" (TopikPerangkat::dasar): kanal 0 = "<dasar>/<sub>",
+// kanal k = "<dasar>/<k>/<sub>". Return panjang, 0 jika buf kurang.
+size_t topikKanal(char *buf, size_t len, const char *dasar, int kanal, const char *sub);
+// Kebalikan topikKanal(); -1 jika topik bukan milik <dasar>/.../<sub>
+int kanalDariTopik(const char *topik, const char *dasar, const char *sub);
+
+#endif
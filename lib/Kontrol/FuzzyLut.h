@@ -0,0 +1,94 @@
+/**
+ * LOOKUP TABLE FUZZY (mode LUT)
+ * * Deskripsi:
+ * Kurva input -> output kontroler Sugeno satu input dipanggang ke tabel
+ * N titik, lalu saat runtime cukup 1 lookup + interpolasi linear.
+ * - Di luar [xMin, xMax] input di-clamp (output fuzzy di sana sudah konstan);
+ *   NaN diperlakukan sebagai xMin.
+ * - Kurva hanya patah di breakpoint himpunan; di antaranya mulus. Breakpoint
+ *   yang jatuh di dalam sel jadi node tambahan (satu per sel), jadi error
+ *   interpolasi O(h^2) dan turun terus saat N naik, tidak bergantung letak
+ *   breakpoint terhadap grid.
+ * - errorMaks = selisih terbesar vs jalur eksak, diukur saat bangun()
+ *   dengan OVERSAMPLE titik uji di antara setiap pasangan node.
+ * - bangun() constexpr: bisa dipanggang saat kompilasi jika fungsi fuzzy-nya
+ *   constexpr, atau saat boot / saat rule base berubah.
+ */
+
+#ifndef AQUARIUM_FUZZY_LUT_H
+#define AQUARIUM_FUZZY_LUT_H
+
+// Jumlah titik tabel (bisa di-override lewat build_flags)
+#ifndef FUZZY_LUT_RESOLUSI
+#define FUZZY_LUT_RESOLUSI 256
+#endif
+
+#include <stdint.h>
+
+template <int N>
+struct FuzzyLut {
+  static_assert(N >= 2, "LUT minimal 2 titik");
+  static constexpr int OVERSAMPLE = 16;
+  static constexpr int PATAH_MAKS = 24;   // node tambahan (4 breakpoint x 5 himpunan + cadangan)
+
+  float xMin = 0.0f, xMax = 0.0f;
+  float skala = 0.0f;    // (N - 1) / (xMax - xMin)
+  float errorMaks = 0.0f;
+  float y[N + 1] = {};   // y[N] = y[N-1] supaya index+1 tidak perlu dicek
+
+  // Sel berisi breakpoint: node tambahan di pecahan fPatah dari awal sel,
+  // kemiringan (per sel) di kiri & kanannya. indeksPatah -1 = sel biasa.
+  int8_t indeksPatah[N] = {};
+  float fPatah[PATAH_MAKS] = {};
+  float miringKiri[PATAH_MAKS] = {};
+  float miringKanan[PATAH_MAKS] = {};
+
+  // patah = breakpoint input (urutan bebas, duplikat boleh). Breakpoint kedua
+  // dalam sel yang sama diabaikan (sel itu kembali interpolasi biasa di sisinya).
+  template <typename Fn>
+  constexpr void bangun(Fn fn, float lo, float hi, const float *patah = nullptr, int nPatah = 0) {
+    xMin = lo; xMax = hi;
+    skala = (float)(N - 1) / (hi - lo);
+    float langkah = (hi - lo) / (float)(N - 1);
+    for (int i = 0; i < N; i++) y[i] = fn(lo + langkah * (float)i);
+    y[N] = y[N - 1];
+
+    for (int i = 0; i < N; i++) indeksPatah[i] = -1;
+    int jumlahPatah = 0;
+    for (int j = 0; j < nPatah && jumlahPatah < PATAH_MAKS; j++) {
+      float t = (patah[j] - lo) * skala;
+      if (!(t > 0.0f && t < (float)(N - 1))) continue;
+      int i = (int)t;
+      float f = t - (float)i;
+      if (f < 1e-4f || f > 1.0f - 1e-4f || indeksPatah[i] >= 0) continue;   // sudah di node / sel terisi
+      float yp = fn(patah[j]);
+      fPatah[jumlahPatah] = f;
+      miringKiri[jumlahPatah] = (yp - y[i]) / f;
+      miringKanan[jumlahPatah] = (y[i + 1] - yp) / (1.0f - f);
+      indeksPatah[i] = (int8_t)jumlahPatah++;
+    }
+
+    errorMaks = 0.0f;
+    for (int i = 0; i < N - 1; i++) {
+      for (int k = 1; k < OVERSAMPLE; k++) {
+        float x = lo + langkah * ((float)i + (float)k / OVERSAMPLE);
+        float d = hitung(x) - fn(x);
+        if (d < 0) d = -d;
+        if (d > errorMaks) errorMaks = d;
+      }
+    }
+  }
+
+  constexpr float hitung(float x) const {
+    float t = (x - xMin) * skala;
+    t = !(t >= 0.0f) ? 0.0f : t;   // NaN ikut ke 0: (int)NaN tidak terdefinisi
+    t = (t > (float)(N - 1)) ? (float)(N - 1) : t;
+    int i = (int)t;
+    float f = t - (float)i;
+    int k = indeksPatah[i];
+    if (k >= 0) return (f < fPatah[k]) ? y[i] + f * miringKiri[k] : y[i + 1] - (1.0f - f) * miringKanan[k];
+    return y[i] + f * (y[i + 1] - y[i]);
+  }
+};
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * MESIN INFERENSI FUZZY SUGENO (GENERIK)
+ * * Deskripsi:
+ * FuzzySugeno<NSets, NInputs>: NSets himpunan trapesium per input,
+ * NSets^NInputs aturan, konsekuen orde-nol (konstanta), defuzzifikasi
+ * weighted average. Firing strength aturan multi-input = min (AND).
+ * - Breakpoint disimpan sebagai array datar (puncak & kemiringan per sisi),
+ *   jadi derajat keanggotaan dihitung tanpa percabangan:
+ *     mu = clamp(min(1 + (x - b) * kiri, 1 + (c - x) * kanan), 0, 1)
+ *   kemiringan 0 berarti bahu (mu tetap 1 ke arah tak hingga).
+ * - Semua method constexpr: rule base default bisa jadi konstanta flash
+ *   dan dipanggang ke LUT saat kompilasi. Tidak ada alokasi heap.
+ */
+
+#ifndef AQUARIUM_FUZZY_SUGENO_H
+#define AQUARIUM_FUZZY_SUGENO_H
+
+// Satu himpunan: naik a->b, bernilai 1 di [b, c], turun c->d
+struct Trapesium {
+  float a, b, c, d;
+};
+
+constexpr Trapesium trapesium(float a, float b, float c, float d) { return {a, b, c, d}; }
+// mu = 1 untuk x <= c, turun ke 0 di d
+constexpr Trapesium bahuKiri(float c, float d) { return {c, c, c, d}; }
+// mu = 0 untuk x <= a, naik ke 1 di b dan tetap 1 sesudahnya
+constexpr Trapesium bahuKanan(float a, float b) { return {a, b, b, b}; }
+
+constexpr int pangkatInt(int basis, int n) { return (n == 0) ? 1 : basis * pangkatInt(basis, n - 1); }
+
+template <int NSets, int NInputs = 1>
+struct FuzzySugeno {
+  static_assert(NSets >= 1 && NInputs >= 1, "rule base kosong");
+  static constexpr int N_HIMPUNAN = NSets * NInputs;
+  static constexpr int N_ATURAN = pangkatInt(NSets, NInputs);
+
+  // Breakpoint, index [input * NSets + himpunan]
+  float puncakKiri[N_HIMPUNAN] = {};
+  float puncakKanan[N_HIMPUNAN] = {};
+  float miringKiri[N_HIMPUNAN] = {};
+  float miringKanan[N_HIMPUNAN] = {};
+
+  // Konsekuen, index aturan = sum(himpunan_k * NSets^k), input 0 paling cepat berubah
+  float konsekuen[N_ATURAN] = {};
+
+  // Output jika total firing strength < 0.01 (tidak ada aturan yang aktif)
+  float keluaranDefault = 0.0f;
+
+  // false jika breakpoint tidak urut (a <= b <= c <= d)
+  constexpr bool setHimpunan(int input, int himpunan, const Trapesium &t) {
+    if (!(t.a <= t.b && t.b <= t.c && t.c <= t.d)) return false;
+    int k = input * NSets + himpunan;
+    puncakKiri[k] = t.b;
+    puncakKanan[k] = t.c;
+    miringKiri[k] = (t.b > t.a) ? 1.0f / (t.b - t.a) : 0.0f;
+    miringKanan[k] = (t.d > t.c) ? 1.0f / (t.d - t.c) : 0.0f;
+    return true;
+  }
+
+  // Ganti seluruh rule base sekaligus (mis. dari MQTT). Jika ada breakpoint
+  // tidak urut / konsekuen NaN, rule base lama dibiarkan dan return false.
+  constexpr bool muat(const Trapesium (&himpunan)[N_HIMPUNAN], const float (&kons)[N_ATURAN],
+                      float keluaranDefaultBaru) {
+    FuzzySugeno baru;
+    for (int k = 0; k < N_HIMPUNAN; k++) {
+      if (!baru.setHimpunan(k / NSets, k % NSets, himpunan[k])) return false;
+    }
+    for (int r = 0; r < N_ATURAN; r++) {
+      if (!(kons[r] == kons[r])) return false;
+      baru.konsekuen[r] = kons[r];
+    }
+    if (!(keluaranDefaultBaru == keluaranDefaultBaru)) return false;
+    baru.keluaranDefault = keluaranDefaultBaru;
+    *this = baru;
+    return true;
+  }
+
+  // Breakpoint input ke-input yang benar-benar patah (sisi datar bahu
+  // dilewati). Output Sugeno hanya patah di titik-titik ini.
+  constexpr int titikPatah(int input, float (&out)[4 * NSets]) const {
+    int n = 0;
+    for (int s = 0; s < NSets; s++) {
+      int k = input * NSets + s;
+      if (miringKiri[k] > 0.0f) {
+        out[n++] = puncakKiri[k] - 1.0f / miringKiri[k];
+        out[n++] = puncakKiri[k];
+      }
+      if (miringKanan[k] > 0.0f) {
+        out[n++] = puncakKanan[k];
+        out[n++] = puncakKanan[k] + 1.0f / miringKanan[k];
+      }
+    }
+    return n;
+  }
+
+  constexpr float keanggotaan(int input, int himpunan, float x) const {
+    int k = input * NSets + himpunan;
+    float kiri = 1.0f + (x - puncakKiri[k]) * miringKiri[k];
+    float kanan = 1.0f + (puncakKanan[k] - x) * miringKanan[k];
+    // min/max lewat nilai mutlak supaya tidak diubah compiler jadi cabang
+    float mu = 0.5f * (kiri + kanan - __builtin_fabsf(kiri - kanan));
+    mu = 0.5f * (mu + 1.0f - __builtin_fabsf(mu - 1.0f));
+    return 0.5f * (mu + __builtin_fabsf(mu));
+  }
+
+  constexpr float hitung(const float (&x)[NInputs]) const {
+    if constexpr (NInputs == 1) {
+      // Satu input: firing strength = derajat keanggotaan
+      float numerator = 0.0f, denominator = 0.0f;
+      for (int s = 0; s < NSets; s++) {
+        float w = keanggotaan(0, s, x[0]);
+        numerator += w * konsekuen[s];
+        denominator += w;
+      }
+      if (denominator < 0.01f) return keluaranDefault;
+      return numerator / denominator;
+    }
+
+    float mu[N_HIMPUNAN] = {};
+    for (int i = 0; i < NInputs; i++)
+      for (int s = 0; s < NSets; s++) mu[i * NSets + s] = keanggotaan(i, s, x[i]);
+
+    float numerator = 0.0f, denominator = 0.0f;
+    if constexpr (NInputs == 2) {
+      // Dua input (PD-fuzzy): loop bersarang, tanpa pembagian index
+      for (int j = 0; j < NSets; j++) {
+        float muJ = mu[NSets + j];
+        for (int i = 0; i < NSets; i++) {
+          float w = 0.5f * (mu[i] + muJ - __builtin_fabsf(mu[i] - muJ));
+          numerator += w * konsekuen[i + NSets * j];
+          denominator += w;
+        }
+      }
+      if (denominator < 0.01f) return keluaranDefault;
+      return numerator / denominator;
+    }
+
+    for (int r = 0; r < N_ATURAN; r++) {
+      float w = 1.0f;
+      int sisa = r;
+      for (int i = 0; i < NInputs; i++) {
+        float m = mu[i * NSets + sisa % NSets];
+        w = (m < w) ? m : w;
+        sisa /= NSets;
+      }
+      numerator += w * konsekuen[r];
+      denominator += w;
+    }
+
+    if (denominator < 0.01f) return keluaranDefault;
+    return numerator / denominator;
+  }
+
+  constexpr float hitung(float x) const {
+    static_assert(NInputs == 1, "pakai hitung(float[NInputs])");
+    const float in[1] = {x};
+    return hitung(in);
+  }
+};
+
+// Bangun rule base satu input dari daftar himpunan & konsekuen (urutan sama)
+template <int NSets>
+constexpr FuzzySugeno<NSets, 1> buatFuzzy1(const Trapesium (&himpunan)[NSets],
+                                          const float (&konsekuen)[NSets], float keluaranDefault) {
+  FuzzySugeno<NSets, 1> f;
+  for (int s = 0; s < NSets; s++) {
+    f.setHimpunan(0, s, himpunan[s]);
+    f.konsekuen[s] = konsekuen[s];
+  }
+  f.keluaranDefault = keluaranDefault;
+  return f;
+}
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * JAM DINDING UNTUK STEMPEL LATENSI LINTAS PERANGKAT
+ * * Deskripsi:
+ * Stempel tahap di perangkat memakai micros() (murah, monoton, dipakai
+ * bersama core 0 & 1); baru saat dikirim diubah ke waktu dinding UTC
+ * lewat satu pasangan (micros, epoch) yang dibaca bersamaan. Host lalu
+ * cukup mengurangkan jam dinding-nya sendiri (broker / server / DB).
+ * - ESP32: epoch dari SNTP (Esp32Clock::mulaiSntp); uji offline: SimClock
+ *   dengan epochAwalUs sebagai pengganti.
+ * - Selisih micros 32 bit: benar s.d. ~71 menit (cukup untuk satu
+ *   perjalanan sampel; data simpan-terus lebih tua -> umur tidak berarti).
+ */
+
+#ifndef AQUARIUM_JAM_DINDING_H
+#define AQUARIUM_JAM_DINDING_H
+
+#include <stdint.h>
+#include "Hal.h"
+
+struct TitikWaktu {
+  uint32_t us;        // micros() saat dibaca
+  uint64_t epochUs;   // UTC (us sejak 1970), 0 = jam belum tersinkron
+
+  static TitikWaktu sekarang(HalClock &clock) {
+    TitikWaktu w;
+    w.us = (uint32_t)clock.micros();
+    if (!clock.epochUs(w.epochUs)) w.epochUs = 0;
+    return w;
+  }
+  bool sinkron() const { return epochUs != 0; }
+  // Umur stempel micros relatif titik ini (stempel 0 = belum ada)
+  uint32_t umurUs(uint32_t stempelUs) const { return us - stempelUs; }
+  // Stempel micros -> UTC (us); 0 jika belum sinkron
+  uint64_t epochDari(uint32_t stempelUs) const { return sinkron() ? epochUs - umurUs(stempelUs) : 0; }
+};
+
+// Stempel micros() tahap satu loop kontrol (0 = belum ada)
+struct StempelTahap {
+  uint32_t sampelUs;    // sampel sensor fisik terbaru yang dipakai
+  uint32_t hitungUs;    // output kontroler selesai
+  uint32_t aktuasiUs;   // duty tertulis ke driver
+};
+
+// a terjadi di / sesudah b (aman melewati putaran micros 32 bit)
+inline bool tidakSebelum(uint32_t a, uint32_t b) { return (int32_t)(a - b) >= 0; }
+
+#endif
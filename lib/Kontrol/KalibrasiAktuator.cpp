@@ -0,0 +1,205 @@
+#include "KalibrasiAktuator.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "Kontrol.h"
+
+// Efek ternormalisasi <= ini dianggap dead band (derau regresi)
+static const float FRAKSI_DEAD_BAND = 0.03f;
+
+static const char PATH_KURVA_AKTUATOR[] = "/aktuator.bin";
+static const uint8_t VERSI_KURVA_AKTUATOR = 1;
+
+struct BerkasKurva {
+  uint8_t versi;
+  KurvaAktuator heater, pompa;
+};
+
+PengaturanKalibrasi pengaturanKalibrasi(KanalPwm kanal) {
+  if (kanal == KANAL_HEATER) {
+    // 95 W / 30 L: penuh ~ 7.6e-4 C/s; level 1/6 ~ 7e-5 C/s vs derau regresi ~2e-5 C/s
+    return {6, 1.0f / 6.0f, 60000, 300000, false, 1.0f, 1e-4f, 0.0f, 1.5f, KURVA_HEATER_DEFAULT.ambangMati};
+  }
+  // Aliran penuh ~ 6/jam = 1.7e-3 /s; dead band motor di sekitar duty 0.85-0.92
+  return {7, 0.70f, 20000, 60000, true, -1.0f, 2e-4f, 2.0f, 100.0f, KURVA_POMPA_DEFAULT.ambangMati};
+}
+
+void KalibrasiAktuator::mulai(KanalPwm k, const PengaturanKalibrasi &pk, unsigned long now) {
+  kanal = k;
+  p = pk;
+  p.jumlahLevel = batasi(p.jumlahLevel, (uint8_t)2, (uint8_t)KALIBRASI_MAKS_LEVEL);
+  status = KALIBRASI_BERJALAN;
+  alasan = "";
+  jumlahTitik = 0;
+  level = 0;
+  awalLevel = now;
+  n = 0;
+  sx = sy = sxx = sxy = 0.0;
+  adaAwal = false;
+}
+
+void KalibrasiAktuator::batal() {
+  if (status == KALIBRASI_BERJALAN) gagal("dibatalkan");
+}
+
+void KalibrasiAktuator::gagal(const char *kenapa) {
+  status = KALIBRASI_GAGAL;
+  alasan = kenapa;
+}
+
+float KalibrasiAktuator::dutyUntuk(uint8_t lv) const {
+  if (lv == 0 || lv > p.jumlahLevel) return 0.0f;
+  return p.dutyMin + (1.0f - p.dutyMin) * (lv - 1) / (p.jumlahLevel - 1);
+}
+
+float KalibrasiAktuator::langkah(float nilai, unsigned long now) {
+  if (status != KALIBRASI_BERJALAN) return 0.0f;
+  if (!isfinite(nilai)) {
+    gagal("pembacaan tidak valid");
+    return 0.0f;
+  }
+  const unsigned long t = now - awalLevel;
+  // Acuan simpangan: sampel pertama jendela baseline (filter sensor sudah tenang)
+  if (!adaAwal && t >= p.tahanMs) {
+    nilaiAwal = nilai;
+    adaAwal = true;
+  }
+  if (adaAwal && fabsf(nilai - nilaiAwal) > p.batasSimpang) {
+    gagal("pembacaan menyimpang melewati batas");
+    return 0.0f;
+  }
+
+  if (t >= p.tahanMs) {
+    if (n == 0) yAwal = nilai;
+    const double x = (t - p.tahanMs) / 1000.0, y = nilai - yAwal;
+    n++;
+    sx += x; sy += y; sxx += x * x; sxy += x * y;
+  }
+  if (t < p.tahanMs + p.ukurMs) return dutyUntuk(level);
+
+  // Level selesai: kemiringan kuadrat terkecil
+  const double det = n * sxx - sx * sx;
+  if (n < 3 || det <= 0.0) {
+    gagal("sampel per level kurang");
+    return 0.0f;
+  }
+  double kemiringan = (n * sxy - sx * sy) / det;
+  if (p.relatif) {
+    const double rata = yAwal + sy / n;
+    if (rata < p.nilaiMin) {
+      gagal("pembacaan terlalu kecil untuk laju relatif");
+      return 0.0f;
+    }
+    kemiringan /= rata;
+  }
+  dutyLevel[level] = dutyUntuk(level);
+  respon[level] = (float)(p.arah * kemiringan);
+  jumlahTitik = ++level;
+  awalLevel = now;
+  n = 0;
+  sx = sy = sxx = sxy = 0.0;
+
+  if (level == p.jumlahLevel + 2) {
+    bangunKurva();
+    return 0.0f;
+  }
+  return dutyUntuk(level);
+}
+
+int KalibrasiAktuator::tulis(HalPwm &pwm, float nilai, unsigned long now) {
+  const int d = kuantisasiDuty(langkah(nilai, now) * PWM_DUTY_MAKS, nullptr);
+  pwm.tulis(kanal, d);
+  return d;
+}
+
+void KalibrasiAktuator::bangunKurva() {
+  const int m = p.jumlahLevel;
+  // Efek bersih: kurangi baseline (rugi ke ruang / pengendapan), interpolasi awal -> akhir
+  float d[KALIBRASI_MAKS_LEVEL + 1], f[KALIBRASI_MAKS_LEVEL + 1];
+  d[0] = f[0] = 0.0f;
+  float maks = 0.0f;
+  for (int i = 1; i <= m; i++) {
+    const float dasar = respon[0] + (respon[m + 1] - respon[0]) * i / (m + 1);
+    d[i] = dutyLevel[i];
+    f[i] = respon[i] - dasar;
+    if (f[i] < f[i - 1]) f[i] = f[i - 1];   // tidak turun
+    if (f[i] > maks) maks = f[i];
+  }
+  if (maks < p.responMin) {
+    gagal("tidak ada respon (aktuator / sensor terputus?)");
+    return;
+  }
+
+  int mati = 0;
+  for (int i = 1; i <= m; i++) {
+    f[i] /= maks;
+    if (f[i] <= FRAKSI_DEAD_BAND) mati = i;
+  }
+  // Tepi dead band: garis dua level responsif pertama memotong nol
+  float tepi = d[mati];
+  if (mati > 0 && mati + 2 <= m && f[mati + 2] > f[mati + 1]) {
+    const float gradien = (f[mati + 2] - f[mati + 1]) / (d[mati + 2] - d[mati + 1]);
+    tepi = batasi(d[mati + 1] - f[mati + 1] / gradien, d[mati], d[mati + 1]);
+  }
+  d[mati] = tepi;
+  f[mati] = 0.0f;
+
+  // Balik: logika x -> duty dengan efek x (interpolasi di segmen pertama yang mencapai x)
+  kurva.duty[0] = tepi;
+  for (int j = 1; j < KURVA_AKTUATOR_TITIK; j++) {
+    const float x = (float)j / (KURVA_AKTUATOR_TITIK - 1);
+    int i = mati + 1;
+    while (i < m && f[i] < x) i++;
+    float duty = d[i];
+    if (f[i] > f[i - 1] && x < f[i]) duty = d[i - 1] + (d[i] - d[i - 1]) * (x - f[i - 1]) / (f[i] - f[i - 1]);
+    kurva.duty[j] = batasi(duty, kurva.duty[j - 1], 1.0f);
+  }
+  kurva.ambangMati = p.ambangMati;
+  status = KALIBRASI_SELESAI;
+}
+
+bool simpanKurvaAktuator(HalBerkas &berkas, const KurvaAktuator &heater, const KurvaAktuator &pompa) {
+  BerkasKurva b;
+  memset(&b, 0, sizeof(b));
+  b.versi = VERSI_KURVA_AKTUATOR;
+  b.heater = heater;
+  b.pompa = pompa;
+  return berkas.tulis(PATH_KURVA_AKTUATOR, (const uint8_t *)&b, sizeof(b));
+}
+
+bool muatKurvaAktuator(HalBerkas &berkas, KurvaAktuator &heater, KurvaAktuator &pompa) {
+  BerkasKurva b;
+  if (berkas.baca(PATH_KURVA_AKTUATOR, 0, (uint8_t *)&b, sizeof(b)) != sizeof(b)) return false;
+  if (b.versi != VERSI_KURVA_AKTUATOR || !kurvaAktuatorValid(b.heater) || !kurvaAktuatorValid(b.pompa)) return false;
+  heater = b.heater;
+  pompa = b.pompa;
+  return true;
+}
+
+size_t serializeKalibrasi(const KalibrasiAktuator &k, char *buf, size_t len) {
+  static const char *const NAMA_STATUS[] = {"diam", "berjalan", "selesai", "gagal"};
+  int n = snprintf(buf, len, "{\"aktuator\":\"%s\",\"status\":\"%s\",\"alasan\":\"%s\",\"ambang\":%.2f,\"kurva\":[",
+                   k.kanal == KANAL_HEATER ? "heater" : "pompa", NAMA_STATUS[k.status], k.alasan, k.kurva.ambangMati);
+  if (n < 0 || (size_t)n >= len) return 0;
+  // Kurva dalam % duty (format sama dengan perintah kurva_heater / kurva_pompa)
+  const int jumlah = (k.status == KALIBRASI_SELESAI) ? KURVA_AKTUATOR_TITIK : 0;
+  for (int i = 0; i < jumlah; i++) {
+    int m = snprintf(buf + n, len - n, "%s%.2f", i ? "," : "", k.kurva.duty[i] * 100.0f);
+    if (m < 0 || (size_t)(n + m) >= len) return 0;
+    n += m;
+  }
+  for (int bagian = 0; bagian < 2; bagian++) {
+    int m = snprintf(buf + n, len - n, bagian == 0 ? "],\"duty\":[" : "],\"respon\":[");
+    if (m < 0 || (size_t)(n + m) >= len) return 0;
+    n += m;
+    for (int i = 0; i < k.jumlahTitik; i++) {
+      m = bagian == 0 ? snprintf(buf + n, len - n, "%s%.2f", i ? "," : "", k.dutyLevel[i] * 100.0f)
+                      : snprintf(buf + n, len - n, "%s%.4g", i ? "," : "", k.respon[i]);
+      if (m < 0 || (size_t)(n + m) >= len) return 0;
+      n += m;
+    }
+  }
+  int m = snprintf(buf + n, len - n, "]}");
+  if (m < 0 || (size_t)(n + m) >= len) return 0;
+  return (size_t)(n + m);
+}
@@ -0,0 +1,110 @@
+/**
+ * KALIBRASI OTOMATIS KURVA AKTUATOR (DI PERANGKAT)
+ * * Deskripsi:
+ * Mengukur kurva logika% -> duty (KurvaAktuator, Aktuator.h) dari respon
+ * plant sendiri, tanpa alat ukur tambahan. Berjalan di task kontrol: selama
+ * kalibrasi, tick loop aktuator itu menulis duty uji, bukan output kontroler.
+ * - Urutan level: 0 (baseline), dutyMin .. 1 naik rata, lalu 0 lagi.
+ *   Tiap level: tahanMs dibuang (lag probe / aliran), lalu kemiringan
+ *   pembacaan diregresi kuadrat terkecil selama ukurMs.
+ * - Heater: efek = kemiringan suhu (C/s) dikurangi baseline (rugi ke ruang,
+ *   diinterpolasi antara baseline awal & akhir) -> sebanding daya ke air.
+ * - Pompa: efek = laju peluruhan relatif kekeruhan -(dK/dt)/K dikurangi
+ *   baseline -> sebanding aliran filter, tidak tergantung level kekeruhan.
+ * - Efek dinormalkan ke level duty penuh, dibuat tidak turun, lalu dibalik:
+ *   logika x% -> duty yang memberi x% efek penuh. Dead band (efek ~ 0)
+ *   dipotong di perpotongan garis dua level responsif pertama dengan nol.
+ * - Pengaman: pembacaan menyimpang > batasSimpang dari awal, efek penuh <
+ *   responMin, atau kekeruhan terlalu rendah -> GAGAL, aktuator 0.
+ */
+
+#ifndef AQUARIUM_KALIBRASI_AKTUATOR_H
+#define AQUARIUM_KALIBRASI_AKTUATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Aktuator.h"
+#include "Hal.h"
+
+const int KALIBRASI_MAKS_LEVEL = 12;   // level duty > 0 (tanpa dua baseline)
+
+// 1 = kurva hasil kalibrasi langsung dipasang & disimpan ke flash. Bawaan 0:
+// hasil hanya dilaporkan, dipasang manual lewat kurva_heater / kurva_pompa.
+// Aturan Fuzzy keruh ditala dengan pemetaan lama; dengan kurva pompa
+// terkalibrasi energi pompa Fuzzy naik ~5x (tools/bench, step_suhu & lonjakan_keruh).
+#ifndef KALIBRASI_PASANG_OTOMATIS
+#define KALIBRASI_PASANG_OTOMATIS 0
+#endif
+
+enum StatusKalibrasi : uint8_t {
+  KALIBRASI_DIAM = 0,
+  KALIBRASI_BERJALAN,
+  KALIBRASI_SELESAI,
+  KALIBRASI_GAGAL,
+};
+
+struct PengaturanKalibrasi {
+  uint8_t jumlahLevel;     // level duty dutyMin..1 (<= KALIBRASI_MAKS_LEVEL)
+  float dutyMin;           // fraksi
+  uint32_t tahanMs;        // transien dibuang tiap level
+  uint32_t ukurMs;         // jendela regresi tiap level
+  bool relatif;            // kemiringan dibagi rata-rata pembacaan (laju peluruhan)
+  float arah;              // +1 aktuator menaikkan pembacaan, -1 menurunkan
+  float responMin;         // efek minimal di duty penuh (per detik)
+  float nilaiMin;          // rata-rata pembacaan minimal (mode relatif)
+  float batasSimpang;      // simpangan maks dari pembacaan awal (C / %)
+  float ambangMati;        // disalin ke kurva hasil
+};
+
+// Bawaan per aktuator: heater 6 level x 6 menit (~48 menit, naik < 1 C di
+// tangki 30 L / 95 W), pompa 7 level 0.70..1 x 80 s (~12 menit)
+PengaturanKalibrasi pengaturanKalibrasi(KanalPwm kanal);
+
+class KalibrasiAktuator {
+public:
+  void mulai(KanalPwm k, const PengaturanKalibrasi &p, unsigned long now);
+  void batal();
+  bool aktif(KanalPwm k) const { return status == KALIBRASI_BERJALAN && kanal == k; }
+
+  // Satu tick loop aktuator ini: nilai = pembacaan terfilter (C / %).
+  // Return duty uji (fraksi 0-1); 0 setelah selesai / gagal.
+  float langkah(float nilai, unsigned long now);
+  // langkah() + tulis ke driver, return duty (count)
+  int tulis(HalPwm &pwm, float nilai, unsigned long now);
+
+  StatusKalibrasi status = KALIBRASI_DIAM;
+  KanalPwm kanal = KANAL_HEATER;
+  const char *alasan = "";      // GAGAL
+  KurvaAktuator kurva = {};     // hasil (SELESAI)
+  // Hasil ukur per level (laporan): duty (fraksi) & efek (per detik, baseline belum dikurangi)
+  uint8_t jumlahTitik = 0;      // level selesai, termasuk baseline
+  float dutyLevel[KALIBRASI_MAKS_LEVEL + 2];
+  float respon[KALIBRASI_MAKS_LEVEL + 2];
+
+private:
+  PengaturanKalibrasi p = {};
+  uint8_t level = 0;
+  unsigned long awalLevel = 0;
+  float nilaiAwal = 0.0f;
+  bool adaAwal = false;
+  // Regresi: x = detik sejak awal jendela, y = nilai - yAwal
+  uint32_t n = 0;
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  float yAwal = 0.0f;
+
+  float dutyUntuk(uint8_t lv) const;
+  void gagal(const char *kenapa);
+  void bangunKurva();
+};
+
+// Kurva aktif disimpan di flash (PATH_KURVA_AKTUATOR) supaya kalibrasi tidak
+// perlu diulang tiap boot. muat: false jika tidak ada / versi beda / tidak valid
+// (isi heater & pompa tidak diubah).
+bool simpanKurvaAktuator(HalBerkas &berkas, const KurvaAktuator &heater, const KurvaAktuator &pompa);
+bool muatKurvaAktuator(HalBerkas &berkas, KurvaAktuator &heater, KurvaAktuator &pompa);
+
+// {"aktuator":"heater","status":"selesai","alasan":"","ambang":..,"kurva":[..],"duty":[..],"respon":[..]}
+// Return panjang, 0 jika buf kurang
+size_t serializeKalibrasi(const KalibrasiAktuator &k, char *buf, size_t len);
+
+#endif
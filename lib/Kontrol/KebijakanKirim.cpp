@@ -0,0 +1,67 @@
+#include "KebijakanKirim.h"
+#include <math.h>
+#include <stdio.h>
+
+namespace {
+
+bool lewatDeadband(const Telemetri &a, const Telemetri &b, const PengaturanKirim &p) {
+  return fabsf(a.suhu - b.suhu) > p.deadbandSuhu ||
+         fabsf(a.turbidityPersen - b.turbidityPersen) > p.deadbandKeruh ||
+         fabs(a.outSuhu - b.outSuhu) > p.deadbandOutput ||
+         fabs(a.outKeruh - b.outKeruh) > p.deadbandOutput;
+}
+
+}  // namespace
+
+AlasanKirim KebijakanKirim::putuskan(const Telemetri &t, const PengaturanKirim &p) {
+  const unsigned long now = t.timestamp_ms;
+  const unsigned long selang = now - terakhir.timestamp_ms + KIRIM_TOLERANSI_MS;
+  AlasanKirim alasan = KIRIM_DITEKAN;
+
+  if (!p.aktif) {
+    if (!adaTerakhir || selang >= p.intervalNormalMs) alasan = KIRIM_INTERVAL;
+  } else {
+    const bool kejadian = adaTerakhir && (t.kontrolAktif != terakhir.kontrolAktif ||
+                                          t.setpointSuhu != terakhir.setpointSuhu ||
+                                          t.setpointKeruh != terakhir.setpointKeruh);
+    if (kejadian) {
+      adaTransien = true;
+      mulaiTransien = now;
+    }
+    // Error besar: deadband dicek pada laju cepat (hanya yang benar-benar berubah)
+    const bool errorBesar = fabsf(t.errorSuhu) > p.errorBesarSuhu || t.errorKeruh > p.errorBesarKeruh;
+    const uint32_t intervalDeadband = errorBesar ? p.intervalCepatMs : p.intervalNormalMs;
+
+    if (!adaTerakhir) alasan = KIRIM_PERTAMA;
+    else if (kejadian) alasan = KIRIM_KEJADIAN;
+    else if (transien(now, p) && selang >= p.intervalCepatMs) alasan = KIRIM_TRANSIEN;
+    else if (selang >= intervalDeadband && lewatDeadband(t, terakhir, p)) alasan = KIRIM_DEADBAND;
+    else if (selang >= p.heartbeatMs) alasan = KIRIM_HEARTBEAT;
+  }
+
+  jumlah[alasan]++;
+  if (alasan != KIRIM_DITEKAN) {
+    terakhir = t;
+    adaTerakhir = true;
+  }
+  return alasan;
+}
+
+uint32_t KebijakanKirim::terkirim() const {
+  uint32_t n = 0;
+  for (int i = 1; i < JUMLAH_ALASAN_KIRIM; i++) n += jumlah[i];
+  return n;
+}
+
+size_t serializeStatusKirim(const KebijakanKirim &k, bool transien, char *buf, size_t len) {
+  const uint32_t total = k.terkirim() + k.ditekan();
+  int n = snprintf(buf, len,
+    "{\"terkirim\":%lu,\"ditekan\":%lu,\"rasio_ditekan\":%.3f,\"mode_transien\":%s,"
+    "\"pertama\":%lu,\"kejadian\":%lu,\"transien\":%lu,\"deadband\":%lu,\"heartbeat\":%lu,\"interval\":%lu}",
+    (unsigned long)k.terkirim(), (unsigned long)k.ditekan(), total ? (double)k.ditekan() / total : 0.0,
+    transien ? "true" : "false",
+    (unsigned long)k.jumlah[KIRIM_PERTAMA], (unsigned long)k.jumlah[KIRIM_KEJADIAN],
+    (unsigned long)k.jumlah[KIRIM_TRANSIEN], (unsigned long)k.jumlah[KIRIM_DEADBAND],
+    (unsigned long)k.jumlah[KIRIM_HEARTBEAT], (unsigned long)k.jumlah[KIRIM_INTERVAL]);
+  return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * KEBIJAKAN KIRIM TELEMETRI (REPORT-BY-EXCEPTION)
+ * * Deskripsi:
+ * Task kontrol menyerahkan snapshot tiap KIRIM_INTERVAL_CEPAT_MS; kebijakan
+ * ini yang memutuskan snapshot mana yang benar-benar dipublikasikan.
+ * - Kejadian (ganti mode / setpoint): kirim saat itu juga lalu semua
+ *   sampel tiap intervalCepatMs selama tahanTransienMs (resolusi penuh).
+ * - Deadband: kirim jika suhu / turbidity / output aktuator keluar dari
+ *   deadband terhadap sampel terakhir yang dikirim, paling cepat tiap
+ *   intervalNormalMs; saat error besar paling cepat tiap intervalCepatMs,
+ *   jadi laju naik sendiri selama sinyal bergerak cepat.
+ * - Heartbeat: paling lama heartbeatMs tanpa kiriman.
+ * Jadi nilai yang ditekan selalu bisa direkonstruksi (sample-and-hold)
+ * dari sampel terkirim sebelumnya dengan galat <= deadband.
+ * Hanya dipanggil dari satu task (task jaringan).
+ */
+
+#ifndef AQUARIUM_KEBIJAKAN_KIRIM_H
+#define AQUARIUM_KEBIJAKAN_KIRIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Tick.h"
+
+#ifndef KIRIM_DEADBAND_SUHU
+#define KIRIM_DEADBAND_SUHU 0.05f      // C
+#endif
+#ifndef KIRIM_DEADBAND_KERUH
+#define KIRIM_DEADBAND_KERUH 0.2f      // %
+#endif
+#ifndef KIRIM_DEADBAND_OUTPUT
+#define KIRIM_DEADBAND_OUTPUT 5.0f     // % output heater / pompa
+#endif
+#ifndef KIRIM_HEARTBEAT_MS
+#define KIRIM_HEARTBEAT_MS 60000
+#endif
+#ifndef KIRIM_INTERVAL_CEPAT_MS
+#define KIRIM_INTERVAL_CEPAT_MS 250    // = PERIODE_KERUH_MS
+#endif
+#ifndef KIRIM_INTERVAL_NORMAL_MS
+#define KIRIM_INTERVAL_NORMAL_MS 1000  // laju lama (intervalKirim)
+#endif
+#ifndef KIRIM_TAHAN_TRANSIEN_MS
+#define KIRIM_TAHAN_TRANSIEN_MS 30000
+#endif
+
+// Toleransi jitter penjadwal saat membandingkan selang waktu
+const uint32_t KIRIM_TOLERANSI_MS = 10;
+
+struct PengaturanKirim {
+  bool aktif = true;   // false = kirim tiap intervalNormalMs (perilaku lama)
+  float deadbandSuhu = KIRIM_DEADBAND_SUHU;
+  float deadbandKeruh = KIRIM_DEADBAND_KERUH;
+  float deadbandOutput = KIRIM_DEADBAND_OUTPUT;
+  uint32_t heartbeatMs = KIRIM_HEARTBEAT_MS;
+  uint32_t intervalCepatMs = KIRIM_INTERVAL_CEPAT_MS;
+  uint32_t intervalNormalMs = KIRIM_INTERVAL_NORMAL_MS;
+  uint32_t tahanTransienMs = KIRIM_TAHAN_TRANSIEN_MS;
+  // Error besar = deadband dicek pada laju cepat. Keruh satu sisi: di bawah setpoint pompa memang
+  // dimatikan (keruhMati), error negatif yang menetap bukan transien.
+  float errorBesarSuhu = 1.0f;    // |error| (C)
+  float errorBesarKeruh = 3.0f;   // error (%) di atas setpoint
+};
+
+enum AlasanKirim : uint8_t {
+  KIRIM_DITEKAN = 0,
+  KIRIM_PERTAMA,
+  KIRIM_KEJADIAN,
+  KIRIM_TRANSIEN,
+  KIRIM_DEADBAND,
+  KIRIM_HEARTBEAT,
+  KIRIM_INTERVAL,     // kebijakan nonaktif
+  JUMLAH_ALASAN_KIRIM
+};
+
+class KebijakanKirim {
+public:
+  // Waktu = t.timestamp_ms. Sampel yang lolos menjadi acuan deadband berikutnya.
+  AlasanKirim putuskan(const Telemetri &t, const PengaturanKirim &p);
+
+  bool transien(unsigned long now, const PengaturanKirim &p) const {
+    return adaTransien && now - mulaiTransien < p.tahanTransienMs;
+  }
+  uint32_t ditekan() const { return jumlah[KIRIM_DITEKAN]; }
+  uint32_t terkirim() const;
+
+  uint32_t jumlah[JUMLAH_ALASAN_KIRIM] = {};
+
+private:
+  Telemetri terakhir = {};        // sampel terakhir yang dikirim
+  bool adaTerakhir = false;
+  bool adaTransien = false;
+  unsigned long mulaiTransien = 0;
+};
+
+// {"terkirim":..,"ditekan":..,"rasio_ditekan":..,"mode_transien":..,"pertama":..,...}
+// Return panjang, 0 jika buf kurang
+size_t serializeStatusKirim(const KebijakanKirim &k, bool transien, char *buf, size_t len);
+
+#endif
@@ -0,0 +1,164 @@
+#include "Kontrol.h"
+#include <math.h>
+
+// =========================================================================
+//                  FUNGSI BANTUAN (HELPER)
+// =========================================================================
+
+const char *namaMode(ControlMode m) {
+  return (m == PID) ? "PID" : (m == MPC) ? "MPC" : "Fuzzy";
+}
+
+// =========================================================================
+//                  LOGIKA FUZZY (SUGENO)
+// =========================================================================
+
+AturanFuzzy aturanFuzzy = ATURAN_FUZZY_DEFAULT;
+
+float hitungFuzzySuhu(float errorSuhu) {
+  return aturanFuzzy.suhu.hitung(errorSuhu);
+}
+
+float hitungFuzzyKeruh(float errorKeruh) {
+  return aturanFuzzy.keruh.hitung(errorKeruh);
+}
+
+// --- PD-Fuzzy Suhu ---
+float hitungFuzzySuhuPD(float &lastError, unsigned long &lastTime, const AturanFuzzy &af,
+                        float errorSuhu, unsigned long now) {
+  float dt = (float)(now - lastTime) / 1000.0f;
+  if (dt < 0.001f) dt = 0.001f;
+
+  // Delta error dalam C/menit (skala himpunan HIMPUNAN_DELTA_SUHU)
+  const float in[2] = {errorSuhu, (errorSuhu - lastError) * 60.0f / dt};
+  lastError = errorSuhu;
+  lastTime = now;
+  return af.suhuPD.hitung(in);
+}
+
+float hitungFuzzySuhuPD(StateKontrol &st, const AturanFuzzy &af, float errorSuhu, unsigned long now) {
+  return hitungFuzzySuhuPD(st.lastErrorFuzzySuhu, st.lastTimeFuzzySuhu, af, errorSuhu, now);
+}
+
+float hitungFuzzySuhuMesin(float &lastError, unsigned long &lastTime, const AturanFuzzy &af,
+                           MesinFuzzy mesin, float errorSuhu, unsigned long now) {
+  if (mesin == FUZZY_PD) return hitungFuzzySuhuPD(lastError, lastTime, af, errorSuhu, now);
+  if (mesin == FUZZY_LUT) return af.lutSuhu.hitung(errorSuhu);
+  return af.suhu.hitung(errorSuhu);
+}
+
+double hitungFuzzyKeruhTerfilter(double &outputTerfilter, const AturanFuzzy &af, MesinFuzzy mesin,
+                                 float errorKeruh, float turbidityPersen, float tahan, float mati) {
+  double rawFuzzyKeruh = (mesin == FUZZY_LUT) ? af.lutKeruh.hitung(errorKeruh) : af.keruh.hitung(errorKeruh);
+  if (turbidityPersen >= tahan) {
+     if (rawFuzzyKeruh < 50.0) {
+        rawFuzzyKeruh = 50.0;
+     }
+  }
+  if (turbidityPersen <= mati) {
+      rawFuzzyKeruh = 0.0;
+  }
+  outputTerfilter = (0.5 * rawFuzzyKeruh) + ((1.0 - 0.5) * outputTerfilter);
+  return outputTerfilter;
+}
+
+void siapkanFuzzyLut() {
+  aturanFuzzy.panggangLut();
+}
+
+// =========================================================================
+//                      KONTROL PID (ADVANCED)
+// =========================================================================
+
+// Gain dikonversi ke AngkaPid tiap panggilan (murah: 3-4 konversi float)
+double hitungPIDSuhu(StateKontrol &st, const ParameterKontrol &p, float errorSuhu, unsigned long now) {
+  const GainPid<AngkaPid> g = {AngkaPid(p.Kp_suhu), AngkaPid(p.Ki_suhu), AngkaPid(p.Kd_suhu)};
+  return (double)pidSuhu(st.pidSuhu, g, errorSuhu, now);
+}
+
+double hitungPIDKeruh(StateKontrol &st, const ParameterKontrol &p, float errorKeruh, unsigned long now) {
+  const GainPidKeruh<AngkaPid> g = {AngkaPid(p.Kp_keruh), AngkaPid(p.Ki_keruh), AngkaPid(p.Kd_keruh),
+                                    AngkaPid(p.Kp_keruh_turbo), p.ambangTurboKeruh,
+                                    p.keruhTahan, p.keruhMati, p.turbiditySetpoint};
+  return (double)pidKeruh(st.pidKeruh, g, errorKeruh, now);
+}
+
+void resetPID(StateKontrol &st, unsigned long now) {
+  st.pidSuhu.reset(now);
+  st.pidKeruh.reset(now);
+  st.outputKeruhTerfilter = 0.0;
+  st.suhuTerfilter = 0.0;
+  st.lastErrorFuzzySuhu = 0; st.lastTimeFuzzySuhu = now;
+  st.mpc.siap = false;
+  st.transferSuhu = TransferMulus();
+  st.transferKeruh = TransferMulus();
+}
+
+// =========================================================================
+//                  TRANSFER MULUS (MODE BAYANGAN)
+// =========================================================================
+
+// Integral yang membuat output PID = u pada error & derivatif terakhir
+static AngkaPid integralTransfer(const StatePid<AngkaPid> &s, float kp, float ki, float kd, double u) {
+  if (ki <= 0.0f) return s.integral;
+  const double i = (u - kp * (double)(float)s.lastError - kd * (double)(float)s.lastDeriv) / ki;
+  return AngkaPid((float)batasi(i, -20.0, 20.0));
+}
+
+void mulaiTransferMulus(StateKontrol &st, const ParameterKontrol &p, unsigned long now) {
+  if (p.kontrolAktif == PID) {
+    st.pidSuhu.integral = integralTransfer(st.pidSuhu, p.Kp_suhu, p.Ki_suhu, p.Kd_suhu, st.outSuhuTerakhir);
+    // Mode Turbo mengabaikan integral; feedforward 50% ada di luar P + I + D
+    if (fabsf((float)st.pidKeruh.lastError) <= p.ambangTurboKeruh) {
+      st.pidKeruh.integral =
+          integralTransfer(st.pidKeruh, p.Kp_keruh, p.Ki_keruh, p.Kd_keruh, st.outKeruhTerakhir - 50.0);
+    }
+  }
+  st.transferSuhu.tunggu = st.transferKeruh.tunggu = true;
+  st.transferSuhu.lastTime = st.transferKeruh.lastTime = now;
+}
+
+double terapkanTransfer(TransferMulus &tr, double out, double outLama, float tauDetik, unsigned long now) {
+  if (tr.tunggu) {
+    tr.tunggu = false;
+    tr.bias = outLama - out;
+  } else if (tr.bias != 0.0) {
+    tr.bias *= exp(-(double)(now - tr.lastTime) / (1000.0 * tauDetik));
+    if (fabs(tr.bias) < 0.01) tr.bias = 0.0;
+  }
+  tr.lastTime = now;
+  if (tr.bias == 0.0) return out;
+  return batasi(out + tr.bias, 0.0, 100.0);
+}
+
+// =========================================================================
+//                  HITUNG OUTPUT KONTROL
+// =========================================================================
+
+double hitungKontrolSuhu(StateKontrol &st, const ParameterKontrol &p, float errorSuhu,
+                         unsigned long now, const AturanFuzzy &af) {
+  if (p.kontrolAktif == FUZZY) {
+    return hitungFuzzySuhuMesin(st.lastErrorFuzzySuhu, st.lastTimeFuzzySuhu, af, p.mesinFuzzySuhu, errorSuhu, now);
+  }
+  if (p.kontrolAktif == MPC) {
+    return hitungMpcSuhu(st.mpc, TABEL_MPC, p.suhuSetpoint - errorSuhu, p.suhuSetpoint, now);
+  }
+  return hitungPIDSuhu(st, p, errorSuhu, now);
+}
+
+double hitungKontrolKeruh(StateKontrol &st, const ParameterKontrol &p, float errorKeruh,
+                          float turbidityPersen, unsigned long now, const AturanFuzzy &af) {
+  if (p.kontrolAktif != PID) {
+    return hitungFuzzyKeruhTerfilter(st.outputKeruhTerfilter, af, p.mesinFuzzyKeruh, errorKeruh,
+                                     turbidityPersen, p.keruhTahan, p.keruhMati);
+  }
+  return hitungPIDKeruh(st, p, errorKeruh, now);
+}
+
+void hitungKontrol(StateKontrol &st, const ParameterKontrol &p,
+                   float errorSuhu, float errorKeruh, float turbidityPersen,
+                   unsigned long now, double &outSuhu, double &outKeruh,
+                   const AturanFuzzy &af) {
+  outSuhu = hitungKontrolSuhu(st, p, errorSuhu, now, af);
+  outKeruh = hitungKontrolKeruh(st, p, errorKeruh, turbidityPersen, now, af);
+}
@@ -0,0 +1,159 @@
+/**
+ * LOGIKA KONTROL (FUZZY SUGENO, PID ADAPTIF & MPC EKSPLISIT)
+ * * Deskripsi:
+ * Kernel kontrol yang dulu menempel di src/main.cpp, dipisah supaya bisa
+ * dikompilasi di ESP32 maupun native (benchmark / simulasi).
+ * - Tidak ada pemanggilan Arduino di sini; waktu (now) selalu dioper dari luar.
+ * - Semua parameter (setpoint, gain, kalibrasi, kurva aktuator) ada di ParameterKontrol,
+ *   semua memori kontroler (integral, error terakhir, filter) di StateKontrol.
+ * - Mode bayangan: Fuzzy & PID dihitung tiap tick pada sampel yang sama (state
+ *   keduanya terpisah), hanya mode aktif yang menggerakkan aktuator. Dengan
+ *   transferMulus, ganti mode tidak me-reset kontroler tetapi mengisi state
+ *   kontroler baru dari output lama (lihat mulaiTransferMulus).
+ */
+
+#ifndef AQUARIUM_KONTROL_H
+#define AQUARIUM_KONTROL_H
+
+#include <stdint.h>
+#include "Aktuator.h"
+#include "AturanFuzzy.h"
+#include "Mpc.h"
+#include "Pid.h"
+
+// Mode Kontrol. MPC hanya untuk loop suhu (tabel TABEL_MPC); loop keruh
+// pada mode MPC memakai fuzzy seperti mode FUZZY.
+enum ControlMode { FUZZY, PID, MPC };
+
+// Cara evaluasi fuzzy per loop: eksak (rule base), tabel LUT,
+// atau PD-fuzzy dua input (error & delta error, khusus loop suhu)
+enum MesinFuzzy { FUZZY_EKSAK, FUZZY_LUT, FUZZY_PD };
+
+struct ParameterKontrol {
+  ControlMode kontrolAktif = FUZZY;
+  MesinFuzzy mesinFuzzySuhu = FUZZY_EKSAK;
+  MesinFuzzy mesinFuzzyKeruh = FUZZY_EKSAK;
+
+  // Setpoint default
+  float suhuSetpoint = 28.0f;
+  float turbiditySetpoint = 15.0f;
+
+  // Parameter PID (Default Tuning - Mode Smooth); single precision untuk FPU ESP32
+  float Kp_suhu = 8.0f, Ki_suhu = 0.3f, Kd_suhu = 6.0f;
+  float Kp_keruh = 5.0f, Ki_keruh = 0.2f, Kd_keruh = 2.0f;
+
+  // Gain scheduling PID keruh: Mode Turbo (P saja) jika |error| > ambang
+  float Kp_keruh_turbo = 35.0f;
+  float ambangTurboKeruh = 2.0f;
+
+  // Batas pompa (Fuzzy & PID): >= keruhTahan output minimal 50%,
+  // <= keruhMati pompa mati total
+  float keruhTahan = 11.0f;
+  float keruhMati = 9.0f;
+
+  // Kalibrasi ADC Turbidity (Nilai Default)
+  int NILAI_ADC_JERNIH = 20100;
+  int NILAI_ADC_KERUH = 3550;
+
+  // Linearisasi aktuator logika % -> duty (bawaan atau hasil KalibrasiAktuator)
+  KurvaAktuator kurvaHeater = KURVA_HEATER_DEFAULT;
+  KurvaAktuator kurvaPompa = KURVA_POMPA_DEFAULT;
+  bool ditherHeater = AKTUATOR_DITHER_HEATER;
+
+  // Mode bayangan & transfer mulus saat ganti mode (hanya di mode bayangan)
+  bool modeBayangan = false;
+  bool transferMulus = false;
+  float tauTransfer = 30.0f;   // detik, peluruhan bias transfer
+};
+
+// Sisa loncatan output saat ganti mode, meluruh ke 0 (per loop)
+struct TransferMulus {
+  double bias = 0.0;          // % output
+  bool tunggu = false;        // bias diisi di tick pertama mode baru
+  unsigned long lastTime = 0;
+};
+
+struct StateKontrol {
+  // Integral, error & derivatif terakhir PID (tipe AngkaPid, lihat Pid.h)
+  StatePid<AngkaPid> pidSuhu;
+  StatePid<AngkaPid> pidKeruh;
+
+  // Observer & output terakhir MPC suhu
+  StateMpc mpc;
+
+  // Memori PD-fuzzy suhu (delta error)
+  float lastErrorFuzzySuhu = 0.0f;
+  unsigned long lastTimeFuzzySuhu = 0;
+
+  // Filter output pompa (fuzzy) & filter suhu
+  double outputKeruhTerfilter = 0.0;
+  float suhuTerfilter = 0.0f;
+
+  // Sisa kuantisasi sigma-delta heater (LSB)
+  float sisaDitherHeater = 0.0f;
+
+  // Output kontroler yang terakhir menggerakkan aktuator (0-100%) & transfer mulus
+  double outSuhuTerakhir = 0.0, outKeruhTerakhir = 0.0;
+  TransferMulus transferSuhu, transferKeruh;
+  uint32_t lewatAnggaranBayangan = 0;   // tick bayangan yang melewati ANGGARAN_BAYANGAN_US
+
+  // Nilai sensor terakhir
+  float suhuTerakhir = 25.0f;
+  int turbidityTerakhir = 0;
+};
+
+inline float mapFloat(float x, float in_min, float in_max, float out_min, float out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// "Fuzzy" / "PID" / "MPC" (kontrol_aktif di telemetri & perintah)
+const char *namaMode(ControlMode m);
+
+// --- Fuzzy Sugeno ---
+// Rule base aktif (awal = ATURAN_FUZZY_DEFAULT, bisa diganti lewat MQTT)
+extern AturanFuzzy aturanFuzzy;
+
+float hitungFuzzySuhu(float errorSuhu);
+float hitungFuzzyKeruh(float errorKeruh);
+float hitungFuzzySuhuPD(StateKontrol &st, const AturanFuzzy &af, float errorSuhu, unsigned long now);
+
+// Bentuk dengan state lewat referensi (dipakai juga BankKontrol, layout SoA)
+float hitungFuzzySuhuPD(float &lastError, unsigned long &lastTime, const AturanFuzzy &af,
+                        float errorSuhu, unsigned long now);
+float hitungFuzzySuhuMesin(float &lastError, unsigned long &lastTime, const AturanFuzzy &af,
+                           MesinFuzzy mesin, float errorSuhu, unsigned long now);
+// Fuzzy keruh + batas pompa (tahan/mati) + filter output 0.5
+double hitungFuzzyKeruhTerfilter(double &outputTerfilter, const AturanFuzzy &af, MesinFuzzy mesin,
+                                 float errorKeruh, float turbidityPersen, float tahan, float mati);
+
+// Panggang ulang kedua LUT (setelah rule base berubah)
+void siapkanFuzzyLut();
+
+// --- PID ---
+double hitungPIDSuhu(StateKontrol &st, const ParameterKontrol &p, float errorSuhu, unsigned long now);
+double hitungPIDKeruh(StateKontrol &st, const ParameterKontrol &p, float errorKeruh, unsigned long now);
+void resetPID(StateKontrol &st, unsigned long now);
+
+// --- Transfer mulus (mode bayangan) ---
+// Dipanggil sekali saat ganti mode, p = parameter baru. PID yang masuk diisi
+// integralnya (back-calculation) supaya P + I + D = output terakhir; sisa
+// loncatan (Fuzzy & MPC tanpa integrator, integral jenuh, Mode Turbo) diukur
+// di tick berikutnya sebagai bias yang meluruh dengan tauTransfer.
+void mulaiTransferMulus(StateKontrol &st, const ParameterKontrol &p, unsigned long now);
+// Output kontroler + bias transfer (0-100%); outLama = output tick sebelumnya
+double terapkanTransfer(TransferMulus &tr, double out, double outLama, float tauDetik, unsigned long now);
+
+// Hitung output satu loop (0-100%) sesuai mode aktif; tiap loop boleh
+// dipanggil dengan periode berbeda (dt diukur dari now)
+double hitungKontrolSuhu(StateKontrol &st, const ParameterKontrol &p, float errorSuhu,
+                         unsigned long now, const AturanFuzzy &af = aturanFuzzy);
+double hitungKontrolKeruh(StateKontrol &st, const ParameterKontrol &p, float errorKeruh,
+                          float turbidityPersen, unsigned long now, const AturanFuzzy &af = aturanFuzzy);
+
+// Hitung output kedua loop (0-100%) sesuai mode aktif
+void hitungKontrol(StateKontrol &st, const ParameterKontrol &p,
+                   float errorSuhu, float errorKeruh, float turbidityPersen,
+                   unsigned long now, double &outSuhu, double &outKeruh,
+                   const AturanFuzzy &af = aturanFuzzy);
+
+#endif
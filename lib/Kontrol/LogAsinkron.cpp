@@ -0,0 +1,192 @@
+#include "LogAsinkron.h"
+#include <stdio.h>
+
+AntrianLog logGlobal;
+
+AntrianLog::AntrianLog() {
+  for (uint32_t i = 0; i < LOG_SLOT; i++) slot[i].urutan.store(i, std::memory_order_relaxed);
+}
+
+// Pesan satu slot: urutan == pos berarti kosong & giliran pos. Return nullptr jika penuh.
+EntriLog *AntrianLog::pesan(uint32_t &pos) {
+  pos = ekor.load(std::memory_order_relaxed);
+  for (;;) {
+    EntriLog &e = slot[pos & (LOG_SLOT - 1)];
+    const int32_t beda = (int32_t)(e.urutan.load(std::memory_order_acquire) - pos);
+    if (beda == 0) {
+      if (ekor.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return &e;
+    } else if (beda < 0) {
+      terbuang.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    } else {
+      pos = ekor.load(std::memory_order_relaxed);   // produsen lain sudah memesan pos ini
+    }
+  }
+}
+
+bool AntrianLog::tulis(uint8_t tingkat, const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  bool ok = tulisV(tingkat, fmt, ap);
+  va_end(ap);
+  return ok;
+}
+
+bool AntrianLog::tulisV(uint8_t tingkat, const char *fmt, va_list ap) {
+  uint32_t pos;
+  EntriLog *e = pesan(pos);
+  if (!e) return false;
+  e->tingkat = tingkat;
+  e->format = nullptr;
+  e->jumlahArg = 0;
+  vsnprintf(e->teks, LOG_PANJANG, fmt, ap);
+  e->urutan.store(pos + 1, std::memory_order_release);
+  ditulis.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool AntrianLog::tulisArg(uint8_t tingkat, const char *fmt, const ArgLog *arg, int n) {
+  uint32_t pos;
+  EntriLog *e = pesan(pos);
+  if (!e) return false;
+  e->tingkat = tingkat;
+  e->format = fmt;
+  e->jumlahArg = (uint8_t)n;
+
+  // Byte terakhir str selalu NUL: string yang tidak muat menunjuk ke sana ("")
+  const size_t ukuranStr = sizeof(e->tunda.str);
+  e->tunda.str[ukuranStr - 1] = '\0';
+  size_t isi = 0;
+  for (int i = 0; i < n; i++) {
+    e->tunda.tipe[i] = arg[i].tipe;
+    if (arg[i].tipe != 's') {
+      e->tunda.nilai[i] = arg[i].v;
+      continue;
+    }
+    const char *s = arg[i].v.p ? (const char *)arg[i].v.p : "(null)";
+    const size_t sisa = ukuranStr - 1 - isi;
+    if (sisa == 0) {
+      e->tunda.nilai[i].ofs = (uint16_t)(ukuranStr - 1);
+      continue;
+    }
+    size_t len = strnlen(s, sisa - 1);
+    memcpy(e->tunda.str + isi, s, len);
+    e->tunda.str[isi + len] = '\0';
+    e->tunda.nilai[i].ofs = (uint16_t)isi;
+    isi += len + 1;
+  }
+  e->urutan.store(pos + 1, std::memory_order_release);
+  ditulis.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool AntrianLog::kosong() const {
+  const uint32_t k = kepala.load(std::memory_order_relaxed);
+  return slot[k & (LOG_SLOT - 1)].urutan.load(std::memory_order_acquire) != k + 1;
+}
+
+// Pesan dibuang dilaporkan di titik antrian kosong (= tempat pesan itu hilang)
+bool AntrianLog::lapor(KeluaranLog keluaran, void *ctx) {
+  const uint32_t t = terbuang.load(std::memory_order_relaxed);
+  if (t == terbuangDilaporkan) return true;
+  char baris[48];
+  int n = snprintf(baris, sizeof(baris), "[LOG] %lu pesan dibuang", (unsigned long)(t - terbuangDilaporkan));
+  if (!keluaran(baris, (size_t)n, ctx)) return false;
+  terbuangDilaporkan = t;
+  return true;
+}
+
+int AntrianLog::kuras(KeluaranLog keluaran, void *ctx, int maks) {
+  char buf[LOG_PANJANG];
+  uint32_t k = kepala.load(std::memory_order_relaxed);
+  int n = 0;
+  while (n < maks) {
+    EntriLog &e = slot[k & (LOG_SLOT - 1)];
+    if (e.urutan.load(std::memory_order_acquire) != k + 1) {
+      lapor(keluaran, ctx);
+      break;
+    }
+    bool ok;
+    if (e.format) ok = keluaran(buf, formatTunda(e.format, e, buf, sizeof(buf)), ctx);
+    else ok = keluaran(e.teks, strnlen(e.teks, LOG_PANJANG), ctx);
+    if (!ok) break;   // UART penuh: slot tetap milik konsumen, dicoba lagi
+    e.urutan.store(k + LOG_SLOT, std::memory_order_release);
+    kepala.store(++k, std::memory_order_relaxed);
+    n++;
+  }
+  return n;
+}
+
+size_t formatTunda(const char *fmt, const EntriLog &e, char *buf, size_t len) {
+  if (len == 0) return 0;
+  size_t o = 0;
+  int k = 0;
+  const char *f = fmt;
+  while (*f && o + 1 < len) {
+    if (*f != '%') {
+      buf[o++] = *f++;
+      continue;
+    }
+    f++;
+    if (*f == '%') {
+      buf[o++] = '%';
+      f++;
+      continue;
+    }
+    // %[flag][lebar][.presisi][panjang]konversi; panjang diganti sesuai tipe argumen tersimpan
+    char spes[24] = "%";
+    size_t s = 1;
+    while (*f && strchr("-+ #0123456789.", *f)) {
+      if (s < sizeof(spes) - 4) spes[s++] = *f;
+      f++;
+    }
+    while (*f && strchr("hlLqjzt", *f)) f++;
+    const char c = *f;
+    if (!c || k >= e.jumlahArg) break;
+    f++;
+    const char tipe = e.tunda.tipe[k];
+    const NilaiLog v = e.tunda.nilai[k];
+    k++;
+
+    int w = 0;
+    char *out = buf + o;
+    const size_t sisa = len - o;
+    switch (c) {
+      case 'd': case 'i':
+        memcpy(spes + s, "ll", 2);
+        spes[s + 2] = c;
+        spes[s + 3] = '\0';
+        w = snprintf(out, sisa, spes, tipe == 'd' ? (long long)v.d : v.i);
+        break;
+      case 'u': case 'o': case 'x': case 'X':
+        memcpy(spes + s, "ll", 2);
+        spes[s + 2] = c;
+        spes[s + 3] = '\0';
+        w = snprintf(out, sisa, spes, tipe == 'd' ? (unsigned long long)v.d : v.u);
+        break;
+      case 'c':
+        spes[s] = c;
+        spes[s + 1] = '\0';
+        w = snprintf(out, sisa, spes, (int)v.i);
+        break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spes[s] = c;
+        spes[s + 1] = '\0';
+        w = snprintf(out, sisa, spes, tipe == 'd' ? v.d : (tipe == 'u' ? (double)v.u : (double)v.i));
+        break;
+      case 's':
+        spes[s] = c;
+        spes[s + 1] = '\0';
+        w = snprintf(out, sisa, spes, tipe == 's' ? e.tunda.str + v.ofs : "?");
+        break;
+      case 'p':
+        w = snprintf(out, sisa, "%p", v.p);
+        break;
+      default:
+        break;
+    }
+    if (w > 0) o += ((size_t)w < sisa) ? (size_t)w : sisa - 1;
+  }
+  buf[o] = '\0';
+  return o;
+}
@@ -0,0 +1,174 @@
+/**
+ * LOG ASINKRON (RING BUFFER LOCK-FREE, BANYAK PRODUSEN)
+ * * Deskripsi:
+ * Pengganti Serial.printf langsung: pemanggil hanya memformat ke slot RAM,
+ * UART dikuras task berprioritas rendah (task log di core 0).
+ * - Banyak produsen (kedua core, task mana saja), satu konsumen: tiap slot
+ *   punya nomor urut sendiri, produsen memesan slot dengan CAS pada ekor.
+ *   Pemanggil tidak pernah menunggu UART maupun produsen lain.
+ * - Penuh = pesan dibuang & dihitung; konsumen mencetak
+ *   "[LOG] N pesan dibuang" begitu UART sempat.
+ * - Tingkat log dieliminasi saat kompilasi (LOG_TINGKAT): makro tingkat
+ *   yang mati menjadi cabang if (0): format tetap dicek compiler, tapi argumen
+ *   tidak dievaluasi dan string format tidak ikut masuk flash.
+ * - LOG_TUNDA=1: slot hanya menyimpan pointer format (ID) + argumen mentah;
+ *   snprintf pindah ke task log. String (%s) disalin ke slot karena sumbernya
+ *   bisa sudah berubah saat dikuras. Maks LOG_MAKS_ARG argumen, tanpa '*'.
+ * - Satu pesan = satu baris; baris baru ditambahkan konsumen.
+ */
+
+#ifndef AQUARIUM_LOG_ASINKRON_H
+#define AQUARIUM_LOG_ASINKRON_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <atomic>
+
+#define LOG_TINGKAT_MATI 0
+#define LOG_TINGKAT_ERROR 1
+#define LOG_TINGKAT_WARN 2
+#define LOG_TINGKAT_INFO 3
+#define LOG_TINGKAT_DEBUG 4
+
+#ifndef LOG_TINGKAT
+#define LOG_TINGKAT LOG_TINGKAT_DEBUG   // -DLOG_TINGKAT=3 membuang debug per detik dari firmware
+#endif
+#ifndef LOG_TUNDA
+#define LOG_TUNDA 0                     // 1 = format ditunda ke task log
+#endif
+#ifndef LOG_SLOT
+#define LOG_SLOT 64                     // jumlah pesan antre (pangkat 2)
+#endif
+#ifndef LOG_PANJANG
+#define LOG_PANJANG 128                 // byte per pesan (lebih panjang dipotong)
+#endif
+#ifndef LOG_MAKS_ARG
+#define LOG_MAKS_ARG 8
+#endif
+
+// Argumen mentah mode tunda ('i' bertanda, 'u' tak bertanda, 'd' double, 's' string, 'p' pointer)
+union NilaiLog {
+  long long i;
+  unsigned long long u;
+  double d;
+  const void *p;
+  uint16_t ofs;   // 's': offset string di EntriLog::tunda.str
+};
+
+struct ArgLog {
+  char tipe;
+  NilaiLog v;
+};
+
+inline ArgLog argLog(int x) { ArgLog a; a.tipe = 'i'; a.v.i = x; return a; }
+inline ArgLog argLog(long x) { ArgLog a; a.tipe = 'i'; a.v.i = x; return a; }
+inline ArgLog argLog(long long x) { ArgLog a; a.tipe = 'i'; a.v.i = x; return a; }
+inline ArgLog argLog(unsigned x) { ArgLog a; a.tipe = 'u'; a.v.u = x; return a; }
+inline ArgLog argLog(unsigned long x) { ArgLog a; a.tipe = 'u'; a.v.u = x; return a; }
+inline ArgLog argLog(unsigned long long x) { ArgLog a; a.tipe = 'u'; a.v.u = x; return a; }
+inline ArgLog argLog(double x) { ArgLog a; a.tipe = 'd'; a.v.d = x; return a; }
+inline ArgLog argLog(const char *x) { ArgLog a; a.tipe = 's'; a.v.p = x; return a; }
+inline ArgLog argLog(const void *x) { ArgLog a; a.tipe = 'p'; a.v.p = x; return a; }
+
+struct EntriLog {
+  std::atomic<uint32_t> urutan;
+  uint8_t tingkat;
+  uint8_t jumlahArg;
+  const char *format;   // nullptr = teks sudah diformat
+  union {
+    char teks[LOG_PANJANG];
+    struct {
+      char tipe[LOG_MAKS_ARG];
+      NilaiLog nilai[LOG_MAKS_ARG];
+      char str[LOG_PANJANG - LOG_MAKS_ARG - LOG_MAKS_ARG * sizeof(NilaiLog)];
+    } tunda;
+  };
+};
+
+// Tujuan konsumen: false = belum muat (mis. buffer TX UART penuh), pesan dicoba lagi nanti
+typedef bool (*KeluaranLog)(const char *baris, size_t len, void *ctx);
+
+class AntrianLog {
+  static_assert(LOG_SLOT >= 2 && (LOG_SLOT & (LOG_SLOT - 1)) == 0, "LOG_SLOT harus pangkat 2");
+  static_assert(LOG_PANJANG > LOG_MAKS_ARG * (sizeof(NilaiLog) + 1) + 8, "LOG_PANJANG terlalu kecil untuk mode tunda");
+
+public:
+  AntrianLog();
+
+  // Produsen (task mana saja): false jika antrian penuh (pesan dibuang)
+  bool tulis(uint8_t tingkat, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+  bool tulisV(uint8_t tingkat, const char *fmt, va_list ap);
+
+  template <typename... A>
+  bool tulisTunda(uint8_t tingkat, const char *fmt, A... arg) {
+    static_assert(sizeof...(A) <= LOG_MAKS_ARG, "argumen log melebihi LOG_MAKS_ARG");
+    const ArgLog a[sizeof...(A) + 1] = {argLog(arg)..., ArgLog()};
+    return tulisArg(tingkat, fmt, a, (int)sizeof...(A));
+  }
+  bool tulisArg(uint8_t tingkat, const char *fmt, const ArgLog *arg, int n);
+
+  // Konsumen (satu task): kirim maks `maks` pesan ke keluaran, return jumlah terkirim
+  int kuras(KeluaranLog keluaran, void *ctx, int maks = LOG_SLOT);
+  bool kosong() const;
+
+  uint32_t jumlahTerbuang() const { return terbuang.load(std::memory_order_relaxed); }
+  uint32_t jumlahDitulis() const { return ditulis.load(std::memory_order_relaxed); }
+  static constexpr uint32_t kapasitas() { return LOG_SLOT; }
+
+private:
+  EntriLog *pesan(uint32_t &pos);
+  bool lapor(KeluaranLog keluaran, void *ctx);
+
+  alignas(64) std::atomic<uint32_t> ekor{0};   // produsen
+  alignas(64) std::atomic<uint32_t> kepala{0}; // ditulis konsumen saja (dibaca kosong())
+  uint32_t terbuangDilaporkan = 0;
+  std::atomic<uint32_t> terbuang{0}, ditulis{0};
+  EntriLog slot[LOG_SLOT];
+};
+
+// Format ulang pesan tunda ke buf (dipakai konsumen); return panjang
+size_t formatTunda(const char *fmt, const EntriLog &e, char *buf, size_t len);
+
+// Satu antrian untuk seluruh firmware
+extern AntrianLog logGlobal;
+
+// Cek format printf saat kompilasi (tidak pernah dipanggil). Dipakai juga oleh
+// tingkat yang mati supaya argumen tetap "terpakai" (tanpa warning) tapi tidak dievaluasi.
+inline void cekFormatLog(const char *, ...) __attribute__((format(printf, 1, 2)));
+inline void cekFormatLog(const char *, ...) {}
+#define LOG_MATI(fmt, ...) do { if (0) cekFormatLog(fmt, ##__VA_ARGS__); } while (0)
+
+#if LOG_TUNDA
+#define LOG_TULIS(t, fmt, ...)                                         \
+  do {                                                                 \
+    if (0) cekFormatLog(fmt, ##__VA_ARGS__);                           \
+    logGlobal.tulisTunda(t, fmt, ##__VA_ARGS__);                       \
+  } while (0)
+#else
+#define LOG_TULIS(t, fmt, ...) logGlobal.tulis(t, fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_TINGKAT >= LOG_TINGKAT_ERROR
+#define LOG_E(fmt, ...) LOG_TULIS(LOG_TINGKAT_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...) LOG_MATI(fmt, ##__VA_ARGS__)
+#endif
+#if LOG_TINGKAT >= LOG_TINGKAT_WARN
+#define LOG_W(fmt, ...) LOG_TULIS(LOG_TINGKAT_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(fmt, ...) LOG_MATI(fmt, ##__VA_ARGS__)
+#endif
+#if LOG_TINGKAT >= LOG_TINGKAT_INFO
+#define LOG_I(fmt, ...) LOG_TULIS(LOG_TINGKAT_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(fmt, ...) LOG_MATI(fmt, ##__VA_ARGS__)
+#endif
+#if LOG_TINGKAT >= LOG_TINGKAT_DEBUG
+#define LOG_D(fmt, ...) LOG_TULIS(LOG_TINGKAT_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(fmt, ...) LOG_MATI(fmt, ##__VA_ARGS__)
+#endif
+
+#endif
@@ -0,0 +1,213 @@
+#include "ManajerKoneksi.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char PATH_CACHE_WIFI[] = "/wifi.bin";
+static const uint8_t VERSI_CACHE_WIFI = 1;
+
+void ManajerKoneksi::mulai(HalClock &c, HalWifi &w, HalMqtt &m, HalBerkas *b, const PengaturanKoneksi &pk,
+                           uint32_t seed) {
+  clock = &c;
+  wifi = &w;
+  mqtt = &m;
+  berkas = b;
+  p = pk;
+  stat = StatistikKoneksi();
+  keadaanAcak = seed ? seed : 1;
+
+  adaCache = false;
+  if (berkas && berkas->mulai() &&
+      berkas->baca(PATH_CACHE_WIFI, 0, (uint8_t *)&cache, sizeof(cache)) == sizeof(cache)) {
+    cache.ssid[sizeof(cache.ssid) - 1] = '\0';
+    adaCache = cache.versi == VERSI_CACHE_WIFI && cache.indeks < p.jumlahJaringan &&
+               strcmp(cache.ssid, p.jaringan[cache.indeks].ssid) == 0;
+  }
+
+  f = KONEKSI_WIFI_MULAI;
+  cobaCache = adaCache;
+  indeks = -1;
+  dicoba = 0;
+  levelWifi = levelMqtt = 0;
+  mulaiPutus = clock->millis();
+  pernahTerhubung = false;
+  backoffTerakhir = 0;
+}
+
+uint32_t ManajerKoneksi::acak() {
+  // xorshift32: cukup untuk jitter, tanpa state global / heap
+  uint32_t x = keadaanAcak;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return keadaanAcak = x;
+}
+
+// awal * 2^level (maks backoffMaksMs), separuh tetap + separuh acak
+uint32_t ManajerKoneksi::backoff(uint8_t &level) {
+  uint64_t d = (uint64_t)p.backoffAwalMs << (level < 20 ? level : 20);
+  if (d > p.backoffMaksMs) d = p.backoffMaksMs;
+  else level++;
+  const uint32_t tetap = (uint32_t)d / 2;
+  backoffTerakhir = tetap + acak() % ((uint32_t)d - tetap + 1);
+  return backoffTerakhir;
+}
+
+void ManajerKoneksi::mulaiAsosiasi(unsigned long now) {
+  if (p.jumlahJaringan == 0) {
+    f = KONEKSI_WIFI_TUNGGU;
+    tungguSampai = now + backoff(levelWifi);
+    return;
+  }
+  if (cobaCache) {
+    indeks = cache.indeks;
+    wifi->mulai(p.jaringan[indeks].ssid, p.jaringan[indeks].password, cache.bssid, cache.kanal, p.ip);
+  } else {
+    // Jaringan cache (jika ada) tetap dicoba duluan, kali ini dengan scan penuh
+    const int awal = adaCache ? cache.indeks : 0;
+    indeks = (awal + dicoba) % p.jumlahJaringan;
+    wifi->mulai(p.jaringan[indeks].ssid, p.jaringan[indeks].password, nullptr, 0, p.ip);
+  }
+  mulaiFase = now;
+  f = KONEKSI_WIFI_ASOSIASI;
+}
+
+void ManajerKoneksi::asosiasiGagal(unsigned long now) {
+  stat.gagalWifi++;
+  wifi->putus();
+  f = KONEKSI_WIFI_MULAI;
+  if (cobaCache) {
+    stat.cacheMeleset++;
+    cobaCache = false;
+    return;
+  }
+  if (++dicoba >= p.jumlahJaringan) {
+    f = KONEKSI_WIFI_TUNGGU;
+    tungguSampai = now + backoff(levelWifi);
+  }
+}
+
+void ManajerKoneksi::wifiTurun(unsigned long) {
+  stat.putusWifi++;
+  wifi->putus();
+  f = KONEKSI_WIFI_MULAI;
+  dicoba = 0;
+  cobaCache = adaCache;   // AP yang sama biasanya kembali: coba jalur cepat dulu
+  levelWifi = 0;
+}
+
+void ManajerKoneksi::simpanCache() {
+  CacheWifi baru;
+  memset(&baru, 0, sizeof(baru));
+  baru.versi = VERSI_CACHE_WIFI;
+  baru.indeks = (uint8_t)indeks;
+  wifi->infoAp(baru.bssid, baru.kanal);
+  strncpy(baru.ssid, p.jaringan[indeks].ssid, sizeof(baru.ssid) - 1);
+  if (adaCache && memcmp(&baru, &cache, sizeof(cache)) == 0) return;   // flash hanya ditulis jika AP berganti
+  cache = baru;
+  adaCache = true;
+  if (berkas) berkas->tulis(PATH_CACHE_WIFI, (const uint8_t *)&cache, sizeof(cache));
+}
+
+uint8_t ManajerKoneksi::layani() {
+  const unsigned long now = clock->millis();
+  uint8_t kejadian = 0;
+
+  switch (f) {
+    case KONEKSI_WIFI_MULAI:
+      mulaiAsosiasi(now);
+      break;
+
+    case KONEKSI_WIFI_ASOSIASI: {
+      const StatusWifi st = wifi->status();
+      if (st == WIFI_TERHUBUNG) {
+        stat.sambungWifi++;
+        stat.msWifiTerakhir = now - mulaiFase;
+        if (cobaCache) stat.cacheKena++;
+        cobaCache = false;
+        levelWifi = 0;
+        simpanCache();
+        kejadian |= KONEKSI_WIFI_NAIK;
+        f = KONEKSI_MQTT_TUNGGU;
+        levelMqtt = 0;
+        tungguSampai = now;
+      } else if (st == WIFI_GAGAL || now - mulaiFase >= (cobaCache ? p.batasCepatMs : p.batasAsosiasiMs)) {
+        asosiasiGagal(now);
+      }
+      break;
+    }
+
+    case KONEKSI_WIFI_TUNGGU:
+      if ((long)(now - tungguSampai) >= 0) {
+        f = KONEKSI_WIFI_MULAI;
+        dicoba = 0;
+        cobaCache = adaCache;
+      }
+      break;
+
+    case KONEKSI_MQTT_TUNGGU:
+      if (wifi->status() != WIFI_TERHUBUNG) {
+        kejadian |= KONEKSI_WIFI_TURUN;
+        wifiTurun(now);
+        break;
+      }
+      if ((long)(now - tungguSampai) < 0) break;
+      if (mqtt->sambung(p.clientId)) {
+        // Jam dibaca ulang: CONNECT sendiri bisa makan waktu
+        const uint32_t lama = clock->millis() - mulaiPutus;
+        stat.sambungMqtt++;
+        if (!pernahTerhubung) {
+          stat.msBootTerhubung = lama ? lama : 1;
+          pernahTerhubung = true;
+        } else {
+          stat.msSambungTerakhir = lama;
+          if (lama > stat.msSambungMaks) stat.msSambungMaks = lama;
+        }
+        levelMqtt = 0;
+        backoffTerakhir = 0;
+        kejadian |= KONEKSI_MQTT_NAIK;
+        f = KONEKSI_TERHUBUNG;
+      } else {
+        stat.gagalMqtt++;
+        tungguSampai = clock->millis() + backoff(levelMqtt);
+      }
+      break;
+
+    case KONEKSI_TERHUBUNG:
+      if (wifi->status() != WIFI_TERHUBUNG) {
+        stat.putusMqtt++;
+        kejadian |= KONEKSI_WIFI_TURUN | KONEKSI_MQTT_TURUN;
+        mulaiPutus = now;
+        wifiTurun(now);
+      } else if (!mqtt->connected()) {
+        // Putus sesaat (broker restart, keepalive): percobaan pertama cepat tapi berjitter
+        stat.putusMqtt++;
+        kejadian |= KONEKSI_MQTT_TURUN;
+        mulaiPutus = now;
+        levelMqtt = 0;
+        tungguSampai = now + backoff(levelMqtt);
+        f = KONEKSI_MQTT_TUNGGU;
+      }
+      break;
+  }
+  return kejadian;
+}
+
+const char *ManajerKoneksi::ssidAktif() const {
+  return (f >= KONEKSI_MQTT_TUNGGU && indeks >= 0) ? p.jaringan[indeks].ssid : "";
+}
+
+size_t serializeStatusKoneksi(const ManajerKoneksi &k, int32_t rssi, char *buf, size_t len) {
+  static const char *const NAMA_FASE[] = {"wifi_mulai", "wifi_asosiasi", "wifi_tunggu", "mqtt_tunggu", "terhubung"};
+  const StatistikKoneksi &s = k.stat;
+  int n = snprintf(buf, len,
+    "{\"fase\":\"%s\",\"ssid\":\"%s\",\"rssi\":%ld,\"sambung_wifi\":%lu,\"putus_wifi\":%lu,\"gagal_wifi\":%lu,"
+    "\"sambung_mqtt\":%lu,\"putus_mqtt\":%lu,\"gagal_mqtt\":%lu,\"cache_kena\":%lu,\"cache_meleset\":%lu,"
+    "\"ms_boot_terhubung\":%lu,\"ms_sambung_terakhir\":%lu,\"ms_sambung_maks\":%lu,\"ms_wifi_terakhir\":%lu,"
+    "\"backoff_ms\":%lu}",
+    NAMA_FASE[k.fase()], k.ssidAktif(), (long)rssi, (unsigned long)s.sambungWifi, (unsigned long)s.putusWifi,
+    (unsigned long)s.gagalWifi, (unsigned long)s.sambungMqtt, (unsigned long)s.putusMqtt, (unsigned long)s.gagalMqtt,
+    (unsigned long)s.cacheKena, (unsigned long)s.cacheMeleset, (unsigned long)s.msBootTerhubung,
+    (unsigned long)s.msSambungTerakhir, (unsigned long)s.msSambungMaks, (unsigned long)s.msWifiTerakhir,
+    (unsigned long)k.backoffMs());
+  return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
@@ -0,0 +1,136 @@
+/**
+ * MANAJER KONEKSI WIFI & MQTT (NON-BLOCKING)
+ * * Deskripsi:
+ * State machine yang dipanggil tiap tick task jaringan; tidak pernah
+ * menunggu asosiasi, DHCP, atau broker.
+ * - WiFi: AP terakhir yang berhasil (SSID + BSSID + kanal) disimpan di
+ *   flash; saat boot / putus dicoba duluan dengan BSSID & kanal itu (tanpa
+ *   scan semua kanal). Gagal -> daftar jaringan dicoba berurutan.
+ * - Semua jaringan gagal / broker menolak: tunggu backoff eksponensial
+ *   dengan jitter (setengah tetap + setengah acak), jadi banyak perangkat
+ *   yang putus bersamaan tidak menyerbu broker di detik yang sama.
+ *   Tidak ada lagi ESP.restart(): kontrol tetap jalan offline.
+ * - IP statis opsional (melewati DHCP).
+ * - Satu-satunya panggilan yang bisa menahan task adalah CONNECT MQTT
+ *   (PubSubClient), dibatasi timeout socket dan hanya sekali per backoff.
+ * - Statistik: waktu sampai terhubung (boot & tiap putus), jumlah
+ *   sambung/putus/gagal, cache kena/meleset -> MQTT_TOPIC_KONEKSI.
+ */
+
+#ifndef AQUARIUM_MANAJER_KONEKSI_H
+#define AQUARIUM_MANAJER_KONEKSI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Hal.h"
+
+#ifndef KONEKSI_BATAS_ASOSIASI_MS
+#define KONEKSI_BATAS_ASOSIASI_MS 10000   // per jaringan (lama: 20 x 500 ms)
+#endif
+#ifndef KONEKSI_BATAS_CEPAT_MS
+#define KONEKSI_BATAS_CEPAT_MS 3000       // asosiasi pakai BSSID/kanal cache
+#endif
+#ifndef KONEKSI_BACKOFF_AWAL_MS
+#define KONEKSI_BACKOFF_AWAL_MS 500
+#endif
+#ifndef KONEKSI_BACKOFF_MAKS_MS
+#define KONEKSI_BACKOFF_MAKS_MS 60000
+#endif
+
+struct JaringanWifi {
+  const char *ssid;
+  const char *password;
+};
+
+struct PengaturanKoneksi {
+  const JaringanWifi *jaringan;
+  uint8_t jumlahJaringan;
+  const char *clientId;
+  IpStatis ip = {};
+  uint32_t batasAsosiasiMs = KONEKSI_BATAS_ASOSIASI_MS;
+  uint32_t batasCepatMs = KONEKSI_BATAS_CEPAT_MS;
+  uint32_t backoffAwalMs = KONEKSI_BACKOFF_AWAL_MS;
+  uint32_t backoffMaksMs = KONEKSI_BACKOFF_MAKS_MS;
+};
+
+enum FaseKoneksi : uint8_t {
+  KONEKSI_WIFI_MULAI = 0,
+  KONEKSI_WIFI_ASOSIASI,
+  KONEKSI_WIFI_TUNGGU,   // backoff: semua jaringan gagal
+  KONEKSI_MQTT_TUNGGU,   // WiFi terhubung, backoff sebelum CONNECT berikutnya
+  KONEKSI_TERHUBUNG,
+};
+
+// Kejadian hasil layani() (bit)
+enum : uint8_t {
+  KONEKSI_WIFI_NAIK = 1 << 0,
+  KONEKSI_WIFI_TURUN = 1 << 1,
+  KONEKSI_MQTT_NAIK = 1 << 2,   // pemanggil subscribe ulang di sini
+  KONEKSI_MQTT_TURUN = 1 << 3,
+};
+
+struct StatistikKoneksi {
+  uint32_t sambungWifi = 0, putusWifi = 0, gagalWifi = 0;
+  uint32_t sambungMqtt = 0, putusMqtt = 0, gagalMqtt = 0;
+  uint32_t cacheKena = 0, cacheMeleset = 0;
+  uint32_t msBootTerhubung = 0;      // boot -> MQTT terhubung pertama (0 = belum)
+  uint32_t msSambungTerakhir = 0;    // putus -> MQTT terhubung lagi
+  uint32_t msSambungMaks = 0;
+  uint32_t msWifiTerakhir = 0;       // asosiasi (+DHCP) terakhir
+};
+
+// AP terakhir yang berhasil (berkas PATH_CACHE_WIFI)
+struct CacheWifi {
+  uint8_t versi;
+  uint8_t indeks;      // di PengaturanKoneksi::jaringan
+  uint8_t bssid[6];
+  int32_t kanal;
+  char ssid[33];       // indeks hanya dipakai jika SSID masih sama
+};
+
+class ManajerKoneksi {
+public:
+  // berkas boleh nullptr (tanpa cache). seed: sumber acak jitter (mis. esp_random()).
+  void mulai(HalClock &clock, HalWifi &wifi, HalMqtt &mqtt, HalBerkas *berkas,
+             const PengaturanKoneksi &p, uint32_t seed);
+  // Panggil sesering mungkin (tiap tick task jaringan); return KONEKSI_* yang terjadi
+  uint8_t layani();
+
+  FaseKoneksi fase() const { return f; }
+  bool mqttTerhubung() const { return f == KONEKSI_TERHUBUNG; }
+  const char *ssidAktif() const;        // "" jika belum terhubung
+  uint32_t backoffMs() const { return backoffTerakhir; }
+
+  StatistikKoneksi stat;
+
+private:
+  void mulaiAsosiasi(unsigned long now);
+  void asosiasiGagal(unsigned long now);
+  void wifiTurun(unsigned long now);
+  void simpanCache();
+  uint32_t backoff(uint8_t &level);
+  uint32_t acak();
+
+  HalClock *clock = nullptr;
+  HalWifi *wifi = nullptr;
+  HalMqtt *mqtt = nullptr;
+  HalBerkas *berkas = nullptr;
+  PengaturanKoneksi p = {};
+
+  CacheWifi cache = {};
+  bool adaCache = false, cobaCache = false;
+  FaseKoneksi f = KONEKSI_WIFI_MULAI;
+  int indeks = -1;                  // jaringan yang sedang dicoba / aktif
+  uint8_t dicoba = 0;               // jaringan yang sudah dicoba di putaran ini
+  uint8_t levelWifi = 0, levelMqtt = 0;
+  unsigned long mulaiFase = 0, tungguSampai = 0, mulaiPutus = 0;
+  bool pernahTerhubung = false;
+  uint32_t backoffTerakhir = 0;
+  uint32_t keadaanAcak = 1;
+};
+
+// {"fase":"terhubung","ssid":"..","rssi":..,"sambung_wifi":..,"ms_boot_terhubung":..,...}
+// Return panjang, 0 jika buf kurang
+size_t serializeStatusKoneksi(const ManajerKoneksi &k, int32_t rssi, char *buf, size_t len);
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * MEDIAN JENDELA GESER (STREAMING)
+ * * Deskripsi:
+ * Median dari n sampel terakhir, O(log n) per sampel, O(1) per query.
+ * - Dua heap berindeks: "bawah" (max-heap, floor(n/2)+1 sampel terkecil)
+ *   dan "atas" (min-heap, sisanya). Median = puncak heap bawah
+ *   (untuk n genap = median atas, sama dengan buffer[n/2] setelah sort).
+ * - Sampel baru menempati slot sampel tertua (ring buffer) di heap yang
+ *   sama, lalu di-sift; paling banyak satu pertukaran puncak antar heap.
+ * - Kapasitas W tetap (tanpa heap/alokasi), panjang jendela n <= W runtime.
+ */
+
+#ifndef AQUARIUM_MEDIAN_GESER_H
+#define AQUARIUM_MEDIAN_GESER_H
+
+#include <stdint.h>
+
+template <int W>
+class MedianGeser {
+  static_assert(W >= 1 && W <= 127, "kapasitas jendela 1..127");
+
+public:
+  MedianGeser() { reset(W); }
+
+  void reset(int panjangBaru) {
+    panjang = (panjangBaru < 1) ? 1 : ((panjangBaru > W) ? W : panjangBaru);
+    jumlah = 0; kepala = 0; nBawah = 0; nAtas = 0;
+  }
+
+  int panjangJendela() const { return panjang; }
+  bool penuh() const { return jumlah == panjang; }
+  int16_t median() const { return (nBawah > 0) ? nilai[bawah[0]] : 0; }
+
+  void tambah(int16_t v) {
+    int slot = kepala;
+    kepala = (kepala + 1 == panjang) ? 0 : kepala + 1;
+    nilai[slot] = v;
+
+    if (jumlah < panjang) {
+      jumlah++;
+      sisipkan(slot);
+      return;
+    }
+
+    // Jendela penuh: nilai slot lama diganti di tempat
+    int p = posisi[slot];
+    if (p >= 0) {
+      perbaikiBawah(p);
+    } else {
+      perbaikiAtas(-p - 1);
+    }
+    tukarPuncakJikaPerlu();
+  }
+
+private:
+  int16_t nilai[W];
+  uint8_t bawah[W];  // max-heap berisi nomor slot
+  uint8_t atas[W];   // min-heap berisi nomor slot
+  int8_t posisi[W];  // >= 0: index di bawah, < 0: -(index di atas) - 1
+  int panjang, jumlah, kepala, nBawah, nAtas;
+
+  // Ukuran heap bawah yang diinginkan untuk jumlah sampel saat ini
+  int targetBawah() const { return jumlah / 2 + 1; }
+
+  void sisipkan(int slot) {
+    if (nBawah == 0 || nilai[slot] <= nilai[bawah[0]]) {
+      taruhBawah(nBawah++, slot); naikBawah(nBawah - 1);
+    } else {
+      taruhAtas(nAtas++, slot); naikAtas(nAtas - 1);
+    }
+    // Seimbangkan ukuran kedua heap
+    if (nBawah > targetBawah()) {
+      int s = cabutBawah();
+      taruhAtas(nAtas++, s); naikAtas(nAtas - 1);
+    } else if (nBawah < targetBawah() && nAtas > 0) {
+      int s = cabutAtas();
+      taruhBawah(nBawah++, s); naikBawah(nBawah - 1);
+    }
+  }
+
+  void tukarPuncakJikaPerlu() {
+    if (nAtas == 0 || nilai[bawah[0]] <= nilai[atas[0]]) return;
+    int sb = bawah[0], sa = atas[0];
+    taruhBawah(0, sa); turunBawah(0);
+    taruhAtas(0, sb); turunAtas(0);
+  }
+
+  void taruhBawah(int i, int slot) { bawah[i] = (uint8_t)slot; posisi[slot] = (int8_t)i; }
+  void taruhAtas(int i, int slot) { atas[i] = (uint8_t)slot; posisi[slot] = (int8_t)(-i - 1); }
+
+  int cabutBawah() {
+    int s = bawah[0];
+    taruhBawah(0, bawah[--nBawah]);
+    if (nBawah > 0) turunBawah(0);
+    return s;
+  }
+  int cabutAtas() {
+    int s = atas[0];
+    taruhAtas(0, atas[--nAtas]);
+    if (nAtas > 0) turunAtas(0);
+    return s;
+  }
+
+  void perbaikiBawah(int i) { if (!naikBawah(i)) turunBawah(i); }
+  void perbaikiAtas(int i) { if (!naikAtas(i)) turunAtas(i); }
+
+  // --- max-heap bawah ---
+  bool naikBawah(int i) {
+    bool pindah = false;
+    while (i > 0) {
+      int induk = (i - 1) / 2;
+      if (nilai[bawah[induk]] >= nilai[bawah[i]]) break;
+      int s = bawah[i]; taruhBawah(i, bawah[induk]); taruhBawah(induk, s);
+      i = induk; pindah = true;
+    }
+    return pindah;
+  }
+  void turunBawah(int i) {
+    for (;;) {
+      int anak = 2 * i + 1;
+      if (anak >= nBawah) break;
+      if (anak + 1 < nBawah && nilai[bawah[anak + 1]] > nilai[bawah[anak]]) anak++;
+      if (nilai[bawah[i]] >= nilai[bawah[anak]]) break;
+      int s = bawah[i]; taruhBawah(i, bawah[anak]); taruhBawah(anak, s);
+      i = anak;
+    }
+  }
+
+  // --- min-heap atas ---
+  bool naikAtas(int i) {
+    bool pindah = false;
+    while (i > 0) {
+      int induk = (i - 1) / 2;
+      if (nilai[atas[induk]] <= nilai[atas[i]]) break;
+      int s = atas[i]; taruhAtas(i, atas[induk]); taruhAtas(induk, s);
+      i = induk; pindah = true;
+    }
+    return pindah;
+  }
+  void turunAtas(int i) {
+    for (;;) {
+      int anak = 2 * i + 1;
+      if (anak >= nAtas) break;
+      if (anak + 1 < nAtas && nilai[atas[anak + 1]] < nilai[atas[anak]]) anak++;
+      if (nilai[atas[i]] <= nilai[atas[anak]]) break;
+      int s = atas[i]; taruhAtas(i, atas[anak]); taruhAtas(anak, s);
+      i = anak;
+    }
+  }
+};
+
+#endif
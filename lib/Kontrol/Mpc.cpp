@@ -0,0 +1,69 @@
+#include "Mpc.h"
+
+// NaN ikut ke lo: (int)NaN dan indeks sel dari NaN tidak terdefinisi
+static inline float jepit(float x, float lo, float hi) {
+  return !(x >= lo) ? lo : (x > hi ? hi : x);
+}
+
+float evaluasiTabelMpc(const TabelMpc &t, float e, float h) {
+  e = jepit(e, t.eMin, t.eMax);
+  h = jepit(h, t.hMin, t.hMax);
+  int i = (int)((e - t.eMin) * t.skalaE);
+  int j = (int)((h - t.hMin) * t.skalaH);
+  if (i >= t.selE) i = t.selE - 1;
+  if (j >= t.selH) j = t.selH - 1;
+
+  const uint16_t s = t.sel[j * t.selE + i];
+  uint8_t hk;
+  if (s & SEL_MPC_LANGSUNG) {
+    hk = (uint8_t)(s & ~SEL_MPC_LANGSUNG);
+  } else {
+    // Wilayah hukum non-default diuji; wilayah sel saling lepas, jadi tidak ada yang cocok = default
+    const uint8_t *k = t.kandidat + s;
+    const uint8_t n = *k++;
+    hk = k[n];
+    for (uint8_t c = 0; c < n; c++) {
+      const WilayahMpc &w = t.wilayah[k[c]];
+      const BidangMpc *b = t.bidang + w.awalBidang;
+      uint8_t m = 0;
+      while (m < w.jumlahBidang && b[m].ae * e + b[m].ah * h <= b[m].b) m++;
+      if (m == w.jumlahBidang) {
+        hk = w.hukum;
+        break;
+      }
+    }
+  }
+  const HukumMpc &l = t.hukum[hk];
+  return jepit(l.ke * e + l.kh * h + l.c, 0.0f, 100.0f);
+}
+
+float hitungMpcSuhu(StateMpc &st, const TabelMpc &t, float suhu, float setpoint, unsigned long now) {
+  if (!st.siap) {
+    // Awal: air = probe = pembacaan, ruang belum diketahui -> dianggap sama (tanpa rugi)
+    st.suhuAir = st.suhuUkur = st.suhuRuang = suhu;
+    st.outTerakhir = 0.0f;
+    st.siap = true;
+  } else {
+    float dt = (float)(now - st.lastTime) / 1000.0f;
+    if (dt > 10.0f) dt = 10.0f;   // jeda panjang (mis. kontrol dijeda): jangan lompat jauh
+    // Prediksi dengan output heater tick sebelumnya (Euler, dt << konstanta waktu)
+    const float air = st.suhuAir + t.alfaAir * dt * (st.suhuRuang + t.gainSuhu * st.outTerakhir - st.suhuAir);
+    const float ukur = st.suhuUkur + t.alfaUkur * dt * (st.suhuAir - st.suhuUkur);
+    const float inovasi = suhu - ukur;
+    st.suhuAir = air + t.kalman[0] * inovasi;
+    st.suhuUkur = ukur + t.kalman[1] * inovasi;
+    st.suhuRuang += t.kalman[2] * inovasi;
+  }
+  st.lastTime = now;
+
+  const float e = setpoint - st.suhuAir;
+  const float h = (setpoint - st.suhuRuang) / t.gainSuhu;
+  st.outTerakhir = evaluasiTabelMpc(t, e, h);
+  return st.outTerakhir;
+}
+
+size_t ukuranTabelMpc(const TabelMpc &t) {
+  return sizeof(TabelMpc) + (size_t)t.selE * t.selH * sizeof(uint16_t) + t.jumlahKandidat +
+         t.jumlahWilayah * sizeof(WilayahMpc) + t.jumlahBidang * sizeof(BidangMpc) +
+         t.jumlahHukum * sizeof(HukumMpc);
+}
@@ -0,0 +1,92 @@
+/**
+ * MPC EKSPLISIT LOOP SUHU (TABEL WILAYAH)
+ * * Deskripsi:
+ * Mode kontrol ketiga (ControlMode MPC) untuk loop heater. Masalah QP MPC
+ * diselesaikan offline secara multiparametrik (tools/mpc, generator di
+ * lib/Simulasi/MpcEksplisit.h): ruang parameter dibagi menjadi wilayah
+ * poligon, tiap wilayah punya hukum affine output pertama. Firmware hanya
+ * melakukan point location + satu hukum affine, tanpa solver.
+ * - Parameter QP: e = setpoint - suhu air (estimasi), h = output heater (%)
+ *   yang menahan suhu tepat di setpoint (dari estimasi suhu ruang), jadi
+ *   solusi bebas offset walau rugi panas berubah.
+ * - Observer Kalman tetap (gain dari generator): state suhu air, ujung probe
+ *   (lag probe + filter EMA) dan suhu ruang; diprediksi dengan output heater
+ *   sebelumnya, dikoreksi dengan suhu terfilter tiap tick.
+ * - Point location waktu terbatas: grid seragam di atas kotak (e, h); sel
+ *   yang hanya disentuh satu hukum langsung menunjuk hukum itu, sisanya
+ *   menyimpan daftar wilayah kandidat + hukum default. Uji terburuk =
+ *   maksBidang perbandingan (dicatat di tabel).
+ * - Di luar kotak e di-clamp (generator memastikan output di tepi kotak
+ *   sudah jenuh 0 / 100%).
+ */
+
+#ifndef AQUARIUM_MPC_H
+#define AQUARIUM_MPC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// u = ke * e + kh * h + c (lalu di-clamp 0-100%)
+struct HukumMpc {
+  float ke, kh, c;
+};
+
+// Setengah bidang ae * e + ah * h <= b
+struct BidangMpc {
+  float ae, ah, b;
+};
+
+struct WilayahMpc {
+  uint16_t awalBidang;
+  uint8_t jumlahBidang;
+  uint8_t hukum;
+};
+
+// sel[i] dengan bit ini = index hukum langsung; tanpa bit = offset di kandidat[]
+const uint16_t SEL_MPC_LANGSUNG = 0x8000;
+
+struct TabelMpc {
+  // --- Model & observer (per detik) ---
+  float alfaAir;       // UA / C (1/s)
+  float gainSuhu;      // kenaikan suhu tunak per % heater (C/%)
+  float alfaUkur;      // 1 / (lag probe + EMA) (1/s)
+  float kalman[3];     // gain inovasi -> [air, ujung probe, ruang], dirancang untuk 1 s
+
+  // --- Point location ---
+  float eMin, eMax, hMin, hMax;
+  float skalaE, skalaH;     // sel per satuan
+  uint8_t selE, selH;
+  uint8_t maksKandidat;     // wilayah diuji per sel (terburuk)
+  uint8_t maksBidang;       // perbandingan bidang per sel (terburuk)
+  const uint16_t *sel;      // selE * selH, baris = h
+  const uint8_t *kandidat;  // per sel: n, n index wilayah, hukum default
+  const WilayahMpc *wilayah;
+  const BidangMpc *bidang;
+  const HukumMpc *hukum;
+  uint16_t jumlahWilayah, jumlahBidang, jumlahHukum, jumlahKandidat;
+
+  // --- Asal tabel (informasi) ---
+  uint8_t horizon;
+  float tsDetik;
+};
+
+struct StateMpc {
+  float suhuAir = 0.0f, suhuUkur = 0.0f, suhuRuang = 0.0f;
+  float outTerakhir = 0.0f;
+  unsigned long lastTime = 0;
+  bool siap = false;
+};
+
+// Tabel bawaan firmware (lib/Kontrol/TabelMpc.cpp, dihasilkan tools/mpc)
+extern const TabelMpc TABEL_MPC;
+
+// Output pertama MPC (0-100%) untuk parameter (e, h)
+float evaluasiTabelMpc(const TabelMpc &t, float e, float h);
+
+// Observer + tabel: suhu = pembacaan terfilter (C). Output 0-100%.
+float hitungMpcSuhu(StateMpc &st, const TabelMpc &t, float suhu, float setpoint, unsigned long now);
+
+// Byte tabel (struct + semua array)
+size_t ukuranTabelMpc(const TabelMpc &t);
+
+#endif
@@ -0,0 +1,39 @@
+#include "Penjadwal.h"
+#include <stdio.h>
+
+static_assert(JITTER_N_BIN == 8, "format hist di serializeStatistikLoop");
+
+void StatistikLoop::reset() {
+  jumlahJalan = 0; overrun = 0; rilisTerlewat = 0;
+  jitterMinUs = INT32_MAX; jitterMaxUs = INT32_MIN;
+  durasiMaksUs = 0;
+  for (int b = 0; b < JITTER_N_BIN; b++) histogram[b] = 0;
+}
+
+void StatistikLoop::catatJitter(int32_t jitterUs) {
+  if (jitterUs < jitterMinUs) jitterMinUs = jitterUs;
+  if (jitterUs > jitterMaxUs) jitterMaxUs = jitterUs;
+  uint32_t a = (jitterUs < 0) ? (uint32_t)(-(int64_t)jitterUs) : (uint32_t)jitterUs;
+  int b = 0;
+  while (b < JITTER_N_BIN - 1 && a > JITTER_BATAS_BIN_US[b]) b++;
+  histogram[b]++;
+}
+
+size_t serializeStatistikLoop(const StatistikLoop &s, const char *penjadwal, uint32_t jendelaUs,
+                              char *buf, size_t len) {
+  // Belum ada dua eksekusi di jendela ini -> jitter belum terdefinisi
+  bool adaJitter = s.jitterMinUs <= s.jitterMaxUs;
+  int n = snprintf(buf, len,
+    "{\"penjadwal\":\"%s\",\"loop\":\"%s\",\"periode_us\":%lu,\"jendela_ms\":%lu,\"jalan\":%lu,"
+    "\"overrun\":%lu,\"rilis_terlewat\":%lu,\"jitter_min_us\":%ld,\"jitter_max_us\":%ld,"
+    "\"durasi_maks_us\":%lu,\"hist\":[%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu]}",
+    penjadwal, s.nama, (unsigned long)s.periodeUs, (unsigned long)(jendelaUs / 1000),
+    (unsigned long)s.jumlahJalan, (unsigned long)s.overrun, (unsigned long)s.rilisTerlewat,
+    adaJitter ? (long)s.jitterMinUs : 0L, adaJitter ? (long)s.jitterMaxUs : 0L,
+    (unsigned long)s.durasiMaksUs,
+    (unsigned long)s.histogram[0], (unsigned long)s.histogram[1], (unsigned long)s.histogram[2],
+    (unsigned long)s.histogram[3], (unsigned long)s.histogram[4], (unsigned long)s.histogram[5],
+    (unsigned long)s.histogram[6], (unsigned long)s.histogram[7]);
+  if (n < 0 || (size_t)n >= len) return 0;
+  return (size_t)n;
+}
@@ -0,0 +1,150 @@
+/**
+ * PENJADWAL LOOP MULTI-RATE (DETERMINISTIK)
+ * * Deskripsi:
+ * Tiap loop (sampling, suhu, keruh, telemetri, WiFi, ...) mendaftar dengan
+ * periode & fasa sendiri. Penjadwal dipanggil tiap tick timer dasar dan
+ * menjalankan loop yang jatuh tempo, urut sesuai pendaftaran.
+ * - Waktu rilis absolut: rilis_k = mulai + fasa + k * periode, jadi loop
+ *   yang telat sekali tidak menggeser jadwal berikutnya (tanpa drift).
+ * - Telat >= 1 periode: rilis yang terlewat dilompati & dihitung.
+ * - Statistik per loop: jitter periode (periode aktual - nominal) min/max
+ *   + histogram |jitter|, overrun (rilis terlewat / durasi > periode),
+ *   durasi eksekusi maksimum. Direset per jendela laporan.
+ * - Waktu dalam mikrodetik 32-bit (micros() ESP32), aman terhadap overflow.
+ */
+
+#ifndef AQUARIUM_PENJADWAL_H
+#define AQUARIUM_PENJADWAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Hal.h"
+
+// Batas atas bin histogram |jitter| (us); bin terakhir = di atas batas terakhir
+const int JITTER_N_BIN = 8;
+const uint32_t JITTER_BATAS_BIN_US[JITTER_N_BIN - 1] = {10, 50, 100, 500, 1000, 5000, 10000};
+
+typedef void (*FungsiLoop)();
+
+struct StatistikLoop {
+  const char *nama;        // literal string, aman disalin antar core
+  uint32_t periodeUs;
+  uint32_t jumlahJalan;
+  uint32_t overrun;
+  uint32_t rilisTerlewat;
+  int32_t jitterMinUs, jitterMaxUs;
+  uint32_t durasiMaksUs;
+  uint32_t histogram[JITTER_N_BIN];
+
+  void reset();
+  void catatJitter(int32_t jitterUs);
+};
+
+// Salinan statistik semua loop satu penjadwal (untuk dikirim antar core)
+template <int N>
+struct LaporanJadwal {
+  int jumlah;
+  uint32_t jendelaUs;      // lama pengumpulan statistik ini
+  StatistikLoop loop[N];
+};
+
+template <int N>
+class Penjadwal {
+public:
+  // Return indeks loop, -1 jika penuh / periode 0
+  int tambah(const char *nama, uint32_t periodeUs, uint32_t fasaUs, FungsiLoop fungsi) {
+    if (jumlah >= N || periodeUs == 0) return -1;
+    Entri &e = entri[jumlah];
+    e.fungsi = fungsi;
+    e.fasaUs = fasaUs;
+    e.stat.nama = nama;
+    e.stat.periodeUs = periodeUs;
+    e.stat.reset();
+    return jumlah++;
+  }
+
+  void mulai(uint32_t nowUs) {
+    for (int i = 0; i < jumlah; i++) {
+      entri[i].rilisUs = nowUs + entri[i].fasaUs;
+      entri[i].pernahJalan = false;
+    }
+    awalJendelaUs = nowUs;
+  }
+
+  // Jalankan loop yang jatuh tempo; return jumlah loop yang dijalankan
+  int jalankan(HalClock &jam) {
+    int n = 0;
+    for (int i = 0; i < jumlah; i++) {
+      Entri &e = entri[i];
+      StatistikLoop &s = e.stat;
+      uint32_t now = (uint32_t)jam.micros();
+      if ((int32_t)(now - e.rilisUs) < 0) continue;
+
+      uint32_t telat = now - e.rilisUs;
+      if (telat >= s.periodeUs) {
+        uint32_t lewat = telat / s.periodeUs;
+        s.rilisTerlewat += lewat;
+        s.overrun++;
+        e.rilisUs += lewat * s.periodeUs;
+      }
+      e.rilisUs += s.periodeUs;
+
+      if (e.pernahJalan) s.catatJitter((int32_t)(now - e.mulaiTerakhirUs - s.periodeUs));
+      e.mulaiTerakhirUs = now;
+      e.pernahJalan = true;
+
+      e.fungsi();
+
+      uint32_t durasi = (uint32_t)jam.micros() - now;
+      if (durasi > s.durasiMaksUs) s.durasiMaksUs = durasi;
+      if (durasi > s.periodeUs) s.overrun++;
+      s.jumlahJalan++;
+      n++;
+    }
+    return n;
+  }
+
+  // Sisa waktu ke rilis terdekat (0 jika ada yang sudah jatuh tempo)
+  uint32_t sisaUs(uint32_t nowUs) const {
+    uint32_t terdekat = UINT32_MAX;
+    for (int i = 0; i < jumlah; i++) {
+      int32_t d = (int32_t)(entri[i].rilisUs - nowUs);
+      if (d <= 0) return 0;
+      if ((uint32_t)d < terdekat) terdekat = (uint32_t)d;
+    }
+    return terdekat;
+  }
+
+  // Salin statistik lalu mulai jendela baru
+  void ambilLaporan(LaporanJadwal<N> &out, uint32_t nowUs) {
+    out.jumlah = jumlah;
+    out.jendelaUs = nowUs - awalJendelaUs;
+    for (int i = 0; i < jumlah; i++) {
+      out.loop[i] = entri[i].stat;
+      entri[i].stat.reset();
+    }
+    awalJendelaUs = nowUs;
+  }
+
+  int jumlahLoop() const { return jumlah; }
+  const StatistikLoop &statistik(int i) const { return entri[i].stat; }
+
+private:
+  struct Entri {
+    FungsiLoop fungsi;
+    uint32_t fasaUs;
+    uint32_t rilisUs;
+    uint32_t mulaiTerakhirUs;
+    bool pernahJalan;
+    StatistikLoop stat;
+  };
+  Entri entri[N];
+  int jumlah = 0;
+  uint32_t awalJendelaUs = 0;
+};
+
+// JSON satu loop, return panjang (0 jika buf kurang)
+size_t serializeStatistikLoop(const StatistikLoop &s, const char *penjadwal, uint32_t jendelaUs,
+                              char *buf, size_t len);
+
+#endif
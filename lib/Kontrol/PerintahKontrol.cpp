@@ -0,0 +1,541 @@
+#include "PerintahKontrol.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "TelemetriBiner.h"
+
+// =========================================================================
+//                  PEMBACA JSON (KURSOR DI ATAS PAYLOAD)
+// =========================================================================
+
+namespace {
+
+double skala10(double m, int e) {
+  static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  while (e > 22) { m *= 1e22; e -= 22; }
+  while (e < -22) { m /= 1e22; e += 22; }
+  return (e >= 0) ? m * POW10[e] : m / POW10[-e];
+}
+
+bool angka(char c) { return c >= '0' && c <= '9'; }
+
+// Semua pembacaan berhenti di `akhir`; false = JSON rusak
+struct PembacaJson {
+  const char *p, *akhir;
+
+  void spasi() {
+    while (p < akhir && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+  }
+  char intip() {
+    spasi();
+    return (p < akhir) ? *p : '\0';
+  }
+  bool ambil(char c) {
+    if (intip() != c) return false;
+    p++;
+    return true;
+  }
+  bool literal(const char *kata) {
+    spasi();
+    size_t n = strlen(kata);
+    if ((size_t)(akhir - p) < n || memcmp(p, kata, n) != 0) return false;
+    p += n;
+    return true;
+  }
+
+  // Isi string mentah (escape tidak didekode, cukup untuk kunci & nama mode)
+  bool string(const char *&s, size_t &n) {
+    if (!ambil('"')) return false;
+    s = p;
+    while (p < akhir && *p != '"') p += (*p == '\\') ? 2 : 1;
+    if (p >= akhir) return false;
+    n = (size_t)(p - s);
+    p++;
+    return true;
+  }
+
+  // Grammar angka JSON: -?digit+(.digit+)?([eE][+-]?digit+)?
+  bool bilangan(double &x) {
+    spasi();
+    const char *q = p;
+    bool negatif = (q < akhir && *q == '-');
+    if (negatif) q++;
+    if (q >= akhir || !angka(*q)) return false;
+
+    double m = 0.0;
+    int eks = 0;
+    while (q < akhir && angka(*q)) m = m * 10.0 + (*q++ - '0');
+    if (q < akhir && *q == '.') {
+      q++;
+      if (q >= akhir || !angka(*q)) return false;
+      while (q < akhir && angka(*q)) { m = m * 10.0 + (*q++ - '0'); eks--; }
+    }
+    if (q < akhir && (*q == 'e' || *q == 'E')) {
+      q++;
+      bool eNegatif = false;
+      if (q < akhir && (*q == '+' || *q == '-')) eNegatif = (*q++ == '-');
+      if (q >= akhir || !angka(*q)) return false;
+      int e = 0;
+      while (q < akhir && angka(*q)) { if (e < 10000) e = e * 10 + (*q - '0'); q++; }
+      eks += eNegatif ? -e : e;
+    }
+    x = skala10(m, eks);
+    if (negatif) x = -x;
+    p = q;
+    return true;
+  }
+
+  bool lewati(int kedalaman) {
+    char c = intip();
+    if (c == '"') {
+      const char *s;
+      size_t n;
+      return string(s, n);
+    }
+    if (c == '{' || c == '[') {
+      if (kedalaman >= PERINTAH_KEDALAMAN_MAKS) return false;
+      const char tutup = (c == '{') ? '}' : ']';
+      p++;
+      if (ambil(tutup)) return true;
+      do {
+        if (c == '{') {
+          const char *s;
+          size_t n;
+          if (!string(s, n) || !ambil(':')) return false;
+        }
+        if (!lewati(kedalaman + 1)) return false;
+      } while (ambil(','));
+      return ambil(tutup);
+    }
+    if (c == 't') return literal("true");
+    if (c == 'f') return literal("false");
+    if (c == 'n') return literal("null");
+    double x;
+    return bilangan(x);
+  }
+};
+
+bool sama(const char *s, size_t n, const char *kunci) {
+  return strlen(kunci) == n && memcmp(s, kunci, n) == 0;
+}
+
+// Salin kunci untuk laporan; karakter yang merusak JSON status diganti '?'
+void salinKunci(char (&tujuan)[24], const char *s, size_t n) {
+  if (n > sizeof(tujuan) - 1) n = sizeof(tujuan) - 1;
+  for (size_t i = 0; i < n; i++) {
+    char c = s[i];
+    tujuan[i] = (c == '"' || c == '\\' || (unsigned char)c < 0x20) ? '?' : c;
+  }
+  tujuan[n] = '\0';
+}
+
+// =========================================================================
+//                  TABEL KUNCI
+// =========================================================================
+
+struct KunciFloat {
+  const char *kunci;
+  float ParameterKontrol::*field;
+  float lo, hi;
+  uint16_t grup;
+};
+
+// Gain PID hasil autotune (sampai AUTOTUNE_GAIN_MAKS) digemakan dokumen Control,
+// jadi kp/ki/kd dibatasi yang terbesar dari kedua batas.
+const float GAIN_MAKS = PERINTAH_GAIN_MAKS > AUTOTUNE_GAIN_MAKS ? PERINTAH_GAIN_MAKS : AUTOTUNE_GAIN_MAKS;
+
+const KunciFloat KUNCI_FLOAT[] = {
+  {"suhu_setpoint", &ParameterKontrol::suhuSetpoint, PERINTAH_SUHU_MIN, PERINTAH_SUHU_MAKS, PERINTAH_SETPOINT},
+  {"keruh_setpoint", &ParameterKontrol::turbiditySetpoint, 0.0f, 100.0f, PERINTAH_SETPOINT},
+  {"kp_suhu", &ParameterKontrol::Kp_suhu, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"ki_suhu", &ParameterKontrol::Ki_suhu, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"kd_suhu", &ParameterKontrol::Kd_suhu, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"kp_keruh", &ParameterKontrol::Kp_keruh, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"ki_keruh", &ParameterKontrol::Ki_keruh, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"kd_keruh", &ParameterKontrol::Kd_keruh, 0.0f, GAIN_MAKS, PERINTAH_TUNING},
+  {"kp_turbo_keruh", &ParameterKontrol::Kp_keruh_turbo, 0.0f, PERINTAH_GAIN_MAKS, PERINTAH_TUNING},
+  {"ambang_turbo_keruh", &ParameterKontrol::ambangTurboKeruh, 0.0f, 100.0f, PERINTAH_TUNING},
+  {"keruh_tahan", &ParameterKontrol::keruhTahan, 0.0f, 100.0f, PERINTAH_TUNING},
+  {"keruh_mati", &ParameterKontrol::keruhMati, 0.0f, 100.0f, PERINTAH_TUNING},
+  {"tau_transfer", &ParameterKontrol::tauTransfer, 0.1f, 3600.0f, PERINTAH_BAYANGAN},
+};
+
+const char *const ALASAN_JSON = "JSON rusak";
+const char *const ALASAN_TIPE = "tipe salah / null";
+const char *const ALASAN_RENTANG = "di luar rentang";
+
+struct Parser {
+  PembacaJson r;
+  HasilPerintah h;
+
+  bool tolak(const char *kunci, size_t n, const char *alasan) {
+    h.ok = false;
+    salinKunci(h.kunci, kunci, n);
+    h.alasan = alasan;
+    return false;
+  }
+
+  // Angka berhingga dalam [lo, hi]; null (NaN dari JSON.stringify) ditolak
+  bool bacaFloat(const char *k, size_t n, float &x, float lo, float hi) {
+    double d;
+    if (!r.bilangan(d)) return tolak(k, n, ALASAN_TIPE);
+    float f = (float)d;
+    if (!isfinite(f) || f < lo || f > hi) return tolak(k, n, ALASAN_RENTANG);
+    x = f;
+    return true;
+  }
+
+  bool bacaInt(const char *k, size_t n, long &x, long lo, long hi) {
+    double d;
+    if (!r.bilangan(d)) return tolak(k, n, ALASAN_TIPE);
+    if (d != floor(d) || d < (double)lo || d > (double)hi) return tolak(k, n, ALASAN_RENTANG);
+    x = (long)d;
+    return true;
+  }
+
+  bool bacaBool(const char *k, size_t n, int8_t &x) {
+    if (r.literal("true")) x = 1;
+    else if (r.literal("false")) x = 0;
+    else return tolak(k, n, ALASAN_TIPE);
+    return true;
+  }
+
+  // [x, ...] tepat `jumlah` angka berhingga
+  bool bacaArrayFloat(float *out, int jumlah) {
+    if (!r.ambil('[')) return false;
+    for (int i = 0; i < jumlah; i++) {
+      double d;
+      if (i > 0 && !r.ambil(',')) return false;
+      if (!r.bilangan(d) || !isfinite((float)d)) return false;
+      out[i] = (float)d;
+    }
+    return r.ambil(']');
+  }
+
+  // [duty %, ...] di logika 0, 10, ..., 100%; harus 0-100 dan tidak turun
+  bool bacaKurva(const char *k, size_t n, KurvaAktuator &tujuan) {
+    KurvaAktuator kurva = tujuan;
+    if (!bacaArrayFloat(kurva.duty, KURVA_AKTUATOR_TITIK)) return tolak(k, n, "butuh 11 angka duty %");
+    for (float &d : kurva.duty) d /= 100.0f;
+    if (!kurvaAktuatorValid(kurva)) return tolak(k, n, "duty di luar 0-100 / turun");
+    tujuan = kurva;
+    return true;
+  }
+
+  // {"mf": [[a,b,c,d], ...], "out": [...], "default": x}; null = tidak diubah
+  template <int NSets, int NInputs>
+  bool bacaAturan(const char *k, size_t n, FuzzySugeno<NSets, NInputs> &tujuan, bool &berubah) {
+    typedef FuzzySugeno<NSets, NInputs> F;
+    if (r.literal("null")) return true;
+    if (!r.ambil('{')) return tolak(k, n, ALASAN_TIPE);
+
+    Trapesium himpunan[F::N_HIMPUNAN];
+    float kons[F::N_ATURAN];
+    float keluaranDefault = tujuan.keluaranDefault;
+    bool adaMf = false, adaOut = false;
+    if (!r.ambil('}')) {
+      do {
+        const char *s;
+        size_t m;
+        if (!r.string(s, m) || !r.ambil(':')) return tolak(k, n, ALASAN_JSON);
+        if (sama(s, m, "mf")) {
+          if (!r.ambil('[')) return tolak(k, n, "mf bukan array");
+          for (int i = 0; i < F::N_HIMPUNAN; i++) {
+            float t[4];
+            if ((i > 0 && !r.ambil(',')) || !bacaArrayFloat(t, 4)) return tolak(k, n, "mf butuh N x [a,b,c,d]");
+            himpunan[i] = trapesium(t[0], t[1], t[2], t[3]);
+          }
+          if (!r.ambil(']')) return tolak(k, n, "jumlah mf salah");
+          adaMf = true;
+        } else if (sama(s, m, "out")) {
+          if (!bacaArrayFloat(kons, F::N_ATURAN)) return tolak(k, n, "jumlah out salah");
+          adaOut = true;
+        } else if (sama(s, m, "default")) {
+          if (!bacaFloat(k, n, keluaranDefault, 0.0f, 100.0f)) return false;
+        } else if (!r.lewati(1)) {
+          return tolak(k, n, ALASAN_JSON);
+        }
+      } while (r.ambil(','));
+      if (!r.ambil('}')) return tolak(k, n, ALASAN_JSON);
+    }
+    if (!adaMf || !adaOut) return tolak(k, n, "butuh mf & out");
+    if (!tujuan.muat(himpunan, kons, keluaranDefault)) return tolak(k, n, "breakpoint tidak urut / NaN");
+    berubah = true;
+    return true;
+  }
+};
+
+}  // namespace
+
+// =========================================================================
+//                  PARSE + VALIDASI
+// =========================================================================
+
+HasilPerintah parsePerintah(const char *json, size_t len, KonfigurasiKontrol &konf, PengaturanTelemetri &pt) {
+  Parser ps = {{json, json + len}, {true, 0, "", nullptr, 0}};
+  PembacaJson &r = ps.r;
+  HasilPerintah &h = ps.h;
+  ParameterKontrol &p = konf.param;
+
+  // Mesin fuzzy diterapkan sesudah loop, urutan tetap (LUT lalu PD) apa pun urutan kunci
+  int8_t lutSuhu = -1, pdSuhu = -1, lutKeruh = -1, biner = -1, kirimPintar = -1, dither = -1;
+  int8_t bayangan = -1, transfer = -1, terapkanAutotune = -1;
+  bool aturanBerubah = false, aturanPdBerubah = false;
+
+  if (!r.ambil('{')) { ps.tolak("", 0, ALASAN_JSON); return h; }
+  if (!r.ambil('}')) {
+    do {
+      const char *k;
+      size_t n;
+      if (!r.string(k, n) || !r.ambil(':')) { ps.tolak("", 0, ALASAN_JSON); return h; }
+
+      const KunciFloat *kf = nullptr;
+      for (const KunciFloat &c : KUNCI_FLOAT) {
+        if (sama(k, n, c.kunci)) { kf = &c; break; }
+      }
+
+      bool ok = true;
+      long v = 0;
+      if (kf) {
+        ok = ps.bacaFloat(k, n, p.*(kf->field), kf->lo, kf->hi);
+        h.berubah |= kf->grup;
+      } else if (sama(k, n, "kontrol_aktif")) {
+        const char *s;
+        size_t m;
+        if (!r.string(s, m)) ok = ps.tolak(k, n, ALASAN_TIPE);
+        else if (sama(s, m, "Fuzzy")) p.kontrolAktif = FUZZY;
+        else if (sama(s, m, "PID")) p.kontrolAktif = PID;
+        else if (sama(s, m, "MPC")) p.kontrolAktif = MPC;
+        else ok = ps.tolak(k, n, "mode bukan Fuzzy/PID/MPC");
+        konf.nomorResetPID++;
+        h.berubah |= PERINTAH_MODE;
+      } else if (sama(k, n, "id_perintah")) {
+        ok = ps.bacaInt(k, n, v, 1, 2147483647L);
+        if (ok) {
+          h.id = (uint32_t)v;
+          konf.idPerintah = (uint32_t)v;
+          konf.nomorPerintah++;
+        }
+      } else if (sama(k, n, "adc_jernih")) {
+        ok = ps.bacaInt(k, n, v, 0, PERINTAH_ADC_MAKS);
+        p.NILAI_ADC_JERNIH = (int)v;
+        h.berubah |= PERINTAH_KALIBRASI;
+      } else if (sama(k, n, "adc_keruh")) {
+        ok = ps.bacaInt(k, n, v, 0, PERINTAH_ADC_MAKS);
+        p.NILAI_ADC_KERUH = (int)v;
+        h.berubah |= PERINTAH_KALIBRASI;
+      } else if (sama(k, n, "kurva_heater")) {
+        ok = ps.bacaKurva(k, n, p.kurvaHeater);
+        h.berubah |= PERINTAH_AKTUATOR;
+      } else if (sama(k, n, "kurva_pompa")) {
+        ok = ps.bacaKurva(k, n, p.kurvaPompa);
+        h.berubah |= PERINTAH_AKTUATOR;
+      } else if (sama(k, n, "dither_heater")) {
+        ok = ps.bacaBool(k, n, dither);
+        h.berubah |= PERINTAH_AKTUATOR;
+      } else if (sama(k, n, "mode_bayangan")) {
+        ok = ps.bacaBool(k, n, bayangan);
+        h.berubah |= PERINTAH_BAYANGAN;
+      } else if (sama(k, n, "transfer_mulus")) {
+        ok = ps.bacaBool(k, n, transfer);
+        h.berubah |= PERINTAH_BAYANGAN;
+      } else if (sama(k, n, "kalibrasi_aktuator")) {
+        const char *s;
+        size_t m;
+        if (!r.string(s, m)) ok = ps.tolak(k, n, ALASAN_TIPE);
+        else if (sama(s, m, "heater")) konf.aksiKalibrasiAktuator = KALIBRASI_AKSI_HEATER;
+        else if (sama(s, m, "pompa")) konf.aksiKalibrasiAktuator = KALIBRASI_AKSI_POMPA;
+        else if (sama(s, m, "batal")) konf.aksiKalibrasiAktuator = KALIBRASI_AKSI_BATAL;
+        else ok = ps.tolak(k, n, "bukan heater/pompa/batal");
+        konf.nomorKalibrasiAktuator++;
+        h.berubah |= PERINTAH_KALIBRASI_AKTUATOR;
+      } else if (sama(k, n, "autotune")) {
+        const char *s;
+        size_t m;
+        if (!r.string(s, m)) ok = ps.tolak(k, n, ALASAN_TIPE);
+        else if (sama(s, m, "suhu")) konf.aksiAutotune = AUTOTUNE_AKSI_SUHU;
+        else if (sama(s, m, "keruh")) konf.aksiAutotune = AUTOTUNE_AKSI_KERUH;
+        else if (sama(s, m, "batal")) konf.aksiAutotune = AUTOTUNE_AKSI_BATAL;
+        else ok = ps.tolak(k, n, "bukan suhu/keruh/batal");
+        konf.nomorAutotune++;
+        h.berubah |= PERINTAH_AUTOTUNE;
+      } else if (sama(k, n, "autotune_aturan")) {
+        const char *s;
+        size_t m;
+        if (!r.string(s, m)) ok = ps.tolak(k, n, ALASAN_TIPE);
+        else if (sama(s, m, "simc")) konf.aturanAutotune = AUTOTUNE_SIMC;
+        else if (sama(s, m, "zn")) konf.aturanAutotune = AUTOTUNE_ZN;
+        else if (sama(s, m, "tl")) konf.aturanAutotune = AUTOTUNE_TL;
+        else ok = ps.tolak(k, n, "bukan simc/zn/tl");
+        h.berubah |= PERINTAH_AUTOTUNE;
+      } else if (sama(k, n, "autotune_terapkan")) {
+        ok = ps.bacaBool(k, n, terapkanAutotune);
+        h.berubah |= PERINTAH_AUTOTUNE;
+      } else if (sama(k, n, "fuzzy_lut_suhu")) {
+        ok = ps.bacaBool(k, n, lutSuhu);
+      } else if (sama(k, n, "fuzzy_pd_suhu")) {
+        ok = ps.bacaBool(k, n, pdSuhu);
+      } else if (sama(k, n, "fuzzy_lut_keruh")) {
+        ok = ps.bacaBool(k, n, lutKeruh);
+      } else if (sama(k, n, "fuzzy_suhu")) {
+        ok = ps.bacaAturan(k, n, konf.aturan.suhu, aturanBerubah);
+      } else if (sama(k, n, "fuzzy_keruh")) {
+        ok = ps.bacaAturan(k, n, konf.aturan.keruh, aturanBerubah);
+      } else if (sama(k, n, "fuzzy_suhu_pd")) {
+        ok = ps.bacaAturan(k, n, konf.aturan.suhuPD, aturanPdBerubah);
+      } else if (sama(k, n, "resolusi_suhu")) {
+        ok = ps.bacaInt(k, n, v, 9, 12);
+        konf.resolusiSuhu = (uint8_t)v;
+        h.berubah |= PERINTAH_RESOLUSI;
+      } else if (sama(k, n, "telemetri_biner")) {
+        ok = ps.bacaBool(k, n, biner);
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "batch_sampel")) {
+        ok = ps.bacaInt(k, n, v, 1, TELEMETRI_BATCH_MAKS);
+        pt.batchSampel = (uint8_t)v;
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "kirim_pintar")) {
+        ok = ps.bacaBool(k, n, kirimPintar);
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "deadband_suhu")) {
+        ok = ps.bacaFloat(k, n, pt.kirim.deadbandSuhu, 0.0f, 5.0f);
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "deadband_keruh")) {
+        ok = ps.bacaFloat(k, n, pt.kirim.deadbandKeruh, 0.0f, 20.0f);
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "deadband_output")) {
+        ok = ps.bacaFloat(k, n, pt.kirim.deadbandOutput, 0.0f, 50.0f);
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "heartbeat_ms")) {
+        ok = ps.bacaInt(k, n, v, 1000, 3600000);
+        pt.kirim.heartbeatMs = (uint32_t)v;
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (sama(k, n, "batch_interval_ms")) {
+        ok = ps.bacaInt(k, n, v, 100, 600000);
+        pt.batchIntervalMs = (unsigned long)v;
+        h.berubah |= PERINTAH_TELEMETRI;
+      } else if (!r.lewati(1)) {
+        ok = ps.tolak(k, n, ALASAN_JSON);
+      }
+      if (!ok) return h;
+    } while (r.ambil(','));
+    if (!r.ambil('}')) { ps.tolak("", 0, ALASAN_JSON); return h; }
+  }
+  r.spasi();
+  if (r.p != r.akhir) { ps.tolak("", 0, ALASAN_JSON); return h; }
+
+  if (lutSuhu >= 0) p.mesinFuzzySuhu = lutSuhu ? FUZZY_LUT : FUZZY_EKSAK;
+  if (pdSuhu == 1) p.mesinFuzzySuhu = FUZZY_PD;
+  else if (pdSuhu == 0 && p.mesinFuzzySuhu == FUZZY_PD) p.mesinFuzzySuhu = FUZZY_EKSAK;
+  if (lutKeruh >= 0) p.mesinFuzzyKeruh = lutKeruh ? FUZZY_LUT : FUZZY_EKSAK;
+  if (lutSuhu >= 0 || pdSuhu >= 0 || lutKeruh >= 0) h.berubah |= PERINTAH_MESIN_FUZZY;
+  if (biner >= 0) pt.biner = biner;
+  if (kirimPintar >= 0) pt.kirim.aktif = kirimPintar;
+  if (dither >= 0) p.ditherHeater = dither;
+  if (bayangan >= 0) p.modeBayangan = bayangan;
+  if (transfer >= 0) p.transferMulus = transfer;
+  if (terapkanAutotune >= 0) konf.terapkanAutotune = terapkanAutotune;
+
+  // Validasi set lengkap (kunci bisa datang di pesan berbeda)
+  if (p.NILAI_ADC_KERUH >= p.NILAI_ADC_JERNIH) { ps.tolak("adc_keruh", 9, "kalibrasi terbalik (keruh >= jernih)"); return h; }
+  if (p.keruhMati > p.keruhTahan) { ps.tolak("keruh_mati", 10, "keruh_mati > keruh_tahan"); return h; }
+
+  if (aturanBerubah) {
+    konf.aturan.panggangLut();   // di core 0, loop kontrol tidak ikut menunggu
+    h.berubah |= PERINTAH_ATURAN;
+  }
+  if (aturanPdBerubah) h.berubah |= PERINTAH_ATURAN_PD;
+  return h;
+}
+
+// =========================================================================
+//                  GEMA PERINTAH
+// =========================================================================
+
+GemaPerintah gemaDitolak(const HasilPerintah &h, uint32_t terimaUs) {
+  GemaPerintah g = {};
+  g.id = h.id;
+  g.ok = false;
+  memcpy(g.kunci, h.kunci, sizeof(g.kunci));
+  g.alasan = h.alasan;
+  g.terimaUs = terimaUs;
+  return g;
+}
+
+void PelacakPerintah::mulai(uint32_t id, uint32_t terimaUs, uint32_t terapUs) {
+  g = {};
+  g.id = id;
+  g.ok = true;
+  g.alasan = "";
+  g.terimaUs = terimaUs;
+  g.terapUs = terapUs;
+  menunggu = true;
+}
+
+bool PelacakPerintah::catat(const StempelTahap &suhu, const StempelTahap &keruh) {
+  if (!menunggu) return false;
+  if (g.aktuasiSuhuUs == 0 && suhu.aktuasiUs != 0 && tidakSebelum(suhu.aktuasiUs, g.terapUs))
+    g.aktuasiSuhuUs = suhu.aktuasiUs;
+  if (g.aktuasiKeruhUs == 0 && keruh.aktuasiUs != 0 && tidakSebelum(keruh.aktuasiUs, g.terapUs))
+    g.aktuasiKeruhUs = keruh.aktuasiUs;
+  if (g.aktuasiSuhuUs == 0 || g.aktuasiKeruhUs == 0) return false;
+  menunggu = false;
+  return true;
+}
+
+// Selisih stempel terhadap waktu terima; 0 = tahap tidak terjadi -> null
+static int tulisSelisih(char *buf, size_t len, const char *kunci, uint32_t stempelUs, uint32_t terimaUs) {
+  if (stempelUs == 0) return snprintf(buf, len, ",\"%s\":null", kunci);
+  return snprintf(buf, len, ",\"%s\":%lu", kunci, (unsigned long)(stempelUs - terimaUs));
+}
+
+size_t serializeGemaPerintah(const GemaPerintah &g, const TitikWaktu &sekarang, char *buf, size_t len) {
+  int n = snprintf(buf, len, "{\"id\":%lu,\"ok\":%s,\"kunci\":\"%s\",\"alasan\":\"%s\"", (unsigned long)g.id,
+                   g.ok ? "true" : "false", g.kunci, g.alasan ? g.alasan : "");
+  if (n < 0 || (size_t)n >= len) return 0;
+  const uint64_t terima = sekarang.epochDari(g.terimaUs);
+  int m = terima ? snprintf(buf + n, len - n, ",\"terima_ms\":%llu.%03u", (unsigned long long)(terima / 1000ULL),
+                            (unsigned)(terima % 1000ULL))
+                 : snprintf(buf + n, len - n, ",\"terima_ms\":null");
+  if (m < 0 || (size_t)(n + m) >= len) return 0;
+  n += m;
+  const char *const KUNCI[] = {"terap_us", "aktuasi_suhu_us", "aktuasi_keruh_us"};
+  const uint32_t stempel[] = {g.terapUs, g.aktuasiSuhuUs, g.aktuasiKeruhUs};
+  for (int i = 0; i < 3; i++) {
+    m = tulisSelisih(buf + n, len - n, KUNCI[i], stempel[i], g.terimaUs);
+    if (m < 0 || (size_t)(n + m) >= len) return 0;
+    n += m;
+  }
+  if ((size_t)n + 1 >= len) return 0;
+  buf[n++] = '}';
+  buf[n] = '\0';
+  return (size_t)n;
+}
+
+// =========================================================================
+//                  STATISTIK
+// =========================================================================
+
+void StatistikPerintah::catat(const HasilPerintah &h, uint32_t parseUs) {
+  parseUsTerakhir = parseUs;
+  if (parseUs > parseUsMaks) parseUsMaks = parseUs;
+  if (h.ok) {
+    diterima++;
+    return;
+  }
+  ditolak++;
+  memcpy(kunciDitolak, h.kunci, sizeof(kunciDitolak));
+  alasanDitolak = h.alasan;
+}
+
+size_t serializeStatusPerintah(const StatistikPerintah &s, uint32_t heapBebas, uint32_t heapBebasMin,
+                               char *buf, size_t len) {
+  int n = snprintf(buf, len,
+    "{\"diterima\":%lu,\"ditolak\":%lu,\"parse_us\":%lu,\"parse_us_maks\":%lu,"
+    "\"heap_bebas\":%lu,\"heap_min\":%lu,\"ditolak_kunci\":\"%s\",\"ditolak_alasan\":\"%s\"}",
+    (unsigned long)s.diterima, (unsigned long)s.ditolak, (unsigned long)s.parseUsTerakhir,
+    (unsigned long)s.parseUsMaks, (unsigned long)heapBebas, (unsigned long)heapBebasMin,
+    s.kunciDitolak, s.alasanDitolak);
+  return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * PARSER PERINTAH MQTT (TANPA HEAP) + SET PARAMETER BERTAHAP
+ * * Deskripsi:
+ * Pesan JSON di MQTT_TOPIC_MODE dibaca langsung dari buffer payload
+ * PubSubClient (tidak perlu diakhiri NUL): tidak ada DynamicJsonDocument,
+ * tidak ada String, tidak ada malloc.
+ * - Semua kunci diterapkan ke salinan bertahap (staging) konfigurasi.
+ *   Satu saja nilai tidak valid (NaN/null, di luar rentang, tipe salah,
+ *   kalibrasi ADC terbalik, rule base tidak urut) -> seluruh pesan ditolak
+ *   dan konfigurasi lama tetap dipakai.
+ * - Pesan yang lolos dipublikasikan utuh lewat Seqlock; task kontrol
+ *   menyalinnya di antara tick, jadi tidak pernah ada set setengah jadi.
+ * - Kunci yang tidak dikenal dilewati (dokumen Control backend dikirim utuh).
+ * - Rentang validasi: PERINTAH_* di bawah (bisa di-override build_flags).
+ * - "id_perintah" (opsional, taruh paling depan supaya ikut terbaca walau
+ *   kunci sesudahnya ditolak): perintah diberi gema di MQTT_TOPIC_GEMA
+ *   dengan waktu terima, terap (snapshot diambil core 1) & aktuasi pertama
+ *   tiap loop -> latensi perintah -> aktuasi di host (PelacakPerintah).
+ */
+
+#ifndef AQUARIUM_PERINTAH_KONTROL_H
+#define AQUARIUM_PERINTAH_KONTROL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "AturanFuzzy.h"
+#include "AutotuneRelay.h"
+#include "JamDinding.h"
+#include "KebijakanKirim.h"
+#include "Kontrol.h"
+#include "Sensor.h"
+
+#ifndef PERINTAH_SUHU_MIN
+#define PERINTAH_SUHU_MIN 15.0f      // setpoint suhu (C)
+#endif
+#ifndef PERINTAH_SUHU_MAKS
+#define PERINTAH_SUHU_MAKS 40.0f
+#endif
+#ifndef PERINTAH_GAIN_MAKS
+#define PERINTAH_GAIN_MAKS 1000.0f   // gain PID >= 0 dan <= ini (kp/ki/kd: <= AUTOTUNE_GAIN_MAKS bila lebih besar)
+#endif
+#ifndef PERINTAH_ADC_MAKS
+#define PERINTAH_ADC_MAKS 32767      // ADS1115 single-ended
+#endif
+#ifndef PERINTAH_KEDALAMAN_MAKS
+#define PERINTAH_KEDALAMAN_MAKS 8    // nesting JSON maksimum (juga untuk kunci yang dilewati)
+#endif
+
+// Semua yang bisa diubah lewat MQTT, dipublikasikan sebagai satu snapshot
+struct KonfigurasiKontrol {
+  ParameterKontrol param;
+  AturanFuzzy aturan;
+  uint8_t resolusiSuhu = SUHU_RESOLUSI;   // bit DS18B20 (9-12), dibaca taskSuhu
+  uint32_t nomorResetPID = 0;   // naik tiap perintah ganti mode -> resetPID (atau transfer mulus) di core 1
+  uint32_t nomorKalibrasiAktuator = 0;   // naik tiap perintah kalibrasi_aktuator -> core 1
+  uint8_t aksiKalibrasiAktuator = 0;     // AksiKalibrasi
+  uint32_t nomorAutotune = 0;   // naik tiap perintah autotune -> core 1
+  uint8_t aksiAutotune = 0;     // AksiAutotune
+  uint8_t aturanAutotune = 0;   // AturanAutotune untuk autotune berikutnya (0 = SIMC)
+  bool terapkanAutotune = false;    // hasil autotune langsung dipasang ke gain aktif
+  uint32_t nomorPerintah = 0;   // naik tiap perintah ber-id_perintah -> gema dari core 1
+  uint32_t idPerintah = 0;
+  uint32_t terimaUs = 0;        // micros() saat pesan tiba (diisi callback)
+};
+
+// "kalibrasi_aktuator": "heater" / "pompa" / "batal" (KalibrasiAktuator.h)
+enum AksiKalibrasi : uint8_t {
+  KALIBRASI_AKSI_HEATER = KANAL_HEATER,
+  KALIBRASI_AKSI_POMPA = KANAL_POMPA,
+  KALIBRASI_AKSI_BATAL,
+};
+
+// "autotune": "suhu" / "keruh" / "batal" (AutotuneRelay.h); "autotune_aturan":
+// "simc" / "zn" / "tl" dan "autotune_terapkan": true/false berlaku untuk autotune berikutnya
+enum AksiAutotune : uint8_t {
+  AUTOTUNE_AKSI_SUHU = KANAL_HEATER,
+  AUTOTUNE_AKSI_KERUH = KANAL_POMPA,
+  AUTOTUNE_AKSI_BATAL,
+};
+
+// Format telemetri (milik task jaringan)
+struct PengaturanTelemetri {
+  bool biner = false;                   // false = JSON per sampel (format lama)
+  uint8_t batchSampel = 10;             // flush jika jumlah sampel tercapai ...
+  unsigned long batchIntervalMs = 10000; // ... atau sampel tertua sudah selama ini
+  PengaturanKirim kirim;                // deadband, heartbeat, laju transien
+};
+
+// Kelompok yang berubah (untuk log Serial)
+enum : uint16_t {
+  PERINTAH_MODE = 1 << 0,
+  PERINTAH_SETPOINT = 1 << 1,
+  PERINTAH_TUNING = 1 << 2,
+  PERINTAH_MESIN_FUZZY = 1 << 3,
+  PERINTAH_ATURAN = 1 << 4,      // rule base suhu/keruh (LUT sudah dipanggang ulang)
+  PERINTAH_ATURAN_PD = 1 << 5,
+  PERINTAH_RESOLUSI = 1 << 6,
+  PERINTAH_TELEMETRI = 1 << 7,
+  PERINTAH_KALIBRASI = 1 << 8,
+  PERINTAH_AKTUATOR = 1 << 9,    // kurva_heater / kurva_pompa / dither_heater
+  PERINTAH_KALIBRASI_AKTUATOR = 1 << 10,
+  PERINTAH_BAYANGAN = 1 << 11,   // mode_bayangan / transfer_mulus / tau_transfer
+  PERINTAH_AUTOTUNE = 1 << 12,   // autotune / autotune_aturan / autotune_terapkan
+};
+
+struct HasilPerintah {
+  bool ok;
+  uint16_t berubah;       // PERINTAH_*
+  char kunci[24];         // kunci penyebab penolakan ("" = JSON rusak / validasi akhir)
+  const char *alasan;     // literal, nullptr jika ok
+  uint32_t id;            // id_perintah (0 = tidak ada / belum terbaca sebelum ditolak)
+};
+
+// Parse payload ke konf & pt (isi awal = konfigurasi aktif). Jika ditolak,
+// isi konf & pt tidak terdefinisi: pemanggil harus membuang salinan ini.
+HasilPerintah parsePerintah(const char *json, size_t len, KonfigurasiKontrol &konf, PengaturanTelemetri &pt);
+
+// Gema satu perintah ber-id; stempel micros, 0 = tahap tidak terjadi
+struct GemaPerintah {
+  uint32_t id;
+  bool ok;
+  char kunci[24];          // ditolak: kunci & alasan penolakan
+  const char *alasan;
+  uint32_t terimaUs;
+  uint32_t terapUs;        // snapshot diambil task kontrol
+  uint32_t aktuasiSuhuUs;  // duty pertama tiap loop sesudah terap
+  uint32_t aktuasiKeruhUs;
+};
+
+GemaPerintah gemaDitolak(const HasilPerintah &h, uint32_t terimaUs);
+
+// Milik task kontrol: tunggu tick pertama kedua loop sesudah perintah diterapkan
+struct PelacakPerintah {
+  GemaPerintah g = {};
+  bool menunggu = false;
+
+  void mulai(uint32_t id, uint32_t terimaUs, uint32_t terapUs);
+  // Panggil sesudah tick; true jika kedua loop sudah beraktuasi (g lengkap, siap dikirim)
+  bool catat(const StempelTahap &suhu, const StempelTahap &keruh);
+};
+
+// {"id":..,"ok":true,"kunci":"","alasan":"","terima_ms":<UTC>,"terap_us":..,"aktuasi_suhu_us":..,
+//  "aktuasi_keruh_us":..}; *_us relatif terima, null jika tidak terjadi; terima_ms null jika
+// jam belum sinkron. Return panjang, 0 jika buf kurang
+size_t serializeGemaPerintah(const GemaPerintah &g, const TitikWaktu &sekarang, char *buf, size_t len);
+
+// Statistik parser untuk telemetri (MQTT_TOPIC_PERINTAH)
+struct StatistikPerintah {
+  uint32_t diterima = 0, ditolak = 0;
+  uint32_t parseUsTerakhir = 0, parseUsMaks = 0;
+  char kunciDitolak[24] = "";
+  const char *alasanDitolak = "";
+
+  void catat(const HasilPerintah &h, uint32_t parseUs);
+};
+
+// {"diterima":..,"ditolak":..,"parse_us":..,"parse_us_maks":..,"heap_bebas":..,"heap_min":..,...}
+// Return panjang, 0 jika buf kurang
+size_t serializeStatusPerintah(const StatistikPerintah &s, uint32_t heapBebas, uint32_t heapBebasMin,
+                               char *buf, size_t len);
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * MESIN PID ADAPTIF GENERIK (double / float / Q16.16)
+ * * Deskripsi:
+ * Aljabar PID suhu & keruh yang dulu ditulis langsung dalam double, kini
+ * template atas tipe angka T. FPU ESP32 hanya mempercepat single precision;
+ * double diemulasi software, jadi firmware memakai float (default AngkaPid).
+ * - Perilaku sama persis untuk semua T: integral dibatasi +/-20, dibagi dua
+ *   saat error ganti tanda (suhu), derivatif difilter 0.3 baru + 0.7 lama,
+ *   dt minimum 1 ms, Mode Turbo + feedforward 50% + batas pompa (keruh).
+ * - Ambang (turbo, tahan, mati) dibandingkan dalam float di satuan sensor
+ *   untuk semua T, supaya keputusan diskret tidak bergantung pembulatan T.
+ * - Q16: fixed-point 16.16 bertanda, operasi jenuh (saturating) supaya
+ *   derivatif besar (dt 1 ms) tidak wrap-around; resolusi 1.5e-5.
+ * Toleransi vs double pada jejak simulator: lihat cekPresisiPid() di tools/bench.
+ */
+
+#ifndef AQUARIUM_PID_H
+#define AQUARIUM_PID_H
+
+#include <stdint.h>
+
+template <typename T>
+inline T batasi(T x, T lo, T hi) { return (x < lo) ? lo : ((x > hi) ? hi : x); }
+
+// =========================================================================
+//                  FIXED-POINT Q16.16
+// =========================================================================
+
+struct Q16 {
+  static constexpr int32_t SATU = 1 << 16;
+  int32_t v = 0;
+
+  constexpr Q16() = default;
+  constexpr explicit Q16(int x) : v(jenuh((int64_t)x * SATU)) {}
+  constexpr explicit Q16(double x) : v(jenuhDouble(x * SATU)) {}
+  explicit Q16(float x) : v(jenuhFloat(x * (float)SATU)) {}
+
+  static constexpr Q16 mentah(int32_t v) { Q16 q; q.v = v; return q; }
+
+  explicit operator double() const { return v * (1.0 / SATU); }
+  explicit operator float() const { return v * (1.0f / SATU); }
+
+  static constexpr int32_t jenuh(int64_t x) {
+    return (x > INT32_MAX) ? INT32_MAX : ((x < -INT32_MAX) ? -INT32_MAX : (int32_t)x);
+  }
+  static constexpr int32_t jenuhDouble(double x) {
+    return (x >= 2147483647.0) ? INT32_MAX : ((x <= -2147483647.0) ? -INT32_MAX : (int32_t)(x + ((x < 0) ? -0.5 : 0.5)));
+  }
+  static int32_t jenuhFloat(float x) {
+    return (x >= 2147483520.0f) ? INT32_MAX : ((x <= -2147483520.0f) ? -INT32_MAX : (int32_t)(x + ((x < 0) ? -0.5f : 0.5f)));
+  }
+
+  friend Q16 operator+(Q16 a, Q16 b) { return mentah(jenuh((int64_t)a.v + b.v)); }
+  friend Q16 operator-(Q16 a, Q16 b) { return mentah(jenuh((int64_t)a.v - b.v)); }
+  friend Q16 operator-(Q16 a) { return mentah(-a.v); }
+  friend Q16 operator*(Q16 a, Q16 b) { return mentah(jenuh(((int64_t)a.v * b.v) >> 16)); }
+  friend Q16 operator/(Q16 a, Q16 b) {
+    if (b.v == 0) return mentah((a.v < 0) ? -INT32_MAX : INT32_MAX);
+    return mentah(jenuh(((int64_t)a.v * SATU) / b.v));
+  }
+  friend bool operator<(Q16 a, Q16 b) { return a.v < b.v; }
+  friend bool operator>(Q16 a, Q16 b) { return a.v > b.v; }
+  friend bool operator<=(Q16 a, Q16 b) { return a.v <= b.v; }
+  friend bool operator>=(Q16 a, Q16 b) { return a.v >= b.v; }
+};
+
+// Tipe angka PID firmware (bisa di-override lewat build_flags, mis. -DPID_ANGKA=Q16)
+#ifndef PID_ANGKA
+#define PID_ANGKA float
+#endif
+typedef PID_ANGKA AngkaPid;
+
+// dt (detik) dari selisih millis()
+template <typename T>
+inline T detikDariMs(unsigned long ms) { return T(ms) / T(1000); }
+template <>
+inline float detikDariMs<float>(unsigned long ms) { return (float)ms / 1000.0f; }
+template <>
+inline double detikDariMs<double>(unsigned long ms) { return (double)ms / 1000.0; }
+template <>
+inline Q16 detikDariMs<Q16>(unsigned long ms) { return Q16::mentah(Q16::jenuh((int64_t)ms * Q16::SATU / 1000)); }
+
+// =========================================================================
+//                  STATE & GAIN
+// =========================================================================
+
+template <typename T>
+struct StatePid {
+  T integral = T(0), lastError = T(0), lastDeriv = T(0);
+  T outputTerfilter = T(0);   // keruh: output pompa terfilter (dicatat, belum dipakai)
+  unsigned long lastTime = 0;
+
+  void reset(unsigned long now) {
+    integral = T(0);
+    lastError = T(0);
+    lastDeriv = T(0);
+    outputTerfilter = T(0);
+    lastTime = now;
+  }
+};
+
+// State PID yang tersimpan di tempat lain (mis. array SoA BankKontrol)
+template <typename T>
+struct RefStatePid {
+  T &integral, &lastError, &lastDeriv;
+  T &outputTerfilter;
+  unsigned long &lastTime;
+
+  void reset(unsigned long now) {
+    integral = T(0);
+    lastError = T(0);
+    lastDeriv = T(0);
+    outputTerfilter = T(0);
+    lastTime = now;
+  }
+};
+
+template <typename T>
+struct GainPid {
+  T kp, ki, kd;
+};
+
+// Gain scheduling keruh; ambang & batas pompa dalam satuan sensor (float)
+template <typename T>
+struct GainPidKeruh {
+  T kp, ki, kd;
+  T kpTurbo;
+  float ambangTurbo;
+  float tahan, mati;
+  float setpoint;
+};
+
+// =========================================================================
+//                  KERNEL
+// =========================================================================
+
+// S = StatePid<T> atau RefStatePid<T>
+template <typename T, typename S>
+T pidSuhu(S &&s, const GainPid<T> &g, float errorSuhu, unsigned long now) {
+  T dt = detikDariMs<T>(now - s.lastTime);
+  if (dt < T(0.001)) dt = T(0.001);
+  const T e = T(errorSuhu);
+
+  T P = g.kp * e;
+
+  s.integral = batasi(s.integral + e * dt, T(-20), T(20));
+  if ((e > T(0) && s.lastError < T(0)) || (e < T(0) && s.lastError > T(0))) {
+    s.integral = s.integral * T(0.5);
+  }
+  T I = g.ki * s.integral;
+
+  T rawDerivative = (e - s.lastError) / dt;
+  T derivative = T(0.3) * rawDerivative + T(0.7) * s.lastDeriv;
+  s.lastDeriv = derivative;
+  T D = g.kd * derivative;
+
+  s.lastError = e;
+  s.lastTime = now;
+
+  return batasi(P + I + D, T(0), T(100));
+}
+
+template <typename T, typename S>
+T pidKeruh(S &&s, const GainPidKeruh<T> &g, float errorKeruh, unsigned long now) {
+  T dt = detikDariMs<T>(now - s.lastTime);
+  if (dt < T(0.001)) dt = T(0.001);
+  const T e = T(errorKeruh);
+
+  T dynamicKp = g.kp, dynamicKd = g.kd;   // Mode Smooth
+  if (__builtin_fabsf(errorKeruh) > g.ambangTurbo) {
+    dynamicKp = g.kpTurbo;                // Mode Turbo
+    dynamicKd = T(0);
+    s.integral = T(0);
+  }
+
+  T P = dynamicKp * e;
+
+  s.integral = batasi(s.integral + e * dt, T(-20), T(20));
+  T I = g.ki * s.integral;
+
+  T rawDerivative = (e - s.lastError) / dt;
+  T derivative = T(0.3) * rawDerivative + T(0.7) * s.lastDeriv;
+  s.lastDeriv = derivative;
+  T D = dynamicKd * derivative;
+
+  const T feedForward = T(50);
+  T output = P + I + D + feedForward;
+
+  float aktualTurbidity = errorKeruh + g.setpoint;
+  if (aktualTurbidity >= g.tahan && output < feedForward) output = feedForward;  // TAHAN, JANGAN TURUN!
+  if (aktualTurbidity <= g.mati) {
+    output = T(0);
+    s.integral = T(0);
+  }
+
+  s.outputTerfilter = T(0.5) * output + T(0.5) * s.outputTerfilter;
+
+  s.lastError = e;
+  s.lastTime = now;
+
+  return batasi(output, T(0), T(100));
+}
+
+#endif
@@ -0,0 +1,77 @@
+#include "Profil.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *const NAMA_TAHAP_PROFIL[JUMLAH_TAHAP_PROFIL] = {
+  "sampel", "sensor_suhu", "sensor_keruh", "hitung_suhu", "hitung_keruh",
+  "aktuator", "serialize", "publish", "perintah",
+};
+
+void StatTahap::reset() {
+  memset(this, 0, sizeof(*this));
+  min = UINT32_MAX;
+}
+
+uint32_t StatTahap::persentil(float q) const {
+  if (jumlah == 0) return 0;
+  const uint32_t target = (uint32_t)(q * (float)(jumlah - 1)) + 1;
+  uint32_t n = 0;
+  for (int b = 0; b < PROFIL_BUCKET; b++) {
+    n += histogram[b];
+    if (n >= target) {
+      // Bucket b berisi durasi [2^(b-1), 2^b - 1]; bucket terakhir dibatasi maks
+      uint32_t batas = (b >= 32) ? UINT32_MAX : (uint32_t)((1ull << b) - 1);
+      return (b == PROFIL_BUCKET - 1 || batas > maks) ? maks : batas;
+    }
+  }
+  return maks;
+}
+
+void Profil::reset() {
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++) tahap[i].reset();
+}
+
+void Profil::salinTahap(const Profil &p, uint32_t mask) {
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++)
+    if (mask & (1u << i)) tahap[i] = p.tahap[i];
+}
+
+void Profil::resetTahap(uint32_t mask) {
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++)
+    if (mask & (1u << i)) tahap[i].reset();
+}
+
+static double keUs(double tick) { return tick / PROFIL_TICK_PER_US; }
+
+size_t serializeStatTahap(const StatTahap &s, TahapProfil t, uint32_t jendelaMs, char *buf, size_t len) {
+  const double rata = s.jumlah ? (double)s.total / s.jumlah : 0.0;
+  int n = snprintf(buf, len,
+    "{\"tahap\":\"%s\",\"jendela_ms\":%lu,\"jumlah\":%lu,\"min_us\":%.2f,\"rata_us\":%.2f,\"maks_us\":%.2f,"
+    "\"p50_us\":%.2f,\"p99_us\":%.2f,\"total_us\":%.0f,\"hist\":[",
+    NAMA_TAHAP_PROFIL[t], (unsigned long)jendelaMs, (unsigned long)s.jumlah, s.jumlah ? keUs(s.min) : 0.0,
+    keUs(rata), keUs(s.maks), keUs(s.persentil(0.5f)), keUs(s.persentil(0.99f)), keUs((double)s.total));
+  if (n < 0 || (size_t)n >= len) return 0;
+
+  // Hanya bucket berisi: [batas atas us, jumlah]
+  bool pertama = true;
+  for (int b = 0; b < PROFIL_BUCKET; b++) {
+    if (!s.histogram[b]) continue;
+    const double batas = (b == PROFIL_BUCKET - 1) ? (double)s.maks : (double)((1ull << b) - 1);
+    int m = snprintf(buf + n, len - n, "%s[%.3f,%lu]", pertama ? "" : ",", keUs(batas), (unsigned long)s.histogram[b]);
+    if (m < 0 || (size_t)(n + m) >= len) return 0;
+    n += m;
+    pertama = false;
+  }
+  int m = snprintf(buf + n, len - n, "]}");
+  if (m < 0 || (size_t)(n + m) >= len) return 0;
+  return (size_t)(n + m);
+}
+
+size_t serializeMemoriProfil(const MemoriProfil &m, char *buf, size_t len) {
+  int n = snprintf(buf, len,
+    "{\"memori\":{\"heap_bebas\":%lu,\"heap_min\":%lu,\"stack_kontrol\":%lu,\"stack_jaringan\":%lu,\"stack_log\":%lu,"
+    "\"stack_suhu\":%lu}}",
+    (unsigned long)m.heapBebas, (unsigned long)m.heapMin, (unsigned long)m.stackKontrol,
+    (unsigned long)m.stackJaringan, (unsigned long)m.stackLog, (unsigned long)m.stackSuhu);
+  return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * PROFILER JALUR PANAS PER TAHAP
+ * * Deskripsi:
+ * Instrumentasi berlingkup (RAII) di sense -> compute -> actuate ->
+ * serialize -> publish. Waktu: register CCOUNT di ESP32 (siklus CPU),
+ * steady_clock (ns) di native; biaya per lingkup hanya dua baca penghitung,
+ * satu clz dan beberapa penjumlahan.
+ * - Per tahap: jumlah, min / rata-rata / maks, histogram log2
+ *   (bucket b = durasi dalam tick dengan panjang bit b; p50/p99 dari histogram).
+ * - Satu tahap hanya boleh ditulis satu task (lihat TAHAP_CORE_KONTROL):
+ *   tidak ada atomic di jalur panas. Tahap core 1 dipindah ke core 0 lewat
+ *   Seqlock per jendela statistik (sama dengan LaporanJadwal).
+ * - Profil dipasang lewat Hal::profil; nullptr = tidak diukur (simulator,
+ *   auto-tuner paralel). PROFIL_AKTIF=0 menghapus semua lingkup saat kompilasi.
+ */
+
+#ifndef AQUARIUM_PROFIL_H
+#define AQUARIUM_PROFIL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Hal.h"
+
+#if !defined(__XTENSA__)
+#include <chrono>
+#else
+#include "SiklusCpu.h"
+#endif
+
+#ifndef PROFIL_AKTIF
+#define PROFIL_AKTIF 1
+#endif
+#ifndef PROFIL_BUCKET
+#define PROFIL_BUCKET 24   // 2^23 siklus = 35 ms di 240 MHz; di atasnya masuk bucket terakhir
+#endif
+#ifndef PROFIL_TICK_PER_US
+#if defined(__XTENSA__)
+#define PROFIL_TICK_PER_US 240   // CPU 240 MHz
+#else
+#define PROFIL_TICK_PER_US 1000  // ns
+#endif
+#endif
+
+enum TahapProfil : uint8_t {
+  PROFIL_SAMPEL = 0,    // core 1: ambil hasil ADS1115 / DS18B20 (loopSampel)
+  PROFIL_SENSOR_SUHU,   // core 1: bacaSuhuDS18B20
+  PROFIL_SENSOR_KERUH,  // core 1: bacaTurbidity + konversi persen
+  PROFIL_HITUNG_SUHU,   // core 1: Fuzzy / PID suhu
+  PROFIL_HITUNG_KERUH,  // core 1: Fuzzy / PID keruh
+  PROFIL_AKTUATOR,      // core 1: setHeaterSpeed / setPumpSpeed
+  PROFIL_SERIALIZE,     // core 0: JSON / record biner
+  PROFIL_PUBLISH,       // core 0: mqtt publish
+  PROFIL_PERINTAH,      // core 0: parse perintah MQTT
+  JUMLAH_TAHAP_PROFIL
+};
+
+// Tahap yang ditulis task kontrol (sisanya task jaringan)
+const uint32_t TAHAP_CORE_KONTROL = (1u << PROFIL_SAMPEL) | (1u << PROFIL_SENSOR_SUHU) | (1u << PROFIL_SENSOR_KERUH) |
+                                    (1u << PROFIL_HITUNG_SUHU) | (1u << PROFIL_HITUNG_KERUH) | (1u << PROFIL_AKTUATOR);
+
+extern const char *const NAMA_TAHAP_PROFIL[JUMLAH_TAHAP_PROFIL];
+
+inline uint32_t waktuProfil() {
+#if defined(__XTENSA__)
+  return bacaSiklusCpu();
+#else
+  // Dipotong 32 bit: selisih tetap benar untuk durasi < 4.2 s
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct StatTahap {
+  uint32_t jumlah, min, maks;
+  uint64_t total;
+  uint32_t histogram[PROFIL_BUCKET];
+
+  void reset();
+  void catat(uint32_t tick) {
+    jumlah++;
+    total += tick;
+    if (tick < min) min = tick;
+    if (tick > maks) maks = tick;
+    int b = tick ? 32 - __builtin_clz(tick) : 0;
+    histogram[b < PROFIL_BUCKET ? b : PROFIL_BUCKET - 1]++;
+  }
+  // Batas atas bucket (tick) tempat persentil q (0-1) jatuh
+  uint32_t persentil(float q) const;
+};
+
+struct Profil {
+  StatTahap tahap[JUMLAH_TAHAP_PROFIL];
+
+  Profil() { reset(); }
+  void reset();
+  // Salin tahap bertanda mask dari p (mis. snapshot core 1)
+  void salinTahap(const Profil &p, uint32_t mask);
+  void resetTahap(uint32_t mask);
+};
+
+class LingkupProfil {
+public:
+  LingkupProfil(Profil *p, TahapProfil t) : profil(p), tahap(t), mulai(p ? waktuProfil() : 0) {}
+  ~LingkupProfil() {
+    if (profil) profil->tahap[tahap].catat(waktuProfil() - mulai);
+  }
+  LingkupProfil(const LingkupProfil &) = delete;
+  LingkupProfil &operator=(const LingkupProfil &) = delete;
+
+private:
+  Profil *profil;
+  TahapProfil tahap;
+  uint32_t mulai;
+};
+
+#if PROFIL_AKTIF
+#define PROFIL_GABUNG2(a, b) a##b
+#define PROFIL_GABUNG(a, b) PROFIL_GABUNG2(a, b)
+// Ukur sisa lingkup (blok) saat ini sebagai tahap t
+#define PROFIL_LINGKUP(hal, t) LingkupProfil PROFIL_GABUNG(lingkupProfil_, __LINE__)((hal).profil, t)
+#else
+#define PROFIL_LINGKUP(hal, t) do { (void)sizeof((hal).profil); } while (0)
+#endif
+
+// Memori: heap bebas & terendah, sisa stack minimum tiap task (byte)
+struct MemoriProfil {
+  uint32_t heapBebas, heapMin;
+  uint32_t stackKontrol, stackJaringan, stackLog, stackSuhu;
+};
+
+// {"tahap":"hitung_suhu","jumlah":..,"min_us":..,"rata_us":..,"maks_us":..,"p50_us":..,"p99_us":..,
+//  "hist":[[batas_us,n],...]} ; return panjang, 0 jika buf kurang
+size_t serializeStatTahap(const StatTahap &s, TahapProfil t, uint32_t jendelaMs, char *buf, size_t len);
+// {"memori":{"heap_bebas":..,"heap_min":..,"stack_kontrol":..,...}}
+size_t serializeMemoriProfil(const MemoriProfil &m, char *buf, size_t len);
+
+#endif
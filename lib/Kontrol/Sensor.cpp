@@ -0,0 +1,85 @@
+#include "Sensor.h"
+#include <math.h>
+
+void PipelineSuhu::mulai(HalSuhu &sensors, uint8_t bit) {
+  setResolusi(bit);
+  resolusi = resolusiBaru;
+  jumlahProbe = sensors.mulai(resolusi);
+  fase = SIAGA;
+}
+
+bool PipelineSuhu::layani(HalSuhu &sensors, unsigned long now) {
+  switch (fase) {
+    case SIAGA:
+      if (jumlahProbe == 0) return false;
+      if (resolusiBaru != resolusi) {
+        resolusi = resolusiBaru;
+        sensors.setResolusi(resolusi);
+      }
+      sensors.mintaKonversi();
+      mulaiKonversiMs = now;
+      fase = KONVERSI;
+      return false;
+
+    case KONVERSI:
+      // Cek bit selesai dari bus; batas waktu datasheet sebagai cadangan (parasite power)
+      if (!sensors.konversiSelesai() && now - mulaiKonversiMs < waktuKonversiMs(resolusi) + 10) return false;
+      probeBerikut = 0;
+      sampelUs = (uint32_t)(now * 1000UL);   // sampel fisik = saat konversi selesai
+      fase = BACA;
+      return false;
+
+    case BACA: {
+      // Satu probe per panggilan supaya loop tidak tertahan lama di bus 1-Wire
+      float c = sensors.bacaC(probeBerikut);
+      if (c == -127.0f) jumlahGagal++;
+      suhu[probeBerikut] = c;
+      if (++probeBerikut < jumlahProbe) return false;
+      jumlahSiklus++;
+      fase = SIAGA;
+      return true;
+    }
+  }
+  return false;
+}
+
+float bacaSuhuDS18B20(PipelineSuhu &pipeline, StateKontrol &st) {
+  float tempC = pipeline.suhu[0];
+  if (tempC == -127.00f || isnan(tempC)) return filterSuhu(st.suhuTerfilter, tempC);
+
+  st.suhuTerakhir = filterSuhu(st.suhuTerfilter, tempC);
+  return st.suhuTerfilter;
+}
+
+void SamplerTurbidity::mulai(HalAdc &ads, int panjangJendela, uint16_t sps) {
+  median.reset(panjangJendela);
+  ads.mulaiKontinu(0, sps);
+  siapTerakhir = ads.jumlahSiap();
+}
+
+bool SamplerTurbidity::layani(HalAdc &ads, uint32_t nowUs) {
+  uint32_t siap = ads.jumlahSiap();
+  if (siap == siapTerakhir) return false;
+  sampelTerlewat += siap - siapTerakhir - 1;
+  siapTerakhir = siap;
+
+  int16_t val = ads.hasilTerakhir();
+  if (val < 0) val = 0;
+  median.tambah(val);
+  jumlahSampel++;
+  sampelUs = nowUs;
+  return true;
+}
+
+int bacaTurbidity(SamplerTurbidity &sampler, StateKontrol &st) {
+  // Median jendela geser: membuang nilai gelembung yang ekstrim tinggi
+  int medianADC = sampler.median.median();
+
+  // Update nilai global
+  st.turbidityTerakhir = medianADC;
+  return medianADC;
+}
+
+float konversiTurbidityKePersen(int adcValue, const ParameterKontrol &p) {
+  return konversiTurbidityKePersen(adcValue, p.NILAI_ADC_KERUH, p.NILAI_ADC_JERNIH);
+}
@@ -0,0 +1,109 @@
+/**
+ * PEMBACAAN SENSOR (DS18B20 & TURBIDITY ADS1115) lewat HAL.
+ * * Turbidity: ADS1115 mode kontinu, pin ALERT/RDY -> ISR (counter),
+ *   layani() dipanggil sesering mungkin dari loop untuk mengambil hasil
+ *   konversi baru ke median jendela geser. Loop kontrol cukup membaca
+ *   median terakhir (O(1)), tanpa delay.
+ * * Suhu: DS18B20 mode non-blocking. PipelineSuhu::layani() memulai
+ *   konversi, menunggu tanpa delay, lalu membaca satu probe per panggilan.
+ *   Baca scratchpad tetap memblok bus ~5-7 ms per probe, jadi firmware
+ *   menjalankannya di task sendiri (core 0) dan menyalin hasil ke task
+ *   kontrol lewat Seqlock; simulator memanggilnya langsung.
+ */
+
+#ifndef AQUARIUM_SENSOR_H
+#define AQUARIUM_SENSOR_H
+
+#include <math.h>
+#include "Hal.h"
+#include "Kontrol.h"
+#include "MedianGeser.h"
+
+// Panjang jendela median & laju sampel turbidity (bisa lewat build_flags)
+#ifndef TURBIDITY_JENDELA
+#define TURBIDITY_JENDELA 21
+#endif
+#ifndef TURBIDITY_SPS
+#define TURBIDITY_SPS 250
+#endif
+const int TURBIDITY_JENDELA_MAKS = 63;
+
+// Konstanta filter eksponensial suhu
+const float ALPHA = 0.2;
+
+struct SamplerTurbidity {
+  MedianGeser<TURBIDITY_JENDELA_MAKS> median;
+  uint32_t siapTerakhir = 0;
+  uint32_t jumlahSampel = 0;
+  uint32_t sampelTerlewat = 0;  // konversi yang tertimpa sebelum sempat dibaca
+  uint32_t sampelUs = 0;        // micros() saat sampel terbaru diambil (0 = belum ada)
+
+  void mulai(HalAdc &ads, int panjangJendela, uint16_t sps);
+  // Ambil hasil konversi baru (jika ada) ke filter; return true jika ada.
+  // nowUs = micros() untuk stempel latensi (0 = tanpa stempel)
+  bool layani(HalAdc &ads, uint32_t nowUs = 0);
+};
+
+// Resolusi DS18B20: 9 bit = 94 ms (0.5 C), ... 12 bit = 750 ms (0.0625 C)
+#ifndef SUHU_RESOLUSI
+#define SUHU_RESOLUSI 12
+#endif
+
+struct PipelineSuhu {
+  enum Fase : uint8_t { SIAGA, KONVERSI, BACA };
+
+  Fase fase = SIAGA;
+  uint8_t resolusi = SUHU_RESOLUSI;
+  uint8_t resolusiBaru = SUHU_RESOLUSI;
+  uint8_t jumlahProbe = 0;
+  uint8_t probeBerikut = 0;
+  unsigned long mulaiKonversiMs = 0;
+  uint32_t sampelUs = 0;   // akhir konversi terakhir (micros, resolusi ms)
+
+  float suhu[SUHU_MAKS_PROBE] = {-127.0f, -127.0f, -127.0f, -127.0f};
+  uint32_t jumlahSiklus = 0;   // set lengkap semua probe
+  uint32_t jumlahGagal = 0;    // pembacaan -127 (CRC gagal / probe lepas)
+
+  static unsigned long waktuKonversiMs(uint8_t bit) { return 750UL >> (12 - bit); }
+  // Satu langkah kuantisasi pembacaan (C): 0.0625 di 12 bit ... 0.5 di 9 bit
+  static float langkahC(uint8_t bit) {
+    if (bit < 9) bit = 9;
+    if (bit > 12) bit = 12;
+    return 0.0625f * (float)(1 << (12 - bit));
+  }
+
+  void mulai(HalSuhu &sensors, uint8_t bit);
+  // Ganti resolusi; diterapkan sebelum konversi berikutnya
+  void setResolusi(uint8_t bit) { resolusiBaru = (bit < 9) ? 9 : ((bit > 12) ? 12 : bit); }
+  // Maju satu langkah state machine; return true jika satu set probe selesai
+  bool layani(HalSuhu &sensors, unsigned long now);
+};
+
+// Semua state akuisisi sensor
+struct SensorAquarium {
+  SamplerTurbidity turbidity;
+  PipelineSuhu suhu;
+};
+
+// Pakai hasil konversi terakhir probe 0 (tidak menunggu konversi)
+float bacaSuhuDS18B20(PipelineSuhu &pipeline, StateKontrol &st);
+int bacaTurbidity(SamplerTurbidity &sampler, StateKontrol &st);
+float konversiTurbidityKePersen(int adcValue, const ParameterKontrol &p);
+
+// Bentuk per nilai (dipakai juga BankKontrol): filter EMA suhu & kalibrasi ADC.
+// Inline supaya prolog BankKontrol atas semua kanal tidak memanggil fungsi per kanal.
+// Probe gagal (-127 / NaN): filter tidak berubah, pakai nilai lama (28 C jika belum ada)
+inline float filterSuhu(float &suhuTerfilter, float tempC) {
+  const float lama = suhuTerfilter;
+  const bool valid = !((tempC == -127.00f) | isnan(tempC));
+  const float ema = (float)((ALPHA * tempC) + ((1.0 - ALPHA) * lama));
+  const float baru = (lama == 0.0f) ? tempC : ema;
+  suhuTerfilter = valid ? baru : lama;
+  return valid ? baru : ((lama == 0.0f) ? 28.0f : lama);
+}
+inline float konversiTurbidityKePersen(int adcValue, int adcKeruh, int adcJernih) {
+  const float persen = mapFloat((float)adcValue, (float)adcKeruh, (float)adcJernih, 100.0, 0.0);
+  return batasi(persen, 0.0f, 100.0f);
+}
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * SEQLOCK (SATU PENULIS, BANYAK PEMBACA)
+ * * Deskripsi:
+ * Publikasi atomik struct parameter antar core tanpa lock.
+ * - Penulis (task jaringan) menaikkan nomor urut jadi ganjil, menyalin
+ *   data, lalu menaikkannya lagi jadi genap.
+ * - Pembaca (task kontrol) menyalin data lalu mengecek nomor urut tidak
+ *   berubah & genap; jika bertabrakan dengan penulis, salin ulang.
+ *   Pembaca tidak pernah memblok penulis dan tidak pernah melihat data
+ *   setengah tertulis.
+ * - versi() murah: pembaca cukup menyalin ulang jika versi berubah.
+ * - Penulis & pembaca harus di core berbeda (atau pembaca berprioritas
+ *   lebih rendah): pembaca berputar selama nomor urut ganjil.
+ * - cobaBaca() untuk pembaca yang tidak boleh tertahan (task kontrol):
+ *   menyerah setelah SEQLOCK_COBA_MAKS percobaan (penulis terpreempt di
+ *   tengah tulis), pemanggil memakai snapshot sebelumnya tick ini; kejadian
+ *   dihitung di jumlahGagalBaca().
+ */
+
+#ifndef AQUARIUM_SEQLOCK_H
+#define AQUARIUM_SEQLOCK_H
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+#ifndef SEQLOCK_COBA_MAKS
+#define SEQLOCK_COBA_MAKS 1000   // ~10-20 us di ESP32: cukup untuk satu tulis yang tidak terpreempt
+#endif
+
+template <typename T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock hanya untuk data yang bisa di-memcpy");
+
+public:
+  // Hanya boleh dipanggil dari satu task penulis
+  void tulis(const T &baru) {
+    uint32_t s = urutan.load(std::memory_order_relaxed);
+    urutan.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&data, &baru, sizeof(T));
+    urutan.store(s + 2, std::memory_order_release);
+  }
+
+  // Salin snapshot konsisten ke keluar; return versinya
+  uint32_t baca(T &keluar) const {
+    for (;;) {
+      uint32_t s1 = urutan.load(std::memory_order_acquire);
+      if (s1 & 1u) continue;  // penulis sedang menyalin (di core lain)
+      memcpy(&keluar, &data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (urutan.load(std::memory_order_relaxed) == s1) return s1;
+    }
+  }
+
+  // Seperti baca(), tapi paling banyak SEQLOCK_COBA_MAKS percobaan. false = menyerah:
+  // isi keluar tidak terdefinisi (salin ke staging, bukan ke data yang sedang dipakai)
+  bool cobaBaca(T &keluar, uint32_t &versiBaca) const {
+    for (uint32_t coba = 0; coba < SEQLOCK_COBA_MAKS; coba++) {
+      uint32_t s1 = urutan.load(std::memory_order_acquire);
+      if (s1 & 1u) continue;
+      memcpy(&keluar, &data, sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (urutan.load(std::memory_order_relaxed) == s1) {
+        versiBaca = s1;
+        return true;
+      }
+    }
+    gagalBaca.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  uint32_t versi() const { return urutan.load(std::memory_order_acquire); }
+  uint32_t jumlahGagalBaca() const { return gagalBaca.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> urutan{0};
+  mutable std::atomic<uint32_t> gagalBaca{0};
+  T data;
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * PENGHITUNG SIKLUS CPU + UKUR SIKLUS PID
+ * * Deskripsi:
+ * bacaSiklusCpu(): register CCOUNT Xtensa (ESP32, 240 MHz) atau TSC x86;
+ * 0 jika arsitektur tidak punya penghitung yang murah dibaca.
+ * ukurSiklusPid<T>(): rata-rata siklus per panggilan pidSuhu + pidKeruh
+ * untuk satu tipe angka, dipakai firmware (-DBENCH_PID, dicetak saat boot)
+ * dan benchmark native supaya angkanya bisa dibandingkan langsung.
+ */
+
+#ifndef AQUARIUM_SIKLUS_CPU_H
+#define AQUARIUM_SIKLUS_CPU_H
+
+#include <stdint.h>
+#include "Pid.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+inline uint32_t bacaSiklusCpu() {
+#if defined(__XTENSA__)
+  uint32_t c;
+  __asm__ __volatile__("rsr %0, ccount" : "=a"(c));
+  return c;
+#elif defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__rdtsc();
+#else
+  return 0;
+#endif
+}
+
+struct SiklusPid {
+  uint32_t suhu, keruh;   // siklus per panggilan
+};
+
+// Error berupa gigi gergaji tetap (deterministik, melewati semua cabang:
+// ganti tanda, turbo, tahan, mati); dt 250 ms
+template <typename T>
+SiklusPid ukurSiklusPid(int n) {
+  StatePid<T> sS, sK;
+  const GainPid<T> gS = {T(8.0f), T(0.3f), T(6.0f)};
+  const GainPidKeruh<T> gK = {T(5.0f), T(0.2f), T(2.0f), T(35.0f), 2.0f, 11.0f, 9.0f, 15.0f};
+  volatile float sink = 0.0f;
+  unsigned long now = 0;
+  SiklusPid hasil;
+
+  uint32_t t0 = bacaSiklusCpu();
+  for (int i = 0; i < n; i++) {
+    now += 250;
+    sink = sink + (float)pidSuhu(sS, gS, (float)((i % 97) - 48) * 0.1f, now);
+  }
+  hasil.suhu = (bacaSiklusCpu() - t0) / (uint32_t)n;
+
+  t0 = bacaSiklusCpu();
+  for (int i = 0; i < n; i++) {
+    now += 250;
+    sink = sink + (float)pidKeruh(sK, gK, (float)((i % 89) - 30) * 0.2f, now);
+  }
+  hasil.keruh = (bacaSiklusCpu() - t0) / (uint32_t)n;
+  return hasil;
+}
+
+#endif
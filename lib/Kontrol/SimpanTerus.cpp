@@ -0,0 +1,261 @@
+#include "SimpanTerus.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char DIR_SIMPAN[] = "/tlm";
+static const char PATH_SESI[] = "/tlm/sesi";
+
+// CRC-8 (poly 0x07) untuk mendeteksi record setengah tertulis saat listrik mati
+static uint8_t crc8(const uint8_t *p, size_t len) {
+  uint8_t crc = 0;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= p[i];
+    for (int b = 0; b < 8; b++) crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+}
+
+static bool recordValid(const uint8_t *r) {
+  return r[0] == SIMPAN_PENANDA && r[1] == crc8(r + 4, TELEMETRI_BINER_RECORD);
+}
+
+static uint16_t sesiRecord(const uint8_t *r) { return (uint16_t)(r[2] | (r[3] << 8)); }
+
+// =========================================================================
+//                  INISIALISASI
+// =========================================================================
+
+struct CariSegmen {
+  bool ada = false;
+  uint32_t min = 0, max = 0;
+};
+
+static void catatSegmen(const char *nama, void *ctx) {
+  CariSegmen &c = *(CariSegmen *)ctx;
+  unsigned long nomor;
+  char ekor[8];
+  if (sscanf(nama, "%8lu.%7s", &nomor, ekor) != 2 || strcmp(ekor, "seg") != 0) return;
+  if (!c.ada || nomor < c.min) c.min = (uint32_t)nomor;
+  if (!c.ada || nomor > c.max) c.max = (uint32_t)nomor;
+  c.ada = true;
+}
+
+void SimpanTerus::pathSegmen(uint32_t nomor, char *buf, size_t len) const {
+  snprintf(buf, len, "%s/%08lu.seg", DIR_SIMPAN, (unsigned long)nomor);
+}
+
+long SimpanTerus::jumlahRecordSegmen(uint32_t nomor) {
+  char path[32];
+  pathSegmen(nomor, path, sizeof(path));
+  long n = berkas->ukuran(path);
+  return (n < 0) ? -1 : n / (long)SIMPAN_RECORD_FLASH;
+}
+
+void SimpanTerus::mulai(HalBerkas *b) {
+  berkas = b;
+  ramKepala = ramJumlah = 0;
+  adaSegmen = false;
+  segBaca = segTulis = offsetBaca = isiTulis = jumlahFlash = 0;
+  sesiAktif = 0;
+  if (!berkas) return;
+  if (!berkas->mulai()) {
+    stat.gagalFlash++;
+    berkas = nullptr;
+    return;
+  }
+
+  // Nomor sesi: satu tulis kecil per boot
+  uint8_t s[2] = {0, 0};
+  if (berkas->baca(PATH_SESI, 0, s, 2) == 2) sesiAktif = (uint16_t)(s[0] | (s[1] << 8));
+  if (++sesiAktif == 0) sesiAktif = 1;   // 0 = tidak diketahui (telemetri v1)
+  s[0] = (uint8_t)sesiAktif; s[1] = (uint8_t)(sesiAktif >> 8);
+  if (!berkas->tulis(PATH_SESI, s, 2)) stat.gagalFlash++;
+
+  CariSegmen c;
+  berkas->daftar(DIR_SIMPAN, catatSegmen, &c);
+  if (!c.ada) return;
+
+  adaSegmen = true;
+  segBaca = c.min;
+  segTulis = c.max;
+  for (uint32_t n = segBaca; n <= segTulis; n++) {
+    long r = jumlahRecordSegmen(n);
+    if (r > 0) jumlahFlash += (uint32_t)r;
+  }
+  // Segmen terakhir bisa berakhir dengan record terpotong: jangan di-append,
+  // tulisan berikutnya mulai di segmen baru
+  char path[32];
+  pathSegmen(segTulis, path, sizeof(path));
+  long ukuran = berkas->ukuran(path);
+  isiTulis = (ukuran < 0 || ukuran % (long)SIMPAN_RECORD_FLASH != 0)
+                 ? SIMPAN_SEGMEN_RECORD : (uint32_t)(ukuran / (long)SIMPAN_RECORD_FLASH);
+  rapikanSegmen();
+}
+
+// =========================================================================
+//                  SIMPAN & SPILL
+// =========================================================================
+
+void SimpanTerus::simpan(const Telemetri &t) {
+  uint8_t rec[TELEMETRI_BINER_RECORD];
+  kodekanRecordTelemetri(t, rec);
+  simpan(rec);
+}
+
+void SimpanTerus::simpan(const uint8_t *record) {
+  stat.dibuffer++;
+  if (ramJumlah == SIMPAN_RAM_RECORD) spill();
+  if (ramJumlah == SIMPAN_RAM_RECORD) {
+    // Tanpa flash (atau flash gagal sebelum ada yang tertulis): korbankan yang tertua.
+    // Spill sebagian sebelum gagal sudah memberi ruang, tidak ada yang dibuang.
+    ramKepala = (ramKepala + 1) % SIMPAN_RAM_RECORD;
+    ramJumlah--;
+    stat.dibuang++;
+  }
+  uint8_t *r = ram[(ramKepala + ramJumlah) % SIMPAN_RAM_RECORD];
+  r[0] = SIMPAN_PENANDA;
+  r[1] = crc8(record, TELEMETRI_BINER_RECORD);
+  r[2] = (uint8_t)sesiAktif;
+  r[3] = (uint8_t)(sesiAktif >> 8);
+  memcpy(r + 4, record, TELEMETRI_BINER_RECORD);
+  ramJumlah++;
+}
+
+bool SimpanTerus::spill() {
+  if (!berkas) return ramJumlah == 0;
+  while (ramJumlah > 0) {
+    // Bagian ring yang bersambung di memori (ring membungkus -> dua potong)
+    uint32_t n = SIMPAN_RAM_RECORD - ramKepala;
+    if (n > ramJumlah) n = ramJumlah;
+    uint32_t tertulis = tulisFlash(ram[ramKepala], n);
+    ramKepala = (ramKepala + tertulis) % SIMPAN_RAM_RECORD;
+    ramJumlah -= tertulis;
+    if (tertulis < n) return false;
+  }
+  return true;
+}
+
+uint32_t SimpanTerus::tulisFlash(const uint8_t *blok, uint32_t jumlahRecord) {
+  uint32_t total = 0;
+  char path[32];
+  while (jumlahRecord > 0) {
+    if (!adaSegmen) {
+      segBaca = ++segTulis;
+      offsetBaca = isiTulis = 0;
+      adaSegmen = true;
+    } else if (isiTulis >= SIMPAN_SEGMEN_RECORD) {
+      segTulis++;
+      isiTulis = 0;
+      if (segTulis - segBaca + 1 > SIMPAN_SEGMEN_MAKS) buangSegmenTertua();
+    }
+    uint32_t k = SIMPAN_SEGMEN_RECORD - isiTulis;
+    if (k > jumlahRecord) k = jumlahRecord;
+    pathSegmen(segTulis, path, sizeof(path));
+    if (!berkas->tambah(path, blok, (size_t)k * SIMPAN_RECORD_FLASH)) {
+      // Bisa tertulis sebagian: tutup segmen ini, coba lagi di segmen baru nanti
+      stat.gagalFlash++;
+      isiTulis = SIMPAN_SEGMEN_RECORD;
+      break;
+    }
+    isiTulis += k;
+    jumlahFlash += k;
+    stat.ditulisFlash += k;
+    total += k;
+    blok += (size_t)k * SIMPAN_RECORD_FLASH;
+    jumlahRecord -= k;
+  }
+  return total;
+}
+
+void SimpanTerus::buangSegmenTertua() {
+  long n = jumlahRecordSegmen(segBaca);
+  uint32_t sisa = (n > (long)offsetBaca) ? (uint32_t)n - offsetBaca : 0;
+  stat.dibuang += sisa;
+  jumlahFlash = (jumlahFlash > sisa) ? jumlahFlash - sisa : 0;
+  char path[32];
+  pathSegmen(segBaca, path, sizeof(path));
+  berkas->hapus(path);
+  offsetBaca = 0;
+  if (segBaca == segTulis) adaSegmen = false;
+  else segBaca++;
+}
+
+// Hapus segmen yang sudah habis diputar (atau hilang) di depan antrean
+void SimpanTerus::rapikanSegmen() {
+  while (adaSegmen) {
+    long n = jumlahRecordSegmen(segBaca);
+    if (n > (long)offsetBaca) return;
+    buangSegmenTertua();
+  }
+  jumlahFlash = 0;
+}
+
+// =========================================================================
+//                  PUTAR ULANG
+// =========================================================================
+
+int SimpanTerus::putarUlang(Hal &hal, const char *topic, int maksRecord) {
+  if (tertunda() == 0 || !hal.mqtt->connected()) return 0;
+  if (maksRecord < 1) maksRecord = 1;
+  if (maksRecord > TELEMETRI_BATCH_MAKS) maksRecord = TELEMETRI_BATCH_MAKS;
+  // Flash selalu lebih tua dari isi RAM
+  if (adaSegmen) return putarUlangFlash(hal, topic, maksRecord);
+  return putarUlangRam(hal, topic, maksRecord);
+}
+
+int SimpanTerus::putarUlangFlash(Hal &hal, const char *topic, int maksRecord) {
+  char path[32];
+  pathSegmen(segBaca, path, sizeof(path));
+  uint8_t buf[TELEMETRI_BATCH_MAKS * SIMPAN_RECORD_FLASH];
+  size_t terbaca = berkas->baca(path, (size_t)offsetBaca * SIMPAN_RECORD_FLASH,
+                                buf, (size_t)maksRecord * SIMPAN_RECORD_FLASH);
+  uint32_t n = (uint32_t)(terbaca / SIMPAN_RECORD_FLASH);
+
+  batchUlang.reset();
+  uint32_t dipakai = 0, rusak = 0;
+  for (; dipakai < n; dipakai++) {
+    const uint8_t *r = buf + (size_t)dipakai * SIMPAN_RECORD_FLASH;
+    if (!recordValid(r)) { rusak++; continue; }
+    // Satu batch = satu sesi (backend memetakan waktu per sesi)
+    if (batchUlang.jumlah > 0 && sesiRecord(r) != batchUlang.sesi) break;
+    if (batchUlang.jumlah == 0) batchUlang.sesi = sesiRecord(r);
+    batchUlang.tambahRecord(r + 4, hal.clock->millis());
+  }
+  if (batchUlang.jumlah > 0) {
+    batchUlang.flags = BATCH_PUTAR_ULANG | (batchUlang.sesi != sesiAktif ? BATCH_SESI_LAMA : 0);
+    if (!kirimBatchTelemetri(hal, topic, batchUlang)) return 0;
+  }
+
+  int terkirim = (int)(dipakai - rusak);
+  offsetBaca += dipakai;
+  jumlahFlash = (jumlahFlash > dipakai) ? jumlahFlash - dipakai : 0;
+  stat.diputarUlang += (uint32_t)terkirim;
+  stat.dibuang += rusak;
+  rapikanSegmen();
+  return terkirim;
+}
+
+int SimpanTerus::putarUlangRam(Hal &hal, const char *topic, int maksRecord) {
+  uint32_t n = ((uint32_t)maksRecord < ramJumlah) ? (uint32_t)maksRecord : ramJumlah;
+  batchUlang.reset();
+  batchUlang.sesi = sesiAktif;
+  batchUlang.flags = BATCH_PUTAR_ULANG;
+  for (uint32_t i = 0; i < n; i++)
+    batchUlang.tambahRecord(ram[(ramKepala + i) % SIMPAN_RAM_RECORD] + 4, hal.clock->millis());
+  if (!kirimBatchTelemetri(hal, topic, batchUlang)) return 0;
+  ramKepala = (ramKepala + n) % SIMPAN_RAM_RECORD;
+  ramJumlah -= n;
+  stat.diputarUlang += n;
+  return (int)n;
+}
+
+size_t serializeStatusSimpan(const SimpanTerus &s, char *buf, size_t len) {
+  int n = snprintf(buf, len,
+    "{\"sesi\":%u,\"flash\":%s,\"tertunda\":%lu,\"tertunda_flash\":%lu,\"dibuffer\":%lu,"
+    "\"diputar_ulang\":%lu,\"dibuang\":%lu,\"ditulis_flash\":%lu,\"gagal_flash\":%lu}",
+    (unsigned)s.sesi(), s.flashAktif() ? "true" : "false",
+    (unsigned long)s.tertunda(), (unsigned long)s.tertundaFlash(), (unsigned long)s.stat.dibuffer,
+    (unsigned long)s.stat.diputarUlang, (unsigned long)s.stat.dibuang,
+    (unsigned long)s.stat.ditulisFlash, (unsigned long)s.stat.gagalFlash);
+  return (n > 0 && (size_t)n < len) ? (size_t)n : 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * STORE-AND-FORWARD TELEMETRI
+ * * Deskripsi:
+ * Telemetri yang tidak bisa dikirim (WiFi/MQTT putus, publish gagal) tidak
+ * dibuang, tapi disimpan lalu diputar ulang setelah koneksi kembali.
+ * - RAM ring SIMPAN_RAM_RECORD record (format record TelemetriBiner, 24 byte).
+ * - Ring penuh -> seluruh isinya ditulis ke flash (segmen /tlm/NNNNNNNN.seg,
+ *   append saja, tiap segmen SIMPAN_SEGMEN_RECORD record). Satu tulis per
+ *   ring penuh, bukan per sampel, supaya flash tidak cepat aus.
+ * - Flash penuh (SIMPAN_SEGMEN_MAKS segmen) -> segmen tertua dihapus dan
+ *   isinya dihitung di stat.dibuang.
+ * - Putar ulang: tertua dulu (flash lalu RAM), satu batch biner per panggilan
+ *   dengan flag BATCH_PUTAR_ULANG, dibatasi jumlah record supaya tidak
+ *   membanjiri broker. Segmen dihapus setelah habis diputar.
+ * - Nomor sesi (boot) disimpan di /tlm/sesi; record dari boot lama dikirim
+ *   dengan BATCH_SESI_LAMA karena millis()-nya tidak bisa dipetakan ke jam
+ *   dinding oleh backend.
+ * Isi RAM hilang saat reset; posisi baca dalam segmen juga tidak disimpan,
+ * jadi setelah reboot paling banyak satu segmen bisa terkirim dua kali.
+ * Hanya dipanggil dari satu task (task jaringan).
+ */
+
+#ifndef AQUARIUM_SIMPAN_TERUS_H
+#define AQUARIUM_SIMPAN_TERUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Hal.h"
+#include "TelemetriBiner.h"
+
+#ifndef SIMPAN_RAM_RECORD
+#define SIMPAN_RAM_RECORD 128
+#endif
+#ifndef SIMPAN_SEGMEN_RECORD
+#define SIMPAN_SEGMEN_RECORD 1024
+#endif
+#ifndef SIMPAN_SEGMEN_MAKS
+#define SIMPAN_SEGMEN_MAKS 40
+#endif
+
+// Record di flash: penanda 0xA5 | crc8 data | sesi u16 | record telemetri
+const size_t SIMPAN_RECORD_FLASH = 4 + TELEMETRI_BINER_RECORD;
+const uint8_t SIMPAN_PENANDA = 0xA5;
+
+struct StatistikSimpan {
+  uint32_t dibuffer = 0;       // record yang masuk store (tidak terkirim live)
+  uint32_t diputarUlang = 0;   // record yang akhirnya terkirim lewat putar ulang
+  uint32_t dibuang = 0;        // hilang: flash penuh / gagal tulis / rusak
+  uint32_t ditulisFlash = 0;   // record yang pernah di-spill ke flash
+  uint32_t gagalFlash = 0;     // operasi flash yang gagal
+};
+
+class SimpanTerus {
+public:
+  // Cari segmen sisa boot sebelumnya & naikkan nomor sesi.
+  // berkas boleh nullptr (atau gagal mount): store hanya di RAM.
+  void mulai(HalBerkas *berkas);
+  uint16_t sesi() const { return sesiAktif; }
+
+  void simpan(const Telemetri &t);
+  void simpan(const uint8_t *record);            // TELEMETRI_BINER_RECORD byte
+
+  // Kirim maksimal maksRecord record tertua sebagai satu batch putar ulang.
+  // Return jumlah record yang terkirim (0 jika kosong / offline / gagal).
+  int putarUlang(Hal &hal, const char *topic, int maksRecord);
+
+  // Pindahkan isi RAM ke flash (otomatis saat ring penuh, atau sebelum
+  // restart terencana). Return false jika ada record yang tertinggal di RAM.
+  bool spill();
+
+  uint32_t tertunda() const { return ramJumlah + jumlahFlash; }
+  uint32_t tertundaFlash() const { return jumlahFlash; }
+  bool flashAktif() const { return berkas != nullptr; }
+
+  StatistikSimpan stat;
+
+private:
+  void pathSegmen(uint32_t nomor, char *buf, size_t len) const;
+  long jumlahRecordSegmen(uint32_t nomor);
+  uint32_t tulisFlash(const uint8_t *blok, uint32_t jumlahRecord);
+  void buangSegmenTertua();
+  void rapikanSegmen();
+  int putarUlangFlash(Hal &hal, const char *topic, int maksRecord);
+  int putarUlangRam(Hal &hal, const char *topic, int maksRecord);
+
+  HalBerkas *berkas = nullptr;
+  uint16_t sesiAktif = 0;
+
+  // Ring RAM sudah dalam format flash, jadi spill = satu/dua append langsung
+  uint8_t ram[SIMPAN_RAM_RECORD][SIMPAN_RECORD_FLASH];
+  uint32_t ramKepala = 0, ramJumlah = 0;
+  BatchTelemetri batchUlang;
+
+  bool adaSegmen = false;
+  uint32_t segBaca = 0, segTulis = 0;   // nomor segmen tertua & terbaru
+  uint32_t offsetBaca = 0;              // record yang sudah diputar di segBaca
+  uint32_t isiTulis = 0;                // record di segTulis
+  uint32_t jumlahFlash = 0;             // record di flash yang belum diputar
+};
+
+// {"sesi":3,"tertunda":120,"tertunda_flash":0,"dibuffer":...}; return panjang (0 jika tidak muat)
+size_t serializeStatusSimpan(const SimpanTerus &s, char *buf, size_t len);
+
+#endif
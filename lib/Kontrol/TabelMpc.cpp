@@ -0,0 +1,102 @@
+// Dihasilkan oleh tools/mpc (lib/Simulasi/MpcEksplisit.cpp), jangan diedit manual:
+//   tools/mpc
+// Plant: C 125580 J/K, UA 2.500 W/K, tau probe 12.0 s. MPC: horizon 8 x 120 s, q 1, r 0.0002,
+// gain tak terbatas 65.96 %/C. 6561 himpunan aktif -> 17 wilayah, 3 hukum; sel 48x8 (344 langsung).
+
+#include "Mpc.h"
+
+static const HukumMpc HUKUM[3] = {
+  {65.9619522f, 1.0f, 0.0f},
+  {0.0f, 0.0f, 0.0f},
+  {0.0f, 0.0f, 100.0f},
+};
+
+static const BidangMpc BIDANG[32] = {
+  {-0.999885082f, -0.0151585117f, 0.0f},
+  {0.999885082f, 0.0151585117f, 1.51585126f},
+  {0.999885082f, 0.0151585117f, 0.0f},
+  {-0.999870777f, -0.0160770342f, 0.0f},
+  {-0.999885082f, -0.0151585117f, -1.51585126f},
+  {0.999870777f, 0.0160770342f, 1.60770345f},
+  {0.999870777f, 0.0160770342f, 0.0f},
+  {-0.999855518f, -0.0169977117f, 0.0f},
+  {-0.999870777f, -0.0160770342f, -1.60770345f},
+  {0.999855518f, 0.0169977117f, 1.69977129f},
+  {0.999855518f, 0.0169977117f, 0.0f},
+  {-0.999839425f, -0.01792055f, 0.0f},
+  {-0.999855518f, -0.0169977117f, -1.69977129f},
+  {0.999839425f, 0.01792055f, 1.79205489f},
+  {0.999839425f, 0.01792055f, 0.0f},
+  {-0.999822378f, -0.018845547f, 0.0f},
+  {-0.999839425f, -0.01792055f, -1.79205489f},
+  {0.999822378f, 0.018845547f, 1.88455474f},
+  {0.999822378f, 0.018845547f, 0.0f},
+  {-0.999804497f, -0.0197727084f, 0.0f},
+  {-0.999822378f, -0.018845547f, -1.88455474f},
+  {0.999804497f, 0.0197727084f, 1.97727096f},
+  {0.999804497f, 0.0197727084f, 0.0f},
+  {-0.999785662f, -0.020702038f, 0.0f},
+  {-0.999804497f, -0.0197727084f, -1.97727096f},
+  {0.999785662f, 0.020702038f, 2.07020378f},
+  {0.999785662f, 0.020702038f, 0.0f},
+  {-0.999765992f, -0.0216335338f, 0.0f},
+  {-0.999785662f, -0.020702038f, -2.07020378f},
+  {0.999765992f, 0.0216335338f, 2.16335344f},
+  {0.999765992f, 0.0216335338f, 0.0f},
+  {-0.999765992f, -0.0216335338f, -2.16335344f},
+};
+
+static const WilayahMpc WILAYAH[17] = {
+  {0, 2, 0}, {2, 2, 1}, {4, 2, 2}, {6, 2, 1}, {8, 2, 2}, {10, 2, 1},
+  {12, 2, 2}, {14, 2, 1}, {16, 2, 2}, {18, 2, 1}, {20, 2, 2}, {22, 2, 1},
+  {24, 2, 2}, {26, 2, 1}, {28, 2, 2}, {30, 1, 1}, {31, 1, 2},
+};
+
+static const uint8_t KANDIDAT[12] = {
+  1, 0, 1, 1, 2, 0, 1, 0, 2, 1, 1, 0,
+};
+
+static const uint16_t SEL[384] = {
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x0000, 0x0000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x0003, 0x0006,
+  0x0006, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x0000, 0x0000, 0x0000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x0003, 0x0006, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x0000, 0x0000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x0003, 0x0006, 0x0006, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x0000, 0x0000, 0x0000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x0006, 0x0006, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x0000, 0x0000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x8000, 0x0003, 0x0006, 0x0006, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x8001, 0x0000, 0x0000, 0x0009, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x8000, 0x8000, 0x0006, 0x0006, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001,
+  0x8001, 0x0000, 0x0000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x8000, 0x0006, 0x0006, 0x0006, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x8001, 0x0000,
+  0x0000, 0x0009, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000, 0x8000,
+  0x0006, 0x0006, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+  0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002, 0x8002,
+};
+
+const TabelMpc TABEL_MPC = {
+  1.99076294e-05f, 0.369014621f, 0.0625f,
+  {0.00186075096f, 0.00183463539f, 0.00515924301f},
+  -3.0f, 3.0f, 0.0f, 100.0f, 8.0f, 0.0799999982f,
+  48, 8, 1, 2,
+  SEL, KANDIDAT, WILAYAH, BIDANG, HUKUM,
+  17, 32, 3, 12,
+  8, 120.0f,
+};
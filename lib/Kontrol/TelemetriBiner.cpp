@@ -0,0 +1,125 @@
+#include "TelemetriBiner.h"
+#include "JamDinding.h"
+#include "Profil.h"
+#include <math.h>
+#include <string.h>
+
+// =========================================================================
+//                  PENGKODEAN FIXED-POINT
+// =========================================================================
+
+static void tulisU16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void tulisU32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24);
+}
+static void tulisU64(uint8_t *p, uint64_t v) {
+  tulisU32(p, (uint32_t)v);
+  tulisU32(p + 4, (uint32_t)(v >> 32));
+}
+static uint16_t bacaU16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t bacaU32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Dibulatkan & dijenuhkan ke rentang tipe (NaN -> 0)
+static int16_t keI16(double x, double skala) {
+  double v = x * skala;
+  if (!(v == v)) return 0;
+  return (int16_t)lround(batasi(v, -32768.0, 32767.0));
+}
+static uint16_t keU16(double x, double skala) {
+  double v = x * skala;
+  if (!(v == v)) return 0;
+  return (uint16_t)lround(batasi(v, 0.0, 65535.0));
+}
+
+void kodekanRecordTelemetri(const Telemetri &t, uint8_t *p) {
+  tulisU32(p + 0, (uint32_t)t.timestamp_ms);
+  tulisU16(p + 4, (uint16_t)keI16(t.suhu, 100.0));
+  tulisU16(p + 6, keU16(t.turbidityPersen, 100.0));
+  tulisU16(p + 8, (uint16_t)keI16(t.turbidityAdc, 1.0));
+  tulisU16(p + 10, keU16(t.outSuhu, 100.0));
+  tulisU16(p + 12, keU16(t.outKeruh, 100.0));
+  tulisU16(p + 14, (uint16_t)keI16(t.errorSuhu, 100.0));
+  tulisU16(p + 16, (uint16_t)keI16(t.errorKeruh, 100.0));
+  tulisU16(p + 18, keU16(t.setpointSuhu, 100.0));
+  tulisU16(p + 20, keU16(t.setpointKeruh, 100.0));
+  p[22] = (uint8_t)((t.kontrolAktif == PID ? 1 : 0) | (t.feedforwardActive ? 2 : 0) | (t.kontrolAktif == MPC ? 4 : 0));
+  p[23] = 0;
+}
+
+void dekodekanRecordTelemetri(const uint8_t *p, Telemetri &t) {
+  t.timestamp_ms = bacaU32(p + 0);
+  t.suhu = (int16_t)bacaU16(p + 4) / 100.0f;
+  t.turbidityPersen = bacaU16(p + 6) / 100.0f;
+  t.turbidityAdc = (int16_t)bacaU16(p + 8);
+  t.outSuhu = bacaU16(p + 10) / 100.0;
+  t.outKeruh = bacaU16(p + 12) / 100.0;
+  // Duty tidak dikirim: rekonstruksi nominal dengan kurva bawaan
+  t.pwmSuhu = kuantisasiDuty(dutyLinear(KURVA_HEATER_DEFAULT, (float)t.outSuhu), nullptr);
+  t.pwmKeruh = kuantisasiDuty(dutyLinear(KURVA_POMPA_DEFAULT, (float)t.outKeruh), nullptr);
+  t.errorSuhu = (int16_t)bacaU16(p + 14) / 100.0f;
+  t.errorKeruh = (int16_t)bacaU16(p + 16) / 100.0f;
+  t.setpointSuhu = bacaU16(p + 18) / 100.0f;
+  t.setpointKeruh = bacaU16(p + 20) / 100.0f;
+  t.kontrolAktif = (p[22] & 4) ? MPC : (p[22] & 1) ? PID : FUZZY;
+  t.feedforwardActive = (p[22] & 2) != 0;
+  t.bayangan = false;   // output bayangan hanya di telemetri JSON
+  t.lewatAnggaranBayangan = 0;
+}
+
+// =========================================================================
+//                  BATCH
+// =========================================================================
+
+void BatchTelemetri::reset() {
+  jumlah = 0;
+  data[0] = 'A'; data[1] = 'Q';
+  data[2] = TELEMETRI_BINER_VERSI;
+  data[3] = 0;
+  data[4] = (uint8_t)TELEMETRI_BINER_RECORD;
+  data[5] = 0;
+  data[6] = data[7] = 0;
+  tulisU32(data + 8, 0);
+  tulisU64(data + 12, 0);
+}
+
+bool BatchTelemetri::tambah(const Telemetri &t, unsigned long now) {
+  if (penuh()) return false;
+  if (jumlah == 0) mulaiMs = now;
+  kodekanRecordTelemetri(t, data + TELEMETRI_BINER_HEADER + (size_t)jumlah * TELEMETRI_BINER_RECORD);
+  data[3] = ++jumlah;
+  return true;
+}
+
+bool BatchTelemetri::tambahRecord(const uint8_t *rec, unsigned long now) {
+  if (penuh()) return false;
+  if (jumlah == 0) mulaiMs = now;
+  memcpy(data + TELEMETRI_BINER_HEADER + (size_t)jumlah * TELEMETRI_BINER_RECORD, rec, TELEMETRI_BINER_RECORD);
+  data[3] = ++jumlah;
+  return true;
+}
+
+bool kirimBatchTelemetri(Hal &hal, const char *topic, BatchTelemetri &batch) {
+  if (batch.jumlah == 0 || !hal.mqtt->connected()) return false;
+  batch.data[5] = batch.flags;
+  tulisU16(batch.data + 6, batch.sesi);
+  // millis & epoch dibaca berurutan: host memetakan timestamp_ms ke UTC tanpa tebakan
+  // (micros 32 bit TitikWaktu berputar tiap ~71 menit, jadi millis dibaca sendiri)
+  const bool lama = (batch.flags & BATCH_SESI_LAMA) != 0;
+  const unsigned long ms = hal.clock->millis();
+  const TitikWaktu w = TitikWaktu::sekarang(*hal.clock);
+  tulisU32(batch.data + 8, lama ? 0 : (uint32_t)ms);
+  tulisU64(batch.data + 12, lama ? 0 : w.epochUs / 1000ULL);
+  {
+    PROFIL_LINGKUP(hal, PROFIL_PUBLISH);
+    if (!hal.mqtt->publish(topic, batch.data, batch.ukuran(), false)) return false;
+  }
+  batch.reset();
+  return true;
+}
+
+bool BatchTelemetri::perluFlush(unsigned long now, uint8_t maksSampel, unsigned long intervalMs) const {
+  if (jumlah == 0) return false;
+  return jumlah >= maksSampel || penuh() || now - mulaiMs >= intervalMs;
+}
@@ -0,0 +1,75 @@
+/**
+ * TELEMETRI BINER BATCH (OPSIONAL)
+ * * Deskripsi:
+ * Pengganti JSON per detik: N sampel dikemas fixed-point dalam satu publish.
+ * Didekode oleh backend/telemetriBiner.js lalu di-insert sekaligus.
+ * * Format (little endian), versi 3:
+ *   Header 20 byte: 'A' 'Q' | versi u8 | jumlah u8 | ukuran record u8 | flags u8
+ *                   sesi u16 (nomor boot) | t_kirim_ms u32 (millis saat publish,
+ *                   0 = tidak diketahui karena record dari sesi/boot lama)
+ *                   epoch_kirim_ms u64 (UTC saat publish, pasangan t_kirim_ms;
+ *                   0 = jam belum tersinkron SNTP / sesi lama)
+ *                   flags: bit0 = putar ulang (store-and-forward), bit1 = sesi lama
+ *   Record 24 byte: timestamp_ms u32
+ *                   suhu i16 (x100)           turbidity_persen u16 (x100)
+ *                   turbidity_adc i16
+ *                   pwm_heater u16 (x100)     pwm_pompa u16 (x100)
+ *                   error_suhu i16 (x100)     error_keruh i16 (x100)
+ *                   setpoint_suhu u16 (x100)  setpoint_keruh u16 (x100)
+ *                   flags u8 (bit0 = PID, bit1 = feedforward, bit2 = MPC) | cadangan u8
+ *   (Versi 1: header 8 byte tanpa flags/sesi/t_kirim_ms; versi 2: header
+ *   12 byte tanpa epoch_kirim_ms. Record sama.)
+ * Ukuran record ada di header: versi baru boleh menambah field di belakang,
+ * dekoder lama tetap bisa melompati sisa record.
+ */
+
+#ifndef AQUARIUM_TELEMETRI_BINER_H
+#define AQUARIUM_TELEMETRI_BINER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Tick.h"
+
+// Kapasitas batch maksimum (bisa lewat build_flags)
+#ifndef TELEMETRI_BATCH_MAKS
+#define TELEMETRI_BATCH_MAKS 32
+#endif
+
+const uint8_t TELEMETRI_BINER_VERSI = 3;
+const size_t TELEMETRI_BINER_HEADER = 20;
+const size_t TELEMETRI_BINER_RECORD = 24;
+const size_t TELEMETRI_BINER_UKURAN_MAKS = TELEMETRI_BINER_HEADER + TELEMETRI_BATCH_MAKS * TELEMETRI_BINER_RECORD;
+
+const uint8_t BATCH_PUTAR_ULANG = 1;
+const uint8_t BATCH_SESI_LAMA = 2;
+
+static_assert(TELEMETRI_BATCH_MAKS >= 1 && TELEMETRI_BATCH_MAKS <= 255, "jumlah di header u8");
+
+// Tulis / baca satu record (TELEMETRI_BINER_RECORD byte)
+void kodekanRecordTelemetri(const Telemetri &t, uint8_t *p);
+void dekodekanRecordTelemetri(const uint8_t *p, Telemetri &t);
+
+struct BatchTelemetri {
+  uint8_t data[TELEMETRI_BINER_UKURAN_MAKS];
+  uint8_t jumlah = 0;
+  uint8_t flags = 0;
+  uint16_t sesi = 0;
+  unsigned long mulaiMs = 0;   // waktu sampel pertama masuk (untuk flush per interval)
+
+  BatchTelemetri() { reset(); }
+  void reset();
+  // false jika sudah penuh (flush dulu)
+  bool tambah(const Telemetri &t, unsigned long now);
+  bool tambahRecord(const uint8_t *record, unsigned long now);
+  const uint8_t *record(int i) const { return data + TELEMETRI_BINER_HEADER + (size_t)i * TELEMETRI_BINER_RECORD; }
+  bool penuh() const { return jumlah >= TELEMETRI_BATCH_MAKS; }
+  // Waktunya kirim: jumlah >= maksSampel atau sampel tertua >= intervalMs
+  bool perluFlush(unsigned long now, uint8_t maksSampel, unsigned long intervalMs) const;
+  size_t ukuran() const { return TELEMETRI_BINER_HEADER + (size_t)jumlah * TELEMETRI_BINER_RECORD; }
+};
+
+// Publish batch (jika ada isinya); t_kirim_ms & epoch_kirim_ms diisi di sini kecuali BATCH_SESI_LAMA.
+// Batch direset hanya jika terkirim.
+bool kirimBatchTelemetri(Hal &hal, const char *topic, BatchTelemetri &batch);
+
+#endif
@@ -0,0 +1,218 @@
+#include "Tick.h"
+#include "Aktuator.h"
+#include "Profil.h"
+#include <math.h>
+#include <stdio.h>
+
+// Waktu hitung dua kernel bayangan; gabungan > anggaran dicatat di state
+static void catatWaktuBayangan(Bayangan &b, StateKontrol &st, uint32_t t0, uint32_t t1, uint32_t t2) {
+  b.usFuzzy = (float)(t1 - t0) / PROFIL_TICK_PER_US;
+  b.usPid = (float)(t2 - t1) / PROFIL_TICK_PER_US;
+  if (b.usFuzzy + b.usPid > ANGGARAN_BAYANGAN_US) st.lewatAnggaranBayangan++;
+}
+
+// Fuzzy & PID pada error yang sama (state terpisah, urutan tidak berpengaruh);
+// return output mode aktif. MPC tetap dihitung sendiri, keduanya jadi bayangan.
+static double hitungBayanganSuhu(StateKontrol &st, const ParameterKontrol &p, float errorSuhu, unsigned long now,
+                                 const AturanFuzzy &af, Bayangan &b) {
+  const uint32_t t0 = waktuProfil();
+  const double fuzzy = hitungFuzzySuhuMesin(st.lastErrorFuzzySuhu, st.lastTimeFuzzySuhu, af, p.mesinFuzzySuhu,
+                                            errorSuhu, now);
+  const uint32_t t1 = waktuProfil();
+  const double pid = hitungPIDSuhu(st, p, errorSuhu, now);
+  catatWaktuBayangan(b, st, t0, t1, waktuProfil());
+  b.fuzzy = (float)fuzzy;
+  b.pid = (float)pid;
+  if (p.kontrolAktif == FUZZY) return fuzzy;
+  if (p.kontrolAktif == PID) return pid;
+  return hitungKontrolSuhu(st, p, errorSuhu, now, af);
+}
+
+static double hitungBayanganKeruh(StateKontrol &st, const ParameterKontrol &p, float errorKeruh,
+                                  float turbidityPersen, unsigned long now, const AturanFuzzy &af, Bayangan &b) {
+  const uint32_t t0 = waktuProfil();
+  const double fuzzy = hitungFuzzyKeruhTerfilter(st.outputKeruhTerfilter, af, p.mesinFuzzyKeruh, errorKeruh,
+                                                 turbidityPersen, p.keruhTahan, p.keruhMati);
+  const uint32_t t1 = waktuProfil();
+  const double pid = hitungPIDKeruh(st, p, errorKeruh, now);
+  catatWaktuBayangan(b, st, t0, t1, waktuProfil());
+  b.fuzzy = (float)fuzzy;
+  b.pid = (float)pid;
+  return (p.kontrolAktif == PID) ? pid : fuzzy;
+}
+
+void tickSuhu(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+              const AturanFuzzy &af, KalibrasiAktuator *kal, AutotuneRelay *tune) {
+  unsigned long now = hal.clock->millis();
+
+  // Baca Sensor -> Hitung Error -> Hitung Output -> Eksekusi ke Heater
+  float suhuAktual;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_SENSOR_SUHU);
+    suhuAktual = bacaSuhuDS18B20(sensor.suhu, st);
+  }
+  float errorSuhu = p.suhuSetpoint - suhuAktual;
+  double outSuhu;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_HITUNG_SUHU);
+    outSuhu = p.modeBayangan ? hitungBayanganSuhu(st, p, errorSuhu, now, af, t.bayanganSuhu)
+                             : hitungKontrolSuhu(st, p, errorSuhu, now, af);
+    outSuhu = terapkanTransfer(st.transferSuhu, outSuhu, st.outSuhuTerakhir, p.tauTransfer, now);
+    st.outSuhuTerakhir = outSuhu;
+  }
+  t.stempelSuhu.sampelUs = sensor.suhu.sampelUs;
+  t.stempelSuhu.hitungUs = (uint32_t)hal.clock->micros();
+
+  int pwmSuhu;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_AKTUATOR);
+    if (kal && kal->aktif(KANAL_HEATER)) {
+      pwmSuhu = kal->tulis(*hal.pwm, suhuAktual, now);
+      outSuhu = pwmSuhu * 100.0 / PWM_DUTY_MAKS;
+    } else if (tune && tune->aktif(KANAL_HEATER)) {
+      outSuhu = tune->langkah(suhuAktual, now);
+      pwmSuhu = setHeaterSpeed(*hal.pwm, p.kurvaHeater, (float)outSuhu, nullptr);
+    } else {
+      pwmSuhu = setHeaterSpeed(*hal.pwm, p.kurvaHeater, (float)outSuhu, p.ditherHeater ? &st.sisaDitherHeater : nullptr);
+    }
+  }
+  t.stempelSuhu.aktuasiUs = (uint32_t)hal.clock->micros();
+
+  t.timestamp_ms = now;
+  t.suhu = suhuAktual;
+  t.kontrolAktif = p.kontrolAktif;
+  t.outSuhu = outSuhu;
+  t.pwmSuhu = pwmSuhu;
+  t.errorSuhu = errorSuhu;
+  t.setpointSuhu = p.suhuSetpoint;
+  t.bayangan = p.modeBayangan;
+  t.lewatAnggaranBayangan = st.lewatAnggaranBayangan;
+}
+
+void tickKeruh(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+               const AturanFuzzy &af, KalibrasiAktuator *kal, AutotuneRelay *tune) {
+  unsigned long now = hal.clock->millis();
+
+  // Baca Sensor -> Hitung Error -> Hitung Output -> Eksekusi ke Pompa
+  int turbidityADC;
+  float turbidityPersen;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_SENSOR_KERUH);
+    turbidityADC = bacaTurbidity(sensor.turbidity, st);
+    turbidityPersen = konversiTurbidityKePersen(turbidityADC, p);
+  }
+  float errorKeruh = turbidityPersen - p.turbiditySetpoint;
+  double outKeruh;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_HITUNG_KERUH);
+    outKeruh = p.modeBayangan ? hitungBayanganKeruh(st, p, errorKeruh, turbidityPersen, now, af, t.bayanganKeruh)
+                              : hitungKontrolKeruh(st, p, errorKeruh, turbidityPersen, now, af);
+    outKeruh = terapkanTransfer(st.transferKeruh, outKeruh, st.outKeruhTerakhir, p.tauTransfer, now);
+    st.outKeruhTerakhir = outKeruh;
+  }
+  t.stempelKeruh.sampelUs = sensor.turbidity.sampelUs;
+  t.stempelKeruh.hitungUs = (uint32_t)hal.clock->micros();
+
+  int pwmKeruh;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_AKTUATOR);
+    if (kal && kal->aktif(KANAL_POMPA)) {
+      pwmKeruh = kal->tulis(*hal.pwm, turbidityPersen, now);
+      outKeruh = pwmKeruh * 100.0 / PWM_DUTY_MAKS;
+    } else if (tune && tune->aktif(KANAL_POMPA)) {
+      outKeruh = tune->langkah(turbidityPersen, now);
+      pwmKeruh = setPumpSpeed(*hal.pwm, p.kurvaPompa, (float)outKeruh);
+    } else {
+      pwmKeruh = setPumpSpeed(*hal.pwm, p.kurvaPompa, (float)outKeruh);
+    }
+  }
+  t.stempelKeruh.aktuasiUs = (uint32_t)hal.clock->micros();
+
+  t.timestamp_ms = now;
+  t.turbidityPersen = turbidityPersen;
+  t.turbidityAdc = turbidityADC;
+  t.kontrolAktif = p.kontrolAktif;
+  t.outKeruh = outKeruh;
+  t.pwmKeruh = pwmKeruh;
+  t.errorKeruh = errorKeruh;
+  t.setpointKeruh = p.turbiditySetpoint;
+  t.feedforwardActive = (fabsf(errorKeruh) < 3.0f && turbidityPersen > p.keruhMati);
+  t.bayangan = p.modeBayangan;
+  t.lewatAnggaranBayangan = st.lewatAnggaranBayangan;
+}
+
+void tickKontrol(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+                 const AturanFuzzy &af) {
+  tickSuhu(hal, sensor, p, st, t, af);
+  tickKeruh(hal, sensor, p, st, t, af);
+}
+
+// Umur stempel saat kirim (us); null jika tahap belum pernah terjadi
+static int tulisUmur(char *buf, size_t len, bool koma, const char *kunci, const TitikWaktu &w, uint32_t stempelUs) {
+  if (stempelUs == 0) return snprintf(buf, len, "%s\"%s\":null", koma ? "," : "", kunci);
+  return snprintf(buf, len, "%s\"%s\":%lu", koma ? "," : "", kunci, (unsigned long)w.umurUs(stempelUs));
+}
+
+// ,"waktu":{"kirim_ms":..,"umur_us":{..}}} menimpa '}' penutup di buf[n - 1]
+static size_t tulisWaktu(const Telemetri &t, const TitikWaktu &w, char *buf, size_t len, size_t n) {
+  n--;
+  int m;
+  if (w.sinkron()) {
+    // ms UTC dengan pecahan us (double tidak cukup presisi untuk us sejak 1970)
+    m = snprintf(buf + n, len - n, ",\"waktu\":{\"kirim_ms\":%llu.%03u,\"umur_us\":{",
+                 (unsigned long long)(w.epochUs / 1000ULL), (unsigned)(w.epochUs % 1000ULL));
+  } else {
+    m = snprintf(buf + n, len - n, ",\"waktu\":{\"kirim_ms\":null,\"umur_us\":{");
+  }
+  if (m < 0 || n + m >= len) return 0;
+  n += m;
+  const char *const KUNCI[] = {"sampel_suhu", "hitung_suhu", "aktuasi_suhu", "sampel_keruh", "hitung_keruh",
+                               "aktuasi_keruh"};
+  const uint32_t stempel[] = {t.stempelSuhu.sampelUs, t.stempelSuhu.hitungUs, t.stempelSuhu.aktuasiUs,
+                              t.stempelKeruh.sampelUs, t.stempelKeruh.hitungUs, t.stempelKeruh.aktuasiUs};
+  for (int i = 0; i < 6; i++) {
+    m = tulisUmur(buf + n, len - n, i > 0, KUNCI[i], w, stempel[i]);
+    if (m < 0 || n + m >= len) return 0;
+    n += m;
+  }
+  m = snprintf(buf + n, len - n, "}}}");
+  if (m < 0 || n + m >= len) return 0;
+  return n + m;
+}
+
+size_t serializeTelemetri(const Telemetri &t, char *buf, size_t len, const TitikWaktu *kirim) {
+  // Nama key sama dengan payload lama (StaticJsonDocument) agar dashboard tidak berubah
+  int n = snprintf(buf, len,
+    "{\"timestamp_ms\":%lu,\"suhu\":%.2f,\"turbidity_persen\":%.2f,\"turbidity_adc\":%d,"
+    "\"kontrol_aktif\":\"%s\",\"pwm_heater\":%.2f,\"pwm_pompa\":%.2f,"
+    "\"error_suhu\":%.3f,\"error_keruh\":%.3f,\"setpoint_suhu\":%.2f,\"setpoint_keruh\":%.2f,"
+    "\"feedforward_active\":%s}",
+    t.timestamp_ms, t.suhu, t.turbidityPersen, t.turbidityAdc,
+    namaMode(t.kontrolAktif), t.outSuhu, t.outKeruh,
+    t.errorSuhu, t.errorKeruh, t.setpointSuhu, t.setpointKeruh,
+    t.feedforwardActive ? "true" : "false");
+  if (n < 0 || (size_t)n >= len) return 0;
+  if (!t.bayangan) return kirim ? tulisWaktu(t, *kirim, buf, len, (size_t)n) : (size_t)n;
+
+  // Mode bayangan: sisipkan sebelum '}' penutup
+  const Bayangan &s = t.bayanganSuhu, &k = t.bayanganKeruh;
+  int m = snprintf(buf + n - 1, len - n + 1,
+    ",\"bayangan\":{\"suhu\":{\"fuzzy\":%.2f,\"pid\":%.2f,\"us_fuzzy\":%.2f,\"us_pid\":%.2f},"
+    "\"keruh\":{\"fuzzy\":%.2f,\"pid\":%.2f,\"us_fuzzy\":%.2f,\"us_pid\":%.2f},\"lewat_anggaran\":%lu}}",
+    s.fuzzy, s.pid, s.usFuzzy, s.usPid, k.fuzzy, k.pid, k.usFuzzy, k.usPid,
+    (unsigned long)t.lewatAnggaranBayangan);
+  if (m < 0 || (size_t)(n - 1 + m) >= len) return 0;
+  return kirim ? tulisWaktu(t, *kirim, buf, len, (size_t)(n - 1 + m)) : (size_t)(n - 1 + m);
+}
+
+bool kirimTelemetri(Hal &hal, const char *topic, const Telemetri &t) {
+  if (!hal.mqtt->connected()) return false;
+  char buffer[768];
+  {
+    PROFIL_LINGKUP(hal, PROFIL_SERIALIZE);
+    const TitikWaktu kirim = TitikWaktu::sekarang(*hal.clock);
+    if (serializeTelemetri(t, buffer, sizeof(buffer), &kirim) == 0) return false;
+  }
+  PROFIL_LINGKUP(hal, PROFIL_PUBLISH);
+  return hal.mqtt->publish(topic, buffer, false);
+}
@@ -0,0 +1,80 @@
+/**
+ * SATU SIKLUS KONTROL: sense -> compute -> actuate -> serialize.
+ * Dipanggil dari task kontrol firmware dan dari benchmark native.
+ * tickSuhu & tickKeruh bisa dijadwalkan dengan periode masing-masing
+ * (lihat Penjadwal.h); tickKontrol = keduanya sekaligus.
+ * Mode bayangan (ParameterKontrol::modeBayangan): Fuzzy & PID dihitung tiap
+ * tick, output & waktu hitung keduanya masuk telemetri; gabungan kedua kernel
+ * per tick dibandingkan dengan ANGGARAN_BAYANGAN_US (jumlah pelanggaran di
+ * StateKontrol::lewatAnggaranBayangan). Anggaran berlaku sebagai persentil
+ * 99.9, bukan maksimum: interupsi / preemption sesekali boleh melewatinya,
+ * asal <= 1 dari 1000 tick (dicek tools/bench).
+ * Stempel tahap (micros) tiap loop: sampel sensor -> selesai hitung ->
+ * duty tertulis; serializeTelemetri mengubahnya ke umur relatif saat kirim
+ * plus waktu kirim UTC (JamDinding.h), untuk laporan latensi di host.
+ */
+
+#ifndef AQUARIUM_TICK_H
+#define AQUARIUM_TICK_H
+
+#include <stddef.h>
+#include "AutotuneRelay.h"
+#include "Hal.h"
+#include "JamDinding.h"
+#include "KalibrasiAktuator.h"
+#include "Kontrol.h"
+#include "Sensor.h"
+
+// Periode & fasa loop kontrol (ms); sama di firmware & simulator (tools/sim).
+// Fasa digeser supaya loop tidak jatuh di tick yang sama.
+const uint32_t PERIODE_SAMPEL_MS = 2;         // < 1/TURBIDITY_SPS
+const uint32_t PERIODE_SUHU_MS = 1000;        // plant termal lambat
+const uint32_t PERIODE_KERUH_MS = 250;        // loop pompa lebih cepat
+const uint32_t FASA_SUHU_MS = 0, FASA_KERUH_MS = 1;
+
+// Anggaran waktu Fuzzy + PID satu loop di mode bayangan (tick kontrol 1 ms), persentil 99.9
+#ifndef ANGGARAN_BAYANGAN_US
+#define ANGGARAN_BAYANGAN_US 50.0f
+#endif
+
+// Output & waktu hitung kedua kontroler satu loop (mode bayangan)
+struct Bayangan {
+  float fuzzy, pid;       // 0-100%
+  float usFuzzy, usPid;   // waktu hitung kernel
+};
+
+// Ringkasan satu siklus (isi payload telemetri & debug serial)
+struct Telemetri {
+  unsigned long timestamp_ms;
+  float suhu;
+  float turbidityPersen;
+  int turbidityAdc;
+  ControlMode kontrolAktif;
+  double outSuhu, outKeruh;   // 0-100%
+  int pwmSuhu, pwmKeruh;      // duty LEDC 0-PWM_DUTY_MAKS (setelah linearisasi)
+  float errorSuhu, errorKeruh;
+  float setpointSuhu, setpointKeruh;
+  bool feedforwardActive;
+  bool bayangan;                         // bayanganSuhu/Keruh terisi
+  Bayangan bayanganSuhu, bayanganKeruh;
+  uint32_t lewatAnggaranBayangan;
+  StempelTahap stempelSuhu, stempelKeruh;
+};
+
+// Tiap tick hanya mengisi bagian Telemetri milik loop-nya. Jika kal sedang
+// mengkalibrasi aktuator loop ini, duty uji kal yang ditulis (output
+// kontroler tetap dihitung, telemetri out = duty uji). Begitu juga output
+// relay jika tune sedang menala loop ini (lewat kurva aktuator).
+void tickSuhu(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+              const AturanFuzzy &af = aturanFuzzy, KalibrasiAktuator *kal = nullptr, AutotuneRelay *tune = nullptr);
+void tickKeruh(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+               const AturanFuzzy &af = aturanFuzzy, KalibrasiAktuator *kal = nullptr, AutotuneRelay *tune = nullptr);
+void tickKontrol(Hal &hal, SensorAquarium &sensor, const ParameterKontrol &p, StateKontrol &st, Telemetri &t,
+                 const AturanFuzzy &af = aturanFuzzy);
+
+// Tulis JSON telemetri ke buf, return panjang (0 jika buf kurang).
+// kirim != nullptr -> tambah "waktu": kirim_ms UTC (jika sinkron) & umur tiap stempel
+size_t serializeTelemetri(const Telemetri &t, char *buf, size_t len, const TitikWaktu *kirim = nullptr);
+bool kirimTelemetri(Hal &hal, const char *topic, const Telemetri &t);
+
+#endif
@@ -0,0 +1,27 @@
+#include "TopikPerangkat.h"
+#include <stdio.h>
+#include <string.h>
+
+const char *const NAMA_TOPIK[JUMLAH_TOPIK] = {
+  "data", "mode", "jadwal", "batch", "status", "perintah", "kirim", "koneksi", "profil", "aktuator", "gema", "autotune",
+};
+
+void idDariMac(const uint8_t mac[6], char *buf, size_t len) {
+  snprintf(buf, len, "aq-%02x%02x%02x%02x%02x%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+bool TopikPerangkat::mulai(const char *prefix, const char *idPerangkat) {
+  memset(this, 0, sizeof(*this));
+  const size_t n = strlen(idPerangkat);
+  if (n == 0 || n >= sizeof(id) || strpbrk(idPerangkat, "/+#") != nullptr) return false;
+  memcpy(id, idPerangkat, n + 1);
+
+  for (int j = 0; j < JUMLAH_TOPIK; j++) {
+    const int m = snprintf(topik[j], sizeof(topik[j]), "%s/%s/%s", prefix, id, NAMA_TOPIK[j]);
+    if (m < 0 || (size_t)m >= sizeof(topik[j])) return false;
+  }
+  const int d = snprintf(dasar, sizeof(dasar), "%s/%s", prefix, id);
+  if (d < 0 || (size_t)d >= sizeof(dasar)) return false;
+  const int m = snprintf(modeSemua, sizeof(modeSemua), "%s/%s", prefix, NAMA_TOPIK[TOPIK_MODE]);
+  return m > 0 && (size_t)m < sizeof(modeSemua);
+}
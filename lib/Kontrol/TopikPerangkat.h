@@ -0,0 +1,64 @@
+/**
+ * ID PERANGKAT & NAMESPACE TOPIK MQTT
+ * * Deskripsi:
+ * Banyak akuarium berbagi satu broker: tiap perangkat punya client ID dan
+ * cabang topik sendiri, <prefix>/<id>/<nama> (mis.
+ * unhas/informatika/aquarium/aq-a1b2c3d4e5f6/data).
+ * - ID default "aq-" + MAC 12 hex (unik per chip, tetap setelah flash
+ *   ulang); -DMQTT_ID_PERANGKAT="\"tangki-01\"" memberi nama sendiri.
+ * - Perintah: perangkat berlangganan <prefix>/<id>/mode (satu perangkat)
+ *   dan <prefix>/mode (siaran ke semua perangkat, topik lama).
+ * - Backend berlangganan <prefix>/+/<nama> dan mengambil id dari topik.
+ * - Bank multi-tangki: kanal k > 0 di <prefix>/<id>/<k>/<nama>
+ *   (BankKontrol.h topikKanal); backend menyimpannya sebagai perangkat "<id>/<k>".
+ * Diisi sekali saat setup, sesudahnya hanya dibaca (aman lintas core).
+ */
+
+#ifndef AQUARIUM_TOPIK_PERANGKAT_H
+#define AQUARIUM_TOPIK_PERANGKAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef MQTT_PREFIX
+#define MQTT_PREFIX "unhas/informatika/aquarium"
+#endif
+
+const size_t ID_PERANGKAT_MAKS = 32;   // termasuk '\0'
+const size_t TOPIK_MAKS = 96;
+
+enum JenisTopik : uint8_t {
+  TOPIK_DATA = 0,
+  TOPIK_MODE,
+  TOPIK_JADWAL,
+  TOPIK_BATCH,
+  TOPIK_STATUS,
+  TOPIK_PERINTAH,
+  TOPIK_KIRIM,
+  TOPIK_KONEKSI,
+  TOPIK_PROFIL,
+  TOPIK_AKTUATOR,
+  TOPIK_GEMA,
+  TOPIK_AUTOTUNE,
+  JUMLAH_TOPIK,
+};
+
+// Nama daun topik ("data", "mode", ...)
+extern const char *const NAMA_TOPIK[JUMLAH_TOPIK];
+
+// "aq-" + 12 hex dari 6 byte MAC (urutan byte seperti tercetak di stiker)
+void idDariMac(const uint8_t mac[6], char *buf, size_t len);
+
+struct TopikPerangkat {
+  char id[ID_PERANGKAT_MAKS];
+  char topik[JUMLAH_TOPIK][TOPIK_MAKS];
+  char modeSemua[TOPIK_MAKS];            // <prefix>/mode
+  char dasar[TOPIK_MAKS];                // <prefix>/<id> (dasar topikKanal BankKontrol)
+
+  // false jika id kosong / mengandung '/', '+', '#' / topik terpotong
+  bool mulai(const char *prefix, const char *idPerangkat);
+  const char *operator[](JenisTopik j) const { return topik[j]; }
+  const char *clientId() const { return id; }
+};
+
+#endif
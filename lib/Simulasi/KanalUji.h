@@ -0,0 +1,58 @@
+/**
+ * KANAL UJI BANK KONTROL (NATIVE)
+ * * Deskripsi:
+ * Beban bersama tools/bench (biaya SoA vs AoS) dan test/test_kontrol
+ * (kesetaraan bit-per-bit BankKontrol vs jalur satu tangki).
+ * - parameterKanal(k): mode, mesin fuzzy, setpoint & gain berbeda tiap kanal.
+ * - TangkiAos + hitungAos: jalur satu tangki per kanal (isi sama dengan
+ *   tickSuhu/tickKeruh tanpa HAL, termasuk linearisasi aktuator).
+ * - suhuUji / adcUji: input deterministik, sesekali gagal baca DS18B20.
+ */
+
+#ifndef AQUARIUM_KANAL_UJI_H
+#define AQUARIUM_KANAL_UJI_H
+
+#ifndef ARDUINO
+
+#include "Aktuator.h"
+#include "Kontrol.h"
+#include "Sensor.h"
+
+inline ParameterKontrol parameterKanal(int k) {
+  ParameterKontrol p;
+  p.kontrolAktif = (ControlMode)(k % 3);
+  p.mesinFuzzySuhu = (MesinFuzzy)((k / 2) % 3);
+  p.mesinFuzzyKeruh = (MesinFuzzy)((k / 2) % 2);
+  p.suhuSetpoint = 26.0f + 0.5f * (k % 7);
+  p.turbiditySetpoint = 12.0f + (float)(k % 5);
+  p.Kp_suhu = 6.0f + 0.25f * (k % 9);
+  p.Kp_keruh = 4.0f + 0.5f * (k % 4);
+  p.keruhTahan = p.turbiditySetpoint - 4.0f;
+  p.keruhMati = p.turbiditySetpoint - 6.0f;
+  return p;
+}
+
+struct TangkiAos {
+  ParameterKontrol p;
+  StateKontrol st;
+};
+
+inline void hitungAos(TangkiAos &t, float suhuMentah, int adc, unsigned long now, double &outS, double &outK,
+                      int &pwmS, int &pwmK) {
+  float suhuAktual = filterSuhu(t.st.suhuTerfilter, suhuMentah);
+  outS = hitungKontrolSuhu(t.st, t.p, t.p.suhuSetpoint - suhuAktual, now);
+  pwmS = kuantisasiDuty(dutyLinear(t.p.kurvaHeater, (float)outS), t.p.ditherHeater ? &t.st.sisaDitherHeater : nullptr);
+  float persen = konversiTurbidityKePersen(adc, t.p);
+  outK = hitungKontrolKeruh(t.st, t.p, persen - t.p.turbiditySetpoint, persen, now);
+  pwmK = kuantisasiDuty(dutyLinear(t.p.kurvaPompa, (float)outK), nullptr);
+}
+
+inline float suhuUji(int k, int i) {
+  if ((i + k) % 53 == 0) return -127.0f;   // gagal baca sesekali
+  return 24.0f + 0.07f * (float)((i * 7 + k * 13) % 101);
+}
+
+inline int adcUji(int k, int i) { return 3000 + ((i * 131 + k * 977) % 18000); }
+
+#endif
+#endif
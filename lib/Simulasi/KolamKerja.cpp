@@ -0,0 +1,94 @@
+#ifndef ARDUINO
+
+#include "KolamKerja.h"
+
+KolamKerja::KolamKerja(int jumlahThread) {
+  if (jumlahThread < 1) jumlahThread = 1;
+  for (int i = 0; i < jumlahThread; i++) antrian.emplace_back(new Antrian());
+  for (int i = 1; i < jumlahThread; i++) pekerja.emplace_back(&KolamKerja::loopPekerja, this, i);
+}
+
+KolamKerja::~KolamKerja() {
+  {
+    std::lock_guard<std::mutex> kunci(mKoordinasi);
+    berhenti = true;
+  }
+  cvMulai.notify_all();
+  for (auto &t : pekerja) t.join();
+}
+
+void KolamKerja::paralel(size_t n, const Tugas &fn) {
+  if (n == 0) return;
+
+  // Tugas & hitungan dipasang sebelum indeks masuk antrian: pekerja yang
+  // masih berkeliling dari batch lalu langsung melihat tugas yang benar
+  tugas.store(&fn, std::memory_order_release);
+  sisa.store(n, std::memory_order_release);
+
+  const size_t t = antrian.size();
+  for (size_t a = 0; a < t; a++) {
+    std::lock_guard<std::mutex> kunci(antrian[a]->m);
+    for (size_t i = a * n / t; i < (a + 1) * n / t; i++) antrian[a]->isi.push_back(i);
+  }
+
+  {
+    std::lock_guard<std::mutex> kunci(mKoordinasi);
+    generasi++;
+  }
+  cvMulai.notify_all();
+
+  kerjakan(0);
+
+  std::unique_lock<std::mutex> kunci(mKoordinasi);
+  cvSelesai.wait(kunci, [this] { return sisa.load(std::memory_order_acquire) == 0; });
+}
+
+bool KolamKerja::ambil(int id, size_t &idx) {
+  {
+    Antrian &milik = *antrian[id];
+    std::lock_guard<std::mutex> kunci(milik.m);
+    if (!milik.isi.empty()) {
+      idx = milik.isi.back();
+      milik.isi.pop_back();
+      return true;
+    }
+  }
+  const int t = (int)antrian.size();
+  for (int k = 1; k < t; k++) {
+    Antrian &korban = *antrian[(id + k) % t];
+    std::lock_guard<std::mutex> kunci(korban.m);
+    if (!korban.isi.empty()) {
+      idx = korban.isi.front();
+      korban.isi.pop_front();
+      curian.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void KolamKerja::kerjakan(int id) {
+  size_t idx;
+  while (ambil(id, idx)) {
+    (*tugas.load(std::memory_order_acquire))(idx);
+    if (sisa.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      std::lock_guard<std::mutex> kunci(mKoordinasi);
+      cvSelesai.notify_all();
+    }
+  }
+}
+
+void KolamKerja::loopPekerja(int id) {
+  uint64_t dilihat = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> kunci(mKoordinasi);
+      cvMulai.wait(kunci, [&] { return berhenti || generasi != dilihat; });
+      if (berhenti) return;
+      dilihat = generasi;
+    }
+    kerjakan(id);
+  }
+}
+
+#endif
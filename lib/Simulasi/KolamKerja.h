@@ -0,0 +1,65 @@
+/**
+ * KOLAM THREAD WORK-STEALING (NATIVE)
+ * * Deskripsi:
+ * Menjalankan fn(i), i = 0..n-1, di semua thread lalu menunggu selesai.
+ * - Indeks dibagi per blok ke antrian milik tiap pekerja. Pekerja mengambil
+ *   dari ujung belakang antriannya sendiri; jika kosong, mencuri dari ujung
+ *   depan antrian pekerja lain. Simulasi yang durasinya beda jauh (skenario
+ *   48 jam vs 12 jam) jadi tetap rata tanpa pembagian manual.
+ * - Thread pemanggil ikut bekerja sebagai pekerja 0; thread lain dibuat
+ *   sekali dan tidur di antara batch.
+ * - Satu batch pada satu waktu (paralel() tidak boleh dipanggil dari fn).
+ */
+
+#ifndef AQUARIUM_KOLAM_KERJA_H
+#define AQUARIUM_KOLAM_KERJA_H
+
+#ifndef ARDUINO
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class KolamKerja {
+public:
+  typedef std::function<void(size_t)> Tugas;
+
+  explicit KolamKerja(int jumlahThread);
+  ~KolamKerja();
+
+  void paralel(size_t n, const Tugas &fn);
+
+  int jumlahThread() const { return (int)antrian.size(); }
+  uint64_t jumlahCurian() const { return curian.load(std::memory_order_relaxed); }
+
+private:
+  struct Antrian {
+    std::mutex m;
+    std::deque<size_t> isi;
+  };
+
+  bool ambil(int id, size_t &idx);
+  void kerjakan(int id);
+  void loopPekerja(int id);
+
+  std::vector<std::unique_ptr<Antrian>> antrian;
+  std::vector<std::thread> pekerja;
+  std::atomic<const Tugas *> tugas{nullptr};
+  std::atomic<size_t> sisa{0};
+  std::atomic<uint64_t> curian{0};
+
+  std::mutex mKoordinasi;
+  std::condition_variable cvMulai, cvSelesai;
+  uint64_t generasi = 0;
+  bool berhenti = false;
+};
+
+#endif
+#endif
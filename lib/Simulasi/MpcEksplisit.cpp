@@ -0,0 +1,510 @@
+#ifndef ARDUINO
+
+#include "MpcEksplisit.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include "Sensor.h"
+#include "Tick.h"
+
+namespace {
+
+// Fungsi affine parameter: v = e * E + h * Hh + c
+struct Affine {
+  double e = 0.0, h = 0.0, c = 0.0;
+};
+
+struct Titik {
+  double e, h;
+};
+
+typedef std::vector<Titik> Poligon;
+
+// Potong poligon konveks dengan ae*e + ah*h <= b (Sutherland-Hodgman satu bidang)
+Poligon potong(const Poligon &p, double ae, double ah, double b) {
+  Poligon out;
+  const size_t n = p.size();
+  for (size_t i = 0; i < n; i++) {
+    const Titik &s = p[i], &t = p[(i + 1) % n];
+    const double ds = ae * s.e + ah * s.h - b, dt = ae * t.e + ah * t.h - b;
+    if (ds <= 0) out.push_back(s);
+    if ((ds < 0 && dt > 0) || (ds > 0 && dt < 0)) {
+      const double f = ds / (ds - dt);
+      out.push_back({s.e + f * (t.e - s.e), s.h + f * (t.h - s.h)});
+    }
+  }
+  return out;
+}
+
+double luas(const Poligon &p) {
+  double a = 0.0;
+  for (size_t i = 0; i < p.size(); i++) {
+    const Titik &s = p[i], &t = p[(i + 1) % p.size()];
+    a += s.e * t.h - t.e * s.h;
+  }
+  return fabs(a) * 0.5;
+}
+
+Poligon kotak(double e0, double e1, double h0, double h1) {
+  return {{e0, h0}, {e1, h0}, {e1, h1}, {e0, h1}};
+}
+
+// Eliminasi Gauss dengan pivot parsial; A (m x m) dirusak, x = A^-1 rhs untuk 3 kolom
+bool selesaikan(double A[MPC_HORIZON_MAKS][MPC_HORIZON_MAKS], Affine rhs[MPC_HORIZON_MAKS], int m) {
+  for (int k = 0; k < m; k++) {
+    int piv = k;
+    for (int i = k + 1; i < m; i++)
+      if (fabs(A[i][k]) > fabs(A[piv][k])) piv = i;
+    if (fabs(A[piv][k]) < 1e-300) return false;
+    if (piv != k) {
+      for (int j = 0; j < m; j++) std::swap(A[k][j], A[piv][j]);
+      std::swap(rhs[k], rhs[piv]);
+    }
+    for (int i = k + 1; i < m; i++) {
+      const double f = A[i][k] / A[k][k];
+      for (int j = k; j < m; j++) A[i][j] -= f * A[k][j];
+      rhs[i].e -= f * rhs[k].e;
+      rhs[i].h -= f * rhs[k].h;
+      rhs[i].c -= f * rhs[k].c;
+    }
+  }
+  for (int k = m - 1; k >= 0; k--) {
+    for (int j = k + 1; j < m; j++) {
+      rhs[k].e -= A[k][j] * rhs[j].e;
+      rhs[k].h -= A[k][j] * rhs[j].h;
+      rhs[k].c -= A[k][j] * rhs[j].c;
+    }
+    rhs[k].e /= A[k][k];
+    rhs[k].h /= A[k][k];
+    rhs[k].c /= A[k][k];
+  }
+  return true;
+}
+
+struct BidangGanda {
+  double ae, ah, b;
+};
+
+struct WilayahMentah {
+  Poligon poligon;
+  std::vector<BidangMpc> bidang;
+  Affine u0;
+  int hukum;
+};
+
+bool hukumSama(const HukumMpc &x, const Affine &y) {
+  return fabs(x.ke - y.e) <= 1e-5 * (1.0 + fabs(y.e)) && fabs(x.kh - y.h) <= 1e-5 * (1.0 + fabs(y.h)) &&
+         fabs(x.c - y.c) <= 1e-4 * (1.0 + fabs(y.c));
+}
+
+// Literal float C++ yang sah & presisi penuh ("1.0f", bukan "1f")
+const char *literal(char *buf, size_t len, float x) {
+  int n = snprintf(buf, len, "%.9g", x);
+  if (!strpbrk(buf, ".e")) n += snprintf(buf + n, len - n, ".0");
+  snprintf(buf + n, len - n, "f");
+  return buf;
+}
+
+}  // namespace
+
+bool GeneratorMpc::bangun(const ParameterPlant &p, const SpesifikasiMpc &s) {
+  plant = p;
+  spek = s;
+  stat = StatistikMpc();
+  hukum.clear();
+  bidang.clear();
+  wilayah.clear();
+  sel.clear();
+  kandidat.clear();
+  n = s.horizon;
+  if (n < 1 || n > MPC_HORIZON_MAKS || s.selE < 1 || s.selH < 1 || s.selE * s.selH > 4096 || !(s.eMax > s.eMin)) {
+    pesanGalat = "spesifikasi di luar batas (horizon 1-12, sel <= 4096)";
+    return false;
+  }
+
+  // --- Model: watt per % = kemiringan kuadrat terkecil kurva heater lewat nol ---
+  double sxy = 0.0, sxx = 0.0;
+  for (int i = 0; i < PLANT_KURVA_HEATER_N; i++) {
+    const double x = p.kurvaDuty[i] * 100.0 / 255.0;
+    sxy += x * p.kurvaWatt[i];
+    sxx += x * x;
+  }
+  const double wattPerPersen = sxy / sxx;
+  const double tau = p.kapasitasPanas / p.ua;
+  const double g = wattPerPersen / p.ua;   // C per % (tunak)
+  a = exp(-s.tsDetik / tau);
+  b = (1.0 - a) * g;
+  const double q = s.bobotError, r = s.bobotInput;
+
+  // Bobot akhir = Riccati skalar tak berhingga (hukum bebas batasan = LQR)
+  double P = q;
+  for (int i = 0; i < 1000000; i++) {
+    const double baru = q + a * a * P - (a * b * P) * (a * b * P) / (r + b * b * P);
+    if (fabs(baru - P) <= 1e-12 * baru) {
+      P = baru;
+      break;
+    }
+    P = baru;
+  }
+  stat.gainTakTerbatas = a * b * P / (r + b * b * P);
+
+  // --- QP padat: e_k = a^k e0 - sum_j b a^(k-1-j) z_j ---
+  memset(H, 0, sizeof(H));
+  memset(Fe, 0, sizeof(Fe));
+  for (int k = 1; k <= n; k++) {
+    const double w = (k == n) ? P : q;
+    double gam[MPC_HORIZON_MAKS];
+    for (int j = 0; j < n; j++) gam[j] = (j < k) ? b * pow(a, k - 1 - j) : 0.0;
+    for (int i = 0; i < n; i++) {
+      Fe[i] -= w * pow(a, k) * gam[i];
+      for (int j = 0; j < n; j++) H[i][j] += w * gam[i] * gam[j];
+    }
+  }
+  for (int i = 0; i < n; i++) H[i][i] += r;
+
+  // --- Enumerasi himpunan aktif ---
+  const double hMin = 0.0, hMax = 100.0;
+  const Poligon kotakParam = kotak(s.eMin, s.eMax, hMin, hMax);
+  const double luasMin = 1e-9 * luas(kotakParam);
+  std::vector<WilayahMentah> mentah;
+  uint32_t jumlahKombinasi = 1;
+  for (int i = 0; i < n; i++) jumlahKombinasi *= 3;
+  stat.himpunanAktif = jumlahKombinasi;
+
+  for (uint32_t kode = 0; kode < jumlahKombinasi; kode++) {
+    int status[MPC_HORIZON_MAKS];   // 0 bebas, 1 batas bawah (u = 0), 2 batas atas (u = 100)
+    int bebas[MPC_HORIZON_MAKS], m = 0;
+    for (uint32_t i = 0, k = kode; i < (uint32_t)n; i++, k /= 3) {
+      status[i] = (int)(k % 3);
+      if (status[i] == 0) bebas[m++] = (int)i;
+    }
+    // z = u - h: z_A di batas, z_F = -H_FF^-1 (H_FA z_A + Fe_F e)
+    Affine z[MPC_HORIZON_MAKS];
+    for (int i = 0; i < n; i++)
+      if (status[i] != 0) z[i] = {0.0, -1.0, status[i] == 2 ? 100.0 : 0.0};
+    if (m > 0) {
+      double A[MPC_HORIZON_MAKS][MPC_HORIZON_MAKS];
+      Affine rhs[MPC_HORIZON_MAKS];
+      for (int i = 0; i < m; i++) {
+        const int fi = bebas[i];
+        for (int j = 0; j < m; j++) A[i][j] = H[fi][bebas[j]];
+        Affine v;
+        v.e = -Fe[fi];
+        for (int j = 0; j < n; j++) {
+          if (status[j] == 0) continue;
+          v.e -= H[fi][j] * z[j].e;
+          v.h -= H[fi][j] * z[j].h;
+          v.c -= H[fi][j] * z[j].c;
+        }
+        rhs[i] = v;
+      }
+      if (!selesaikan(A, rhs, m)) continue;
+      for (int i = 0; i < m; i++) z[bebas[i]] = rhs[i];
+    }
+
+    // Syarat wilayah sebagai E(theta) <= 0
+    Poligon poli = kotakParam;
+    std::vector<BidangGanda> syarat;
+    bool kosong = false;
+    for (int i = 0; i < n && !kosong; i++) {
+      Affine E;
+      if (status[i] == 0) {
+        for (int sisi = 0; sisi < 2 && !kosong; sisi++) {
+          // bawah: -(z + h) <= 0 ; atas: z + h - 100 <= 0
+          E = (sisi == 0) ? Affine{-z[i].e, -z[i].h - 1.0, -z[i].c} : Affine{z[i].e, z[i].h + 1.0, z[i].c - 100.0};
+          const double nrm = sqrt(E.e * E.e + E.h * E.h);
+          if (nrm < 1e-12) {
+            kosong = E.c > 1e-9;
+            continue;
+          }
+          syarat.push_back({E.e / nrm, E.h / nrm, -E.c / nrm});
+          poli = potong(poli, E.e / nrm, E.h / nrm, -E.c / nrm);
+          kosong = poli.size() < 3 || luas(poli) <= luasMin;
+        }
+      } else {
+        // Pengali: batas bawah aktif -> gradien >= 0, batas atas -> gradien <= 0
+        Affine gr;
+        gr.e = Fe[i];
+        for (int j = 0; j < n; j++) {
+          gr.e += H[i][j] * z[j].e;
+          gr.h += H[i][j] * z[j].h;
+          gr.c += H[i][j] * z[j].c;
+        }
+        E = (status[i] == 1) ? Affine{-gr.e, -gr.h, -gr.c} : gr;
+        const double nrm = sqrt(E.e * E.e + E.h * E.h);
+        if (nrm < 1e-12) {
+          kosong = E.c > 1e-9;
+          continue;
+        }
+        syarat.push_back({E.e / nrm, E.h / nrm, -E.c / nrm});
+        poli = potong(poli, E.e / nrm, E.h / nrm, -E.c / nrm);
+        kosong = poli.size() < 3 || luas(poli) <= luasMin;
+      }
+    }
+    if (kosong) continue;
+
+    // Simpan hanya bidang yang menjadi sisi poligon di dalam kotak (sisi kotak tidak perlu: input di-clamp)
+    WilayahMentah w;
+    w.poligon = poli;
+    w.u0 = {z[0].e, z[0].h + 1.0, z[0].c};
+    const double tol = 1e-9 * (s.eMax - s.eMin + hMax);
+    std::vector<bool> dipakai(syarat.size(), false);
+    for (size_t i = 0; i < poli.size(); i++) {
+      const Titik &v0 = poli[i], &v1 = poli[(i + 1) % poli.size()];
+      const Titik mid = {(v0.e + v1.e) * 0.5, (v0.h + v1.h) * 0.5};
+      if (mid.e <= s.eMin + tol || mid.e >= s.eMax - tol || mid.h <= hMin + tol || mid.h >= hMax - tol) continue;
+      for (size_t k = 0; k < syarat.size(); k++) {
+        const BidangGanda &bd = syarat[k];
+        if (fabs(bd.ae * v0.e + bd.ah * v0.h - bd.b) <= tol && fabs(bd.ae * v1.e + bd.ah * v1.h - bd.b) <= tol) {
+          dipakai[k] = true;
+          break;
+        }
+      }
+    }
+    for (size_t k = 0; k < syarat.size(); k++)
+      if (dipakai[k]) w.bidang.push_back({(float)syarat[k].ae, (float)syarat[k].ah, (float)syarat[k].b});
+    w.hukum = -1;
+    for (size_t k = 0; k < hukum.size() && w.hukum < 0; k++)
+      if (hukumSama(hukum[k], w.u0)) w.hukum = (int)k;
+    if (w.hukum < 0) {
+      w.hukum = (int)hukum.size();
+      hukum.push_back({(float)w.u0.e, (float)w.u0.h, (float)w.u0.c});
+    }
+    mentah.push_back(w);
+  }
+  if (mentah.empty()) {
+    pesanGalat = "tidak ada wilayah (QP tidak layak?)";
+    return false;
+  }
+  if (mentah.size() > 255 || hukum.size() > 255) {
+    pesanGalat = "wilayah / hukum > 255: kecilkan horizon";
+    return false;
+  }
+  for (const WilayahMentah &w : mentah) {
+    wilayah.push_back({(uint16_t)bidang.size(), (uint8_t)w.bidang.size(), (uint8_t)w.hukum});
+    bidang.insert(bidang.end(), w.bidang.begin(), w.bidang.end());
+  }
+
+  // --- Grid point location ---
+  const double lebarE = (s.eMax - s.eMin) / s.selE, lebarH = (hMax - hMin) / s.selH;
+  std::map<std::vector<uint8_t>, uint16_t> daftarSama;
+  uint8_t maksKandidat = 0, maksBidang = 0;
+  for (int j = 0; j < s.selH; j++) {
+    for (int i = 0; i < s.selE; i++) {
+      const double e0 = s.eMin + i * lebarE, h0 = hMin + j * lebarH;
+      const Poligon rect = kotak(e0, e0 + lebarE, h0, h0 + lebarH);
+      std::vector<std::pair<double, int>> kena;   // (luas potongan, wilayah)
+      for (size_t w = 0; w < mentah.size(); w++) {
+        Poligon pp = rect;
+        const Poligon &wp = mentah[w].poligon;
+        // Potong sel dengan setiap sisi poligon wilayah (konveks, berlawanan jarum jam atau searah)
+        double arah = 0.0;
+        for (size_t k = 0; k < wp.size(); k++) {
+          const Titik &s0 = wp[k], &s1 = wp[(k + 1) % wp.size()];
+          arah += s0.e * s1.h - s1.e * s0.h;
+        }
+        for (size_t k = 0; k < wp.size() && pp.size() >= 3; k++) {
+          const Titik &s0 = wp[k], &s1 = wp[(k + 1) % wp.size()];
+          // Bagian dalam di kiri sisi jika berlawanan jarum jam
+          double ae = (s1.h - s0.h), ah = -(s1.e - s0.e);
+          if (arah < 0) ae = -ae, ah = -ah;
+          pp = potong(pp, ae, ah, ae * s0.e + ah * s0.h);
+        }
+        if (pp.size() >= 3) {
+          const double l = luas(pp);
+          if (l > 1e-9 * lebarE * lebarH) kena.push_back({l, (int)w});
+        }
+      }
+      std::sort(kena.begin(), kena.end(), [](const std::pair<double, int> &x, const std::pair<double, int> &y) {
+        return x.first > y.first;
+      });
+      // Hukum default = yang wilayahnya paling banyak di sel (paling sedikit uji), seri -> paling luas
+      std::map<int, std::pair<int, double>> perHukum;
+      for (const auto &k : kena) {
+        auto &v = perHukum[mentah[k.second].hukum];
+        v.first++;
+        v.second += k.first;
+      }
+      int hDefault = -1;
+      std::pair<int, double> terbaik(-1, 0.0);
+      for (const auto &v : perHukum)
+        if (v.second.first > terbaik.first || (v.second.first == terbaik.first && v.second.second > terbaik.second)) {
+          terbaik = v.second;
+          hDefault = v.first;
+        }
+      if (perHukum.size() == 1) {
+        sel.push_back((uint16_t)(SEL_MPC_LANGSUNG | hDefault));
+        stat.selLangsung++;
+        continue;
+      }
+      std::vector<uint8_t> daftar(1, 0);
+      uint8_t jumlahBidangSel = 0;
+      for (const auto &k : kena) {
+        if (mentah[k.second].hukum == hDefault) continue;
+        daftar.push_back((uint8_t)k.second);
+        jumlahBidangSel += (uint8_t)mentah[k.second].bidang.size();
+      }
+      daftar[0] = (uint8_t)(daftar.size() - 1);
+      daftar.push_back((uint8_t)hDefault);
+      maksKandidat = std::max(maksKandidat, daftar[0]);
+      maksBidang = std::max(maksBidang, jumlahBidangSel);
+      auto ada = daftarSama.find(daftar);
+      if (ada != daftarSama.end()) {
+        sel.push_back(ada->second);
+        continue;
+      }
+      if (kandidat.size() + daftar.size() >= SEL_MPC_LANGSUNG) {
+        pesanGalat = "daftar kandidat > 32 KB: kurangi sel";
+        return false;
+      }
+      daftarSama[daftar] = (uint16_t)kandidat.size();
+      sel.push_back((uint16_t)kandidat.size());
+      kandidat.insert(kandidat.end(), daftar.begin(), daftar.end());
+    }
+  }
+
+  // --- Observer Kalman tunak: x = [air, ujung probe, ruang], y = ujung probe ---
+  const double dt = PERIODE_SUHU_MS / 1000.0;
+  const double tauUkur = p.tauProbe + (1.0 - ALPHA) / ALPHA * dt;   // lag probe + EMA filterSuhu
+  const double al = dt / tau, be = dt / tauUkur;
+  const double F[3][3] = {{1.0 - al, 0.0, al}, {be, 1.0 - be, 0.0}, {0.0, 0.0, 1.0}};
+  double Pk[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 100}};
+  double L[3] = {0, 0, 0};
+  for (int it = 0; it < 2000000; it++) {
+    double M[3][3], Pm[3][3];
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) {
+        M[i][j] = 0.0;
+        for (int k = 0; k < 3; k++) M[i][j] += F[i][k] * Pk[k][j];
+      }
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) {
+        Pm[i][j] = 0.0;
+        for (int k = 0; k < 3; k++) Pm[i][j] += M[i][k] * F[j][k];
+      }
+    Pm[0][0] += s.varProsesAir * dt;
+    Pm[2][2] += s.varProsesRuang * dt;
+    const double S = Pm[1][1] + s.varUkur;
+    double Lb[3], beda = 0.0;
+    for (int i = 0; i < 3; i++) {
+      Lb[i] = Pm[i][1] / S;
+      beda = std::max(beda, fabs(Lb[i] - L[i]) / (fabs(Lb[i]) + 1e-30));
+    }
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++) Pk[i][j] = Pm[i][j] - Lb[i] * Pm[1][j];
+    memcpy(L, Lb, sizeof(L));
+    if (it > 1000 && beda < 1e-10) break;
+  }
+
+  t = TabelMpc();
+  t.alfaAir = (float)(1.0 / tau);
+  t.gainSuhu = (float)g;
+  t.alfaUkur = (float)(1.0 / tauUkur);
+  for (int i = 0; i < 3; i++) t.kalman[i] = (float)L[i];
+  t.eMin = (float)s.eMin;
+  t.eMax = (float)s.eMax;
+  t.hMin = (float)hMin;
+  t.hMax = (float)hMax;
+  t.skalaE = (float)(s.selE / (s.eMax - s.eMin));
+  t.skalaH = (float)(s.selH / (hMax - hMin));
+  t.selE = (uint8_t)s.selE;
+  t.selH = (uint8_t)s.selH;
+  t.maksKandidat = maksKandidat;
+  t.maksBidang = maksBidang;
+  t.sel = sel.data();
+  t.kandidat = kandidat.data();
+  t.wilayah = wilayah.data();
+  t.bidang = bidang.data();
+  t.hukum = hukum.data();
+  t.jumlahWilayah = (uint16_t)wilayah.size();
+  t.jumlahBidang = (uint16_t)bidang.size();
+  t.jumlahHukum = (uint16_t)hukum.size();
+  t.jumlahKandidat = (uint16_t)kandidat.size();
+  t.horizon = (uint8_t)n;
+  t.tsDetik = (float)s.tsDetik;
+
+  // Clamp e di luar kotak hanya sah jika output di tepi kotak sudah jenuh
+  for (int j = 0; j <= 20; j++) {
+    const float h = (float)(hMin + (hMax - hMin) * j / 20.0);
+    if (evaluasiTabelMpc(t, t.eMax, h) < 99.99f || evaluasiTabelMpc(t, t.eMin, h) > 0.01f) {
+      pesanGalat = "output di tepi kotak e belum jenuh: lebarkan eMin/eMax";
+      return false;
+    }
+  }
+  return true;
+}
+
+double GeneratorMpc::solusiDaring(double e, double h) const {
+  double z[MPC_HORIZON_MAKS];
+  for (int i = 0; i < n; i++) z[i] = 0.0;
+  for (int sapuan = 0; sapuan < 200000; sapuan++) {
+    double ubahMaks = 0.0;
+    for (int i = 0; i < n; i++) {
+      double g = Fe[i] * e;
+      for (int j = 0; j < n; j++) g += H[i][j] * z[j];
+      double baru = z[i] - g / H[i][i];
+      baru = std::min(std::max(baru, -h), 100.0 - h);
+      ubahMaks = std::max(ubahMaks, fabs(baru - z[i]));
+      z[i] = baru;
+    }
+    if (ubahMaks < 1e-10) break;
+  }
+  return z[0] + h;
+}
+
+void GeneratorMpc::tulisSumber(FILE *f, const char *perintah) const {
+  fprintf(f, "// Dihasilkan oleh tools/mpc (lib/Simulasi/MpcEksplisit.cpp), jangan diedit manual:\n");
+  fprintf(f, "//   %s\n", perintah);
+  fprintf(f, "// Plant: C %.0f J/K, UA %.3f W/K, tau probe %.1f s. MPC: horizon %d x %.0f s, q %g, r %g,\n",
+          plant.kapasitasPanas, plant.ua, plant.tauProbe, n, spek.tsDetik, spek.bobotError, spek.bobotInput);
+  fprintf(f, "// gain tak terbatas %.2f %%/C. %u himpunan aktif -> %u wilayah, %u hukum; sel %ux%u (%u langsung).\n",
+          stat.gainTakTerbatas, stat.himpunanAktif, (unsigned)t.jumlahWilayah, (unsigned)t.jumlahHukum,
+          (unsigned)t.selE, (unsigned)t.selH, stat.selLangsung);
+  fprintf(f, "\n#include \"Mpc.h\"\n\n");
+
+  char x[24], y[24], z[24], w[24], u[24], v[24];
+  fprintf(f, "static const HukumMpc HUKUM[%u] = {\n", (unsigned)t.jumlahHukum);
+  for (const HukumMpc &h : hukum)
+    fprintf(f, "  {%s, %s, %s},\n", literal(x, sizeof(x), h.ke), literal(y, sizeof(y), h.kh),
+            literal(z, sizeof(z), h.c));
+  fprintf(f, "};\n\n");
+
+  fprintf(f, "static const BidangMpc BIDANG[%u] = {\n", (unsigned)t.jumlahBidang);
+  for (const BidangMpc &bd : bidang)
+    fprintf(f, "  {%s, %s, %s},\n", literal(x, sizeof(x), bd.ae), literal(y, sizeof(y), bd.ah),
+            literal(z, sizeof(z), bd.b));
+  fprintf(f, "};\n\n");
+
+  fprintf(f, "static const WilayahMpc WILAYAH[%u] = {\n", (unsigned)t.jumlahWilayah);
+  for (size_t i = 0; i < wilayah.size(); i++)
+    fprintf(f, "%s{%u, %u, %u},%s", (i % 6 == 0) ? "  " : " ", (unsigned)wilayah[i].awalBidang,
+            (unsigned)wilayah[i].jumlahBidang, (unsigned)wilayah[i].hukum, (i % 6 == 5) ? "\n" : "");
+  fprintf(f, "%s};\n\n", (wilayah.size() % 6) ? "\n" : "");
+
+  // Array kosong tidak sah di C++: minimal satu elemen
+  fprintf(f, "static const uint8_t KANDIDAT[%u] = {", (unsigned)std::max<size_t>(kandidat.size(), 1));
+  for (size_t i = 0; i < kandidat.size(); i++) fprintf(f, "%s%u,", (i % 16 == 0) ? "\n  " : " ", kandidat[i]);
+  fprintf(f, "%s\n};\n\n", kandidat.empty() ? "0" : "");
+
+  fprintf(f, "static const uint16_t SEL[%u] = {", (unsigned)sel.size());
+  for (size_t i = 0; i < sel.size(); i++) fprintf(f, "%s0x%04x,", (i % 12 == 0) ? "\n  " : " ", sel[i]);
+  fprintf(f, "\n};\n\n");
+
+  fprintf(f, "const TabelMpc TABEL_MPC = {\n");
+  fprintf(f, "  %s, %s, %s,\n", literal(x, sizeof(x), t.alfaAir), literal(y, sizeof(y), t.gainSuhu),
+          literal(z, sizeof(z), t.alfaUkur));
+  fprintf(f, "  {%s, %s, %s},\n", literal(x, sizeof(x), t.kalman[0]), literal(y, sizeof(y), t.kalman[1]),
+          literal(z, sizeof(z), t.kalman[2]));
+  fprintf(f, "  %s, %s, %s, %s, %s, %s,\n", literal(x, sizeof(x), t.eMin), literal(y, sizeof(y), t.eMax),
+          literal(z, sizeof(z), t.hMin), literal(w, sizeof(w), t.hMax), literal(u, sizeof(u), t.skalaE),
+          literal(v, sizeof(v), t.skalaH));
+  fprintf(f, "  %u, %u, %u, %u,\n", (unsigned)t.selE, (unsigned)t.selH, (unsigned)t.maksKandidat,
+          (unsigned)t.maksBidang);
+  fprintf(f, "  SEL, KANDIDAT, WILAYAH, BIDANG, HUKUM,\n");
+  fprintf(f, "  %u, %u, %u, %u,\n", (unsigned)t.jumlahWilayah, (unsigned)t.jumlahBidang, (unsigned)t.jumlahHukum,
+          (unsigned)t.jumlahKandidat);
+  fprintf(f, "  %u, %s,\n};\n", (unsigned)t.horizon, literal(x, sizeof(x), t.tsDetik));
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * GENERATOR MPC EKSPLISIT (HOST)
+ * * Deskripsi:
+ * Menyelesaikan QP MPC loop suhu secara multiparametrik untuk model tangki
+ * hasil identifikasi (ParameterPlant), lalu memadatkannya menjadi TabelMpc
+ * (lib/Kontrol/Mpc.h) yang dievaluasi firmware tanpa solver.
+ * - Model diskret (langkah tsDetik): e+ = a e - b (u - h), e = setpoint -
+ *   suhu air, h = output penahan setpoint; a, b eksak dari C & UA, watt per
+ *   % = kemiringan kuadrat terkecil kurva heater (lewat titik nol).
+ * - Biaya: sum q e_k^2 + r (u_k - h)^2, bobot akhir = solusi Riccati tak
+ *   berhingga; batasan 0 <= u_k <= 100 untuk semua langkah horizon.
+ * - mp-QP: semua himpunan aktif (3^horizon, batas bawah / atas / bebas per
+ *   langkah) diselesaikan KKT-nya; wilayah = syarat primal + dual sebagai
+ *   setengah bidang di (e, h), dipotong ke kotak parameter (poligon eksak,
+ *   2 dimensi). Wilayah kosong dibuang, bidang redundan dibuang.
+ * - Point location: grid seragam; tiap sel memuat wilayah yang memotongnya,
+ *   hukum paling luas jadi default sel (tidak perlu diuji).
+ * - Observer: gain Kalman tunak (iterasi Riccati) untuk model 3 state
+ *   (air, ujung probe, ruang) dengan periode PERIODE_SUHU_MS.
+ */
+
+#ifndef AQUARIUM_MPC_EKSPLISIT_H
+#define AQUARIUM_MPC_EKSPLISIT_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+#include "Mpc.h"
+#include "PlantAquarium.h"
+
+const int MPC_HORIZON_MAKS = 12;
+
+struct SpesifikasiMpc {
+  double tsDetik = 120.0;       // langkah prediksi
+  int horizon = 8;
+  double bobotError = 1.0;      // q (per C^2)
+  double bobotInput = 2e-4;     // r (per %^2, terhadap output penahan)
+  double eMin = -3.0, eMax = 3.0;
+  int selE = 48, selH = 8;
+  // Observer (varian per detik / per sampel)
+  double varProsesAir = 2.5e-9;
+  double varProsesRuang = 2e-8;
+  double varUkur = 7.5e-4;
+};
+
+struct StatistikMpc {
+  uint32_t himpunanAktif = 0;   // kombinasi yang diselesaikan
+  uint32_t selLangsung = 0;
+  double gainTakTerbatas = 0.0; // ke hukum bebas batasan (%/C)
+};
+
+// Pemilik semua array; tabel menunjuk ke vector di dalamnya (jangan disalin)
+class GeneratorMpc {
+public:
+  GeneratorMpc() = default;
+  GeneratorMpc(const GeneratorMpc &) = delete;
+  GeneratorMpc &operator=(const GeneratorMpc &) = delete;
+
+  // false -> galat() (mis. wilayah > 255, kotak e terlalu sempit)
+  bool bangun(const ParameterPlant &plant, const SpesifikasiMpc &spek);
+
+  // Solusi QP daring (coordinate descent) untuk verifikasi: output pertama (%)
+  double solusiDaring(double e, double h) const;
+
+  // Sumber C++ berisi TABEL_MPC (lib/Kontrol/TabelMpc.cpp)
+  void tulisSumber(FILE *f, const char *perintah) const;
+
+  const TabelMpc &tabel() const { return t; }
+  const StatistikMpc &statistik() const { return stat; }
+  const char *galat() const { return pesanGalat; }
+
+private:
+  SpesifikasiMpc spek;
+  ParameterPlant plant;
+  double a = 0.0, b = 0.0;
+  int n = 0;
+  double H[MPC_HORIZON_MAKS][MPC_HORIZON_MAKS];
+  double Fe[MPC_HORIZON_MAKS];   // gradien = H z + Fe e
+
+  std::vector<HukumMpc> hukum;
+  std::vector<BidangMpc> bidang;
+  std::vector<WilayahMpc> wilayah;
+  std::vector<uint16_t> sel;
+  std::vector<uint8_t> kandidat;
+  TabelMpc t = {};
+  StatistikMpc stat;
+  const char *pesanGalat = "";
+};
+
+#endif
+#endif
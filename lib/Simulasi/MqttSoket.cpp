@@ -0,0 +1,633 @@
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include "MqttSoket.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+// Jenis paket MQTT (nibble atas byte pertama)
+enum : uint8_t {
+  MQTT_CONNECT = 1, MQTT_CONNACK = 2, MQTT_PUBLISH = 3, MQTT_PUBACK = 4, MQTT_SUBSCRIBE = 8, MQTT_SUBACK = 9,
+  MQTT_UNSUBSCRIBE = 10, MQTT_UNSUBACK = 11, MQTT_PINGREQ = 12, MQTT_PINGRESP = 13, MQTT_DISCONNECT = 14,
+};
+
+static const size_t PAKET_MAKS = 1u << 20;   // remaining length lebih besar = paket rusak
+
+uint64_t jamMonotonUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// =========================================================================
+//                  FORMAT PAKET
+// =========================================================================
+
+namespace {
+
+// Remaining length (varint 7 bit) -> p, return jumlah byte
+size_t tulisPanjang(uint8_t *p, size_t n) {
+  size_t i = 0;
+  do {
+    uint8_t b = n & 0x7F;
+    n >>= 7;
+    p[i++] = n ? (b | 0x80) : b;
+  } while (n);
+  return i;
+}
+
+// 1 = kepala lengkap (kepala = 1 + varint, sisa = remaining length), 0 = kurang data, -1 = rusak
+int bacaKepala(const uint8_t *p, size_t n, size_t &kepala, size_t &sisa) {
+  sisa = 0;
+  for (size_t i = 1; i < 5; i++) {
+    if (i >= n) return 0;
+    sisa |= (size_t)(p[i] & 0x7F) << (7 * (i - 1));
+    if (!(p[i] & 0x80)) {
+      kepala = i + 1;
+      return sisa <= PAKET_MAKS ? 1 : -1;
+    }
+  }
+  return -1;
+}
+
+void tambahU16(std::vector<uint8_t> &v, uint16_t x) {
+  v.push_back(x >> 8);
+  v.push_back(x & 0xFF);
+}
+
+void tambahStr(std::vector<uint8_t> &v, const char *s, size_t n) {
+  tambahU16(v, (uint16_t)n);
+  v.insert(v.end(), s, s + n);
+}
+
+// Kepala PUBLISH QoS 0 (tanpa topik & isi) -> kepala, return panjang
+size_t kepalaPublish(uint8_t kepala[5], size_t nTopik, size_t nIsi, bool retained) {
+  kepala[0] = (MQTT_PUBLISH << 4) | (retained ? 1 : 0);
+  return 1 + tulisPanjang(kepala + 1, 2 + nTopik + nIsi);
+}
+
+// Tunggu fd siap (POLLIN / POLLOUT) sampai batas waktu absolut
+bool tunggu(int fd, short ev, uint64_t batasUs) {
+  for (;;) {
+    const uint64_t now = jamMonotonUs();
+    if (now >= batasUs) return false;
+    pollfd p = {fd, ev, 0};
+    int r = poll(&p, 1, (int)((batasUs - now + 999) / 1000));
+    if (r > 0) return true;
+    if (r < 0 && errno != EINTR) return false;
+  }
+}
+
+}  // namespace
+
+// =========================================================================
+//                  KLIEN
+// =========================================================================
+
+KlienMqtt::KlienMqtt(size_t kapasitasKeluar) : kapasitas(kapasitasKeluar) {}
+
+KlienMqtt::~KlienMqtt() { putus(); }
+
+bool KlienMqtt::setServer(const char *host, uint16_t port) {
+  addrinfo hint = {}, *hasil = nullptr;
+  hint.ai_family = AF_INET;
+  hint.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host, nullptr, &hint, &hasil) != 0 || !hasil) return false;
+  sockaddr_in a = *(const sockaddr_in *)hasil->ai_addr;
+  freeaddrinfo(hasil);
+  a.sin_port = htons(port);
+  static_assert(sizeof(a) <= sizeof(alamat), "alamat");
+  memcpy(alamat, &a, sizeof(a));
+  adaAlamat = true;
+  return true;
+}
+
+void KlienMqtt::putus() {
+  if (fdSoket >= 0) close(fdSoket);
+  fdSoket = -1;
+  keluar.clear();
+  masuk.clear();
+  terkirim = 0;
+  stempel.clear();
+  kepalaStempel = 0;
+  totalAntre = totalKirim = 0;
+}
+
+bool KlienMqtt::sambung(const char *clientId) {
+  putus();
+  if (!adaAlamat) return false;
+  const uint64_t batas = jamMonotonUs() + timeoutMs * 1000ULL;
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  int satu = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &satu, sizeof(satu));
+  if (connect(fd, (const sockaddr *)alamat, sizeof(sockaddr_in)) != 0) {
+    int err = 0;
+    socklen_t n = sizeof(err);
+    if (errno != EINPROGRESS || !tunggu(fd, POLLOUT, batas) || getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &n) != 0 ||
+        err != 0) {
+      close(fd);
+      return false;
+    }
+  }
+
+  // CONNECT: clean session, keep alive 0 (broker tidak memutus sesi diam)
+  std::vector<uint8_t> isi;
+  tambahStr(isi, "MQTT", 4);
+  isi.push_back(4);      // protokol 3.1.1
+  isi.push_back(0x02);   // clean session
+  tambahU16(isi, 0);
+  tambahStr(isi, clientId, strlen(clientId));
+  uint8_t kepala[5];
+  kepala[0] = MQTT_CONNECT << 4;
+  const size_t nKepala = 1 + tulisPanjang(kepala + 1, isi.size());
+  isi.insert(isi.begin(), kepala, kepala + nKepala);
+
+  // Blok sampai CONNACK (seperti PubSubClient::connect)
+  size_t dikirim = 0;
+  while (dikirim < isi.size()) {
+    ssize_t n = send(fd, isi.data() + dikirim, isi.size() - dikirim, MSG_NOSIGNAL);
+    if (n > 0) dikirim += n;
+    else if ((n < 0 && errno != EAGAIN && errno != EINTR) || !tunggu(fd, POLLOUT, batas)) {
+      close(fd);
+      return false;
+    }
+  }
+  uint8_t buf[512];
+  while (masuk.size() < 4) {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n > 0) masuk.insert(masuk.end(), buf, buf + n);
+    else if (n == 0 || (errno != EAGAIN && errno != EINTR) || !tunggu(fd, POLLIN, batas)) {
+      close(fd);
+      masuk.clear();
+      return false;
+    }
+  }
+  if (masuk[0] != (MQTT_CONNACK << 4) || masuk[1] != 2 || masuk[3] != 0) {
+    close(fd);
+    masuk.clear();
+    return false;
+  }
+  masuk.erase(masuk.begin(), masuk.begin() + 4);
+  fdSoket = fd;
+  return true;
+}
+
+bool KlienMqtt::antre(const uint8_t *kepala, size_t nKepala, const char *topik, const uint8_t *isi, size_t nIsi) {
+  const size_t nTopik = topik ? strlen(topik) : 0;
+  const size_t total = nKepala + (topik ? 2 + nTopik : 0) + nIsi;
+  if (fdSoket < 0 || isiBuffer() + total > kapasitas) return false;
+  if (terkirim > 0 && terkirim >= keluar.size() / 2) {
+    keluar.erase(keluar.begin(), keluar.begin() + terkirim);
+    terkirim = 0;
+  }
+  keluar.insert(keluar.end(), kepala, kepala + nKepala);
+  if (topik) tambahStr(keluar, topik, nTopik);
+  keluar.insert(keluar.end(), isi, isi + nIsi);
+  totalAntre += total;
+  if (isiBuffer() > stat.bufferMaks) stat.bufferMaks = isiBuffer();
+  return true;
+}
+
+bool KlienMqtt::publish(const char *topic, const char *payload, bool retained) {
+  return publish(topic, (const uint8_t *)payload, strlen(payload), retained);
+}
+
+bool KlienMqtt::publish(const char *topic, const uint8_t *payload, size_t len, bool retained) {
+  uint8_t kepala[5];
+  const size_t nKepala = kepalaPublish(kepala, strlen(topic), len, retained);
+  if (!antre(kepala, nKepala, topic, payload, len)) {
+    stat.ditolak++;
+    return false;
+  }
+  stat.publish++;
+  if (catatanAntrian) stempel.push_back({totalAntre, jamMonotonUs()});
+  // Langsung ke kernel seperti PubSubClient; yang belum masuk menunggu layani()
+  if (!tulisSemua()) putus();
+  return true;
+}
+
+bool KlienMqtt::subscribe(const char *filter) {
+  const size_t nFilter = strlen(filter);
+  if (++idPaket == 0) idPaket = 1;
+  std::vector<uint8_t> isi;
+  tambahU16(isi, idPaket);
+  tambahStr(isi, filter, nFilter);
+  isi.push_back(1);   // QoS diminta (sama dengan firmware)
+  uint8_t kepala[5];
+  kepala[0] = (MQTT_SUBSCRIBE << 4) | 0x02;
+  const size_t nKepala = 1 + tulisPanjang(kepala + 1, isi.size());
+  if (!antre(kepala, nKepala, nullptr, isi.data(), isi.size())) return false;
+  if (!tulisSemua()) {
+    putus();
+    return false;
+  }
+  return true;
+}
+
+bool KlienMqtt::tulisSemua() {
+  while (terkirim < keluar.size()) {
+    ssize_t n = send(fdSoket, keluar.data() + terkirim, keluar.size() - terkirim, MSG_NOSIGNAL);
+    if (n > 0) {
+      terkirim += n;
+      totalKirim += n;
+      stat.byteKeluar += n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && errno == EAGAIN) {
+      break;
+    } else {
+      return false;
+    }
+  }
+  if (terkirim == keluar.size()) {
+    keluar.clear();
+    terkirim = 0;
+  }
+  if (catatanAntrian && kepalaStempel < stempel.size()) {
+    const uint64_t now = jamMonotonUs();
+    while (kepalaStempel < stempel.size() && stempel[kepalaStempel].akhir <= totalKirim)
+      catatanAntrian->push_back((uint32_t)(now - stempel[kepalaStempel++].us));
+    if (kepalaStempel == stempel.size()) {
+      stempel.clear();
+      kepalaStempel = 0;
+    }
+  }
+  return true;
+}
+
+bool KlienMqtt::prosesMasuk() {
+  uint8_t buf[4096];
+  for (;;) {
+    ssize_t n = recv(fdSoket, buf, sizeof(buf), 0);
+    if (n > 0) masuk.insert(masuk.end(), buf, buf + n);
+    else if (n == 0) return false;
+    else if (errno == EINTR) continue;
+    else if (errno == EAGAIN) break;
+    else return false;
+  }
+
+  size_t pos = 0, kepala, sisa;
+  std::string topik;
+  for (;;) {
+    const int k = bacaKepala(masuk.data() + pos, masuk.size() - pos, kepala, sisa);
+    if (k < 0) return false;
+    if (k == 0 || masuk.size() - pos < kepala + sisa) break;
+    const uint8_t *p = masuk.data() + pos + kepala;
+    const uint8_t jenis = masuk[pos] >> 4;
+    if (jenis == MQTT_PUBLISH && sisa >= 2) {
+      const uint8_t qos = (masuk[pos] >> 1) & 3;
+      const size_t nTopik = ((size_t)p[0] << 8) | p[1];
+      size_t o = 2 + nTopik + (qos ? 2 : 0);
+      if (o > sisa) return false;
+      if (qos == 1) {
+        const uint8_t puback[4] = {MQTT_PUBACK << 4, 2, p[2 + nTopik], p[3 + nTopik]};
+        antre(puback, sizeof(puback), nullptr, nullptr, 0);
+      }
+      stat.pesanMasuk++;
+      topik.assign((const char *)p + 2, nTopik);
+      if (pendengar) pendengar(topik.c_str(), p + o, sisa - o);
+    }
+    pos += kepala + sisa;
+  }
+  masuk.erase(masuk.begin(), masuk.begin() + pos);
+  return true;
+}
+
+bool KlienMqtt::layani() {
+  if (fdSoket < 0) return false;
+  if (!tulisSemua() || !prosesMasuk() || !tulisSemua()) {
+    putus();
+    return false;
+  }
+  return true;
+}
+
+// =========================================================================
+//                  BROKER
+// =========================================================================
+
+namespace {
+
+// Pohon filter per level topik; "+" dan "#" disimpan sebagai anak biasa
+struct SimpulTopik {
+  std::unordered_map<std::string, std::unique_ptr<SimpulTopik>> anak;
+  std::vector<uint64_t> pelanggan;   // id sesi
+};
+
+struct SesiBroker {
+  int fd = -1;
+  std::vector<uint8_t> masuk, keluar;
+  size_t terkirim = 0;
+  bool mauTulis = false;             // EPOLLOUT terpasang
+  std::vector<std::string> filter;
+};
+
+void pisahLevel(const char *s, size_t n, std::vector<std::string> &level) {
+  level.clear();
+  size_t awal = 0;
+  for (size_t i = 0; i <= n; i++) {
+    if (i == n || s[i] == '/') {
+      level.emplace_back(s + awal, i - awal);
+      awal = i + 1;
+    }
+  }
+}
+
+void cocokkan(const SimpulTopik &s, const std::vector<std::string> &level, size_t i, std::vector<uint64_t> &hasil) {
+  auto pagar = s.anak.find("#");   // "a/#" juga cocok dengan "a"
+  if (pagar != s.anak.end()) hasil.insert(hasil.end(), pagar->second->pelanggan.begin(), pagar->second->pelanggan.end());
+  if (i == level.size()) {
+    hasil.insert(hasil.end(), s.pelanggan.begin(), s.pelanggan.end());
+    return;
+  }
+  auto a = s.anak.find(level[i]);
+  if (a != s.anak.end()) cocokkan(*a->second, level, i + 1, hasil);
+  auto plus = s.anak.find("+");
+  if (plus != s.anak.end()) cocokkan(*plus->second, level, i + 1, hasil);
+}
+
+}  // namespace
+
+struct BrokerMqtt::Isi {
+  int fdDengar = -1, ep = -1;
+  size_t batasAntrian = 0;
+  uint64_t idBerikut = 1;                     // 0 = socket dengar
+  std::unordered_map<uint64_t, SesiBroker> sesi;
+  SimpulTopik akar;
+  std::vector<std::string> level;
+  std::vector<uint64_t> cocok;
+
+  ~Isi() {
+    for (auto &s : sesi) close(s.second.fd);
+    if (fdDengar >= 0) close(fdDengar);
+    if (ep >= 0) close(ep);
+  }
+
+  SimpulTopik &simpul(const std::string &filter) {
+    pisahLevel(filter.data(), filter.size(), level);
+    SimpulTopik *s = &akar;
+    for (const std::string &l : level) {
+      std::unique_ptr<SimpulTopik> &a = s->anak[l];
+      if (!a) a.reset(new SimpulTopik());
+      s = a.get();
+    }
+    return *s;
+  }
+
+  void berhentiLangganan(uint64_t id, const std::string &filter) {
+    std::vector<uint64_t> &p = simpul(filter).pelanggan;
+    p.erase(std::remove(p.begin(), p.end(), id), p.end());
+  }
+
+  void pasangTulis(uint64_t id, SesiBroker &s, bool mau) {
+    if (s.mauTulis == mau) return;
+    s.mauTulis = mau;
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    if (mau) ev.events |= EPOLLOUT;
+    ev.data.u64 = id;
+    epoll_ctl(ep, EPOLL_CTL_MOD, s.fd, &ev);
+  }
+
+  // false = socket rusak
+  bool kirim(uint64_t id, SesiBroker &s) {
+    while (s.terkirim < s.keluar.size()) {
+      ssize_t n = send(s.fd, s.keluar.data() + s.terkirim, s.keluar.size() - s.terkirim, MSG_NOSIGNAL);
+      if (n > 0) s.terkirim += n;
+      else if (n < 0 && errno == EINTR) continue;
+      else if (n < 0 && errno == EAGAIN) break;
+      else return false;
+    }
+    if (s.terkirim == s.keluar.size()) {
+      s.keluar.clear();
+      s.terkirim = 0;
+    } else if (s.terkirim >= s.keluar.size() / 2) {
+      s.keluar.erase(s.keluar.begin(), s.keluar.begin() + s.terkirim);
+      s.terkirim = 0;
+    }
+    pasangTulis(id, s, !s.keluar.empty());
+    return true;
+  }
+
+  void balas(SesiBroker &s, const uint8_t *p, size_t n) { s.keluar.insert(s.keluar.end(), p, p + n); }
+};
+
+bool BrokerMqtt::mulai(const char *alamat, uint16_t port, size_t batasAntrianByte) {
+  berhenti();
+  isi = std::make_shared<Isi>();
+  isi->batasAntrian = batasAntrianByte;
+  sockaddr_in a = {};
+  a.sin_family = AF_INET;
+  a.sin_port = htons(port);
+  if (inet_pton(AF_INET, alamat, &a.sin_addr) != 1) return false;
+
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  isi->fdDengar = fd;
+  int satu = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &satu, sizeof(satu));
+  if (bind(fd, (const sockaddr *)&a, sizeof(a)) != 0 || listen(fd, SOMAXCONN) != 0) return false;
+  socklen_t n = sizeof(a);
+  getsockname(fd, (sockaddr *)&a, &n);
+  portDengar = ntohs(a.sin_port);
+
+  isi->ep = epoll_create1(EPOLL_CLOEXEC);
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.u64 = 0;
+  if (isi->ep < 0 || epoll_ctl(isi->ep, EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+
+  stop = false;
+  thread = std::thread(&BrokerMqtt::jalan, this);
+  return true;
+}
+
+void BrokerMqtt::berhenti() {
+  stop = true;
+  if (thread.joinable()) thread.join();
+  isi.reset();
+}
+
+void BrokerMqtt::jalan() {
+  Isi &b = *isi;
+  epoll_event ev[256];
+  uint8_t buf[16384];
+
+  auto tutup = [&](uint64_t id) {
+    auto it = b.sesi.find(id);
+    if (it == b.sesi.end()) return;
+    for (const std::string &f : it->second.filter) b.berhentiLangganan(id, f);
+    close(it->second.fd);
+    b.sesi.erase(it);
+    stat.aktif--;
+  };
+
+  // Teruskan PUBLISH (sebagai QoS 0) ke semua sesi yang filternya cocok
+  auto teruskan = [&](const char *topik, size_t nTopik, const uint8_t *payload, size_t nPayload) {
+    pisahLevel(topik, nTopik, b.level);
+    b.cocok.clear();
+    cocokkan(b.akar, b.level, 0, b.cocok);
+    std::sort(b.cocok.begin(), b.cocok.end());
+    b.cocok.erase(std::unique(b.cocok.begin(), b.cocok.end()), b.cocok.end());
+    uint8_t kepala[5];
+    const size_t nKepala = kepalaPublish(kepala, nTopik, nPayload, false);
+    const size_t total = nKepala + 2 + nTopik + nPayload;
+    for (uint64_t id : b.cocok) {
+      auto it = b.sesi.find(id);
+      if (it == b.sesi.end()) continue;
+      SesiBroker &s = it->second;
+      if (s.keluar.size() - s.terkirim + total > b.batasAntrian) {
+        stat.dibuang++;
+        continue;
+      }
+      const bool kosong = s.keluar.size() == s.terkirim;
+      s.keluar.insert(s.keluar.end(), kepala, kepala + nKepala);
+      tambahStr(s.keluar, topik, nTopik);
+      s.keluar.insert(s.keluar.end(), payload, payload + nPayload);
+      stat.pesanKeluar++;
+      // Antrian yang sudah menunggu EPOLLOUT tidak dicoba ulang per pesan
+      if (kosong && !b.kirim(id, s)) tutup(id);
+    }
+  };
+
+  // false = tutup sesi
+  auto proses = [&](uint64_t id, SesiBroker &s) -> bool {
+    size_t pos = 0, kepala, sisa;
+    for (;;) {
+      const int k = bacaKepala(s.masuk.data() + pos, s.masuk.size() - pos, kepala, sisa);
+      if (k < 0) return false;
+      if (k == 0 || s.masuk.size() - pos < kepala + sisa) break;
+      const uint8_t b0 = s.masuk[pos];
+      const uint8_t *p = s.masuk.data() + pos + kepala;
+      pos += kepala + sisa;
+      switch (b0 >> 4) {
+        case MQTT_CONNECT: {
+          const uint8_t connack[4] = {MQTT_CONNACK << 4, 2, 0, 0};
+          b.balas(s, connack, sizeof(connack));
+          stat.sambungan++;
+          break;
+        }
+        case MQTT_PUBLISH: {
+          const uint8_t qos = (b0 >> 1) & 3;
+          if (sisa < 2) return false;
+          const size_t nTopik = ((size_t)p[0] << 8) | p[1];
+          const size_t o = 2 + nTopik + (qos ? 2 : 0);
+          if (o > sisa) return false;
+          if (qos == 1) {
+            const uint8_t puback[4] = {MQTT_PUBACK << 4, 2, p[2 + nTopik], p[3 + nTopik]};
+            b.balas(s, puback, sizeof(puback));
+          }
+          stat.pesanMasuk++;
+          stat.byteMasuk += kepala + sisa;
+          // teruskan() bisa menutup sesi ini juga (ikut berlangganan & socket rusak)
+          teruskan((const char *)p + 2, nTopik, p + o, sisa - o);
+          if (b.sesi.find(id) == b.sesi.end()) return true;
+          break;
+        }
+        case MQTT_SUBSCRIBE:
+        case MQTT_UNSUBSCRIBE: {
+          const bool langganan = (b0 >> 4) == MQTT_SUBSCRIBE;
+          if (sisa < 2) return false;
+          size_t o = 2, jumlah = 0;
+          while (o + 2 <= sisa) {
+            const size_t n = ((size_t)p[o] << 8) | p[o + 1];
+            if (o + 2 + n + (langganan ? 1 : 0) > sisa) return false;
+            std::string f((const char *)p + o + 2, n);
+            o += 2 + n + (langganan ? 1 : 0);
+            jumlah++;
+            if (langganan) {
+              if (std::find(s.filter.begin(), s.filter.end(), f) != s.filter.end()) continue;
+              b.simpul(f).pelanggan.push_back(id);
+              s.filter.push_back(f);
+            } else {
+              b.berhentiLangganan(id, f);
+              s.filter.erase(std::remove(s.filter.begin(), s.filter.end(), f), s.filter.end());
+            }
+          }
+          std::vector<uint8_t> ack;
+          ack.push_back((langganan ? MQTT_SUBACK : MQTT_UNSUBACK) << 4);
+          const size_t nAck = 2 + (langganan ? jumlah : 0);
+          uint8_t pj[4];
+          ack.insert(ack.end(), pj, pj + tulisPanjang(pj, nAck));
+          ack.push_back(p[0]);
+          ack.push_back(p[1]);
+          if (langganan) ack.insert(ack.end(), jumlah, 0);   // QoS 0 diberikan
+          b.balas(s, ack.data(), ack.size());
+          break;
+        }
+        case MQTT_PINGREQ: {
+          const uint8_t pingresp[2] = {MQTT_PINGRESP << 4, 0};
+          b.balas(s, pingresp, sizeof(pingresp));
+          break;
+        }
+        case MQTT_DISCONNECT:
+          return false;
+        default:
+          break;   // PUBACK dari klien, dll.
+      }
+    }
+    s.masuk.erase(s.masuk.begin(), s.masuk.begin() + pos);
+    return true;
+  };
+
+  while (!stop.load(std::memory_order_relaxed)) {
+    const int n = epoll_wait(b.ep, ev, 256, 100);
+    for (int i = 0; i < n; i++) {
+      const uint64_t id = ev[i].data.u64;
+      if (id == 0) {
+        for (;;) {
+          int fd = accept4(b.fdDengar, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+          if (fd < 0) break;
+          int satu = 1;
+          setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &satu, sizeof(satu));
+          const uint64_t idBaru = b.idBerikut++;
+          epoll_event e = {};
+          e.events = EPOLLIN;
+          e.data.u64 = idBaru;
+          if (epoll_ctl(b.ep, EPOLL_CTL_ADD, fd, &e) != 0) {
+            close(fd);
+            continue;
+          }
+          b.sesi[idBaru].fd = fd;
+          stat.aktif++;
+        }
+        continue;
+      }
+
+      auto it = b.sesi.find(id);
+      if (it == b.sesi.end()) continue;   // sudah ditutup di iterasi ini
+      SesiBroker &s = it->second;
+      bool hidup = !(ev[i].events & EPOLLERR);
+      if (hidup && (ev[i].events & (EPOLLIN | EPOLLHUP))) {
+        for (;;) {
+          ssize_t r = recv(s.fd, buf, sizeof(buf), 0);
+          if (r > 0) {
+            s.masuk.insert(s.masuk.end(), buf, buf + r);
+            continue;
+          }
+          if (r == 0 || (errno != EAGAIN && errno != EINTR)) hidup = false;
+          if (r < 0 && errno == EINTR) continue;
+          break;
+        }
+        // Paket lengkap tetap diproses walau socket sudah ditutup lawan
+        if (!proses(id, s)) hidup = false;
+      }
+      if (b.sesi.find(id) == b.sesi.end()) continue;
+      if (hidup && !b.kirim(id, s)) hidup = false;
+      if (!hidup) tutup(id);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * MQTT 3.1.1 DI ATAS SOCKET TCP (NATIVE, LINUX)
+ * * Deskripsi:
+ * Transport sungguhan untuk uji beban banyak perangkat virtual (tools/farm).
+ * - KlienMqtt: HalMqtt satu socket per perangkat. sambung() memblok sampai
+ *   CONNACK seperti PubSubClient; sesudahnya socket non-blocking:
+ *   publish() langsung menulis ke socket, sisa yang belum diterima kernel
+ *   menunggu di buffer keluar berbatas. Buffer penuh = publish gagal
+ *   (backpressure; firmware lalu menyimpan ke simpan-terus). Pemilik
+ *   memanggil layani() saat socket siap (epoll) untuk kirim/terima.
+ * - BrokerMqtt: broker minimal satu thread epoll (QoS 0, wildcard + dan #,
+ *   tanpa retained / sesi persisten / will) supaya uji bisa jalan tanpa
+ *   mosquitto. Pelanggan lambat: pesan dibuang jika antrian keluarnya
+ *   melewati batas (seperti max_queued_messages mosquitto), dihitung.
+ * QoS 1 dari sisi lain tetap dilayani (PUBACK), tetapi diteruskan sebagai QoS 0.
+ * Linux saja (epoll); build native lain melewati berkas ini.
+ */
+
+#ifndef AQUARIUM_MQTT_SOKET_H
+#define AQUARIUM_MQTT_SOKET_H
+
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Hal.h"
+
+// Jam monoton host (us) untuk stempel antrian
+uint64_t jamMonotonUs();
+
+struct StatistikKlien {
+  uint64_t publish = 0;        // diterima ke buffer keluar
+  uint64_t ditolak = 0;        // publish gagal: buffer penuh / tidak tersambung
+  uint64_t byteKeluar = 0;     // sudah diterima kernel
+  uint64_t pesanMasuk = 0;
+  size_t bufferMaks = 0;       // isi buffer keluar terbesar (byte)
+};
+
+class KlienMqtt : public HalMqtt {
+public:
+  explicit KlienMqtt(size_t kapasitasKeluar = 16384);
+  ~KlienMqtt();
+
+  // IPv4 / nama host; false jika tidak bisa di-resolve
+  bool setServer(const char *host, uint16_t port);
+  void setTimeout(uint32_t ms) { timeoutMs = ms; }
+
+  bool sambung(const char *clientId) override;
+  bool connected() override { return fdSoket >= 0; }
+  bool publish(const char *topic, const char *payload, bool retained) override;
+  bool publish(const char *topic, const uint8_t *payload, size_t len, bool retained) override;
+  bool subscribe(const char *filter);
+  void putus();
+
+  // Kirim isi buffer keluar & proses paket masuk. false = koneksi putus (socket ditutup)
+  bool layani();
+  int fd() const { return fdSoket; }
+  bool adaTertunda() const { return keluar.size() > terkirim; }
+  size_t isiBuffer() const { return keluar.size() - terkirim; }
+
+  // Paket PUBLISH masuk (topik ber-'\0')
+  std::function<void(const char *topik, const uint8_t *payload, size_t len)> pendengar;
+  // Opsional: waktu tiap publish di buffer keluar sampai diterima kernel (us)
+  std::vector<uint32_t> *catatanAntrian = nullptr;
+  StatistikKlien stat;
+
+private:
+  bool antre(const uint8_t *kepala, size_t nKepala, const char *topik, const uint8_t *isi, size_t nIsi);
+  bool tulisSemua();
+  bool prosesMasuk();
+
+  int fdSoket = -1;
+  uint32_t timeoutMs = 2000;
+  uint8_t alamat[16];          // sockaddr_in
+  bool adaAlamat = false;
+  uint16_t idPaket = 0;
+  size_t kapasitas;
+  std::vector<uint8_t> keluar, masuk;
+  size_t terkirim = 0;         // byte terdepan keluar yang sudah dikirim
+  uint64_t totalAntre = 0, totalKirim = 0;   // byte kumulatif (stempel antrian)
+  struct Stempel { uint64_t akhir; uint64_t us; };
+  std::vector<Stempel> stempel;
+  size_t kepalaStempel = 0;
+};
+
+struct StatistikBroker {
+  std::atomic<uint64_t> sambungan{0};      // CONNECT diterima (kumulatif)
+  std::atomic<uint32_t> aktif{0};          // sesi terbuka
+  std::atomic<uint64_t> pesanMasuk{0};
+  std::atomic<uint64_t> pesanKeluar{0};
+  std::atomic<uint64_t> dibuang{0};        // antrian pelanggan penuh
+  std::atomic<uint64_t> byteMasuk{0};
+};
+
+class BrokerMqtt {
+public:
+  ~BrokerMqtt() { berhenti(); }
+  // Dengar di alamat:port lalu jalan di thread sendiri. port 0 = pilih bebas (lihat port())
+  bool mulai(const char *alamat, uint16_t port, size_t batasAntrianByte = 8u << 20);
+  void berhenti();
+  uint16_t port() const { return portDengar; }
+  StatistikBroker stat;
+
+private:
+  struct Isi;
+  void jalan();
+
+  std::shared_ptr<Isi> isi;
+  std::thread thread;
+  std::atomic<bool> stop{false};
+  uint16_t portDengar = 0;
+};
+
+#endif
+#endif
@@ -0,0 +1,261 @@
+#ifndef ARDUINO
+
+#include "Optimasi.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+typedef std::vector<double> Vektor;
+
+// Ruang ternormalisasi -> evaluasi batch, catat yang terbaik & hitung anggaran
+class Pelacak {
+public:
+  Pelacak(const std::vector<DimensiCari> &dim, const OpsiCari &opsi, const EvaluasiBatch &eval)
+      : dim(dim), opsi(opsi), eval(eval) {}
+
+  size_t sisa() const { return (hasil.jumlahEvaluasi < opsi.anggaran) ? opsi.anggaran - hasil.jumlahEvaluasi : 0; }
+
+  static double potong(double u) { return (u < 0.0) ? 0.0 : ((u > 1.0) ? 1.0 : u); }
+
+  Vektor keAsli(const Vektor &u) const {
+    Vektor x(u.size());
+    for (size_t j = 0; j < u.size(); j++) x[j] = dim[j].min + potong(u[j]) * (dim[j].max - dim[j].min);
+    return x;
+  }
+
+  // Evaluasi kandidat (ternormalisasi); dipotong jika melebihi anggaran
+  Vektor evaluasi(const std::vector<Vektor> &u) {
+    size_t n = std::min(u.size(), sisa());
+    std::vector<Vektor> x(n);
+    for (size_t i = 0; i < n; i++) x[i] = keAsli(u[i]);
+    Vektor biaya(n, INFINITY);
+    if (n == 0) return biaya;
+    eval(x, biaya);
+    for (size_t i = 0; i < n; i++) {
+      if (hasil.terbaik.empty() || biaya[i] < hasil.biayaTerbaik) {
+        hasil.biayaTerbaik = biaya[i];
+        hasil.terbaik = x[i];
+      }
+    }
+    hasil.jumlahEvaluasi += n;
+    hasil.jumlahBatch++;
+    if (opsi.progres) opsi.progres(hasil.jumlahEvaluasi, hasil.biayaTerbaik, opsi.ctxProgres);
+    biaya.resize(u.size(), INFINITY);
+    return biaya;
+  }
+
+  Vektor awal() const {
+    Vektor u(dim.size());
+    for (size_t j = 0; j < dim.size(); j++) u[j] = potong((dim[j].awal - dim[j].min) / (dim[j].max - dim[j].min));
+    return u;
+  }
+
+  HasilCari hasil;
+
+private:
+  const std::vector<DimensiCari> &dim;
+  const OpsiCari &opsi;
+  const EvaluasiBatch &eval;
+};
+
+void cariGrid(Pelacak &p, size_t n) {
+  size_t k = 2;
+  while (pow((double)(k + 1), (double)n) <= (double)p.sisa()) k++;
+  size_t total = 1;
+  for (size_t j = 0; j < n; j++) total *= k;
+
+  std::vector<Vektor> u(total, Vektor(n));
+  for (size_t i = 0; i < total; i++) {
+    size_t sisa = i;
+    for (size_t j = 0; j < n; j++) {
+      u[i][j] = (double)(sisa % k) / (k - 1);
+      sisa /= k;
+    }
+  }
+  p.evaluasi(u);
+}
+
+void cariAcak(Pelacak &p, size_t n, const OpsiCari &opsi) {
+  std::mt19937 rng(opsi.seed);
+  std::uniform_real_distribution<double> seragam(0.0, 1.0);
+  bool pertama = true;
+  while (p.sisa() > 0) {
+    std::vector<Vektor> u((size_t)std::max(opsi.batch, 1), Vektor(n));
+    for (Vektor &v : u)
+      for (double &x : v) x = seragam(rng);
+    if (pertama) u[0] = p.awal();
+    pertama = false;
+    p.evaluasi(u);
+  }
+}
+
+void cariNelderMead(Pelacak &p, size_t n, const OpsiCari &opsi) {
+  std::vector<Vektor> s(n + 1, p.awal());
+  for (size_t i = 1; i <= n; i++) {
+    double &x = s[i][i - 1];
+    x = (x + opsi.langkahAwal <= 1.0) ? x + opsi.langkahAwal : x - opsi.langkahAwal;
+  }
+  Vektor f = p.evaluasi(s);
+  std::vector<size_t> urut(n + 1);
+
+  while (p.sisa() > 0) {
+    for (size_t i = 0; i <= n; i++) urut[i] = i;
+    std::sort(urut.begin(), urut.end(), [&](size_t a, size_t b) { return f[a] < f[b]; });
+    const size_t terbaik = urut[0], keduaTerburuk = urut[n - 1], terburuk = urut[n];
+
+    double ukuran = 0.0;
+    for (size_t i = 0; i <= n; i++)
+      for (size_t j = 0; j < n; j++) ukuran = std::max(ukuran, fabs(s[i][j] - s[terbaik][j]));
+    if (ukuran < 1e-4) break;
+
+    Vektor c(n, 0.0);
+    for (size_t i = 0; i <= n; i++) {
+      if (i == terburuk) continue;
+      for (size_t j = 0; j < n; j++) c[j] += s[i][j] / n;
+    }
+    // Refleksi, ekspansi, kontraksi luar, kontraksi dalam: satu batch
+    const double koef[4] = {1.0, 2.0, 0.5, -0.5};
+    std::vector<Vektor> u(4, Vektor(n));
+    for (int k = 0; k < 4; k++)
+      for (size_t j = 0; j < n; j++) u[k][j] = Pelacak::potong(c[j] + koef[k] * (c[j] - s[terburuk][j]));
+    Vektor fu = p.evaluasi(u);
+
+    int pilih = -1;
+    if (fu[0] < f[terbaik]) pilih = (fu[1] < fu[0]) ? 1 : 0;
+    else if (fu[0] < f[keduaTerburuk]) pilih = 0;
+    else if (fu[0] < f[terburuk]) pilih = (fu[2] <= fu[0]) ? 2 : -1;
+    else pilih = (fu[3] < f[terburuk]) ? 3 : -1;
+
+    if (pilih >= 0) {
+      s[terburuk] = u[pilih];
+      f[terburuk] = fu[pilih];
+      continue;
+    }
+    // Susutkan ke titik terbaik
+    std::vector<Vektor> baru;
+    std::vector<size_t> indeks;
+    for (size_t i = 0; i <= n; i++) {
+      if (i == terbaik) continue;
+      for (size_t j = 0; j < n; j++) s[i][j] = s[terbaik][j] + 0.5 * (s[i][j] - s[terbaik][j]);
+      baru.push_back(s[i]);
+      indeks.push_back(i);
+    }
+    Vektor fb = p.evaluasi(baru);
+    for (size_t k = 0; k < indeks.size(); k++) f[indeks[k]] = fb[k];
+  }
+}
+
+// sep-CMA-ES (Ros & Hansen 2008): kovarians diagonal, cukup untuk n <= ~10
+void cariCmaEs(Pelacak &p, size_t n, const OpsiCari &opsi) {
+  const double nd = (double)n;
+  const int lambda = std::max(4 + (int)floor(3.0 * log(nd)), opsi.batch);
+  const int mu = lambda / 2;
+
+  Vektor w(mu);
+  double jumlahW = 0.0, jumlahW2 = 0.0;
+  for (int i = 0; i < mu; i++) {
+    w[i] = log(mu + 0.5) - log(i + 1.0);
+    jumlahW += w[i];
+  }
+  for (double &x : w) {
+    x /= jumlahW;
+    jumlahW2 += x * x;
+  }
+  const double mueff = 1.0 / jumlahW2;
+
+  const double cs = (mueff + 2.0) / (nd + mueff + 5.0);
+  const double ds = 1.0 + 2.0 * std::max(0.0, sqrt((mueff - 1.0) / (nd + 1.0)) - 1.0) + cs;
+  const double cc = (4.0 + mueff / nd) / (nd + 4.0 + 2.0 * mueff / nd);
+  const double faktorSep = (nd + 2.0) / 3.0;
+  const double c1 = std::min(1.0, faktorSep * 2.0 / ((nd + 1.3) * (nd + 1.3) + mueff));
+  const double cmu = std::min(1.0 - c1, faktorSep * 2.0 * (mueff - 2.0 + 1.0 / mueff) /
+                                            ((nd + 2.0) * (nd + 2.0) + mueff));
+  const double chiN = sqrt(nd) * (1.0 - 1.0 / (4.0 * nd) + 1.0 / (21.0 * nd * nd));
+
+  std::mt19937 rng(opsi.seed);
+  std::normal_distribution<double> normal(0.0, 1.0);
+
+  Vektor m = p.awal(), diag(n, 1.0), ps(n, 0.0), pc(n, 0.0);
+  double sigma = opsi.langkahAwal;
+  std::vector<Vektor> z(lambda, Vektor(n)), y(lambda, Vektor(n)), u(lambda, Vektor(n));
+  std::vector<int> urut(lambda);
+
+  for (int generasi = 0; p.sisa() > 0; generasi++) {
+    for (int k = 0; k < lambda; k++) {
+      for (size_t j = 0; j < n; j++) {
+        z[k][j] = normal(rng);
+        y[k][j] = sqrt(diag[j]) * z[k][j];
+        u[k][j] = Pelacak::potong(m[j] + sigma * y[k][j]);
+      }
+    }
+    Vektor f = p.evaluasi(u);
+    for (int k = 0; k < lambda; k++) urut[k] = k;
+    std::sort(urut.begin(), urut.end(), [&](int a, int b) { return f[a] < f[b]; });
+
+    Vektor yw(n, 0.0), zw(n, 0.0);
+    for (int i = 0; i < mu; i++) {
+      for (size_t j = 0; j < n; j++) {
+        yw[j] += w[i] * y[urut[i]][j];
+        zw[j] += w[i] * z[urut[i]][j];
+      }
+    }
+
+    double normPs = 0.0;
+    for (size_t j = 0; j < n; j++) {
+      m[j] = Pelacak::potong(m[j] + sigma * yw[j]);
+      ps[j] = (1.0 - cs) * ps[j] + sqrt(cs * (2.0 - cs) * mueff) * zw[j];
+      normPs += ps[j] * ps[j];
+    }
+    normPs = sqrt(normPs);
+    const bool hsig = normPs / sqrt(1.0 - pow(1.0 - cs, 2.0 * (generasi + 1))) / chiN < 1.4 + 2.0 / (nd + 1.0);
+
+    double maksStd = 0.0;
+    for (size_t j = 0; j < n; j++) {
+      pc[j] = (1.0 - cc) * pc[j] + (hsig ? sqrt(cc * (2.0 - cc) * mueff) : 0.0) * yw[j];
+      double rankMu = 0.0;
+      for (int i = 0; i < mu; i++) rankMu += w[i] * y[urut[i]][j] * y[urut[i]][j];
+      diag[j] = (1.0 - c1 - cmu) * diag[j] +
+                c1 * (pc[j] * pc[j] + (hsig ? 0.0 : cc * (2.0 - cc) * diag[j])) + cmu * rankMu;
+      maksStd = std::max(maksStd, sqrt(diag[j]));
+    }
+    sigma *= exp((cs / ds) * (normPs / chiN - 1.0));
+    if (sigma > 1.0) sigma = 1.0;
+    if (sigma * maksStd < 1e-5) break;
+  }
+}
+
+}  // namespace
+
+HasilCari cari(const std::vector<DimensiCari> &dimensi, const OpsiCari &opsi, const EvaluasiBatch &evaluasi) {
+  Pelacak p(dimensi, opsi, evaluasi);
+  const size_t n = dimensi.size();
+  if (n == 0) return p.hasil;
+  switch (opsi.strategi) {
+    case CARI_GRID: cariGrid(p, n); break;
+    case CARI_ACAK: cariAcak(p, n, opsi); break;
+    case CARI_NELDER_MEAD: cariNelderMead(p, n, opsi); break;
+    case CARI_CMA_ES: cariCmaEs(p, n, opsi); break;
+  }
+  return p.hasil;
+}
+
+static const char *NAMA_STRATEGI[] = {"grid", "acak", "nm", "cma"};
+
+const char *namaStrategi(StrategiCari s) {
+  return NAMA_STRATEGI[s];
+}
+
+bool strategiDariNama(const char *nama, StrategiCari &out) {
+  for (int i = 0; i < 4; i++) {
+    if (!strcmp(nama, NAMA_STRATEGI[i])) {
+      out = (StrategiCari)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
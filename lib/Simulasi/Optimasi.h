@@ -0,0 +1,63 @@
+/**
+ * OPTIMASI KOTAK HITAM BERBASIS BATCH (NATIVE)
+ * * Deskripsi:
+ * Mencari x dalam batas [min, max] per dimensi yang meminimalkan biaya.
+ * Biaya dihitung oleh EvaluasiBatch: satu panggilan = sekumpulan kandidat,
+ * jadi pemanggil bebas mengevaluasinya paralel (lihat KolamKerja.h).
+ * - GRID: k titik per dimensi, k^n <= anggaran.
+ * - ACAK: seragam dalam batas (kandidat pertama = nilai awal).
+ * - NELDER_MEAD: simplex; refleksi, ekspansi & kedua kontraksi dievaluasi
+ *   sekaligus satu batch (spekulatif, 4 simulasi paralel per iterasi).
+ * - CMA_ES: varian kovarians diagonal (sep-CMA-ES), lambda = 4 + 3 ln n
+ *   (atau OpsiCari::batch jika lebih besar) kandidat per generasi.
+ * Semua strategi bekerja di ruang ternormalisasi [0, 1]^n; kandidat di luar
+ * batas dipotong ke batas sebelum dievaluasi.
+ */
+
+#ifndef AQUARIUM_OPTIMASI_H
+#define AQUARIUM_OPTIMASI_H
+
+#ifndef ARDUINO
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+struct DimensiCari {
+  const char *nama;
+  double min, max;
+  double awal;
+};
+
+typedef std::function<void(const std::vector<std::vector<double>> &kandidat, std::vector<double> &biaya)>
+    EvaluasiBatch;
+
+enum StrategiCari : uint8_t { CARI_GRID, CARI_ACAK, CARI_NELDER_MEAD, CARI_CMA_ES };
+
+struct OpsiCari {
+  StrategiCari strategi = CARI_CMA_ES;
+  size_t anggaran = 200;       // maksimum jumlah evaluasi
+  int batch = 16;              // kandidat per batch (ACAK, minimum lambda CMA-ES)
+  uint32_t seed = 1;
+  double langkahAwal = 0.2;    // simplex awal / sigma CMA-ES, fraksi rentang
+  // Dipanggil setelah tiap batch (opsional), mis. untuk progres
+  void (*progres)(size_t evaluasi, double biayaTerbaik, void *ctx) = nullptr;
+  void *ctxProgres = nullptr;
+};
+
+struct HasilCari {
+  std::vector<double> terbaik;
+  double biayaTerbaik = 0.0;
+  size_t jumlahEvaluasi = 0;
+  int jumlahBatch = 0;
+};
+
+HasilCari cari(const std::vector<DimensiCari> &dimensi, const OpsiCari &opsi, const EvaluasiBatch &evaluasi);
+
+const char *namaStrategi(StrategiCari s);
+// false jika nama tidak dikenal ("grid", "acak", "nm", "cma")
+bool strategiDariNama(const char *nama, StrategiCari &out);
+
+#endif
+#endif
@@ -0,0 +1,91 @@
+#ifndef ARDUINO
+
+#include "PlantAquarium.h"
+#include <math.h>
+
+void PlantAquarium::mulai(const ParameterPlant &param, double suhuAwal, double keruhAwal,
+                          double ruang, uint32_t seed) {
+  p = param;
+  suhu = suhuProbe = suhuAwal;
+  keruh = keruhAwal;
+  suhuRuang = ruang;
+  energiHeater = energiPompa = 0.0;
+  waktuUs = 0;
+  dutyHeater = dutyPompa = 0;
+  rng = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)seed << 1 | 1);
+}
+
+double PlantAquarium::seragam() {
+  rng ^= rng >> 12;
+  rng ^= rng << 25;
+  rng ^= rng >> 27;
+  return (double)((rng * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double PlantAquarium::normal() {
+  // Jumlah 4 seragam: mean 2, varians 1/3
+  return (seragam() + seragam() + seragam() + seragam() - 2.0) * 1.7320508075688772;
+}
+
+double PlantAquarium::wattHeater(double duty) const {
+  if (duty <= 0) return 0.0;
+  for (int i = 1; i < PLANT_KURVA_HEATER_N; i++) {
+    if (duty <= p.kurvaDuty[i]) {
+      double f = (duty - p.kurvaDuty[i - 1]) / (p.kurvaDuty[i] - p.kurvaDuty[i - 1]);
+      return p.kurvaWatt[i - 1] + f * (p.kurvaWatt[i] - p.kurvaWatt[i - 1]);
+    }
+  }
+  return p.kurvaWatt[PLANT_KURVA_HEATER_N - 1];
+}
+
+double PlantAquarium::fraksiAliran(double duty) const {
+  if (duty <= p.dutyMogokPompa) return 0.0;
+  return (duty - p.dutyMogokPompa) / (255 - p.dutyMogokPompa);
+}
+
+void PlantAquarium::tambahKeruh(double persen) {
+  keruh += persen;
+  if (keruh > 100.0) keruh = 100.0;
+  if (keruh < 0.0) keruh = 0.0;
+}
+
+void PlantAquarium::majuKe(uint64_t tUs) {
+  if (tUs <= waktuUs) return;
+  double dt = (double)(tUs - waktuUs) * 1e-6;
+  waktuUs = tUs;
+
+  // Termal: C dT/dt = W - UA (T - Truang)  ->  T menuju Truang + W/UA
+  double w = wattHeater(dutyHeater);
+  double suhuAkhir = suhuRuang + w / p.ua;
+  double suhuMulai = suhu;
+  suhu = suhuAkhir + (suhuMulai - suhuAkhir) * exp(-dt * p.ua / p.kapasitasPanas);
+
+  // Probe mengejar rata-rata suhu air selama langkah (air jauh lebih lambat dari probe)
+  double rata = 0.5 * (suhuMulai + suhu);
+  suhuProbe = rata + (suhuProbe - rata) * exp(-dt / p.tauProbe);
+
+  // Kekeruhan: dx/dt = sumber - (kAlami + kFilter * aliran) x   (per jam)
+  double q = fraksiAliran(dutyPompa);
+  double k = (p.kAlami + p.kFilter * q) / 3600.0;
+  double keruhAkhir = (p.sumberKeruh / 3600.0) / k;
+  keruh = keruhAkhir + (keruh - keruhAkhir) * exp(-k * dt);
+
+  energiHeater += w * dt;
+  energiPompa += p.wattPompa * dutyPompa / 255.0 * dt;   // motor mogok tetap menarik arus
+}
+
+float PlantAquarium::bacaProbe(uint8_t resolusiBit) {
+  double langkah = 0.0625 * (double)(1 << (12 - resolusiBit));
+  double v = suhuProbe + p.derauSuhu * normal();
+  return (float)(floor(v / langkah + 0.5) * langkah);
+}
+
+int16_t PlantAquarium::bacaAdc() {
+  double v = p.adcJernih + (p.adcKeruh - p.adcJernih) * keruh / 100.0 + p.derauAdc * normal();
+  if (seragam() < p.peluangGelembung) v += 2000.0 + 6000.0 * seragam();
+  if (v < 0.0) v = 0.0;
+  if (v > 32767.0) v = 32767.0;
+  return (int16_t)v;
+}
+
+#endif
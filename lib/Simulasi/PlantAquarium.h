@@ -0,0 +1,94 @@
+/**
+ * MODEL PLANT AQUARIUM (SIMULASI NATIVE)
+ * * Deskripsi:
+ * Model fisik sederhana untuk menguji kontrol tanpa tangki asli.
+ * - Termal: massa air C (J/K), heater = kurva PWM -> watt (driver L298N),
+ *   rugi ke udara UA (W/K) menuju suhu ruang (bisa berayun harian).
+ *   Probe DS18B20 punya lag orde-1 + kuantisasi resolusi.
+ * - Kekeruhan (%): sumber kotoran konstan + lonjakan (pemberian pakan),
+ *   dibersihkan pengendapan alami + filter pompa. Aliran pompa mati di bawah
+ *   duty mogok (dead band motor, di bawah PWM_MIN_FISIK), linear di atasnya.
+ *   Sensor: ADC = kalibrasi jernih..keruh + derau + gelembung (nilai tinggi).
+ * Duty dalam skala 8 bit (0-255, pecahan boleh) apa pun PWM_RESOLUTION
+ * firmware; simulator menskalakan duty HAL sebelum setDuty().
+ * Input (duty PWM) dianggap tetap di antara dua panggilan majuKe(), jadi
+ * langkah besar tetap eksak untuk bagian linear model (solusi eksponensial).
+ * Derau memakai xorshift64* + Irwin-Hall (4 seragam): jauh lebih murah dari
+ * mt19937 + normal_distribution, ekor dipotong di +/-3.5 sigma.
+ */
+
+#ifndef AQUARIUM_PLANT_AQUARIUM_H
+#define AQUARIUM_PLANT_AQUARIUM_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+
+const int PLANT_KURVA_HEATER_N = 6;
+
+struct ParameterPlant {
+  // --- Termal ---
+  double kapasitasPanas = 30.0 * 4186.0;   // 30 L air (J/K)
+  double ua = 2.5;                         // rugi panas ke udara (W/K)
+  // Kurva duty (0-255) -> watt ke air; default contoh heater 100 W lewat L298N
+  // (tegangan jatuh driver membuat duty kecil hampir tidak berdaya). Ganti
+  // dengan hasil ukur.
+  double kurvaDuty[PLANT_KURVA_HEATER_N] = {0, 32, 64, 128, 192, 255};
+  double kurvaWatt[PLANT_KURVA_HEATER_N] = {0, 6, 18, 44, 70, 95};
+  double tauProbe = 12.0;                  // lag probe DS18B20 di air (s)
+  double derauSuhu = 0.02;                 // derau pembacaan (C, std)
+
+  // --- Kekeruhan ---
+  double sumberKeruh = 3.0;                // %/jam (kotoran ikan)
+  double kAlami = 0.05;                    // 1/jam (pengendapan)
+  double kFilter = 6.0;                    // 1/jam pada aliran penuh
+  int dutyMogokPompa = 225;                // < PWM_MIN_FISIK: pompa tidak berputar
+  double wattPompa = 12.0;                 // daya listrik pompa pada aliran penuh
+  // Sensor: kalibrasi "sebenarnya" (firmware memakai NILAI_ADC_* miliknya)
+  int adcJernih = 20100;
+  int adcKeruh = 3550;
+  double derauAdc = 40.0;                  // count, std
+  double peluangGelembung = 0.01;          // per konversi, nilai melonjak ke atas
+};
+
+class PlantAquarium {
+public:
+  void mulai(const ParameterPlant &p, double suhuAwal, double keruhAwal, double suhuRuang, uint32_t seed);
+
+  // Integrasi sampai tUs (mikrodetik simulasi) dengan duty saat ini
+  void majuKe(uint64_t tUs);
+
+  void setDuty(double heater, double pompa) { dutyHeater = heater; dutyPompa = pompa; }
+  bool dutySama(double heater, double pompa) const { return heater == dutyHeater && pompa == dutyPompa; }
+  void setSuhuRuang(double c) { suhuRuang = c; }
+  void tambahKeruh(double persen);
+
+  double wattHeater(double duty) const;
+  double fraksiAliran(double duty) const;
+
+  // Pembacaan sensor (dengan derau, pakai RNG plant)
+  float bacaProbe(uint8_t resolusiBit);
+  int16_t bacaAdc();
+
+  // Nilai sebenarnya
+  double suhu = 25.0;        // air
+  double suhuProbe = 25.0;   // ujung probe (lag)
+  double keruh = 10.0;       // %
+  double suhuRuang = 25.0;
+
+  // Energi aktuator kumulatif (J)
+  double energiHeater = 0.0;
+  double energiPompa = 0.0;
+  uint64_t waktuUs = 0;
+
+private:
+  ParameterPlant p;
+  double dutyHeater = 0.0, dutyPompa = 0.0;
+  uint64_t rng = 1;
+
+  double seragam();   // [0, 1)
+  double normal();    // mean 0, std 1 (aproksimasi)
+};
+
+#endif
+#endif
@@ -0,0 +1,595 @@
+#ifndef ARDUINO
+
+#include "Replay.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Tick.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// =========================================================================
+//                  NAMA KOLOM
+// =========================================================================
+
+namespace {
+
+// Header CSV ekspor backend, kunci research_data (JSONL) & jejak tools/sim
+// (dicari per kunci JSON di setiap baris: panjang dibandingkan dulu, tanpa strlen)
+struct NamaKolom {
+  const char *nama;
+  uint8_t panjang;
+  KolomJejak kolom;
+};
+
+#define NAMA_KOLOM_(n, k) {n, sizeof(n) - 1, k}
+const NamaKolom NAMA_KOLOM[] = {
+  NAMA_KOLOM_("Timestamp", KOLOM_WAKTU), NAMA_KOLOM_("timestamp", KOLOM_WAKTU),
+  NAMA_KOLOM_("timestamp_ms", KOLOM_WAKTU), NAMA_KOLOM_("detik", KOLOM_WAKTU),
+  NAMA_KOLOM_("Control_Mode", KOLOM_MODE), NAMA_KOLOM_("kontrol_aktif", KOLOM_MODE),
+  NAMA_KOLOM_("Temp_Actual", KOLOM_SUHU), NAMA_KOLOM_("suhu", KOLOM_SUHU),
+  NAMA_KOLOM_("Temp_Setpoint", KOLOM_SETPOINT_SUHU), NAMA_KOLOM_("setpoint_suhu", KOLOM_SETPOINT_SUHU),
+  NAMA_KOLOM_("Temp_Error", KOLOM_ERROR_SUHU), NAMA_KOLOM_("error_suhu", KOLOM_ERROR_SUHU),
+  NAMA_KOLOM_("PWM_Heater", KOLOM_OUT_SUHU), NAMA_KOLOM_("pwm_heater", KOLOM_OUT_SUHU),
+  NAMA_KOLOM_("out_suhu", KOLOM_OUT_SUHU),
+  NAMA_KOLOM_("Turb_Actual", KOLOM_KERUH), NAMA_KOLOM_("turbidity_persen", KOLOM_KERUH),
+  NAMA_KOLOM_("Turb_Setpoint", KOLOM_SETPOINT_KERUH), NAMA_KOLOM_("setpoint_keruh", KOLOM_SETPOINT_KERUH),
+  NAMA_KOLOM_("Turb_Error", KOLOM_ERROR_KERUH), NAMA_KOLOM_("error_keruh", KOLOM_ERROR_KERUH),
+  NAMA_KOLOM_("PWM_Pump", KOLOM_OUT_KERUH), NAMA_KOLOM_("pwm_pompa", KOLOM_OUT_KERUH),
+  NAMA_KOLOM_("out_keruh", KOLOM_OUT_KERUH),
+};
+#undef NAMA_KOLOM_
+
+int cariKolom(const char *a, const char *e) {
+  const size_t n = (size_t)(e - a);
+  for (const NamaKolom &k : NAMA_KOLOM)
+    if (k.panjang == n && k.nama[0] == a[0] && memcmp(k.nama, a, n) == 0) return k.kolom;
+  return -1;
+}
+
+// =========================================================================
+//                  URAI ANGKA & WAKTU (RENTANG [p, e), TANPA NUL)
+// =========================================================================
+
+inline bool digit(char c) { return c >= '0' && c <= '9'; }
+
+inline void lewatiSpasi(const char *&p, const char *e) {
+  while (p < e && (*p == ' ' || *p == '\t')) p++;
+}
+
+// Desimal sederhana: mantisa 64 bit dibagi / dikali 10^k yang eksak (<= 1e22),
+// benar-dibulatkan untuk angka telemetri (<= 15 digit signifikan)
+bool uraiAngka(const char *&p, const char *e, double &x) {
+  static const double PANGKAT10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  bool negatif = false;
+  if (p < e && (*p == '-' || *p == '+')) negatif = (*p++ == '-');
+  uint64_t m = 0;
+  int eks = 0;
+  bool ada = false;
+  for (; p < e && digit(*p); p++, ada = true) {
+    if (m < 100000000000000000ULL) m = m * 10 + (uint64_t)(*p - '0');
+    else eks++;
+  }
+  if (p < e && *p == '.') {
+    for (p++; p < e && digit(*p); p++, ada = true) {
+      if (m < 100000000000000000ULL) {
+        m = m * 10 + (uint64_t)(*p - '0');
+        eks--;
+      }
+    }
+  }
+  if (!ada) return false;
+  if (p < e && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    bool eNeg = false;
+    if (q < e && (*q == '-' || *q == '+')) eNeg = (*q++ == '-');
+    if (q < e && digit(*q)) {
+      int v = 0;
+      for (; q < e && digit(*q); q++) v = (v < 1000) ? v * 10 + (*q - '0') : v;
+      eks += eNeg ? -v : v;
+      p = q;
+    }
+  }
+  double v = (double)m;
+  if (eks < 0) v = (eks >= -22) ? v / PANGKAT10[-eks] : v * pow(10.0, eks);
+  else if (eks > 0) v = (eks <= 22) ? v * PANGKAT10[eks] : v * pow(10.0, eks);
+  x = negatif ? -v : v;
+  return true;
+}
+
+bool uraiDuaDigit(const char *&p, const char *e, int &v) {
+  if (e - p < 2 || !digit(p[0]) || !digit(p[1])) return false;
+  v = (p[0] - '0') * 10 + (p[1] - '0');
+  p += 2;
+  return true;
+}
+
+// Hari sejak 1970-01-01 (kalender Gregorian proleptik)
+int64_t hariDariTanggal(int y, int m, int d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const int64_t thn = y - era * 400;
+  const int64_t hariThn = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const int64_t hariEra = thn * 365 + thn / 4 - thn / 100 + hariThn;
+  return era * 146097 + hariEra - 719468;
+}
+
+// "YYYY-MM-DD[T ]HH:MM[:SS[.fff]]..." atau angka (epoch ms, atau detik jika detik = true)
+bool uraiWaktu(const char *p, const char *e, int64_t &ms, bool detik) {
+  lewatiSpasi(p, e);
+  const char *q = p;
+  int tahun = 0, n = 0;
+  for (; q < e && digit(*q) && n < 5; q++, n++) tahun = tahun * 10 + (*q - '0');
+  if (n == 4 && q < e && *q == '-') {
+    int bulan, hari, jam = 0, menit = 0, dtk = 0, milidtk = 0;
+    q++;
+    if (!uraiDuaDigit(q, e, bulan) || q >= e || *q++ != '-' || !uraiDuaDigit(q, e, hari)) return false;
+    if (bulan < 1 || bulan > 12 || hari < 1 || hari > 31) return false;
+    if (q < e && (*q == 'T' || *q == ' ')) {
+      q++;
+      if (!uraiDuaDigit(q, e, jam) || q >= e || *q++ != ':' || !uraiDuaDigit(q, e, menit)) return false;
+      if (q < e && *q == ':') {
+        q++;
+        if (!uraiDuaDigit(q, e, dtk)) return false;
+        if (q < e && *q == '.') {
+          int skala = 100;
+          for (q++; q < e && digit(*q); q++, skala /= 10) milidtk += (*q - '0') * skala;
+        }
+      }
+    }
+    ms = (((hariDariTanggal(tahun, bulan, hari) * 24 + jam) * 60 + menit) * 60 + dtk) * 1000 + milidtk;
+    return true;
+  }
+  double x;
+  if (!uraiAngka(p, e, x)) return false;
+  ms = (int64_t)llround(detik ? x * 1000.0 : x);
+  return true;
+}
+
+bool uraiMode(const char *p, const char *e, ControlMode &m) {
+  while (p < e && (*p == ' ' || *p == '"')) p++;
+  if (p >= e) return false;
+  if (*p == 'F' || *p == 'f') m = FUZZY;
+  else if (*p == 'P' || *p == 'p') m = PID;
+  else if (*p == 'M' || *p == 'm') m = MPC;
+  else return false;
+  return true;
+}
+
+// Lewati satu nilai JSON; p berhenti tepat setelahnya
+bool lewatiNilaiJson(const char *&p, const char *e) {
+  if (p >= e) return false;
+  if (*p == '"') {
+    for (p++; p < e; p++) {
+      if (*p == '\\') p++;
+      else if (*p == '"') {
+        p++;
+        return true;
+      }
+    }
+    return false;
+  }
+  if (*p == '{' || *p == '[') {
+    int dalam = 0;
+    while (p < e) {
+      const char c = *p;
+      if (c == '"') {
+        if (!lewatiNilaiJson(p, e)) return false;
+        continue;
+      }
+      if (c == '{' || c == '[') dalam++;
+      else if (c == '}' || c == ']') {
+        if (--dalam == 0) {
+          p++;
+          return true;
+        }
+      }
+      p++;
+    }
+    return false;
+  }
+  while (p < e && *p != ',' && *p != '}' && *p != ']' && *p != ' ' && *p != '\t') p++;
+  return true;
+}
+
+// Nilai timestamp mongoexport: "ISO", angka, {"$date":"ISO"}, {"$date":{"$numberLong":"ms"}}
+bool uraiWaktuJson(const char *p, const char *e, int64_t &ms) {
+  lewatiSpasi(p, e);
+  while (p < e && *p == '{') {
+    // Ambil nilai kunci pertama objek ($date / $numberLong)
+    while (p < e && *p != ':') p++;
+    if (p >= e) return false;
+    p++;
+    lewatiSpasi(p, e);
+  }
+  if (p < e && *p == '"') p++;
+  return uraiWaktu(p, e, ms, false);
+}
+
+void isiNilai(SampelRekaman &s, int kolom, float v) {
+  switch (kolom) {
+    case KOLOM_SUHU: s.suhu = v; break;
+    case KOLOM_SETPOINT_SUHU: s.setpointSuhu = v; break;
+    case KOLOM_ERROR_SUHU: s.errorSuhu = v; break;
+    case KOLOM_OUT_SUHU: s.outSuhu = v; break;
+    case KOLOM_KERUH: s.keruh = v; break;
+    case KOLOM_SETPOINT_KERUH: s.setpointKeruh = v; break;
+    case KOLOM_ERROR_KERUH: s.errorKeruh = v; break;
+    case KOLOM_OUT_KERUH: s.outKeruh = v; break;
+    default: break;
+  }
+}
+
+void kosongkan(SampelRekaman &s) {
+  s.ms = 0;
+  s.adaMode = false;
+  s.mode = FUZZY;
+  s.suhu = s.errorSuhu = s.setpointSuhu = NAN;
+  s.keruh = s.errorKeruh = s.setpointKeruh = NAN;
+  s.outSuhu = s.outKeruh = NAN;
+}
+
+// Error firmware: suhu = setpoint - aktual, keruh = aktual - setpoint
+bool lengkapi(SampelRekaman &s) {
+  if (isnan(s.suhu) || isnan(s.keruh)) return false;
+  if (isnan(s.errorSuhu)) s.errorSuhu = s.setpointSuhu - s.suhu;
+  if (isnan(s.errorKeruh)) s.errorKeruh = s.keruh - s.setpointKeruh;
+  return !isnan(s.errorSuhu) && !isnan(s.errorKeruh);
+}
+
+// Akhir baris [p, return) tanpa '\r'; berikut = awal baris selanjutnya
+inline const char *akhirBaris(const char *p, const char *e, const char *&berikut) {
+  const char *nl = (const char *)memchr(p, '\n', (size_t)(e - p));
+  berikut = nl ? nl + 1 : e;
+  const char *b = nl ? nl : e;
+  if (b > p && b[-1] == '\r') b--;
+  return b;
+}
+
+}  // namespace
+
+// =========================================================================
+//                  BERKAS
+// =========================================================================
+
+BerkasJejak::~BerkasJejak() { tutup(); }
+
+void BerkasJejak::tutup() {
+#if !defined(_WIN32)
+  if (ukuranPeta) munmap((void *)awalBerkas, ukuranPeta);
+#endif
+  free(salinan);
+  salinan = nullptr;
+  ukuranPeta = 0;
+  awalBerkas = awalData = akhirData = nullptr;
+}
+
+bool BerkasJejak::buka(const char *path) {
+  tutup();
+#if !defined(_WIN32)
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    pesanGalat = "tidak bisa dibuka";
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    pesanGalat = "berkas kosong";
+    return false;
+  }
+  void *peta = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (peta == MAP_FAILED) {
+    pesanGalat = "mmap gagal";
+    return false;
+  }
+  madvise(peta, (size_t)st.st_size, MADV_SEQUENTIAL);
+  ukuranPeta = (size_t)st.st_size;
+  awalBerkas = (const char *)peta;
+  akhirData = awalBerkas + ukuranPeta;
+#else
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    pesanGalat = "tidak bisa dibuka";
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  const long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  salinan = (n > 0) ? (char *)malloc((size_t)n) : nullptr;
+  const bool ok = salinan && fread(salinan, 1, (size_t)n, f) == (size_t)n;
+  fclose(f);
+  if (!ok) {
+    pesanGalat = "berkas kosong / gagal dibaca";
+    return false;
+  }
+  awalBerkas = salinan;
+  akhirData = salinan + n;
+#endif
+  return siapkan();
+}
+
+bool BerkasJejak::bukaMemori(const char *teks, size_t len) {
+  tutup();
+  awalBerkas = teks;
+  akhirData = teks + len;
+  return siapkan();
+}
+
+bool BerkasJejak::siapkan() {
+  const char *p = awalBerkas;
+  if (akhirData - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3;   // BOM ekspor CSV backend
+  while (p < akhirData && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+  if (p >= akhirData) {
+    pesanGalat = "berkas kosong";
+    return false;
+  }
+  if (*p == '[') {
+    pesanGalat = "array JSON tidak didukung (mongoexport tanpa --jsonArray)";
+    return false;
+  }
+  if (*p == '{') {
+    fmt = JEJAK_JSONL;
+    awalData = p;
+    return true;
+  }
+
+  // CSV: petakan header
+  fmt = JEJAK_CSV;
+  const char *berikut;
+  const char *e = akhirBaris(p, akhirData, berikut);
+  memset(jenisKolom, -1, sizeof(jenisKolom));
+  bool adaWaktu = false;
+  waktuDetik = false;
+  for (int k = 0; k < MAKS_KOLOM_CSV && p <= e; k++) {
+    const char *a = p;
+    while (p < e && *p != ',') p++;
+    const char *b = p;
+    while (a < b && (*a == '"' || *a == ' ')) a++;
+    while (b > a && (b[-1] == '"' || b[-1] == ' ')) b--;
+    const int kolom = cariKolom(a, b);
+    if (kolom >= 0) {
+      jenisKolom[k] = (int8_t)kolom;
+      if (kolom == KOLOM_WAKTU) {
+        adaWaktu = true;
+        waktuDetik = (b - a == 5 && memcmp(a, "detik", 5) == 0);
+      }
+    }
+    p++;
+  }
+  if (!adaWaktu) {
+    pesanGalat = "header CSV tanpa kolom waktu (Timestamp)";
+    return false;
+  }
+  awalData = berikut;
+  return true;
+}
+
+bool BerkasJejak::uraiBaris(const char *p, const char *e, SampelRekaman &s, bool hanyaWaktu) const {
+  kosongkan(s);
+  bool adaWaktu = false;
+
+  if (fmt == JEJAK_CSV) {
+    for (int k = 0; k < MAKS_KOLOM_CSV && p <= e; k++) {
+      const char *a, *b;
+      if (p < e && *p == '"') {
+        a = ++p;
+        while (p < e && *p != '"') p++;
+        b = p;
+        while (p < e && *p != ',') p++;
+      } else {
+        a = p;
+        while (p < e && *p != ',') p++;
+        b = p;
+      }
+      p++;
+      const int kolom = jenisKolom[k];
+      if (kolom < 0) continue;
+      if (kolom == KOLOM_WAKTU) {
+        adaWaktu = uraiWaktu(a, b, s.ms, waktuDetik);
+        if (hanyaWaktu) return adaWaktu;
+      } else if (hanyaWaktu) {
+        continue;
+      } else if (kolom == KOLOM_MODE) {
+        s.adaMode = uraiMode(a, b, s.mode);
+      } else {
+        double x;
+        if (uraiAngka(a, b, x)) isiNilai(s, kolom, (float)x);
+      }
+    }
+    return adaWaktu && (hanyaWaktu || lengkapi(s));
+  }
+
+  // JSONL: satu objek per baris; "timestamp" (waktu dinding) lebih diutamakan dari timestamp_ms
+  bool waktuDinding = false;
+  lewatiSpasi(p, e);
+  if (p >= e || *p++ != '{') return false;
+  for (;;) {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == ',')) p++;
+    if (p >= e) return false;
+    if (*p == '}') break;
+    if (*p != '"') return false;
+    const char *ka = ++p;
+    while (p < e && *p != '"') p++;
+    if (p >= e) return false;
+    const char *ke = p++;
+    lewatiSpasi(p, e);
+    if (p >= e || *p++ != ':') return false;
+    lewatiSpasi(p, e);
+    const char *va = p;
+    if (!lewatiNilaiJson(p, e)) return false;
+
+    const int kolom = cariKolom(ka, ke);
+    if (kolom < 0) continue;
+    if (kolom == KOLOM_WAKTU) {
+      const bool dinding = (ke - ka == 9);   // "timestamp"
+      if (waktuDinding && !dinding) continue;
+      int64_t ms;
+      if (uraiWaktuJson(va, p, ms)) {
+        s.ms = ms;
+        adaWaktu = true;
+        waktuDinding = dinding;
+        if (hanyaWaktu && dinding) return true;   // indeks: sisa baris tidak perlu diurai
+      }
+    } else if (hanyaWaktu) {
+      continue;
+    } else if (kolom == KOLOM_MODE) {
+      s.adaMode = uraiMode(va, p, s.mode);
+    } else {
+      double x;
+      if (uraiAngka(va, p, x)) isiNilai(s, kolom, (float)x);
+    }
+  }
+  return adaWaktu && (hanyaWaktu || lengkapi(s));
+}
+
+std::vector<SegmenJejak> BerkasJejak::indeks(uint32_t celahMs) const {
+  std::vector<SegmenJejak> hasil;
+  SegmenJejak seg = {awalData, awalData, 0};
+  int64_t terakhir = 0;
+  bool ada = false;
+  SampelRekaman s;
+  for (const char *p = awalData, *berikut; p < akhirData; p = berikut) {
+    const char *e = akhirBaris(p, akhirData, berikut);
+    if (e > p && uraiBaris(p, e, s, true)) {
+      if (ada && (s.ms < terakhir || s.ms - terakhir > (int64_t)celahMs)) {
+        seg.akhir = p;
+        hasil.push_back(seg);
+        seg = {p, p, 0};
+      }
+      terakhir = s.ms;
+      ada = true;
+    }
+    seg.jumlahBaris++;
+  }
+  seg.akhir = akhirData;
+  if (seg.jumlahBaris) hasil.push_back(seg);
+  return hasil;
+}
+
+bool PembacaJejak::berikut(SampelRekaman &s) {
+  while (p < akhir) {
+    const char *a = p;
+    const char *e = akhirBaris(a, akhir, p);
+    if (e == a) continue;
+    if (berkas.uraiBaris(a, e, s)) return true;
+    ditolak++;
+  }
+  return false;
+}
+
+// =========================================================================
+//                  PUTAR ULANG
+// =========================================================================
+
+void MetrikSelisih::catat(double rekam, double ulang, int64_t ms, double toleransi) {
+  if (isnan(rekam)) return;
+  const double d = fabs(ulang - rekam);
+  jumlah++;
+  totalAbs += d;
+  totalKuadrat += d * d;
+  totalRekam += rekam;
+  totalUlang += ulang;
+  if (d > toleransi) beda++;
+  if (d > maks || jumlah == 1) {
+    maks = d;
+    msMaks = ms;
+  }
+}
+
+void MetrikSelisih::gabung(const MetrikSelisih &m) {
+  if (m.jumlah && (m.maks > maks || jumlah == 0)) {
+    maks = m.maks;
+    msMaks = m.msMaks;
+  }
+  jumlah += m.jumlah;
+  beda += m.beda;
+  totalAbs += m.totalAbs;
+  totalKuadrat += m.totalKuadrat;
+  totalRekam += m.totalRekam;
+  totalUlang += m.totalUlang;
+}
+
+double MetrikSelisih::rms() const { return jumlah ? sqrt(totalKuadrat / jumlah) : 0.0; }
+
+void HasilReplay::gabung(const HasilReplay &h) {
+  sampel += h.sampel;
+  ditolak += h.ditolak;
+  segmen += h.segmen;
+  gantiMode += h.gantiMode;
+  kembar += h.kembar;
+  suhu.gabung(h.suhu);
+  keruh.gabung(h.keruh);
+}
+
+HasilReplay putarUlangSegmen(const BerkasJejak &b, const SegmenJejak &seg, const OpsiReplay &o, std::string *beda) {
+  HasilReplay h;
+  h.segmen = 1;
+  const AturanFuzzy &af = o.aturan ? *o.aturan : aturanFuzzy;
+  ParameterKontrol p = o.param;
+  StateKontrol st;
+  PembacaJejak r(b, seg);
+  SampelRekaman s, lalu;
+  bool pertama = true;
+  int64_t t0 = 0;
+  unsigned long nowLalu = 0, keruhBerikut = 0;
+
+  while (r.berikut(s)) {
+    if (pertama) t0 = s.ms;
+    // Waktu relatif segmen, seperti millis() sejak boot
+    const unsigned long now = (unsigned long)(s.ms - t0);
+    if (!pertama && now == nowLalu) {
+      h.kembar++;
+      continue;
+    }
+
+    // Tick keruh firmware di antara dua sampel telemetri: sensor diinterpolasi linear
+    if (!pertama && o.subLangkahKeruh) {
+      const float selang = (float)(now - nowLalu);
+      for (; keruhBerikut + PERIODE_KERUH_MS / 2 <= now; keruhBerikut += PERIODE_KERUH_MS) {
+        const float a = (float)(keruhBerikut - nowLalu) / selang;
+        hitungKontrolKeruh(st, p, lalu.errorKeruh + a * (s.errorKeruh - lalu.errorKeruh),
+                           lalu.keruh + a * (s.keruh - lalu.keruh), keruhBerikut, af);
+      }
+    }
+
+    const ControlMode mode = o.paksaMode ? o.mode : (s.adaMode ? s.mode : p.kontrolAktif);
+    if (pertama) {
+      p.kontrolAktif = mode;
+      resetPID(st, now);
+    } else if (mode != p.kontrolAktif) {
+      p.kontrolAktif = mode;
+      resetPID(st, now);
+      h.gantiMode++;
+    }
+
+    const double outSuhu = hitungKontrolSuhu(st, p, s.errorSuhu, now, af);
+    const double outKeruh = hitungKontrolKeruh(st, p, s.errorKeruh, s.keruh, now, af);
+    keruhBerikut = now + PERIODE_KERUH_MS;
+
+    h.sampel++;
+    h.suhu.catat(s.outSuhu, outSuhu, s.ms, o.toleransi);
+    h.keruh.catat(s.outKeruh, outKeruh, s.ms, o.toleransi);
+    if (beda && (fabs(s.outSuhu - outSuhu) > o.toleransi || fabs(s.outKeruh - outKeruh) > o.toleransi)) {
+      char baris[128];
+      int n = snprintf(baris, sizeof(baris), "%lld,%s,%.2f,%.2f,%.2f,%.2f\n", (long long)s.ms,
+                       namaMode(mode), s.outSuhu, outSuhu, s.outKeruh, outKeruh);
+      if (n > 0) beda->append(baris, (size_t)n < sizeof(baris) ? (size_t)n : sizeof(baris) - 1);
+    }
+    lalu = s;
+    nowLalu = now;
+    pertama = false;
+  }
+  h.ditolak = r.ditolak;
+  return h;
+}
+
+#endif
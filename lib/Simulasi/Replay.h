@@ -0,0 +1,157 @@
+/**
+ * PUTAR ULANG JEJAK DATA RISET (HOST)
+ * * Deskripsi:
+ * Sampel research_data yang sudah terekam (ekspor CSV backend
+ * /api/export/csv/range atau JSONL mongoexport) dialirkan lagi ke kernel
+ * kontrol firmware (hitungKontrolSuhu/Keruh -> Fuzzy / PID / MPC) dengan
+ * parameter kandidat; output tiap sampel dibandingkan dengan yang terekam.
+ * - Berkas di-mmap, baris diurai langsung dari halaman berkas (tanpa
+ *   salinan baris, tanpa alokasi per sampel). Kolom CSV dipetakan dari
+ *   header, kunci JSON yang tidak dikenal dilewati.
+ * - Jejak dipotong menjadi segmen di setiap celah waktu > celahMs atau waktu
+ *   mundur (reboot, putus, kiriman ulang store-and-forward). Segmen saling
+ *   bebas (state kontroler direset seperti saat boot), jadi bisa dibagi ke
+ *   banyak thread; hasil digabung urut segmen (deterministik).
+ * - Loop terbuka: input = error / sensor terekam, output kandidat tidak
+ *   mengubah plant. Setpoint ikut rekaman; ganti mode -> resetPID (firmware).
+ * - Loop keruh dijalankan tiap PERIODE_KERUH_MS di antara sampel (firmware
+ *   4x lebih cepat dari telemetri), sensor diinterpolasi linear antar sampel.
+ * - Waktu: ISO 8601 / "YYYY-MM-DD HH:MM:SS" (zona diabaikan: hanya selisih
+ *   yang dipakai) atau angka epoch ms.
+ */
+
+#ifndef AQUARIUM_REPLAY_H
+#define AQUARIUM_REPLAY_H
+
+#ifndef ARDUINO
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "Kontrol.h"
+
+#ifndef REPLAY_CELAH_MS
+#define REPLAY_CELAH_MS 60000   // selang antar sampel lebih dari ini = segmen baru
+#endif
+
+enum FormatJejak : uint8_t { JEJAK_CSV, JEJAK_JSONL };
+
+enum KolomJejak : uint8_t {
+  KOLOM_WAKTU = 0,
+  KOLOM_MODE,
+  KOLOM_SUHU,
+  KOLOM_SETPOINT_SUHU,
+  KOLOM_ERROR_SUHU,
+  KOLOM_OUT_SUHU,      // pwm_heater di research_data (0-100%)
+  KOLOM_KERUH,
+  KOLOM_SETPOINT_KERUH,
+  KOLOM_ERROR_KERUH,
+  KOLOM_OUT_KERUH,     // pwm_pompa (0-100%)
+  JUMLAH_KOLOM_JEJAK
+};
+
+struct SampelRekaman {
+  int64_t ms;                 // waktu dinding (ms)
+  bool adaMode;
+  ControlMode mode;
+  float suhu, errorSuhu, setpointSuhu;
+  float keruh, errorKeruh, setpointKeruh;
+  float outSuhu, outKeruh;    // NAN jika tidak terekam
+};
+
+// Rentang byte berisi baris-baris satu segmen (menunjuk ke isi berkas)
+struct SegmenJejak {
+  const char *awal, *akhir;
+  uint32_t jumlahBaris;
+};
+
+class BerkasJejak {
+public:
+  BerkasJejak() = default;
+  ~BerkasJejak();
+  BerkasJejak(const BerkasJejak &) = delete;
+  BerkasJejak &operator=(const BerkasJejak &) = delete;
+
+  // mmap berkas (read-only) + deteksi format + header CSV; false -> galat()
+  bool buka(const char *path);
+  // Teks di memori milik pemanggil (harus hidup selama objek ini dipakai)
+  bool bukaMemori(const char *teks, size_t len);
+
+  FormatJejak format() const { return fmt; }
+  size_t ukuran() const { return (size_t)(akhirData - awalBerkas); }
+  const char *galat() const { return pesanGalat; }
+
+  // Potong jejak (hanya kolom waktu yang diurai); segmen menutupi semua baris data
+  std::vector<SegmenJejak> indeks(uint32_t celahMs = REPLAY_CELAH_MS) const;
+
+  // Urai satu baris [p, e) tanpa '\n'; false jika baris rusak / kolom wajib hilang
+  bool uraiBaris(const char *p, const char *e, SampelRekaman &s, bool hanyaWaktu = false) const;
+
+private:
+  bool siapkan();
+  void tutup();
+
+  static const int MAKS_KOLOM_CSV = 32;
+
+  const char *awalBerkas = nullptr;   // seluruh berkas
+  const char *awalData = nullptr;     // setelah BOM / header CSV
+  const char *akhirData = nullptr;
+  size_t ukuranPeta = 0;              // != 0 -> munmap saat tutup
+  char *salinan = nullptr;            // tanpa mmap (Windows): isi berkas di heap
+  FormatJejak fmt = JEJAK_CSV;
+  int8_t jenisKolom[MAKS_KOLOM_CSV];  // KolomJejak per kolom CSV, -1 = dilewati
+  bool waktuDetik = false;            // kolom waktu CSV dalam detik (jejak tools/sim)
+  const char *pesanGalat = "";
+};
+
+// Baca sampel satu segmen berurutan
+class PembacaJejak {
+public:
+  PembacaJejak(const BerkasJejak &b, const SegmenJejak &s) : berkas(b), p(s.awal), akhir(s.akhir) {}
+  bool berikut(SampelRekaman &s);
+  uint64_t ditolak = 0;
+
+private:
+  const BerkasJejak &berkas;
+  const char *p, *akhir;
+};
+
+struct OpsiReplay {
+  ParameterKontrol param;               // kandidat (setpoint diabaikan: ikut rekaman)
+  const AturanFuzzy *aturan = nullptr;  // nullptr = aturanFuzzy global (hanya dibaca)
+  bool paksaMode = false;               // false = mode per sampel dari rekaman
+  ControlMode mode = FUZZY;
+  bool subLangkahKeruh = true;          // loop keruh tiap PERIODE_KERUH_MS seperti firmware
+  double toleransi = 0.5;               // |selisih| output (%) yang dihitung "beda"
+};
+
+struct MetrikSelisih {
+  uint64_t jumlah = 0, beda = 0;
+  double totalAbs = 0.0, totalKuadrat = 0.0;
+  double maks = 0.0;
+  int64_t msMaks = 0;
+  double totalRekam = 0.0, totalUlang = 0.0;   // rata-rata output = proksi energi
+
+  void catat(double rekam, double ulang, int64_t ms, double toleransi);
+  void gabung(const MetrikSelisih &m);
+  double mae() const { return jumlah ? totalAbs / jumlah : 0.0; }
+  double rms() const;
+};
+
+struct HasilReplay {
+  uint64_t sampel = 0, ditolak = 0, segmen = 0, gantiMode = 0;
+  uint64_t kembar = 0;   // waktu sama dengan sampel sebelumnya (resolusi detik CSV): dilewati
+  MetrikSelisih suhu, keruh;
+
+  void gabung(const HasilReplay &h);
+};
+
+// Putar ulang satu segmen. beda != nullptr: baris CSV
+// "waktu_ms,mode,out_suhu_rekam,out_suhu_ulang,out_keruh_rekam,out_keruh_ulang"
+// untuk setiap sampel yang selisihnya > toleransi ditambahkan ke sana.
+HasilReplay putarUlangSegmen(const BerkasJejak &b, const SegmenJejak &seg, const OpsiReplay &o,
+                             std::string *beda = nullptr);
+
+#endif
+#endif
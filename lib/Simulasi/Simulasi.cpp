@@ -0,0 +1,324 @@
+#ifndef ARDUINO
+
+#include "Simulasi.h"
+#include <math.h>
+#include <memory>
+#include "Aktuator.h"
+#include "HalNative.h"
+#include "Penjadwal.h"
+#include "Sensor.h"
+
+// =========================================================================
+//                  SKENARIO BAWAAN
+// =========================================================================
+
+const Skenario SKENARIO_STANDAR[] = {
+  // Naik dari suhu ruang ke setpoint, lalu step +2 C
+  {"step_suhu", 12, 25.0, 15.0, 25.0, 0.0, 2, {
+    {0, SETPOINT_SUHU, 28.0}, {6 * 3600, SETPOINT_SUHU, 30.0}}},
+  // Siang-malam: ruang 24 +/- 3 C, setpoint tetap
+  {"ayunan_ruang", 48, 28.0, 15.0, 24.0, 3.0, 0, {}},
+  // Pemberian pakan: kekeruhan melonjak 3x sehari
+  {"lonjakan_keruh", 24, 28.0, 15.0, 25.0, 0.0, 3, {
+    {2 * 3600, LONJAKAN_KERUH, 20.0}, {10 * 3600, LONJAKAN_KERUH, 20.0}, {18 * 3600, LONJAKAN_KERUH, 20.0}}},
+  // Step setpoint kekeruhan naik lalu turun
+  {"step_keruh", 12, 28.0, 15.0, 25.0, 0.0, 2, {
+    {4 * 3600, SETPOINT_KERUH, 25.0}, {8 * 3600, SETPOINT_KERUH, 12.0}}},
+  // Ruang dingin: heater mendekati jenuh
+  {"ruang_dingin", 12, 20.0, 15.0, 18.0, 0.0, 1, {
+    {6 * 3600, SUHU_RUANG, 15.0}}},
+  // Semua sekaligus
+  {"gabungan", 24, 26.0, 30.0, 22.0, 4.0, 4, {
+    {0, SETPOINT_SUHU, 27.0}, {8 * 3600, LONJAKAN_KERUH, 25.0},
+    {12 * 3600, SETPOINT_SUHU, 29.0}, {16 * 3600, LONJAKAN_KERUH, 25.0}}},
+};
+const int JUMLAH_SKENARIO_STANDAR = sizeof(SKENARIO_STANDAR) / sizeof(SKENARIO_STANDAR[0]);
+
+// =========================================================================
+//                  HAL DI ATAS PLANT
+// =========================================================================
+
+namespace {
+
+// DS18B20: konversi selesai setelah waktu datasheet resolusi aktif
+class SuhuSim : public HalSuhu {
+public:
+  SuhuSim(PlantAquarium &plant, SimClock &jam) : plant(plant), jam(jam) {}
+  uint8_t mulai(uint8_t resolusiBit) override { resolusi = resolusiBit; return 1; }
+  void setResolusi(uint8_t resolusiBit) override { resolusi = resolusiBit; }
+  void mintaKonversi() override { selesaiUs = jam.us + PipelineSuhu::waktuKonversiMs(resolusi) * 1000ULL; }
+  bool konversiSelesai() override { return jam.us >= selesaiUs; }
+  float bacaC(uint8_t) override {
+    plant.majuKe(jam.us);
+    return plant.bacaProbe(resolusi);
+  }
+private:
+  PlantAquarium &plant;
+  SimClock &jam;
+  uint8_t resolusi = 12;
+  uint64_t selesaiUs = 0;
+};
+
+// Metrik satu loop; "jendela" baru dibuka tiap step setpoint / gangguan
+struct PelacakMetrik {
+  MetrikLoop m;
+  double pita = 0.5;
+  double arah = 0.0;          // +1 naik ke setpoint, -1 turun, 0 = sudah di pita
+  double mulaiJendela = 0.0;
+  double terakhirLuar = -1.0;
+  bool diLuar = false;
+  bool belumStabil = false;
+
+  void tutupJendela() {
+    if (diLuar) belumStabil = true;
+    else if (terakhirLuar >= 0.0 && terakhirLuar - mulaiJendela > m.settlingDetik)
+      m.settlingDetik = terakhirLuar - mulaiJendela;
+  }
+  void jendelaBaru(double t, double y, double sp) {
+    tutupJendela();
+    arah = (fabs(sp - y) > pita) ? ((sp > y) ? 1.0 : -1.0) : 0.0;
+    mulaiJendela = t;
+    terakhirLuar = -1.0;
+    diLuar = false;
+  }
+  void catat(double t, double dt, double y, double sp) {
+    double e = sp - y;
+    m.iae += fabs(e) * dt;
+    m.ise += e * e * dt;
+    if (arah != 0.0 && arah * (y - sp) > m.overshoot) m.overshoot = arah * (y - sp);
+    diLuar = fabs(e) > pita;
+    if (diLuar) terakhirLuar = t;
+  }
+  void selesai() {
+    tutupJendela();
+    if (belumStabil) m.settlingDetik = -1.0;
+  }
+};
+
+// Semua state satu simulasi (firmware: variabel global di main.cpp)
+struct KonteksSim {
+  SimClock jam;
+  PlantAquarium plant;
+  NativeAdc adc;
+  SuhuSim suhu{plant, jam};
+  NativePwm pwm;
+  NativeMqtt mqtt;
+  Hal hal = {&jam, &adc, &suhu, &pwm, &mqtt};
+  SensorAquarium sensor;
+  ParameterKontrol param;
+  StateKontrol state;
+  Telemetri telemetri = {};
+  const OpsiSimulasi *opsi;
+  const AturanFuzzy *aturan;
+};
+
+// Loop Penjadwal hanya menerima fungsi tanpa konteks -> konteks per thread
+thread_local KonteksSim *ks = nullptr;
+
+void loopSampel() {
+  ks->sensor.turbidity.layani(ks->adc, (uint32_t)ks->jam.micros());
+  ks->sensor.suhu.layani(ks->suhu, ks->jam.millis());
+}
+void loopSuhu() {
+  tickSuhu(ks->hal, ks->sensor, ks->param, ks->state, ks->telemetri, *ks->aturan, ks->opsi->kalibrasi, ks->opsi->autotune);
+}
+void loopKeruh() {
+  tickKeruh(ks->hal, ks->sensor, ks->param, ks->state, ks->telemetri, *ks->aturan, ks->opsi->kalibrasi, ks->opsi->autotune);
+}
+void loopJejak() {
+  ks->telemetri.timestamp_ms = ks->jam.millis();
+  ks->opsi->jejak(ks->telemetri, ks->opsi->ctxJejak);
+}
+
+void tambahLoopFirmware(Penjadwal<4> &jadwal) {
+  jadwal.tambah("sampel", PERIODE_SAMPEL_MS * 1000, 0, loopSampel);
+  jadwal.tambah("suhu", PERIODE_SUHU_MS * 1000, FASA_SUHU_MS * 1000, loopSuhu);
+  jadwal.tambah("keruh", PERIODE_KERUH_MS * 1000, FASA_KERUH_MS * 1000, loopKeruh);
+}
+
+// Urutan setup() firmware
+void mulaiFirmware(KonteksSim &c) {
+  c.sensor.turbidity.mulai(c.adc, TURBIDITY_JENDELA, TURBIDITY_SPS);
+  c.sensor.suhu.mulai(c.suhu, SUHU_RESOLUSI);
+  resetPID(c.state, 0);
+}
+
+// Pulsa ADC jatuh tempo, loop firmware, lalu duty baru ke plant (plant sudah
+// dimajukan ke c.jam.us jika ada pulsa ADC). Return waktu kejadian berikutnya.
+uint64_t langkahFirmware(KonteksSim &c, Penjadwal<4> &jadwal, uint64_t &adcBerikut) {
+  const uint64_t now = c.jam.us;
+  while (adcBerikut <= now) {
+    c.adc.konversi(c.plant.bacaAdc());   // pulsa RDY ADS1115
+    adcBerikut += 1000000ULL / TURBIDITY_SPS;
+  }
+  jadwal.jalankan(c.jam);
+  // Duty HAL (PWM_RESOLUTION) -> skala 8 bit plant
+  const double dutyHeater = c.pwm.duty[KANAL_HEATER] * (255.0 / PWM_DUTY_MAKS);
+  const double dutyPompa = c.pwm.duty[KANAL_POMPA] * (255.0 / PWM_DUTY_MAKS);
+  if (!c.plant.dutySama(dutyHeater, dutyPompa)) {
+    c.plant.majuKe(now);
+    c.plant.setDuty(dutyHeater, dutyPompa);
+  }
+  const uint64_t berikut = now + jadwal.sisaUs((uint32_t)now);
+  return adcBerikut < berikut ? adcBerikut : berikut;
+}
+
+}  // namespace
+
+// =========================================================================
+//                  LOOP SIMULASI
+// =========================================================================
+
+HasilSimulasi simulasikan(const Skenario &sk, const ParameterKontrol &param,
+                          const ParameterPlant &parameterPlant, const OpsiSimulasi &opsi) {
+  std::unique_ptr<KonteksSim> k(new KonteksSim());
+  ks = k.get();
+  KonteksSim &c = *k;
+  c.opsi = &opsi;
+  c.aturan = opsi.aturan ? opsi.aturan : &aturanFuzzy;
+  c.param = param;
+  c.plant.mulai(parameterPlant, sk.suhuAwal, sk.keruhAwal, sk.suhuRuang, opsi.seed);
+
+  mulaiFirmware(c);
+
+  Penjadwal<4> jadwal;
+  tambahLoopFirmware(jadwal);
+  if (opsi.jejak) jadwal.tambah("jejak", opsi.periodeJejakMs * 1000, 3 * 1000, loopJejak);
+  jadwal.mulai(0);
+
+  const uint64_t akhirUs = (uint64_t)(sk.durasiJam * opsi.skalaDurasi * 3600e6);
+  const uint64_t periodeMetrikUs = opsi.periodeMetrikMs * 1000ULL;
+  const double dtMetrik = opsi.periodeMetrikMs / 1000.0;
+  uint64_t adcBerikut = 0, metrikBerikut = 0;
+  double ruangDasar = sk.suhuRuang;
+
+  PelacakMetrik mSuhu, mKeruh;
+  mSuhu.pita = opsi.pitaSuhu;
+  mKeruh.pita = opsi.pitaKeruh;
+
+  auto waktuKejadian = [&](int i) -> uint64_t {
+    return (uint64_t)(sk.kejadian[i].detik * opsi.skalaDurasi * 1e6);
+  };
+  auto terapkan = [&](const KejadianSkenario &e, double t) {
+    switch (e.jenis) {
+      case SETPOINT_SUHU:
+        c.param.suhuSetpoint = (float)e.nilai;
+        mSuhu.jendelaBaru(t, c.plant.suhu, c.param.suhuSetpoint);
+        break;
+      case SETPOINT_KERUH:
+        c.param.turbiditySetpoint = (float)e.nilai;
+        mKeruh.jendelaBaru(t, c.plant.keruh, c.param.turbiditySetpoint);
+        break;
+      case SUHU_RUANG:
+        ruangDasar = e.nilai;
+        mSuhu.jendelaBaru(t, c.plant.suhu, c.param.suhuSetpoint);
+        break;
+      case LONJAKAN_KERUH:
+        c.plant.tambahKeruh(e.nilai);
+        mKeruh.jendelaBaru(t, c.plant.keruh, c.param.turbiditySetpoint);
+        break;
+      case GANTI_MODE:   // sama dengan taskKontrol firmware
+        c.param.kontrolAktif = (ControlMode)(int)e.nilai;
+        if (c.param.modeBayangan && c.param.transferMulus) mulaiTransferMulus(c.state, c.param, c.jam.millis());
+        else resetPID(c.state, c.jam.millis());
+        break;
+    }
+  };
+
+  int idx = 0;
+  while (idx < sk.jumlahKejadian && waktuKejadian(idx) == 0) terapkan(sk.kejadian[idx++], 0.0);
+  mSuhu.jendelaBaru(0.0, c.plant.suhu, c.param.suhuSetpoint);
+  mKeruh.jendelaBaru(0.0, c.plant.keruh, c.param.turbiditySetpoint);
+
+  HasilSimulasi h;
+  while (c.jam.us < akhirUs) {
+    const uint64_t now = c.jam.us;
+    const double t = now * 1e-6;
+
+    // Plant hanya dimajukan (duty lama, zero-order hold) saat ada yang
+    // membacanya atau duty berubah; tick sampel kosong tidak menyentuhnya
+    bool kejadian = idx < sk.jumlahKejadian && waktuKejadian(idx) <= now;
+    if (kejadian || adcBerikut <= now || metrikBerikut <= now) {
+      if (sk.ayunanRuang != 0.0) c.plant.setSuhuRuang(ruangDasar + sk.ayunanRuang * sin(2.0 * M_PI * t / 86400.0));
+      else c.plant.setSuhuRuang(ruangDasar);
+      c.plant.majuKe(now);
+    }
+
+    while (idx < sk.jumlahKejadian && waktuKejadian(idx) <= now) terapkan(sk.kejadian[idx++], t);
+    if (metrikBerikut <= now) {
+      mSuhu.catat(t, dtMetrik, c.plant.suhu, c.param.suhuSetpoint);
+      mKeruh.catat(t, dtMetrik, c.plant.keruh, c.param.turbiditySetpoint);
+      metrikBerikut += periodeMetrikUs;
+    }
+
+    // Lompat ke kejadian terdekat
+    uint64_t berikut = langkahFirmware(c, jadwal, adcBerikut);
+    if (metrikBerikut < berikut) berikut = metrikBerikut;
+    if (idx < sk.jumlahKejadian && waktuKejadian(idx) < berikut) berikut = waktuKejadian(idx);
+    if (akhirUs < berikut) berikut = akhirUs;
+    c.jam.us = (berikut > now) ? berikut : now + 1;
+    h.jumlahLangkah++;
+  }
+  c.plant.majuKe(c.jam.us);
+
+  mSuhu.selesai();
+  mKeruh.selesai();
+  h.suhu = mSuhu.m;
+  h.keruh = mKeruh.m;
+  h.suhu.energiWh = c.plant.energiHeater / 3600.0;
+  h.keruh.energiWh = c.plant.energiPompa / 3600.0;
+  h.jamSimulasi = c.jam.us / 3600e6;
+  ks = nullptr;
+  return h;
+}
+
+// =========================================================================
+//                  TANGKI VIRTUAL (DIMAJUKAN BERTAHAP)
+// =========================================================================
+
+struct TangkiVirtual::Isi {
+  KonteksSim c;
+  OpsiSimulasi opsi;
+  Penjadwal<4> jadwal;
+  uint64_t adcBerikut = 0;
+  uint64_t berikutUs = 0;   // kejadian firmware berikutnya (jam tangki bisa di depan/di belakangnya)
+};
+
+TangkiVirtual::TangkiVirtual() : isi(new Isi()) {}
+TangkiVirtual::~TangkiVirtual() { delete isi; }
+
+void TangkiVirtual::mulai(const ParameterKontrol &param, const ParameterPlant &plant, double suhuAwal,
+                          double keruhAwal, double suhuRuang, uint32_t seed, uint64_t epochAwalUs) {
+  KonteksSim &c = isi->c;
+  c.opsi = &isi->opsi;
+  c.aturan = &aturanFuzzy;
+  c.param = param;
+  c.jam.epochAwalUs = epochAwalUs;
+  c.plant.mulai(plant, suhuAwal, keruhAwal, suhuRuang, seed);
+  mulaiFirmware(c);
+  tambahLoopFirmware(isi->jadwal);
+  isi->jadwal.mulai(0);
+}
+
+void TangkiVirtual::majuKe(uint64_t us) {
+  KonteksSim &c = isi->c;
+  KonteksSim *sebelum = ks;
+  ks = &c;
+  while (isi->berikutUs <= us) {
+    c.jam.us = isi->berikutUs;
+    if (isi->adcBerikut <= c.jam.us) c.plant.majuKe(c.jam.us);
+    const uint64_t berikut = langkahFirmware(c, isi->jadwal, isi->adcBerikut);
+    isi->berikutUs = (berikut > c.jam.us) ? berikut : c.jam.us + 1;
+  }
+  if (us > c.jam.us) c.jam.us = us;
+  ks = sebelum;
+}
+
+Hal &TangkiVirtual::hal() { return isi->c.hal; }
+ParameterKontrol &TangkiVirtual::param() { return isi->c.param; }
+StateKontrol &TangkiVirtual::state() { return isi->c.state; }
+const Telemetri &TangkiVirtual::telemetri() const { return isi->c.telemetri; }
+const SensorAquarium &TangkiVirtual::sensor() const { return isi->c.sensor; }
+uint64_t TangkiVirtual::us() const { return isi->c.jam.us; }
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * SIMULASI LOOP TERTUTUP (LEBIH CEPAT DARI WAKTU NYATA)
+ * * Deskripsi:
+ * Menjalankan kode kontrol yang sama dengan firmware (PipelineSuhu,
+ * SamplerTurbidity, tickSuhu/tickKeruh, Penjadwal dengan periode & fasa
+ * dari Tick.h) lewat HAL native di atas PlantAquarium.
+ * - Jam simulasi melompat langsung ke kejadian berikutnya (rilis loop,
+ *   konversi ADC, sampel metrik), tanpa menunggu tick 1 ms kosong.
+ * - Skenario: kondisi awal + daftar kejadian (step setpoint, suhu ruang,
+ *   lonjakan kekeruhan, ganti mode kontrol seperti perintah kontrol_aktif).
+ *   Metrik dihitung dari nilai plant sebenarnya.
+ * - Tiap panggilan simulasikan() berdiri sendiri (state per thread), jadi
+ *   banyak skenario bisa jalan paralel di thread berbeda. Rule base fuzzy
+ *   global (aturanFuzzy) hanya dibaca; kandidat lain lewat OpsiSimulasi::aturan.
+ * - TangkiVirtual: loop yang sama dimajukan sedikit-sedikit oleh pemanggil
+ *   (perangkat virtual tools/farm), bukan satu skenario sekali jalan.
+ */
+
+#ifndef AQUARIUM_SIMULASI_H
+#define AQUARIUM_SIMULASI_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include "Kontrol.h"
+#include "PlantAquarium.h"
+#include "Sensor.h"
+#include "Tick.h"
+
+// GANTI_MODE: nilai = ControlMode; resetPID, atau mulaiTransferMulus di mode bayangan + transferMulus
+enum JenisKejadian : uint8_t { SETPOINT_SUHU, SETPOINT_KERUH, SUHU_RUANG, LONJAKAN_KERUH, GANTI_MODE };
+
+struct KejadianSkenario {
+  double detik;
+  JenisKejadian jenis;
+  double nilai;
+};
+
+const int SKENARIO_MAKS_KEJADIAN = 16;
+
+struct Skenario {
+  const char *nama;
+  double durasiJam;
+  double suhuAwal, keruhAwal;
+  double suhuRuang;
+  double ayunanRuang;          // amplitudo ayunan harian suhu ruang (C), 0 = tetap
+  int jumlahKejadian;
+  KejadianSkenario kejadian[SKENARIO_MAKS_KEJADIAN];   // urut waktu
+};
+
+// Skenario bawaan (step setpoint, ayunan ruang, lonjakan kekeruhan, ...)
+extern const Skenario SKENARIO_STANDAR[];
+extern const int JUMLAH_SKENARIO_STANDAR;
+
+struct OpsiSimulasi {
+  uint32_t seed = 1;               // sama untuk semua kontroler = derau identik
+  double skalaDurasi = 1.0;
+  double pitaSuhu = 0.5;           // pita settling (C)
+  double pitaKeruh = 2.0;          // pita settling (%)
+  uint32_t periodeMetrikMs = 100;
+  // Rule base fuzzy simulasi ini (nullptr = aturanFuzzy global), mis. kandidat tuner
+  const AturanFuzzy *aturan = nullptr;
+  // Dipanggil tiap periodeJejakMs dengan telemetri firmware (opsional)
+  void (*jejak)(const Telemetri &t, void *ctx) = nullptr;
+  uint32_t periodeJejakMs = PERIODE_SUHU_MS;
+  void *ctxJejak = nullptr;
+  // Kalibrasi aktuator yang sudah mulai() (opsional): selama berjalan, loop
+  // aktuatornya menulis duty uji seperti firmware (tickSuhu/tickKeruh)
+  KalibrasiAktuator *kalibrasi = nullptr;
+  // Autotune relay yang sudah mulai() (opsional), sama seperti kalibrasi
+  AutotuneRelay *autotune = nullptr;
+};
+
+struct MetrikLoop {
+  double iae = 0.0;          // integral |error| dt  (satuan.detik)
+  double ise = 0.0;          // integral error^2 dt
+  double overshoot = 0.0;    // lewatan terbesar melewati setpoint setelah step/gangguan
+  double settlingDetik = 0;  // terlama dari step/gangguan sampai masuk pita; -1 = tidak pernah
+  double energiWh = 0.0;     // energi aktuator loop ini
+};
+
+struct HasilSimulasi {
+  MetrikLoop suhu, keruh;
+  double jamSimulasi = 0.0;
+  uint64_t jumlahLangkah = 0;  // lompatan jam simulasi
+};
+
+HasilSimulasi simulasikan(const Skenario &sk, const ParameterKontrol &param,
+                          const ParameterPlant &plant, const OpsiSimulasi &opsi = OpsiSimulasi());
+
+// Satu tangki yang dimajukan bertahap oleh pemanggil (generator beban
+// tools/farm): plant + loop firmware yang sama dengan simulasikan(), tanpa
+// skenario & metrik. Jam tangki = waktu yang diberikan ke majuKe() (mis. jam
+// dinding sejak mulai); hal().mqtt boleh diganti transport sungguhan dan
+// param()/state() diubah seperti taskKontrol. Tidak thread-safe, tetapi
+// banyak tangki boleh dimajukan bergantian di satu thread.
+class TangkiVirtual {
+public:
+  TangkiVirtual();
+  ~TangkiVirtual();
+  TangkiVirtual(const TangkiVirtual &) = delete;
+  TangkiVirtual &operator=(const TangkiVirtual &) = delete;
+
+  // epochAwalUs: UTC saat jam tangki 0 (pengganti SNTP), 0 = tidak sinkron
+  void mulai(const ParameterKontrol &param, const ParameterPlant &plant, double suhuAwal, double keruhAwal,
+             double suhuRuang, uint32_t seed, uint64_t epochAwalUs);
+  // Jalankan semua pulsa ADC & rilis loop s.d. us; sesudahnya jam tangki = us
+  void majuKe(uint64_t us);
+
+  Hal &hal();
+  ParameterKontrol &param();
+  StateKontrol &state();
+  const Telemetri &telemetri() const;
+  const SensorAquarium &sensor() const;
+  uint64_t us() const;
+
+private:
+  struct Isi;
+  Isi *isi;
+};
+
+#endif
+#endif
@@ -2,86 +2,152 @@
  * SISTEM KENDALI HYBRID (FUZZY & PID) 
  * * Deskripsi:
  * Kode ini membandingkan kinerja kontrol Fuzzy Logic vs PID Adaptif (Gain Scheduling).
- * - Fuzzy: Menggunakan metode Sugeno (5 membership function).
+ * - Fuzzy: Menggunakan metode Sugeno (5 membership function, rule base di lib/Kontrol/AturanFuzzy.h).
  * - PID: Menggunakan fitur Gain Scheduling (respon cepat) + Feedforward (anti-stuck).
  * * Hardware: ESP32, DS18B20, Sensor Turbidity (ADS1115), L298N Driver.
+ * * Struktur: kernel kontrol ada di lib/Kontrol, akses hardware lewat lib/Hal
+ *   (HAL native dipakai benchmark di tools/bench, env:native).
+ * * Pembagian core (FreeRTOS):
+ *   - Core 1: taskKontrol (prioritas tinggi) -> sensor, Fuzzy/PID, PWM.
+ *   - Core 0: taskJaringan -> WiFi, MQTT, parse JSON callback;
+ *     taskSuhu -> pembacaan DS18B20 (scratchpad 1-Wire memblok beberapa ms),
+ *     hasil ke core 1 lewat Seqlock;
+ *     taskLog (prioritas terendah) -> menguras log ke Serial.
+ *   Parameter dikirim ke core 1 lewat Seqlock, telemetri ke core 0 lewat
+ *   antrian SPSC; task kontrol tidak pernah mengambil lock.
+ * * Penjadwalan: tiap loop punya periode & fasa sendiri (lib/Kontrol/Penjadwal.h).
+ *   Core 1 dibangunkan hardware timer 1 ms; statistik jitter/overrun tiap
+ *   loop dikirim ke MQTT_TOPIC_JADWAL.
+ * * Store-and-forward: telemetri yang gagal terkirim disimpan (RAM lalu
+ *   LittleFS) dan diputar ulang bertahap setelah online (lib/Kontrol/SimpanTerus.h).
+ * * Telemetri report-by-exception: snapshot tiap 250 ms, yang dipublikasikan
+ *   hanya kejadian/transien, keluar deadband, atau heartbeat (lib/Kontrol/KebijakanKirim.h).
+ * * Koneksi: WiFi/MQTT lewat state machine non-blocking dengan backoff + jitter,
+ *   cache BSSID/kanal & IP statis opsional (lib/Kontrol/ManajerKoneksi.h).
+ * * Profiler per tahap (sensor, Fuzzy/PID, aktuator, serialize, publish) +
+ *   heap & stack high-water mark -> MQTT_TOPIC_PROFIL (lib/Kontrol/Profil.h, -DPROFIL_AKTIF=0 mematikan).
+ * * Log: LOG_E/W/I/D hanya memformat ke ring buffer lock-free, UART tidak
+ *   pernah memblok pemanggil; tingkat yang mati hilang saat kompilasi
+ *   (-DLOG_TINGKAT, -DLOG_TUNDA; lib/Kontrol/LogAsinkron.h).
+ * * Perintah MQTT di-parse tanpa heap ke salinan bertahap; pesan diterapkan
+ *   utuh atau ditolak utuh (lib/Kontrol/PerintahKontrol.h).
+ * * Aktuator: PWM 12 bit (-DPWM_RESOLUSI_BIT), output lewat kurva linearisasi
+ *   logika -> duty per aktuator (+ dither sigma-delta heater opsional);
+ *   kurva diukur di perangkat dengan {"kalibrasi_aktuator":"heater"|"pompa"},
+ *   hasil -> MQTT_TOPIC_AKTUATOR; dipasang lewat kurva_heater / kurva_pompa
+ *   (otomatis jika -DKALIBRASI_PASANG_OTOMATIS=1), disimpan di LittleFS
+ *   (lib/Kontrol/KalibrasiAktuator.h).
+ * * Autotune PID di perangkat {"autotune":"suhu"|"keruh"}: eksperimen relay
+ *   Åström–Hägglund di task kontrol (dengan batas simpangan), Ku/Pu -> gain
+ *   SIMC / Ziegler–Nichols / Tyreus–Luyben ("autotune_aturan"), hasil ->
+ *   MQTT_TOPIC_AUTOTUNE, dipasang jika "autotune_terapkan" (lib/Kontrol/AutotuneRelay.h).
+ * * Mode bayangan {"mode_bayangan":true}: Fuzzy & PID dihitung tiap tick pada
+ *   sampel yang sama, output & waktu hitung keduanya di telemetri JSON;
+ *   {"transfer_mulus":true} = ganti mode tanpa loncatan output (lib/Kontrol/Kontrol.h).
+ * * Latensi ujung ke ujung: jam dinding SNTP (mode smooth); tiap telemetri
+ *   membawa umur sampel/hitung/aktuasi saat kirim + waktu kirim UTC;
+ *   perintah ber-id_perintah digemakan ke MQTT_TOPIC_GEMA dengan waktu
+ *   terima/terap/aktuasi (lib/Kontrol/JamDinding.h). Laporan: backend /api/latensi.
+ * * Banyak perangkat per broker: client ID & topik <MQTT_PREFIX>/<id>/<nama>,
+ *   id dari MAC (atau -DMQTT_ID_PERANGKAT); perintah lewat <id>/mode atau
+ *   siaran <MQTT_PREFIX>/mode (lib/Kontrol/TopikPerangkat.h). Uji beban
+ *   ribuan perangkat virtual: tools/farm.
  */
 
 #include <WiFi.h>
 #include <PubSubClient.h>
-#include <ArduinoJson.h>
 #include <OneWire.h>
 #include <DallasTemperature.h>
 #include <Wire.h>
 #include <Adafruit_ADS1X15.h>
-#include <esp_arduino_version.h>
+#include "HalEsp32.h"
+#include "Kontrol.h"
+#include "Tick.h"
+#include "Aktuator.h"
+#include "KalibrasiAktuator.h"
+#include "AutotuneRelay.h"
+#include "Seqlock.h"
+#include "AntrianSpsc.h"
+#include "Penjadwal.h"
+#include "TelemetriBiner.h"
+#include "SimpanTerus.h"
+#include "TopikPerangkat.h"
+#include "SiklusCpu.h"
+#include "KebijakanKirim.h"
+#include "PerintahKontrol.h"
+#include "LogAsinkron.h"
+#include "ManajerKoneksi.h"
+#include "Profil.h"
 
 // =========================================================================
 //                  SETTING JARINGAN & MQTT
 // =========================================================================
 
-struct WiFiCredentials {
-  const char *ssid;
-  const char *password;
-};
-
-WiFiCredentials wifiNetworks[] = {
+const JaringanWifi wifiNetworks[] = {
     {"Private u52", "12345678"}, 
     {"iPhone 2", "bobo2002"}    
 };
 const int NUM_WIFI_NETWORKS = sizeof(wifiNetworks) / sizeof(wifiNetworks[0]);
 
+// IP statis opsional (melewati DHCP), mis. build_flags:
+//   -DWIFI_IP_STATIS=192,168,1,50 -DWIFI_GATEWAY=192,168,1,1 [-DWIFI_SUBNET=..] [-DWIFI_DNS=..]
+#ifdef WIFI_IP_STATIS
+#ifndef WIFI_SUBNET
+#define WIFI_SUBNET 255, 255, 255, 0
+#endif
+#ifndef WIFI_DNS
+#define WIFI_DNS WIFI_GATEWAY
+#endif
+const IpStatis IP_STATIS = {true, {WIFI_IP_STATIS}, {WIFI_GATEWAY}, {WIFI_SUBNET}, {WIFI_DNS}};
+#else
+const IpStatis IP_STATIS = {};
+#endif
+
 const char *MQTT_BROKER = "broker.hivemq.com";
 const int MQTT_PORT = 1883;
-const char *MQTT_TOPIC_DATA = "unhas/informatika/aquarium/data";
-const char *MQTT_TOPIC_MODE = "unhas/informatika/aquarium/mode";
-const char *MQTT_CLIENT_ID = "esp32-research-aquarium";
+// Topik per perangkat <MQTT_PREFIX>/<id>/<nama>, diisi di setup() (lib/Kontrol/TopikPerangkat.h)
+TopikPerangkat topikPerangkat;
+const char *const MQTT_TOPIC_DATA = topikPerangkat.topik[TOPIK_DATA];
+const char *const MQTT_TOPIC_MODE = topikPerangkat.topik[TOPIK_MODE];
+const char *const MQTT_TOPIC_MODE_SEMUA = topikPerangkat.modeSemua;       // perintah siaran ke semua perangkat
+const char *const MQTT_TOPIC_JADWAL = topikPerangkat.topik[TOPIK_JADWAL];
+const char *const MQTT_TOPIC_BATCH = topikPerangkat.topik[TOPIK_BATCH];      // telemetri biner (TelemetriBiner.h)
+const char *const MQTT_TOPIC_STATUS = topikPerangkat.topik[TOPIK_STATUS];    // status store-and-forward
+const char *const MQTT_TOPIC_PERINTAH = topikPerangkat.topik[TOPIK_PERINTAH]; // statistik parser perintah + heap
+const char *const MQTT_TOPIC_KIRIM = topikPerangkat.topik[TOPIK_KIRIM];      // rasio sampel ditekan / terkirim
+const char *const MQTT_TOPIC_KONEKSI = topikPerangkat.topik[TOPIK_KONEKSI];  // waktu sambung, jumlah putus/gagal
+const char *const MQTT_TOPIC_PROFIL = topikPerangkat.topik[TOPIK_PROFIL];    // durasi per tahap jalur panas + memori
+const char *const MQTT_TOPIC_AKTUATOR = topikPerangkat.topik[TOPIK_AKTUATOR]; // status & kurva kalibrasi aktuator (retained)
+const char *const MQTT_TOPIC_GEMA = topikPerangkat.topik[TOPIK_GEMA];        // gema perintah ber-id_perintah (latensi)
+const char *const MQTT_TOPIC_AUTOTUNE = topikPerangkat.topik[TOPIK_AUTOTUNE]; // status & gain hasil autotune (retained)
+const char *NTP_SERVER_1 = "pool.ntp.org";
+const char *NTP_SERVER_2 = "time.google.com";
 
 // =========================================================================
 //                  PIN & VARIABEL GLOBAL
 // =========================================================================
 
 const int SENSOR_SUHU_PIN = 4;
+const int ADS_RDY_PIN = 19;      // ALERT/RDY ADS1115 (open-drain, pakai pull-up)
 
 // Driver L298N (Pemanas & Pompa)
 const int HEATER_ENA = 16; const int HEATER_IN1 = 17; const int HEATER_IN2 = 18;
 const int PUMP_ENB = 27;   const int PUMP_IN3 = 25;   const int PUMP_IN4 = 26;
 
-// Mode Kontrol
-enum ControlMode { FUZZY, PID };
-ControlMode kontrolAktif = FUZZY;
-
-// Setpoint default
-float suhuSetpoint = 28.0f;
-float turbiditySetpoint = 15.0f;
-
-// Parameter PID (Default Tuning - Mode Smooth)
-double Kp_suhu = 8.0, Ki_suhu = 0.3, Kd_suhu = 6.0;
-double Kp_keruh = 5.0, Ki_keruh = 0.2, Kd_keruh = 2.0; 
+// Periode & fasa loop (ms). Loop sampel/suhu/keruh: lihat Tick.h (dipakai juga simulator).
+const uint32_t TICK_KONTROL_US = 1000;        // hardware timer core 1
+const uint32_t PERIODE_KIRIM_MS = KIRIM_INTERVAL_CEPAT_MS;  // snapshot ke core 0; laju publish: KebijakanKirim
+const uint32_t PERIODE_STATISTIK_MS = 10000;  // jendela statistik jitter
+const uint32_t FASA_KIRIM_MS = 3, FASA_STATISTIK_MS = 5;
 
-// Variabel penyimpan nilai integral & error sebelumnya
-double integralSumSuhu = 0.0, lastErrorSuhu = 0.0;
-double integralSumKeruh = 0.0, lastErrorKeruh = 0.0;
+const uint32_t TICK_JARINGAN_MS = 10;         // core 0: tick FreeRTOS
+const uint32_t PERIODE_MQTT_MS = 10;
+const uint32_t PERIODE_PUTAR_ULANG_MS = 1000;  // backlog dikirim maks 20x laju real-time
+const int PUTAR_ULANG_MAKS_RECORD = 20;
 
-// Kalibrasi ADC Turbidity (Nilai Default)
-int NILAI_ADC_JERNIH = 20100;
-int NILAI_ADC_KERUH = 3550;
-
-// Timer
-unsigned long lastTimeSuhu = 0;
-unsigned long lastTimeKeruh = 0;
-unsigned long waktuTerakhirKirim = 0;
-const long intervalKirim = 1000;      
-unsigned long lastWiFiCheck = 0;
-
-// variabel wifiCheckInterval 
-const long wifiCheckInterval = 5000; 
-
-// Setting PWM
-const int PWM_FREQ = 1000;
-const int PWM_RESOLUTION = 8;
-const int PWM_MIN_FISIK = 235;   
-const int PWM_START_LOGIKA = 5;
+// CONNECT PubSubClient memblok task jaringan sampai CONNACK: batasi (default 15 s),
+// ManajerKoneksi menjamin paling banyak satu percobaan per backoff
+const uint16_t MQTT_TIMEOUT_S = 2;
 
 // Objek Sensor & Komunikasi
 WiFiClient espClient;
@@ -90,430 +156,709 @@ OneWire oneWire(SENSOR_SUHU_PIN);
 DallasTemperature sensors(&oneWire);
 Adafruit_ADS1115 ads;
 
-// Variabel Filter Sensor & Last Values
-float suhuTerfilter = 0.0;
-const float ALPHA = 0.2; 
-double outputKeruhTerfilter = 0.0;
+// HAL: pembungkus hardware untuk lib/Kontrol
+Esp32Clock halClock;
+Esp32Adc halAdc(ads, ADS_RDY_PIN);
+Esp32Suhu halSuhu(sensors);
+Esp32Pwm halPwm({HEATER_ENA, HEATER_IN1, HEATER_IN2}, {PUMP_ENB, PUMP_IN3, PUMP_IN4});
+Esp32Mqtt halMqtt(mqttClient);
+Esp32Wifi halWifi;
+Esp32Berkas halBerkas;
+Profil profil;   // tahap core 1 ditulis task kontrol, sisanya task jaringan
+Hal hal = {&halClock, &halAdc, &halSuhu, &halPwm, &halMqtt, &profil};
 
-// variabel suhuTerakhir & turbidityTerakhir
-float suhuTerakhir = 25.0f;
-int turbidityTerakhir = 0; 
+// =========================================================================
+//                  DATA LINTAS CORE
+// =========================================================================
+
+const BaseType_t KONTROL_CORE = 1;
+const BaseType_t JARINGAN_CORE = 0;
+const UBaseType_t PRIORITAS_KONTROL = configMAX_PRIORITIES - 2;
+const UBaseType_t PRIORITAS_JARINGAN = 1;
+const uint32_t STACK_KONTROL = 4096;
+const uint32_t STACK_JARINGAN = 8192;       // callback perintah + snprintf telemetri
+const UBaseType_t PRIORITAS_SUHU = 2;       // di atas jaringan: parse JSON tidak menunda baca probe
+const uint32_t STACK_SUHU = 2048;
+const uint32_t PERIODE_BACA_SUHU_MS = 10;   // polling selesai konversi (94-750 ms) & baca probe
+const UBaseType_t PRIORITAS_LOG = tskIDLE_PRIORITY;
+const uint32_t STACK_LOG = 3072;            // vsnprintf mode tunda
+const uint32_t PERIODE_LOG_MS = 10;         // 115200 baud ~ 115 byte / 10 ms
+const size_t LOG_UART_TX = 1024;            // buffer TX Serial (availableForWrite)
+
+// KonfigurasiKontrol (semua yang bisa diubah lewat MQTT): lib/Kontrol/PerintahKontrol.h
+
+// Satu entri antrian telemetri (+ info debug milik task kontrol)
+struct PaketTelemetri {
+  Telemetri t;
+  uint32_t jumlahSampel, sampelTerlewat;
+  uint32_t siklusSuhu, gagalSuhu;
+  uint8_t jumlahProbe;
+  float suhuProbe[SUHU_MAKS_PROBE];
+};
+
+// Milik taskJaringan (hanya diubah callback)
+KonfigurasiKontrol konfigurasi = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+
+Seqlock<KonfigurasiKontrol> konfigurasiBersama;
+AntrianSpsc<PaketTelemetri, 32> antrianTelemetri;   // 8 detik pada PERIODE_KIRIM_MS
+
+// Milik taskKontrol: parameter aktif, memori kontroler, akuisisi sensor
+// (aturanFuzzy di lib/Kontrol juga hanya disalin di task ini)
+ParameterKontrol param;
+StateKontrol state;
+SensorAquarium sensor;   // sensor.suhu = salinan hasil terakhir dari taskSuhu
+Telemetri telemetri;
+Esp32Timer halTimer;
+KalibrasiAktuator kalibrasi;                  // milik task kontrol
+Seqlock<KalibrasiAktuator> laporanKalibrasi;  // mulai / selesai / gagal -> core 0
+AutotuneRelay autotune;                       // milik task kontrol
+Seqlock<AutotuneRelay> laporanAutotune;       // mulai / selesai / gagal -> core 0
+PelacakPerintah pelacakPerintah;              // milik task kontrol
+AntrianSpsc<GemaPerintah, 8> antrianGema;     // gema perintah diterima -> core 0
+GemaPerintah gemaTolak;                       // perintah ditolak (callback -> loopMqtt, core 0 saja)
+bool adaGemaTolak = false;
+
+// Format telemetri (milik taskJaringan, diubah lewat MQTT)
+PengaturanTelemetri pengaturanTelemetri;
+StatistikPerintah statistikPerintah;
+BatchTelemetri batchTelemetri;
+SimpanTerus simpanTerus;
+KebijakanKirim kebijakanKirim;
+ManajerKoneksi koneksi;
+
+// Penjadwal per core + laporan statistik core 1 untuk dikirim core 0
+Penjadwal<5> jadwalKontrol;
+Penjadwal<4> jadwalJaringan;
+Seqlock<LaporanJadwal<5>> laporanKontrol;
+Seqlock<Profil> laporanProfil;   // tahap core 1, per jendela statistik
+TaskHandle_t taskKontrolHandle = NULL, taskJaringanHandle = NULL, taskLogHandle = NULL, taskSuhuHandle = NULL;
+
+// Milik taskSuhu (core 0): state machine DS18B20; tiap set probe lengkap -> core 1
+PipelineSuhu pipelineSuhu;
+Seqlock<PipelineSuhu> hasilSuhu;
 
 // =========================================================================
-//                  FUNGSI BANTUAN (HELPER)
+//                  LOG SERIAL (CORE 0, PRIORITAS TERENDAH)
 // =========================================================================
 
-float mapFloat(float x, float in_min, float in_max, float out_min, float out_max) {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+// Tulis satu baris hanya jika muat di buffer TX: task log tidak pernah memblok di UART.
+// Pesan yang belum muat tetap di antrian; jika antrian penuh, produsen membuang & menghitung.
+bool keluaranSerial(const char *baris, size_t len, void *) {
+  if ((size_t)Serial.availableForWrite() < len + 1) return false;
+  Serial.write((const uint8_t *)baris, len);
+  Serial.write('\n');
+  return true;
 }
 
 // =========================================================================
-//                  KONTROL MOTOR L298N
+//                  PEMBACAAN DS18B20 (CORE 0)
 // =========================================================================
 
-void setHeaterSpeed(int pwmValue) {
-  pwmValue = constrain(pwmValue, 0, 255);
-  if (pwmValue > 0) {
-    digitalWrite(HEATER_IN1, HIGH); digitalWrite(HEATER_IN2, LOW);
-  } else {
-    digitalWrite(HEATER_IN1, LOW); digitalWrite(HEATER_IN2, LOW);
+// bacaC() = scratchpad 1-Wire ~5-7 ms dengan interupsi dimatikan per bit:
+// terlalu lama untuk loopSampel (2 ms, core 1), jadi dijalankan di sini.
+// Resolusi baru dibaca langsung dari konfigurasi (satu byte, ditulis callback di core ini).
+void taskSuhu(void *) {
+  TickType_t bangun = xTaskGetTickCount();
+  for (;;) {
+    pipelineSuhu.setResolusi(konfigurasi.resolusiSuhu);
+    if (pipelineSuhu.layani(halSuhu, millis())) hasilSuhu.tulis(pipelineSuhu);
+    vTaskDelayUntil(&bangun, pdMS_TO_TICKS(PERIODE_BACA_SUHU_MS));
+  }
+}
+
+void taskLog(void *) {
+  for (;;) {
+    logGlobal.kuras(keluaranSerial, NULL);
+    vTaskDelay(pdMS_TO_TICKS(PERIODE_LOG_MS));
   }
-  
-  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
-    ledcWrite(HEATER_ENA, pwmValue);
-  #else
-    ledcWrite(0, pwmValue); 
-  #endif
 }
 
-void setPumpSpeed(int pwmValue) {
-  pwmValue = constrain(pwmValue, 0, 255);
-  int finalOutput = 0;
+// =========================================================================
+//                  KONEKSI WIFI & MQTT
+// =========================================================================
 
-  if (pwmValue < PWM_START_LOGIKA) {
-    finalOutput = 0;
-  } else {
-    finalOutput = map(pwmValue, PWM_START_LOGIKA, 255, PWM_MIN_FISIK, 255);
+void callback(char *topic, byte *payload, unsigned int length) {
+  (void)topic;   // MQTT_TOPIC_MODE & MQTT_TOPIC_MODE_SEMUA sama-sama dokumen Control
+  // Salinan bertahap di .bss (bukan heap / stack task): pesan diterapkan utuh atau tidak sama sekali
+  static KonfigurasiKontrol staging;
+  staging = konfigurasi;
+  PengaturanTelemetri ptBaru = pengaturanTelemetri;
+
+  uint32_t t0 = micros();
+  HasilPerintah h;
+  {
+    PROFIL_LINGKUP(hal, PROFIL_PERINTAH);
+    h = parsePerintah((const char *)payload, length, staging, ptBaru);
   }
+  statistikPerintah.catat(h, micros() - t0);
+
+  if (!h.ok) {
+    LOG_W("[MQTT ERROR] Perintah ditolak, konfigurasi lama tetap dipakai: %s%s%s",
+      h.kunci, h.kunci[0] ? " -> " : "", h.alasan);
+    if (h.id != 0) {
+      gemaTolak = gemaDitolak(h, t0);
+      adaGemaTolak = true;
+    }
+    return;
+  }
+  staging.terimaUs = t0;
 
-  if (finalOutput > 0) {
-    digitalWrite(PUMP_IN3, HIGH); digitalWrite(PUMP_IN4, LOW);
-  } else {
-    digitalWrite(PUMP_IN3, LOW); digitalWrite(PUMP_IN4, LOW);
+  // --- 1. MODE KONTROL ---
+  if (h.berubah & PERINTAH_MODE) {
+    LOG_I("\n========================================");
+    LOG_I("[MODE] Ganti Mode Kontrol ke: %s", namaMode(staging.param.kontrolAktif));
+    LOG_I("========================================");
   }
 
-  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
-    ledcWrite(PUMP_ENB, finalOutput);
-  #else
-    ledcWrite(1, finalOutput); 
-  #endif
-}
+  // --- 2. SETPOINT ---
+  if (h.berubah & PERINTAH_SETPOINT) {
+    LOG_I("[SETPOINT] Target Suhu: %.2f C | Kekeruhan: %.2f %%",
+      staging.param.suhuSetpoint, staging.param.turbiditySetpoint);
+  }
+
+  // --- 3. TUNING PID ---
+  if (h.berubah & PERINTAH_TUNING) {
+    LOG_I("\n----------- PID PARAMETER BERHASIL DI-UPDATE -----------");
+    LOG_I("[PID SUHU ] Kp: %.2f | Ki: %.2f | Kd: %.2f", staging.param.Kp_suhu, staging.param.Ki_suhu, staging.param.Kd_suhu);
+    LOG_I("[PID KERUH] Kp: %.2f | Ki: %.2f | Kd: %.2f", staging.param.Kp_keruh, staging.param.Ki_keruh, staging.param.Kd_keruh);
+    LOG_I("[TURBO KERUH] Kp: %.2f jika |e| > %.2f | pompa tahan >= %.1f%% | mati <= %.1f%%",
+      staging.param.Kp_keruh_turbo, staging.param.ambangTurboKeruh, staging.param.keruhTahan, staging.param.keruhMati);
+    LOG_I("--------------------------------------------------------");
+  }
+
+  // --- 3b. MESIN & RULE BASE FUZZY ---
+  if (h.berubah & PERINTAH_MESIN_FUZZY) {
+    const char *nama[] = {"EKSAK", "LUT", "PD"};
+    LOG_I("[FUZZY] Suhu pakai: %s | Keruh pakai: %s",
+      nama[staging.param.mesinFuzzySuhu], nama[staging.param.mesinFuzzyKeruh]);
+  }
+  if (h.berubah & PERINTAH_ATURAN) {
+    LOG_I("[FUZZY] Rule base diperbarui, LUT dipanggang ulang | error maks suhu: %.4f%% | keruh: %.4f%%",
+      staging.aturan.lutSuhu.errorMaks, staging.aturan.lutKeruh.errorMaks);
+  }
+  if (h.berubah & PERINTAH_ATURAN_PD) LOG_I("[FUZZY] Rule base suhu PD diperbarui");
+
+  // --- 3c. RESOLUSI DS18B20 & FORMAT TELEMETRI ---
+  if (h.berubah & PERINTAH_RESOLUSI) {
+    LOG_I("[SUHU] Resolusi: %d bit (%lu ms/konversi)",
+      staging.resolusiSuhu, PipelineSuhu::waktuKonversiMs(staging.resolusiSuhu));
+  }
+  if (h.berubah & PERINTAH_TELEMETRI) {
+    LOG_I("[TELEMETRI] Format: %s | batch %d sampel / %lu ms",
+      ptBaru.biner ? "BINER" : "JSON", ptBaru.batchSampel, ptBaru.batchIntervalMs);
+    LOG_I("[TELEMETRI] Kirim pintar: %s | deadband %.2f C, %.2f %%, output %.1f %% | heartbeat %lu ms",
+      ptBaru.kirim.aktif ? "ON" : "OFF", ptBaru.kirim.deadbandSuhu, ptBaru.kirim.deadbandKeruh,
+      ptBaru.kirim.deadbandOutput, (unsigned long)ptBaru.kirim.heartbeatMs);
+  }
 
-void setupL298N() {
-  pinMode(HEATER_IN1, OUTPUT); pinMode(HEATER_IN2, OUTPUT);
-  pinMode(PUMP_IN3, OUTPUT); pinMode(PUMP_IN4, OUTPUT);
-
-  #if ESP_ARDUINO_VERSION >= ESP_ARDUINO_VERSION_VAL(3, 0, 0)
-    ledcAttach(HEATER_ENA, PWM_FREQ, PWM_RESOLUTION);
-    ledcAttach(PUMP_ENB, PWM_FREQ, PWM_RESOLUTION);
-  #else
-    ledcSetup(0, PWM_FREQ, PWM_RESOLUTION); ledcAttachPin(HEATER_ENA, 0);
-    ledcSetup(1, PWM_FREQ, PWM_RESOLUTION); ledcAttachPin(PUMP_ENB, 1);
-  #endif
+  // --- 4. KALIBRASI ---
+  if (h.berubah & PERINTAH_KALIBRASI) {
+    LOG_I("\n!!!!!!!!!! CALIBRATION UPDATED !!!!!!!!!!");
+    LOG_I("[CALIB] ADC Jernih (0%%)   : %d", staging.param.NILAI_ADC_JERNIH);
+    LOG_I("[CALIB] ADC Keruh (100%%)  : %d", staging.param.NILAI_ADC_KERUH);
+    LOG_I("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+  }
+  if (h.berubah & PERINTAH_AKTUATOR) {
+    const KurvaAktuator &kh = staging.param.kurvaHeater, &kp = staging.param.kurvaPompa;
+    LOG_I("[AKTUATOR] Kurva heater 10/50/100%%: %.1f/%.1f/%.1f%% duty | dither %s", kh.duty[1] * 100.0f,
+      kh.duty[5] * 100.0f, kh.duty[10] * 100.0f, staging.param.ditherHeater ? "ON" : "OFF");
+    LOG_I("[AKTUATOR] Kurva pompa  10/50/100%%: %.1f/%.1f/%.1f%% duty", kp.duty[1] * 100.0f, kp.duty[5] * 100.0f,
+      kp.duty[10] * 100.0f);
+    if (!simpanKurvaAktuator(halBerkas, kh, kp)) LOG_W("[AKTUATOR] Kurva gagal disimpan ke flash");
+  }
+  if (h.berubah & PERINTAH_BAYANGAN) {
+    LOG_I("[BAYANGAN] Mode bayangan %s | transfer mulus %s (tau %.1f s)", staging.param.modeBayangan ? "ON" : "OFF",
+      staging.param.transferMulus ? "ON" : "OFF", staging.param.tauTransfer);
+  }
+  if (h.berubah & PERINTAH_KALIBRASI_AKTUATOR) {
+    const char *nama[] = {"heater", "pompa", "batal"};
+    LOG_I("[AKTUATOR] Perintah kalibrasi: %s", nama[staging.aksiKalibrasiAktuator]);
+  }
+  if (h.berubah & PERINTAH_AUTOTUNE) {
+    const char *aturan[] = {"SIMC", "Ziegler-Nichols", "Tyreus-Luyben"};
+    LOG_I("[AUTOTUNE] Aturan: %s | terapkan otomatis: %s", aturan[staging.aturanAutotune],
+      staging.terapkanAutotune ? "ON" : "OFF");
+  }
+
+  // --- 5. PUBLIKASI KE TASK KONTROL (set lengkap, diambil core 1 di antara tick) ---
+  konfigurasi = staging;
+  pengaturanTelemetri = ptBaru;
+  konfigurasiBersama.tulis(konfigurasi);
 }
 
 // =========================================================================
-//                  LOGIKA FUZZY (SUGENO)
+//                  TASK KONTROL (CORE 1)
 // =========================================================================
 
-// --- Fuzzy Suhu ---
-float membershipSangatDingin(float error) {
-  if (error <= 3.5f) return 0.0f;
-  if (error >= 5.0f) return 1.0f;
-  return (error - 3.5f) / 1.5f;
-}
-float membershipDingin(float error) {
-  if (error <= 1.5f || error >= 4.5f) return 0.0f;
-  if (error >= 2.5f && error <= 3.5f) return 1.0f;
-  if (error > 1.5f && error < 2.5f) return (error - 1.5f) / 1.0f;
-  return (4.5f - error) / 1.0f; 
-}
-float membershipSesuai(float error) { 
-  if (error <= -1.0f || error >= 2.0f) return 0.0f;
-  if (error >= -0.3f && error <= 0.3f) return 1.0f;
-  if (error > -1.0f && error < -0.3f) return (error + 1.0f) / 0.7f;
-  return (2.0f - error) / 1.7f;
-}
-float membershipPanas(float error) {
-  if (error <= -3.5f || error >= -0.5f) return 0.0f;
-  if (error >= -2.5f && error <= -1.0f) return 1.0f;
-  if (error > -3.5f && error < -2.5f) return (error + 3.5f) / 1.0f;
-  return (-0.5f - error) / 0.5f;
+// Ambil hasil konversi ADS1115 & set probe DS18B20 terbaru dari taskSuhu (non-blocking)
+void loopSampel() {
+  static uint32_t versiSuhu = 0;
+  PROFIL_LINGKUP(hal, PROFIL_SAMPEL);
+  sensor.turbidity.layani(halAdc, micros());
+  static PipelineSuhu baru;   // staging: baca yang menyerah tidak merusak sensor.suhu
+  if (hasilSuhu.versi() != versiSuhu && hasilSuhu.cobaBaca(baru, versiSuhu)) sensor.suhu = baru;
 }
-float membershipSangatPanas(float error) {
-  if (error >= -3.0f) return 0.0f;
-  if (error <= -4.5f) return 1.0f;
-  return (-3.0f - error) / 1.5f;
-}
-
-float hitungFuzzySuhu(float errorSuhu) {
-  float mu_sangatDingin = membershipSangatDingin(errorSuhu);
-  float mu_dingin = membershipDingin(errorSuhu);
-  float mu_sesuai = membershipSesuai(errorSuhu);
-  float mu_panas = membershipPanas(errorSuhu);
-  float mu_sangatPanas = membershipSangatPanas(errorSuhu);
 
-  float numerator = (mu_sangatDingin * 95.0f) + (mu_dingin * 75.0f) + 
-                    (mu_sesuai * 25.0f) + (mu_panas * 5.0f) + (mu_sangatPanas * 0.0f);
-  float denominator = mu_sangatDingin + mu_dingin + mu_sesuai + mu_panas + mu_sangatPanas;
-
-  if (denominator < 0.01f) return 25.0f; 
-  return numerator / denominator;
+// Baca Sensor -> Hitung Kontrol -> Eksekusi ke Motor, per loop
+// Kalibrasi aktuator baru berhenti (selesai / gagal): memori kontroler
+// tertinggal dari duty uji -> reset, laporkan ke core 0
+void cekAkhirKalibrasi(bool berjalanSebelum) {
+  if (!berjalanSebelum || kalibrasi.status == KALIBRASI_BERJALAN) return;
+  resetPID(state, millis());
+  laporanKalibrasi.tulis(kalibrasi);
 }
 
-// --- Fuzzy Turbidity ---
-float membershipSangatJernih(float error) {
-  if (error <= -7.0f) return 1.0f;
-  if (error <= -5.0f) return (-5.0f - error) / 2.0f;
-  return 0.0f;
+// Autotune baru berhenti: integral PID menumpuk selama relay -> reset, laporkan ke core 0
+void cekAkhirAutotune(bool berjalanSebelum) {
+  if (!berjalanSebelum || autotune.status == AUTOTUNE_BERJALAN) return;
+  resetPID(state, millis());
+  laporanAutotune.tulis(autotune);
 }
-float membershipJernih(float error) {
-  if (error <= -7.0f || error >= -1.0f) return 0.0f;
-  if (error >= -4.0f && error <= -2.0f) return 1.0f;
-  if (error > -7.0f && error < -4.0f) return (error + 7.0f) / 3.0f;
-  return (-1.0f - error) / 1.0f;
+
+// Perintah ber-id: gema dikirim setelah kedua loop menulis duty sesudah diterapkan
+void cekGemaPerintah() {
+  if (pelacakPerintah.catat(telemetri.stempelSuhu, telemetri.stempelKeruh)) antrianGema.kirim(pelacakPerintah.g);
 }
-float membershipSesuaiKeruh(float error) {
-  if (error <= -2.5f || error >= 2.5f) return 0.0f;
-  if (error >= -0.5f && error <= 0.5f) return 1.0f;
-  if (error > -2.5f && error < -0.5f) return (error + 2.5f) / 2.0f;
-  return (2.5f - error) / 2.0f;
+
+void loopSuhu() {
+  const bool berjalan = kalibrasi.status == KALIBRASI_BERJALAN;
+  const bool menala = autotune.status == AUTOTUNE_BERJALAN;
+  tickSuhu(hal, sensor, param, state, telemetri, aturanFuzzy, &kalibrasi, &autotune);
+  cekAkhirKalibrasi(berjalan);
+  cekAkhirAutotune(menala);
+  cekGemaPerintah();
 }
-float membershipKeruh(float error) {
-  if (error <= 1.0f || error >= 10.0f) return 0.0f;
-  if (error >= 4.0f && error <= 7.0f) return 1.0f;
-  if (error > 1.0f && error < 4.0f) return (error - 1.0f) / 3.0f;
-  return (10.0f - error) / 3.0f;
+void loopKeruh() {
+  const bool berjalan = kalibrasi.status == KALIBRASI_BERJALAN;
+  const bool menala = autotune.status == AUTOTUNE_BERJALAN;
+  tickKeruh(hal, sensor, param, state, telemetri, aturanFuzzy, &kalibrasi, &autotune);
+  cekAkhirKalibrasi(berjalan);
+  cekAkhirAutotune(menala);
+  cekGemaPerintah();
 }
-float membershipSangatKeruh(float error) {
-  if (error <= 8.0f) return 0.0f;
-  if (error >= 12.0f) return 1.0f;
-  return (error - 8.0f) / 4.0f;
+
+// Serahkan snapshot telemetri ke core 0 (penuh = dibuang, kontrol tidak menunggu)
+void loopKirim() {
+  PaketTelemetri paket;
+  paket.t = telemetri;
+  paket.t.timestamp_ms = millis();
+  paket.jumlahSampel = sensor.turbidity.jumlahSampel;
+  paket.sampelTerlewat = sensor.turbidity.sampelTerlewat;
+  paket.siklusSuhu = sensor.suhu.jumlahSiklus;
+  paket.gagalSuhu = sensor.suhu.jumlahGagal;
+  paket.jumlahProbe = sensor.suhu.jumlahProbe;
+  for (int i = 0; i < SUHU_MAKS_PROBE; i++) paket.suhuProbe[i] = sensor.suhu.suhu[i];
+  antrianTelemetri.kirim(paket);
 }
 
-float hitungFuzzyKeruh(float errorKeruh) {
-  float mu_sangatJernih = membershipSangatJernih(errorKeruh);
-  float mu_jernih = membershipJernih(errorKeruh);
-  float mu_sesuai = membershipSesuaiKeruh(errorKeruh);
-  float mu_keruh = membershipKeruh(errorKeruh);
-  float mu_sangatKeruh = membershipSangatKeruh(errorKeruh);
+void loopStatistikKontrol() {
+  static LaporanJadwal<5> laporan;
+  jadwalKontrol.ambilLaporan(laporan, micros());
+  laporanKontrol.tulis(laporan);
+  static uint32_t gagalBacaTerlapor = 0;
+  const uint32_t gagalBaca = konfigurasiBersama.jumlahGagalBaca() + hasilSuhu.jumlahGagalBaca();
+  if (gagalBaca != gagalBacaTerlapor) {
+    LOG_W("[SEQLOCK] %lu baca dari core 0 ditunda (snapshot lama dipakai)", (unsigned long)(gagalBaca - gagalBacaTerlapor));
+    gagalBacaTerlapor = gagalBaca;
+  }
+#if PROFIL_AKTIF
+  // Jendela profil tahap core 1 ditutup bersamaan dengan jendela jitter
+  static Profil lapProfil;
+  lapProfil.salinTahap(profil, TAHAP_CORE_KONTROL);
+  profil.resetTahap(TAHAP_CORE_KONTROL);
+  laporanProfil.tulis(lapProfil);
+#endif
+}
 
-  float numerator = (mu_sangatJernih * 0.0f) + (mu_jernih * 20.0f) + 
-                    (mu_sesuai * 50.0f) + (mu_keruh * 90.0f) + (mu_sangatKeruh * 100.0f);
-  float denominator = mu_sangatJernih + mu_jernih + mu_sesuai + mu_keruh + mu_sangatKeruh;
+void taskKontrol(void *) {
+  static KonfigurasiKontrol snapshot;   // di .bss, bukan di stack task
+  uint32_t versiAktif = 0;
+  uint32_t nomorResetAktif = konfigurasi.nomorResetPID;
+  uint32_t nomorKalibrasiAktif = konfigurasi.nomorKalibrasiAktuator;
+  uint32_t nomorAutotuneAktif = konfigurasi.nomorAutotune;
+  uint32_t nomorPerintahAktif = konfigurasi.nomorPerintah;
+
+  jadwalKontrol.tambah("sampel", PERIODE_SAMPEL_MS * 1000, 0, loopSampel);
+  jadwalKontrol.tambah("suhu", PERIODE_SUHU_MS * 1000, FASA_SUHU_MS * 1000, loopSuhu);
+  jadwalKontrol.tambah("keruh", PERIODE_KERUH_MS * 1000, FASA_KERUH_MS * 1000, loopKeruh);
+  jadwalKontrol.tambah("telemetri", PERIODE_KIRIM_MS * 1000, FASA_KIRIM_MS * 1000, loopKirim);
+  jadwalKontrol.tambah("statistik", PERIODE_STATISTIK_MS * 1000, FASA_STATISTIK_MS * 1000, loopStatistikKontrol);
+
+  halTimer.mulai(TICK_KONTROL_US);   // ISR timer membangunkan task ini
+  jadwalKontrol.mulai(micros());
+
+  for (;;) {
+    // Parameter baru dari core 0: salin snapshot utuh, tanpa lock. Penulis terpreempt di
+    // tengah tulis -> tick ini tetap dengan parameter lama, coba lagi tick berikutnya
+    if (konfigurasiBersama.versi() != versiAktif && konfigurasiBersama.cobaBaca(snapshot, versiAktif)) {
+      param = snapshot.param;
+      aturanFuzzy = snapshot.aturan;
+      if (snapshot.nomorPerintah != nomorPerintahAktif) {
+        nomorPerintahAktif = snapshot.nomorPerintah;
+        // Perintah sebelumnya tersusul sebelum kedua loop beraktuasi: kirim apa adanya
+        if (pelacakPerintah.menunggu) antrianGema.kirim(pelacakPerintah.g);
+        pelacakPerintah.mulai(snapshot.idPerintah, snapshot.terimaUs, micros());
+      }
+      if (snapshot.nomorResetPID != nomorResetAktif) {
+        nomorResetAktif = snapshot.nomorResetPID;
+        // Mode bayangan: kontroler baru sudah hangat, cukup diselaraskan
+        if (snapshot.param.modeBayangan && snapshot.param.transferMulus) mulaiTransferMulus(state, param, millis());
+        else resetPID(state, millis());
+      }
+      if (snapshot.nomorKalibrasiAktuator != nomorKalibrasiAktif) {
+        nomorKalibrasiAktif = snapshot.nomorKalibrasiAktuator;
+        const bool berjalan = kalibrasi.status == KALIBRASI_BERJALAN;
+        if (snapshot.aksiKalibrasiAktuator == KALIBRASI_AKSI_BATAL) {
+          kalibrasi.batal();
+          cekAkhirKalibrasi(berjalan);
+        } else {
+          const KanalPwm k = (KanalPwm)snapshot.aksiKalibrasiAktuator;
+          if (berjalan) hal.pwm->tulis(kalibrasi.kanal, 0);   // ganti aktuator: yang lama berhenti dulu
+          if (autotune.aktif(k)) {                             // satu eksperimen per aktuator
+            autotune.batal();
+            cekAkhirAutotune(true);
+          }
+          kalibrasi.mulai(k, pengaturanKalibrasi(k), millis());
+          laporanKalibrasi.tulis(kalibrasi);
+        }
+      }
+      if (snapshot.nomorAutotune != nomorAutotuneAktif) {
+        nomorAutotuneAktif = snapshot.nomorAutotune;
+        const bool menala = autotune.status == AUTOTUNE_BERJALAN;
+        if (snapshot.aksiAutotune == AUTOTUNE_AKSI_BATAL) {
+          autotune.batal();
+          cekAkhirAutotune(menala);
+        } else {
+          const KanalPwm k = (KanalPwm)snapshot.aksiAutotune;
+          if (menala) {
+            hal.pwm->tulis(autotune.kanal, 0);   // ganti loop: relay lama berhenti dulu
+            autotune.batal();
+            cekAkhirAutotune(true);
+          }
+          if (kalibrasi.aktif(k)) {
+            kalibrasi.batal();
+            cekAkhirKalibrasi(true);
+          }
+          const float sp = k == KANAL_HEATER ? param.suhuSetpoint : param.turbiditySetpoint;
+          autotune.mulai(k, sp, (AturanAutotune)snapshot.aturanAutotune, snapshot.terapkanAutotune,
+                         pengaturanAutotune(k, snapshot.resolusiSuhu), millis());
+          laporanAutotune.tulis(autotune);
+        }
+      }
+    }
 
-  if (denominator < 0.01f) return 50.0f; 
-  return numerator / denominator;
+    jadwalKontrol.jalankan(halClock);
+    halTimer.tunggu();
+  }
 }
 
 // =========================================================================
-//                      KONTROL PID (ADVANCED)
+//                  TASK JARINGAN (CORE 0)
 // =========================================================================
 
-double hitungPIDSuhu(float errorSuhu) {
-  unsigned long now = millis();
-  double dt = (double)(now - lastTimeSuhu) / 1000.0;
-  if (dt < 0.001) dt = 0.001; 
-
-  double P = Kp_suhu * errorSuhu;
-
-  integralSumSuhu += errorSuhu * dt;
-  if (integralSumSuhu > 20.0) integralSumSuhu = 20.0;
-  if (integralSumSuhu < -20.0) integralSumSuhu = -20.0;
+// Debug Lengkap di Serial Monitor
+void cetakDebug(const PaketTelemetri &p) {
+  const Telemetri &t = p.t;
+  unsigned long s = t.timestamp_ms / 1000;  // Total detik
+  unsigned long m = s / 60;                 // Total menit
+  unsigned long h = m / 60;                 // Total jam
+
+  LOG_D("\n-------------------------------------------------------------");
+  LOG_D("[%02lu:%02lu:%02lu] [SYSTEM] Mode: %s | WiFi: %s (%d dBm) | Telemetri dibuang: %lu", 
+    (h % 24), (m % 60), (s % 60), 
+    (t.kontrolAktif == FUZZY) ? "FUZZY" : (t.kontrolAktif == MPC) ? "MPC (EKSPLISIT)" : "PID (ADAPTIVE)", 
+    WiFi.status() == WL_CONNECTED ? "ONLINE" : "OFFLINE", 
+    WiFi.RSSI(), (unsigned long)antrianTelemetri.jumlahTerbuang()
+  );
   
-  if ((errorSuhu > 0 && lastErrorSuhu < 0) || (errorSuhu < 0 && lastErrorSuhu > 0)) {
-    integralSumSuhu *= 0.5;
+  LOG_D("[TURBIDITY] Current: %.2f%% (Set: %.1f%%) | Error: %.2f", 
+    t.turbidityPersen, t.setpointKeruh, t.errorKeruh
+  );
+  LOG_D("            ADC Val: %d | Calib: [Jernih:%d - Keruh:%d] | Sampel: %lu (terlewat %lu)", 
+    t.turbidityAdc, konfigurasi.param.NILAI_ADC_JERNIH, konfigurasi.param.NILAI_ADC_KERUH,
+    (unsigned long)p.jumlahSampel, (unsigned long)p.sampelTerlewat
+  );
+  LOG_D("[KIRIM]     Terkirim: %lu | Ditekan: %lu | Transien: %s",
+    (unsigned long)kebijakanKirim.terkirim(), (unsigned long)kebijakanKirim.ditekan(),
+    kebijakanKirim.transien(t.timestamp_ms, pengaturanTelemetri.kirim) ? "YA" : "TIDAK"
+  );
+  LOG_D("[SIMPAN]    Tertunda: %lu (flash %lu) | Diputar ulang: %lu | Dibuang: %lu | Sesi: %u",
+    (unsigned long)simpanTerus.tertunda(), (unsigned long)simpanTerus.tertundaFlash(),
+    (unsigned long)simpanTerus.stat.diputarUlang, (unsigned long)simpanTerus.stat.dibuang,
+    (unsigned)simpanTerus.sesi()
+  );
+  LOG_D("            Output : %.1f%% (PWM: %d) | Feedforward: %s", 
+    t.outKeruh, t.pwmKeruh, 
+    t.feedforwardActive ? "ON" : "OFF"
+  );
+
+  LOG_D("[TEMP]      Current: %.2f°C (Set: %.1f°C) | Error: %.2f", 
+    t.suhu, t.setpointSuhu, t.errorSuhu
+  );
+  LOG_D("            Output : %.1f%% (PWM: %d)", t.outSuhu, t.pwmSuhu);
+  if (t.bayangan) {
+    LOG_D("[BAYANGAN]  Suhu  F/P: %.1f/%.1f%% (%.1f+%.1f us) | Lewat anggaran: %lu",
+      t.bayanganSuhu.fuzzy, t.bayanganSuhu.pid, t.bayanganSuhu.usFuzzy, t.bayanganSuhu.usPid,
+      (unsigned long)t.lewatAnggaranBayangan);
+    LOG_D("            Keruh F/P: %.1f/%.1f%% (%.1f+%.1f us)",
+      t.bayanganKeruh.fuzzy, t.bayanganKeruh.pid, t.bayanganKeruh.usFuzzy, t.bayanganKeruh.usPid);
   }
-  double I = Ki_suhu * integralSumSuhu;
-
-  double rawDerivative = (errorSuhu - lastErrorSuhu) / dt;
-  static double lastDerivSuhu = 0.0;
-  double derivative = 0.3 * rawDerivative + 0.7 * lastDerivSuhu; 
-  lastDerivSuhu = derivative;
-  double D = Kd_suhu * derivative;
-
-  lastErrorSuhu = errorSuhu;
-  lastTimeSuhu = now;
-
-  return constrain(P + I + D, 0.0, 100.0);
+  if (p.jumlahProbe > 1) {
+    char baris[LOG_PANJANG];
+    int n = snprintf(baris, sizeof(baris), "            Probe  :");
+    for (int i = 0; i < p.jumlahProbe && n > 0 && n < (int)sizeof(baris); i++)
+      n += snprintf(baris + n, sizeof(baris) - n, " [%d] %.2f°C", i, p.suhuProbe[i]);
+    LOG_D("%s", baris);
+  }
+  LOG_D("-------------------------------------------------------------");
 }
 
-double hitungPIDKeruh(float errorKeruh) {
-  unsigned long now = millis();
-  double dt = (double)(now - lastTimeKeruh) / 1000.0;
-  if (dt < 0.001) dt = 0.001;
-
-  double dynamicKp;
-  double dynamicKd;
-  
-  if (abs(errorKeruh) > 2.0) {
-    dynamicKp = 35.0; // Mode Turbo
-    dynamicKd = 0.0;  
-    integralSumKeruh = 0; 
-  } else {
-    dynamicKp = Kp_keruh; // Mode Smooth
-    dynamicKd = Kd_keruh; 
+// Kirim batch biner jika sudah waktunya (atau dipaksa saat ganti ke JSON).
+// Gagal kirim saat offline / batch penuh -> isinya pindah ke store-and-forward.
+void flushBatch(bool paksa) {
+  const PengaturanTelemetri &pt = pengaturanTelemetri;
+  if (!paksa && !batchTelemetri.perluFlush(millis(), pt.batchSampel, pt.batchIntervalMs)) return;
+  if (kirimBatchTelemetri(hal, MQTT_TOPIC_BATCH, batchTelemetri)) return;
+  if (paksa || batchTelemetri.penuh() || !mqttClient.connected()) {
+    for (int i = 0; i < batchTelemetri.jumlah; i++) simpanTerus.simpan(batchTelemetri.record(i));
+    batchTelemetri.reset();
   }
+}
 
-  double P = dynamicKp * errorKeruh;
-
-  integralSumKeruh += errorKeruh * dt;
-  integralSumKeruh = constrain(integralSumKeruh, -20.0, 20.0); 
-  double I = Ki_keruh * integralSumKeruh;
-
-  double rawDerivative = (errorKeruh - lastErrorKeruh) / dt;
-  static double lastDerivKeruh = 0.0;
-  double derivative = 0.3 * rawDerivative + 0.7 * lastDerivKeruh; 
-  lastDerivKeruh = derivative;
-  double D = dynamicKd * derivative;
-
-  double feedForward = 50.0; 
-
-  double output = P + I + D + feedForward;
-
-  float aktualTurbidity = errorKeruh + turbiditySetpoint; 
-  if (aktualTurbidity >= 11.0) {
-     if (output < 50.0) {
-        output = 50.0; // TAHAN DI SINI! JANGAN TURUN!
-     }
+void logKoneksi(uint8_t kejadian) {
+  const StatistikKoneksi &s = koneksi.stat;
+  if (kejadian & KONEKSI_WIFI_TURUN) LOG_W("[WiFi] Putus, menyambung ulang...");
+  if (kejadian & KONEKSI_MQTT_TURUN) LOG_W("[MQTT] Putus dari broker");
+  if (kejadian & KONEKSI_WIFI_NAIK) {
+    LOG_I("\n[WiFi] Terhubung ke %s dalam %lu ms (cache kena %lu / meleset %lu)! IP: %s", koneksi.ssidAktif(),
+      (unsigned long)s.msWifiTerakhir, (unsigned long)s.cacheKena, (unsigned long)s.cacheMeleset,
+      WiFi.localIP().toString().c_str());
   }
-  float targetMatiTotal = 9.0; 
-
-  if (aktualTurbidity <= targetMatiTotal) {
-    output = 0.0;          
-    integralSumKeruh = 0;  
+  if (kejadian & KONEKSI_MQTT_NAIK) {
+    LOG_I("[MQTT] Terhubung ke %s | sejak boot/putus: %lu ms | sambung ke-%lu", MQTT_BROKER,
+      (unsigned long)(s.sambungMqtt == 1 ? s.msBootTerhubung : s.msSambungTerakhir), (unsigned long)s.sambungMqtt);
   }
-
-  float alpha = 0.5; 
-  
-  outputKeruhTerfilter = (alpha * output) + ((1.0 - alpha) * outputKeruhTerfilter);
-
-  lastErrorKeruh = errorKeruh;
-  lastTimeKeruh = now;
-
-  return constrain(output, 0.0, 100.0);
 }
 
-void resetPID() {
-  integralSumSuhu = 0; lastErrorSuhu = 0;
-  integralSumKeruh = 0; lastErrorKeruh = 0;
-  lastTimeSuhu = millis(); lastTimeKeruh = millis();
-  outputKeruhTerfilter = 0.0;
-  suhuTerfilter = 0.0;
+// Laporan kalibrasi dari core 1: kurva hasil dipasang ke konfigurasi aktif &
+// disimpan ke flash (hanya jika KALIBRASI_PASANG_OTOMATIS), lalu dipublikasikan
+// (retained) untuk dashboard
+void layaniKalibrasi() {
+  static KalibrasiAktuator lap;
+  static uint32_t versiTerkirim = 0;
+  const uint32_t versi = laporanKalibrasi.versi();
+  if (versi == versiTerkirim || versi == 0) return;
+  versiTerkirim = laporanKalibrasi.baca(lap);
+
+  const char *nama = lap.kanal == KANAL_HEATER ? "heater" : "pompa";
+  if (lap.status == KALIBRASI_BERJALAN) LOG_I("[AKTUATOR] Kalibrasi %s dimulai", nama);
+  if (lap.status == KALIBRASI_GAGAL) LOG_W("[AKTUATOR] Kalibrasi %s gagal: %s (kurva lama tetap)", nama, lap.alasan);
+  if (lap.status == KALIBRASI_SELESAI) {
+#if KALIBRASI_PASANG_OTOMATIS
+    (lap.kanal == KANAL_HEATER ? konfigurasi.param.kurvaHeater : konfigurasi.param.kurvaPompa) = lap.kurva;
+    konfigurasiBersama.tulis(konfigurasi);
+    const bool tersimpan = simpanKurvaAktuator(halBerkas, konfigurasi.param.kurvaHeater, konfigurasi.param.kurvaPompa);
+    const char *pasang = tersimpan ? "dipasang, flash OK" : "dipasang, flash GAGAL";
+#else
+    const char *pasang = "tidak dipasang";
+#endif
+    LOG_I("[AKTUATOR] Kalibrasi %s selesai | dead band %.1f%% duty | logika 50%% -> %.1f%% duty | %s", nama,
+      lap.kurva.duty[0] * 100.0f, lap.kurva.duty[5] * 100.0f, pasang);
+  }
+  char buffer[512];
+  if (serializeKalibrasi(lap, buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_AKTUATOR, buffer, true);
 }
 
-// =========================================================================
-//                  KONEKSI WIFI & MQTT
-// =========================================================================
-
-void setup_wifi() {
-  delay(10);
-  Serial.println("\n[WiFi] Mencoba koneksi...");
-  WiFi.mode(WIFI_STA);
-  WiFi.disconnect();
-
-  for (int network = 0; network < NUM_WIFI_NETWORKS; network++) {
-    Serial.printf("\n[WiFi] Mencoba network: %s\n", wifiNetworks[network].ssid);
-    WiFi.begin(wifiNetworks[network].ssid, wifiNetworks[network].password);
-
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-      delay(500); Serial.print("."); attempts++;
-    }
-
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.printf("\n[WiFi] Terhubung! IP: %s\n", WiFi.localIP().toString().c_str());
-      return;
+// Laporan autotune dari core 1: gain hasil dipasang (jika diminta) sebagai satu
+// snapshot konfigurasi baru, lalu dipublikasikan (retained) untuk dashboard
+void layaniAutotune() {
+  static AutotuneRelay lap;
+  static uint32_t versiTerkirim = 0;
+  const uint32_t versi = laporanAutotune.versi();
+  if (versi == versiTerkirim || versi == 0) return;
+  versiTerkirim = laporanAutotune.baca(lap);
+
+  const char *nama = lap.kanal == KANAL_HEATER ? "suhu" : "keruh";
+  if (lap.status == AUTOTUNE_BERJALAN) LOG_I("[AUTOTUNE] Relay loop %s dimulai di setpoint %.2f", nama, lap.setpoint);
+  if (lap.status == AUTOTUNE_GAGAL) LOG_W("[AUTOTUNE] Loop %s gagal: %s (gain lama tetap)", nama, lap.alasan);
+  if (lap.status == AUTOTUNE_SELESAI) {
+    bool terpasang = false;
+    if (lap.terapkan && terapkanAutotune(lap, konfigurasi.param, AUTOTUNE_GAIN_MAKS)) {
+      konfigurasiBersama.tulis(konfigurasi);
+      terpasang = true;
     }
+    lap.terpasang = terpasang;   // backend menyimpan gain ke Control hanya jika true
+    LOG_I("[AUTOTUNE] Loop %s: Ku %.4g, Pu %.0f s -> Kp %.4g Ki %.4g Kd %.4g | %s", nama, lap.ku, lap.pu, lap.kp,
+      lap.ki, lap.kd, terpasang ? "DIPASANG" : (lap.terapkan ? "di luar rentang, tidak dipasang" : "tidak dipasang"));
   }
-  Serial.println("\n[WiFi] Gagal semua network. Restart ESP...");
-  ESP.restart();
+  char buffer[384];
+  if (serializeAutotune(lap, buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_AUTOTUNE, buffer, true);
 }
 
-void callback(char *topic, byte *payload, unsigned int length) {
-  // Gunakan DynamicJsonDocument agar aman dari Stack Overflow
-  DynamicJsonDocument doc(1024);
-  DeserializationError error = deserializeJson(doc, payload, length);
-
-  if (error) {
-    Serial.printf("[MQTT ERROR] Gagal parse JSON: %s\n", error.c_str());
-    return;
+// Gema perintah (diterima dari core 1, ditolak dari callback) -> MQTT_TOPIC_GEMA
+void terbitkanGema(const GemaPerintah &g) {
+  if (g.ok) {
+    LOG_D("[GEMA] Perintah %lu | terap %lu us | aktuasi suhu %lu us, keruh %lu us", (unsigned long)g.id,
+      (unsigned long)(g.terapUs - g.terimaUs), (unsigned long)(g.aktuasiSuhuUs - g.terimaUs),
+      (unsigned long)(g.aktuasiKeruhUs - g.terimaUs));
   }
+  char buffer[256];
+  if (serializeGemaPerintah(g, TitikWaktu::sekarang(halClock), buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_GEMA, buffer, false);
+}
 
-  // --- 1. UPDATE MODE KONTROL ---
-  if (doc.containsKey("kontrol_aktif")) {
-    String mode = doc["kontrol_aktif"].as<String>();
-    if (mode == "Fuzzy") kontrolAktif = FUZZY;
-    else kontrolAktif = PID;
-    resetPID(); 
-    Serial.println("\n========================================");
-    Serial.printf("[MODE] Ganti Mode Kontrol ke: %s\n", mode.c_str());
-    Serial.println("========================================");
+void layaniGema() {
+  GemaPerintah g;
+  while (antrianGema.ambil(g)) terbitkanGema(g);
+  if (adaGemaTolak) {
+    adaGemaTolak = false;
+    terbitkanGema(gemaTolak);
   }
+}
 
-  // --- 2. UPDATE SETPOINT ---
-  if (doc.containsKey("suhu_setpoint")) {
-    suhuSetpoint = doc["suhu_setpoint"];
-    Serial.printf("[SETPOINT] Target Suhu Baru: %.2f C\n", suhuSetpoint);
-  }
-  if (doc.containsKey("keruh_setpoint")) {
-    turbiditySetpoint = doc["keruh_setpoint"];
-    Serial.printf("[SETPOINT] Target Kekeruhan Baru: %.2f %%\n", turbiditySetpoint);
+void loopMqtt() {
+  const uint8_t kejadian = koneksi.layani();
+  if (kejadian) logKoneksi(kejadian);
+  if (kejadian & KONEKSI_MQTT_NAIK) {
+    mqttClient.subscribe(MQTT_TOPIC_MODE, 1);
+    mqttClient.subscribe(MQTT_TOPIC_MODE_SEMUA, 1);
   }
+  mqttClient.loop();
 
-  // --- 3. UPDATE TUNING PID ---
-  bool tuningUpdated = false;
-  
-  // PID Suhu
-  if (doc.containsKey("kp_suhu")) { Kp_suhu = doc["kp_suhu"]; tuningUpdated = true; }
-  if (doc.containsKey("ki_suhu")) { Ki_suhu = doc["ki_suhu"]; tuningUpdated = true; }
-  if (doc.containsKey("kd_suhu")) { Kd_suhu = doc["kd_suhu"]; tuningUpdated = true; }
-
-  // PID Keruh
-  if (doc.containsKey("kp_keruh")) { Kp_keruh = doc["kp_keruh"]; tuningUpdated = true; }
-  if (doc.containsKey("ki_keruh")) { Ki_keruh = doc["ki_keruh"]; tuningUpdated = true; }
-  if (doc.containsKey("kd_keruh")) { Kd_keruh = doc["kd_keruh"]; tuningUpdated = true; }
-
-  if (tuningUpdated) {
-    Serial.println("\n----------- PID PARAMETER BERHASIL DI-UPDATE -----------");
-    // PERBAIKAN: Menghapus %s dan timeStr yang bikin crash
-    Serial.printf("[PID SUHU ] Kp: %.2f | Ki: %.2f | Kd: %.2f\n", Kp_suhu, Ki_suhu, Kd_suhu);
-    Serial.printf("[PID KERUH] Kp: %.2f | Ki: %.2f | Kd: %.2f\n", Kp_keruh, Ki_keruh, Kd_keruh);
-    Serial.println("--------------------------------------------------------");
-  }
-
-  // --- 4. UPDATE KALIBRASI ---
-  bool calibUpdated = false;
-  if (doc.containsKey("adc_jernih")) { 
-    NILAI_ADC_JERNIH = doc["adc_jernih"]; 
-    calibUpdated = true; 
-  }
-  if (doc.containsKey("adc_keruh")) { 
-    NILAI_ADC_KERUH = doc["adc_keruh"]; 
-    calibUpdated = true; 
-  }
-
-  if (calibUpdated) {
-    Serial.println("\n!!!!!!!!!! CALIBRATION UPDATED !!!!!!!!!!");
-    // PERBAIKAN: Menghapus %s dan timeStr
-    Serial.printf("[CALIB] ADC Jernih (0%%)   : %d\n", NILAI_ADC_JERNIH);
-    Serial.printf("[CALIB] ADC Keruh (100%%)  : %d\n", NILAI_ADC_KERUH);
-    Serial.println("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+  // Kirim Telemetri ke Dashboard (MQTT) + debug, urut sesuai tick;
+  // sampel yang ditekan kebijakan tidak dikirim, tidak di-batch, tidak disimpan
+  PaketTelemetri paket;
+  while (antrianTelemetri.ambil(paket)) {
+    if (kebijakanKirim.putuskan(paket.t, pengaturanTelemetri.kirim) == KIRIM_DITEKAN) continue;
+    if (pengaturanTelemetri.biner) {
+      {
+        PROFIL_LINGKUP(hal, PROFIL_SERIALIZE);
+        batchTelemetri.tambah(paket.t, millis());
+      }
+      flushBatch(false);
+    } else {
+      if (batchTelemetri.jumlah > 0) flushBatch(true);
+      if (!kirimTelemetri(hal, MQTT_TOPIC_DATA, paket.t)) simpanTerus.simpan(paket.t);
+    }
+    if (LOG_TINGKAT >= LOG_TINGKAT_DEBUG) cetakDebug(paket);
   }
+  if (batchTelemetri.jumlah > 0) flushBatch(!pengaturanTelemetri.biner);
+  layaniKalibrasi();
+  layaniAutotune();
+  layaniGema();
 }
 
-bool reconnect_mqtt() {
-  if (mqttClient.connect(MQTT_CLIENT_ID)) {
-    mqttClient.subscribe(MQTT_TOPIC_MODE, 1); 
-    return true;
-  }
-  return false;
+// Backlog dikirim bertahap (batch biner berflag putar ulang) supaya broker
+// dan telemetri live tidak tertahan saat baru online
+void loopPutarUlang() {
+  if (!mqttClient.connected()) return;
+  simpanTerus.putarUlang(hal, MQTT_TOPIC_BATCH, PUTAR_ULANG_MAKS_RECORD);
 }
 
-// =========================================================================
-//                  PEMBACAAN SENSOR
-// =========================================================================
-
-float bacaSuhuDS18B20() {
-  sensors.requestTemperatures();
-  float tempC = sensors.getTempCByIndex(0);
-
-  if (tempC == -127.00f || isnan(tempC)) {
-    return (suhuTerfilter == 0.0) ? 28.0 : suhuTerfilter;
+// Satu pesan per loop: {"penjadwal":"kontrol","loop":"suhu","jitter_max_us":...}
+template <int N>
+void kirimLaporanJadwal(const char *penjadwal, const LaporanJadwal<N> &lap) {
+  char buffer[384];
+  for (int i = 0; i < lap.jumlah; i++) {
+    if (serializeStatistikLoop(lap.loop[i], penjadwal, lap.jendelaUs, buffer, sizeof(buffer)) == 0) continue;
+    if (mqttClient.connected()) mqttClient.publish(MQTT_TOPIC_JADWAL, buffer, false);
   }
-
-  if (suhuTerfilter == 0.0) suhuTerfilter = tempC;
-  else suhuTerfilter = (ALPHA * tempC) + ((1.0 - ALPHA) * suhuTerfilter);
-  
-  suhuTerakhir = suhuTerfilter; 
-  return suhuTerfilter;
 }
 
-int bacaTurbidity() {
-  int buffer[20]; // Kita ambil 20 sampel
-  
-  // 1. Ambil sampel
-  for (int i = 0; i < 20; i++) {
-    int16_t val = ads.readADC_SingleEnded(0);
-    if (val < 0) val = 0;
-    if (val > 32767) val = 32767;
-    buffer[i] = val;
-    delay(2);
-  }
-
-  // 2. Urutkan dari Kecil ke Besar (Sorting)
-  for (int i = 0; i < 19; i++) {
-    for (int j = i + 1; j < 20; j++) {
-      if (buffer[i] > buffer[j]) {
-        int temp = buffer[i];
-        buffer[i] = buffer[j];
-        buffer[j] = temp;
-      }
-    }
+#if PROFIL_AKTIF
+// Satu pesan per tahap (histogram bisa panjang) + satu pesan memori
+void kirimProfil() {
+  static Profil lap;
+  static uint32_t versiTerkirim = 0;
+  uint32_t versi = laporanProfil.versi();
+  if (versi != versiTerkirim && versi != 0) versiTerkirim = laporanProfil.baca(lap);
+  else lap.resetTahap(TAHAP_CORE_KONTROL);   // jendela core 1 belum ganti: jangan kirim ulang
+  lap.salinTahap(profil, ~TAHAP_CORE_KONTROL);
+  profil.resetTahap(~TAHAP_CORE_KONTROL);
+  if (!mqttClient.connected()) return;
+
+  char buffer[768];
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++) {
+    if (lap.tahap[i].jumlah == 0) continue;
+    if (serializeStatTahap(lap.tahap[i], (TahapProfil)i, PERIODE_STATISTIK_MS, buffer, sizeof(buffer)) > 0)
+      mqttClient.publish(MQTT_TOPIC_PROFIL, buffer, false);
   }
+  // Stack ESP-IDF dalam byte; high-water mark = sisa stack terkecil sejak task dibuat
+  const MemoriProfil m = {ESP.getFreeHeap(), ESP.getMinFreeHeap(),
+                          (uint32_t)uxTaskGetStackHighWaterMark(taskKontrolHandle),
+                          (uint32_t)uxTaskGetStackHighWaterMark(taskJaringanHandle),
+                          (uint32_t)uxTaskGetStackHighWaterMark(taskLogHandle),
+                          (uint32_t)uxTaskGetStackHighWaterMark(taskSuhuHandle)};
+  if (serializeMemoriProfil(m, buffer, sizeof(buffer)) > 0) mqttClient.publish(MQTT_TOPIC_PROFIL, buffer, false);
+}
+#endif
 
-  // 3. Ambil Nilai Tengah (Median)
-  // Ini akan membuang nilai gelembung yang ekstrim tinggi
-  int medianADC = buffer[10]; 
+void loopStatistikJaringan() {
+  static LaporanJadwal<5> lapKontrol;
+  static LaporanJadwal<4> lapJaringan;
+  static uint32_t versiTerkirim = 0;
 
-  // Update nilai global
-  turbidityTerakhir = medianADC; 
-  return medianADC;
+  uint32_t versi = laporanKontrol.versi();
+  if (versi != versiTerkirim && versi != 0) {
+    versiTerkirim = laporanKontrol.baca(lapKontrol);
+    kirimLaporanJadwal("kontrol", lapKontrol);
+  }
+  jadwalJaringan.ambilLaporan(lapJaringan, micros());
+  kirimLaporanJadwal("jaringan", lapJaringan);
+
+  char buffer[512];
+  if (serializeStatusSimpan(simpanTerus, buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_STATUS, buffer, false);
+  // Heap: bebas sekarang & titik terendah sejak boot (high-water mark pemakaian)
+  if (serializeStatusPerintah(statistikPerintah, ESP.getFreeHeap(), ESP.getMinFreeHeap(), buffer, sizeof(buffer)) > 0 &&
+      mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_PERINTAH, buffer, false);
+  if (serializeStatusKoneksi(koneksi, WiFi.RSSI(), buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_KONEKSI, buffer, false);
+  bool transien = kebijakanKirim.transien(millis(), pengaturanTelemetri.kirim);
+  if (serializeStatusKirim(kebijakanKirim, transien, buffer, sizeof(buffer)) > 0 && mqttClient.connected())
+    mqttClient.publish(MQTT_TOPIC_KIRIM, buffer, false);
+#if PROFIL_AKTIF
+  kirimProfil();
+#endif
 }
 
-float konversiTurbidityKePersen(int adcValue) {
-  float persen = mapFloat((float)adcValue, (float)NILAI_ADC_KERUH, (float)NILAI_ADC_JERNIH, 100.0, 0.0);
-  return constrain(persen, 0.0f, 100.0f);
+void taskJaringan(void *) {
+  // Flash disentuh hanya dari task ini
+  simpanTerus.mulai(&halBerkas);
+  batchTelemetri.sesi = simpanTerus.sesi();
+  LOG_I("[SIMPAN] Sesi %u | flash %s | backlog %lu record", (unsigned)simpanTerus.sesi(),
+    simpanTerus.flashAktif() ? "OK" : "GAGAL (RAM saja)", (unsigned long)simpanTerus.tertunda());
+  if (muatKurvaAktuator(halBerkas, konfigurasi.param.kurvaHeater, konfigurasi.param.kurvaPompa)) {
+    konfigurasiBersama.tulis(konfigurasi);
+    LOG_I("[AKTUATOR] Kurva hasil kalibrasi dimuat dari flash");
+  }
+
+  mqttClient.setBufferSize(TELEMETRI_BINER_UKURAN_MAKS + 128 > 512 ? TELEMETRI_BINER_UKURAN_MAKS + 128 : 512); 
+  mqttClient.setServer(MQTT_BROKER, MQTT_PORT);
+  mqttClient.setCallback(callback);
+  mqttClient.setSocketTimeout(MQTT_TIMEOUT_S);
+
+  PengaturanKoneksi pk;
+  pk.jaringan = wifiNetworks;
+  pk.jumlahJaringan = NUM_WIFI_NETWORKS;
+  pk.clientId = topikPerangkat.clientId();
+  pk.ip = IP_STATIS;
+  koneksi.mulai(halClock, halWifi, halMqtt, &halBerkas, pk, esp_random());
+
+  jadwalJaringan.tambah("mqtt", PERIODE_MQTT_MS * 1000, 0, loopMqtt);
+  jadwalJaringan.tambah("putar_ulang", PERIODE_PUTAR_ULANG_MS * 1000, 500 * 1000, loopPutarUlang);
+  jadwalJaringan.tambah("statistik", PERIODE_STATISTIK_MS * 1000, 1000 * 1000, loopStatistikJaringan);
+  jadwalJaringan.mulai(micros());
+
+  TickType_t bangun = xTaskGetTickCount();
+  for (;;) {
+    // beri waktu task WiFi/idle di core 0
+    vTaskDelayUntil(&bangun, pdMS_TO_TICKS(TICK_JARINGAN_MS));
+    jadwalJaringan.jalankan(halClock);
+  }
 }
 
 // =========================================================================
@@ -521,139 +866,62 @@ float konversiTurbidityKePersen(int adcValue) {
 // =========================================================================
 
 void setup() {
+  Serial.setTxBufferSize(LOG_UART_TX);
   Serial.begin(115200);
+  // Task log duluan: pesan setup sudah lewat antrian (termasuk error fatal di bawah)
+  xTaskCreatePinnedToCore(taskLog, "log", STACK_LOG, NULL, PRIORITAS_LOG, &taskLogHandle, JARINGAN_CORE);
   
   Wire.begin();
+  Wire.setClock(400000); // baca hasil konversi secepat mungkin (s.d. 860 SPS)
   if (!ads.begin()) {
-    Serial.println("[ERR] ADS1115 Tidak Terdeteksi!");
+    LOG_E("[ERR] ADS1115 Tidak Terdeteksi!");
     while (1);
   }
+  sensor.turbidity.mulai(halAdc, TURBIDITY_JENDELA, TURBIDITY_SPS);
   
-  setupL298N();
-  sensors.begin();
-  resetPID();
-  setup_wifi();
-  
-  mqttClient.setBufferSize(512); 
-  mqttClient.setServer(MQTT_BROKER, MQTT_PORT);
-  mqttClient.setCallback(callback);
-  
-  Serial.println("\n=== SISTEM SIAP: RISET KENDALI HYBRID ===");
-}
-
-void loop() {
-  unsigned long now = millis();
-
-  if (now - lastWiFiCheck >= wifiCheckInterval) {
-    lastWiFiCheck = now;
-    if (WiFi.status() != WL_CONNECTED) {
-      WiFi.disconnect(); WiFi.reconnect();
-    }
+  halPwm.begin(PWM_FREQ, PWM_RESOLUTION);
+  LOG_I("[PWM] %d Hz, %d bit (duty 0-%d)", PWM_FREQ, PWM_RESOLUTION, PWM_DUTY_MAKS);
+  pipelineSuhu.mulai(halSuhu, SUHU_RESOLUSI);
+  hasilSuhu.tulis(pipelineSuhu);   // jumlah probe sudah terlihat core 1 sebelum set pertama
+  LOG_I("[SUHU] %d probe DS18B20, resolusi %d bit (%lu ms/konversi)",
+    pipelineSuhu.jumlahProbe, pipelineSuhu.resolusi, PipelineSuhu::waktuKonversiMs(pipelineSuhu.resolusi));
+  resetPID(state, millis());
+#ifdef BENCH_PID
+  // Biaya mesin PID per tipe angka di target (build_flags: -DBENCH_PID)
+  const SiklusPid sd = ukurSiklusPid<double>(1000), sf = ukurSiklusPid<float>(1000), sq = ukurSiklusPid<Q16>(1000);
+  LOG_I("[PID] siklus/panggilan suhu|keruh: double %u|%u  float %u|%u  Q16 %u|%u",
+    (unsigned)sd.suhu, (unsigned)sd.keruh, (unsigned)sf.suhu, (unsigned)sf.keruh, (unsigned)sq.suhu, (unsigned)sq.keruh);
+#endif
+  LOG_I("[FUZZY] LUT %d titik | error maks suhu: %.4f%% | keruh: %.4f%%",
+    FUZZY_LUT_RESOLUSI, aturanFuzzy.lutSuhu.errorMaks, aturanFuzzy.lutKeruh.errorMaks);
+
+  // ID & topik per perangkat: -DMQTT_ID_PERANGKAT, atau MAC pabrik (efuse) jika tidak ada / tidak valid
+  char idPerangkat[ID_PERANGKAT_MAKS] = "";
+#ifdef MQTT_ID_PERANGKAT
+  snprintf(idPerangkat, sizeof(idPerangkat), "%s", MQTT_ID_PERANGKAT);
+#endif
+  if (!topikPerangkat.mulai(MQTT_PREFIX, idPerangkat)) {
+    if (idPerangkat[0]) LOG_W("[MQTT] MQTT_ID_PERANGKAT \"%s\" tidak valid, pakai MAC", idPerangkat);
+    uint8_t mac[6];
+    esp_efuse_mac_get_default(mac);
+    idDariMac(mac, idPerangkat, sizeof(idPerangkat));
+    topikPerangkat.mulai(MQTT_PREFIX, idPerangkat);
   }
+  LOG_I("[MQTT] ID perangkat %s | telemetri -> %s", topikPerangkat.clientId(), MQTT_TOPIC_DATA);
 
-  if (!mqttClient.connected()) reconnect_mqtt();
-  mqttClient.loop();
-
-  if (now - waktuTerakhirKirim >= intervalKirim) {
-    waktuTerakhirKirim = now;
-
-    // 1. Baca Sensor
-    float suhuAktual = bacaSuhuDS18B20();
-    int turbidityADC = bacaTurbidity();
-    float turbidityPersen = konversiTurbidityKePersen(turbidityADC);
-
-    // 2. Hitung Error
-    float errorSuhu = suhuSetpoint - suhuAktual;
-    float errorKeruh = turbidityPersen - turbiditySetpoint;
-
-    // 3. Hitung Output Kontrol
-    double outSuhu, outKeruh;
-    if (kontrolAktif == FUZZY) {
-      double rawFuzzy = hitungFuzzySuhu(errorSuhu); 
-      outSuhu = rawFuzzy; 
-
-      double rawFuzzyKeruh = hitungFuzzyKeruh(errorKeruh);
-      if (turbidityPersen >= 11.0) {     
-         if (rawFuzzyKeruh < 50.0) {     
-            rawFuzzyKeruh = 50.0;        
-         }
-      }
-      if (turbidityPersen <= 9.0) {
-          rawFuzzyKeruh = 0.0;
-      }
-      outputKeruhTerfilter = (0.5 * rawFuzzyKeruh) + ((1.0 - 0.5) * outputKeruhTerfilter);
-      outKeruh = outputKeruhTerfilter;
-      
-    } else {
-      outSuhu = hitungPIDSuhu(errorSuhu);
-      outKeruh = hitungPIDKeruh(errorKeruh); 
-    }
+  konfigurasiBersama.tulis(konfigurasi);
+  // Jam dinding untuk stempel latensi; SNTP menunggu WiFi sendiri, sebelum sinkron kirim_ms = null
+  halClock.mulaiSntp(NTP_SERVER_1, NTP_SERVER_2);
 
-    // 4. Eksekusi ke Motor
-    int pwmSuhu = constrain((int)(outSuhu * 2.55), 0, 255);
-    int pwmKeruh = constrain((int)(outKeruh * 2.55), 0, 255);
-
-    setHeaterSpeed(pwmSuhu);
-    setPumpSpeed(pwmKeruh);
-
-    // 5. Kirim Telemetri ke Dashboard (MQTT)
-    if (mqttClient.connected()) {
-      StaticJsonDocument<512> doc;
-
-      // --- Basic Data (Nama Key sesuai kode lama) ---
-      doc["timestamp_ms"] = now;  
-      doc["suhu"] = round(suhuAktual * 100) / 100.0;
-      doc["turbidity_persen"] = round(turbidityPersen * 100) / 100.0;
-      doc["turbidity_adc"] = turbidityADC;
-      doc["kontrol_aktif"] = (kontrolAktif == FUZZY) ? "Fuzzy" : "PID"; // Kembali ke "kontrol_aktif"
-      
-      // Kirim nilai 0-100% (bukan PWM 0-255) agar enak dibaca di grafik
-      doc["pwm_heater"] = round(outSuhu * 100) / 100.0; 
-      doc["pwm_pompa"] = round(outKeruh * 100) / 100.0;
-
-      // --- Research Data ---
-      doc["error_suhu"] = round(errorSuhu * 1000) / 1000.0;
-      doc["error_keruh"] = round(errorKeruh * 1000) / 1000.0;
-      doc["setpoint_suhu"] = suhuSetpoint;
-      doc["setpoint_keruh"] = turbiditySetpoint;
-
-      // --- Data Tambahan (Optional - Fitur Baru) ---
-      // Ini tidak akan merusak dashboard lama, cuma nambah info jika ingin dipakai
-      doc["feedforward_active"] = (abs(errorKeruh) < 3.0 && turbidityPersen > 9.0);
-      
-      char buffer[512];
-      serializeJson(doc, buffer);
-      mqttClient.publish(MQTT_TOPIC_DATA, buffer, false); 
-    }
+  // Kontrol jalan duluan; koneksi WiFi/MQTT dikelola ManajerKoneksi di task jaringan
+  xTaskCreatePinnedToCore(taskKontrol, "kontrol", STACK_KONTROL, NULL, PRIORITAS_KONTROL, &taskKontrolHandle, KONTROL_CORE);
+  xTaskCreatePinnedToCore(taskJaringan, "jaringan", STACK_JARINGAN, NULL, PRIORITAS_JARINGAN, &taskJaringanHandle, JARINGAN_CORE);
+  xTaskCreatePinnedToCore(taskSuhu, "suhu", STACK_SUHU, NULL, PRIORITAS_SUHU, &taskSuhuHandle, JARINGAN_CORE);
+  
+  LOG_I("\n=== SISTEM SIAP: RISET KENDALI HYBRID ===");
+}
 
-    // 6. Debug Lengkap di Serial Monitor 
-    unsigned long s = now / 1000;      // Total detik
-    unsigned long m = s / 60;          // Total menit
-    unsigned long h = m / 60;          // Total jam
-
-    Serial.println("\n-------------------------------------------------------------");
-    Serial.printf("[%02lu:%02lu:%02lu] [SYSTEM] Mode: %s | WiFi: %s (%d dBm)\n", 
-      (h % 24), (m % 60), (s % 60), 
-      (kontrolAktif == FUZZY) ? "FUZZY" : "PID (ADAPTIVE)", 
-      WiFi.status() == WL_CONNECTED ? "ONLINE" : "OFFLINE", 
-      WiFi.RSSI()
-    );
-    
-    Serial.printf("[TURBIDITY] Current: %.2f%% (Set: %.1f%%) | Error: %.2f\n", 
-      turbidityPersen, turbiditySetpoint, errorKeruh
-    );
-    Serial.printf("            ADC Val: %d | Calib: [Jernih:%d - Keruh:%d]\n", 
-      turbidityADC, NILAI_ADC_JERNIH, NILAI_ADC_KERUH
-    );
-    Serial.printf("            Output : %.1f%% (PWM: %d) | Feedforward: %s\n", 
-      outKeruh, pwmKeruh, 
-      (abs(errorKeruh) < 3.0 && turbidityPersen > 9.0) ? "ON" : "OFF"
-    );
-
-    Serial.printf("[TEMP]      Current: %.2f°C (Set: %.1f°C) | Error: %.2f\n", 
-      suhuAktual, suhuSetpoint, errorSuhu
-    );
-    Serial.printf("            Output : %.1f%% (PWM: %d)\n", outSuhu, pwmSuhu);
-    Serial.println("-------------------------------------------------------------");
-  }
-}
\ No newline at end of file
+void loop() {
+  // Semua kerja ada di taskKontrol, taskJaringan & taskSuhu
+  vTaskDelete(NULL);
+}
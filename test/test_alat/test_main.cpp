@@ -0,0 +1,264 @@
+/**
+ * UJI PROFILER, PUTAR ULANG & PENJADWAL (native, Unity)
+ * * Deskripsi:
+ * Dijalankan dengan `pio test -e native`; gagal satu assert = run gagal.
+ * - Profiler: histogram & persentil pada durasi yang diketahui, dan tick
+ *   penuh berprofil harus mencatat tepat satu sampel per tahap per tick;
+ *   laporan memori memuat sisa stack semua task (termasuk task suhu).
+ * - Putar ulang data riset: jejak simulator ditulis sebagai CSV ekspor backend
+ *   & JSONL mongoexport (dua sesi + celah + baris rusak). Kedua format harus
+ *   menghasilkan metrik identik, parameter yang sama mereproduksi output
+ *   heater terekam, hasil multi-thread sama persis dengan satu thread.
+ * - Penjadwal multi-rate dijalankan 60 detik simulasi di SimTimer 1 ms:
+ *   jumlah eksekusi tiap loop harus tepat & jitter 0 (jam simulasi).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "HalNative.h"
+#include "KolamKerja.h"
+#include "Kontrol.h"
+#include "Penjadwal.h"
+#include "Profil.h"
+#include "Replay.h"
+#include "Simulasi.h"
+#include "Sensor.h"
+#include "Tick.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Durasi 1..1000 tick: bucket b (panjang bit) -> p50 = 511, p99 = maks (bucket 10 dibatasi maks)
+static void test_profil_statistik() {
+  StatTahap s;
+  s.reset();
+  for (uint32_t d = 1; d <= 1000; d++) s.catat(d);
+  uint32_t isiHist = 0;
+  for (int b = 0; b < PROFIL_BUCKET; b++) isiHist += s.histogram[b];
+  TEST_ASSERT_EQUAL_UINT32(1000, s.jumlah);
+  TEST_ASSERT_TRUE(s.min == 1 && s.maks == 1000 && s.total == 500500);
+  TEST_ASSERT_EQUAL_UINT32(1000, isiHist);
+  TEST_ASSERT_TRUE(s.histogram[1] == 1 && s.histogram[10] == 1000 - 511);
+  TEST_ASSERT_EQUAL_UINT32(511, s.persentil(0.5f));
+  TEST_ASSERT_EQUAL_UINT32(1000, s.persentil(0.99f));
+  TEST_ASSERT_EQUAL_UINT32(1, s.persentil(0.0f));
+  s.catat(0xFFFFFFFFu);   // di luar rentang -> bucket terakhir
+  TEST_ASSERT_EQUAL_UINT32(1, s.histogram[PROFIL_BUCKET - 1]);
+}
+
+// Tick penuh berprofil: satu sampel per tahap per tick; snapshot core 1 + tahap core 0 -> JSON
+static void test_profil_tick_penuh() {
+  static Profil prof;
+  SimClock clock;
+  NativeAdc adc;
+  NativeSuhu suhu;
+  NativePwm pwm;
+  NativeMqtt mqtt;
+  Hal hal = {&clock, &adc, &suhu, &pwm, &mqtt, &prof};
+  SensorAquarium sensor;
+  sensor.turbidity.mulai(adc, TURBIDITY_JENDELA, TURBIDITY_SPS);
+  sensor.suhu.mulai(suhu, SUHU_RESOLUSI);
+  ParameterKontrol p;
+  StateKontrol st;
+  resetPID(st, clock.millis());
+  Telemetri t;
+  prof.reset();
+  const int N = 2000;
+  for (int i = 0; i < N; i++) {
+    clock.maju(1000);
+    suhu.suhu = p.suhuSetpoint - 0.5f * (float)((i % 7) - 3);
+    adc.konversi(p.NILAI_ADC_KERUH);
+    {
+      PROFIL_LINGKUP(hal, PROFIL_SAMPEL);
+      sensor.turbidity.layani(adc);
+      while (!sensor.suhu.layani(suhu, clock.millis())) {}
+    }
+    p.kontrolAktif = (i & 1) ? PID : FUZZY;
+    tickKontrol(hal, sensor, p, st, t);
+    kirimTelemetri(hal, "uji", t);
+  }
+  // Aktuator dua kali per tick (heater + pompa)
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++) {
+    const StatTahap &a = prof.tahap[i];
+    uint32_t harap = (i == PROFIL_PERINTAH || !PROFIL_AKTIF) ? 0 : (i == PROFIL_AKTUATOR) ? 2 * N : N;
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(harap, a.jumlah, NAMA_TAHAP_PROFIL[i]);
+  }
+
+  static Profil lap;
+  lap.salinTahap(prof, TAHAP_CORE_KONTROL);
+  prof.resetTahap(TAHAP_CORE_KONTROL);
+  lap.salinTahap(prof, ~TAHAP_CORE_KONTROL);
+  TEST_ASSERT_EQUAL_UINT32(0, prof.tahap[PROFIL_HITUNG_SUHU].jumlah);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)(PROFIL_AKTIF ? N : 0), lap.tahap[PROFIL_HITUNG_SUHU].jumlah);
+  char buf[768];
+  size_t panjangMaks = 0;
+  for (int i = 0; i < JUMLAH_TAHAP_PROFIL; i++) {
+    size_t n = serializeStatTahap(lap.tahap[i], (TahapProfil)i, 10000, buf, sizeof(buf));
+    TEST_ASSERT_TRUE_MESSAGE(n > 0, NAMA_TAHAP_PROFIL[i]);
+    if (n > panjangMaks) panjangMaks = n;
+  }
+  printf("  JSON per tahap maks %u byte\n", (unsigned)panjangMaks);
+  // Sisa stack semua task (kontrol, jaringan, log, suhu DS18B20) ikut terkirim
+  const MemoriProfil m = {200000, 150000, 1100, 2200, 3300, 4400};
+  TEST_ASSERT_TRUE(serializeMemoriProfil(m, buf, sizeof(buf)) > 0);
+  TEST_ASSERT_EQUAL_STRING("{\"memori\":{\"heap_bebas\":200000,\"heap_min\":150000,\"stack_kontrol\":1100,"
+                           "\"stack_jaringan\":2200,\"stack_log\":3300,\"stack_suhu\":4400}}", buf);
+  TEST_ASSERT_EQUAL_UINT32(0, serializeMemoriProfil(m, buf, 40));
+}
+
+// Jejak simulator sebagai ekspor research_data: CSV /api/export/csv/range & JSONL mongoexport
+struct RekamanRiset {
+  std::string csv, jsonl;
+  int64_t awalMs;
+};
+
+static void rekamRiset(const Telemetri &t, void *ctx) {
+  RekamanRiset &r = *(RekamanRiset *)ctx;
+  const int64_t ms = r.awalMs + (int64_t)t.timestamp_ms;
+  const time_t detik = (time_t)(ms / 1000);
+  struct tm w;
+  gmtime_r(&detik, &w);
+  char tanggal[32], baris[768];
+  strftime(tanggal, sizeof(tanggal), "%Y-%m-%d %H:%M:%S", &w);
+  const char *mode = (t.kontrolAktif == FUZZY) ? "Fuzzy" : "PID";
+  snprintf(baris, sizeof(baris), "\"%s\",\"%s\",%.2f,%.2f,%.3f,%.2f,%.2f,%.2f,%.3f,%.2f\n", tanggal, mode, t.suhu,
+           t.setpointSuhu, t.errorSuhu, t.outSuhu, t.turbidityPersen, t.setpointKeruh, t.errorKeruh, t.outKeruh);
+  r.csv += baris;
+
+  // Dokumen = payload telemetri firmware + _id & timestamp dari backend
+  char dok[512];
+  serializeTelemetri(t, dok, sizeof(dok));
+  tanggal[10] = 'T';
+  snprintf(baris, sizeof(baris), "{\"_id\":{\"$oid\":\"66%022lld\"},\"timestamp\":{\"$date\":\"%s.%03dZ\"},%s\n",
+           (long long)ms, tanggal, (int)(ms % 1000), dok + 1);
+  r.jsonl += baris;
+}
+
+static bool hasilSama(const HasilReplay &a, const HasilReplay &b) {
+  auto sama = [](const MetrikSelisih &x, const MetrikSelisih &y) {
+    return x.jumlah == y.jumlah && x.beda == y.beda && x.totalAbs == y.totalAbs && x.totalKuadrat == y.totalKuadrat &&
+           x.maks == y.maks && x.totalUlang == y.totalUlang;
+  };
+  return a.sampel == b.sampel && a.segmen == b.segmen && a.ditolak == b.ditolak && sama(a.suhu, b.suhu) &&
+         sama(a.keruh, b.keruh);
+}
+
+static HasilReplay putarUlang(const BerkasJejak &b, const OpsiReplay &o, KolamKerja *kolam = nullptr) {
+  std::vector<SegmenJejak> seg = b.indeks();
+  std::vector<HasilReplay> per(seg.size());
+  if (kolam) kolam->paralel(seg.size(), [&](size_t i) { per[i] = putarUlangSegmen(b, seg[i], o); });
+  else
+    for (size_t i = 0; i < seg.size(); i++) per[i] = putarUlangSegmen(b, seg[i], o);
+  HasilReplay h;
+  for (const HasilReplay &x : per) h.gabung(x);
+  return h;
+}
+
+// Sesi 1 Fuzzy, sesi 2 PID (reboot 2 jam kemudian), satu baris rusak di antaranya
+static RekamanRiset r;
+
+static void test_replay_csv_sama_dengan_jsonl() {
+  r.csv = "\xEF\xBB\xBFTimestamp,Control_Mode,Temp_Actual,Temp_Setpoint,Temp_Error,PWM_Heater,Turb_Actual,"
+          "Turb_Setpoint,Turb_Error,PWM_Pump\n";
+  r.awalMs = 1714521600000LL;   // 2024-05-01
+  ParameterKontrol pFuzzy, pPid;
+  pPid.kontrolAktif = PID;
+  OpsiSimulasi opsi;
+  opsi.skalaDurasi = 0.125;
+  opsi.jejak = rekamRiset;
+  opsi.ctxJejak = &r;
+  HasilSimulasi s1 = simulasikan(SKENARIO_STANDAR[5], pFuzzy, ParameterPlant(), opsi);
+  r.csv += "\"2024-05-01 ??\",\"PID\",,,\n";
+  r.jsonl += "{\"timestamp\":{\"$date\":\"2024-05-01T03:00:30Z\"},\"suhu\":null}\n";
+  r.awalMs += (int64_t)(s1.jamSimulasi * 3600.0 * 1000.0) + 2 * 3600 * 1000;
+  opsi.skalaDurasi = 0.25;
+  simulasikan(SKENARIO_STANDAR[0], pPid, ParameterPlant(), opsi);
+
+  BerkasJejak csv, jsonl;
+  TEST_ASSERT_TRUE(csv.bukaMemori(r.csv.data(), r.csv.size()) && csv.format() == JEJAK_CSV);
+  TEST_ASSERT_TRUE(jsonl.bukaMemori(r.jsonl.data(), r.jsonl.size()) && jsonl.format() == JEJAK_JSONL);
+  OpsiReplay o;
+  o.toleransi = 0.1;
+  HasilReplay hc = putarUlang(csv, o), hj = putarUlang(jsonl, o);
+  printf("  CSV %u KB / JSONL %u KB: %llu sampel, %llu segmen, %llu ditolak\n", (unsigned)(r.csv.size() / 1024),
+         (unsigned)(r.jsonl.size() / 1024), (unsigned long long)hc.sampel, (unsigned long long)hc.segmen,
+         (unsigned long long)hc.ditolak);
+  TEST_ASSERT_TRUE(hc.segmen == 2 && hc.ditolak == 1 && hc.kembar == 0);
+  TEST_ASSERT_TRUE_MESSAGE(hasilSama(hc, hj), "metrik CSV != JSONL");
+
+  // Parameter sama: heater terekam terulang (selisih = pembulatan rekaman, error 0.001 C);
+  // pompa hanya mendekati: 3 dari 4 tick keruh firmware tidak terekam (diinterpolasi)
+  printf("  parameter firmware: heater MAE %.4f maks %.4f | pompa MAE %.3f maks %.2f\n", hc.suhu.mae(),
+         hc.suhu.maks, hc.keruh.mae(), hc.keruh.maks);
+  TEST_ASSERT_TRUE(hc.suhu.jumlah == hc.sampel && hc.suhu.beda == 0);
+  TEST_ASSERT_TRUE_MESSAGE(hc.suhu.mae() < 0.01 && hc.keruh.mae() < 0.5, "putar ulang tidak mereproduksi rekaman");
+
+  // Kandidat: Kp suhu 2x -> hanya sesi PID yang berubah; paksa PID -> sesi Fuzzy ikut berubah
+  OpsiReplay k = o;
+  k.param.Kp_suhu *= 2.0f;
+  HasilReplay hk = putarUlang(jsonl, k);
+  k.paksaMode = true;
+  k.mode = PID;
+  HasilReplay hp = putarUlang(jsonl, k);
+  TEST_ASSERT_TRUE(hk.suhu.beda > 0 && hp.suhu.beda > hk.suhu.beda && hk.suhu.mae() > hc.suhu.mae());
+}
+
+// Banyak salinan jejak = banyak segmen: 1 thread vs KolamKerja
+static void test_replay_multi_thread_identik() {
+  BerkasJejak jsonl;
+  TEST_ASSERT_TRUE(jsonl.bukaMemori(r.jsonl.data(), r.jsonl.size()));
+  OpsiReplay o;
+  o.toleransi = 0.1;
+  const HasilReplay hj = putarUlang(jsonl, o);
+  std::string besar;
+  for (int i = 0; i < 16; i++) besar += r.jsonl;
+  BerkasJejak b;
+  b.bukaMemori(besar.data(), besar.size());
+  const int jumlahThread = (int)std::thread::hardware_concurrency();
+  KolamKerja kolam(jumlahThread > 1 ? jumlahThread : 2);
+  HasilReplay h1 = putarUlang(b, o);
+  HasilReplay hN = putarUlang(b, o, &kolam);
+  TEST_ASSERT_TRUE_MESSAGE(hasilSama(h1, hN), "hasil KolamKerja beda dari satu thread");
+  TEST_ASSERT_TRUE(h1.segmen == 32 && h1.sampel == 16 * hj.sampel);
+}
+
+static unsigned long jumlahLoop[3];
+
+static void test_penjadwal_tepat() {
+  SimClock jam;
+  SimTimer timer(jam);
+  Penjadwal<3> jadwal;
+  jadwal.tambah("cepat", 2000, 0, [] { jumlahLoop[0]++; });
+  jadwal.tambah("sedang", 250000, 1000, [] { jumlahLoop[1]++; });
+  jadwal.tambah("lambat", 1000000, 3000, [] { jumlahLoop[2]++; });
+  timer.mulai(1000);
+  jadwal.mulai((uint32_t)jam.micros());
+  for (int k = 0; k < 60000; k++) {   // 60 s tick 1 ms
+    jadwal.jalankan(jam);
+    timer.tunggu();
+  }
+  const unsigned long harap[3] = {30000, 240, 60};
+  for (int i = 0; i < 3; i++) {
+    const StatistikLoop &st = jadwal.statistik(i);
+    printf("  Penjadwal %-7s: %lu jalan (harap %lu), jitter [%ld, %ld] us, overrun %lu\n", st.nama, jumlahLoop[i],
+           harap[i], (long)st.jitterMinUs, (long)st.jitterMaxUs, (unsigned long)st.overrun);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(harap[i], jumlahLoop[i], st.nama);
+    TEST_ASSERT_TRUE_MESSAGE(st.jitterMinUs == 0 && st.jitterMaxUs == 0, st.nama);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, st.overrun, st.nama);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_profil_statistik);
+  RUN_TEST(test_profil_tick_penuh);
+  RUN_TEST(test_replay_csv_sama_dengan_jsonl);
+  RUN_TEST(test_replay_multi_thread_identik);
+  RUN_TEST(test_penjadwal_tepat);
+  return UNITY_END();
+}
@@ -0,0 +1,659 @@
+/**
+ * UJI JALUR JARINGAN (native, Unity)
+ * * Deskripsi:
+ * Dijalankan dengan `pio test -e native`; gagal satu assert = run gagal.
+ * - Kebijakan kirim: jejak simulator tiap 250 ms disaring deadband/heartbeat.
+ *   Sesudah ganti setpoint semua sampel harus terkirim (resolusi penuh),
+ *   selang antar kiriman <= heartbeat, dan galat sample-and-hold sampel
+ *   yang ditekan (di luar transien) <= deadband.
+ * - Latensi: SimClock dengan epoch pengganti SNTP; umur stempel sampel/hitung/
+ *   aktuasi di JSON telemetri harus tepat, gema perintah ber-id_perintah
+ *   (diterima & ditolak) membawa waktu terima/terap/aktuasi, header biner v3
+ *   membawa epoch kirim, JSON terpanjang muat di buffer kirimTelemetri.
+ * - Store-and-forward: putus 2 jam + reboot di tengah, lalu putus 12 jam
+ *   (flash penuh). Semua record harus tiba tepat sekali & urut, kecuali
+ *   yang memang hilang (isi RAM saat reboot, segmen tertua yang dibuang).
+ *   Flash gagal sesudah spill sebagian tidak boleh membuang record RAM.
+ * - Manajer koneksi (AP & broker pengganti, jam simulasi): cache BSSID/kanal
+ *   & IP statis mempercepat boot, broker mati dicoba ulang dengan backoff
+ *   (bukan tiap tick), AP hilang pulih sendiri, jitter menyebar perangkat.
+ * - Perangkat virtual: topik <prefix>/<id>/<nama> & validasi id, TangkiVirtual
+ *   yang dimajukan dalam langkah acak harus identik dengan sekali lompat,
+ *   broker bawaan (loopback) merutekan wildcard & siaran perintah dengan
+ *   benar, pelanggan macet -> broker membuang & menghitung, publish yang
+ *   melebihi buffer keluar klien ditolak tanpa memblok. Broker yang gagal
+ *   listen = gagal, bukan dilewati.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "HalNative.h"
+#include "KebijakanKirim.h"
+#include "Kontrol.h"
+#include "ManajerKoneksi.h"
+#include "MqttSoket.h"
+#include "PerintahKontrol.h"
+#include "SimpanTerus.h"
+#include "Simulasi.h"
+#include "TelemetriBiner.h"
+#include "Sensor.h"
+#include "Tick.h"
+#include "TopikPerangkat.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void rekamTelemetri(const Telemetri &t, void *ctx) {
+  ((std::vector<Telemetri> *)ctx)->push_back(t);
+}
+
+static void test_kebijakan_kirim() {
+  const PengaturanKirim pk;
+  uint64_t terkirim = 0, total = 0;
+  unsigned long gapMaks = 0;
+  long hilangTransien = 0;
+  float galatSuhu = 0.0f, galatKeruh = 0.0f;
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    std::vector<Telemetri> jejak;
+    OpsiSimulasi opsi;
+    opsi.skalaDurasi = 0.25;
+    opsi.jejak = rekamTelemetri;
+    opsi.ctxJejak = &jejak;
+    opsi.periodeJejakMs = KIRIM_INTERVAL_CEPAT_MS;
+    simulasikan(SKENARIO_STANDAR[s], ParameterKontrol(), ParameterPlant(), opsi);
+
+    KebijakanKirim k;
+    Telemetri acuan = {};
+    unsigned long kejadian = 0;
+    bool adaKejadian = false;
+    for (size_t i = 0; i < jejak.size(); i++) {
+      const Telemetri &t = jejak[i];
+      if (i > 0 && (t.setpointSuhu != jejak[i - 1].setpointSuhu || t.setpointKeruh != jejak[i - 1].setpointKeruh)) {
+        kejadian = t.timestamp_ms;
+        adaKejadian = true;
+      }
+      bool transien = k.transien(t.timestamp_ms, pk);
+      if (k.putuskan(t, pk) != KIRIM_DITEKAN) {
+        if (i > 0) gapMaks = std::max(gapMaks, t.timestamp_ms - acuan.timestamp_ms);
+        acuan = t;
+        terkirim++;
+      } else {
+        if (adaKejadian && t.timestamp_ms - kejadian < pk.tahanTransienMs) hilangTransien++;
+        if (!transien && t.timestamp_ms - acuan.timestamp_ms >= pk.intervalNormalMs) {
+          galatSuhu = std::max(galatSuhu, fabsf(t.suhu - acuan.suhu));
+          galatKeruh = std::max(galatKeruh, fabsf(t.turbidityPersen - acuan.turbidityPersen));
+        }
+      }
+    }
+    total += jejak.size();
+  }
+  TEST_ASSERT_TRUE(total > 0 && terkirim > 0);
+  printf("  Kirim pintar: %llu/%llu sampel terkirim (%.1f%% ditekan, %.1fx lebih sedikit dari 1 Hz), "
+         "transien hilang %ld, selang maks %lu ms, galat tahan suhu %.3f C keruh %.3f %%\n",
+         (unsigned long long)terkirim, (unsigned long long)total, 100.0 * (total - terkirim) / total,
+         (total / 4.0) / terkirim, hilangTransien, gapMaks, galatSuhu, galatKeruh);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, (int)hilangTransien, "sampel transien ditekan");
+  TEST_ASSERT_TRUE_MESSAGE(gapMaks <= pk.heartbeatMs, "selang antar kiriman > heartbeat");
+  TEST_ASSERT_TRUE_MESSAGE(galatSuhu <= pk.deadbandSuhu, "galat tahan suhu > deadband");
+  TEST_ASSERT_TRUE_MESSAGE(galatKeruh <= pk.deadbandKeruh, "galat tahan keruh > deadband");
+}
+
+// Nilai angka sesudah "kunci": di JSON (NaN jika tidak ada / null)
+static double angkaJson(const std::string &dok, const char *kunci) {
+  const std::string pola = std::string("\"") + kunci + "\":";
+  const size_t i = dok.find(pola);
+  if (i == std::string::npos) return NAN;
+  return strncmp(dok.c_str() + i + pola.size(), "null", 4) == 0 ? NAN : atof(dok.c_str() + i + pola.size());
+}
+
+// Jam pengganti SNTP: epoch tetap + jam simulasi
+const uint64_t EPOCH_AWAL_US = 1760000000000000ULL;
+
+struct RigLatensi {
+  SimClock clock;
+  NativeAdc adc;
+  NativeSuhu suhu;
+  NativePwm pwm;
+  NativeMqtt mqtt;
+  Hal hal = {&clock, &adc, &suhu, &pwm, &mqtt};
+  SensorAquarium sensor;
+  ParameterKontrol p;
+  StateKontrol st;
+  Telemetri t = {};
+
+  RigLatensi() {
+    sensor.turbidity.mulai(adc, TURBIDITY_JENDELA, TURBIDITY_SPS);
+    sensor.suhu.mulai(suhu, SUHU_RESOLUSI);
+    resetPID(st, clock.millis());
+  }
+};
+
+// Sampel di T, tick di T + 300 us, kirim di T + 1800 us
+static void test_latensi_umur_stempel() {
+  static RigLatensi r;
+  for (int i = 0; i < 20; i++) {
+    r.clock.epochAwalUs = (i < 19) ? EPOCH_AWAL_US : 0;
+    r.clock.us = (unsigned long long)(i + 1) * 1000000ULL;
+    r.adc.konversi(r.p.NILAI_ADC_KERUH);
+    r.sensor.turbidity.layani(r.adc, (uint32_t)r.clock.micros());
+    while (!r.sensor.suhu.layani(r.suhu, r.clock.millis())) {}
+    r.clock.majuUs(300);
+    tickKontrol(r.hal, r.sensor, r.p, r.st, r.t);
+    r.clock.majuUs(1500);
+    TEST_ASSERT_TRUE(kirimTelemetri(r.hal, "bench", r.t));
+    const std::string &d = r.mqtt.payloadTerakhir;
+    if (i == 19) {
+      TEST_ASSERT_TRUE_MESSAGE(d.find("\"kirim_ms\":null") != std::string::npos, "kirim_ms tidak null sebelum SNTP");
+      TEST_ASSERT_TRUE(angkaJson(d, "sampel_suhu") == 1800.0);
+      continue;
+    }
+    const double kirimMs = (double)(EPOCH_AWAL_US + r.clock.us) / 1000.0;
+    TEST_ASSERT_TRUE_MESSAGE(fabs(angkaJson(d, "kirim_ms") - kirimMs) < 0.0015, "kirim_ms bukan jam pengganti SNTP");
+    TEST_ASSERT_TRUE(angkaJson(d, "sampel_suhu") == 1800.0 && angkaJson(d, "sampel_keruh") == 1800.0);
+    TEST_ASSERT_TRUE(angkaJson(d, "hitung_suhu") == 1500.0 && angkaJson(d, "aktuasi_keruh") == 1500.0);
+  }
+}
+
+// Perintah ber-id: diterima -> gema lengkap; ditolak -> gema ok:false (id terbaca lebih dulu)
+static void test_latensi_gema_perintah() {
+  static RigLatensi r;
+  r.clock.epochAwalUs = EPOCH_AWAL_US;
+  r.clock.us = 1000000ULL;
+  r.adc.konversi(r.p.NILAI_ADC_KERUH);
+  r.sensor.turbidity.layani(r.adc, (uint32_t)r.clock.micros());
+  while (!r.sensor.suhu.layani(r.suhu, r.clock.millis())) {}
+  tickKontrol(r.hal, r.sensor, r.p, r.st, r.t);
+
+  static KonfigurasiKontrol konf = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  PengaturanTelemetri pt;
+  const char *terima = "{\"id_perintah\":42,\"kp_suhu\":9}";
+  const char *tolak = "{\"id_perintah\":43,\"kp_suhu\":-1}";
+  const char *idSalah = "{\"id_perintah\":0}";
+  const HasilPerintah h1 = parsePerintah(terima, strlen(terima), konf, pt);
+  TEST_ASSERT_TRUE(h1.ok && h1.id == 42);
+  TEST_ASSERT_TRUE(konf.idPerintah == 42 && konf.nomorPerintah == 1);
+  static KonfigurasiKontrol salinan;
+  salinan = konf;
+  const HasilPerintah h2 = parsePerintah(tolak, strlen(tolak), salinan, pt);
+  TEST_ASSERT_TRUE(!h2.ok && h2.id == 43);
+  salinan = konf;
+  TEST_ASSERT_FALSE(parsePerintah(idSalah, strlen(idSalah), salinan, pt).ok);
+
+  const uint32_t terimaUs = (uint32_t)r.clock.micros();
+  PelacakPerintah lacak;
+  lacak.mulai(h1.id, terimaUs, terimaUs + 200);
+  r.clock.majuUs(200);
+  TEST_ASSERT_FALSE(lacak.catat(r.t.stempelSuhu, r.t.stempelKeruh));   // stempel lama (sebelum terap)
+  r.clock.majuUs(700);
+  tickKeruh(r.hal, r.sensor, r.p, r.st, r.t);
+  TEST_ASSERT_FALSE(lacak.catat(r.t.stempelSuhu, r.t.stempelKeruh));
+  r.clock.majuUs(1000);
+  tickSuhu(r.hal, r.sensor, r.p, r.st, r.t);
+  TEST_ASSERT_TRUE(lacak.catat(r.t.stempelSuhu, r.t.stempelKeruh) && !lacak.menunggu);
+  char buf[256];
+  const TitikWaktu w = TitikWaktu::sekarang(r.clock);
+  const std::string gema(buf, serializeGemaPerintah(lacak.g, w, buf, sizeof(buf)));
+  const double terimaMs = (double)(EPOCH_AWAL_US + terimaUs) / 1000.0;
+  printf("  gema: terap %.0f us, aktuasi keruh %.0f / suhu %.0f us\n", angkaJson(gema, "terap_us"),
+         angkaJson(gema, "aktuasi_keruh_us"), angkaJson(gema, "aktuasi_suhu_us"));
+  TEST_ASSERT_TRUE(angkaJson(gema, "id") == 42.0 && gema.find("\"ok\":true") != std::string::npos);
+  TEST_ASSERT_TRUE(fabs(angkaJson(gema, "terima_ms") - terimaMs) < 0.0015);
+  TEST_ASSERT_TRUE(angkaJson(gema, "terap_us") == 200.0);
+  TEST_ASSERT_TRUE(angkaJson(gema, "aktuasi_keruh_us") == 900.0 && angkaJson(gema, "aktuasi_suhu_us") == 1900.0);
+  const std::string gemaTolak(buf, serializeGemaPerintah(gemaDitolak(h2, terimaUs), w, buf, sizeof(buf)));
+  TEST_ASSERT_TRUE(gemaTolak.find("\"ok\":false,\"kunci\":\"kp_suhu\"") != std::string::npos);
+  TEST_ASSERT_TRUE(isnan(angkaJson(gemaTolak, "terap_us")));
+}
+
+// Batch biner v3: millis & epoch kirim di header; JSON terpanjang muat di buffer kirimTelemetri
+static void test_latensi_biner_dan_json_terpanjang() {
+  static RigLatensi r;
+  r.clock.epochAwalUs = EPOCH_AWAL_US;
+  r.clock.us = 5000000ULL;
+  static BatchTelemetri batch;
+  batch.reset();
+  batch.tambah(r.t, r.clock.millis());
+  kirimBatchTelemetri(r.hal, "bench", batch);
+  const uint8_t *b = (const uint8_t *)r.mqtt.payloadTerakhir.data();
+  TEST_ASSERT_EQUAL_INT(TELEMETRI_BINER_HEADER + TELEMETRI_BINER_RECORD, (int)r.mqtt.payloadTerakhir.size());
+  uint64_t epochMs = 0;
+  for (int i = 7; i >= 0; i--) epochMs = (epochMs << 8) | b[12 + i];
+  const uint32_t tKirim = (uint32_t)b[8] | ((uint32_t)b[9] << 8) | ((uint32_t)b[10] << 16) | ((uint32_t)b[11] << 24);
+  TEST_ASSERT_EQUAL_INT(3, b[2]);
+  TEST_ASSERT_TRUE_MESSAGE(epochMs == (EPOCH_AWAL_US + r.clock.us) / 1000, "epoch kirim di header biner salah");
+  TEST_ASSERT_TRUE(tKirim == r.clock.millis());
+
+  Telemetri besar = {};
+  besar.timestamp_ms = 4000000000UL;
+  besar.suhu = besar.setpointSuhu = besar.errorSuhu = besar.errorKeruh = -127.0f;
+  besar.outSuhu = besar.outKeruh = 100.0;
+  besar.bayangan = true;
+  besar.bayanganSuhu = besar.bayanganKeruh = {100.0f, 100.0f, 999.99f, 999.99f};
+  besar.lewatAnggaranBayangan = 4000000000u;
+  besar.stempelSuhu = besar.stempelKeruh = {1, 1, 1};
+  const TitikWaktu wBesar = {0, 4102444800000000ULL};   // 2100-01-01, umur ~2^32 us
+  char dok[768];
+  const size_t panjang = serializeTelemetri(besar, dok, sizeof(dok), &wBesar);
+  printf("  JSON telemetri terpanjang %zu / %zu byte\n", panjang, sizeof(dok));
+  TEST_ASSERT_TRUE_MESSAGE(panjang > 0, "JSON telemetri terpanjang tidak muat di buffer kirimTelemetri");
+}
+
+// Penerima batch di sisi "backend": catat id (timestamp_ms) record yang tiba
+struct PenerimaSimpan {
+  std::vector<uint32_t> id;
+  unsigned long batchUlang = 0, batchSesiLama = 0;
+  void terima(const std::string &payload) {
+    const uint8_t *p = (const uint8_t *)payload.data();
+    if (payload.size() < TELEMETRI_BINER_HEADER || p[0] != 'A' || p[1] != 'Q') return;
+    if (p[5] & BATCH_PUTAR_ULANG) batchUlang++;
+    if (p[5] & BATCH_SESI_LAMA) batchSesiLama++;
+    for (int i = 0; i < p[3]; i++) {
+      Telemetri t;
+      dekodekanRecordTelemetri(p + TELEMETRI_BINER_HEADER + (size_t)i * p[4], t);
+      id.push_back((uint32_t)t.timestamp_ms);
+    }
+  }
+};
+
+// Satu sampel per detik; offline -> simpan, online -> live + putar ulang 20/detik
+static void jalankanSimpan(SimpanTerus &sf, Hal &hal, NativeMqtt &mqtt, PenerimaSimpan &rx,
+                           uint32_t &id, unsigned long detik, bool online) {
+  mqtt.online = online;
+  for (unsigned long k = 0; k < detik; k++) {
+    Telemetri t = {};
+    t.timestamp_ms = id++;
+    if (online) rx.id.push_back((uint32_t)t.timestamp_ms);
+    else sf.simpan(t);
+    sf.putarUlang(hal, "batch", 20);
+  }
+}
+
+// id harus naik ketat (tidak ganda, tidak tertukar) untuk record putar ulang
+static bool urutNaik(const std::vector<uint32_t> &v) {
+  for (size_t i = 1; i < v.size(); i++)
+    if (v[i] <= v[i - 1]) return false;
+  return true;
+}
+
+static std::vector<uint32_t> dalamRentang(const std::vector<uint32_t> &v, uint32_t awal, uint32_t akhir) {
+  std::vector<uint32_t> hasil;
+  for (uint32_t x : v) if (x >= awal && x < akhir) hasil.push_back(x);
+  return hasil;
+}
+
+struct RigSimpan {
+  SimClock jam;
+  NativeMqtt mqtt;
+  NativeBerkas flash;
+  Hal hal = {&jam, nullptr, nullptr, nullptr, &mqtt};
+  PenerimaSimpan rx;
+  uint32_t id = 0;
+
+  RigSimpan() { mqtt.pendengar = [this](const std::string &, const std::string &payload) { rx.terima(payload); }; }
+};
+
+// 10 menit online, putus 1 jam, reboot (RAM hilang), putus 1 jam lagi, online;
+// lalu putus 12 jam (> kapasitas SIMPAN_SEGMEN_MAKS segmen) dan online sampai habis
+static void test_simpan_putus_reboot_dan_flash_penuh() {
+  static RigSimpan r;
+  static SimpanTerus sf;
+  sf.mulai(&r.flash);
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 600, true);
+  uint32_t awalPutus = r.id;
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 3600, false);
+  const uint32_t hilangReboot = sf.tertunda() - sf.tertundaFlash();
+  sf.mulai(&r.flash);   // reboot: objek sama, RAM dianggap hilang
+  sf.stat = StatistikSimpan();
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 3600, false);
+  uint32_t akhirPutus = r.id;
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 1200, true);
+  std::vector<uint32_t> ulang = dalamRentang(r.rx.id, awalPutus, akhirPutus);
+  printf("  Simpan A (2 jam putus + reboot): %lu/%lu record diputar ulang, hilang saat reboot %lu, "
+         "batch sesi lama %lu, tulis flash %lu\n", (unsigned long)ulang.size(), (unsigned long)(akhirPutus - awalPutus),
+         (unsigned long)hilangReboot, r.rx.batchSesiLama, r.flash.jumlahTulis);
+  TEST_ASSERT_EQUAL_UINT32(0, sf.tertunda());
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE((akhirPutus - awalPutus) - hilangReboot, ulang.size(), "record putar ulang hilang");
+  TEST_ASSERT_TRUE_MESSAGE(urutNaik(ulang), "record putar ulang ganda / tertukar");
+  TEST_ASSERT_TRUE(r.rx.batchSesiLama > 0);
+  TEST_ASSERT_EQUAL_UINT32(0, sf.stat.dibuang);
+
+  r.rx.id.clear();
+  awalPutus = r.id;
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 12 * 3600, false);
+  akhirPutus = r.id;
+  const size_t flashMaks = r.flash.totalByte();
+  while (sf.tertunda() > 0) jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 60, true);
+  ulang = dalamRentang(r.rx.id, awalPutus, akhirPutus);
+  const StatistikSimpan &s = sf.stat;
+  printf("  Simpan B (12 jam putus)        : %lu diputar ulang, %lu dibuang (tertua), flash puncak %lu KB\n",
+         (unsigned long)ulang.size(), (unsigned long)s.dibuang, (unsigned long)(flashMaks / 1024));
+  TEST_ASSERT_TRUE(s.dibuang > 0);
+  TEST_ASSERT_EQUAL_UINT32(akhirPutus - awalPutus, ulang.size() + s.dibuang);
+  // Yang dibuang harus yang tertua: yang tiba = ekor rentang putus, berurutan
+  TEST_ASSERT_FALSE(ulang.empty());
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(akhirPutus - 1, ulang.back(), "record terbaru tidak tiba");
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(awalPutus + s.dibuang, ulang.front(), "yang dibuang bukan yang tertua");
+  TEST_ASSERT_TRUE(urutNaik(ulang));
+  TEST_ASSERT_TRUE(flashMaks <= (size_t)SIMPAN_SEGMEN_MAKS * SIMPAN_SEGMEN_RECORD * SIMPAN_RECORD_FLASH);
+}
+
+// Flash gagal tulis -> RAM saja, tertua dibuang & dihitung
+static void test_simpan_flash_gagal() {
+  static RigSimpan r;
+  NativeBerkas rusak;
+  rusak.gagalTulis = true;
+  static SimpanTerus sf;
+  sf.mulai(&rusak);
+  const uint32_t awalPutus = r.id;
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 600, false);
+  const uint32_t akhirPutus = r.id;
+  while (sf.tertunda() > 0) jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 10, true);
+  const std::vector<uint32_t> ulang = dalamRentang(r.rx.id, awalPutus, akhirPutus);
+  printf("  Simpan C (flash gagal)         : %lu diputar ulang, %lu dibuang\n", (unsigned long)ulang.size(),
+         (unsigned long)sf.stat.dibuang);
+  TEST_ASSERT_EQUAL_UINT32(SIMPAN_RAM_RECORD, ulang.size());
+  TEST_ASSERT_EQUAL_UINT32(600 - SIMPAN_RAM_RECORD, sf.stat.dibuang);
+  TEST_ASSERT_TRUE(urutNaik(ulang));
+  TEST_ASSERT_EQUAL_UINT32(akhirPutus - 1, ulang.back());
+}
+
+// Spill sebagian: ring penuh membungkus (kepala != 0), potongan pertama masuk flash,
+// potongan kedua gagal (flash penuh). Ring sudah punya ruang -> tidak ada yang dibuang lagi
+static void test_simpan_spill_sebagian() {
+  static RigSimpan r;
+  static SimpanTerus sf;
+  r.flash.gagalTulis = true;
+  sf.mulai(&r.flash);
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, SIMPAN_RAM_RECORD + 1, false);   // id 0 dibuang, kepala = 1
+  TEST_ASSERT_EQUAL_UINT32(1, sf.stat.dibuang);
+  r.flash.gagalTulis = false;
+  r.flash.kapasitasByte = r.flash.totalByte() + (SIMPAN_RAM_RECORD - 1) * SIMPAN_RECORD_FLASH;
+  jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 1, false);
+  printf("  Simpan D (spill sebagian)      : %lu di flash, %lu di RAM, %lu dibuang\n",
+         (unsigned long)sf.tertundaFlash(), (unsigned long)(sf.tertunda() - sf.tertundaFlash()),
+         (unsigned long)sf.stat.dibuang);
+  TEST_ASSERT_EQUAL_UINT32(SIMPAN_RAM_RECORD - 1, sf.tertundaFlash());
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, sf.stat.dibuang, "record RAM dibuang padahal spill sebagian memberi ruang");
+
+  const uint32_t akhir = r.id;
+  r.flash.kapasitasByte = 1536 * 1024;
+  while (sf.tertunda() > 0) jalankanSimpan(sf, r.hal, r.mqtt, r.rx, r.id, 10, true);
+  const std::vector<uint32_t> ulang = dalamRentang(r.rx.id, 1, akhir);
+  TEST_ASSERT_EQUAL_UINT32(akhir - 1, ulang.size());
+  TEST_ASSERT_TRUE(urutNaik(ulang));
+}
+
+// Jalankan manajer koneksi di tick task jaringan (10 ms) selama ms; catat waktu tiap CONNECT
+static void jalankanKoneksi(ManajerKoneksi &k, SimClock &jam, NativeMqtt &mqtt, unsigned long ms,
+                            std::vector<unsigned long> *percobaan = nullptr) {
+  for (unsigned long t = 0; t < ms; t += 10) {
+    unsigned long sebelum = mqtt.jumlahSambung;
+    k.layani();
+    if (percobaan && mqtt.jumlahSambung != sebelum) percobaan->push_back(jam.millis());
+    jam.maju(10);
+  }
+}
+
+static const JaringanWifi JARINGAN_UJI[] = {{"Private u52", "12345678"}, {"iPhone 2", "bobo2002"}};
+
+static PengaturanKoneksi pengaturanKoneksiUji() {
+  PengaturanKoneksi pk;
+  pk.jaringan = JARINGAN_UJI;
+  pk.jumlahJaringan = 2;
+  pk.clientId = "esp32-research-aquarium";
+  return pk;
+}
+
+// Manajer koneksi vs AP & broker pengganti (jam simulasi), satu perangkat berurutan:
+// boot tanpa/dengan cache, IP statis, broker mati 10 menit, AP hilang 20 s
+static void test_koneksi_boot_broker_ap() {
+  const PengaturanKoneksi pk = pengaturanKoneksiUji();
+  NativeBerkas flash;
+
+  // 1. Boot pertama: jaringan 0 tidak ada, jaringan 1 ada -> scan penuh, cache ditulis
+  SimClock jam;
+  NativeWifi wifi(jam);
+  NativeMqtt mqtt;
+  mqtt.online = false;
+  wifi.ap.push_back({"iPhone 2", "bobo2002", {2, 0, 0, 0, 0, 7}, 6, true});
+  ManajerKoneksi k;
+  k.mulai(jam, wifi, mqtt, &flash, pk, 1);
+  jalankanKoneksi(k, jam, mqtt, 20000);
+  const uint32_t bootDingin = k.stat.msBootTerhubung;
+  TEST_ASSERT_TRUE(k.mqttTerhubung());
+  TEST_ASSERT_EQUAL_STRING("iPhone 2", k.ssidAktif());
+  TEST_ASSERT_TRUE_MESSAGE(flash.ukuran("/wifi.bin") > 0, "cache wifi tidak ditulis");
+
+  // 2. Reboot: BSSID & kanal dari cache (tanpa scan), lalu IP statis
+  ManajerKoneksi k2;
+  mqtt.online = false;
+  wifi.putus();
+  k2.mulai(jam, wifi, mqtt, &flash, pk, 2);
+  jalankanKoneksi(k2, jam, mqtt, 20000);
+  const uint32_t bootCache = k2.stat.msBootTerhubung;
+  TEST_ASSERT_TRUE(k2.mqttTerhubung());
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, k2.stat.cacheKena, "cache BSSID/kanal tidak dipakai");
+  TEST_ASSERT_EQUAL_INT(1, (int)wifi.jumlahCepat);
+  PengaturanKoneksi pkStatis = pk;
+  pkStatis.ip = {true, {192, 168, 1, 50}, {192, 168, 1, 1}, {255, 255, 255, 0}, {8, 8, 8, 8}};
+  ManajerKoneksi k3;
+  mqtt.online = false;
+  wifi.putus();
+  k3.mulai(jam, wifi, mqtt, &flash, pkStatis, 3);
+  jalankanKoneksi(k3, jam, mqtt, 20000);
+  const uint32_t bootStatis = k3.stat.msBootTerhubung;
+  printf("  Koneksi boot     : tanpa cache %lu ms, cache BSSID/kanal %lu ms, + IP statis %lu ms\n",
+         (unsigned long)bootDingin, (unsigned long)bootCache, (unsigned long)bootStatis);
+  TEST_ASSERT_TRUE(k3.mqttTerhubung());
+  TEST_ASSERT_TRUE_MESSAGE(bootStatis < bootCache && bootCache < bootDingin, "cache / IP statis tidak mempercepat boot");
+
+  // 3. Broker mati 10 menit: CONNECT hanya tiap backoff (naik s.d. maks), lalu pulih <= backoff maks
+  std::vector<unsigned long> percobaan;
+  mqtt.online = false;
+  mqtt.brokerHidup = false;
+  const unsigned long mati = jam.millis();
+  jalankanKoneksi(k3, jam, mqtt, 600000, &percobaan);
+  const unsigned long hidup = jam.millis();
+  mqtt.brokerHidup = true;
+  jalankanKoneksi(k3, jam, mqtt, pk.backoffMaksMs + 1000, &percobaan);
+  TEST_ASSERT_FALSE_MESSAGE(percobaan.empty(), "tidak ada CONNECT selama broker mati");
+  unsigned long selangMaks = 0;
+  for (size_t i = 1; i < percobaan.size(); i++) selangMaks = std::max(selangMaks, percobaan[i] - percobaan[i - 1]);
+  const unsigned long pulih = percobaan.back() - hidup;
+  printf("  Broker mati 10 mnt: %zu CONNECT (lama: %lu, tiap tick 10 ms), selang maks %lu ms, pulih %lu ms "
+         "setelah broker hidup\n", percobaan.size(), 600000ul / 10, selangMaks, pulih);
+  TEST_ASSERT_TRUE(k3.mqttTerhubung());
+  TEST_ASSERT_TRUE_MESSAGE(percobaan.size() < 40, "CONNECT ke broker mati tidak memakai backoff");
+  TEST_ASSERT_TRUE_MESSAGE(selangMaks <= pk.backoffMaksMs + 10, "selang CONNECT > backoff maks");
+  TEST_ASSERT_TRUE_MESSAGE(pulih <= pk.backoffMaksMs + 10, "pulih setelah broker hidup > backoff maks");
+  TEST_ASSERT_TRUE(k3.stat.msSambungTerakhir == percobaan.back() - mati);
+
+  // 4. AP hilang 20 s: deteksi, jalur cepat gagal, scan penuh dengan backoff, kembali ke AP yang sama
+  wifi.ap[0].hidup = false;
+  jalankanKoneksi(k3, jam, mqtt, 20000);
+  wifi.ap[0].hidup = true;
+  jalankanKoneksi(k3, jam, mqtt, 30000);
+  printf("  AP hilang 20 s   : putus %lu, gagal asosiasi %lu, terhubung lagi setelah %lu ms\n",
+         (unsigned long)k3.stat.putusWifi, (unsigned long)k3.stat.gagalWifi, (unsigned long)k3.stat.msSambungTerakhir);
+  TEST_ASSERT_TRUE_MESSAGE(k3.mqttTerhubung(), "tidak pulih sesudah AP kembali");
+  TEST_ASSERT_EQUAL_UINT32(1, k3.stat.putusWifi);
+  TEST_ASSERT_TRUE(k3.stat.cacheMeleset >= 1);
+  TEST_ASSERT_TRUE(k3.stat.msSambungTerakhir <= 20000 + pk.backoffMaksMs);
+}
+
+// 32 perangkat putus bersamaan: percobaan ulang pertama tersebar (tidak serempak)
+static void test_koneksi_jitter() {
+  const PengaturanKoneksi pk = pengaturanKoneksiUji();
+  std::vector<unsigned long> pertama;
+  for (uint32_t d = 0; d < 32; d++) {
+    SimClock j;
+    NativeWifi w(j);
+    NativeMqtt m;
+    w.ap.push_back({"iPhone 2", "bobo2002", {2, 0, 0, 0, 0, 7}, 6, true});
+    ManajerKoneksi kd;
+    kd.mulai(j, w, m, nullptr, pk, 0x9E3779B9u * (d + 1));
+    jalankanKoneksi(kd, j, m, 10000);
+    m.online = false;
+    const unsigned long t0 = j.millis();
+    std::vector<unsigned long> coba;
+    jalankanKoneksi(kd, j, m, 2000, &coba);
+    if (!coba.empty()) pertama.push_back(coba[0] - t0);
+  }
+  TEST_ASSERT_EQUAL_INT_MESSAGE(32, (int)pertama.size(), "ada perangkat yang tidak mencoba ulang");
+  std::sort(pertama.begin(), pertama.end());
+  const size_t unik = std::unique(pertama.begin(), pertama.end()) - pertama.begin();
+  printf("  Jitter 32 perangkat: percobaan pertama %lu..%lu ms, %zu waktu berbeda\n", pertama.front(),
+         pertama.back(), unik);
+  TEST_ASSERT_TRUE_MESSAGE(unik >= 16, "percobaan ulang serempak");
+  TEST_ASSERT_TRUE(pertama.front() >= pk.backoffAwalMs / 2);
+  TEST_ASSERT_TRUE(pertama.back() <= pk.backoffAwalMs + 10);
+}
+
+// Topik per perangkat; id kosong / '/' '+' '#' / terlalu panjang ditolak
+static void test_topik_perangkat() {
+  TopikPerangkat tp;
+  const uint8_t mac[6] = {0xa1, 0xb2, 0xc3, 0xd4, 0xe5, 0xf6};
+  char id[ID_PERANGKAT_MAKS];
+  idDariMac(mac, id, sizeof(id));
+  TEST_ASSERT_TRUE(tp.mulai("unhas/informatika/aquarium", id));
+  TEST_ASSERT_EQUAL_STRING("unhas/informatika/aquarium/aq-a1b2c3d4e5f6/data", tp[TOPIK_DATA]);
+  TEST_ASSERT_EQUAL_STRING("unhas/informatika/aquarium/aq-a1b2c3d4e5f6/gema", tp[TOPIK_GEMA]);
+  TEST_ASSERT_EQUAL_STRING("unhas/informatika/aquarium/mode", tp.modeSemua);
+  TEST_ASSERT_EQUAL_STRING(id, tp.clientId());
+  TEST_ASSERT_EQUAL_STRING("unhas/informatika/aquarium/aq-a1b2c3d4e5f6", tp.dasar);
+  for (const char *salah : {"", "a/b", "a+", "#", "id-yang-terlalu-panjang-untuk-buffer-id"})
+    TEST_ASSERT_FALSE_MESSAGE(tp.mulai("unhas/informatika/aquarium", salah), salah);
+}
+
+// TangkiVirtual: dimajukan dalam langkah acak harus sama persis dengan sekali lompat
+static void test_tangki_virtual_langkah_acak() {
+  ParameterKontrol param;
+  ParameterPlant plant;
+  TangkiVirtual lompat, bertahap;
+  lompat.mulai(param, plant, 25.0, 12.0, 24.0, 7, 0);
+  bertahap.mulai(param, plant, 25.0, 12.0, 24.0, 7, 0);
+  const uint64_t akhir = 600ULL * 1000000ULL;
+  lompat.majuKe(akhir);
+  uint32_t acak = 12345;
+  int langkah = 0;
+  for (uint64_t us = 0; us < akhir; langkah++) {
+    acak = acak * 1664525u + 1013904223u;
+    us = std::min(akhir, us + 1 + (acak >> 8) % 2000000);
+    bertahap.majuKe(us);
+  }
+  const Telemetri &a = lompat.telemetri(), &b = bertahap.telemetri();
+  printf("  TangkiVirtual 600 s: %d langkah acak vs sekali lompat (suhu %.3f, pwm %d/%d)\n", langkah,
+         (double)b.suhu, b.pwmSuhu, b.pwmKeruh);
+  TEST_ASSERT_TRUE_MESSAGE(a.suhu == b.suhu && a.turbidityAdc == b.turbidityAdc, "langkah acak != sekali lompat");
+  TEST_ASSERT_TRUE(a.outSuhu == b.outSuhu && a.outKeruh == b.outKeruh);
+  TEST_ASSERT_TRUE(a.pwmSuhu == b.pwmSuhu && a.pwmKeruh == b.pwmKeruh);
+  TEST_ASSERT_TRUE(lompat.us() == bertahap.us());
+  TEST_ASSERT_TRUE(a.suhu > 25.2f && a.pwmSuhu > 0);
+}
+
+#ifdef __linux__
+// Broker bawaan + klien socket sungguhan (loopback): layani semua klien sampai syarat terpenuhi / 3 s
+template <typename F>
+static bool layaniSampai(std::initializer_list<KlienMqtt *> klien, F selesai) {
+  const uint64_t batas = jamMonotonUs() + 3000000;
+  while (!selesai()) {
+    if (jamMonotonUs() > batas) return false;
+    for (KlienMqtt *k : klien) k->layani();
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  return true;
+}
+
+// Broker: wildcard + per perangkat, pesan di luar filter tidak diteruskan
+static void test_broker_rute() {
+  BrokerMqtt broker;
+  if (!broker.mulai("127.0.0.1", 0)) TEST_FAIL_MESSAGE("broker MQTT bawaan gagal listen");
+  KlienMqtt backend, dev1, dev2;
+  for (KlienMqtt *k : {&backend, &dev1, &dev2}) k->setServer("127.0.0.1", broker.port());
+  std::vector<std::string> diterima;
+  backend.pendengar = [&](const char *topik, const uint8_t *, size_t) { diterima.push_back(topik); };
+  bool ok = backend.sambung("backend") && dev1.sambung("aq-1") && dev2.sambung("aq-2") &&
+            backend.subscribe("x/+/data");
+  int perintahDev1 = 0;
+  dev1.pendengar = [&](const char *, const uint8_t *, size_t) { perintahDev1++; };
+  ok = ok && dev1.subscribe("x/aq-1/mode") && dev1.subscribe("x/mode");
+  // SUBACK belum ditunggu: beri waktu broker memproses langganan dulu
+  ok = ok && layaniSampai({&backend, &dev1, &dev2}, [&] { return broker.stat.sambungan == 3; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  dev1.publish("x/aq-1/data", "{\"suhu\":27.1}", false);
+  dev2.publish("x/aq-2/data", "{\"suhu\":26.4}", false);
+  dev2.publish("x/aq-2/gema", "{}", false);
+  backend.publish("x/aq-1/mode", "{}", false);
+  backend.publish("x/aq-2/mode", "{}", false);
+  backend.publish("x/mode", "{}", false);
+  ok = ok && layaniSampai({&backend, &dev1, &dev2}, [&] { return diterima.size() >= 2 && perintahDev1 >= 2; });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (KlienMqtt *k : {&backend, &dev1, &dev2}) k->layani();
+  broker.berhenti();
+  printf("  Broker bawaan: x/+/data -> %lu pesan, perintah aq-1 (per id + siaran) -> %d\n",
+         (unsigned long)diterima.size(), perintahDev1);
+  TEST_ASSERT_TRUE_MESSAGE(ok, "sambung / subscribe / rute lewat broker bawaan tidak selesai");
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, (int)diterima.size(), "x/+/data meneruskan pesan di luar filter");
+  TEST_ASSERT_EQUAL_INT(1, (int)std::count(diterima.begin(), diterima.end(), std::string("x/aq-2/data")));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, perintahDev1, "perintah per id + siaran ke aq-1");
+}
+
+// Backpressure: pelanggan yang tidak membaca -> broker membuang (dihitung), publish klien
+// yang melebihi buffer keluar ditolak tanpa memblok
+static void test_broker_backpressure() {
+  BrokerMqtt sempit;
+  if (!sempit.mulai("127.0.0.1", 0, 64 * 1024)) TEST_FAIL_MESSAGE("broker MQTT bawaan gagal listen");
+  KlienMqtt lambat, cepat(4096);
+  lambat.setServer("127.0.0.1", sempit.port());
+  cepat.setServer("127.0.0.1", sempit.port());
+  bool ok = lambat.sambung("lambat") && lambat.subscribe("#") && cepat.sambung("cepat");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  std::vector<uint8_t> besar(5000, 'x'), sedang(1000, 'y');
+  const bool tolakBesar = !cepat.publish("x/aq-1/data", besar.data(), besar.size(), false) && cepat.stat.ditolak == 1;
+  const uint64_t total = 20000;
+  uint64_t terkirim = 0;
+  const uint64_t batas = jamMonotonUs() + 10000000;
+  while (terkirim < total && jamMonotonUs() < batas) {
+    if (cepat.publish("x/aq-1/data", sedang.data(), sedang.size(), false)) terkirim++;
+    else cepat.layani();
+  }
+  ok = ok && terkirim == total &&
+       layaniSampai({&cepat}, [&] { return !cepat.adaTertunda() && sempit.stat.pesanMasuk == total; });
+  const uint64_t dibuang = sempit.stat.dibuang, keluar = sempit.stat.pesanKeluar;
+  sempit.berhenti();
+  printf("  Backpressure: %lu publish ke pelanggan macet -> %lu diteruskan, %lu dibuang broker\n",
+         (unsigned long)total, (unsigned long)keluar, (unsigned long)dibuang);
+  TEST_ASSERT_TRUE_MESSAGE(ok, "publish ke broker dengan pelanggan macet tidak selesai");
+  TEST_ASSERT_TRUE_MESSAGE(tolakBesar, "publish > buffer keluar klien tidak ditolak");
+  TEST_ASSERT_TRUE_MESSAGE(dibuang > 0, "broker tidak membuang untuk pelanggan macet");
+  TEST_ASSERT_TRUE_MESSAGE(dibuang + keluar == total, "diteruskan + dibuang != masuk");
+}
+#endif
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_kebijakan_kirim);
+  RUN_TEST(test_latensi_umur_stempel);
+  RUN_TEST(test_latensi_gema_perintah);
+  RUN_TEST(test_latensi_biner_dan_json_terpanjang);
+  RUN_TEST(test_simpan_putus_reboot_dan_flash_penuh);
+  RUN_TEST(test_simpan_flash_gagal);
+  RUN_TEST(test_simpan_spill_sebagian);
+  RUN_TEST(test_koneksi_boot_broker_ap);
+  RUN_TEST(test_koneksi_jitter);
+  RUN_TEST(test_topik_perangkat);
+  RUN_TEST(test_tangki_virtual_langkah_acak);
+#ifdef __linux__
+  RUN_TEST(test_broker_rute);
+  RUN_TEST(test_broker_backpressure);
+#endif
+  return UNITY_END();
+}
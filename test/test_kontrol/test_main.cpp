@@ -0,0 +1,723 @@
+/**
+ * UJI KERNEL KONTROL (native, Unity)
+ * * Deskripsi:
+ * Dijalankan dengan `pio test -e native`; gagal satu assert = run gagal.
+ * - LUT fuzzy 32..1024 titik dibanding mesin eksak di 200k titik rapat:
+ *   error maks harus turun monoton saat resolusi naik, dan errorMaks hasil
+ *   bangun() tidak boleh meremehkan error sebenarnya lebih dari 2x;
+ *   NaN / +-inf di-clamp ke batas tabel.
+ * - PID float & Q16.16 diputar ulang pada jejak error loop tertutup dari
+ *   simulator (lib/Simulasi, mode PID) dan dibandingkan dengan referensi
+ *   double: selisih output maks harus < PID_TOLERANSI_* (% output).
+ * - BankKontrol (SoA) harus identik bit-per-bit dengan jalur satu tangki
+ *   per kanal (mode Fuzzy/PID/MPC & mesin campuran, output & duty PWM).
+ *   Topik kanal <prefix>/<id>/<k>/<nama> bolak-balik lewat kanalDariTopik.
+ * - MPC eksplisit: TABEL_MPC harus sama dengan keluaran generator saat ini
+ *   (tabel basi = gagal), output tabel = solusi QP daring, input NaN di-clamp
+ *   ke batas bawah, loop tertutup step_suhu & ruang_dingin harus lebih baik
+ *   dari PID tanpa overshoot berarti.
+ * - Aktuator: kurva bawaan = map() 8 bit lama, dither sigma-delta rata-rata
+ *   tepat, kalibrasi heater & pompa lewat tickSuhu/tickKeruh di simulator
+ *   lebih linear dari kurva bawaan, kurva lewat MQTT + flash kembali utuh.
+ * - Autotune relay: perintah diterima/ditolak, identifikasi Ku/Pu di plant
+ *   simulasi, gain <= AUTOTUNE_GAIN_MAKS, PID suhu hasil SIMC harus lebih
+ *   baik dari gain bawaan tanpa overshoot berarti; mulai jauh dari setpoint
+ *   harus gagal dengan heater 0; histeresis heater >= 2 langkah DS18B20.
+ * - Mode bayangan: output aktif identik dengan mode biasa (Fuzzy & PID),
+ *   biaya Fuzzy + PID per loop p99.9 <= ANGGARAN_BAYANGAN_US dan <= 1 dari
+ *   1000 tick melewatinya (maks host dilaporkan saja); ganti mode dengan
+ *   transfer mulus harus memperkecil loncatan output.
+ * - Parser perintah MQTT: dokumen Control backend lengkap diterima; NaN/null,
+ *   rentang, kalibrasi terbalik, rule base rusak & JSON terpotong ditolak
+ *   tanpa mengubah konfigurasi aktif.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include <unity.h>
+#include "AutotuneRelay.h"
+#include "BankKontrol.h"
+#include "HalNative.h"
+#include "KalibrasiAktuator.h"
+#include "KanalUji.h"
+#include "Kontrol.h"
+#include "MpcEksplisit.h"
+#include "PerintahKontrol.h"
+#include "Simulasi.h"
+#include "Tick.h"
+#include "TopikPerangkat.h"
+
+void setUp() {}
+void tearDown() {}
+
+static std::vector<float> buatInput(int n, float lo, float hi, unsigned seed) {
+  std::vector<float> v(n);
+  srand(seed);
+  for (int i = 0; i < n; i++) v[i] = lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+  return v;
+}
+
+// Error LUT vs mesin eksak pada grid rapat independen (bukan titik uji bangun())
+template <int R>
+static float errorLutRapat(const Fuzzy1 &f, float lo, float hi, FuzzyLut<R> &lut) {
+  float patah[4 * FUZZY_N_HIMPUNAN] = {};
+  lut.bangun([&f](float x) { return f.hitung(x); }, lo, hi, patah, f.titikPatah(0, patah));
+  float e = 0.0f;
+  const int RAPAT = 200000;
+  for (int i = 0; i <= RAPAT; i++) {
+    const float x = (lo - 1.0f) + (hi - lo + 2.0f) * (float)i / (float)RAPAT;
+    e = fmaxf(e, fabsf(lut.hitung(x) - f.hitung(x)));
+  }
+  return e;
+}
+
+template <int R>
+static void errorLut(float &errSuhu, float &errKeruh, bool &okPerkiraan) {
+  static FuzzyLut<R> suhu, keruh;
+  errSuhu = errorLutRapat(aturanFuzzy.suhu, LUT_SUHU_MIN, LUT_SUHU_MAX, suhu);
+  errKeruh = errorLutRapat(aturanFuzzy.keruh, LUT_KERUH_MIN, LUT_KERUH_MAX, keruh);
+  // errorMaks (OVERSAMPLE per sel) tidak boleh jauh meremehkan error sebenarnya
+  okPerkiraan = okPerkiraan && suhu.errorMaks >= 0.5f * errSuhu && keruh.errorMaks >= 0.5f * errKeruh;
+  printf("  LUT %5d titik (%6u byte/tabel): error maks suhu %.4f%%  keruh %.4f%% (bangun(): %.4f%% / %.4f%%)\n",
+         R, (unsigned)sizeof(suhu), errSuhu, errKeruh, suhu.errorMaks, keruh.errorMaks);
+}
+
+// Error LUT harus turun terus saat resolusi naik (breakpoint jadi node, sisa error O(h^2))
+static void test_lut_error_turun_monoton() {
+  float s[6] = {}, k[6] = {};
+  bool okPerkiraan = true;
+  errorLut<32>(s[0], k[0], okPerkiraan);
+  errorLut<64>(s[1], k[1], okPerkiraan);
+  errorLut<128>(s[2], k[2], okPerkiraan);
+  errorLut<256>(s[3], k[3], okPerkiraan);
+  errorLut<512>(s[4], k[4], okPerkiraan);
+  errorLut<1024>(s[5], k[5], okPerkiraan);
+  for (int i = 1; i < 6; i++) {
+    TEST_ASSERT_TRUE_MESSAGE(s[i] <= s[i - 1], "error LUT suhu naik saat resolusi naik");
+    TEST_ASSERT_TRUE_MESSAGE(k[i] <= k[i - 1], "error LUT keruh naik saat resolusi naik");
+  }
+  TEST_ASSERT_TRUE_MESSAGE(okPerkiraan, "errorMaks bangun() meremehkan error sebenarnya");
+}
+
+// NaN / +-inf tidak boleh sampai ke indeks tabel: NaN & -inf = batas bawah, +inf = batas atas
+static void test_lut_nan_inf() {
+  static FuzzyLut<FUZZY_LUT_RESOLUSI> lut;
+  errorLutRapat(aturanFuzzy.suhu, LUT_SUHU_MIN, LUT_SUHU_MAX, lut);
+  TEST_ASSERT_TRUE(lut.hitung(NAN) == lut.hitung(LUT_SUHU_MIN));
+  TEST_ASSERT_TRUE(lut.hitung(-INFINITY) == lut.hitung(LUT_SUHU_MIN));
+  TEST_ASSERT_TRUE(lut.hitung(INFINITY) == lut.hitung(LUT_SUHU_MAX));
+}
+
+// Toleransi selisih output vs double (% skala 0-100)
+const double PID_TOLERANSI_FLOAT = 1e-3;
+const double PID_TOLERANSI_Q16 = 0.25;
+
+struct SampelJejak {
+  unsigned long ms;
+  float errorSuhu, errorKeruh;
+};
+
+static void rekamJejak(const Telemetri &t, void *ctx) {
+  ((std::vector<SampelJejak> *)ctx)->push_back({t.timestamp_ms, t.errorSuhu, t.errorKeruh});
+}
+
+template <typename T>
+static void putarUlangPid(const std::vector<SampelJejak> &jejak, const ParameterKontrol &p,
+                          std::vector<double> &suhu, std::vector<double> &keruh) {
+  StatePid<T> sS, sK;
+  sS.reset(0);
+  sK.reset(0);
+  const GainPid<T> gS = {T(p.Kp_suhu), T(p.Ki_suhu), T(p.Kd_suhu)};
+  const GainPidKeruh<T> gK = {T(p.Kp_keruh), T(p.Ki_keruh), T(p.Kd_keruh), T(p.Kp_keruh_turbo),
+                              p.ambangTurboKeruh, p.keruhTahan, p.keruhMati, p.turbiditySetpoint};
+  for (const SampelJejak &j : jejak) {
+    suhu.push_back((double)pidSuhu(sS, gS, j.errorSuhu, j.ms));
+    keruh.push_back((double)pidKeruh(sK, gK, j.errorKeruh, j.ms));
+  }
+}
+
+static double selisihMaks(const std::vector<double> &a, const std::vector<double> &b) {
+  double m = 0.0;
+  for (size_t i = 0; i < a.size(); i++) m = std::max(m, fabs(a[i] - b[i]));
+  return m;
+}
+
+// Jejak error direkam dari simulator loop tertutup (PID, skala 1/4 durasi),
+// diputar ulang per skenario dengan state baru
+static void test_presisi_pid() {
+  ParameterKontrol p;
+  p.kontrolAktif = PID;
+  std::vector<double> dS, dK, fS, fK, qS, qK;
+  size_t jumlahSampel = 0;
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    std::vector<SampelJejak> jejak;
+    OpsiSimulasi opsi;
+    opsi.skalaDurasi = 0.25;
+    opsi.jejak = rekamJejak;
+    opsi.ctxJejak = &jejak;
+    simulasikan(SKENARIO_STANDAR[s], p, ParameterPlant(), opsi);
+    putarUlangPid<double>(jejak, p, dS, dK);
+    putarUlangPid<float>(jejak, p, fS, fK);
+    putarUlangPid<Q16>(jejak, p, qS, qK);
+    jumlahSampel += jejak.size();
+  }
+  const double eFS = selisihMaks(fS, dS), eFK = selisihMaks(fK, dK);
+  const double eQS = selisihMaks(qS, dS), eQK = selisihMaks(qK, dK);
+  printf("  PID vs double (%zu sampel jejak): float suhu %.2e keruh %.2e (< %.2g) | Q16 suhu %.2e keruh %.2e (< %.2g)\n",
+         jumlahSampel, eFS, eFK, PID_TOLERANSI_FLOAT, eQS, eQK, PID_TOLERANSI_Q16);
+  TEST_ASSERT_TRUE_MESSAGE(jumlahSampel > 0, "jejak simulator kosong");
+  TEST_ASSERT_TRUE_MESSAGE(eFS < PID_TOLERANSI_FLOAT && eFK < PID_TOLERANSI_FLOAT, "PID float menyimpang dari double");
+  TEST_ASSERT_TRUE_MESSAGE(eQS < PID_TOLERANSI_Q16 && eQK < PID_TOLERANSI_Q16, "PID Q16.16 menyimpang dari double");
+}
+
+// Kesetaraan bank vs jalur satu tangki (biaya per kanal: tools/bench)
+static void test_bank_kontrol_setara() {
+  const int K = 12;
+  static BankKontrol<K> bank;
+  TangkiAos aos[K];
+  unsigned long now = 0;
+  bank.mulai(now);
+  for (int k = 0; k < K; k++) {
+    bank.setParameter(k, parameterKanal(k));
+    aos[k].p = parameterKanal(k);
+    resetPID(aos[k].st, now);
+  }
+  long beda = 0;
+  for (int i = 0; i < 5000; i++) {
+    now += 250 + (i % 4) * 250;
+    if (i == 2500) {   // ganti mode semua kanal di tengah jalan
+      for (int k = 0; k < K; k++) {
+        ParameterKontrol p = bank.parameter(k);
+        p.kontrolAktif = (ControlMode)((p.kontrolAktif + 1) % 3);
+        bank.setParameter(k, p);
+        bank.reset(k, now);
+        aos[k].p = p;
+        resetPID(aos[k].st, now);
+      }
+    }
+    for (int k = 0; k < K; k++) {
+      bank.suhu[k] = suhuUji(k, i);
+      bank.turbidityAdc[k] = adcUji(k, i);
+    }
+    bank.hitung(now);
+    for (int k = 0; k < K; k++) {
+      double s, kk;
+      int ps, pk;
+      hitungAos(aos[k], suhuUji(k, i), adcUji(k, i), now, s, kk, ps, pk);
+      if (s != bank.outSuhu[k] || kk != bank.outKeruh[k] || ps != bank.pwmSuhu[k] || pk != bank.pwmKeruh[k]) beda++;
+    }
+  }
+  printf("  BankKontrol<%d> vs satu tangki : %ld tick kanal berbeda\n", K, beda);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, beda, "BankKontrol berbeda dari jalur satu tangki");
+}
+
+static void test_bank_topik_kanal() {
+  char topik[TOPIK_MAKS];
+  TopikPerangkat tp;
+  TEST_ASSERT_TRUE(tp.mulai("aquarium", "aq-01"));   // dasar "aquarium/aq-01"
+  topikKanal(topik, sizeof(topik), tp.dasar, 3, "data");
+  TEST_ASSERT_EQUAL_STRING("aquarium/aq-01/3/data", topik);
+  TEST_ASSERT_EQUAL_INT(3, kanalDariTopik(topik, tp.dasar, "data"));
+  TEST_ASSERT_EQUAL_INT(0, kanalDariTopik(tp[TOPIK_DATA], tp.dasar, "data"));
+  TEST_ASSERT_EQUAL_INT(-1, kanalDariTopik("aquarium/aq-01/x/data", tp.dasar, "data"));
+  TEST_ASSERT_EQUAL_INT(-1, kanalDariTopik("aquarium/3/data", tp.dasar, "data"));
+}
+
+// Tabel terpasang vs generator vs QP daring
+static void test_mpc_tabel() {
+  static GeneratorMpc gen;
+  TEST_ASSERT_TRUE_MESSAGE(gen.bangun(ParameterPlant(), SpesifikasiMpc()), "generator MPC gagal");
+  const TabelMpc &t = gen.tabel();
+
+  // TABEL_MPC dihasilkan dari spesifikasi & plant default: harus sama persis dengan generator sekarang
+  double bedaTabel = 0.0, bedaQp = 0.0;
+  for (int i = 0; i <= 400; i++)
+    for (int j = 0; j <= 100; j++) {
+      const float e = -4.0f + 0.02f * (float)i, h = (float)j;
+      bedaTabel = fmax(bedaTabel, fabs(evaluasiTabelMpc(TABEL_MPC, e, h) - evaluasiTabelMpc(t, e, h)));
+    }
+  std::vector<float> e = buatInput(2000, TABEL_MPC.eMin, TABEL_MPC.eMax, 21), h = buatInput(2000, 0.0f, 100.0f, 22);
+  for (size_t i = 0; i < e.size(); i++)
+    bedaQp = fmax(bedaQp, fabs(evaluasiTabelMpc(TABEL_MPC, e[i], h[i]) - gen.solusiDaring(e[i], h[i])));
+  printf("  MPC eksplisit: %u wilayah, %u hukum, sel %ux%u, terburuk %u bidang/lookup | tabel %u byte | "
+         "vs generator %.6f%%, vs QP daring %.5f%%\n",
+         (unsigned)TABEL_MPC.jumlahWilayah, (unsigned)TABEL_MPC.jumlahHukum, (unsigned)TABEL_MPC.selE,
+         (unsigned)TABEL_MPC.selH, (unsigned)TABEL_MPC.maksBidang, (unsigned)ukuranTabelMpc(TABEL_MPC), bedaTabel,
+         bedaQp);
+  TEST_ASSERT_TRUE_MESSAGE(bedaTabel < 1e-4, "TABEL_MPC basi, jalankan ulang tools/mpc");
+  TEST_ASSERT_TRUE_MESSAGE(bedaQp < 0.01, "tabel MPC menyimpang dari QP daring");
+  // NaN tidak boleh sampai ke indeks sel: dianggap batas bawah, output tetap 0-100
+  TEST_ASSERT_TRUE(evaluasiTabelMpc(TABEL_MPC, NAN, 0.0f) == evaluasiTabelMpc(TABEL_MPC, TABEL_MPC.eMin, 0.0f));
+  TEST_ASSERT_TRUE(evaluasiTabelMpc(TABEL_MPC, 1.0f, NAN) == evaluasiTabelMpc(TABEL_MPC, 1.0f, TABEL_MPC.hMin));
+  const float o = evaluasiTabelMpc(TABEL_MPC, NAN, NAN);
+  TEST_ASSERT_TRUE(o >= 0.0f && o <= 100.0f);
+}
+
+// Loop tertutup: skenario suhu (step setpoint & ruang dingin = rugi panas besar)
+static void test_mpc_loop_tertutup() {
+  const ParameterPlant plant;
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    const Skenario &sk = SKENARIO_STANDAR[s];
+    if (strcmp(sk.nama, "step_suhu") != 0 && strcmp(sk.nama, "ruang_dingin") != 0) continue;
+    ParameterKontrol pm, pp;
+    pm.kontrolAktif = MPC;
+    pp.kontrolAktif = PID;
+    const HasilSimulasi hm = simulasikan(sk, pm, plant), hp = simulasikan(sk, pp, plant);
+    char tsM[16] = "-", tsP[16] = "-";
+    if (hm.suhu.settlingDetik >= 0) snprintf(tsM, sizeof(tsM), "%.0f", hm.suhu.settlingDetik / 60);
+    if (hp.suhu.settlingDetik >= 0) snprintf(tsP, sizeof(tsP), "%.0f", hp.suhu.settlingDetik / 60);
+    printf("  %-12s IAE MPC %.2f vs PID %.2f C.h | overshoot %.2f vs %.2f C | settling %s vs %s mnt\n", sk.nama,
+           hm.suhu.iae / 3600, hp.suhu.iae / 3600, hm.suhu.overshoot, hp.suhu.overshoot, tsM, tsP);
+    TEST_ASSERT_TRUE_MESSAGE(hm.suhu.iae < hp.suhu.iae, "IAE suhu MPC tidak lebih baik dari PID");
+    TEST_ASSERT_TRUE_MESSAGE(hm.suhu.overshoot < 0.3, "overshoot suhu MPC >= 0.3 C");
+    TEST_ASSERT_TRUE_MESSAGE(hm.suhu.settlingDetik >= 0, "suhu MPC tidak settle");
+  }
+}
+
+// Galat linearitas kurva terhadap plant: |efek(duty(x)) - x| maks, x = 5..100% (efek ternormalisasi)
+static double galatLinear(const PlantAquarium &plant, const KurvaAktuator &k, KanalPwm kanal) {
+  double maks = 0.0;
+  for (int x = 5; x <= 100; x += 5) {
+    const double d = dutyLinear(k, (float)x) * (255.0 / PWM_DUTY_MAKS);
+    const double efek = kanal == KANAL_HEATER ? plant.wattHeater(d) / plant.wattHeater(255) : plant.fraksiAliran(d);
+    maks = fmax(maks, fabs(efek - x / 100.0));
+  }
+  return maks;
+}
+
+// Kurva bawaan = map() 8 bit lama (map() memotong dua kali, kurva membulatkan sekali)
+static void test_aktuator_kurva_bawaan() {
+  double bedaHeater = 0.0, bedaPompa = 0.0;
+  for (int i = 0; i <= 1000; i++) {
+    const float x = i * 0.1f;
+    const int v = (int)(x * 2.55f);
+    const int lamaPompa = v < PWM_START_LOGIKA ? 0 :
+      (v - PWM_START_LOGIKA) * (255 - PWM_MIN_FISIK) / (255 - PWM_START_LOGIKA) + PWM_MIN_FISIK;
+    const double skala = 255.0 / PWM_DUTY_MAKS;
+    bedaHeater = fmax(bedaHeater, fabs(kuantisasiDuty(dutyLinear(KURVA_HEATER_DEFAULT, x), nullptr) * skala - v));
+    bedaPompa = fmax(bedaPompa, fabs(kuantisasiDuty(dutyLinear(KURVA_POMPA_DEFAULT, x), nullptr) * skala - lamaPompa));
+  }
+  printf("  PWM %d bit (duty 0-%d): kurva bawaan vs map() 8 bit lama: heater %.2f, pompa %.2f LSB8\n",
+         PWM_RESOLUTION, PWM_DUTY_MAKS, bedaHeater, bedaPompa);
+  TEST_ASSERT_TRUE_MESSAGE(bedaHeater < 1.5 && bedaPompa < 1.5, "kurva bawaan beda dari map() 8 bit lama");
+}
+
+// Sigma-delta: rata-rata duty = ideal walau pecahan LSB; tanpa dither galat = sisa pembulatan
+static void test_aktuator_dither() {
+  double galatDither = 0.0, galatBulat = 0.0;
+  for (int c = 1; c < 10; c++) {
+    const float ideal = 3.0f + c * 0.1f;
+    float sisa = 0.0f;
+    long jumlahD = 0, jumlahB = 0;
+    const int n = 1000;
+    for (int i = 0; i < n; i++) {
+      jumlahD += kuantisasiDuty(ideal, &sisa);
+      jumlahB += kuantisasiDuty(ideal, nullptr);
+    }
+    galatDither = fmax(galatDither, fabs((double)jumlahD / n - ideal));
+    galatBulat = fmax(galatBulat, fabs((double)jumlahB / n - ideal));
+  }
+  printf("  Dither heater: galat rata-rata duty %.4f LSB (tanpa dither %.2f LSB)\n", galatDither, galatBulat);
+  TEST_ASSERT_TRUE_MESSAGE(galatDither < 0.01, "rata-rata dither heater meleset");
+}
+
+// Kalibrasi di perangkat lewat jalur firmware (tickSuhu/tickKeruh) di atas plant simulasi
+static void test_aktuator_kalibrasi() {
+  const ParameterPlant pp;
+  PlantAquarium plant;
+  plant.mulai(pp, 25.0, 15.0, 25.0, 1);
+  const Skenario skHeater = {"kalibrasi_heater", 0.85, 26.0, 15.0, 24.0, 0.0, 0, {}};
+  const Skenario skPompa = {"kalibrasi_pompa", 0.25, 28.0, 25.0, 25.0, 0.0, 0, {}};
+  const KanalPwm kanal[2] = {KANAL_HEATER, KANAL_POMPA};
+  const Skenario *sk[2] = {&skHeater, &skPompa};
+  ParameterKontrol kal;
+  for (int a = 0; a < 2; a++) {
+    KalibrasiAktuator k;
+    k.mulai(kanal[a], pengaturanKalibrasi(kanal[a]), 0);
+    OpsiSimulasi opsi;
+    opsi.kalibrasi = &k;
+    opsi.seed = 7 + a;
+    ParameterKontrol p;
+    p.suhuSetpoint = 26.0f;
+    simulasikan(*sk[a], p, pp, opsi);
+    const KurvaAktuator &bawaan = a == 0 ? KURVA_HEATER_DEFAULT : KURVA_POMPA_DEFAULT;
+    const double gB = galatLinear(plant, bawaan, kanal[a]);
+    const double gK = k.status == KALIBRASI_SELESAI ? galatLinear(plant, k.kurva, kanal[a]) : 1.0;
+    // Pompa: tepi dead band terukur vs duty mogok plant
+    const double tepi = k.kurva.duty[0] * 255.0;
+    printf("  Kalibrasi %-6s: %s%s%s, %d level | galat linearitas %.1f%% (bawaan %.1f%%) | duty logika 0+/50%%: "
+           "%.1f/%.1f (8 bit)\n",
+           a == 0 ? "heater" : "pompa", k.status == KALIBRASI_SELESAI ? "selesai" : "gagal",
+           k.alasan[0] ? ": " : "", k.alasan, (int)k.jumlahTitik, gK * 100.0, gB * 100.0, tepi,
+           k.kurva.duty[5] * 255.0);
+    TEST_ASSERT_TRUE_MESSAGE(k.status == KALIBRASI_SELESAI, "kalibrasi tidak selesai");
+    TEST_ASSERT_TRUE_MESSAGE(gK < 0.08 && gK < gB, "kurva kalibrasi tidak lebih linear dari bawaan");
+    TEST_ASSERT_TRUE_MESSAGE(a == 0 || fabs(tepi - pp.dutyMogokPompa) < 4.0, "dead band pompa meleset");
+    (a == 0 ? kal.kurvaHeater : kal.kurvaPompa) = k.kurva;
+  }
+  char buffer[512];
+  KalibrasiAktuator kosong;
+  TEST_ASSERT_TRUE(serializeKalibrasi(kosong, buffer, sizeof(buffer)) > 0);
+
+  // Kurva hasil: lewat perintah MQTT (format % duty) lalu flash, harus kembali utuh
+  static KonfigurasiKontrol konf = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  PengaturanTelemetri pt;
+  char json[512];
+  int n = snprintf(json, sizeof(json), "{\"dither_heater\":true,\"kurva_pompa\":[");
+  for (int i = 0; i < KURVA_AKTUATOR_TITIK; i++)
+    n += snprintf(json + n, sizeof(json) - n, "%s%.4f", i ? "," : "", kal.kurvaPompa.duty[i] * 100.0f);
+  snprintf(json + n, sizeof(json) - n, "]}");
+  TEST_ASSERT_TRUE_MESSAGE(parsePerintah(json, strlen(json), konf, pt).ok, "perintah kurva_pompa ditolak");
+  NativeBerkas flash;
+  KurvaAktuator mh = {}, mp = {};
+  TEST_ASSERT_TRUE(simpanKurvaAktuator(flash, kal.kurvaHeater, konf.param.kurvaPompa));
+  TEST_ASSERT_TRUE(muatKurvaAktuator(flash, mh, mp));
+  TEST_ASSERT_TRUE_MESSAGE(memcmp(&mh, &kal.kurvaHeater, sizeof(mh)) == 0, "kurva heater dari flash berubah");
+  double bedaMqtt = 0.0;
+  for (int i = 0; i < KURVA_AKTUATOR_TITIK; i++) bedaMqtt = fmax(bedaMqtt, fabs(mp.duty[i] - kal.kurvaPompa.duty[i]));
+  printf("  Kurva lewat MQTT + flash: selisih %.6f, dither %s\n", bedaMqtt, konf.param.ditherHeater ? "ON" : "OFF");
+  TEST_ASSERT_TRUE_MESSAGE(bedaMqtt < 1e-5, "kurva pompa lewat MQTT + flash berubah");
+  TEST_ASSERT_TRUE(konf.param.ditherHeater);
+
+  // Loop tertutup dengan kurva hasil kalibrasi (jika dipasang) vs bawaan; energi pompa Fuzzy
+  // naik tajam, karena itu KALIBRASI_PASANG_OTOMATIS bawaan 0. Dilaporkan saja.
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    const Skenario &sk2 = SKENARIO_STANDAR[s];
+    if (strcmp(sk2.nama, "step_suhu") != 0 && strcmp(sk2.nama, "lonjakan_keruh") != 0) continue;
+    for (int m = 0; m < 2; m++) {
+      ParameterKontrol pb, pk = kal;
+      pb.kontrolAktif = pk.kontrolAktif = m == 0 ? FUZZY : PID;
+      const HasilSimulasi hb = simulasikan(sk2, pb, pp), hk = simulasikan(sk2, pk, pp);
+      printf("  %-14s %-5s IAE suhu %.2f -> %.2f C.h, keruh %.2f -> %.2f %%.h | energi pompa %.1f -> %.1f Wh\n",
+             sk2.nama, namaMode(pb.kontrolAktif), hb.suhu.iae / 3600, hk.suhu.iae / 3600, hb.keruh.iae / 3600,
+             hk.keruh.iae / 3600, hb.keruh.energiWh, hk.keruh.energiWh);
+    }
+  }
+}
+
+// Perintah: aksi + aturan + terapkan dalam satu dokumen; nilai asing ditolak
+static void test_autotune_perintah() {
+  static KonfigurasiKontrol konf = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  PengaturanTelemetri pt;
+  const char *terima = "{\"autotune\":\"keruh\",\"autotune_aturan\":\"tl\",\"autotune_terapkan\":true}";
+  const HasilPerintah h = parsePerintah(terima, strlen(terima), konf, pt);
+  TEST_ASSERT_TRUE(h.ok && (h.berubah & PERINTAH_AUTOTUNE));
+  TEST_ASSERT_EQUAL_UINT32(1, konf.nomorAutotune);
+  TEST_ASSERT_TRUE(konf.aksiAutotune == AUTOTUNE_AKSI_KERUH && konf.aturanAutotune == AUTOTUNE_TL);
+  TEST_ASSERT_TRUE(konf.terapkanAutotune);
+  const char *tolak[] = {"{\"autotune\":\"lampu\"}", "{\"autotune_aturan\":\"pid\"}", "{\"autotune_terapkan\":1}"};
+  for (const char *j : tolak) {
+    static KonfigurasiKontrol salinan;
+    salinan = konf;
+    TEST_ASSERT_FALSE_MESSAGE(parsePerintah(j, strlen(j), salinan, pt).ok, j);
+  }
+}
+
+// Eksperimen relay lewat jalur firmware (tickSuhu/tickKeruh) di atas plant simulasi, mulai di
+// setpoint, lalu PID suhu hasil autotune vs gain bawaan di loop tertutup
+static void test_autotune_relay() {
+  const ParameterPlant pp;
+  const Skenario skRelay = {"autotune", 8.0, 28.0, 15.0, 24.0, 0.0, 0, {}};
+  const KanalPwm kanal[2] = {KANAL_HEATER, KANAL_POMPA};
+  ParameterKontrol hasil;
+  for (int a = 0; a < 2; a++) {
+    ParameterKontrol p;
+    p.kontrolAktif = PID;
+    AutotuneRelay t;
+    t.mulai(kanal[a], a == 0 ? p.suhuSetpoint : p.turbiditySetpoint, AUTOTUNE_SIMC, true, pengaturanAutotune(kanal[a]), 0);
+    OpsiSimulasi opsi;
+    opsi.autotune = &t;
+    opsi.seed = 3 + a;
+    simulasikan(skRelay, p, pp, opsi);
+    printf("  Relay %-6s: %s%s%s, %u siklus | Ku %.4g, Pu %.0f s, amplitudo %.3f, fraksi tinggi %.2f -> "
+           "SIMC Kp %.4g Ki %.4g\n",
+           a == 0 ? "heater" : "pompa", t.status == AUTOTUNE_SELESAI ? "selesai" : "gagal", t.alasan[0] ? ": " : "",
+           t.alasan, (unsigned)t.siklus, t.ku, t.pu, t.amplitudo, t.fraksiTinggi, t.kp, t.ki);
+    TEST_ASSERT_TRUE_MESSAGE(t.status == AUTOTUNE_SELESAI, "eksperimen relay tidak selesai");
+    TEST_ASSERT_TRUE_MESSAGE(terapkanAutotune(t, hasil, AUTOTUNE_GAIN_MAKS), "gain hasil autotune ditolak");
+  }
+
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    const Skenario &sk = SKENARIO_STANDAR[s];
+    if (strcmp(sk.nama, "step_suhu") != 0 && strcmp(sk.nama, "ruang_dingin") != 0) continue;
+    ParameterKontrol pb, pt2 = hasil;
+    pb.kontrolAktif = pt2.kontrolAktif = PID;
+    const HasilSimulasi hb = simulasikan(sk, pb, pp), ht = simulasikan(sk, pt2, pp);
+    printf("  %-12s IAE suhu autotune %.2f vs bawaan %.2f C.h | overshoot %.2f vs %.2f C | keruh %.2f vs %.2f %%.h\n",
+           sk.nama, ht.suhu.iae / 3600, hb.suhu.iae / 3600, ht.suhu.overshoot, hb.suhu.overshoot,
+           ht.keruh.iae / 3600, hb.keruh.iae / 3600);
+    TEST_ASSERT_TRUE_MESSAGE(ht.suhu.iae < hb.suhu.iae, "PID suhu hasil autotune tidak lebih baik dari bawaan");
+    TEST_ASSERT_TRUE_MESSAGE(ht.suhu.overshoot < 0.3, "overshoot PID suhu hasil autotune >= 0.3 C");
+  }
+}
+
+// Pengaman: mulai 2 C di bawah setpoint -> gagal di tick pertama, heater 0; batal & serialisasi;
+// histeresis heater mengikuti resolusi DS18B20
+static void test_autotune_pengaman() {
+  AutotuneRelay jauh, batal;
+  jauh.mulai(KANAL_HEATER, 26.0f, AUTOTUNE_SIMC, true, pengaturanAutotune(KANAL_HEATER), 0);
+  const float out = jauh.langkah(24.0f, 1000);
+  batal.mulai(KANAL_POMPA, 10.0f, AUTOTUNE_ZN, false, pengaturanAutotune(KANAL_POMPA), 0);
+  batal.batal();
+  ParameterKontrol tetap;
+  char buffer[384];
+  const size_t n = serializeAutotune(jauh, buffer, sizeof(buffer));
+  printf("  Autotune jauh dari setpoint: %s | %s\n", jauh.alasan, buffer);
+  TEST_ASSERT_TRUE(jauh.status == AUTOTUNE_GAGAL && out == 0.0f);
+  TEST_ASSERT_TRUE(batal.status == AUTOTUNE_GAGAL);
+  TEST_ASSERT_FALSE(terapkanAutotune(jauh, tetap, AUTOTUNE_GAIN_MAKS));
+  TEST_ASSERT_TRUE(tetap.Kp_suhu == ParameterKontrol().Kp_suhu);
+  TEST_ASSERT_TRUE(n > 0 && strstr(buffer, "\"status\":\"gagal\"") != nullptr);
+
+  // Histeresis heater >= 2 langkah DS18B20 di tiap resolusi; 10 bit (+/- 0.5 C) sudah tidak muat di pita 1 C
+  for (uint8_t bit = 9; bit <= 12; bit++) {
+    const PengaturanAutotune pa = pengaturanAutotune(KANAL_HEATER, bit);
+    TEST_ASSERT_TRUE(pa.histeresis >= 2.0f * PipelineSuhu::langkahC(bit));
+    AutotuneRelay r;
+    r.mulai(KANAL_HEATER, 26.0f, AUTOTUNE_SIMC, false, pa, 0);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(bit >= 11 ? AUTOTUNE_BERJALAN : AUTOTUNE_GAGAL, r.status, r.alasan);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.125f, pengaturanAutotune(KANAL_HEATER).histeresis);
+}
+
+static void rekamBayangan(const Telemetri &t, void *ctx) {
+  ((std::vector<Telemetri> *)ctx)->push_back(t);
+}
+
+// Loncatan output terbesar di sekitar ganti mode: sampel terakhir sebelum
+// vs sampel pertama sesudah tick loop itu berjalan (suhu 1 s, keruh 250 ms)
+static void loncatanGanti(const std::vector<Telemetri> &j, const Skenario &sk, double &suhu, double &keruh) {
+  suhu = keruh = 0.0;
+  for (int e = 0; e < sk.jumlahKejadian; e++) {
+    if (sk.kejadian[e].jenis != GANTI_MODE) continue;
+    const unsigned long ms = (unsigned long)(sk.kejadian[e].detik * 1000.0);
+    for (size_t i = 1; i < j.size(); i++) {
+      if (j[i - 1].timestamp_ms >= ms || j[i].timestamp_ms < ms) continue;
+      for (size_t k = i; k < j.size() && j[k].timestamp_ms <= ms + 1500; k++) {
+        if (j[k].timestamp_ms >= ms + PERIODE_SUHU_MS + 250) suhu = fmax(suhu, fabs(j[k].outSuhu - j[i - 1].outSuhu));
+        if (j[k].timestamp_ms >= ms + PERIODE_KERUH_MS + 250) keruh = fmax(keruh, fabs(j[k].outKeruh - j[i - 1].outKeruh));
+      }
+      break;
+    }
+  }
+}
+
+// Bayangan tidak boleh mengubah output yang menggerakkan aktuator; biaya per loop dalam anggaran
+static void test_bayangan_identik_dan_anggaran() {
+  const ParameterPlant pp;
+  OpsiSimulasi opsi;
+  opsi.periodeJejakMs = PERIODE_KERUH_MS;
+  opsi.jejak = rekamBayangan;
+  bool okSama = true;
+  double beda[2] = {0.0, 0.0}, usTotal = 0.0;
+  std::vector<double> usTick;
+  uint32_t lewat = 0;
+  for (int m = 0; m < 2; m++) {
+    for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+      const Skenario &sk = SKENARIO_STANDAR[s];
+      if (strcmp(sk.nama, "step_suhu") != 0 && strcmp(sk.nama, "lonjakan_keruh") != 0) continue;
+      std::vector<Telemetri> jBiasa, jBayangan;
+      ParameterKontrol p;
+      p.kontrolAktif = m == 0 ? FUZZY : PID;
+      opsi.skalaDurasi = 0.25;
+      opsi.ctxJejak = &jBiasa;
+      const HasilSimulasi hB = simulasikan(sk, p, pp, opsi);
+      p.modeBayangan = true;
+      opsi.ctxJejak = &jBayangan;
+      const HasilSimulasi hS = simulasikan(sk, p, pp, opsi);
+      okSama = okSama && hB.suhu.iae == hS.suhu.iae && hB.keruh.iae == hS.keruh.iae && jBiasa.size() == jBayangan.size();
+      for (size_t i = 0; okSama && i < jBayangan.size(); i++) {
+        const Telemetri &a = jBiasa[i], &b = jBayangan[i];
+        const Bayangan &bs = b.bayanganSuhu, &bk = b.bayanganKeruh;
+        okSama = a.outSuhu == b.outSuhu && a.outKeruh == b.outKeruh && b.bayangan &&
+                 (float)b.outSuhu == (m == 0 ? bs.fuzzy : bs.pid) && (float)b.outKeruh == (m == 0 ? bk.fuzzy : bk.pid);
+        beda[0] = fmax(beda[0], fabs(bs.fuzzy - bs.pid));
+        beda[1] = fmax(beda[1], fabs(bk.fuzzy - bk.pid));
+        const double us = fmax(bs.usFuzzy + bs.usPid, bk.usFuzzy + bk.usPid);
+        usTotal += us;
+        usTick.push_back(us);
+      }
+      if (!jBayangan.empty()) lewat += jBayangan.back().lewatAnggaranBayangan;
+    }
+  }
+  printf("  Mode bayangan: beda Fuzzy-PID maks suhu %.1f%%, keruh %.1f%%\n", beda[0], beda[1]);
+  TEST_ASSERT_TRUE_MESSAGE(okSama, "mode bayangan mengubah output aktif");
+
+  // Anggaran = persentil 99.9 (Tick.h): maks di host ikut preemption OS, dilaporkan saja
+  const size_t n = usTick.size();
+  TEST_ASSERT_TRUE(n > 0);
+  std::sort(usTick.begin(), usTick.end());
+  const double p999 = usTick[(n * 999) / 1000], usMaks = usTick[n - 1];
+  printf("  Biaya Fuzzy + PID per loop (native, %zu sampel): rata-rata %.2f us, p99.9 %.2f us, maks %.2f us | "
+         "anggaran p99.9 %.0f us, dilewati %lu tick\n", n, usTotal / n, p999, usMaks, ANGGARAN_BAYANGAN_US,
+         (unsigned long)lewat);
+  TEST_ASSERT_TRUE_MESSAGE(p999 <= ANGGARAN_BAYANGAN_US, "p99.9 biaya mode bayangan di atas anggaran");
+  TEST_ASSERT_TRUE_MESSAGE(lewat * 1000 <= n, "lebih dari 1/1000 tick melewati anggaran bayangan");
+}
+
+// Ganti mode Fuzzy -> PID -> Fuzzy di tengah transien suhu & keruh
+static void test_bayangan_transfer_mulus() {
+  const ParameterPlant pp;
+  OpsiSimulasi opsi;
+  opsi.periodeJejakMs = PERIODE_KERUH_MS;
+  opsi.jejak = rekamBayangan;
+  const Skenario skGanti = {"ganti_mode", 2.0, 26.0, 25.0, 24.0, 0.0, 3, {
+    {0, SETPOINT_SUHU, 28.0}, {1800, GANTI_MODE, PID}, {3600, GANTI_MODE, FUZZY}}};
+  double lonjakan[2][2];
+  HasilSimulasi hasil[2];
+  for (int v = 0; v < 2; v++) {
+    std::vector<Telemetri> j;
+    ParameterKontrol p;
+    p.modeBayangan = p.transferMulus = v == 1;
+    opsi.ctxJejak = &j;
+    hasil[v] = simulasikan(skGanti, p, pp, opsi);
+    loncatanGanti(j, skGanti, lonjakan[v][0], lonjakan[v][1]);
+  }
+  printf("  Ganti mode Fuzzy->PID->Fuzzy: loncatan output suhu %.1f -> %.1f%%, keruh %.1f -> %.1f%% "
+         "(reset -> transfer mulus) | IAE suhu %.3f -> %.3f C.h\n",
+         lonjakan[0][0], lonjakan[1][0], lonjakan[0][1], lonjakan[1][1], hasil[0].suhu.iae / 3600,
+         hasil[1].suhu.iae / 3600);
+  TEST_ASSERT_TRUE_MESSAGE(lonjakan[1][0] < 2.0 && lonjakan[1][1] < 2.0, "loncatan transfer mulus >= 2%");
+  TEST_ASSERT_TRUE_MESSAGE(lonjakan[1][0] < lonjakan[0][0] && lonjakan[1][1] < lonjakan[0][1],
+                           "transfer mulus tidak memperkecil loncatan");
+}
+
+// Perintah MQTT & payload telemetri JSON mode bayangan
+static void test_bayangan_perintah_dan_json() {
+  static KonfigurasiKontrol konf = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  PengaturanTelemetri pt;
+  const char *terima = "{\"mode_bayangan\":true,\"transfer_mulus\":true,\"tau_transfer\":12.5}";
+  const char *tolak = "{\"mode_bayangan\":false,\"tau_transfer\":0}";
+  TEST_ASSERT_TRUE(parsePerintah(terima, strlen(terima), konf, pt).ok);
+  TEST_ASSERT_FALSE(parsePerintah(tolak, strlen(tolak), konf, pt).ok);
+  TEST_ASSERT_TRUE(konf.param.modeBayangan && konf.param.transferMulus && konf.param.tauTransfer == 12.5f);
+  Telemetri t = {};
+  t.bayangan = true;
+  t.bayanganSuhu = {100.0f, 100.0f, 999.99f, 999.99f};
+  t.bayanganKeruh = t.bayanganSuhu;
+  t.lewatAnggaranBayangan = 4000000000u;
+  t.suhu = t.setpointSuhu = -127.0f;
+  t.outSuhu = t.outKeruh = 100.0;
+  char dok[640];
+  const size_t panjang = serializeTelemetri(t, dok, sizeof(dok));
+  printf("  JSON telemetri bayangan terpanjang %zu byte\n", panjang);
+  TEST_ASSERT_TRUE_MESSAGE(panjang > 0 && dok[panjang - 1] == '}', "JSON telemetri bayangan terpotong");
+  TEST_ASSERT_TRUE(strstr(dok, "\"bayangan\":{\"suhu\"") != nullptr);
+}
+
+// Dokumen Control backend (startup sync) + rule base keruh
+static const char PERINTAH_LENGKAP[] =
+  "{\"kontrol_aktif\":\"PID\",\"suhu_setpoint\":27.5,\"kp_suhu\":9,\"ki_suhu\":0.25,\"kd_suhu\":5.5,"
+  "\"keruh_setpoint\":10,\"kp_keruh\":5,\"ki_keruh\":0.2,\"kd_keruh\":2,\"kp_turbo_keruh\":35,"
+  "\"ambang_turbo_keruh\":2,\"keruh_tahan\":11,\"keruh_mati\":9,\"fuzzy_lut_suhu\":true,"
+  "\"fuzzy_lut_keruh\":false,\"fuzzy_pd_suhu\":false,\"resolusi_suhu\":11,\"telemetri_biner\":true,"
+  "\"batch_sampel\":20,\"batch_interval_ms\":5000,\"adc_jernih\":20100,\"adc_keruh\":3550,"
+  "\"catatan\":{\"oleh\":\"dashboard\",\"tag\":[1,2,{\"x\":null}]},\"fuzzy_suhu_pd\":null,"
+  "\"fuzzy_keruh\":{\"mf\":[[-9,-9,-7,-5],[-7,-4,-2,-1],[-2.5,-0.5,0.5,2.5],[1,4,7,10],[8,12,12,12]],"
+  "\"out\":[5,20,50,90,100],\"default\":50}}";
+
+// Pesan yang harus ditolak utuh (kunci sah di depan tidak boleh ikut diterapkan)
+static const char *const PERINTAH_TOLAK[] = {
+  "{\"kp_suhu\":12,\"ki_suhu\":null}",
+  "{\"kp_suhu\":12,\"kd_suhu\":-1}",
+  "{\"kp_suhu\":12,\"kd_suhu\":1e39}",
+  "{\"kp_suhu\":12,\"kd_suhu\":200000}",
+  "{\"kp_suhu\":12,\"kp_turbo_keruh\":5000}",
+  "{\"kp_suhu\":12,\"ki_suhu\":\"0.3\"}",
+  "{\"kp_suhu\":12,\"adc_jernih\":3000,\"adc_keruh\":20000}",
+  "{\"kp_suhu\":12,\"keruh_mati\":30}",
+  "{\"kp_suhu\":12,\"kontrol_aktif\":\"Bang-bang\"}",
+  "{\"kp_suhu\":12,\"resolusi_suhu\":13}",
+  "{\"kp_suhu\":12,\"fuzzy_suhu\":{\"mf\":[[3,2,1,0],[0,1,2,3],[0,1,2,3],[0,1,2,3],[0,1,2,3]],\"out\":[1,2,3,4,5]}}",
+  "{\"kp_suhu\":12,\"fuzzy_suhu\":{\"mf\":[[0,1,2,3]],\"out\":[1,2,3,4,5]}}",
+  "{\"kp_suhu\":12,\"ki_suhu\":0.5",
+  "{\"kp_suhu\":12}, {}",
+  "",
+};
+
+static KonfigurasiKontrol aktif = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+static KonfigurasiKontrol staging;
+
+// Diterima: semua nilai masuk, rule base keruh berganti + LUT dipanggang
+static void test_perintah_lengkap_diterima() {
+  PengaturanTelemetri pt;
+  staging = aktif;
+  const HasilPerintah h = parsePerintah(PERINTAH_LENGKAP, sizeof(PERINTAH_LENGKAP) - 1, staging, pt);
+  const ParameterKontrol &q = staging.param;
+  TEST_ASSERT_TRUE_MESSAGE(h.ok, "dokumen Control lengkap ditolak");
+  TEST_ASSERT_TRUE(q.kontrolAktif == PID && q.suhuSetpoint == 27.5f && q.Kp_suhu == 9.0f && q.Ki_suhu == 0.25f);
+  TEST_ASSERT_TRUE(q.turbiditySetpoint == 10.0f && q.mesinFuzzySuhu == FUZZY_LUT);
+  TEST_ASSERT_EQUAL_INT(11, staging.resolusiSuhu);
+  TEST_ASSERT_TRUE(pt.biner && pt.batchSampel == 20 && pt.batchIntervalMs == 5000);
+  TEST_ASSERT_EQUAL_UINT32(1, staging.nomorResetPID);
+  TEST_ASSERT_TRUE(staging.aturan.keruh.hitung(-8.0f) == 5.0f);
+  TEST_ASSERT_TRUE((h.berubah & PERINTAH_ATURAN) && !(h.berubah & PERINTAH_ATURAN_PD));
+}
+
+// Ditolak: tiap pesan diparse ke salinan, konfigurasi aktif tidak tersentuh
+static void test_perintah_rusak_ditolak() {
+  for (const char *m : PERINTAH_TOLAK) {
+    staging = aktif;
+    PengaturanTelemetri ptTolak;
+    TEST_ASSERT_FALSE_MESSAGE(parsePerintah(m, strlen(m), staging, ptTolak).ok, m);
+  }
+  TEST_ASSERT_TRUE(aktif.param.Kp_suhu == ParameterKontrol().Kp_suhu);
+}
+
+// Buffer PubSubClient tidak diakhiri NUL: byte sesudah `length` tidak boleh ikut dibaca
+static void test_perintah_batas_buffer() {
+  PengaturanTelemetri pt;
+  const char mentah[] = "{\"kp_suhu\":79}";
+  staging = aktif;
+  TEST_ASSERT_FALSE(parsePerintah(mentah, 12, staging, pt).ok);   // "{"kp_suhu":7" terpotong
+  staging = aktif;
+  TEST_ASSERT_TRUE(parsePerintah(mentah, 14, staging, pt).ok);
+  TEST_ASSERT_TRUE(staging.param.Kp_suhu == 79.0f);
+}
+
+// Gema gain hasil autotune (> PERINTAH_GAIN_MAKS) dari dokumen Control: kp/ki/kd lolos
+// s.d. AUTOTUNE_GAIN_MAKS, di atasnya ditolak walau sama dengan gain aktif
+static void test_perintah_gema_autotune() {
+  PengaturanTelemetri pt;
+  char gema[96];
+  staging = aktif;
+  snprintf(gema, sizeof(gema), "{\"kp_suhu\":12,\"kd_suhu\":%.9g}", 31234.5664f);
+  TEST_ASSERT_TRUE(parsePerintah(gema, strlen(gema), staging, pt).ok);
+  TEST_ASSERT_TRUE(staging.param.Kp_suhu == 12.0f && staging.param.Kd_suhu == 31234.5664f);
+  snprintf(gema, sizeof(gema), "{\"kp_suhu\":13,\"ki_keruh\":%.9g}", AUTOTUNE_GAIN_MAKS);
+  TEST_ASSERT_TRUE(parsePerintah(gema, strlen(gema), staging, pt).ok);
+  staging.param.Kd_suhu = 2.0f * AUTOTUNE_GAIN_MAKS;
+  snprintf(gema, sizeof(gema), "{\"kp_suhu\":14,\"kd_suhu\":%.9g}", staging.param.Kd_suhu);
+  const HasilPerintah h = parsePerintah(gema, strlen(gema), staging, pt);
+  TEST_ASSERT_FALSE(h.ok);
+  TEST_ASSERT_EQUAL_STRING("kd_suhu", h.kunci);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_lut_error_turun_monoton);
+  RUN_TEST(test_lut_nan_inf);
+  RUN_TEST(test_presisi_pid);
+  RUN_TEST(test_bank_kontrol_setara);
+  RUN_TEST(test_bank_topik_kanal);
+  RUN_TEST(test_mpc_tabel);
+  RUN_TEST(test_mpc_loop_tertutup);
+  RUN_TEST(test_aktuator_kurva_bawaan);
+  RUN_TEST(test_aktuator_dither);
+  RUN_TEST(test_aktuator_kalibrasi);
+  RUN_TEST(test_autotune_perintah);
+  RUN_TEST(test_autotune_relay);
+  RUN_TEST(test_autotune_pengaman);
+  RUN_TEST(test_bayangan_identik_dan_anggaran);
+  RUN_TEST(test_bayangan_transfer_mulus);
+  RUN_TEST(test_bayangan_perintah_dan_json);
+  RUN_TEST(test_perintah_lengkap_diterima);
+  RUN_TEST(test_perintah_rusak_ditolak);
+  RUN_TEST(test_perintah_batas_buffer);
+  RUN_TEST(test_perintah_gema_autotune);
+  return UNITY_END();
+}
@@ -0,0 +1,230 @@
+/**
+ * UJI JALUR LINTAS CORE (native, Unity)
+ * * Deskripsi:
+ * Dijalankan dengan `pio test -e native`; gagal satu assert = run gagal.
+ * Thread host menggantikan core 0 / core 1; assert hanya sesudah join.
+ * - Seqlock & antrian SPSC dengan dua thread: tidak boleh ada snapshot
+ *   sobek / data antrian yang hilang atau tertukar urutannya.
+ * - cobaBaca() Seqlock melawan penulis yang hampir selalu di tengah tulis:
+ *   harus menyerah (bukan berputar), setiap penyerahan terhitung, snapshot
+ *   lama di pemanggil tetap utuh.
+ * - Log asinkron: 4 thread produsen + 1 konsumen yang sesekali menolak
+ *   (UART penuh); urutan per produsen terjaga, diterima + dibuang = ditulis,
+ *   dan mode tunda memformat sama persis dengan snprintf.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <unity.h>
+#include "AntrianSpsc.h"
+#include "Kontrol.h"
+#include "LogAsinkron.h"
+#include "Seqlock.h"
+#include "Tick.h"
+
+void setUp() {}
+void tearDown() {}
+
+const int JUMLAH = 200000;
+
+// Penulis mengisi semua gain dengan nilai sama; pembaca menghitung snapshot campuran
+static void test_seqlock_tanpa_sobek() {
+  static Seqlock<ParameterKontrol> seq;
+  std::atomic<bool> mulai{false}, selesai{false};
+  long sobek = 0, dibaca = 0;
+
+  std::thread penulis([&] {
+    ParameterKontrol p;
+    while (!mulai) std::this_thread::yield();
+    for (int k = 1; k <= JUMLAH; k++) {
+      p.Kp_suhu = p.Ki_suhu = p.Kd_suhu = p.Kp_keruh = p.Ki_keruh = p.Kd_keruh = (double)k;
+      p.suhuSetpoint = p.turbiditySetpoint = (float)k;
+      seq.tulis(p);
+      if ((k & 63) == 0) std::this_thread::yield();  // host 1 core: beri giliran pembaca
+    }
+    selesai = true;
+  });
+  ParameterKontrol snap;
+  mulai = true;
+  while (!selesai) {
+    if (seq.baca(snap) == 0) continue;  // belum ada tulisan
+    if ((++dibaca & 63) == 0) std::this_thread::yield();
+    double k = snap.Kp_suhu;
+    if (snap.Ki_suhu != k || snap.Kd_suhu != k || snap.Kp_keruh != k || snap.Ki_keruh != k ||
+        snap.Kd_keruh != k || snap.suhuSetpoint != (float)k || snap.turbiditySetpoint != (float)k) sobek++;
+  }
+  penulis.join();
+  printf("  Seqlock 2 thread : %ld snapshot dibaca, %ld sobek\n", dibaca, sobek);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, sobek, "snapshot Seqlock sobek");
+}
+
+// Struct besar: penulis hampir selalu di tengah memcpy (nomor urut ganjil)
+struct BlokBesar {
+  uint32_t isi[64 * 1024];
+};
+
+static void test_seqlock_baca_terbatas() {
+  static Seqlock<BlokBesar> seq;
+  static BlokBesar tulisan, staging, dipakai;
+  std::atomic<bool> selesai{false};
+  seq.tulis(tulisan);   // versi pertama: semua 0
+  std::thread penulis([&] {
+    for (uint32_t k = 1; k <= 2000; k++) {
+      for (uint32_t &x : tulisan.isi) x = k;
+      seq.tulis(tulisan);
+    }
+    selesai = true;
+  });
+  uint32_t versi = 0;
+  long berhasil = 0, menyerah = 0, sobek = 0;
+  while (!selesai) {
+    if (seq.cobaBaca(staging, versi)) {
+      berhasil++;
+      dipakai = staging;
+    } else {
+      menyerah++;
+    }
+    const uint32_t k = dipakai.isi[0];
+    if (dipakai.isi[1000] != k || dipakai.isi[32 * 1024] != k || dipakai.isi[64 * 1024 - 1] != k) sobek++;
+  }
+  penulis.join();
+  printf("  Seqlock cobaBaca : %ld berhasil, %ld menyerah (terhitung %lu), %ld snapshot sobek\n", berhasil,
+         menyerah, (unsigned long)seq.jumlahGagalBaca(), sobek);
+  TEST_ASSERT_TRUE_MESSAGE(menyerah > 0, "cobaBaca tidak pernah menyerah melawan penulis yang sibuk");
+  TEST_ASSERT_TRUE(seq.jumlahGagalBaca() == (uint32_t)menyerah);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, sobek, "snapshot yang dipakai sobek");
+  uint32_t akhir = 0;
+  TEST_ASSERT_TRUE(seq.cobaBaca(staging, akhir) && staging.isi[0] == 2000 && akhir == seq.versi());
+}
+
+static void test_spsc_urut_utuh() {
+  static AntrianSpsc<Telemetri, 8> antrian;
+  unsigned long salahUrut = 0;
+  std::thread produsen([&] {
+    Telemetri t = {};
+    for (unsigned long k = 1; k <= (unsigned long)JUMLAH; k++) {
+      t.timestamp_ms = k; t.pwmSuhu = (int)(k & 255);
+      while (!antrian.kirim(t)) std::this_thread::yield();
+    }
+  });
+  Telemetri t;
+  for (unsigned long harap = 1; harap <= (unsigned long)JUMLAH;) {
+    if (!antrian.ambil(t)) continue;
+    if (t.timestamp_ms != harap || t.pwmSuhu != (int)(harap & 255)) salahUrut++;
+    harap++;
+  }
+  produsen.join();
+  printf("  SPSC 2 thread    : %d paket, %lu salah urut/rusak\n", JUMLAH, salahUrut);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, (int)salahUrut, "antrian SPSC salah urut/rusak");
+}
+
+struct KonsumenUji {
+  uint32_t terakhir[4] = {0, 0, 0, 0};
+  unsigned long diterima = 0, salahUrut = 0, dilaporkanBuang = 0, tolak = 0;
+};
+
+// Keluaran uji: sesekali menolak (buffer TX UART penuh), cek urutan per produsen
+static bool keluaranUji(const char *baris, size_t len, void *ctx) {
+  KonsumenUji &k = *(KonsumenUji *)ctx;
+  if ((++k.tolak % 7) == 0) return false;
+  unsigned long n;
+  if (sscanf(baris, "[LOG] %lu pesan dibuang", &n) == 1) {
+    k.dilaporkanBuang += n;
+    return true;
+  }
+  int p;
+  unsigned u;
+  char s[8];
+  if (sscanf(baris, "P%d #%u %7s", &p, &u, s) != 3 || p < 0 || p > 3 || u <= k.terakhir[p] ||
+      strcmp(s, "abc") != 0 || baris[len] != '\0') {
+    k.salahUrut++;
+  } else {
+    k.terakhir[p] = u;
+  }
+  k.diterima++;
+  return true;
+}
+
+// 4 produsen (2 teks, 2 tunda) + 1 konsumen
+static void test_log_banyak_produsen() {
+  static AntrianLog log;
+  const unsigned PESAN = 100000;
+  std::atomic<int> siap{0};
+  std::vector<std::thread> produsen;
+  for (int p = 0; p < 4; p++) {
+    produsen.emplace_back([&, p] {
+      char s[8];
+      siap++;
+      while (siap < 4) std::this_thread::yield();
+      for (unsigned u = 1; u <= PESAN; u++) {
+        strcpy(s, "abc");
+        if (p < 2) log.tulis(LOG_TINGKAT_INFO, "P%d #%u %s", p, u, s);
+        else log.tulisTunda(LOG_TINGKAT_INFO, "P%d #%u %s", p, u, (const char *)s);
+        strcpy(s, "XYZ");   // mode tunda harus sudah menyalin string
+        if ((u & 255) == 0) std::this_thread::yield();
+      }
+    });
+  }
+  KonsumenUji k;
+  std::atomic<bool> selesai{false};
+  std::thread konsumen([&] {
+    while (!selesai || !log.kosong() || k.dilaporkanBuang != log.jumlahTerbuang()) {
+      if (log.kuras(keluaranUji, &k) == 0) std::this_thread::yield();
+    }
+  });
+  for (std::thread &t : produsen) t.join();
+  selesai = true;
+  konsumen.join();
+  const unsigned long total = 4ul * PESAN;
+  printf("  Log 4 produsen   : %lu pesan, %lu diterima, %lu dibuang (dilaporkan %lu), %lu salah urut/rusak\n",
+         total, k.diterima, (unsigned long)log.jumlahTerbuang(), k.dilaporkanBuang, k.salahUrut);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(0, (int)k.salahUrut, "log salah urut/rusak");
+  TEST_ASSERT_TRUE_MESSAGE(k.diterima + log.jumlahTerbuang() == total, "diterima + dibuang != ditulis");
+  TEST_ASSERT_TRUE_MESSAGE(k.dilaporkanBuang == log.jumlahTerbuang(), "jumlah dibuang tidak dilaporkan utuh");
+  TEST_ASSERT_TRUE(log.jumlahDitulis() == k.diterima);
+}
+
+// Format tunda harus sama persis dengan snprintf
+static void test_log_format_tunda() {
+  struct { const char *fmt; } kasus[] = {{"%d|%5d|%-4d|%+d"}, {"%lu|%02lu:%02lu"}, {"%.2f%% (Set: %.1f)"},
+                                         {"%s=%u %c"}, {"%x %X %o"}, {"%8.3e|%g"}};
+  char harap[LOG_PANJANG], hasil[LOG_PANJANG];
+  for (auto &c : kasus) {
+    static AntrianLog satu;
+    if (c.fmt[1] == 'd') {
+      snprintf(harap, sizeof(harap), c.fmt, -7, 42, 3, 9);
+      satu.tulisTunda(0, c.fmt, -7, 42, 3, 9);
+    } else if (c.fmt[1] == 'l') {
+      snprintf(harap, sizeof(harap), c.fmt, 4000000000ul, 5ul, 9ul);
+      satu.tulisTunda(0, c.fmt, 4000000000ul, 5ul, 9ul);
+    } else if (c.fmt[1] == '.') {
+      snprintf(harap, sizeof(harap), c.fmt, 12.345f, 30.0f);
+      satu.tulisTunda(0, c.fmt, 12.345f, 30.0f);
+    } else if (c.fmt[1] == 's') {
+      snprintf(harap, sizeof(harap), c.fmt, "Fuzzy", 7u, 'k');
+      satu.tulisTunda(0, c.fmt, "Fuzzy", 7u, 'k');
+    } else if (c.fmt[1] == 'x') {
+      snprintf(harap, sizeof(harap), c.fmt, 255u, 48879u, 8u);
+      satu.tulisTunda(0, c.fmt, 255u, 48879u, 8u);
+    } else {
+      snprintf(harap, sizeof(harap), c.fmt, 1234.5678, 0.001);
+      satu.tulisTunda(0, c.fmt, 1234.5678, 0.001);
+    }
+    struct Salin { static bool f(const char *b, size_t, void *ctx) { strcpy((char *)ctx, b); return true; } };
+    satu.kuras(Salin::f, hasil);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(harap, hasil, c.fmt);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_seqlock_tanpa_sobek);
+  RUN_TEST(test_seqlock_baca_terbatas);
+  RUN_TEST(test_spsc_urut_utuh);
+  RUN_TEST(test_log_banyak_produsen);
+  RUN_TEST(test_log_format_tunda);
+  return UNITY_END();
+}
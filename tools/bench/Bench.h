@@ -0,0 +1,53 @@
+/**
+ * Utilitas benchmark native: ns/iterasi, p50/p99.
+ * Kernel kontrol terlalu cepat untuk diukur per panggilan (resolusi
+ * steady_clock), jadi waktu diambil per batch lalu dibagi ukuran batch.
+ * nama nullptr: hanya mengukur, tanpa mencetak baris.
+ */
+
+#ifndef AQUARIUM_BENCH_H
+#define AQUARIUM_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+
+// Cegah compiler membuang hasil kernel
+static volatile double benchSink = 0;
+
+struct HasilBench {
+  double nsPerIterasi;
+  double p50, p99;
+};
+
+template <typename Fn>
+HasilBench ukur(const char *nama, Fn fn, int batch = 64, int jumlahBatch = 20000) {
+  using clk = std::chrono::steady_clock;
+  std::vector<double> perBatch;
+  perBatch.reserve(jumlahBatch);
+
+  // Pemanasan cache & branch predictor
+  for (int i = 0; i < batch * 100; i++) fn(i);
+
+  long long totalNs = 0;
+  int idx = 0;
+  for (int b = 0; b < jumlahBatch; b++) {
+    auto t0 = clk::now();
+    for (int i = 0; i < batch; i++) fn(idx++);
+    auto t1 = clk::now();
+    long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    totalNs += ns;
+    perBatch.push_back((double)ns / batch);
+  }
+
+  std::sort(perBatch.begin(), perBatch.end());
+  HasilBench h;
+  h.nsPerIterasi = (double)totalNs / ((double)batch * jumlahBatch);
+  h.p50 = perBatch[perBatch.size() / 2];
+  h.p99 = perBatch[(perBatch.size() * 99) / 100];
+  if (nama) printf("%-28s %10.2f ns/iter   p50 %9.2f ns   p99 %9.2f ns\n", nama, h.nsPerIterasi, h.p50, h.p99);
+  return h;
+}
+
+#endif
@@ -0,0 +1,362 @@
+/**
+ * BENCHMARK KERNEL KONTROL (build native)
+ * * Deskripsi:
+ * Mengukur biaya setiap kernel di lib/Kontrol dan satu siklus penuh
+ * sense -> compute -> actuate -> serialize lewat HAL native. Hanya mengukur &
+ * melaporkan; ambang lulus (akurasi LUT, presisi PID, kesetaraan bank, MPC,
+ * aktuator, autotune, bayangan, perintah, kirim, log, latensi, profiler,
+ * putar ulang, penjadwal, store-and-forward, manajer koneksi, perangkat
+ * virtual) diuji di test/ lewat `pio test -e native`.
+ * - Input error diambil acak (seed tetap) di rentang kerja tiap loop.
+ * - Jam memakai SimClock; tick penuh termasuk satu sampel baru ke median
+ *   turbidity dan satu siklus state machine DS18B20.
+ * - BankKontrol (SoA): biaya per kanal (p50, termasuk linearisasi aktuator di
+ *   kedua sisi) dibandingkan dengan array ParameterKontrol+StateKontrol (AoS)
+ *   untuk N = 1, 4, 16, 64, mode campuran & tiap mode.
+ * - Log asinkron: biaya di pemanggil (teks vs tunda) vs task log.
+ * Ukuran kode per kernel: lihat tools/bench/ukuran_kode.sh.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "AntrianSpsc.h"
+#include "BankKontrol.h"
+#include "Bench.h"
+#include "HalNative.h"
+#include "KanalUji.h"
+#include "Kontrol.h"
+#include "LogAsinkron.h"
+#include "MpcEksplisit.h"
+#include "MedianGeser.h"
+#include "Penjadwal.h"
+#include "PerintahKontrol.h"
+#include "Profil.h"
+#include "Seqlock.h"
+#include "SiklusCpu.h"
+#include "Simulasi.h"
+#include "TelemetriBiner.h"
+#include "Sensor.h"
+#include "Tick.h"
+
+static std::vector<float> buatInput(int n, float lo, float hi, unsigned seed) {
+  std::vector<float> v(n);
+  srand(seed);
+  for (int i = 0; i < n; i++) v[i] = lo + (hi - lo) * (float)rand() / (float)RAND_MAX;
+  return v;
+}
+
+// modeTetap < 0: mode campuran parameterKanal(); selain itu semua kanal mode tsb
+template <int N>
+static void ukurBank(int modeTetap, double &nsBank, double &nsAos) {
+  static BankKontrol<N> bank;
+  static TangkiAos aos[N];
+  unsigned long now = 0;
+  bank.mulai(now);
+  for (int k = 0; k < N; k++) {
+    ParameterKontrol p = parameterKanal(k);
+    if (modeTetap >= 0) p.kontrolAktif = (ControlMode)modeTetap;
+    bank.setParameter(k, p);
+    aos[k].p = p;
+    resetPID(aos[k].st, now);
+  }
+  // Bergantian, p50 terkecil dari 3 putaran: derau mesin host sebesar selisihnya
+  unsigned long nowB = 0, nowA = 0;
+  nsBank = nsAos = 1e30;
+  for (int ulang = 0; ulang < 3; ulang++) {
+    const HasilBench b = ukur(nullptr, [&](int i) {
+      nowB += 1000;
+      for (int k = 0; k < N; k++) {
+        bank.suhu[k] = suhuUji(k, i);
+        bank.turbidityAdc[k] = adcUji(k, i);
+      }
+      bank.hitung(nowB);
+      benchSink = benchSink + bank.pwmSuhu[N - 1] + bank.pwmKeruh[0];
+    }, 8, 32000 / N);
+    const HasilBench a = ukur(nullptr, [&](int i) {
+      nowA += 1000;
+      double s = 0, kk = 0;
+      int ps = 0, pk = 0;
+      for (int k = 0; k < N; k++) hitungAos(aos[k], suhuUji(k, i), adcUji(k, i), nowA, s, kk, ps, pk);
+      benchSink = benchSink + ps + pk;
+    }, 8, 32000 / N);
+    nsBank = fmin(nsBank, b.p50 / N);
+    nsAos = fmin(nsAos, a.p50 / N);
+  }
+}
+
+// Biaya per kanal (p50): campuran, lalu semua kanal satu mode. Hanya dilaporkan, tidak ada ambang lulus
+static void ukurBankKontrol() {
+  const char *namaUkur[] = {"campur", "Fuzzy", "PID", "MPC"};
+  for (int m = -1; m < 3; m++) {
+    double b[4], a[4];
+    ukurBank<1>(m, b[0], a[0]);
+    ukurBank<4>(m, b[1], a[1]);
+    ukurBank<16>(m, b[2], a[2]);
+    ukurBank<64>(m, b[3], a[3]);
+    printf("  ns/kanal SoA|AoS %-6s: N=1 %.1f|%.1f  N=4 %.1f|%.1f  N=16 %.1f|%.1f  N=64 %.1f|%.1f\n", namaUkur[m + 1],
+           b[0], a[0], b[1], a[1], b[2], a[2], b[3], a[3]);
+  }
+}
+
+// Dokumen Control backend (startup sync) + rule base keruh
+static const char PERINTAH_LENGKAP[] =
+  "{\"kontrol_aktif\":\"PID\",\"suhu_setpoint\":27.5,\"kp_suhu\":9,\"ki_suhu\":0.25,\"kd_suhu\":5.5,"
+  "\"keruh_setpoint\":10,\"kp_keruh\":5,\"ki_keruh\":0.2,\"kd_keruh\":2,\"kp_turbo_keruh\":35,"
+  "\"ambang_turbo_keruh\":2,\"keruh_tahan\":11,\"keruh_mati\":9,\"fuzzy_lut_suhu\":true,"
+  "\"fuzzy_lut_keruh\":false,\"fuzzy_pd_suhu\":false,\"resolusi_suhu\":11,\"telemetri_biner\":true,"
+  "\"batch_sampel\":20,\"batch_interval_ms\":5000,\"adc_jernih\":20100,\"adc_keruh\":3550,"
+  "\"catatan\":{\"oleh\":\"dashboard\",\"tag\":[1,2,{\"x\":null}]},\"fuzzy_suhu_pd\":null,"
+  "\"fuzzy_keruh\":{\"mf\":[[-9,-9,-7,-5],[-7,-4,-2,-1],[-2.5,-0.5,0.5,2.5],[1,4,7,10],[8,12,12,12]],"
+  "\"out\":[5,20,50,90,100],\"default\":50}}";
+
+static void ukurPerintah() {
+  static KonfigurasiKontrol aktif = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  static KonfigurasiKontrol staging;
+  PengaturanTelemetri pt;
+  staging = aktif;
+  const char kecil[] = "{\"kontrol_aktif\":\"PID\",\"kp_suhu\":9,\"ki_suhu\":0.25,\"kd_suhu\":5.5}";
+  ukur("parsePerintah (4 kunci)", [&](int) {
+    benchSink = benchSink + parsePerintah(kecil, sizeof(kecil) - 1, staging, pt).berubah;
+  });
+  ukur("parsePerintah (doc+rule+LUT)", [&](int) {
+    staging.param = aktif.param;
+    benchSink = benchSink + parsePerintah(PERINTAH_LENGKAP, sizeof(PERINTAH_LENGKAP) - 1, staging, pt).berubah;
+  }, 4, 2000);
+}
+
+static bool keluaranBuang(const char *baris, size_t len, void *) {
+  benchSink = benchSink + (double)len + baris[0];
+  return true;
+}
+
+// Log asinkron: biaya per pesan di sisi pemanggil vs task log vs UART 115200 baud yang memblok
+static void ukurLog() {
+  static AntrianLog log;
+  using clk = std::chrono::steady_clock;
+  const float suhu = 27.43f, set = 28.0f, err = -0.57f;
+  for (int tunda = 0; tunda < 2; tunda++) {
+    long long nsTulis = 0, nsKuras = 0;
+    const int PUTARAN = 20000, PER = 32;
+    for (int r = 0; r < PUTARAN; r++) {
+      auto t0 = clk::now();
+      for (int i = 0; i < PER; i++) {
+        if (tunda) log.tulisTunda(LOG_TINGKAT_DEBUG, "[TEMP]      Current: %.2f°C (Set: %.1f°C) | Error: %.2f", suhu, set, err + i);
+        else log.tulis(LOG_TINGKAT_DEBUG, "[TEMP]      Current: %.2f°C (Set: %.1f°C) | Error: %.2f", suhu, set, err + i);
+      }
+      auto t1 = clk::now();
+      log.kuras(keluaranBuang, nullptr);
+      auto t2 = clk::now();
+      nsTulis += std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+      nsKuras += std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count();
+    }
+    printf("  Log %-5s        : pemanggil %7.1f ns/pesan, task log %7.1f ns/pesan\n", tunda ? "tunda" : "teks",
+           (double)nsTulis / (PUTARAN * PER), (double)nsKuras / (PUTARAN * PER));
+  }
+  // cetakDebug lama: ~700 byte per sampel dikirim langsung ke UART (10 bit/byte)
+  printf("  Serial.printf lama: ~700 byte/sampel = %.1f ms memblok task jaringan di 115200 baud\n", 700 * 10 * 1000.0 / 115200);
+}
+
+static void ukurProfil() {
+  printf("\n== Profiler ==\n");
+  static Profil prof;
+  Hal tanpa = {};
+  Hal dengan = {};
+  dengan.profil = &prof;
+  ukur("lingkup profil (nullptr)", [&](int i) {
+    PROFIL_LINGKUP(tanpa, PROFIL_HITUNG_SUHU);
+    benchSink = benchSink + i;
+  });
+  ukur("lingkup profil (aktif)", [&](int i) {
+    PROFIL_LINGKUP(dengan, PROFIL_HITUNG_SUHU);
+    benchSink = benchSink + i;
+  });
+}
+
+static unsigned long jumlahLoop[3];
+
+static void ukurPenjadwal() {
+  SimClock jam;
+  SimTimer timer(jam);
+  Penjadwal<3> jadwal;
+  jadwal.tambah("cepat", 2000, 0, [] { jumlahLoop[0]++; });
+  jadwal.tambah("sedang", 250000, 1000, [] { jumlahLoop[1]++; });
+  jadwal.tambah("lambat", 1000000, 3000, [] { jumlahLoop[2]++; });
+  timer.mulai(1000);
+  jadwal.mulai((uint32_t)jam.micros());
+  for (int k = 0; k < 60000; k++) {   // 60 s tick 1 ms
+    jadwal.jalankan(jam);
+    timer.tunggu();
+  }
+  // Biaya satu tick penjadwal (tanpa loop jatuh tempo vs rata-rata campuran)
+  ukur("Penjadwal.jalankan (tick)", [&](int) {
+    timer.tunggu();
+    benchSink = benchSink + jadwal.jalankan(jam);
+  });
+}
+
+int main() {
+  const int N = 4096; // pangkat 2, indeks pakai mask
+  std::vector<float> errSuhu = buatInput(N, -6.0f, 6.0f, 1);
+  std::vector<float> errKeruh = buatInput(N, -10.0f, 15.0f, 2);
+
+  ParameterKontrol p;
+  StateKontrol st;
+
+  printf("=== BENCHMARK KERNEL KONTROL (native) ===\n");
+
+  ukur("hitungFuzzySuhu", [&](int i) { benchSink = benchSink + hitungFuzzySuhu(errSuhu[i & (N - 1)]); });
+  ukur("hitungFuzzyKeruh", [&](int i) { benchSink = benchSink + hitungFuzzyKeruh(errKeruh[i & (N - 1)]); });
+
+  // PD-fuzzy dua input (25 aturan)
+  StateKontrol stPD;
+  unsigned long nowPD = 0;
+  ukur("hitungFuzzySuhuPD", [&](int i) {
+    nowPD += 1000;
+    benchSink = benchSink + hitungFuzzySuhuPD(stPD, aturanFuzzy, errSuhu[i & (N - 1)], nowPD);
+  });
+
+  // Mode LUT: resolusi default + error maksimum vs jalur eksak per resolusi
+  const AturanFuzzy &af = aturanFuzzy;
+  ukur("lutSuhu.hitung", [&](int i) { benchSink = benchSink + af.lutSuhu.hitung(errSuhu[i & (N - 1)]); });
+  ukur("lutKeruh.hitung", [&](int i) { benchSink = benchSink + af.lutKeruh.hitung(errKeruh[i & (N - 1)]); });
+
+  unsigned long now = 0;
+  resetPID(st, now);
+  ukur("hitungPIDSuhu", [&](int i) {
+    now += 1000;
+    benchSink = benchSink + hitungPIDSuhu(st, p, errSuhu[i & (N - 1)], now);
+  });
+  ukur("hitungPIDKeruh", [&](int i) {
+    now += 1000;
+    benchSink = benchSink + hitungPIDKeruh(st, p, errKeruh[i & (N - 1)], now);
+  });
+
+  // Mesin PID per tipe angka (ns native + siklus CPU, bandingkan dengan -DBENCH_PID di ESP32)
+  StatePid<double> pidD;
+  StatePid<float> pidF;
+  StatePid<Q16> pidQ;
+  const GainPid<double> gD = {8.0, 0.3, 6.0};
+  const GainPid<float> gF = {8.0f, 0.3f, 6.0f};
+  const GainPid<Q16> gQ = {Q16(8.0), Q16(0.3), Q16(6.0)};
+  ukur("pidSuhu<double>", [&](int i) { now += 1000; benchSink = benchSink + pidSuhu(pidD, gD, errSuhu[i & (N - 1)], now); });
+  ukur("pidSuhu<float>", [&](int i) { now += 1000; benchSink = benchSink + pidSuhu(pidF, gF, errSuhu[i & (N - 1)], now); });
+  ukur("pidSuhu<Q16>", [&](int i) {
+    now += 1000;
+    benchSink = benchSink + (double)pidSuhu(pidQ, gQ, errSuhu[i & (N - 1)], now);
+  });
+  // MPC eksplisit: point location saja, lalu observer + lookup (jalur firmware)
+  StateMpc stMpc;
+  ukur("evaluasiTabelMpc", [&](int i) {
+    benchSink = benchSink + evaluasiTabelMpc(TABEL_MPC, errSuhu[i & (N - 1)], errKeruh[i & (N - 1)] * 4.0f + 40.0f);
+  });
+  ukur("hitungMpcSuhu", [&](int i) {
+    now += 1000;
+    benchSink = benchSink + hitungMpcSuhu(stMpc, TABEL_MPC, 28.0f - errSuhu[i & (N - 1)] * 0.1f, 28.0f, now);
+  });
+  const SiklusPid sd = ukurSiklusPid<double>(100000), sf = ukurSiklusPid<float>(100000), sq = ukurSiklusPid<Q16>(100000);
+  printf("  siklus/panggilan suhu|keruh: double %u|%u  float %u|%u  Q16 %u|%u\n",
+         (unsigned)sd.suhu, (unsigned)sd.keruh, (unsigned)sf.suhu, (unsigned)sf.keruh, (unsigned)sq.suhu, (unsigned)sq.keruh);
+  printf("  MPC tabel %u byte (%u wilayah, terburuk %u bidang/lookup), LUT fuzzy %u byte/loop, StateMpc %u byte, "
+         "StatePid %u byte\n", (unsigned)ukuranTabelMpc(TABEL_MPC), (unsigned)TABEL_MPC.jumlahWilayah,
+         (unsigned)TABEL_MPC.maksBidang, (unsigned)sizeof(aturanFuzzy.lutSuhu), (unsigned)sizeof(StateMpc),
+         (unsigned)sizeof(StatePid<AngkaPid>));
+  ukurBankKontrol();
+
+  // Filter turbidity: median geser per sampel vs sort 20 sampel lama (per tick)
+  std::vector<int16_t> adcAcak(N);
+  for (int i = 0; i < N; i++) adcAcak[i] = (int16_t)(3000 + rand() % 18000);
+  MedianGeser<TURBIDITY_JENDELA_MAKS> median;
+  median.reset(TURBIDITY_JENDELA);
+  ukur("MedianGeser.tambah (n=21)", [&](int i) { median.tambah(adcAcak[i & (N - 1)]); benchSink = benchSink + median.median(); });
+  median.reset(TURBIDITY_JENDELA_MAKS);
+  ukur("MedianGeser.tambah (n=63)", [&](int i) { median.tambah(adcAcak[i & (N - 1)]); benchSink = benchSink + median.median(); });
+  ukur("bubble sort 20 (lama)", [&](int i) {
+    int buffer[20];
+    for (int k = 0; k < 20; k++) buffer[k] = adcAcak[(i * 20 + k) & (N - 1)];
+    for (int a = 0; a < 19; a++)
+      for (int b = a + 1; b < 20; b++)
+        if (buffer[a] > buffer[b]) { int tmp = buffer[a]; buffer[a] = buffer[b]; buffer[b] = tmp; }
+    benchSink = benchSink + buffer[10];
+  }, 16);
+
+  // Jalur lintas core: snapshot parameter lengkap (+ rule base & LUT) dan telemetri
+  static Seqlock<KonfigurasiKontrol> konfig;
+  static KonfigurasiKontrol snapshot = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  konfig.tulis(snapshot);
+  printf("  KonfigurasiKontrol: %u byte\n", (unsigned)sizeof(KonfigurasiKontrol));
+  ukur("Seqlock.versi", [&](int) { benchSink = benchSink + konfig.versi(); });
+  uint32_t versiKonfig = 0;
+  ukur("Seqlock.cobaBaca (param+rule)", [&](int) {
+    benchSink = benchSink + konfig.cobaBaca(snapshot, versiKonfig) + versiKonfig;
+  }, 16);
+  static AntrianSpsc<Telemetri, 8> antrian;
+  Telemetri tk = {};
+  ukur("AntrianSpsc kirim+ambil", [&](int i) {
+    tk.timestamp_ms = i;
+    antrian.kirim(tk);
+    antrian.ambil(tk);
+    benchSink = benchSink + tk.timestamp_ms;
+  });
+  ukurPerintah();
+  ukurLog();
+  ukurProfil();
+  ukurPenjadwal();
+
+  // Siklus penuh lewat HAL native
+  SimClock clock;
+  NativeAdc adc;
+  NativeSuhu suhu;
+  NativePwm pwm;
+  NativeMqtt mqtt;
+  Hal hal = {&clock, &adc, &suhu, &pwm, &mqtt};
+  SensorAquarium sensor;
+  sensor.turbidity.mulai(adc, TURBIDITY_JENDELA, TURBIDITY_SPS);
+  sensor.suhu.mulai(suhu, SUHU_RESOLUSI);
+  Telemetri t;
+  char buffer[512];
+
+  const ControlMode mode[2] = {FUZZY, PID};
+  const char *namaTick[2] = {"tick penuh (Fuzzy)", "tick penuh (PID)"};
+  for (int m = 0; m < 2; m++) {
+    p.kontrolAktif = mode[m];
+    resetPID(st, clock.millis());
+    ukur(namaTick[m], [&](int i) {
+      clock.maju(1000);
+      suhu.suhu = p.suhuSetpoint - errSuhu[i & (N - 1)];
+      adc.konversi((int16_t)(p.NILAI_ADC_JERNIH - (p.NILAI_ADC_JERNIH - p.NILAI_ADC_KERUH) *
+                             (p.turbiditySetpoint + errKeruh[i & (N - 1)]) / 100.0f));
+      sensor.turbidity.layani(adc);
+      while (!sensor.suhu.layani(suhu, clock.millis())) {}
+      tickKontrol(hal, sensor, p, st, t);
+      benchSink = benchSink + serializeTelemetri(t, buffer, sizeof(buffer));
+    }, 16, 20000);
+  }
+
+  // Format telemetri: JSON per sampel vs record biner dalam batch
+  BatchTelemetri batch;
+  size_t bytesJson = serializeTelemetri(t, buffer, sizeof(buffer));
+  ukur("serializeTelemetri (JSON)", [&](int i) {
+    t.timestamp_ms = i;
+    benchSink = benchSink + serializeTelemetri(t, buffer, sizeof(buffer));
+  });
+  clock.epochAwalUs = 1760000000000000ULL;   // jam pengganti SNTP: umur stempel ikut diserialisasi
+  TitikWaktu wk = TitikWaktu::sekarang(clock);
+  ukur("serializeTelemetri + waktu", [&](int i) {
+    wk.us += i;
+    benchSink = benchSink + serializeTelemetri(t, buffer, sizeof(buffer), &wk);
+  });
+  ukur("BatchTelemetri.tambah", [&](int i) {
+    t.timestamp_ms = i;
+    if (batch.penuh()) batch.reset();
+    benchSink = benchSink + batch.tambah(t, i);
+  });
+  printf("  JSON %u byte/sampel, biner %u byte/sampel (+%u header/batch, batch %d = %u byte)\n",
+         (unsigned)bytesJson, (unsigned)TELEMETRI_BINER_RECORD, (unsigned)TELEMETRI_BINER_HEADER,
+         TELEMETRI_BATCH_MAKS, (unsigned)TELEMETRI_BINER_UKURAN_MAKS);
+
+  return 0;
+}
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Ukuran kode (byte) tiap kernel kontrol dari sebuah ELF.
+#   ESP32 : tools/bench/ukuran_kode.sh .pio/build/esp32dev/firmware.elf xtensa-esp32-elf-nm
+#   Native: tools/bench/ukuran_kode.sh .pio/build/native/program
+ELF=${1:-.pio/build/esp32dev/firmware.elf}
+NM=${2:-nm}
+
+if [ ! -f "$ELF" ]; then
+  echo "ELF tidak ditemukan: $ELF" >&2
+  exit 1
+fi
+
+"$NM" -S -C --size-sort "$ELF" | awk '
+  function hex(s,   i, n) {
+    n = 0
+    for (i = 1; i <= length(s); i++) n = n * 16 + index("0123456789abcdef", tolower(substr(s, i, 1))) - 1
+    return n
+  }
+  / [tTwW] / && /hitungFuzzy|FuzzySugeno|FuzzyLut|hitungPID|pidSuhu|pidKeruh|hitungKontrol|tickKontrol|serializeTelemetri|bacaSuhu|bacaTurbidity|setHeaterSpeed|setPumpSpeed/ {
+    size = hex($2); total += size
+    $1 = ""; $2 = ""; $3 = ""
+    printf "%8d  %s\n", size, substr($0, 4)
+  }
+  END { printf "%8d  TOTAL\n", total }'
@@ -0,0 +1,638 @@
+/**
+ * GENERATOR BEBAN: RIBUAN PERANGKAT VIRTUAL KE SATU BROKER MQTT
+ * * Deskripsi:
+ * Tiap perangkat virtual = TangkiVirtual (plant + loop kontrol firmware
+ * yang sama, lib/Simulasi) + koneksi MQTT sendiri (KlienMqtt) dengan client
+ * ID & topik per perangkat (TopikPerangkat), berjalan mengikuti jam dinding.
+ * - Perangkat dibagi rata ke -j thread. Tiap thread satu event loop: epoll
+ *   untuk socket yang siap + antrian prioritas tangki yang jatuh tempo.
+ * - Jalur kirim sama dengan loopMqtt firmware: snapshot -> KebijakanKirim ->
+ *   kirimTelemetri (JSON) atau batch biner. Default tiap --periode-ms
+ *   (kirim pintar mati); --pintar = report-by-exception firmware (snapshot
+ *   250 ms). Perintah di <id>/mode & siaran <prefix>/mode di-parse
+ *   parsePerintah, diterapkan, lalu digemakan ke <id>/gema.
+ * - Jumlah perangkat dinaikkan per tahap (--tahap); tiap tahap: sambung,
+ *   pemanasan, lalu jendela ukur. Satu pelanggan terpisah (thread sendiri)
+ *   berlangganan <prefix>/+/data|batch|gema seperti backend.
+ * - --broker host:port ke broker luar (mosquitto / EMQX, mis. bersama
+ *   backend: laporan server di /api/latensi); tanpa itu broker minimal
+ *   bawaan (lib/Simulasi/MqttSoket.h) jalan di thread sendiri.
+ *   pio run -e farm && .pio/build/farm/program [--tahap 100,500,1000,2000]
+ *       [--durasi s] [--pemanasan s] [-j thread] [--periode-ms ms | --pintar]
+ *       [--biner] [--perintah-ms ms] [--buffer byte] [--broker host:port]
+ *       [--prefix topik] [--csv berkas]
+ * Keluaran per tahap: pesan/detik terkirim & diterima pelanggan, latensi
+ * publish -> pelanggan (kirim_ms di payload vs jam dinding) p50/p99/maks,
+ * waktu tunggu di buffer keluar klien (p99), lag event loop (p99), publish
+ * ditolak (buffer keluar penuh / offline = backpressure), pesan dibuang
+ * broker (antrian pelanggan penuh, broker bawaan), putus, beban CPU kontrol.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "JamDinding.h"
+#include "KebijakanKirim.h"
+#include "MqttSoket.h"
+#include "PerintahKontrol.h"
+#include "Simulasi.h"
+#include "TelemetriBiner.h"
+#include "TopikPerangkat.h"
+
+struct OpsiFarm {
+  std::string host = "127.0.0.1";
+  uint16_t port = 0;              // 0 = broker bawaan
+  std::vector<int> tahap = {100, 500, 1000, 2000};
+  double durasiS = 10.0, pemanasanS = 2.0;
+  int jumlahThread = 1;
+  uint32_t periodeMs = 1000;
+  bool pintar = false, biner = false;
+  uint32_t perintahMs = 0;        // 0 = tanpa perintah siaran
+  size_t buffer = 16384;          // buffer keluar per perangkat
+  std::string prefix = MQTT_PREFIX;
+};
+
+static OpsiFarm opsi;
+static std::atomic<bool> selesai{false};
+
+// Jam dinding bersama: satu pasangan (monoton, epoch) dibaca saat mulai, supaya
+// pengirim & pelanggan membandingkan kirim_ms dengan jam yang sama
+static uint64_t monoAwal = 0, epochAwal = 0;
+static uint64_t epochSekarangUs() { return epochAwal + (jamMonotonUs() - monoAwal); }
+
+static uint32_t persentil(std::vector<uint32_t> &v, double q) {
+  if (v.empty()) return 0;
+  const size_t i = std::min(v.size() - 1, (size_t)(q * v.size()));
+  std::nth_element(v.begin(), v.begin() + i, v.end());
+  return v[i];
+}
+
+static uint32_t maks(const std::vector<uint32_t> &v) {
+  return v.empty() ? 0 : *std::max_element(v.begin(), v.end());
+}
+
+// =========================================================================
+//                  PERANGKAT VIRTUAL & THREAD PEKERJA
+// =========================================================================
+
+struct Perangkat {
+  explicit Perangkat(size_t buffer) : mqtt(buffer) {}
+
+  TangkiVirtual tangki;
+  KlienMqtt mqtt;
+  TopikPerangkat topik;
+  KebijakanKirim kebijakan;
+  PengaturanTelemetri pt;
+  BatchTelemetri batch;
+  PelacakPerintah pelacak;
+  uint32_t indeks = 0;
+  uint64_t awalMono = 0;          // jam tangki 0
+  uint64_t snapshotBerikut = 0;   // jam tangki (us)
+  uint64_t jadwal = 0;            // jatuh tempo berikutnya (monoton); entri antrian lain = basi
+  uint64_t sambungLagi = 0;       // monoton
+  bool tulisTerpasang = false;
+};
+
+class Pekerja {
+public:
+  explicit Pekerja(int id) : id(id) {}
+  void mulai() { t = std::thread(&Pekerja::jalan, this); }
+  void gabung() {
+    if (t.joinable()) t.join();
+  }
+
+  // Diatur thread utama
+  std::atomic<int> target{0};
+  // Dibaca thread utama (kumulatif)
+  std::atomic<int> jumlah{0};
+  std::atomic<uint64_t> terkirim{0}, ditolak{0}, ditekan{0}, gagalSambung{0}, putus{0}, gema{0}, cpuKontrolUs{0};
+  std::mutex m;
+  std::vector<uint32_t> antrianUs, lagUs;   // sampel sejak diambil terakhir
+
+private:
+  void jalan();
+  void tambahPerangkat(uint64_t now);
+  bool sambungkan(Perangkat &p, uint64_t now);
+  void langkah(Perangkat &p, uint64_t now);
+  void kirimSnapshot(Perangkat &p);
+  void perintah(Perangkat &p, const uint8_t *payload, size_t len);
+  void terbitkanGema(Perangkat &p, const GemaPerintah &g);
+  void aturTulis(Perangkat &p);
+  void jadwalkan(Perangkat &p, uint64_t mono);
+
+  int id;
+  std::thread t;
+  int ep = -1;
+  std::vector<std::unique_ptr<Perangkat>> perangkat;
+  typedef std::pair<uint64_t, uint32_t> Entri;
+  std::priority_queue<Entri, std::vector<Entri>, std::greater<Entri>> antrian;
+  std::vector<uint32_t> lokalAntrian, lokalLag;
+  KonfigurasiKontrol staging;
+};
+
+void Pekerja::jadwalkan(Perangkat &p, uint64_t mono) {
+  p.jadwal = mono;
+  antrian.push(Entri(mono, p.indeks));
+}
+
+void Pekerja::aturTulis(Perangkat &p) {
+  const bool mau = p.mqtt.connected() && p.mqtt.adaTertunda();
+  if (mau == p.tulisTerpasang || !p.mqtt.connected()) return;
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  if (mau) ev.events |= EPOLLOUT;
+  ev.data.u32 = p.indeks;
+  epoll_ctl(ep, EPOLL_CTL_MOD, p.mqtt.fd(), &ev);
+  p.tulisTerpasang = mau;
+}
+
+bool Pekerja::sambungkan(Perangkat &p, uint64_t now) {
+  if (!p.mqtt.sambung(p.topik.clientId())) {
+    gagalSambung++;
+    p.sambungLagi = now + 1000000;
+    return false;
+  }
+  p.mqtt.subscribe(p.topik[TOPIK_MODE]);
+  p.mqtt.subscribe(p.topik.modeSemua);
+  epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.u32 = p.indeks;
+  epoll_ctl(ep, EPOLL_CTL_ADD, p.mqtt.fd(), &ev);
+  p.tulisTerpasang = false;
+  aturTulis(p);
+  return true;
+}
+
+void Pekerja::tambahPerangkat(uint64_t now) {
+  const uint32_t nomor = (uint32_t)perangkat.size() * opsi.jumlahThread + id;   // unik lintas thread
+  std::unique_ptr<Perangkat> baru(new Perangkat(opsi.buffer));
+  Perangkat &p = *baru;
+  p.indeks = (uint32_t)perangkat.size();
+  char idPerangkat[ID_PERANGKAT_MAKS];
+  snprintf(idPerangkat, sizeof(idPerangkat), "farm-%06u", (unsigned)nomor);
+  p.topik.mulai(opsi.prefix.c_str(), idPerangkat);
+
+  // Tiap tangki sedikit beda (kondisi awal, derau) supaya deadband tidak serempak
+  ParameterKontrol param;
+  ParameterPlant plant;
+  p.awalMono = now;
+  p.tangki.mulai(param, plant, 25.0 + (nomor % 7) * 0.5, 10.0 + (nomor % 11), 24.0, nomor + 1,
+                 epochAwal + (now - monoAwal));
+  p.tangki.hal().mqtt = &p.mqtt;
+  p.pt.biner = opsi.biner;
+  p.pt.kirim.aktif = opsi.pintar;
+  // Periode tetap: toleransi 10% supaya jitter jadwal tidak menekan snapshot
+  if (!opsi.pintar) p.pt.kirim.intervalNormalMs = opsi.periodeMs - opsi.periodeMs / 10;
+  p.batch.sesi = 1;
+  p.mqtt.catatanAntrian = &lokalAntrian;
+  p.mqtt.setServer(opsi.host.c_str(), opsi.port);
+  Perangkat *pp = &p;
+  p.mqtt.pendengar = [this, pp](const char *, const uint8_t *payload, size_t len) { perintah(*pp, payload, len); };
+
+  perangkat.push_back(std::move(baru));
+  jumlah.store((int)perangkat.size(), std::memory_order_relaxed);
+  sambungkan(p, now);
+  // Fasa acak dalam satu periode supaya publish tidak serempak
+  const uint64_t periodeUs = (opsi.pintar ? KIRIM_INTERVAL_CEPAT_MS : opsi.periodeMs) * 1000ULL;
+  p.snapshotBerikut = (nomor * 7919ULL) % periodeUs;
+  jadwalkan(p, p.awalMono + p.snapshotBerikut);
+}
+
+void Pekerja::terbitkanGema(Perangkat &p, const GemaPerintah &g) {
+  char buffer[256];
+  if (serializeGemaPerintah(g, TitikWaktu::sekarang(*p.tangki.hal().clock), buffer, sizeof(buffer)) > 0 &&
+      p.mqtt.connected() && p.mqtt.publish(p.topik[TOPIK_GEMA], buffer, false))
+    gema++;
+}
+
+// Sama dengan callback + awal taskKontrol firmware (tanpa seqlock: satu thread).
+// Rule base fuzzy tangki virtual = aturanFuzzy global, perintah aturan tidak diterapkan.
+void Pekerja::perintah(Perangkat &p, const uint8_t *payload, size_t len) {
+  p.tangki.majuKe(jamMonotonUs() - p.awalMono);
+  HalClock &jam = *p.tangki.hal().clock;
+  staging.param = p.tangki.param();
+  const uint32_t nomorReset = staging.nomorResetPID, nomorPerintah = staging.nomorPerintah;
+  PengaturanTelemetri ptBaru = p.pt;
+  const uint32_t t0 = (uint32_t)jam.micros();
+  const HasilPerintah h = parsePerintah((const char *)payload, len, staging, ptBaru);
+  if (h.berubah & (PERINTAH_ATURAN | PERINTAH_ATURAN_PD)) staging.aturan = aturanFuzzy;
+  if (!h.ok) {
+    if (h.id != 0) terbitkanGema(p, gemaDitolak(h, t0));
+    return;
+  }
+  p.tangki.param() = staging.param;
+  p.pt = ptBaru;
+  if (staging.nomorPerintah != nomorPerintah) {
+    if (p.pelacak.menunggu) terbitkanGema(p, p.pelacak.g);
+    p.pelacak.mulai(staging.idPerintah, t0, (uint32_t)jam.micros());
+  }
+  if (staging.nomorResetPID != nomorReset) {
+    if (staging.param.modeBayangan && staging.param.transferMulus)
+      mulaiTransferMulus(p.tangki.state(), p.tangki.param(), jam.millis());
+    else resetPID(p.tangki.state(), jam.millis());
+  }
+  // Gema menunggu aktuasi kedua loop: majukan tiap 10 ms (PERIODE_MQTT_MS firmware)
+  const uint64_t cepat = jamMonotonUs() + 10000;
+  if (p.pelacak.menunggu && p.jadwal > cepat) jadwalkan(p, cepat);
+}
+
+void Pekerja::kirimSnapshot(Perangkat &p) {
+  Hal &hal = p.tangki.hal();
+  Telemetri t = p.tangki.telemetri();
+  t.timestamp_ms = hal.clock->millis();
+  if (p.kebijakan.putuskan(t, p.pt.kirim) == KIRIM_DITEKAN) {
+    ditekan++;
+    return;
+  }
+  bool ok;
+  if (p.pt.biner) {
+    p.batch.tambah(t, t.timestamp_ms);
+    if (!p.batch.perluFlush(t.timestamp_ms, p.pt.batchSampel, p.pt.batchIntervalMs)) return;
+    ok = kirimBatchTelemetri(hal, p.topik[TOPIK_BATCH], p.batch);
+    // Firmware: isi batch pindah ke simpan-terus; di sini dihitung ditolak saja
+    if (!ok && (p.batch.penuh() || !p.mqtt.connected())) p.batch.reset();
+  } else {
+    ok = kirimTelemetri(hal, p.topik[TOPIK_DATA], t);
+  }
+  (ok ? terkirim : ditolak)++;
+}
+
+void Pekerja::langkah(Perangkat &p, uint64_t now) {
+  if (!p.mqtt.connected() && now >= p.sambungLagi) sambungkan(p, now);
+  const uint64_t rel = now - p.awalMono;
+  const uint64_t t0 = jamMonotonUs();
+  p.tangki.majuKe(rel);
+  cpuKontrolUs.fetch_add(jamMonotonUs() - t0, std::memory_order_relaxed);
+
+  const Telemetri &tel = p.tangki.telemetri();
+  if (p.pelacak.catat(tel.stempelSuhu, tel.stempelKeruh)) terbitkanGema(p, p.pelacak.g);
+  if (rel >= p.snapshotBerikut) {
+    const uint64_t periodeUs = (opsi.pintar ? KIRIM_INTERVAL_CEPAT_MS : opsi.periodeMs) * 1000ULL;
+    p.snapshotBerikut += periodeUs;
+    if (p.snapshotBerikut <= rel) p.snapshotBerikut = rel + periodeUs;   // tertinggal jauh: lewati
+    kirimSnapshot(p);
+  }
+  aturTulis(p);
+
+  uint64_t berikut = p.snapshotBerikut;
+  if (p.pelacak.menunggu && rel + 10000 < berikut) berikut = rel + 10000;
+  jadwalkan(p, p.awalMono + berikut);
+}
+
+void Pekerja::jalan() {
+  ep = epoll_create1(EPOLL_CLOEXEC);
+  staging = KonfigurasiKontrol();
+  staging.aturan = aturanFuzzy;
+  epoll_event ev[256];
+  uint64_t laporBerikut = 0;
+
+  while (!selesai.load(std::memory_order_relaxed)) {
+    uint64_t now = jamMonotonUs();
+    // Sambung bertahap: CONNECT memblok s.d. CONNACK, perangkat lama tetap dilayani
+    for (int i = 0; i < 16 && (int)perangkat.size() < target.load(std::memory_order_relaxed); i++)
+      tambahPerangkat(jamMonotonUs());
+
+    int timeoutMs = 10;
+    if ((int)perangkat.size() < target.load(std::memory_order_relaxed)) timeoutMs = 0;
+    else if (!antrian.empty()) {
+      const uint64_t tempo = antrian.top().first;
+      timeoutMs = tempo <= now ? 0 : (int)std::min<uint64_t>(10, (tempo - now) / 1000);
+    }
+    const int n = epoll_wait(ep, ev, 256, timeoutMs);
+    for (int i = 0; i < n; i++) {
+      Perangkat &p = *perangkat[ev[i].data.u32];
+      if (!p.mqtt.layani()) {
+        putus++;
+        p.tulisTerpasang = false;
+        p.sambungLagi = jamMonotonUs() + 1000000;
+      } else {
+        aturTulis(p);
+      }
+    }
+
+    now = jamMonotonUs();
+    while (!antrian.empty() && antrian.top().first <= now) {
+      const Entri e = antrian.top();
+      antrian.pop();
+      Perangkat &p = *perangkat[e.second];
+      if (e.first != p.jadwal) continue;   // sudah dijadwal ulang lebih cepat
+      lokalLag.push_back((uint32_t)(now - e.first));
+      langkah(p, now);
+      now = jamMonotonUs();
+    }
+
+    if (now >= laporBerikut) {
+      laporBerikut = now + 100000;
+      std::lock_guard<std::mutex> kunci(m);
+      antrianUs.insert(antrianUs.end(), lokalAntrian.begin(), lokalAntrian.end());
+      lagUs.insert(lagUs.end(), lokalLag.begin(), lokalLag.end());
+      lokalAntrian.clear();
+      lokalLag.clear();
+    }
+  }
+  perangkat.clear();
+  close(ep);
+}
+
+// =========================================================================
+//                  PELANGGAN (PERAN BACKEND)
+// =========================================================================
+
+class Pelanggan {
+public:
+  bool mulai() {
+    mqtt.setServer(opsi.host.c_str(), opsi.port);
+    if (!mqtt.sambung("farm-pelanggan")) return false;
+    for (const char *nama : {"data", "batch", "gema"}) {
+      const std::string f = opsi.prefix + "/+/" + nama;
+      mqtt.subscribe(f.c_str());
+    }
+    mqtt.pendengar = [this](const char *topik, const uint8_t *payload, size_t len) { terima(topik, payload, len); };
+    t = std::thread(&Pelanggan::jalan, this);
+    return true;
+  }
+  void gabung() {
+    if (t.joinable()) t.join();
+  }
+
+  std::atomic<uint64_t> diterima{0}, gema{0};
+  std::mutex m;
+  std::vector<uint32_t> latensiUs, latensiGemaUs;
+
+private:
+  static bool akhiran(const char *s, const char *a) {
+    const size_t ns = strlen(s), na = strlen(a);
+    return ns >= na && strcmp(s + ns - na, a) == 0;
+  }
+
+  void catat(std::vector<uint32_t> &v, double epochMs) {
+    const double us = (double)epochSekarangUs() - epochMs * 1000.0;
+    std::lock_guard<std::mutex> kunci(m);
+    v.push_back(us > 0 ? (uint32_t)std::min(us, 4e9) : 0);
+  }
+
+  void terima(const char *topik, const uint8_t *payload, size_t len) {
+    if (akhiran(topik, "/gema")) {
+      const std::string s((const char *)payload, len);
+      const char *p = strstr(s.c_str(), "\"id\":");
+      if (!p) return;
+      auto it = kirimPerintah.find((uint32_t)strtoul(p + 5, nullptr, 10));
+      if (it == kirimPerintah.end()) return;
+      gema++;
+      catat(latensiGemaUs, it->second / 1000.0);
+      return;
+    }
+    diterima++;
+    if (akhiran(topik, "/batch")) {
+      if (len < TELEMETRI_BINER_HEADER || payload[2] < 3) return;
+      uint64_t epochMs = 0;
+      for (int i = 7; i >= 0; i--) epochMs = (epochMs << 8) | payload[12 + i];
+      if (epochMs != 0) catat(latensiUs, (double)epochMs);
+      return;
+    }
+    const std::string s((const char *)payload, len);
+    const char *p = strstr(s.c_str(), "\"kirim_ms\":");
+    if (!p) return;
+    char *akhir = nullptr;
+    const double kirimMs = strtod(p + 11, &akhir);
+    if (akhir != p + 11) catat(latensiUs, kirimMs);
+  }
+
+  void jalan() {
+    uint64_t perintahBerikut = jamMonotonUs() + opsi.perintahMs * 1000ULL;
+    uint32_t idPerintah = 1;
+    const std::string topikSiaran = opsi.prefix + "/mode";
+    while (!selesai.load(std::memory_order_relaxed)) {
+      mqtt.layani();
+      if (!mqtt.connected()) {
+        fprintf(stderr, "[farm] pelanggan putus dari broker\n");
+        return;
+      }
+      // Perintah siaran: setpoint bolak-balik, gema dari tiap perangkat
+      if (opsi.perintahMs && jamMonotonUs() >= perintahBerikut) {
+        perintahBerikut += opsi.perintahMs * 1000ULL;
+        char buf[96];
+        snprintf(buf, sizeof(buf), "{\"id_perintah\":%u,\"suhu_setpoint\":%.1f}", (unsigned)idPerintah,
+                 (idPerintah & 1) ? 28.5 : 28.0);
+        kirimPerintah[idPerintah] = epochSekarangUs();
+        mqtt.publish(topikSiaran.c_str(), buf, false);
+        idPerintah++;
+        while (kirimPerintah.size() > 64) kirimPerintah.erase(kirimPerintah.begin());
+      }
+      usleep(1000);
+    }
+  }
+
+  KlienMqtt mqtt{1u << 20};
+  std::thread t;
+  std::map<uint32_t, uint64_t> kirimPerintah;   // id -> epoch us publish
+};
+
+// =========================================================================
+//                  UTAMA
+// =========================================================================
+
+struct Rekap {
+  uint64_t terkirim = 0, ditolak = 0, ditekan = 0, gagalSambung = 0, putus = 0, gema = 0, cpuUs = 0;
+  uint64_t diterima = 0, gemaDiterima = 0, dibuangBroker = 0;
+};
+
+static Rekap rekap(std::vector<std::unique_ptr<Pekerja>> &pekerja, Pelanggan &pel, BrokerMqtt *broker) {
+  Rekap r;
+  for (auto &p : pekerja) {
+    r.terkirim += p->terkirim;
+    r.ditolak += p->ditolak;
+    r.ditekan += p->ditekan;
+    r.gagalSambung += p->gagalSambung;
+    r.putus += p->putus;
+    r.gema += p->gema;
+    r.cpuUs += p->cpuKontrolUs;
+  }
+  r.diterima = pel.diterima;
+  r.gemaDiterima = pel.gema;
+  if (broker) r.dibuangBroker = broker->stat.dibuang;
+  return r;
+}
+
+static void tidur(double detik) {
+  std::this_thread::sleep_for(std::chrono::microseconds((int64_t)(detik * 1e6)));
+}
+
+int main(int argc, char **argv) {
+  opsi.jumlahThread = std::max(1, (int)std::thread::hardware_concurrency() - 2);   // sisa: broker & pelanggan
+  const char *pathCsv = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) opsi.jumlahThread = std::max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--tahap") && i + 1 < argc) {
+      opsi.tahap.clear();
+      for (char *s = argv[++i]; *s;) {
+        opsi.tahap.push_back(std::max(1, (int)strtol(s, &s, 10)));
+        if (*s == ',') s++;
+        else if (*s) break;
+      }
+    } else if (!strcmp(argv[i], "--durasi") && i + 1 < argc) opsi.durasiS = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--pemanasan") && i + 1 < argc) opsi.pemanasanS = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--periode-ms") && i + 1 < argc) opsi.periodeMs = std::max(10, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--pintar")) opsi.pintar = true;
+    else if (!strcmp(argv[i], "--biner")) opsi.biner = true;
+    else if (!strcmp(argv[i], "--perintah-ms") && i + 1 < argc) opsi.perintahMs = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--buffer") && i + 1 < argc) opsi.buffer = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--prefix") && i + 1 < argc) opsi.prefix = argv[++i];
+    else if (!strcmp(argv[i], "--csv") && i + 1 < argc) pathCsv = argv[++i];
+    else if (!strcmp(argv[i], "--broker") && i + 1 < argc) {
+      const std::string b = argv[++i];
+      const size_t titikDua = b.rfind(':');
+      opsi.host = b.substr(0, titikDua);
+      opsi.port = titikDua == std::string::npos ? 1883 : (uint16_t)atoi(b.c_str() + titikDua + 1);
+    } else {
+      fprintf(stderr,
+              "pakai: %s [--tahap 100,500,1000] [--durasi s] [--pemanasan s] [-j thread] [--periode-ms ms | "
+              "--pintar] [--biner] [--perintah-ms ms] [--buffer byte] [--broker host:port] [--prefix topik] "
+              "[--csv berkas]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  std::sort(opsi.tahap.begin(), opsi.tahap.end());
+
+  // Satu socket per perangkat (+ satu sisi broker bawaan)
+  const int perluFd = opsi.tahap.back() * (opsi.port ? 1 : 2) + 64;
+  rlimit lim;
+  if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < (rlim_t)perluFd) {
+    lim.rlim_cur = std::min<rlim_t>(lim.rlim_max, perluFd);
+    setrlimit(RLIMIT_NOFILE, &lim);
+    getrlimit(RLIMIT_NOFILE, &lim);
+    if (lim.rlim_cur < (rlim_t)perluFd)
+      fprintf(stderr, "[farm] batas berkas terbuka %lu < %d: tahap besar akan gagal sambung (ulimit -n)\n",
+              (unsigned long)lim.rlim_cur, perluFd);
+  }
+
+  monoAwal = jamMonotonUs();
+  epochAwal = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+  std::unique_ptr<BrokerMqtt> broker;
+  if (opsi.port == 0) {
+    broker.reset(new BrokerMqtt());
+    if (!broker->mulai("127.0.0.1", 0)) {
+      fprintf(stderr, "[farm] broker bawaan gagal mulai: %s\n", strerror(errno));
+      return 1;
+    }
+    opsi.port = broker->port();
+  }
+  printf("Broker %s:%u%s | prefix %s | %d thread | %s | %s%s\n", opsi.host.c_str(), (unsigned)opsi.port,
+         broker ? " (bawaan)" : "", opsi.prefix.c_str(), opsi.jumlahThread, opsi.biner ? "batch biner" : "JSON",
+         opsi.pintar ? "kirim pintar (snapshot 250 ms)" : "periode tetap ",
+         opsi.pintar ? "" : (std::to_string(opsi.periodeMs) + " ms").c_str());
+
+  Pelanggan pelanggan;
+  if (!pelanggan.mulai()) {
+    fprintf(stderr, "[farm] pelanggan gagal sambung ke broker\n");
+    return 1;
+  }
+  std::vector<std::unique_ptr<Pekerja>> pekerja;
+  for (int i = 0; i < opsi.jumlahThread; i++) {
+    pekerja.emplace_back(new Pekerja(i));
+    pekerja.back()->mulai();
+  }
+
+  FILE *csv = pathCsv ? fopen(pathCsv, "w") : nullptr;
+  if (csv)
+    fprintf(csv, "perangkat,kirim_per_s,terima_per_s,lat_p50_ms,lat_p99_ms,lat_maks_ms,antre_p99_ms,lag_p99_ms,"
+                 "ditolak,dibuang_broker,putus,gagal_sambung,gema_p99_ms,cpu_kontrol_persen\n");
+  printf("\n%9s %9s %9s %8s %8s %8s %9s %8s %8s %8s %6s %8s %7s\n", "perangkat", "kirim/s", "terima/s", "lat_p50",
+         "lat_p99", "lat_maks", "antre_p99", "lag_p99", "ditolak", "dibuang", "putus", "gema_p99", "cpu%");
+  printf("%9s %9s %9s %8s %8s %8s %9s %8s %8s %8s %6s %8s %7s\n", "", "", "", "(ms)", "(ms)", "(ms)", "(ms)", "(ms)",
+         "", "broker", "", "(ms)", "kontrol");
+
+  for (int n : opsi.tahap) {
+    const int t = (int)pekerja.size();
+    for (int i = 0; i < t; i++) pekerja[i]->target = n / t + (i < n % t ? 1 : 0);
+    const auto batas = std::chrono::steady_clock::now() + std::chrono::seconds(120);
+    for (;;) {
+      int ada = 0;
+      for (auto &p : pekerja) ada += p->jumlah;
+      if (ada >= n) break;
+      if (std::chrono::steady_clock::now() > batas) {
+        fprintf(stderr, "[farm] hanya %d/%d perangkat dibuat dalam 120 s\n", ada, n);
+        break;
+      }
+      tidur(0.05);
+    }
+    tidur(opsi.pemanasanS);
+
+    // Jendela ukur: buang sampel pemanasan
+    for (auto &p : pekerja) {
+      std::lock_guard<std::mutex> kunci(p->m);
+      p->antrianUs.clear();
+      p->lagUs.clear();
+    }
+    {
+      std::lock_guard<std::mutex> kunci(pelanggan.m);
+      pelanggan.latensiUs.clear();
+      pelanggan.latensiGemaUs.clear();
+    }
+    const Rekap awal = rekap(pekerja, pelanggan, broker.get());
+    const uint64_t monoMulai = jamMonotonUs();
+    tidur(opsi.durasiS);
+    const Rekap akhir = rekap(pekerja, pelanggan, broker.get());
+    const double detik = (jamMonotonUs() - monoMulai) / 1e6;
+
+    std::vector<uint32_t> antre, lag, lat, latGema;
+    for (auto &p : pekerja) {
+      std::lock_guard<std::mutex> kunci(p->m);
+      antre.insert(antre.end(), p->antrianUs.begin(), p->antrianUs.end());
+      lag.insert(lag.end(), p->lagUs.begin(), p->lagUs.end());
+    }
+    {
+      std::lock_guard<std::mutex> kunci(pelanggan.m);
+      lat.swap(pelanggan.latensiUs);
+      latGema.swap(pelanggan.latensiGemaUs);
+    }
+    const double kirimPerS = (akhir.terkirim - awal.terkirim) / detik;
+    const double terimaPerS = (akhir.diterima - awal.diterima) / detik;
+    const double cpu = 100.0 * (akhir.cpuUs - awal.cpuUs) / (detik * 1e6);
+    const unsigned long ditolak = (unsigned long)(akhir.ditolak - awal.ditolak);
+    const unsigned long dibuang = (unsigned long)(akhir.dibuangBroker - awal.dibuangBroker);
+    const unsigned long putus = (unsigned long)(akhir.putus - awal.putus);
+    const unsigned long gagal = (unsigned long)(akhir.gagalSambung - awal.gagalSambung);
+    const double latP50 = persentil(lat, 0.5) / 1000.0, latP99 = persentil(lat, 0.99) / 1000.0;
+    const double latMaks = maks(lat) / 1000.0, antreP99 = persentil(antre, 0.99) / 1000.0;
+    const double lagP99 = persentil(lag, 0.99) / 1000.0, gemaP99 = persentil(latGema, 0.99) / 1000.0;
+
+    char kolomGema[16];
+    if (latGema.empty()) snprintf(kolomGema, sizeof(kolomGema), "-");
+    else snprintf(kolomGema, sizeof(kolomGema), "%.2f", gemaP99);
+    printf("%9d %9.0f %9.0f %8.2f %8.2f %8.2f %9.2f %8.2f %8lu %8lu %6lu %8s %7.1f\n", n, kirimPerS, terimaPerS, latP50,
+           latP99, latMaks, antreP99, lagP99, ditolak, dibuang, putus, kolomGema, cpu);
+    if (gagal) printf("%9s gagal sambung: %lu\n", "", gagal);
+    fflush(stdout);
+    if (csv)
+      fprintf(csv, "%d,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%lu,%lu,%lu,%lu,%.3f,%.2f\n", n, kirimPerS, terimaPerS, latP50,
+              latP99, latMaks, antreP99, lagP99, ditolak, dibuang, putus, gagal, gemaP99, cpu);
+  }
+
+  const Rekap total = rekap(pekerja, pelanggan, broker.get());
+  printf("\nTotal: %lu publish telemetri, %lu ditekan kebijakan, %lu diterima pelanggan, %lu gema\n",
+         (unsigned long)total.terkirim, (unsigned long)total.ditekan, (unsigned long)total.diterima,
+         (unsigned long)total.gemaDiterima);
+  selesai = true;
+  for (auto &p : pekerja) p->gabung();
+  pelanggan.gabung();
+  if (csv) fclose(csv);
+  return 0;
+}
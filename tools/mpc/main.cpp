@@ -0,0 +1,112 @@
+/**
+ * GENERATOR TABEL MPC EKSPLISIT (build native)
+ * * Deskripsi:
+ * Menyelesaikan QP MPC loop suhu secara offline untuk model tangki
+ * (ParameterPlant, lib/Simulasi/MpcEksplisit.h) lalu menulis tabel wilayah
+ * / hukum yang dipakai firmware (lib/Kontrol/TabelMpc.cpp).
+ * - Verifikasi: output tabel (evaluator firmware, float) dibandingkan dengan
+ *   solusi QP daring (coordinate descent, double) di titik acak kotak (e, h).
+ * - Dicetak: jumlah wilayah / hukum, byte tabel, uji terburuk per lookup.
+ *   pio run -e mpc && .pio/build/mpc/program [--horizon n] [--ts detik] [--q bobot]
+ *       [--r bobot] [--emaks C] [--sel ExH] [--periksa n] [--keluar lib/Kontrol/TabelMpc.cpp]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "MpcEksplisit.h"
+
+int main(int argc, char **argv) {
+  SpesifikasiMpc spek;
+  const char *pathKeluar = nullptr;
+  int jumlahPeriksa = 2000;
+  std::string perintah = "tools/mpc";
+
+  for (int i = 1; i < argc; i++) {
+    const bool adaNilai = i + 1 < argc;
+    if (!strcmp(argv[i], "--horizon") && adaNilai) spek.horizon = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--ts") && adaNilai) spek.tsDetik = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--q") && adaNilai) spek.bobotError = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--r") && adaNilai) spek.bobotInput = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--emaks") && adaNilai) {
+      spek.eMax = atof(argv[++i]);
+      spek.eMin = -spek.eMax;
+    }
+    else if (!strcmp(argv[i], "--sel") && adaNilai) {
+      if (sscanf(argv[++i], "%dx%d", &spek.selE, &spek.selH) != 2) spek.selE = 0;
+    }
+    else if (!strcmp(argv[i], "--periksa") && adaNilai) jumlahPeriksa = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--keluar") && adaNilai) {
+      pathKeluar = argv[++i];
+      continue;
+    }
+    else {
+      fprintf(stderr, "pakai: %s [--horizon n] [--ts detik] [--q bobot] [--r bobot] [--emaks C] [--sel ExH]\n"
+                      "          [--periksa n] [--keluar berkas.cpp]\n",
+              argv[0]);
+      return 1;
+    }
+    perintah += std::string(" ") + argv[i - 1] + " " + argv[i];
+  }
+
+  ParameterPlant plant;
+  GeneratorMpc gen;
+  auto t0 = std::chrono::steady_clock::now();
+  if (!gen.bangun(plant, spek)) {
+    fprintf(stderr, "gagal: %s\n", gen.galat());
+    return 1;
+  }
+  const double msBangun = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+  const TabelMpc &t = gen.tabel();
+  const StatistikMpc &s = gen.statistik();
+
+  printf("=== MPC EKSPLISIT LOOP SUHU ===\n");
+  printf("horizon %d x %.0f s, q %g, r %g -> gain tak terbatas %.2f %%/C\n", spek.horizon, spek.tsDetik,
+         spek.bobotError, spek.bobotInput, s.gainTakTerbatas);
+  printf("%u himpunan aktif -> %u wilayah, %u bidang, %u hukum (%.1f ms)\n", s.himpunanAktif,
+         (unsigned)t.jumlahWilayah, (unsigned)t.jumlahBidang, (unsigned)t.jumlahHukum, msBangun);
+  printf("grid %ux%u: %u sel langsung, kandidat %u byte, terburuk %u wilayah / %u bidang per lookup\n",
+         (unsigned)t.selE, (unsigned)t.selH, s.selLangsung, (unsigned)t.jumlahKandidat, (unsigned)t.maksKandidat,
+         (unsigned)t.maksBidang);
+  printf("tabel %zu byte | observer: gain Kalman air %.3g, probe %.3g, ruang %.3g\n", ukuranTabelMpc(t),
+         t.kalman[0], t.kalman[1], t.kalman[2]);
+
+  // Tabel (float) vs QP daring (double) di titik acak
+  uint32_t x = 12345;
+  auto acak = [&x]() {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (double)x / 4294967296.0;
+  };
+  double bedaMaks = 0.0, eMaks = 0.0, hMaks = 0.0;
+  for (int i = 0; i < jumlahPeriksa; i++) {
+    const double e = t.eMin + (t.eMax - t.eMin) * acak(), h = t.hMax * acak();
+    const double d = fabs(evaluasiTabelMpc(t, (float)e, (float)h) - gen.solusiDaring(e, h));
+    if (d > bedaMaks) bedaMaks = d, eMaks = e, hMaks = h;
+  }
+  printf("tabel vs QP daring (%d titik): selisih maks %.5f%% (e %.3f, h %.1f)\n", jumlahPeriksa, bedaMaks, eMaks,
+         hMaks);
+
+  volatile float tampung = 0.0f;
+  const int ulang = 2000000;
+  auto t1 = std::chrono::steady_clock::now();
+  for (int i = 0; i < ulang; i++) tampung = tampung + evaluasiTabelMpc(t, -3.5f + 7.0f * (i & 1023) / 1024.0f, (float)(i % 97));
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t1).count() / ulang;
+  printf("lookup %.1f ns\n", ns);
+
+  if (pathKeluar) {
+    FILE *f = fopen(pathKeluar, "w");
+    if (!f) {
+      fprintf(stderr, "gagal menulis %s\n", pathKeluar);
+      return 1;
+    }
+    gen.tulisSumber(f, perintah.c_str());
+    fclose(f);
+    printf("ditulis: %s\n", pathKeluar);
+  }
+  return bedaMaks < 0.05 ? 0 : 2;
+}
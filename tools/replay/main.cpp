@@ -0,0 +1,214 @@
+/**
+ * PUTAR ULANG DATA RISET (build native, uji regresi kontroler)
+ * * Deskripsi:
+ * Mengalirkan jejak research_data yang terekam (CSV /api/export/csv/range
+ * atau JSONL mongoexport) ke kernel Fuzzy / PID / MPC firmware dengan parameter
+ * kandidat, lalu membandingkan output tiap sampel dengan yang terekam.
+ * - Berkas di-mmap & diurai tanpa salinan (lib/Simulasi/Replay.h). Tiap
+ *   berkas dipotong di celah waktu menjadi segmen bebas; semua segmen dari
+ *   semua berkas dibagi ke semua core lewat KolamKerja (work-stealing).
+ * - Kandidat: --param berisi dokumen JSON yang sama dengan payload
+ *   MQTT_TOPIC_MODE (mis. keluaran tools/tune --keluar), diurai parser
+ *   firmware; --mode memaksa satu mode untuk seluruh jejak.
+ * - Keluaran per berkas: jumlah sampel/segmen, selisih output heater &
+ *   pompa (MAE, RMS, maks + waktunya, % sampel > toleransi) dan rata-rata
+ *   output terekam vs kandidat (proksi energi). --beda menulis sampel yang
+ *   selisihnya > toleransi ke <awalan>_<nama_berkas>.csv.
+ *   pio run -e replay && .pio/build/replay/program [-j thread] [--param berkas.json]
+ *       [--mode rekam|fuzzy|pid|mpc] [--celah detik] [--toleransi persen] [--tanpa-sublangkah]
+ *       [--beda awalan] [--csv ringkasan.csv] jejak.csv|jejak.jsonl ...
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "KolamKerja.h"
+#include "PerintahKontrol.h"
+#include "Replay.h"
+#include "Sensor.h"
+
+struct TugasSegmen {
+  size_t berkas;
+  SegmenJejak segmen;
+  HasilReplay hasil;
+  std::string beda;
+};
+
+// Dokumen Control / payload MQTT_TOPIC_MODE -> konfigurasi kandidat (validasi sama dengan firmware)
+static bool bacaParam(const char *path, KonfigurasiKontrol &konf) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    fprintf(stderr, "gagal membuka %s\n", path);
+    return false;
+  }
+  std::string isi;
+  char buf[4096];
+  for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) isi.append(buf, n);
+  fclose(f);
+  PengaturanTelemetri pt;
+  HasilPerintah h = parsePerintah(isi.data(), isi.size(), konf, pt);
+  if (!h.ok) {
+    fprintf(stderr, "%s ditolak: %s%s%s\n", path, h.alasan, h.kunci[0] ? " pada " : "", h.kunci);
+    return false;
+  }
+  return true;
+}
+
+// "data/mei.jsonl" -> "mei_jsonl" (CSV & JSONL dari rentang yang sama tidak saling timpa)
+static std::string namaDasar(const char *path) {
+  const char *a = strrchr(path, '/');
+  std::string n = a ? a + 1 : path;
+  for (char &c : n)
+    if (c == '.') c = '_';
+  return n;
+}
+
+static void cetakMetrik(const char *loop, const MetrikSelisih &m, double toleransi) {
+  if (m.jumlah == 0) {
+    printf("  %-6s tanpa output terekam\n", loop);
+    return;
+  }
+  printf("  %-6s MAE %7.3f  RMS %7.3f  maks %7.2f (t=%lld)  >%.2f: %6.2f%%  rata rekam %6.2f -> ulang %6.2f\n",
+         loop, m.mae(), m.rms(), m.maks, (long long)m.msMaks, toleransi, 100.0 * m.beda / m.jumlah,
+         m.totalRekam / m.jumlah, m.totalUlang / m.jumlah);
+}
+
+int main(int argc, char **argv) {
+  int jumlahThread = (int)std::thread::hardware_concurrency();
+  const char *pathParam = nullptr;
+  const char *awalanBeda = nullptr;
+  const char *pathCsv = nullptr;
+  uint32_t celahMs = REPLAY_CELAH_MS;
+  OpsiReplay opsi;
+  std::vector<const char *> pathJejak;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) jumlahThread = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--param") && i + 1 < argc) pathParam = argv[++i];
+    else if (!strcmp(argv[i], "--mode") && i + 1 < argc) {
+      const char *m = argv[++i];
+      if (!strcmp(m, "rekam")) opsi.paksaMode = false;
+      else if (!strcmp(m, "fuzzy")) opsi.paksaMode = true, opsi.mode = FUZZY;
+      else if (!strcmp(m, "pid")) opsi.paksaMode = true, opsi.mode = PID;
+      else if (!strcmp(m, "mpc")) opsi.paksaMode = true, opsi.mode = MPC;
+      else {
+        fprintf(stderr, "mode tidak dikenal: %s (rekam, fuzzy, pid, mpc)\n", m);
+        return 1;
+      }
+    }
+    else if (!strcmp(argv[i], "--celah") && i + 1 < argc) celahMs = (uint32_t)(atof(argv[++i]) * 1000.0);
+    else if (!strcmp(argv[i], "--toleransi") && i + 1 < argc) opsi.toleransi = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--tanpa-sublangkah")) opsi.subLangkahKeruh = false;
+    else if (!strcmp(argv[i], "--beda") && i + 1 < argc) awalanBeda = argv[++i];
+    else if (!strcmp(argv[i], "--csv") && i + 1 < argc) pathCsv = argv[++i];
+    else if (argv[i][0] != '-') pathJejak.push_back(argv[i]);
+    else {
+      pathJejak.clear();
+      break;
+    }
+  }
+  if (pathJejak.empty()) {
+    fprintf(stderr, "pakai: %s [-j thread] [--param berkas.json] [--mode rekam|fuzzy|pid|mpc] [--celah detik]\n"
+                    "          [--toleransi persen] [--tanpa-sublangkah] [--beda awalan] [--csv berkas]\n"
+                    "          jejak.csv|jejak.jsonl ...\n",
+            argv[0]);
+    return 1;
+  }
+  if (jumlahThread < 1) jumlahThread = 1;
+
+  // Kandidat: default firmware, ditimpa --param. Rule base & LUT hanya dibaca thread.
+  static KonfigurasiKontrol konf = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT, SUHU_RESOLUSI, 0};
+  if (pathParam && !bacaParam(pathParam, konf)) return 1;
+  opsi.param = konf.param;
+  opsi.aturan = &konf.aturan;
+
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::unique_ptr<BerkasJejak>> berkas;
+  std::vector<TugasSegmen> tugas;
+  size_t totalByte = 0;
+  for (size_t i = 0; i < pathJejak.size(); i++) {
+    berkas.emplace_back(new BerkasJejak());
+    if (!berkas[i]->buka(pathJejak[i])) {
+      fprintf(stderr, "%s: %s\n", pathJejak[i], berkas[i]->galat());
+      return 1;
+    }
+    totalByte += berkas[i]->ukuran();
+    for (const SegmenJejak &s : berkas[i]->indeks(celahMs)) tugas.push_back({i, s, HasilReplay(), std::string()});
+  }
+  const double detikIndeks = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  KolamKerja kolam(jumlahThread);
+  auto t1 = std::chrono::steady_clock::now();
+  kolam.paralel(tugas.size(), [&](size_t i) {
+    TugasSegmen &t = tugas[i];
+    t.hasil = putarUlangSegmen(*berkas[t.berkas], t.segmen, opsi, awalanBeda ? &t.beda : nullptr);
+  });
+  const double detikPutar = std::chrono::duration<double>(std::chrono::steady_clock::now() - t1).count();
+
+  // Gabung urut segmen: hasil sama persis berapa pun jumlah thread
+  std::vector<HasilReplay> perBerkas(berkas.size());
+  HasilReplay total;
+  for (const TugasSegmen &t : tugas) perBerkas[t.berkas].gabung(t.hasil);
+  for (const HasilReplay &h : perBerkas) total.gabung(h);
+
+  printf("=== PUTAR ULANG DATA RISET (%d thread) | mode %s | toleransi %.2f%% ===\n", jumlahThread,
+         opsi.paksaMode ? namaMode(opsi.mode) : "rekaman", opsi.toleransi);
+  for (size_t i = 0; i < berkas.size(); i++) {
+    const HasilReplay &h = perBerkas[i];
+    printf("%s [%s]: %llu sampel, %llu segmen, %llu ganti mode, %llu ditolak, %llu waktu kembar\n", pathJejak[i],
+           berkas[i]->format() == JEJAK_CSV ? "CSV" : "JSONL", (unsigned long long)h.sampel,
+           (unsigned long long)h.segmen, (unsigned long long)h.gantiMode, (unsigned long long)h.ditolak,
+           (unsigned long long)h.kembar);
+    cetakMetrik("heater", h.suhu, opsi.toleransi);
+    cetakMetrik("pompa", h.keruh, opsi.toleransi);
+  }
+  if (berkas.size() > 1) {
+    printf("TOTAL: %llu sampel, %llu segmen\n", (unsigned long long)total.sampel, (unsigned long long)total.segmen);
+    cetakMetrik("heater", total.suhu, opsi.toleransi);
+    cetakMetrik("pompa", total.keruh, opsi.toleransi);
+  }
+  printf("\nindeks %.3f s, putar ulang %.3f s: %.2f juta sampel/s, %.0f MB/s, %llu tugas dicuri\n", detikIndeks,
+         detikPutar, total.sampel / detikPutar / 1e6, totalByte / detikPutar / 1e6,
+         (unsigned long long)kolam.jumlahCurian());
+
+  if (awalanBeda) {
+    for (size_t i = 0; i < berkas.size(); i++) {
+      const std::string path = std::string(awalanBeda) + "_" + namaDasar(pathJejak[i]) + ".csv";
+      FILE *f = fopen(path.c_str(), "w");
+      if (!f) {
+        fprintf(stderr, "gagal menulis %s\n", path.c_str());
+        return 1;
+      }
+      fprintf(f, "waktu_ms,mode,out_suhu_rekam,out_suhu_ulang,out_keruh_rekam,out_keruh_ulang\n");
+      for (const TugasSegmen &t : tugas)
+        if (t.berkas == i) fwrite(t.beda.data(), 1, t.beda.size(), f);
+      fclose(f);
+    }
+  }
+  if (pathCsv) {
+    FILE *f = fopen(pathCsv, "w");
+    if (!f) {
+      fprintf(stderr, "gagal menulis %s\n", pathCsv);
+      return 1;
+    }
+    fprintf(f, "berkas,sampel,segmen,ditolak,mae_heater,rms_heater,maks_heater,beda_heater,rata_rekam_heater,"
+               "rata_ulang_heater,mae_pompa,rms_pompa,maks_pompa,beda_pompa,rata_rekam_pompa,rata_ulang_pompa\n");
+    for (size_t i = 0; i < berkas.size(); i++) {
+      const HasilReplay &h = perBerkas[i];
+      const MetrikSelisih &s = h.suhu, &k = h.keruh;
+      fprintf(f, "%s,%llu,%llu,%llu,%.4f,%.4f,%.3f,%llu,%.3f,%.3f,%.4f,%.4f,%.3f,%llu,%.3f,%.3f\n", pathJejak[i],
+              (unsigned long long)h.sampel, (unsigned long long)h.segmen, (unsigned long long)h.ditolak, s.mae(),
+              s.rms(), s.maks, (unsigned long long)s.beda, s.jumlah ? s.totalRekam / s.jumlah : 0.0,
+              s.jumlah ? s.totalUlang / s.jumlah : 0.0, k.mae(), k.rms(), k.maks, (unsigned long long)k.beda,
+              k.jumlah ? k.totalRekam / k.jumlah : 0.0, k.jumlah ? k.totalUlang / k.jumlah : 0.0);
+    }
+    fclose(f);
+  }
+  return 0;
+}
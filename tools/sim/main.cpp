@@ -0,0 +1,167 @@
+/**
+ * SIMULATOR PLANT AQUARIUM (build native, lebih cepat dari waktu nyata)
+ * * Deskripsi:
+ * Membandingkan varian kontroler (Fuzzy eksak / LUT / PD-fuzzy, PID, MPC) pada
+ * skenario bawaan lib/Simulasi (step setpoint, ayunan suhu ruang, lonjakan
+ * kekeruhan, ...). Tiap pasangan skenario x kontroler = satu pekerjaan,
+ * dibagi ke semua core lewat antrian atomik. Semua kontroler dalam satu
+ * skenario memakai seed derau yang sama.
+ *   pio run -e sim && .pio/build/sim/program [-j thread] [-s skenario]
+ *       [-k kontroler] [--skala x] [--csv berkas] [--jejak awalan]
+ * --jejak menulis telemetri firmware per detik ke <awalan>_<skenario>_<kontroler>.csv.
+ * Keluaran per loop: IAE/ISE (dari nilai plant sebenarnya), overshoot,
+ * settling (pita 0.5 C / 2 %), energi heater/pompa.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Simulasi.h"
+
+struct VarianKontroler {
+  const char *nama;
+  ControlMode mode;
+  MesinFuzzy mesinSuhu, mesinKeruh;
+};
+
+static const VarianKontroler VARIAN[] = {
+  {"Fuzzy", FUZZY, FUZZY_EKSAK, FUZZY_EKSAK},
+  {"Fuzzy-LUT", FUZZY, FUZZY_LUT, FUZZY_LUT},
+  {"Fuzzy-PD", FUZZY, FUZZY_PD, FUZZY_EKSAK},
+  {"PID", PID, FUZZY_EKSAK, FUZZY_EKSAK},
+  {"MPC", MPC, FUZZY_EKSAK, FUZZY_EKSAK},
+};
+static const int JUMLAH_VARIAN = sizeof(VARIAN) / sizeof(VARIAN[0]);
+
+struct Pekerjaan {
+  const Skenario *skenario;
+  const VarianKontroler *varian;
+  HasilSimulasi hasil;
+};
+
+static void tulisJejak(const Telemetri &t, void *ctx) {
+  fprintf((FILE *)ctx, "%lu,%.3f,%.3f,%d,%.2f,%.2f,%.3f,%.3f\n", t.timestamp_ms / 1000, t.suhu, t.turbidityPersen,
+          t.turbidityAdc, t.outSuhu, t.outKeruh, t.setpointSuhu, t.setpointKeruh);
+}
+
+static void cetakSettling(char *buf, size_t len, double detik) {
+  if (detik < 0) snprintf(buf, len, "%s", "-");
+  else snprintf(buf, len, "%.0f", detik / 60.0);
+}
+
+int main(int argc, char **argv) {
+  int jumlahThread = (int)std::thread::hardware_concurrency();
+  const char *filter = nullptr;
+  const char *filterKontroler = nullptr;
+  const char *awalanJejak = nullptr;
+  const char *pathCsv = nullptr;
+  OpsiSimulasi opsi;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) jumlahThread = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-s") && i + 1 < argc) filter = argv[++i];
+    else if (!strcmp(argv[i], "-k") && i + 1 < argc) filterKontroler = argv[++i];
+    else if (!strcmp(argv[i], "--jejak") && i + 1 < argc) awalanJejak = argv[++i];
+    else if (!strcmp(argv[i], "--skala") && i + 1 < argc) opsi.skalaDurasi = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--csv") && i + 1 < argc) pathCsv = argv[++i];
+    else {
+      fprintf(stderr, "pakai: %s [-j thread] [-s skenario] [-k kontroler] [--skala x] [--csv berkas] [--jejak awalan]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (jumlahThread < 1) jumlahThread = 1;
+
+  std::vector<Pekerjaan> kerja;
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++) {
+    if (filter && strcmp(filter, SKENARIO_STANDAR[s].nama) != 0) continue;
+    for (int v = 0; v < JUMLAH_VARIAN; v++) {
+      if (filterKontroler && strcmp(filterKontroler, VARIAN[v].nama) != 0) continue;
+      kerja.push_back({&SKENARIO_STANDAR[s], &VARIAN[v], HasilSimulasi()});
+    }
+  }
+  if (kerja.empty()) {
+    fprintf(stderr, "skenario / kontroler tidak dikenal\n");
+    return 1;
+  }
+
+  // LUT dipanggang sekali sebelum thread jalan (aturanFuzzy hanya dibaca)
+  siapkanFuzzyLut();
+  ParameterPlant plant;
+
+  std::atomic<size_t> berikut(0);
+  auto pekerja = [&]() {
+    for (size_t i = berikut++; i < kerja.size(); i = berikut++) {
+      Pekerjaan &p = kerja[i];
+      ParameterKontrol param;
+      param.kontrolAktif = p.varian->mode;
+      param.mesinFuzzySuhu = p.varian->mesinSuhu;
+      param.mesinFuzzyKeruh = p.varian->mesinKeruh;
+      OpsiSimulasi o = opsi;
+      FILE *f = nullptr;
+      if (awalanJejak) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s_%s_%s.csv", awalanJejak, p.skenario->nama, p.varian->nama);
+        f = fopen(path, "w");
+        if (f) {
+          fprintf(f, "detik,suhu,turbidity_persen,turbidity_adc,out_suhu,out_keruh,setpoint_suhu,setpoint_keruh\n");
+          o.jejak = tulisJejak;
+          o.ctxJejak = f;
+        }
+      }
+      p.hasil = simulasikan(*p.skenario, param, plant, o);
+      if (f) fclose(f);
+    }
+  };
+
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> thread;
+  for (int i = 1; i < jumlahThread; i++) thread.emplace_back(pekerja);
+  pekerja();
+  for (auto &th : thread) th.join();
+  double detikDinding = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  printf("=== SIMULASI PLANT AQUARIUM (%d thread) ===\n", jumlahThread);
+  printf("%-15s %-10s | %-8s %-9s %-6s %-6s %-7s | %-9s %-10s %-6s %-6s %-7s\n",
+         "skenario", "kontroler", "IAE_C.h", "ISE_C2.h", "OS_C", "ts_mnt", "heatWh",
+         "IAE_%.h", "ISE_%2.h", "OS_%", "ts_mnt", "pompaWh");
+  double totalJam = 0.0;
+  uint64_t totalLangkah = 0;
+  for (const Pekerjaan &p : kerja) {
+    const HasilSimulasi &h = p.hasil;
+    char tsS[16], tsK[16];
+    cetakSettling(tsS, sizeof(tsS), h.suhu.settlingDetik);
+    cetakSettling(tsK, sizeof(tsK), h.keruh.settlingDetik);
+    printf("%-15s %-10s | %-8.3f %-9.4f %-6.2f %-6s %-7.0f | %-9.2f %-10.2f %-6.2f %-6s %-7.1f\n",
+           p.skenario->nama, p.varian->nama,
+           h.suhu.iae / 3600, h.suhu.ise / 3600, h.suhu.overshoot, tsS, h.suhu.energiWh,
+           h.keruh.iae / 3600, h.keruh.ise / 3600, h.keruh.overshoot, tsK, h.keruh.energiWh);
+    totalJam += h.jamSimulasi;
+    totalLangkah += h.jumlahLangkah;
+  }
+  printf("\n%.0f jam simulasi dalam %.2f s = %.0f jam simulasi / menit (%.1f juta langkah)\n",
+         totalJam, detikDinding, totalJam / detikDinding * 60.0, totalLangkah / 1e6);
+
+  if (pathCsv) {
+    FILE *f = fopen(pathCsv, "w");
+    if (!f) {
+      fprintf(stderr, "gagal menulis %s\n", pathCsv);
+      return 1;
+    }
+    fprintf(f, "skenario,kontroler,jam,iae_suhu,ise_suhu,overshoot_suhu,settling_suhu_s,energi_heater_wh,"
+               "iae_keruh,ise_keruh,overshoot_keruh,settling_keruh_s,energi_pompa_wh\n");
+    for (const Pekerjaan &p : kerja) {
+      const HasilSimulasi &h = p.hasil;
+      fprintf(f, "%s,%s,%.3f,%.3f,%.3f,%.4f,%.0f,%.2f,%.3f,%.3f,%.4f,%.0f,%.2f\n",
+              p.skenario->nama, p.varian->nama, h.jamSimulasi,
+              h.suhu.iae, h.suhu.ise, h.suhu.overshoot, h.suhu.settlingDetik, h.suhu.energiWh,
+              h.keruh.iae, h.keruh.ise, h.keruh.overshoot, h.keruh.settlingDetik, h.keruh.energiWh);
+    }
+    fclose(f);
+  }
+  return 0;
+}
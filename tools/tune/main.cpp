@@ -0,0 +1,345 @@
+/**
+ * AUTO-TUNER OFFLINE (build native, di atas lib/Simulasi)
+ * * Deskripsi:
+ * Mencari gain PID, ambang gain scheduling / batas pompa keruh, dan
+ * konsekuen fuzzy yang meminimalkan biaya loop tertutup di simulator.
+ * - Kelompok parameter (-g): pid_suhu, pid_keruh, fuzzy_suhu, fuzzy_keruh.
+ *   Tiap kelompok hanya dinilai dari loop-nya sendiri (plant termal &
+ *   kekeruhan tidak saling terkait) pada skenario yang relevan.
+ * - Strategi (-m): grid, acak, nm (Nelder-Mead), cma (sep-CMA-ES).
+ * - Satu batch kandidat x skenario = satu simulasi per tugas, dibagi ke
+ *   semua core lewat KolamKerja (work-stealing). Semua kandidat memakai
+ *   seed derau yang sama, jadi biaya deterministik & bisa dibandingkan.
+ * - Biaya per skenario = rata-rata |error| + bobot_os * overshoot
+ *   + bobot_energi * daya rata-rata aktuator (W); dijumlah antar skenario.
+ * - Hasil: payload JSON siap publish ke MQTT_TOPIC_MODE (retain), mis.
+ *     mosquitto_pub -t unhas/informatika/aquarium/mode -r -f hasil.json
+ *   pio run -e tune && .pio/build/tune/program -g pid_suhu -m cma -n 200
+ *       [-j thread] [--skala x] [--seed s] [--bobot-os w] [--bobot-energi w] [--keluar berkas]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "KolamKerja.h"
+#include "Optimasi.h"
+#include "Simulasi.h"
+
+// =========================================================================
+//                  KELOMPOK PARAMETER
+// =========================================================================
+
+// Nama dimensi = key JSON di callback MQTT firmware (konsekuen: indeks "out")
+static const std::vector<DimensiCari> DIMENSI_PID_SUHU = {
+  {"kp_suhu", 0.5, 40.0, 8.0},
+  {"ki_suhu", 0.0, 3.0, 0.3},
+  {"kd_suhu", 0.0, 30.0, 6.0},
+};
+
+static const std::vector<DimensiCari> DIMENSI_PID_KERUH = {
+  {"kp_keruh", 0.5, 30.0, 5.0},
+  {"ki_keruh", 0.0, 2.0, 0.2},
+  {"kd_keruh", 0.0, 10.0, 2.0},
+  {"kp_turbo_keruh", 5.0, 80.0, 35.0},
+  {"ambang_turbo_keruh", 0.5, 6.0, 2.0},
+  {"keruh_tahan", 9.0, 20.0, 11.0},
+  {"keruh_mati", 3.0, 14.0, 9.0},
+};
+
+static const std::vector<DimensiCari> DIMENSI_FUZZY_SUHU = {
+  {"fuzzy_suhu.out[0]", 0.0, 100.0, KONSEKUEN_SUHU[0]},
+  {"fuzzy_suhu.out[1]", 0.0, 100.0, KONSEKUEN_SUHU[1]},
+  {"fuzzy_suhu.out[2]", 0.0, 100.0, KONSEKUEN_SUHU[2]},
+  {"fuzzy_suhu.out[3]", 0.0, 100.0, KONSEKUEN_SUHU[3]},
+  {"fuzzy_suhu.out[4]", 0.0, 100.0, KONSEKUEN_SUHU[4]},
+};
+
+static const std::vector<DimensiCari> DIMENSI_FUZZY_KERUH = {
+  {"fuzzy_keruh.out[0]", 0.0, 100.0, KONSEKUEN_KERUH[0]},
+  {"fuzzy_keruh.out[1]", 0.0, 100.0, KONSEKUEN_KERUH[1]},
+  {"fuzzy_keruh.out[2]", 0.0, 100.0, KONSEKUEN_KERUH[2]},
+  {"fuzzy_keruh.out[3]", 0.0, 100.0, KONSEKUEN_KERUH[3]},
+  {"fuzzy_keruh.out[4]", 0.0, 100.0, KONSEKUEN_KERUH[4]},
+  {"keruh_tahan", 9.0, 20.0, 11.0},
+  {"keruh_mati", 3.0, 14.0, 9.0},
+};
+
+struct Kandidat {
+  ParameterKontrol param;
+  AturanFuzzy aturan;
+};
+
+static void terapkanPidSuhu(const double *x, Kandidat &k) {
+  k.param.Kp_suhu = x[0]; k.param.Ki_suhu = x[1]; k.param.Kd_suhu = x[2];
+}
+
+static void terapkanPidKeruh(const double *x, Kandidat &k) {
+  k.param.Kp_keruh = x[0]; k.param.Ki_keruh = x[1]; k.param.Kd_keruh = x[2];
+  k.param.Kp_keruh_turbo = x[3]; k.param.ambangTurboKeruh = (float)x[4];
+  k.param.keruhTahan = (float)x[5]; k.param.keruhMati = (float)x[6];
+}
+
+static void terapkanFuzzySuhu(const double *x, Kandidat &k) {
+  for (int s = 0; s < FUZZY_N_HIMPUNAN; s++) k.aturan.suhu.konsekuen[s] = (float)x[s];
+}
+
+static void terapkanFuzzyKeruh(const double *x, Kandidat &k) {
+  for (int s = 0; s < FUZZY_N_HIMPUNAN; s++) k.aturan.keruh.konsekuen[s] = (float)x[s];
+  k.param.keruhTahan = (float)x[5]; k.param.keruhMati = (float)x[6];
+}
+
+struct KelompokTuning {
+  const char *nama;
+  ControlMode mode;
+  bool loopSuhu;                          // false = loop keruh
+  const std::vector<DimensiCari> *dimensi;
+  void (*terapkan)(const double *x, Kandidat &k);
+  const char *skenario[4];
+};
+
+static const KelompokTuning KELOMPOK[] = {
+  {"pid_suhu", PID, true, &DIMENSI_PID_SUHU, terapkanPidSuhu, {"step_suhu", "ayunan_ruang", "ruang_dingin"}},
+  {"pid_keruh", PID, false, &DIMENSI_PID_KERUH, terapkanPidKeruh, {"lonjakan_keruh", "step_keruh"}},
+  {"fuzzy_suhu", FUZZY, true, &DIMENSI_FUZZY_SUHU, terapkanFuzzySuhu, {"step_suhu", "ayunan_ruang", "ruang_dingin"}},
+  {"fuzzy_keruh", FUZZY, false, &DIMENSI_FUZZY_KERUH, terapkanFuzzyKeruh, {"lonjakan_keruh", "step_keruh"}},
+};
+static const int JUMLAH_KELOMPOK = sizeof(KELOMPOK) / sizeof(KELOMPOK[0]);
+
+// Batas pompa terbalik / terlalu rapat membuat pompa berosilasi on-off
+static bool kandidatValid(const Kandidat &k) {
+  return k.param.keruhMati + 0.5f <= k.param.keruhTahan;
+}
+
+// =========================================================================
+//                  PAYLOAD MQTT_TOPIC_MODE
+// =========================================================================
+
+// Rule base satu input dalam format callback firmware: mf, out, default
+static int tulisFuzzyJson(char *buf, size_t len, const char *key, const Trapesium (&mf)[FUZZY_N_HIMPUNAN],
+                          const Fuzzy1 &f) {
+  int n = snprintf(buf, len, ",\"%s\":{\"mf\":[", key);
+  for (int s = 0; s < FUZZY_N_HIMPUNAN; s++) {
+    n += snprintf(buf + n, (n < (int)len) ? len - n : 0, "%s[%g,%g,%g,%g]", s ? "," : "",
+                  mf[s].a, mf[s].b, mf[s].c, mf[s].d);
+  }
+  n += snprintf(buf + n, (n < (int)len) ? len - n : 0, "],\"out\":[");
+  for (int s = 0; s < FUZZY_N_HIMPUNAN; s++) {
+    n += snprintf(buf + n, (n < (int)len) ? len - n : 0, "%s%.2f", s ? "," : "", f.konsekuen[s]);
+  }
+  n += snprintf(buf + n, (n < (int)len) ? len - n : 0, "],\"default\":%g}", f.keluaranDefault);
+  return n;
+}
+
+static size_t tulisPayloadMode(const KelompokTuning &g, const Kandidat &k, char *buf, size_t len) {
+  const ParameterKontrol &p = k.param;
+  int n = snprintf(buf, len, "{\"kontrol_aktif\":\"%s\"", (g.mode == FUZZY) ? "Fuzzy" : "PID");
+  auto sisa = [&]() -> size_t { return (n < (int)len) ? len - n : 0; };
+  if (g.terapkan == terapkanPidSuhu) {
+    n += snprintf(buf + n, sisa(), ",\"kp_suhu\":%.4f,\"ki_suhu\":%.4f,\"kd_suhu\":%.4f",
+                  p.Kp_suhu, p.Ki_suhu, p.Kd_suhu);
+  } else if (g.terapkan == terapkanPidKeruh) {
+    n += snprintf(buf + n, sisa(),
+                  ",\"kp_keruh\":%.4f,\"ki_keruh\":%.4f,\"kd_keruh\":%.4f,\"kp_turbo_keruh\":%.3f,"
+                  "\"ambang_turbo_keruh\":%.3f,\"keruh_tahan\":%.2f,\"keruh_mati\":%.2f",
+                  p.Kp_keruh, p.Ki_keruh, p.Kd_keruh, p.Kp_keruh_turbo, p.ambangTurboKeruh,
+                  p.keruhTahan, p.keruhMati);
+  } else if (g.terapkan == terapkanFuzzySuhu) {
+    n += snprintf(buf + n, sisa(), ",\"fuzzy_lut_suhu\":false,\"fuzzy_pd_suhu\":false");
+    n += tulisFuzzyJson(buf + n, sisa(), "fuzzy_suhu", HIMPUNAN_SUHU, k.aturan.suhu);
+  } else {
+    n += snprintf(buf + n, sisa(), ",\"fuzzy_lut_keruh\":false,\"keruh_tahan\":%.2f,\"keruh_mati\":%.2f",
+                  p.keruhTahan, p.keruhMati);
+    n += tulisFuzzyJson(buf + n, sisa(), "fuzzy_keruh", HIMPUNAN_KERUH, k.aturan.keruh);
+  }
+  n += snprintf(buf + n, sisa(), "}");
+  if (n < 0 || (size_t)n >= len) return 0;
+  return (size_t)n;
+}
+
+// =========================================================================
+//                  EVALUASI PARALEL
+// =========================================================================
+
+struct PenilaiTuning {
+  const KelompokTuning *kelompok;
+  std::vector<const Skenario *> skenario;
+  ParameterPlant plant;
+  OpsiSimulasi opsi;
+  double bobotOvershoot = 1.0;
+  double bobotEnergi = 0.01;
+  KolamKerja *kolam;
+
+  size_t jumlahSimulasi = 0;
+  double jamSimulasi = 0.0;
+  double detikSimulasi = 0.0;    // waktu dinding di dalam kolam
+
+  Kandidat buatKandidat(const std::vector<double> &x) const {
+    Kandidat k = {ParameterKontrol(), ATURAN_FUZZY_DEFAULT};
+    k.param.kontrolAktif = kelompok->mode;
+    kelompok->terapkan(x.data(), k);
+    k.aturan.panggangLut();
+    return k;
+  }
+
+  double biayaSkenario(const HasilSimulasi &h) const {
+    const MetrikLoop &m = kelompok->loopSuhu ? h.suhu : h.keruh;
+    double detik = h.jamSimulasi * 3600.0;
+    if (detik <= 0.0) return INFINITY;
+    return m.iae / detik + bobotOvershoot * m.overshoot + bobotEnergi * m.energiWh * 3600.0 / detik;
+  }
+
+  void evaluasi(const std::vector<std::vector<double>> &x, std::vector<double> &biaya) {
+    const size_t nSk = skenario.size();
+    std::vector<Kandidat> kandidat;
+    kandidat.reserve(x.size());
+    for (const auto &v : x) kandidat.push_back(buatKandidat(v));
+
+    // Kandidat tidak valid tidak disimulasikan
+    std::vector<size_t> tugas;
+    for (size_t i = 0; i < x.size(); i++) {
+      if (!kandidatValid(kandidat[i])) continue;
+      for (size_t s = 0; s < nSk; s++) tugas.push_back(i * nSk + s);
+    }
+
+    std::vector<HasilSimulasi> hasil(x.size() * nSk);
+    auto t0 = std::chrono::steady_clock::now();
+    kolam->paralel(tugas.size(), [&](size_t t) {
+      size_t i = tugas[t] / nSk, s = tugas[t] % nSk;
+      OpsiSimulasi o = opsi;
+      o.aturan = &kandidat[i].aturan;
+      hasil[tugas[t]] = simulasikan(*skenario[s], kandidat[i].param, plant, o);
+    });
+    detikSimulasi += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    jumlahSimulasi += tugas.size();
+
+    for (size_t i = 0; i < x.size(); i++) {
+      if (!kandidatValid(kandidat[i])) {
+        biaya[i] = 1e9;
+        continue;
+      }
+      double total = 0.0;
+      for (size_t s = 0; s < nSk; s++) {
+        total += biayaSkenario(hasil[i * nSk + s]);
+        jamSimulasi += hasil[i * nSk + s].jamSimulasi;
+      }
+      biaya[i] = total;
+    }
+  }
+};
+
+static void cetakProgres(size_t evaluasi, double biayaTerbaik, void *ctx) {
+  const PenilaiTuning &p = *(const PenilaiTuning *)ctx;
+  fprintf(stderr, "\r  %5zu evaluasi | biaya terbaik %.5f | %.1f simulasi/s   ", evaluasi, biayaTerbaik,
+          p.jumlahSimulasi / p.detikSimulasi);
+}
+
+static const Skenario *cariSkenario(const char *nama) {
+  for (int s = 0; s < JUMLAH_SKENARIO_STANDAR; s++)
+    if (!strcmp(nama, SKENARIO_STANDAR[s].nama)) return &SKENARIO_STANDAR[s];
+  return nullptr;
+}
+
+int main(int argc, char **argv) {
+  int jumlahThread = (int)std::thread::hardware_concurrency();
+  const char *namaKelompok = "pid_suhu";
+  const char *pathKeluar = nullptr;
+  OpsiCari opsiCari;
+  OpsiSimulasi opsiSim;
+  opsiSim.skalaDurasi = 0.25;
+  double bobotOvershoot = 1.0, bobotEnergi = 0.01;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) jumlahThread = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "-g") && i + 1 < argc) namaKelompok = argv[++i];
+    else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+      if (!strategiDariNama(argv[++i], opsiCari.strategi)) {
+        fprintf(stderr, "strategi tidak dikenal: %s (grid, acak, nm, cma)\n", argv[i]);
+        return 1;
+      }
+    }
+    else if (!strcmp(argv[i], "-n") && i + 1 < argc) opsiCari.anggaran = (size_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--batch") && i + 1 < argc) opsiCari.batch = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) opsiCari.seed = opsiSim.seed = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--skala") && i + 1 < argc) opsiSim.skalaDurasi = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--bobot-os") && i + 1 < argc) bobotOvershoot = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--bobot-energi") && i + 1 < argc) bobotEnergi = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--keluar") && i + 1 < argc) pathKeluar = argv[++i];
+    else {
+      fprintf(stderr, "pakai: %s [-g kelompok] [-m grid|acak|nm|cma] [-n anggaran] [-j thread] [--batch b]\n"
+                      "          [--seed s] [--skala x] [--bobot-os w] [--bobot-energi w] [--keluar berkas]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (jumlahThread < 1) jumlahThread = 1;
+
+  const KelompokTuning *g = nullptr;
+  for (int i = 0; i < JUMLAH_KELOMPOK; i++)
+    if (!strcmp(namaKelompok, KELOMPOK[i].nama)) g = &KELOMPOK[i];
+  if (!g) {
+    fprintf(stderr, "kelompok tidak dikenal: %s (pid_suhu, pid_keruh, fuzzy_suhu, fuzzy_keruh)\n", namaKelompok);
+    return 1;
+  }
+
+  KolamKerja kolam(jumlahThread);
+  PenilaiTuning penilai;
+  penilai.kelompok = g;
+  penilai.opsi = opsiSim;
+  penilai.bobotOvershoot = bobotOvershoot;
+  penilai.bobotEnergi = bobotEnergi;
+  penilai.kolam = &kolam;
+  for (const char *nama : g->skenario) {
+    if (!nama) break;
+    penilai.skenario.push_back(cariSkenario(nama));
+  }
+
+  const std::vector<DimensiCari> &dim = *g->dimensi;
+  printf("=== AUTO-TUNER %s | %s | anggaran %zu | %d thread | skala durasi %.2f ===\n",
+         g->nama, namaStrategi(opsiCari.strategi), opsiCari.anggaran, jumlahThread, opsiSim.skalaDurasi);
+
+  // Acuan: parameter default firmware
+  std::vector<double> awal;
+  for (const DimensiCari &d : dim) awal.push_back(d.awal);
+  std::vector<double> biayaAwal(1);
+  penilai.evaluasi({awal}, biayaAwal);
+
+  opsiCari.progres = cetakProgres;
+  opsiCari.ctxProgres = &penilai;
+  auto t0 = std::chrono::steady_clock::now();
+  HasilCari h = cari(dim, opsiCari, [&](const std::vector<std::vector<double>> &x, std::vector<double> &b) {
+    penilai.evaluasi(x, b);
+  });
+  double detikDinding = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  fprintf(stderr, "\n");
+
+  printf("\n%-20s %10s %10s\n", "parameter", "default", "terbaik");
+  for (size_t j = 0; j < dim.size(); j++) printf("%-20s %10.4f %10.4f\n", dim[j].nama, awal[j], h.terbaik[j]);
+  printf("\nbiaya default %.5f -> terbaik %.5f (%.1f%%)\n", biayaAwal[0], h.biayaTerbaik,
+         100.0 * (h.biayaTerbaik - biayaAwal[0]) / biayaAwal[0]);
+  printf("%zu evaluasi (%d batch), %zu simulasi, %.0f jam simulasi dalam %.2f s\n",
+         h.jumlahEvaluasi, h.jumlahBatch, penilai.jumlahSimulasi, penilai.jamSimulasi, detikDinding);
+  printf("throughput: %.2f simulasi/s, %.0f jam simulasi / menit, %llu tugas dicuri\n",
+         penilai.jumlahSimulasi / penilai.detikSimulasi, penilai.jamSimulasi / penilai.detikSimulasi * 60.0,
+         (unsigned long long)kolam.jumlahCurian());
+
+  char payload[1024];
+  if (tulisPayloadMode(*g, penilai.buatKandidat(h.terbaik), payload, sizeof(payload)) == 0) {
+    fprintf(stderr, "payload terlalu panjang\n");
+    return 1;
+  }
+  printf("\nPayload MQTT_TOPIC_MODE:\n%s\n", payload);
+  if (pathKeluar) {
+    FILE *f = fopen(pathKeluar, "w");
+    if (!f) {
+      fprintf(stderr, "gagal menulis %s\n", pathKeluar);
+      return 1;
+    }
+    fprintf(f, "%s\n", payload);
+    fclose(f);
+  }
+  return 0;
+}